@@ -93,6 +93,18 @@ typedef struct TAOS_FIELD_E {
   int32_t bytes;
 } TAOS_FIELD_E;
 
+// One column of the block fetched by taos_fetch_columns. Var types have an offset per row into data, -1 for null,
+// the other types a null bitmap, one bit per row from the highest bit of the first byte. NCHAR values are converted to
+// the client charset and JSON values to strings, as taos_fetch_block returns them.
+typedef struct TAOS_COLUMN_DATA {
+  int8_t   type;
+  int32_t  bytes;
+  int32_t  numOfRows;
+  char    *nullbitmap;
+  int32_t *offset;
+  char    *data;
+} TAOS_COLUMN_DATA;
+
 #ifdef WINDOWS
 #define DLL_EXPORT __declspec(dllexport)
 #else
@@ -174,6 +186,10 @@ DLL_EXPORT int       taos_stmt_close(TAOS_STMT *stmt);
 DLL_EXPORT char     *taos_stmt_errstr(TAOS_STMT *stmt);
 DLL_EXPORT int       taos_stmt_affected_rows(TAOS_STMT *stmt);
 DLL_EXPORT int       taos_stmt_affected_rows_once(TAOS_STMT *stmt);
+// fp gets the result of every submit of the stmt and frees it with taos_free_result
+DLL_EXPORT int       taos_stmt_set_async(TAOS_STMT *stmt, __taos_async_fn_t fp, void *param);
+DLL_EXPORT int       taos_stmt_bind_tables(TAOS_STMT *stmt, int numOfTables, const char **tbnames,
+                                           TAOS_MULTI_BIND **binds);
 
 DLL_EXPORT TAOS_RES *taos_query(TAOS *taos, const char *sql);
 
@@ -195,6 +211,8 @@ DLL_EXPORT int         taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows);
 DLL_EXPORT int         taos_fetch_block_s(TAOS_RES *res, int *numOfRows, TAOS_ROW *rows);
 DLL_EXPORT int         taos_fetch_raw_block(TAOS_RES *res, int *numOfRows, void **pData);
 DLL_EXPORT int        *taos_get_column_data_offset(TAOS_RES *res, int columnIndex);
+DLL_EXPORT int         taos_fetch_columns(TAOS_RES *res, int *numOfRows);
+DLL_EXPORT int         taos_get_column_data(TAOS_RES *res, int columnIndex, TAOS_COLUMN_DATA *pData);
 DLL_EXPORT int         taos_validate_sql(TAOS *taos, const char *sql);
 DLL_EXPORT void        taos_reset_current_db(TAOS *taos);
 
@@ -216,6 +234,7 @@ DLL_EXPORT int       taos_get_db_route_info(TAOS* taos, const char* db, TAOS_DB_
 DLL_EXPORT int       taos_get_table_vgId(TAOS* taos, const char* db, const char* table, int* vgId);
 
 DLL_EXPORT int       taos_load_table_info(TAOS *taos, const char *tableNameList);
+DLL_EXPORT int       taos_load_child_table_info(TAOS *taos, const char *stbName);
 DLL_EXPORT TAOS_RES *taos_schemaless_insert(TAOS *taos, char *lines[], int numLines, int protocol, int precision);
 DLL_EXPORT TAOS_RES *taos_schemaless_insert_raw(TAOS* taos, char* lines, int len, int32_t *totalRows, int protocol, int precision);
 
@@ -241,8 +241,13 @@ int32_t      blockDataAppendColInfo(SSDataBlock* pBlock, SColumnInfoData* pColIn
 SColumnInfoData  createColumnInfoData(int16_t type, int32_t bytes, int16_t colId);
 SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 
+#define BLOCK_VERSION_1        1
+#define BLOCK_VERSION_COLUMNAR 2  // each column encoded on its own, see blockEncode
+
 void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_t numOfCols, int8_t needCompress);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
+// decode one column of a columnar block, pColInfoData must have room for numOfRows
+int32_t blockDecodeCol(SColumnInfoData* pColInfoData, const char* pData, int32_t len, int32_t numOfRows);
 
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
 void blockDebugShowDataBlocks(const SArray* dataBlocks, const char* flag);
@@ -255,7 +260,9 @@ int32_t buildSubmitReqFromDataBlock(SSubmitReq** pReq, const SSDataBlock* pDataB
 char* buildCtbNameByGroupId(const char* stbName, uint64_t groupId);
 
 static FORCE_INLINE int32_t blockGetEncodeSize(const SSDataBlock* pBlock) {
-  return blockDataGetSerialMetaSize(taosArrayGetSize(pBlock->pDataBlock)) + blockDataGetSize(pBlock);
+  // one more byte per column for the encoding of a columnar block
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  return blockDataGetSerialMetaSize(numOfCols) + blockDataGetSize(pBlock) + numOfCols * sizeof(int8_t);
 }
 
 static FORCE_INLINE int32_t blockCompressColData(SColumnInfoData* pColRes, int32_t numOfRows, char* data,
@@ -85,18 +85,24 @@ extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQueryRspPolicy;
+extern int32_t tsQueryTimeSlice;
 extern int32_t tsQuerySmaOptimize;
 extern int32_t tsQueryRsmaTolerance;
 extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
 extern bool    tsKeepColumnName;
+extern int32_t tsQueryPlanCacheSize;
 extern bool    tsEnableQueryHb;
 
 // client
 extern int32_t tsMinSlidingTime;
 extern int32_t tsMinIntervalTime;
 extern int32_t tsMaxMemUsedByInsert;
+extern int32_t tsNumOfCsvParseThreads;
+extern int32_t tsStmtFlushRows;
+extern int32_t tsStmtFlushInterval;
+extern int32_t tsStmtMaxInflight;
 
 // build info
 extern char version[];
@@ -129,6 +135,24 @@ extern bool tsSmlDataFormat;
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
 
+// vnode
+extern int64_t tsVnodeWriteBufferSize;
+extern int32_t tsVnodeCommitAge;
+extern int32_t tsVnodeWriteBufferNum;
+extern bool    tsCompactEnable;
+extern int32_t tsCompactIOLimit;
+extern bool    tsRetentionRewrite;
+extern int32_t tsCommitIOLimit;
+extern int32_t tsMigrateIOLimit;
+extern int32_t tsSnapshotIOLimit;
+extern int32_t tsIoBackgroundShare;
+
+// tmq
+extern int32_t tsTqLogCacheSize;
+
+// stream
+extern int32_t tsStreamBufferSize;
+
 // internal
 extern int32_t tsTransPullupInterval;
 extern int32_t tsMqRebalanceInterval;
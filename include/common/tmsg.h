@@ -119,6 +119,7 @@ typedef enum _mgmt_table {
   TSDB_MGMT_TABLE_QUERIES,
   TSDB_MGMT_TABLE_VNODES,
   TSDB_MGMT_TABLE_APPS,
+  TSDB_MGMT_TABLE_STREAM_TASKS,
   TSDB_MGMT_TABLE_MAX,
 } EShowType;
 
@@ -241,10 +242,29 @@ typedef struct {
   char     blocks[];
 } SSubmitReq;
 
+// Set in the high bit of SSubmitBlk.schemaLen when the data part is column-major (see SSubmitColBlk) instead of a
+// sequence of STSRow.
+#define SUBMIT_BLK_COL_FMT ((int32_t)0x80000000)
+
+typedef struct SSubmitColBlk {
+  int32_t   nRow;
+  int32_t   nCol;
+  int32_t   nColAlloc;
+  SSchema*  aSchema;   // only type, colId and bytes are set
+  SColData* aColData;  // bitmaps, offsets and uncompressed values point into the submit message
+  uint8_t** aBuf;      // decompressed values
+} SSubmitColBlk;
+
 typedef struct {
   int32_t totalLen;
   int32_t len;
   STSRow* row;
+  // column-major block, rows are rebuilt into row one by one
+  int32_t        iRow;
+  int32_t        sversion;
+  SSubmitColBlk* pColBlk;
+  STSchema*      pTSchema;
+  void*          varBuf;
 } SSubmitBlkIter;
 
 typedef struct {
@@ -258,6 +278,7 @@ typedef struct {
   int32_t schemaLen;  // schema length, if length is 0, no schema exists
   int32_t numOfRows;  // total number of rows in current submit block
   // head of SSubmitBlk
+  int8_t      colFmt;
   int32_t     numOfBlocks;
   const void* pMsg;
 } SSubmitMsgIter;
@@ -266,6 +287,12 @@ int32_t tInitSubmitMsgIter(const SSubmitReq* pMsg, SSubmitMsgIter* pIter);
 int32_t tGetSubmitMsgNext(SSubmitMsgIter* pIter, SSubmitBlk** pPBlock);
 int32_t tInitSubmitBlkIter(SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock, SSubmitBlkIter* pIter);
 STSRow* tGetSubmitBlkNext(SSubmitBlkIter* pIter);
+void    tDestroySubmitBlkIter(SSubmitBlkIter* pIter);
+
+int32_t tSubmitColBlkMaxSize(SColData* aColData, int32_t nCol);
+int32_t tEncodeSubmitColBlk(SColData* aColData, const SSchema* aSchema, int32_t nCol, int8_t cmprAlg, uint8_t* pBuf);
+int32_t tDecodeSubmitColBlk(const uint8_t* pBuf, int32_t len, SSubmitColBlk* pBlk);
+void    tDestroySubmitColBlk(SSubmitColBlk* pBlk);
 // for debug
 int32_t tPrintFixedSchemaSubmitReq(SSubmitReq* pReq, STSchema* pSchema);
 
@@ -570,6 +597,7 @@ typedef struct {
   int32_t  svrTimestamp;
   char     sVer[TSDB_VERSION_LEN];
   char     sDetailVer[128];
+  int8_t   submitColFmt;  // the vnodes of the cluster accept SUBMIT_BLK_COL_FMT blocks
 } SConnectRsp;
 
 int32_t tSerializeSConnectRsp(void* buf, int32_t bufLen, SConnectRsp* pRsp);
@@ -1063,16 +1091,37 @@ typedef struct {
   char    charset[TD_LOCALE_LEN];     // tsCharset
 } SClusterCfg;
 
-typedef struct {
-  int32_t openVnodes;
-  int32_t totalVnodes;
-  int32_t masterNum;
-  int64_t numOfSelectReqs;
-  int64_t numOfInsertReqs;
-  int64_t numOfInsertSuccessReqs;
-  int64_t numOfBatchInsertReqs;
-  int64_t numOfBatchInsertSuccessReqs;
-  int64_t errors;
+// classes of background file I/O rate limited across the vnodes of a dnode
+typedef enum {
+  VND_IO_NONE = -1,  // foreground, not limited
+  VND_IO_COMMIT = 0,
+  VND_IO_COMPACT,
+  VND_IO_MIGRATE,
+  VND_IO_SNAPSHOT,
+  VND_IO_MAX,
+} EVndIoClass;
+
+typedef struct {
+  int64_t bytes;   // delta
+  int64_t waitUs;  // delta
+  int32_t queued;
+} SVnodeIoStat;
+
+typedef struct {
+  int32_t      openVnodes;
+  int32_t      totalVnodes;
+  int32_t      masterNum;
+  int64_t      numOfSelectReqs;
+  int64_t      numOfInsertReqs;
+  int64_t      numOfInsertSuccessReqs;
+  int64_t      numOfBatchInsertReqs;
+  int64_t      numOfBatchInsertSuccessReqs;
+  int64_t      numOfCommitStalls;
+  int64_t      commitStallTimeUs;
+  int64_t      numOfBufferStalls;
+  int64_t      bufferStallTimeUs;
+  SVnodeIoStat ioStat[VND_IO_MAX];
+  int64_t      errors;
 } SVnodesStat;
 
 typedef struct {
@@ -1090,8 +1139,23 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t numOfCommitStalls;
+  int64_t commitStallTimeUs;
+  int64_t numOfBufferStalls;
+  int64_t bufferStallTimeUs;
 } SVnodeLoad;
 
+typedef struct {
+  int64_t streamId;
+  int32_t taskId;
+  int32_t batchSize;
+  int64_t execNum;
+  int64_t inputItems;
+  int64_t outputRows;
+  int64_t execTimeUs;
+  int64_t maxExecUs;
+} SStreamTaskLoad;
+
 typedef struct {
   int8_t syncState;
   int8_t syncRestore;
@@ -1127,7 +1191,8 @@ typedef struct {
   SMnodeLoad  mload;
   SQnodeLoad  qload;
   SClusterCfg clusterCfg;
-  SArray*     pVloads;  // array of SVnodeLoad
+  SArray*     pVloads;       // array of SVnodeLoad
+  SArray*     pStreamLoads;  // array of SStreamTaskLoad, the tasks of the leader vnodes
 } SStatusReq;
 
 int32_t tSerializeSStatusReq(void* buf, int32_t bufLen, SStatusReq* pReq);
@@ -1276,6 +1341,36 @@ typedef struct {
 int32_t tSerializeSTableInfoReq(void* buf, int32_t bufLen, STableInfoReq* pReq);
 int32_t tDeserializeSTableInfoReq(void* buf, int32_t bufLen, STableInfoReq* pReq);
 
+// one page of the child tables of a super table in a vnode, ordered by uid
+typedef struct {
+  SMsgHead header;
+  char     dbFName[TSDB_DB_FNAME_LEN];
+  char     stbName[TSDB_TABLE_NAME_LEN];
+  int64_t  lastUid;  // child tables with a uid above it are returned
+  int32_t  limit;
+} SVTablesMetaReq;
+
+typedef struct {
+  char    tbName[TSDB_TABLE_NAME_LEN];
+  int64_t uid;
+} SVCtbMeta;
+
+typedef struct {
+  int64_t dbId;
+  int64_t suid;
+  int32_t vgId;
+  int32_t sversion;
+  int32_t tversion;
+  int8_t  hasMore;
+  SArray* pCtbs;  // SVCtbMeta
+} SVTablesMetaRsp;
+
+int32_t tSerializeSVTablesMetaReq(void* buf, int32_t bufLen, SVTablesMetaReq* pReq);
+int32_t tDeserializeSVTablesMetaReq(void* buf, int32_t bufLen, SVTablesMetaReq* pReq);
+int32_t tSerializeSVTablesMetaRsp(void* buf, int32_t bufLen, SVTablesMetaRsp* pRsp);
+int32_t tDeserializeSVTablesMetaRsp(void* buf, int32_t bufLen, SVTablesMetaRsp* pRsp);
+void    tFreeSVTablesMetaRsp(SVTablesMetaRsp* pRsp);
+
 typedef struct {
   int8_t  metaClone;  // create local clone of the cached table meta
   int32_t numOfVgroups;
@@ -1642,12 +1737,16 @@ typedef struct {
   int32_t tversion;
 } SResReadyRsp;
 
+#define RES_FETCH_REQ_VER 1
+
 typedef struct {
   SMsgHead header;
   uint64_t sId;
   uint64_t queryId;
   uint64_t taskId;
   int32_t  execId;
+  int32_t  ver;     // RES_FETCH_REQ_VER, the fields below are only read from a request of the full size
+  int8_t   colFmt;  // the fetcher decodes BLOCK_VERSION_COLUMNAR blocks
 } SResFetchReq;
 
 typedef struct {
@@ -203,6 +203,15 @@ int32_t catalogUpdateTableMeta(SCatalog* pCatalog, STableMetaRsp* rspMsg);
 
 int32_t catalogUpdateTableMeta(SCatalog* pCatalog, STableMetaRsp* rspMsg);
 
+/**
+ * Load the meta of all the child tables of a super table into the local cache, page by page from each vgroup.
+ * @param pCatalog (input, got with catalogGetHandle)
+ * @param pConn (input, connection info)
+ * @param pStbName (input, super table name)
+ * @return error code
+ */
+int32_t catalogPrefetchChildTableMeta(SCatalog* pCatalog, SRequestConnInfo* pConn, const SName* pStbName);
+
 int32_t catalogGetCachedTableMeta(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, STableMeta** pTableMeta);
 
 int32_t catalogGetCachedSTableMeta(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName,
@@ -116,6 +116,13 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput);
 
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize);
 
+/**
+ * Whether the fetcher decodes BLOCK_VERSION_COLUMNAR blocks, the blocks are encoded in version 1 otherwise.
+ * @param handle
+ * @param colFmt
+ */
+void dsSetColumnarOutput(DataSinkHandle handle, bool colFmt);
+
 /**
  * After dsGetStatus returns DS_NEED_SCHEDULE, the caller need to put this into the work queue.
  * @param ahandle
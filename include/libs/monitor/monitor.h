@@ -189,7 +189,8 @@ typedef struct {
 } SMonBmInfo;
 
 typedef struct {
-  SArray *pVloads;  // SVnodeLoad
+  SArray *pVloads;       // SVnodeLoad
+  SArray *pStreamLoads;  // SStreamTaskLoad, filled only when allocated by the caller
 } SMonVloadInfo;
 
 typedef struct {
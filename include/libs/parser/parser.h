@@ -68,8 +68,15 @@ typedef struct SParseContext {
   SParseCsvCxt     csvCxt;
 } SParseContext;
 
+typedef struct SQueryConstant {
+  int32_t type;     // TK_NK_INTEGER, TK_NK_FLOAT or TK_NK_STRING
+  char*   literal;  // same as the literal of the value node the parser creates for it
+} SQueryConstant;
+
 int32_t qParseSql(SParseContext* pCxt, SQuery** pQuery);
 bool    qIsInsertValuesSql(const char* pStr, size_t length);
+int32_t qNormalizeQuerySql(const char* pSql, size_t sqlLen, char** pKey, SArray** pConsts);
+void    qDestroyQueryConstants(SArray* pConsts);
 
 // for async mode
 int32_t qParseSqlSyntax(SParseContext* pCxt, SQuery** pQuery, struct SCatalogReq* pCatalogReq);
@@ -83,8 +90,9 @@ void qDestroyQuery(SQuery* pQueryNode);
 int32_t qExtractResultSchema(const SNode* pRoot, int32_t* numOfCols, SSchema** pSchema);
 int32_t qSetSTableIdForRsma(SNode* pStmt, int64_t uid);
 void    qCleanupKeywordsTable();
+void    qCleanupCsvParseWorker();
 
-int32_t     qBuildStmtOutput(SQuery* pQuery, SHashObj* pVgHash, SHashObj* pBlockHash);
+int32_t     qBuildStmtOutput(SQuery* pQuery, SHashObj* pVgHash, SHashObj* pBlockHash, bool colFmt);
 int32_t     qResetStmtDataBlock(void* block, bool keepBuf);
 int32_t     qCloneStmtDataBlock(void** pDst, void* pSrc);
 void        qFreeStmtDataBlock(void* pDataBlock);
@@ -109,7 +117,7 @@ void*   smlInitHandle(SQuery* pQuery);
 void    smlDestroyHandle(void* pHandle);
 int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols, bool format, STableMeta* pTableMeta,
                     char* tableName, const char* sTableName, int32_t sTableNameLen, char* msgBuf, int16_t msgBufLen);
-int32_t smlBuildOutput(void* handle, SHashObj* pVgHash);
+int32_t smlBuildOutput(void* handle, SHashObj* pVgHash, bool colFmt);
 
 int32_t rewriteToVnodeModifyOpStmt(SQuery* pQuery, SArray* pBufArray);
 SArray* serializeVgroupsCreateTableBatch(SHashObj* pVgroupHashmap);
@@ -60,6 +60,7 @@ typedef struct SQWMsgInfo {
   int8_t taskType;
   int8_t explain;
   int8_t needFetch;
+  int8_t colFmt;  // fetch only, see SResFetchReq
 } SQWMsgInfo;
 
 typedef struct SQWMsg {
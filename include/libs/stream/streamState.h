@@ -23,20 +23,22 @@ extern "C" {
 #ifndef _STREAM_STATE_H_
 #define _STREAM_STATE_H_
 
-typedef struct SStreamTask SStreamTask;
+typedef struct SStreamTask     SStreamTask;
+typedef struct SStreamStateBuf SStreamStateBuf;
 
 typedef bool (*state_key_cmpr_fn)(void* pKey1, void* pKey2);
 
 // incremental state storage
 typedef struct {
-  SStreamTask* pOwner;
-  TDB*         db;
-  TTB*         pStateDb;
-  TTB*         pFuncStateDb;
-  TTB*         pFillStateDb;  // todo refactor
-  TTB*         pSessionStateDb;
-  TXN          txn;
-  int32_t      number;
+  SStreamTask*     pOwner;
+  TDB*             db;
+  TTB*             pStateDb;
+  TTB*             pFuncStateDb;
+  TTB*             pFillStateDb;  // todo refactor
+  TTB*             pSessionStateDb;
+  TXN              txn;
+  int32_t          number;
+  SStreamStateBuf* pBuf;  // shared by the per-operator copies, NULL to write through
 } SStreamState;
 
 SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int32_t szPage, int32_t pages);
@@ -275,6 +275,15 @@ typedef struct {
   SArray* checkpointVer;
 } SStreamRecoveringState;
 
+typedef struct {
+  int32_t batchSize;   // adaptive limit of input items merged into one execution
+  int64_t execNum;
+  int64_t inputItems;
+  int64_t outputRows;
+  int64_t execTimeUs;  // total
+  int64_t maxExecUs;
+} STaskExecStatis;
+
 typedef struct SStreamTask {
   int64_t streamId;
   int32_t taskId;
@@ -332,7 +341,8 @@ typedef struct SStreamTask {
   SStreamState* pState;
 
   // do not serialize
-  int32_t recoverWaitingChild;
+  int32_t         recoverWaitingChild;
+  STaskExecStatis execStatis;
 
 } SStreamTask;
 
@@ -570,6 +580,7 @@ typedef struct SStreamMeta {
   TTB*         pTaskDb;
   TTB*         pCheckpointDb;
   SHashObj*    pTasks;
+  SRWLatch     lock;  // guards pTasks against the readers of the task statistics
   SHashObj*    pRecoverStatus;
   void*        ahandle;
   TXN          txn;
@@ -584,6 +595,7 @@ int32_t      streamMetaAddTask(SStreamMeta* pMeta, int64_t ver, SStreamTask* pTa
 int32_t      streamMetaAddSerializedTask(SStreamMeta* pMeta, int64_t startVer, char* msg, int32_t msgLen);
 int32_t      streamMetaRemoveTask(SStreamMeta* pMeta, int32_t taskId);
 SStreamTask* streamMetaGetTask(SStreamMeta* pMeta, int32_t taskId);
+int32_t      streamMetaGetTaskLoads(SStreamMeta* pMeta, SArray* pLoads);
 
 int32_t streamMetaBegin(SStreamMeta* pMeta);
 int32_t streamMetaCommit(SStreamMeta* pMeta);
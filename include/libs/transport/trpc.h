@@ -100,6 +100,11 @@ typedef struct SRpcInit {
   void *parent;
 } SRpcInit;
 
+typedef struct {
+  int64_t numOfWrites;    // writes issued to the sockets
+  int64_t numOfSentMsgs;  // msgs sent by these writes
+} SRpcSendStats;
+
 typedef struct {
   void *val;
   int32_t (*clone)(void *src, void **dst);
@@ -140,6 +145,7 @@ int   rpcSendRequestWithCtx(void *thandle, const SEpSet *pEpSet, SRpcMsg *pMsg,
 int   rpcSendRecv(void *shandle, SEpSet *pEpSet, SRpcMsg *pReq, SRpcMsg *pRsp);
 int   rpcSetDefaultAddr(void *thandle, const char *ip, const char *fqdn);
 void *rpcAllocHandle();
+int   rpcGetSendStats(void *thandle, SRpcSendStats *pStats);
 
 #ifdef __cplusplus
 }
@@ -96,6 +96,7 @@ extern "C" {
 #include "osMemory.h"
 #include "osRand.h"
 #include "osSemaphore.h"
+#include "osShm.h"
 #include "osSignal.h"
 #include "osSleep.h"
 #include "osSocket.h"
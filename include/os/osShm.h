@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_OS_SHM_H_
+#define _TD_OS_SHM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// named shared memory, name must start with '/' and be shorter than 32 bytes
+typedef struct {
+  void   *ptr;
+  int64_t size;
+} SShm;
+
+int32_t taosCreateShm(SShm *pShm, const char *name, int64_t size);
+int32_t taosAttachShm(SShm *pShm, const char *name);
+void    taosDetachShm(SShm *pShm);
+void    taosDropShm(const char *name);
+// drop the segments named <prefix>-<pid>-... left behind by processes that are gone, returns the number dropped
+int32_t taosDropStaleShm(const char *prefix);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_OS_SHM_H_*/
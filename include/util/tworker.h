@@ -53,6 +53,8 @@ typedef struct SWWorkerPool {
   int32_t       max;  // max number of workers
   int32_t       num;
   int32_t       nextId;  // from 0 to max-1, cyclic
+  FItemFilter   stealFp; // if set, idle workers take the pending items it accepts from the other workers
+  int8_t        stop;
   const char   *name;
   SWWorker     *workers;
   TdThreadMutex mutex;
@@ -30,6 +30,7 @@ extern "C" {
 #include "tdef.h"
 #include "thash.h"
 #include "tlist.h"
+#include "tlrucache.h"
 #include "tmsg.h"
 #include "tmsgtype.h"
 #include "trpc.h"
@@ -122,6 +123,7 @@ struct SAppInstInfo {
   void*              pTransporter;
   SAppHbMgr*         pAppHbMgr;
   char*              instKey;
+  SLRUCache*         pPlanCache;  // normalized select -> SPlanCacheEntry
 };
 
 typedef struct SAppInfo {
@@ -142,6 +144,7 @@ typedef struct STscObj {
   char          sDetailVer[128];
   int8_t        sysInfo;
   int8_t        connType;
+  int8_t        submitColFmt;  // stmt and schemaless may send column-major submit blocks
   int32_t       acctId;
   uint32_t      connId;
   int64_t       id;         // ref ID returned by taosAddRef
@@ -160,26 +163,35 @@ typedef struct SResultColumn {
   char* pData;
 } SResultColumn;
 
+typedef struct SResultColumnar {
+  const char*     pEncoded;  // the column in the current columnar block, NULL once decoded into data
+  int32_t         len;
+  SColumnInfoData data;
+} SResultColumnar;
+
 typedef struct SReqResultInfo {
-  SExecResult    execRes;
-  const char*    pRspMsg;
-  const char*    pData;
-  TAOS_FIELD*    fields;      // todo, column names are not needed.
-  TAOS_FIELD*    userFields;  // the fields info that return to user
-  uint32_t       numOfCols;
-  int32_t*       length;
-  char**         convertBuf;
-  TAOS_ROW       row;
-  SResultColumn* pCol;
-  uint32_t       numOfRows;
-  uint64_t       totalRows;
-  uint32_t       current;
-  bool           localResultFetched;
-  bool           completed;
-  int32_t        precision;
-  bool           convertUcs4;
-  int32_t        payloadLen;
-  char*          convertJson;
+  SExecResult      execRes;
+  const char*      pRspMsg;
+  const char*      pData;
+  TAOS_FIELD*      fields;      // todo, column names are not needed.
+  TAOS_FIELD*      userFields;  // the fields info that return to user
+  uint32_t         numOfCols;
+  int32_t*         length;
+  char**           convertBuf;
+  TAOS_ROW         row;
+  SResultColumn*   pCol;
+  uint32_t         numOfRows;
+  uint64_t         totalRows;
+  uint32_t         current;
+  bool             localResultFetched;
+  bool             completed;
+  int32_t          precision;
+  bool             convertUcs4;
+  int32_t          payloadLen;
+  char*            convertJson;
+  bool             lazyDecode;    // columns of a columnar block are decoded on taos_get_column_data
+  SResultColumnar* pColumnar;
+  char*            convertBlock;  // the columnar block as a version 1 block for the row and raw block APIs
 } SReqResultInfo;
 
 typedef struct SRequestSendRecvBody {
@@ -274,6 +286,7 @@ TAOS_RES* taosQueryImpl(TAOS* taos, const char* sql, bool validateOnly);
 void      taosAsyncQueryImpl(uint64_t connId, const char* sql, __taos_async_fn_t fp, void* param, bool validateOnly);
 
 int32_t getVersion1BlockMetaSize(const char* p, int32_t numOfCols);
+int32_t decodeResultColumn(SReqResultInfo* pResultInfo, int32_t columnIndex);
 
 static FORCE_INLINE SReqResultInfo* tmqGetCurResInfo(TAOS_RES* res) {
   SMqRspObj* msg = (SMqRspObj*)res;
@@ -381,6 +394,8 @@ typedef struct SSqlCallbackWrapper {
   SCatalogReq*   pCatalogReq;
   SMetaData*     pResultMeta;
   SRequestObj*   pRequest;
+  char*          pPlanCacheKey;
+  SArray*        pPlanCacheConsts;  // SQueryConstant
 } SSqlCallbackWrapper;
 
 SRequestObj* launchQueryImpl(SRequestObj* pRequest, SQuery* pQuery, bool keepQuery, void** res);
@@ -396,6 +411,26 @@ bool    qnodeRequired(SRequestObj* pRequest);
 int32_t continueInsertFromCsv(SSqlCallbackWrapper* pWrapper, SRequestObj* pRequest);
 void    destorySqlCallbackWrapper(SSqlCallbackWrapper* pWrapper);
 
+SLRUCache* planCacheOpen(int64_t capacity);
+void       planCacheClose(SLRUCache* pCache);
+int32_t    planCacheLookup(SRequestObj* pRequest, SSqlCallbackWrapper* pWrapper, bool updateMetaForce,
+                           SQueryPlan** ppDag, SArray** ppNodeList);
+void       planCacheInsert(SRequestObj* pRequest, SSqlCallbackWrapper* pWrapper, SQuery* pQuery, SQueryPlan* pDag,
+                           SArray* pNodeList);
+void       launchAsyncCachedQuery(SRequestObj* pRequest, SQueryPlan* pDag, SArray* pNodeList,
+                                  SSqlCallbackWrapper* pWrapper);
+
+typedef struct SPlanCacheEntry SPlanCacheEntry;
+
+void         planCacheDestroyEntry(SPlanCacheEntry* pEntry);
+void         planCacheCreateStmtPlan(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag, SArray* pNodeList,
+                                     SPlanCacheEntry** ppEntry);
+int32_t      planCacheBuildStmtPlan(SRequestObj* pRequest, SPlanCacheEntry* pEntry, SQuery* pQuery, SQueryPlan** ppDag,
+                                    SArray** ppNodeList);
+void         createStmtPlan(SRequestObj* pRequest, SQuery* pQuery, SPlanCacheEntry** ppPlan);
+SRequestObj* launchStmtQuery(SRequestObj* pRequest, SQuery* pQuery, SPlanCacheEntry** ppPlan);
+int32_t      launchStmtCachedQuery(SRequestObj* pRequest, SPlanCacheEntry* pPlan, SQuery* pQuery);
+
 #ifdef __cplusplus
 }
 #endif
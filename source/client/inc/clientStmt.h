@@ -85,19 +85,41 @@ typedef struct SStmtSQLInfo {
   char             *sqlStr;
   int32_t           sqlLen;
   SArray           *nodeList;
+  SPlanCacheEntry  *pQueryPlan;  // plan of the query, rebound with each bind
   SStmtQueryResInfo queryRes;
   bool              autoCreateTbl;
   SHashObj         *pVgHash;
 } SStmtSQLInfo;
 
+typedef struct SStmtAsyncVg {
+  int32_t   vgId;
+  int32_t   numOfRows;  // bound but not submitted yet
+  int64_t   firstTs;    // ms the first of them was bound
+  int32_t   inflight;
+  SHashObj *pTables;  // SHash<SName>, the tables of these rows by tbFName
+} SStmtAsyncVg;
+
+typedef struct SStmtAsyncInfo {
+  __taos_async_fn_t fp;
+  void             *param;
+  SHashObj         *pVgroups;  // SHash<SStmtAsyncVg*>
+  TdThreadMutex     lock;
+  TdThreadCond      cond;    // signalled when a submit completes or is to be resubmitted
+  SArray           *pRetry;  // SArray<SStmtAsyncReq*>, submits that failed on stale meta
+  int32_t           inflight;
+  int32_t           code;  // first submit error since the last execute
+  int64_t           affectedRows;
+} SStmtAsyncInfo;
+
 typedef struct STscStmt {
   STscObj  *taos;
   SCatalog *pCatalog;
   int32_t   affectedRows;
 
-  SStmtSQLInfo  sql;
-  SStmtExecInfo exec;
-  SStmtBindInfo bInfo;
+  SStmtSQLInfo    sql;
+  SStmtExecInfo   exec;
+  SStmtBindInfo   bInfo;
+  SStmtAsyncInfo *pAsync;  // set by taos_stmt_set_async
 } STscStmt;
 
 #define STMT_STATUS_NE(S) (pStmt->sql.status != STMT_##S)
@@ -145,6 +167,8 @@ int         stmtGetParam(TAOS_STMT *stmt, int idx, int *type, int *bytes);
 int         stmtAddBatch(TAOS_STMT *stmt);
 TAOS_RES   *stmtUseResult(TAOS_STMT *stmt);
 int         stmtBindBatch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind, int32_t colIdx);
+int         stmtSetAsync(TAOS_STMT *stmt, __taos_async_fn_t fp, void *param);
+int         stmtBindTables(TAOS_STMT *stmt, int32_t numOfTables, const char **tbnames, TAOS_MULTI_BIND **binds);
 
 #ifdef __cplusplus
 }
@@ -202,6 +202,7 @@ void destroyAppInst(SAppInstInfo *pAppInfo) {
   taosArrayDestroy(pAppInfo->pQnodeList);
   taosThreadMutexUnlock(&pAppInfo->qnodeMutex);
 
+  planCacheClose(pAppInfo->pPlanCache);
   taosMemoryFree(pAppInfo);
 }
 
@@ -316,6 +317,14 @@ void doFreeReqResultInfo(SReqResultInfo *pResInfo) {
   taosMemoryFreeClear(pResInfo->fields);
   taosMemoryFreeClear(pResInfo->userFields);
   taosMemoryFreeClear(pResInfo->convertJson);
+  taosMemoryFreeClear(pResInfo->convertBlock);
+
+  if (pResInfo->pColumnar != NULL) {
+    for (int32_t i = 0; i < pResInfo->numOfCols; ++i) {
+      colDataDestroy(&pResInfo->pColumnar[i].data);
+    }
+    taosMemoryFreeClear(pResInfo->pColumnar);
+  }
 
   if (pResInfo->convertBuf != NULL) {
     for (int32_t i = 0; i < pResInfo->numOfCols; ++i) {
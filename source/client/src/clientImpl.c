@@ -133,6 +133,7 @@ STscObj* taos_connect_internal(const char* ip, const char* user, const char* pas
     taosThreadMutexInit(&p->qnodeMutex, NULL);
     p->pTransporter = openTransporter(user, secretEncrypt, tsNumOfCores);
     p->pAppHbMgr = appHbMgrInit(p, key);
+    p->pPlanCache = planCacheOpen((int64_t)tsQueryPlanCacheSize * 1024 * 1024);
     taosHashPut(appInfo.pInstMap, key, strlen(key), &p, POINTER_BYTES);
     p->instKey = key;
     key = NULL;
@@ -934,7 +935,8 @@ void schedulerExecCb(SExecResult* pResult, void* param, int32_t code) {
   pRequest->body.queryFp(pRequest->body.param, pRequest, code);
 }
 
-SRequestObj* launchQueryImpl(SRequestObj* pRequest, SQuery* pQuery, bool keepQuery, void** res) {
+static SRequestObj* doLaunchQuery(SRequestObj* pRequest, SQuery* pQuery, bool keepQuery, void** res,
+                                  SPlanCacheEntry** ppStmtPlan) {
   int32_t code = 0;
 
   if (pQuery->pRoot) {
@@ -977,6 +979,9 @@ SRequestObj* launchQueryImpl(SRequestObj* pRequest, SQuery* pQuery, bool keepQue
           SArray* pNodeList = NULL;
           buildSyncExecNodeList(pRequest, &pNodeList, pMnodeList);
 
+          if (NULL != ppStmtPlan) {
+            planCacheCreateStmtPlan(pRequest, pQuery, pDag, pNodeList, ppStmtPlan);
+          }
           code = scheduleQuery(pRequest, pDag, pNodeList);
           taosArrayDestroy(pNodeList);
         }
@@ -1013,6 +1018,84 @@ SRequestObj* launchQueryImpl(SRequestObj* pRequest, SQuery* pQuery, bool keepQue
   return pRequest;
 }
 
+SRequestObj* launchQueryImpl(SRequestObj* pRequest, SQuery* pQuery, bool keepQuery, void** res) {
+  return doLaunchQuery(pRequest, pQuery, keepQuery, res, NULL);
+}
+
+// Plan a translated stmt query and keep the plan in *ppPlan if the placeholders can be rebound into it. The query
+// itself is left as translated, it is planned from a copy.
+void createStmtPlan(SRequestObj* pRequest, SQuery* pQuery, SPlanCacheEntry** ppPlan) {
+  SQuery      query = *pQuery;
+  SQueryPlan* pDag = NULL;
+  SArray*     pMnodeList = taosArrayInit(4, sizeof(SQueryNodeLoad));
+  query.pRoot = nodesCloneNode(pQuery->pRoot);
+  if (NULL != pMnodeList && NULL != query.pRoot && TSDB_CODE_SUCCESS == getPlan(pRequest, &query, &pDag, pMnodeList)) {
+    SArray* pNodeList = NULL;
+    buildSyncExecNodeList(pRequest, &pNodeList, pMnodeList);
+    planCacheCreateStmtPlan(pRequest, pQuery, pDag, pNodeList, ppPlan);
+    taosArrayDestroy(pNodeList);
+  }
+  qDestroyQueryPlan(pDag);
+  nodesDestroyNode(query.pRoot);
+  taosArrayDestroy(pMnodeList);
+}
+
+// Launch a translated stmt query, keeping its plan in *ppPlan if the placeholders can be rebound into it.
+SRequestObj* launchStmtQuery(SRequestObj* pRequest, SQuery* pQuery, SPlanCacheEntry** ppPlan) {
+  return doLaunchQuery(pRequest, pQuery, true, NULL, ppPlan);
+}
+
+// Schedule a stmt query from its kept plan. Only a plan that cannot be rebuilt is reported, execution errors go to
+// the request as in launchQueryImpl.
+int32_t launchStmtCachedQuery(SRequestObj* pRequest, SPlanCacheEntry* pPlan, SQuery* pQuery) {
+  SQueryPlan* pDag = NULL;
+  SArray*     pNodeList = NULL;
+  int32_t     code = planCacheBuildStmtPlan(pRequest, pPlan, pQuery, &pDag, &pNodeList);
+  if (TSDB_CODE_SUCCESS != code) {
+    tscDebug("0x%" PRIx64 " stmt plan not used, code:%s, reqId:0x%" PRIx64, pRequest->self, tstrerror(code),
+             pRequest->requestId);
+    return code;
+  }
+
+  if (!pRequest->inRetry) {
+    atomic_add_fetch_64((int64_t*)&pRequest->pTscObj->pAppInfo->summary.numOfQueryReq, 1);
+  }
+  tscDebug("0x%" PRIx64 " use stmt plan, subplans:%d, reqId:0x%" PRIx64, pRequest->self, pDag->numOfSubplans,
+           pRequest->requestId);
+
+  code = scheduleQuery(pRequest, pDag, pNodeList);
+  taosArrayDestroy(pNodeList);
+
+  handleQueryExecRsp(pRequest);
+  if (TSDB_CODE_SUCCESS != code) {
+    pRequest->code = terrno;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t asyncExecSchJob(SRequestObj* pRequest, SQueryPlan* pDag, SArray* pNodeList,
+                               SSqlCallbackWrapper* pWrapper) {
+  SRequestConnInfo conn = {.pTrans = getAppInfo(pRequest)->pTransporter,
+                           .requestId = pRequest->requestId,
+                           .requestObjRefId = pRequest->self};
+  SSchedulerReq    req = {
+         .syncReq = false,
+         .localReq = (tsQueryPolicy == QUERY_POLICY_CLIENT),
+         .pConn = &conn,
+         .pNodeList = pNodeList,
+         .pDag = pDag,
+         .allocatorRefId = pRequest->allocatorRefId,
+         .sql = pRequest->sqlstr,
+         .startTs = pRequest->metric.start,
+         .execFp = schedulerExecCb,
+         .cbParam = pWrapper,
+         .chkKillFp = chkRequestKilled,
+         .chkKillParam = (void*)pRequest->self,
+         .pExecRes = NULL,
+  };
+  return schedulerExecJob(&req, &pRequest->body.queryJob);
+}
+
 static int32_t asyncExecSchQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaData* pResultMeta,
                                  SSqlCallbackWrapper* pWrapper) {
   pRequest->type = pQuery->msgType;
@@ -1051,25 +1134,8 @@ static int32_t asyncExecSchQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaDat
     SArray* pNodeList = NULL;
     buildAsyncExecNodeList(pRequest, &pNodeList, pMnodeList, pResultMeta);
 
-    SRequestConnInfo conn = {.pTrans = getAppInfo(pRequest)->pTransporter,
-                             .requestId = pRequest->requestId,
-                             .requestObjRefId = pRequest->self};
-    SSchedulerReq    req = {
-           .syncReq = false,
-           .localReq = (tsQueryPolicy == QUERY_POLICY_CLIENT),
-           .pConn = &conn,
-           .pNodeList = pNodeList,
-           .pDag = pDag,
-           .allocatorRefId = pRequest->allocatorRefId,
-           .sql = pRequest->sqlstr,
-           .startTs = pRequest->metric.start,
-           .execFp = schedulerExecCb,
-           .cbParam = pWrapper,
-           .chkKillFp = chkRequestKilled,
-           .chkKillParam = (void*)pRequest->self,
-           .pExecRes = NULL,
-    };
-    code = schedulerExecJob(&req, &pRequest->body.queryJob);
+    planCacheInsert(pRequest, pWrapper, pQuery, pDag, pNodeList);
+    code = asyncExecSchJob(pRequest, pDag, pNodeList, pWrapper);
     taosArrayDestroy(pNodeList);
   } else {
     tscDebug("0x%" PRIx64 " plan not executed, code:%s 0x%" PRIx64, pRequest->self, tstrerror(code),
@@ -1084,6 +1150,19 @@ static int32_t asyncExecSchQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaDat
   return code;
 }
 
+// Schedule a plan taken from the plan cache, the request skipped parsing, catalog and planning.
+void launchAsyncCachedQuery(SRequestObj* pRequest, SQueryPlan* pDag, SArray* pNodeList,
+                            SSqlCallbackWrapper* pWrapper) {
+  pRequest->metric.ctgEnd = taosGetTimestampUs();
+  pRequest->metric.semanticEnd = pRequest->metric.ctgEnd;
+  pRequest->metric.planEnd = pRequest->metric.ctgEnd;
+  tscDebug("0x%" PRIx64 " use cached query plan, subplans:%d, 0x%" PRIx64, pRequest->self, pDag->numOfSubplans,
+           pRequest->requestId);
+
+  asyncExecSchJob(pRequest, pDag, pNodeList, pWrapper);
+  taosArrayDestroy(pNodeList);
+}
+
 void launchAsyncQuery(SRequestObj* pRequest, SQuery* pQuery, SMetaData* pResultMeta, SSqlCallbackWrapper* pWrapper) {
   int32_t code = 0;
 
@@ -1585,36 +1664,43 @@ static int32_t doPrepareResPtr(SReqResultInfo* pResInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t doConvertUCS4(SReqResultInfo* pResultInfo, int32_t numOfRows, int32_t numOfCols, int32_t* colLength) {
-  for (int32_t i = 0; i < numOfCols; ++i) {
-    int32_t type = pResultInfo->fields[i].type;
-    int32_t bytes = pResultInfo->fields[i].bytes;
+static int32_t doConvertUCS4Col(SReqResultInfo* pResultInfo, int32_t numOfRows, int32_t i, int32_t colLength) {
+  int32_t bytes = pResultInfo->fields[i].bytes;
 
-    if (type == TSDB_DATA_TYPE_NCHAR && colLength[i] > 0) {
-      char* p = taosMemoryRealloc(pResultInfo->convertBuf[i], colLength[i]);
-      if (p == NULL) {
-        return TSDB_CODE_OUT_OF_MEMORY;
-      }
+  char* p = taosMemoryRealloc(pResultInfo->convertBuf[i], colLength);
+  if (p == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-      pResultInfo->convertBuf[i] = p;
+  pResultInfo->convertBuf[i] = p;
 
-      SResultColumn* pCol = &pResultInfo->pCol[i];
-      for (int32_t j = 0; j < numOfRows; ++j) {
-        if (pCol->offset[j] != -1) {
-          char* pStart = pCol->offset[j] + pCol->pData;
+  SResultColumn* pCol = &pResultInfo->pCol[i];
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    if (pCol->offset[j] != -1) {
+      char* pStart = pCol->offset[j] + pCol->pData;
 
-          int32_t len = taosUcs4ToMbs((TdUcs4*)varDataVal(pStart), varDataLen(pStart), varDataVal(p));
-          ASSERT(len <= bytes);
-          ASSERT((p + len) < (pResultInfo->convertBuf[i] + colLength[i]));
+      int32_t len = taosUcs4ToMbs((TdUcs4*)varDataVal(pStart), varDataLen(pStart), varDataVal(p));
+      ASSERT(len <= bytes);
+      ASSERT((p + len) < (pResultInfo->convertBuf[i] + colLength));
 
-          varDataSetLen(p, len);
-          pCol->offset[j] = (p - pResultInfo->convertBuf[i]);
-          p += (len + VARSTR_HEADER_SIZE);
-        }
-      }
+      varDataSetLen(p, len);
+      pCol->offset[j] = (p - pResultInfo->convertBuf[i]);
+      p += (len + VARSTR_HEADER_SIZE);
+    }
+  }
 
-      pResultInfo->pCol[i].pData = pResultInfo->convertBuf[i];
-      pResultInfo->row[i] = pResultInfo->pCol[i].pData;
+  pResultInfo->pCol[i].pData = pResultInfo->convertBuf[i];
+  pResultInfo->row[i] = pResultInfo->pCol[i].pData;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doConvertUCS4(SReqResultInfo* pResultInfo, int32_t numOfRows, int32_t numOfCols, int32_t* colLength) {
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (pResultInfo->fields[i].type == TSDB_DATA_TYPE_NCHAR && colLength[i] > 0) {
+      int32_t code = doConvertUCS4Col(pResultInfo, numOfRows, i, colLength[i]);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
     }
   }
 
@@ -1629,6 +1715,57 @@ int32_t getVersion1BlockMetaSize(const char* p, int32_t numOfCols) {
          numOfCols * (sizeof(int8_t) + sizeof(int32_t));
 }
 
+static int32_t estimateJsonValueLen(const char* data) {
+  int32_t     jsonInnerType = *data;
+  const char* jsonInnerData = data + CHAR_BYTES;
+  if (jsonInnerType == TSDB_DATA_TYPE_NULL) {
+    return VARSTR_HEADER_SIZE + strlen(TSDB_DATA_NULL_STR_L);
+  } else if (tTagIsJson(data)) {
+    return VARSTR_HEADER_SIZE + ((const STag*)(data))->len;
+  } else if (jsonInnerType == TSDB_DATA_TYPE_NCHAR) {  // value -> "value"
+    return varDataTLen(jsonInnerData) + CHAR_BYTES * 2;
+  } else if (jsonInnerType == TSDB_DATA_TYPE_DOUBLE) {
+    return VARSTR_HEADER_SIZE + 32;
+  } else if (jsonInnerType == TSDB_DATA_TYPE_BOOL) {
+    return VARSTR_HEADER_SIZE + 5;
+  }
+
+  ASSERT(0);
+  return 0;
+}
+
+static void doConvertJsonValue(char* data, char* dst) {
+  int32_t jsonInnerType = *data;
+  char*   jsonInnerData = data + CHAR_BYTES;
+  if (jsonInnerType == TSDB_DATA_TYPE_NULL) {
+    sprintf(varDataVal(dst), "%s", TSDB_DATA_NULL_STR_L);
+    varDataSetLen(dst, strlen(varDataVal(dst)));
+  } else if (tTagIsJson(data)) {
+    char* jsonString = parseTagDatatoJson(data);
+    STR_TO_VARSTR(dst, jsonString);
+    taosMemoryFree(jsonString);
+  } else if (jsonInnerType == TSDB_DATA_TYPE_NCHAR) {  // value -> "value"
+    *(char*)varDataVal(dst) = '\"';
+    int32_t length = taosUcs4ToMbs((TdUcs4*)varDataVal(jsonInnerData), varDataLen(jsonInnerData),
+                                   varDataVal(dst) + CHAR_BYTES);
+    if (length <= 0) {
+      tscError("charset:%s to %s. convert failed.", DEFAULT_UNICODE_ENCODEC, tsCharset);
+      length = 0;
+    }
+    varDataSetLen(dst, length + CHAR_BYTES * 2);
+    *(char*)POINTER_SHIFT(varDataVal(dst), length + CHAR_BYTES) = '\"';
+  } else if (jsonInnerType == TSDB_DATA_TYPE_DOUBLE) {
+    double jsonVd = *(double*)(jsonInnerData);
+    sprintf(varDataVal(dst), "%.9lf", jsonVd);
+    varDataSetLen(dst, strlen(varDataVal(dst)));
+  } else if (jsonInnerType == TSDB_DATA_TYPE_BOOL) {
+    sprintf(varDataVal(dst), "%s", (*((char*)jsonInnerData) == 1) ? "true" : "false");
+    varDataSetLen(dst, strlen(varDataVal(dst)));
+  } else {
+    ASSERT(0);
+  }
+}
+
 static int32_t estimateJsonLen(SReqResultInfo* pResultInfo, int32_t numOfCols, int32_t numOfRows) {
   char* p = (char*)pResultInfo->pData;
 
@@ -1651,23 +1788,7 @@ static int32_t estimateJsonLen(SReqResultInfo* pResultInfo, int32_t numOfCols, i
         if (offset[j] == -1) {
           continue;
         }
-        char* data = offset[j] + pStart;
-
-        int32_t jsonInnerType = *data;
-        char*   jsonInnerData = data + CHAR_BYTES;
-        if (jsonInnerType == TSDB_DATA_TYPE_NULL) {
-          len += (VARSTR_HEADER_SIZE + strlen(TSDB_DATA_NULL_STR_L));
-        } else if (tTagIsJson(data)) {
-          len += (VARSTR_HEADER_SIZE + ((const STag*)(data))->len);
-        } else if (jsonInnerType == TSDB_DATA_TYPE_NCHAR) {  // value -> "value"
-          len += varDataTLen(jsonInnerData) + CHAR_BYTES * 2;
-        } else if (jsonInnerType == TSDB_DATA_TYPE_DOUBLE) {
-          len += (VARSTR_HEADER_SIZE + 32);
-        } else if (jsonInnerType == TSDB_DATA_TYPE_BOOL) {
-          len += (VARSTR_HEADER_SIZE + 5);
-        } else {
-          ASSERT(0);
-        }
+        len += estimateJsonValueLen(offset[j] + pStart);
       }
     } else if (IS_VAR_DATA_TYPE(pResultInfo->fields[i].type)) {
       int32_t lenTmp = numOfRows * sizeof(int32_t);
@@ -1742,38 +1863,8 @@ static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int
         if (offset[j] == -1) {
           continue;
         }
-        char* data = offset[j] + pStart;
-
-        int32_t jsonInnerType = *data;
-        char*   jsonInnerData = data + CHAR_BYTES;
-        char    dst[TSDB_MAX_JSON_TAG_LEN] = {0};
-        if (jsonInnerType == TSDB_DATA_TYPE_NULL) {
-          sprintf(varDataVal(dst), "%s", TSDB_DATA_NULL_STR_L);
-          varDataSetLen(dst, strlen(varDataVal(dst)));
-        } else if (tTagIsJson(data)) {
-          char* jsonString = parseTagDatatoJson(data);
-          STR_TO_VARSTR(dst, jsonString);
-          taosMemoryFree(jsonString);
-        } else if (jsonInnerType == TSDB_DATA_TYPE_NCHAR) {  // value -> "value"
-          *(char*)varDataVal(dst) = '\"';
-          int32_t length = taosUcs4ToMbs((TdUcs4*)varDataVal(jsonInnerData), varDataLen(jsonInnerData),
-                                         varDataVal(dst) + CHAR_BYTES);
-          if (length <= 0) {
-            tscError("charset:%s to %s. convert failed.", DEFAULT_UNICODE_ENCODEC, tsCharset);
-            length = 0;
-          }
-          varDataSetLen(dst, length + CHAR_BYTES * 2);
-          *(char*)POINTER_SHIFT(varDataVal(dst), length + CHAR_BYTES) = '\"';
-        } else if (jsonInnerType == TSDB_DATA_TYPE_DOUBLE) {
-          double jsonVd = *(double*)(jsonInnerData);
-          sprintf(varDataVal(dst), "%.9lf", jsonVd);
-          varDataSetLen(dst, strlen(varDataVal(dst)));
-        } else if (jsonInnerType == TSDB_DATA_TYPE_BOOL) {
-          sprintf(varDataVal(dst), "%s", (*((char*)jsonInnerData) == 1) ? "true" : "false");
-          varDataSetLen(dst, strlen(varDataVal(dst)));
-        } else {
-          ASSERT(0);
-        }
+        char dst[TSDB_MAX_JSON_TAG_LEN] = {0};
+        doConvertJsonValue(offset[j] + pStart, dst);
 
         offset1[j] = len;
         memcpy(pStart1 + len, dst, varDataTLen(dst));
@@ -1808,6 +1899,157 @@ static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int
   return TSDB_CODE_SUCCESS;
 }
 
+// remember where each column of a columnar block starts, nothing is decoded yet
+static int32_t doPrepareColumnar(SReqResultInfo* pResultInfo, int32_t numOfCols) {
+  if (pResultInfo->pColumnar == NULL) {
+    pResultInfo->pColumnar = taosMemoryCalloc(numOfCols, sizeof(SResultColumnar));
+    if (pResultInfo->pColumnar == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  const char* p = pResultInfo->pData;
+  int32_t     len = getVersion1BlockMetaSize(p, numOfCols);
+  int32_t*    colLength = (int32_t*)(p + len);
+  const char* pColInfo = p + len - numOfCols * (sizeof(int8_t) + sizeof(int32_t));
+  const char* pStart = p + len + sizeof(int32_t) * numOfCols;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SResultColumnar* pColumnar = &pResultInfo->pColumnar[i];
+    pColumnar->data.info.type = *(int8_t*)pColInfo;
+    pColumnar->data.info.bytes = *(int32_t*)(pColInfo + sizeof(int8_t));
+    pColInfo += sizeof(int8_t) + sizeof(int32_t);
+
+    pColumnar->pEncoded = pStart;
+    pColumnar->len = htonl(colLength[i]);
+    pStart += pColumnar->len;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doDecodeResultColumn(SReqResultInfo* pResultInfo, int32_t columnIndex) {
+  if (pResultInfo->pData == NULL || *(int32_t*)pResultInfo->pData != BLOCK_VERSION_COLUMNAR) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SResultColumnar* pColumnar = &pResultInfo->pColumnar[columnIndex];
+  if (pColumnar->pEncoded == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pData = &pColumnar->data;
+  if (colInfoDataEnsureCapacity(pData, pResultInfo->numOfRows) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (blockDecodeCol(pData, pColumnar->pEncoded, pColumnar->len, pResultInfo->numOfRows) < 0) {
+    return terrno;
+  }
+  pColumnar->pEncoded = NULL;
+
+  SResultColumn* pCol = &pResultInfo->pCol[columnIndex];
+  if (IS_VAR_DATA_TYPE(pData->info.type)) {
+    pCol->offset = pData->varmeta.offset;
+  } else {
+    pCol->nullbitmap = pData->nullbitmap;
+  }
+  pCol->pData = pData->pData;
+  pResultInfo->length[columnIndex] = pResultInfo->fields[columnIndex].bytes;
+  pResultInfo->row[columnIndex] = pCol->pData;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doConvertJsonCol(SReqResultInfo* pResultInfo, int32_t numOfRows, int32_t i) {
+  SResultColumn* pCol = &pResultInfo->pCol[i];
+  int32_t        len = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    if (pCol->offset[j] != -1) {
+      len += estimateJsonValueLen(pCol->offset[j] + pCol->pData);
+    }
+  }
+
+  char* p = taosMemoryRealloc(pResultInfo->convertBuf[i], len);
+  if (len > 0 && p == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pResultInfo->convertBuf[i] = p;
+
+  len = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    if (pCol->offset[j] == -1) {
+      continue;
+    }
+
+    char dst[TSDB_MAX_JSON_TAG_LEN] = {0};
+    doConvertJsonValue(pCol->offset[j] + pCol->pData, dst);
+    memcpy(p + len, dst, varDataTLen(dst));
+    pCol->offset[j] = len;
+    len += varDataTLen(dst);
+  }
+
+  pCol->pData = p;
+  pResultInfo->row[i] = p;
+  return TSDB_CODE_SUCCESS;
+}
+
+// The column as the version 1 path returns it: json as strings, nchar in the client charset if convertUcs4 is set.
+int32_t decodeResultColumn(SReqResultInfo* pResultInfo, int32_t columnIndex) {
+  if (pResultInfo->pData == NULL || *(int32_t*)pResultInfo->pData != BLOCK_VERSION_COLUMNAR ||
+      pResultInfo->pColumnar[columnIndex].pEncoded == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = doDecodeResultColumn(pResultInfo, columnIndex);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int8_t           type = pResultInfo->fields[columnIndex].type;
+  SColumnInfoData* pData = &pResultInfo->pColumnar[columnIndex].data;
+  if (type == TSDB_DATA_TYPE_JSON) {
+    code = doConvertJsonCol(pResultInfo, pResultInfo->numOfRows, columnIndex);
+  } else if (type == TSDB_DATA_TYPE_NCHAR && pResultInfo->convertUcs4 && pData->varmeta.length > 0) {
+    code = doConvertUCS4Col(pResultInfo, pResultInfo->numOfRows, columnIndex, pData->varmeta.length);
+  }
+  return code;
+}
+
+// decode all the columns and encode them again as a version 1 block
+static int32_t doDecodeColumnarBlock(SReqResultInfo* pResultInfo, int32_t numOfCols, int32_t numOfRows) {
+  int32_t code = doPrepareColumnar(pResultInfo, numOfCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SSDataBlock block = {0};
+  block.info.rows = numOfRows;
+  block.info.groupId = *(uint64_t*)(pResultInfo->pData + sizeof(int32_t) * 5);
+  block.pDataBlock = taosArrayInit(numOfCols, sizeof(SColumnInfoData));
+  if (block.pDataBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfCols && code == TSDB_CODE_SUCCESS; ++i) {
+    code = doDecodeResultColumn(pResultInfo, i);
+    taosArrayPush(block.pDataBlock, &pResultInfo->pColumnar[i].data);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    char* p = taosMemoryRealloc(pResultInfo->convertBlock, blockGetEncodeSize(&block));
+    if (p == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      int32_t len = 0;
+      blockEncode(&block, p, &len, numOfCols, 0);
+      pResultInfo->convertBlock = p;
+      pResultInfo->pData = p;
+    }
+  }
+
+  taosArrayDestroy(block.pDataBlock);
+  return code;
+}
+
 int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32_t numOfCols, int32_t numOfRows,
                          bool convertUcs4) {
   assert(numOfCols > 0 && pFields != NULL && pResultInfo != NULL);
@@ -1819,6 +2061,15 @@ int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
+
+  if (*(int32_t*)pResultInfo->pData == BLOCK_VERSION_COLUMNAR) {
+    code = pResultInfo->lazyDecode ? doPrepareColumnar(pResultInfo, numOfCols)
+                                   : doDecodeColumnarBlock(pResultInfo, numOfCols, numOfRows);
+    if (code != TSDB_CODE_SUCCESS || pResultInfo->lazyDecode) {
+      return code;
+    }
+  }
+
   code = doConvertJson(pResultInfo, numOfCols, numOfRows);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
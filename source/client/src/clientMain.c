@@ -66,6 +66,7 @@ void taos_cleanup(void) {
 
   fmFuncMgtDestroy();
   qCleanupKeywordsTable();
+  qCleanupCsvParseWorker();
   nodesDestroyAllocatorSet();
 
   id = clientConnRefPool;
@@ -622,6 +623,77 @@ int *taos_get_column_data_offset(TAOS_RES *res, int columnIndex) {
   return pResInfo->pCol[columnIndex].offset;
 }
 
+int taos_fetch_columns(TAOS_RES *res, int *numOfRows) {
+  (*numOfRows) = 0;
+  if (res == NULL || TD_RES_TMQ_META(res)) {
+    return 0;
+  }
+
+  if (TD_RES_TMQ(res) || TD_RES_TMQ_METADATA(res)) {
+    SReqResultInfo *pResultInfo = tmqGetNextResInfo(res, false);
+    if (pResultInfo == NULL) {
+      return 0;
+    }
+
+    pResultInfo->current = pResultInfo->numOfRows;
+    (*numOfRows) = pResultInfo->numOfRows;
+    return 0;
+  }
+
+  SRequestObj *pRequest = (SRequestObj *)res;
+
+  if (pRequest->type == TSDB_SQL_RETRIEVE_EMPTY_RESULT || pRequest->type == TSDB_SQL_INSERT ||
+      pRequest->code != TSDB_CODE_SUCCESS || taos_num_fields(res) == 0) {
+    return pRequest->code;
+  }
+
+  SReqResultInfo *pResultInfo = &pRequest->body.resInfo;
+
+  pResultInfo->lazyDecode = true;
+  doAsyncFetchRows(pRequest, false, true);
+  pResultInfo->lazyDecode = false;
+
+  pResultInfo->current = pResultInfo->numOfRows;
+  (*numOfRows) = pResultInfo->numOfRows;
+  return pRequest->code;
+}
+
+int taos_get_column_data(TAOS_RES *res, int columnIndex, TAOS_COLUMN_DATA *pData) {
+  if (res == NULL || pData == NULL || TD_RES_TMQ_META(res)) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  int32_t numOfFields = taos_num_fields(res);
+  if (columnIndex < 0 || columnIndex >= numOfFields) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  SReqResultInfo *pResInfo = tscGetCurResInfo(res);
+  TAOS_FIELD     *pField = &pResInfo->userFields[columnIndex];
+
+  memset(pData, 0, sizeof(TAOS_COLUMN_DATA));
+  pData->type = pField->type;
+  pData->bytes = pField->bytes;
+  if (pResInfo->pData == NULL || pResInfo->numOfRows == 0) {
+    return 0;
+  }
+
+  int32_t code = decodeResultColumn(pResInfo, columnIndex);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SResultColumn *pCol = &pResInfo->pCol[columnIndex];
+  pData->numOfRows = pResInfo->numOfRows;
+  if (IS_VAR_DATA_TYPE(pField->type)) {
+    pData->offset = pCol->offset;
+  } else {
+    pData->nullbitmap = pCol->nullbitmap;
+  }
+  pData->data = pCol->pData;
+  return 0;
+}
+
 int taos_validate_sql(TAOS *taos, const char *sql) {
   TAOS_RES *pObj = taosQueryImpl(taos, sql, true);
 
@@ -683,6 +755,8 @@ void destorySqlCallbackWrapper(SSqlCallbackWrapper *pWrapper) {
   destoryCatalogReq(pWrapper->pCatalogReq);
   qDestroyParseContext(pWrapper->pParseCtx);
   catalogFreeMetaData(pWrapper->pResultMeta);
+  taosMemoryFree(pWrapper->pPlanCacheKey);
+  qDestroyQueryConstants(pWrapper->pPlanCacheConsts);
   taosMemoryFree(pWrapper);
 }
 
@@ -810,6 +884,20 @@ void doAsyncQuery(SRequestObj *pRequest, bool updateMetaForce) {
     }
   }
 
+  if (TSDB_CODE_SUCCESS == code) {
+    SQueryPlan *pDag = NULL;
+    SArray     *pNodeList = NULL;
+    pRequest->metric.syntaxStart = taosGetTimestampUs();
+    code = planCacheLookup(pRequest, pWrapper, updateMetaForce, &pDag, &pNodeList);
+    pRequest->metric.syntaxEnd = taosGetTimestampUs();
+    if (TSDB_CODE_SUCCESS == code && NULL != pDag) {
+      atomic_add_fetch_64((int64_t *)&pTscObj->pAppInfo->summary.numOfQueryReq, 1);
+      pRequest->metric.ctgStart = pRequest->metric.syntaxEnd;
+      launchAsyncCachedQuery(pRequest, pDag, pNodeList, pWrapper);
+      return;
+    }
+  }
+
   if (TSDB_CODE_SUCCESS == code) {
     code = createParseContext(pRequest, &pWrapper->pParseCtx);
   }
@@ -1138,6 +1226,73 @@ _return:
   return code;
 }
 
+int taos_load_child_table_info(TAOS *taos, const char *stbName) {
+  if (NULL == taos) {
+    terrno = TSDB_CODE_TSC_DISCONNECTED;
+    return terrno;
+  }
+
+  if (NULL == stbName || 0 == strlen(stbName)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t      connId = *(int64_t *)taos;
+  int32_t      code = 0;
+  SRequestObj *pRequest = NULL;
+  char         db[TSDB_DB_NAME_LEN] = {0};
+  char         tb[TSDB_TABLE_NAME_LEN] = {0};
+
+  char *sql = "taos_load_child_table_info";
+  code = buildRequest(connId, sql, strlen(sql), NULL, false, &pRequest);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto _return;
+  }
+
+  STscObj    *pTscObj = pRequest->pTscObj;
+  const char *p = strchr(stbName, '.');
+  if (p) {
+    if (p - stbName >= sizeof(db) || strlen(p + 1) >= sizeof(tb)) {
+      code = TSDB_CODE_TSC_INVALID_OPERATION;
+      goto _return;
+    }
+    memcpy(db, stbName, p - stbName);
+    strcpy(tb, p + 1);
+  } else {
+    if (strlen(stbName) >= sizeof(tb)) {
+      code = TSDB_CODE_TSC_INVALID_OPERATION;
+      goto _return;
+    }
+    tstrncpy(db, pTscObj->db, sizeof(db));
+    strcpy(tb, stbName);
+  }
+
+  if (0 == strlen(db)) {
+    code = TSDB_CODE_TSC_DB_NOT_SELECTED;
+    goto _return;
+  }
+
+  SName name = {0};
+  toName(pTscObj->acctId, db, tb, &name);
+
+  SCatalog *pCtg = NULL;
+  code = catalogGetHandle(pTscObj->pAppInfo->clusterId, &pCtg);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _return;
+  }
+
+  SRequestConnInfo conn = {
+      .pTrans = pTscObj->pAppInfo->pTransporter, .requestId = pRequest->requestId, .requestObjRefId = pRequest->self};
+
+  conn.mgmtEps = getEpSet_s(&pTscObj->pAppInfo->mgmtEp);
+
+  code = catalogPrefetchChildTableMeta(pCtg, &conn, &name);
+
+_return:
+  destroyRequest(pRequest);
+  return code;
+}
+
 TAOS_STMT *taos_stmt_init(TAOS *taos) {
   STscObj *pObj = acquireTscObj(*(int64_t *)taos);
   if (NULL == pObj) {
@@ -1370,6 +1525,40 @@ int taos_stmt_affected_rows_once(TAOS_STMT *stmt) {
   return stmtAffectedRowsOnce(stmt);
 }
 
+int taos_stmt_set_async(TAOS_STMT *stmt, __taos_async_fn_t fp, void *param) {
+  if (stmt == NULL) {
+    tscError("NULL parameter for %s", __FUNCTION__);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return terrno;
+  }
+
+  return stmtSetAsync(stmt, fp, param);
+}
+
+int taos_stmt_bind_tables(TAOS_STMT *stmt, int numOfTables, const char **tbnames, TAOS_MULTI_BIND **binds) {
+  if (stmt == NULL || tbnames == NULL || binds == NULL) {
+    tscError("NULL parameter for %s", __FUNCTION__);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return terrno;
+  }
+
+  if (numOfTables <= 0) {
+    tscError("invalid table num %d", numOfTables);
+    terrno = TSDB_CODE_INVALID_PARA;
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    if (tbnames[i] == NULL || binds[i] == NULL || binds[i]->num <= 0 || binds[i]->num > INT16_MAX) {
+      tscError("invalid bind of table %d", i);
+      terrno = TSDB_CODE_INVALID_PARA;
+      return terrno;
+    }
+  }
+
+  return stmtBindTables(stmt, numOfTables, tbnames, binds);
+}
+
 int taos_stmt_close(TAOS_STMT *stmt) {
   if (stmt == NULL) {
     tscError("NULL parameter for %s", __FUNCTION__);
@@ -0,0 +1,1096 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clientInt.h"
+#include "clientLog.h"
+#include "tglobal.h"
+#include "ttime.h"
+#include "ttokendef.h"
+#include "tvariant.h"
+
+#define PLAN_CACHE_INVALID_VG_VERSION (-1)  // vgVersion catalogGetDBVgVersion reports for a db it does not cache
+
+typedef struct SPlanCacheConst {
+  char*       literal;
+  SValueNode* pParam;  // bound value of a stmt placeholder, whose literal is "?<placeholderNo>" in the plan
+  bool        isTs;
+  int64_t     ts;           // the constant as a timestamp of the plan precision
+  int32_t     numOfValues;  // value nodes bound to the constant
+  int32_t     numOfBounds;  // scan time range bounds bound to the constant
+} SPlanCacheConst;
+
+typedef struct SPlanCacheDb {
+  char    dbFName[TSDB_DB_FNAME_LEN];
+  int64_t dbId;
+  int32_t vgVersion;
+} SPlanCacheDb;
+
+typedef struct SPlanCacheTable {
+  SName    name;
+  uint64_t uid;
+  int32_t  sversion;
+  int32_t  tversion;
+} SPlanCacheTable;
+
+typedef struct SPlanCacheSubplan {
+  int32_t        level;
+  SQueryNodeStat execNodeStat;
+  int32_t        msgLen;
+  char*          pMsg;
+  SArray*        pChildren;  // int32_t, index of the child subplans
+} SPlanCacheSubplan;
+
+// A physical plan of a select, with the constants it was built with and the catalog versions it depends on.
+struct SPlanCacheEntry {
+  bool               uncacheable;  // negative entry, the query is planned every time without trying to cache it
+  bool               placeholder;  // constants are stmt placeholders, rebound with bind values instead of literals
+  int32_t            msgType;
+  int8_t             precision;
+  bool               stableQuery;
+  int32_t            numOfResCols;
+  SSchema*           pResSchema;
+  SArray*            pDbList;    // char[TSDB_DB_FNAME_LEN]
+  SArray*            pTableList;  // SName
+  SArray*            pDbs;        // SPlanCacheDb
+  SArray*            pTables;     // SPlanCacheTable
+  SArray*            pNodeList;   // SQueryNodeLoad
+  int32_t            numOfConsts;
+  SPlanCacheConst*   pConsts;
+  int32_t            numOfSubplans;
+  SPlanCacheSubplan* pSubplans;  // level by level, as in SQueryPlan
+};
+
+typedef struct SPlanCacheBindCxt {
+  bool             stamp;  // only name the placeholders of a plan about to be cached
+  int8_t           precision;
+  int32_t          numOfConsts;
+  SPlanCacheConst* pOld;
+  SPlanCacheConst* pNew;
+  int32_t          code;
+} SPlanCacheBindCxt;
+
+void planCacheDestroyEntry(SPlanCacheEntry* pEntry) {
+  if (NULL == pEntry) return;
+
+  taosMemoryFree(pEntry->pResSchema);
+  taosArrayDestroy(pEntry->pDbList);
+  taosArrayDestroy(pEntry->pTableList);
+  taosArrayDestroy(pEntry->pDbs);
+  taosArrayDestroy(pEntry->pTables);
+  taosArrayDestroy(pEntry->pNodeList);
+  for (int32_t i = 0; i < pEntry->numOfConsts; ++i) {
+    taosMemoryFree(pEntry->pConsts[i].literal);
+  }
+  taosMemoryFree(pEntry->pConsts);
+  for (int32_t i = 0; i < pEntry->numOfSubplans; ++i) {
+    taosMemoryFree(pEntry->pSubplans[i].pMsg);
+    taosArrayDestroy(pEntry->pSubplans[i].pChildren);
+  }
+  taosMemoryFree(pEntry->pSubplans);
+  taosMemoryFree(pEntry);
+}
+
+static void planCacheDeleteEntry(const void* key, size_t keyLen, void* value) {
+  planCacheDestroyEntry((SPlanCacheEntry*)value);
+}
+
+SLRUCache* planCacheOpen(int64_t capacity) {
+  if (capacity <= 0) return NULL;
+
+  SLRUCache* pCache = taosLRUCacheInit(capacity, -1, .5);
+  if (NULL == pCache) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  taosLRUCacheSetStrictCapacity(pCache, false);
+  return pCache;
+}
+
+void planCacheClose(SLRUCache* pCache) {
+  if (NULL == pCache) return;
+
+  taosLRUCacheEraseUnrefEntries(pCache);
+  taosLRUCacheCleanup(pCache);
+}
+
+static bool planCacheConstToTs(SQueryConstant* pConst, int8_t precision, int64_t* pTs) {
+  int32_t len = strlen(pConst->literal);
+  if (TK_NK_INTEGER == pConst->type) {
+    return TSDB_CODE_SUCCESS == toInteger(pConst->literal, len, 10, pTs);
+  }
+  if (TK_NK_STRING == pConst->type) {
+    return TSDB_CODE_SUCCESS == taosParseTime(pConst->literal, pTs, len, precision, tsDaylight);
+  }
+  return false;
+}
+
+static bool planCacheParamToTs(const SValueNode* pParam, int8_t precision, int64_t* pTs) {
+  int8_t type = pParam->node.resType.type;
+  if (TSDB_DATA_TYPE_TIMESTAMP == type || IS_SIGNED_NUMERIC_TYPE(type)) {
+    *pTs = pParam->datum.i;
+    return true;
+  }
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    *pTs = (int64_t)pParam->datum.u;
+    return pParam->datum.u <= INT64_MAX;
+  }
+  if (TSDB_DATA_TYPE_VARCHAR == type) {
+    return TSDB_CODE_SUCCESS ==
+           taosParseTime(varDataVal(pParam->datum.p), pTs, varDataLen(pParam->datum.p), precision, tsDaylight);
+  }
+  return false;
+}
+
+static int32_t planCacheInitParams(SArray* pParams, int8_t precision, SPlanCacheConst** ppConsts) {
+  int32_t          num = taosArrayGetSize(pParams);
+  SPlanCacheConst* pConsts = (SPlanCacheConst*)taosMemoryCalloc(TMAX(num, 1), sizeof(SPlanCacheConst));
+  if (NULL == pConsts) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    pConsts[i].pParam = (SValueNode*)taosArrayGetP(pParams, i);
+    pConsts[i].isTs = planCacheParamToTs(pConsts[i].pParam, precision, &pConsts[i].ts);
+  }
+  *ppConsts = pConsts;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t planCacheInitConsts(SArray* pArray, int8_t precision, SPlanCacheConst** ppConsts) {
+  int32_t          num = taosArrayGetSize(pArray);
+  SPlanCacheConst* pConsts = (SPlanCacheConst*)taosMemoryCalloc(TMAX(num, 1), sizeof(SPlanCacheConst));
+  if (NULL == pConsts) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    SQueryConstant* pConst = (SQueryConstant*)taosArrayGet(pArray, i);
+    pConsts[i].literal = pConst->literal;
+    pConsts[i].isTs = planCacheConstToTs(pConst, precision, &pConsts[i].ts);
+  }
+  *ppConsts = pConsts;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Same conversions as the translater does for the value type, the value node keeps its type.
+static int32_t planCacheSetValue(SValueNode* pVal, const char* literal) {
+  int32_t len = strlen(literal);
+  int32_t code = TSDB_CODE_SUCCESS;
+  switch (pVal->node.resType.type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      code = toInteger(literal, len, 10, &pVal->datum.i);
+      *(int64_t*)&pVal->typeData = pVal->datum.i;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      code = toUInteger(literal, len, 10, &pVal->datum.u);
+      *(uint64_t*)&pVal->typeData = pVal->datum.u;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      pVal->datum.d = taosStr2Double(literal, NULL);
+      *(double*)&pVal->typeData = pVal->datum.d;
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      if (TSDB_CODE_SUCCESS !=
+          taosParseTime(literal, &pVal->datum.i, len, pVal->node.resType.precision, tsDaylight)) {
+        char* pEnd = NULL;
+        pVal->datum.i = taosStr2Int64(literal, &pEnd, 10);
+        code = (NULL != pEnd && '\0' == *pEnd) ? TSDB_CODE_SUCCESS : TSDB_CODE_FAILED;
+      }
+      *(int64_t*)&pVal->typeData = pVal->datum.i;
+      break;
+    case TSDB_DATA_TYPE_VARCHAR:
+    case TSDB_DATA_TYPE_VARBINARY:
+      // the decoded buffer holds the bytes of the original literal, a longer one would change the value type
+      if (len > pVal->node.resType.bytes - VARSTR_HEADER_SIZE) {
+        return TSDB_CODE_FAILED;
+      }
+      memcpy(varDataVal(pVal->datum.p), literal, len);
+      varDataSetLen(pVal->datum.p, len);
+      break;
+    case TSDB_DATA_TYPE_NCHAR: {
+      int32_t output = 0;
+      if (!taosMbsToUcs4(literal, len, (TdUcs4*)varDataVal(pVal->datum.p),
+                         pVal->node.resType.bytes - VARSTR_HEADER_SIZE, &output)) {
+        return TSDB_CODE_FAILED;
+      }
+      varDataSetLen(pVal->datum.p, output);
+      break;
+    }
+    default:
+      return TSDB_CODE_FAILED;
+  }
+  if (TSDB_CODE_SUCCESS != code) {
+    return TSDB_CODE_FAILED;
+  }
+
+  char* p = (char*)taosMemoryStrDup(literal);
+  if (NULL == p) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosMemoryFree(pVal->literal);
+  pVal->literal = p;
+  return TSDB_CODE_SUCCESS;
+}
+
+// A placeholder keeps the type of its bind value through translation, later values must come in the same type.
+static int32_t planCacheSetParam(SValueNode* pVal, const SValueNode* pParam) {
+  if (pParam->node.resType.type != pVal->node.resType.type) {
+    return TSDB_CODE_FAILED;
+  }
+
+  if (IS_VAR_DATA_TYPE(pParam->node.resType.type)) {
+    int32_t len = varDataTLen(pParam->datum.p);
+    char*   p = (char*)taosMemoryCalloc(1, len + 1);
+    if (NULL == p) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memcpy(p, pParam->datum.p, len);
+    taosMemoryFree(pVal->datum.p);
+    pVal->datum.p = p;
+  } else {
+    pVal->datum = pParam->datum;
+  }
+  pVal->typeData = pParam->typeData;
+  pVal->node.resType.bytes = pParam->node.resType.bytes;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t planCacheStampParam(SValueNode* pVal) {
+  char literal[16];
+  snprintf(literal, sizeof(literal), "?%d", pVal->placeholderNo);
+  char* p = (char*)taosMemoryStrDup(literal);
+  if (NULL == p) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosMemoryFree(pVal->literal);
+  pVal->literal = p;
+  return TSDB_CODE_SUCCESS;
+}
+
+static EDealRes planCacheBindValue(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_VALUE != nodeType(pNode)) {
+    return DEAL_RES_CONTINUE;
+  }
+
+  SPlanCacheBindCxt* pCxt = (SPlanCacheBindCxt*)pContext;
+  SValueNode*        pVal = (SValueNode*)pNode;
+  if (pCxt->stamp) {
+    if (pVal->placeholderNo > 0) {
+      pCxt->code = planCacheStampParam(pVal);
+    }
+    return TSDB_CODE_SUCCESS == pCxt->code ? DEAL_RES_CONTINUE : DEAL_RES_ERROR;
+  }
+  if (NULL == pVal->literal || pVal->isDuration || pVal->isNull || pVal->placeholderNo > 0) {
+    return DEAL_RES_CONTINUE;
+  }
+  for (int32_t i = 0; i < pCxt->numOfConsts; ++i) {
+    if (0 == strcmp(pVal->literal, pCxt->pOld[i].literal)) {
+      pCxt->code = (NULL != pCxt->pNew[i].pParam) ? planCacheSetParam(pVal, pCxt->pNew[i].pParam)
+                                                  : planCacheSetValue(pVal, pCxt->pNew[i].literal);
+      if (TSDB_CODE_SUCCESS != pCxt->code) {
+        return DEAL_RES_ERROR;
+      }
+      ++pCxt->pNew[i].numOfValues;
+      break;
+    }
+  }
+  return DEAL_RES_CONTINUE;
+}
+
+static int32_t planCacheBindCond(SPlanCacheBindCxt* pCxt, SNode* pCond) {
+  if (NULL != pCond) {
+    nodesWalkExpr(pCond, planCacheBindValue, pCxt);
+  }
+  return pCxt->code;
+}
+
+static bool planCacheTsNear(int64_t bound, int64_t ts) {
+  uint64_t diff = (bound > ts) ? (uint64_t)bound - (uint64_t)ts : (uint64_t)ts - (uint64_t)bound;
+  return diff <= 1;
+}
+
+// The optimizer moves primary key conditions into the scan range, where `ts > c` shows up as c + 1 and `ts < c` as
+// c - 1. A bound follows the only constant within one of it, bounds no constant is near (open ranges) stay as they are.
+static int32_t planCacheBindTsBound(SPlanCacheBindCxt* pCxt, int64_t* pBound) {
+  int32_t idx = -1;
+  for (int32_t i = 0; i < pCxt->numOfConsts; ++i) {
+    if (pCxt->pOld[i].isTs && planCacheTsNear(*pBound, pCxt->pOld[i].ts)) {
+      if (idx >= 0) {
+        return TSDB_CODE_FAILED;
+      }
+      idx = i;
+    }
+  }
+  if (idx < 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SPlanCacheConst* pNew = pCxt->pNew + idx;
+  int64_t          delta = *pBound - pCxt->pOld[idx].ts;
+  if (!pNew->isTs || (delta > 0 && INT64_MAX == pNew->ts) || (delta < 0 && INT64_MIN == pNew->ts)) {
+    return TSDB_CODE_FAILED;
+  }
+  *pBound = pNew->ts + delta;
+  ++pNew->numOfBounds;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t planCacheBindPhysiNode(SPlanCacheBindCxt* pCxt, SPhysiNode* pNode) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  switch (nodeType(pNode)) {
+    case QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN:
+    case QUERY_NODE_PHYSICAL_PLAN_TABLE_SEQ_SCAN:
+    case QUERY_NODE_PHYSICAL_PLAN_TABLE_MERGE_SCAN: {
+      STableScanPhysiNode* pScan = (STableScanPhysiNode*)pNode;
+      if (pNode->pOutputDataBlockDesc->precision != pCxt->precision) {
+        return TSDB_CODE_FAILED;
+      }
+      code = planCacheBindTsBound(pCxt, &pScan->scanRange.skey);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = planCacheBindTsBound(pCxt, &pScan->scanRange.ekey);
+      }
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN: {
+      SSortMergeJoinPhysiNode* pJoin = (SSortMergeJoinPhysiNode*)pNode;
+      code = planCacheBindCond(pCxt, pJoin->pMergeCondition);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = planCacheBindCond(pCxt, pJoin->pOnConditions);
+      }
+      break;
+    }
+    case QUERY_NODE_PHYSICAL_PLAN_TAG_SCAN:
+    case QUERY_NODE_PHYSICAL_PLAN_LAST_ROW_SCAN:
+    case QUERY_NODE_PHYSICAL_PLAN_PROJECT:
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG:
+    case QUERY_NODE_PHYSICAL_PLAN_EXCHANGE:
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE:
+    case QUERY_NODE_PHYSICAL_PLAN_SORT:
+    case QUERY_NODE_PHYSICAL_PLAN_GROUP_SORT:
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL:
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_INTERVAL:
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_ALIGNED_INTERVAL:
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_SESSION:
+    case QUERY_NODE_PHYSICAL_PLAN_MERGE_STATE:
+    case QUERY_NODE_PHYSICAL_PLAN_PARTITION:
+    case QUERY_NODE_PHYSICAL_PLAN_INDEF_ROWS_FUNC:
+      break;
+    default:
+      // fill and interp validate their time range against the interval at translation, system tables are
+      // answered from mnode state
+      return TSDB_CODE_FAILED;
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBindCond(pCxt, pNode->pConditions);
+  }
+
+  SNode* pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) {
+    if (TSDB_CODE_SUCCESS != code) break;
+    code = planCacheBindPhysiNode(pCxt, (SPhysiNode*)pChild);
+  }
+  return code;
+}
+
+// Constants are only rebound inside conditions and scan ranges, where no translation check depends on their value.
+static int32_t planCacheBindSubplan(SPlanCacheBindCxt* pCxt, SSubplan* pSubplan) {
+  if (SUBPLAN_TYPE_MODIFY == pSubplan->subplanType || NULL == pSubplan->pNode ||
+      (NULL != pSubplan->pDataSink && QUERY_NODE_PHYSICAL_PLAN_DISPATCH != nodeType(pSubplan->pDataSink))) {
+    return TSDB_CODE_FAILED;
+  }
+
+  int32_t code = planCacheBindCond(pCxt, pSubplan->pTagCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBindCond(pCxt, pSubplan->pTagIndexCond);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBindPhysiNode(pCxt, pSubplan->pNode);
+  }
+  return code;
+}
+
+static int32_t planCachePushSubplan(SQueryPlan* pDag, int32_t level, SSubplan* pSubplan) {
+  SNodeListNode* pGroup = NULL;
+  if (level >= LIST_LENGTH(pDag->pSubplans)) {
+    pGroup = (SNodeListNode*)nodesMakeNode(QUERY_NODE_NODE_LIST);
+    if (NULL == pGroup) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    if (TSDB_CODE_SUCCESS != nodesListStrictAppend(pDag->pSubplans, (SNode*)pGroup)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  } else {
+    pGroup = (SNodeListNode*)nodesListGetNode(pDag->pSubplans, level);
+  }
+  return nodesListMakeAppend(&pGroup->pNodeList, (SNode*)pSubplan);
+}
+
+// Decode the cached subplans, bind pConsts into them and link them up again, as qCreateQueryPlan would have.
+static int32_t planCacheBuildPlan(SPlanCacheEntry* pEntry, SPlanCacheConst* pConsts, uint64_t queryId,
+                                  SQueryPlan** ppDag) {
+  SPlanCacheBindCxt cxt = {.precision = pEntry->precision,
+                           .numOfConsts = pEntry->numOfConsts,
+                           .pOld = pEntry->pConsts,
+                           .pNew = pConsts,
+                           .code = TSDB_CODE_SUCCESS};
+
+  SSubplan**  pSubplans = (SSubplan**)taosMemoryCalloc(pEntry->numOfSubplans, POINTER_BYTES);
+  SQueryPlan* pDag = (SQueryPlan*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN);
+  int32_t     code = TSDB_CODE_SUCCESS;
+  if (NULL == pSubplans || NULL == pDag || NULL == (pDag->pSubplans = nodesMakeList())) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  } else {
+    pDag->queryId = queryId;
+    pDag->numOfSubplans = pEntry->numOfSubplans;
+    pDag->explainInfo.mode = EXPLAIN_MODE_DISABLE;
+  }
+
+  // the decoder converts the tlv headers in place, the cached msg is shared by every lookup of the entry
+  char* pMsg = NULL;
+  if (TSDB_CODE_SUCCESS == code) {
+    int32_t maxLen = 0;
+    for (int32_t i = 0; i < pEntry->numOfSubplans; ++i) {
+      maxLen = TMAX(maxLen, pEntry->pSubplans[i].msgLen);
+    }
+    pMsg = (char*)taosMemoryMalloc(TMAX(maxLen, 1));
+    if (NULL == pMsg) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < pEntry->numOfSubplans; ++i) {
+    SPlanCacheSubplan* pCached = pEntry->pSubplans + i;
+    memcpy(pMsg, pCached->pMsg, pCached->msgLen);
+    code = qMsgToSubplan(pMsg, pCached->msgLen, pSubplans + i);
+    if (TSDB_CODE_SUCCESS == code) {
+      pSubplans[i]->id.queryId = queryId;
+      pSubplans[i]->execNodeStat = pCached->execNodeStat;
+      code = planCachePushSubplan(pDag, pCached->level, pSubplans[i]);
+      if (TSDB_CODE_SUCCESS != code) {
+        nodesDestroyNode((SNode*)pSubplans[i]);
+      }
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      code = planCacheBindSubplan(&cxt, pSubplans[i]);
+    }
+  }
+
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < pEntry->numOfSubplans; ++i) {
+    SArray* pChildren = pEntry->pSubplans[i].pChildren;
+    for (int32_t j = 0; TSDB_CODE_SUCCESS == code && j < taosArrayGetSize(pChildren); ++j) {
+      SSubplan* pChild = pSubplans[*(int32_t*)taosArrayGet(pChildren, j)];
+      code = nodesListMakeAppend(&pSubplans[i]->pChildren, (SNode*)pChild);
+      if (TSDB_CODE_SUCCESS == code) {
+        code = nodesListMakeAppend(&pChild->pParents, (SNode*)pSubplans[i]);
+      }
+    }
+  }
+
+  taosMemoryFree(pMsg);
+  taosMemoryFree(pSubplans);
+  if (TSDB_CODE_SUCCESS == code) {
+    *ppDag = pDag;
+  } else {
+    qDestroyQueryPlan(pDag);
+  }
+  return code;
+}
+
+static int32_t planCacheFindSubplan(SQueryPlan* pDag, SSubplan* pTarget) {
+  int32_t idx = 0;
+  SNode*  pLevel = NULL;
+  FOREACH(pLevel, pDag->pSubplans) {
+    SNode* pSubplan = NULL;
+    FOREACH(pSubplan, ((SNodeListNode*)pLevel)->pNodeList) {
+      if ((SSubplan*)pSubplan == pTarget) {
+        return idx;
+      }
+      ++idx;
+    }
+  }
+  return -1;
+}
+
+static int32_t planCacheSaveSubplans(SPlanCacheEntry* pEntry, SQueryPlan* pDag) {
+  pEntry->pSubplans = (SPlanCacheSubplan*)taosMemoryCalloc(pDag->numOfSubplans, sizeof(SPlanCacheSubplan));
+  if (NULL == pEntry->pSubplans) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t level = 0;
+  SNode*  pLevel = NULL;
+  FOREACH(pLevel, pDag->pSubplans) {
+    SNode* pNode = NULL;
+    FOREACH(pNode, ((SNodeListNode*)pLevel)->pNodeList) {
+      SSubplan*          pSubplan = (SSubplan*)pNode;
+      SPlanCacheSubplan* pCached = pEntry->pSubplans + pEntry->numOfSubplans;
+      if (pEntry->numOfSubplans >= pDag->numOfSubplans) {
+        return TSDB_CODE_FAILED;
+      }
+      ++pEntry->numOfSubplans;
+
+      pCached->level = level;
+      pCached->execNodeStat = pSubplan->execNodeStat;
+      code = qSubPlanToMsg(pSubplan, &pCached->pMsg, &pCached->msgLen);
+      if (TSDB_CODE_SUCCESS == code) {
+        pCached->pChildren = taosArrayInit(LIST_LENGTH(pSubplan->pChildren), sizeof(int32_t));
+        if (NULL == pCached->pChildren) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+        }
+      }
+      SNode* pChild = NULL;
+      FOREACH(pChild, pSubplan->pChildren) {
+        if (TSDB_CODE_SUCCESS != code) break;
+        int32_t idx = planCacheFindSubplan(pDag, (SSubplan*)pChild);
+        if (idx < 0 || NULL == taosArrayPush(pCached->pChildren, &idx)) {
+          code = TSDB_CODE_FAILED;
+        }
+      }
+      if (TSDB_CODE_SUCCESS != code) {
+        return code;
+      }
+    }
+    ++level;
+  }
+  return pEntry->numOfSubplans == pDag->numOfSubplans ? TSDB_CODE_SUCCESS : TSDB_CODE_FAILED;
+}
+
+// Number of value nodes carrying the literal anywhere in the subplan, counted on its json form since no walker
+// covers all physical nodes.
+static int32_t planCacheCountLiteral(const char* pJson, const char* literal) {
+  char    pattern[TSDB_MAX_BYTES_PER_ROW];
+  int32_t len = snprintf(pattern, sizeof(pattern), "\"Literal\":\"%s\"", literal);
+  if (len >= sizeof(pattern)) {
+    return -1;
+  }
+
+  int32_t     num = 0;
+  const char* p = pJson;
+  while (NULL != (p = strstr(p, pattern))) {
+    ++num;
+    p += len;
+  }
+  return num;
+}
+
+static bool planCacheLiteralIsPlain(const char* literal) {
+  for (const char* p = literal; '\0' != *p; ++p) {
+    if ('"' == *p || '\\' == *p || (uint8_t)*p < 0x20) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Every constant must be bound somewhere, and every value node carrying it must be in a place it is bound in.
+// Otherwise it went through constant folding, a function parameter check or a clause the cache leaves alone.
+static int32_t planCacheCheckBinding(SPlanCacheEntry* pEntry, SPlanCacheConst* pConsts, SQueryPlan* pDag) {
+  for (int32_t i = 0; i < pEntry->numOfConsts; ++i) {
+    if (!planCacheLiteralIsPlain(pEntry->pConsts[i].literal) ||
+        0 == pConsts[i].numOfValues + pConsts[i].numOfBounds) {
+      return TSDB_CODE_FAILED;
+    }
+    for (int32_t j = 0; j < i; ++j) {
+      if (0 == strcmp(pEntry->pConsts[i].literal, pEntry->pConsts[j].literal)) {
+        return TSDB_CODE_FAILED;
+      }
+    }
+  }
+
+  int32_t* pNum = (int32_t*)taosMemoryCalloc(TMAX(pEntry->numOfConsts, 1), sizeof(int32_t));
+  if (NULL == pNum) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  SNode*  pLevel = NULL;
+  FOREACH(pLevel, pDag->pSubplans) {
+    SNode* pNode = NULL;
+    FOREACH(pNode, ((SNodeListNode*)pLevel)->pNodeList) {
+      char*   pJson = NULL;
+      int32_t len = 0;
+      code = nodesNodeToString(pNode, false, &pJson, &len);
+      if (TSDB_CODE_SUCCESS == code && pEntry->placeholder && 0 != planCacheCountLiteral(pJson, "?")) {
+        // a placeholder outside the places the stamp walks through
+        code = TSDB_CODE_FAILED;
+      }
+      for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < pEntry->numOfConsts; ++i) {
+        int32_t num = planCacheCountLiteral(pJson, pEntry->pConsts[i].literal);
+        if (num < 0) {
+          code = TSDB_CODE_FAILED;
+        } else {
+          pNum[i] += num;
+        }
+      }
+      taosMemoryFree(pJson);
+      if (TSDB_CODE_SUCCESS != code) break;
+    }
+    if (TSDB_CODE_SUCCESS != code) break;
+  }
+
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < pEntry->numOfConsts; ++i) {
+    if (pNum[i] != pConsts[i].numOfValues) {
+      code = TSDB_CODE_FAILED;
+    }
+  }
+  taosMemoryFree(pNum);
+  return code;
+}
+
+static int32_t planCacheSaveMeta(SRequestObj* pRequest, SPlanCacheEntry* pEntry) {
+  STscObj*  pTscObj = pRequest->pTscObj;
+  SCatalog* pCtg = NULL;
+  int32_t   code = catalogGetHandle(pTscObj->pAppInfo->clusterId, &pCtg);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
+  SRequestConnInfo conn = {.pTrans = pTscObj->pAppInfo->pTransporter,
+                           .requestId = pRequest->requestId,
+                           .requestObjRefId = pRequest->self,
+                           .mgmtEps = getEpSet_s(&pTscObj->pAppInfo->mgmtEp)};
+
+  int32_t dbNum = taosArrayGetSize(pRequest->dbList);
+  int32_t tbNum = taosArrayGetSize(pRequest->tableList);
+  pEntry->pDbList = taosArrayDup(pRequest->dbList);
+  pEntry->pTableList = taosArrayDup(pRequest->tableList);
+  pEntry->pDbs = taosArrayInit(TMAX(dbNum, 1), sizeof(SPlanCacheDb));
+  pEntry->pTables = taosArrayInit(TMAX(tbNum, 1), sizeof(SPlanCacheTable));
+  if ((dbNum > 0 && NULL == pEntry->pDbList) || (tbNum > 0 && NULL == pEntry->pTableList) || NULL == pEntry->pDbs ||
+      NULL == pEntry->pTables) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // versions are read after planning, a change in between is caught by the server and retried without the cache
+  for (int32_t i = 0; i < dbNum; ++i) {
+    SPlanCacheDb db = {0};
+    int32_t      tableNum = 0;
+    tstrncpy(db.dbFName, (const char*)taosArrayGet(pRequest->dbList, i), TSDB_DB_FNAME_LEN);
+    code = catalogGetDBVgVersion(pCtg, db.dbFName, &db.vgVersion, &db.dbId, &tableNum);
+    if (TSDB_CODE_SUCCESS != code) {
+      return code;
+    }
+    if (PLAN_CACHE_INVALID_VG_VERSION == db.vgVersion) {
+      return TSDB_CODE_FAILED;
+    }
+    taosArrayPush(pEntry->pDbs, &db);
+  }
+
+  for (int32_t i = 0; i < tbNum; ++i) {
+    SPlanCacheTable tb = {.name = *(SName*)taosArrayGet(pRequest->tableList, i)};
+    STableMeta*     pMeta = NULL;
+    code = catalogGetCachedTableMeta(pCtg, &conn, &tb.name, &pMeta);
+    if (TSDB_CODE_SUCCESS != code) {
+      return code;
+    }
+    if (NULL == pMeta) {
+      return TSDB_CODE_FAILED;
+    }
+    tb.uid = pMeta->uid;
+    tb.sversion = pMeta->sversion;
+    tb.tversion = pMeta->tversion;
+    taosMemoryFree(pMeta);
+    taosArrayPush(pEntry->pTables, &tb);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool planCacheMetaValid(SRequestObj* pRequest, SPlanCacheEntry* pEntry) {
+  STscObj*  pTscObj = pRequest->pTscObj;
+  SCatalog* pCtg = NULL;
+  if (TSDB_CODE_SUCCESS != catalogGetHandle(pTscObj->pAppInfo->clusterId, &pCtg)) {
+    return false;
+  }
+
+  SRequestConnInfo conn = {.pTrans = pTscObj->pAppInfo->pTransporter,
+                           .requestId = pRequest->requestId,
+                           .requestObjRefId = pRequest->self,
+                           .mgmtEps = getEpSet_s(&pTscObj->pAppInfo->mgmtEp)};
+  bool             superUser = (0 == strcmp(pTscObj->user, TSDB_DEFAULT_USER));
+
+  for (int32_t i = 0; i < taosArrayGetSize(pEntry->pDbs); ++i) {
+    SPlanCacheDb* pDb = (SPlanCacheDb*)taosArrayGet(pEntry->pDbs, i);
+    int32_t       vgVersion = PLAN_CACHE_INVALID_VG_VERSION;
+    int64_t       dbId = 0;
+    int32_t       tableNum = 0;
+    if (TSDB_CODE_SUCCESS != catalogGetDBVgVersion(pCtg, pDb->dbFName, &vgVersion, &dbId, &tableNum) ||
+        vgVersion != pDb->vgVersion || dbId != pDb->dbId) {
+      return false;
+    }
+
+    bool pass = false;
+    bool exists = false;
+    if (!superUser && (TSDB_CODE_SUCCESS != catalogChkAuthFromCache(pCtg, &conn, pTscObj->user, pDb->dbFName,
+                                                                     AUTH_TYPE_READ, &pass, &exists) ||
+                       !exists || !pass)) {
+      return false;
+    }
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pEntry->pTables); ++i) {
+    SPlanCacheTable* pTb = (SPlanCacheTable*)taosArrayGet(pEntry->pTables, i);
+    STableMeta*      pMeta = NULL;
+    if (TSDB_CODE_SUCCESS != catalogGetCachedTableMeta(pCtg, &conn, &pTb->name, &pMeta) || NULL == pMeta) {
+      return false;
+    }
+    bool valid = (pMeta->uid == pTb->uid && pMeta->sversion == pTb->sversion && pMeta->tversion == pTb->tversion);
+    taosMemoryFree(pMeta);
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static size_t planCacheEntrySize(SPlanCacheEntry* pEntry) {
+  size_t size = sizeof(SPlanCacheEntry) + pEntry->numOfResCols * sizeof(SSchema) +
+                taosArrayGetSize(pEntry->pDbList) * TSDB_DB_FNAME_LEN +
+                taosArrayGetSize(pEntry->pTableList) * sizeof(SName) +
+                taosArrayGetSize(pEntry->pDbs) * sizeof(SPlanCacheDb) +
+                taosArrayGetSize(pEntry->pTables) * sizeof(SPlanCacheTable) +
+                taosArrayGetSize(pEntry->pNodeList) * sizeof(SQueryNodeLoad);
+  for (int32_t i = 0; i < pEntry->numOfConsts; ++i) {
+    size += sizeof(SPlanCacheConst) + strlen(pEntry->pConsts[i].literal) + 1;
+  }
+  for (int32_t i = 0; i < pEntry->numOfSubplans; ++i) {
+    size += sizeof(SPlanCacheSubplan) + pEntry->pSubplans[i].msgLen +
+            taosArrayGetSize(pEntry->pSubplans[i].pChildren) * sizeof(int32_t);
+  }
+  return size;
+}
+
+static bool planCacheQueryCacheable(SRequestObj* pRequest, SQuery* pQuery, bool placeholder) {
+  return NULL != pQuery->pRoot &&
+         (QUERY_NODE_SELECT_STMT == nodeType(pQuery->pRoot) || QUERY_NODE_SET_OPERATOR == nodeType(pQuery->pRoot)) &&
+         QUERY_EXEC_MODE_SCHEDULE == pQuery->execMode && pQuery->haveResultSet && !pQuery->showRewrite &&
+         (placeholder || 0 == pQuery->placeholderNum) && 0 == taosArrayGetSize(pRequest->targetTableList) &&
+         pRequest->body.resInfo.numOfCols > 0 &&
+         (QUERY_POLICY_VNODE == tsQueryPolicy || QUERY_POLICY_CLIENT == tsQueryPolicy);
+}
+
+// Compute the cache key of the request, kept in the wrapper so that a cache miss can fill the entry once planned.
+static int32_t planCacheInitKey(SRequestObj* pRequest, SSqlCallbackWrapper* pWrapper) {
+  char*   pNormSql = NULL;
+  SArray* pConsts = NULL;
+  int32_t code = qNormalizeQuerySql(pRequest->sqlstr, pRequest->sqlLen, &pNormSql, &pConsts);
+  if (TSDB_CODE_SUCCESS != code || NULL == pNormSql) {
+    return code;
+  }
+
+  const char* db = (NULL != pRequest->pDb) ? pRequest->pDb : "";
+  int32_t     len = strlen(db) + strlen(pNormSql) + 2;
+  pWrapper->pPlanCacheKey = (char*)taosMemoryMalloc(len);
+  if (NULL == pWrapper->pPlanCacheKey) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  } else {
+    snprintf(pWrapper->pPlanCacheKey, len, "%s\n%s", db, pNormSql);
+    SArray* pTmp = pWrapper->pPlanCacheConsts;
+    pWrapper->pPlanCacheConsts = pConsts;
+    pConsts = pTmp;
+  }
+  taosMemoryFree(pNormSql);
+  qDestroyQueryConstants(pConsts);
+  return code;
+}
+
+// Name every placeholder of the plan "?<placeholderNo>", the number does not survive serialization.
+static int32_t planCacheStampParams(SQueryPlan* pDag, int8_t precision) {
+  SPlanCacheBindCxt cxt = {.stamp = true, .precision = precision, .code = TSDB_CODE_SUCCESS};
+  SNode*            pLevel = NULL;
+  FOREACH(pLevel, pDag->pSubplans) {
+    SNode* pNode = NULL;
+    FOREACH(pNode, ((SNodeListNode*)pLevel)->pNodeList) {
+      int32_t code = planCacheBindSubplan(&cxt, (SSubplan*)pNode);
+      if (TSDB_CODE_SUCCESS != code) {
+        return code;
+      }
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t planCacheInitEntryConsts(SPlanCacheEntry* pEntry, SArray* pConsts) {
+  pEntry->pConsts = (SPlanCacheConst*)taosMemoryCalloc(TMAX(pEntry->numOfConsts, 1), sizeof(SPlanCacheConst));
+  if (NULL == pEntry->pConsts) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < pEntry->numOfConsts; ++i) {
+    SPlanCacheConst* pConst = pEntry->pConsts + i;
+    if (pEntry->placeholder) {
+      char literal[16];
+      snprintf(literal, sizeof(literal), "?%d", i + 1);
+      pConst->literal = (char*)taosMemoryStrDup(literal);
+      pConst->isTs = planCacheParamToTs((SValueNode*)taosArrayGetP(pConsts, i), pEntry->precision, &pConst->ts);
+    } else {
+      pConst->literal = (char*)taosMemoryStrDup(((SQueryConstant*)taosArrayGet(pConsts, i))->literal);
+      pConst->isTs = planCacheConstToTs((SQueryConstant*)taosArrayGet(pConsts, i), pEntry->precision, &pConst->ts);
+    }
+    if (NULL == pConst->literal) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// Build an entry from the plan about to be scheduled. pConsts are the SQueryConstant of the normalized sql, or the
+// placeholder values of a stmt query.
+static int32_t planCacheCreateEntry(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag, SArray* pNodeList,
+                                    SArray* pConsts, bool placeholder, SPlanCacheEntry** ppEntry) {
+  if (!planCacheQueryCacheable(pRequest, pQuery, placeholder)) {
+    return TSDB_CODE_FAILED;
+  }
+
+  SReqResultInfo*  pResInfo = &pRequest->body.resInfo;
+  SPlanCacheEntry* pEntry = (SPlanCacheEntry*)taosMemoryCalloc(1, sizeof(SPlanCacheEntry));
+  SPlanCacheConst* pCheckConsts = NULL;
+  SQueryPlan*      pCheck = NULL;
+  int32_t          code = (NULL == pEntry) ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+  if (TSDB_CODE_SUCCESS == code) {
+    pEntry->placeholder = placeholder;
+    pEntry->msgType = pQuery->msgType;
+    pEntry->precision = pQuery->precision;
+    pEntry->stableQuery = pQuery->stableQuery;
+    pEntry->numOfResCols = pResInfo->numOfCols;
+    pEntry->pResSchema = (SSchema*)taosMemoryCalloc(pEntry->numOfResCols, sizeof(SSchema));
+    pEntry->pNodeList = taosArrayDup(pNodeList);
+    pEntry->numOfConsts = taosArrayGetSize(pConsts);
+    if (NULL == pEntry->pResSchema || (NULL != pNodeList && NULL == pEntry->pNodeList)) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    for (int32_t i = 0; i < pEntry->numOfResCols; ++i) {
+      pEntry->pResSchema[i].type = pResInfo->fields[i].type;
+      pEntry->pResSchema[i].bytes = pResInfo->fields[i].bytes;
+      tstrncpy(pEntry->pResSchema[i].name, pResInfo->fields[i].name, sizeof(pEntry->pResSchema[i].name));
+    }
+    code = planCacheInitEntryConsts(pEntry, pConsts);
+  }
+  if (TSDB_CODE_SUCCESS == code && placeholder) {
+    code = planCacheStampParams(pDag, pEntry->precision);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheSaveSubplans(pEntry, pDag);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheSaveMeta(pRequest, pEntry);
+  }
+
+  // rebuild the plan from the entry with its own constants: it must come out bound exactly like the original
+  if (TSDB_CODE_SUCCESS == code) {
+    code = placeholder ? planCacheInitParams(pConsts, pEntry->precision, &pCheckConsts)
+                       : planCacheInitConsts(pConsts, pEntry->precision, &pCheckConsts);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBuildPlan(pEntry, pCheckConsts, pDag->queryId, &pCheck);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheCheckBinding(pEntry, pCheckConsts, pDag);
+  }
+  qDestroyQueryPlan(pCheck);
+  taosMemoryFree(pCheckConsts);
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *ppEntry = pEntry;
+  } else {
+    planCacheDestroyEntry(pEntry);
+  }
+  return code;
+}
+
+// Cache the plan of a miss. A query that cannot be cached leaves a negative entry under its key, so that the next
+// ones skip the serialization and the binding check that failed.
+void planCacheInsert(SRequestObj* pRequest, SSqlCallbackWrapper* pWrapper, SQuery* pQuery, SQueryPlan* pDag,
+                     SArray* pNodeList) {
+  SLRUCache* pCache = pRequest->pTscObj->pAppInfo->pPlanCache;
+  if (NULL == pCache || NULL == pWrapper || NULL == pWrapper->pPlanCacheKey) {
+    return;
+  }
+
+  SPlanCacheEntry* pEntry = NULL;
+  int32_t code = planCacheCreateEntry(pRequest, pQuery, pDag, pNodeList, pWrapper->pPlanCacheConsts, false, &pEntry);
+  if (TSDB_CODE_SUCCESS != code && TSDB_CODE_OUT_OF_MEMORY != code) {
+    pEntry = (SPlanCacheEntry*)taosMemoryCalloc(1, sizeof(SPlanCacheEntry));
+    if (NULL != pEntry) {
+      pEntry->uncacheable = true;
+    }
+  }
+  if (NULL != pEntry) {
+    const char* key = pWrapper->pPlanCacheKey;
+    LRUStatus   status = taosLRUCacheInsert(pCache, key, strlen(key), pEntry, planCacheEntrySize(pEntry),
+                                            planCacheDeleteEntry, NULL, TAOS_LRU_PRIORITY_LOW);
+    if (TAOS_LRU_STATUS_FAIL == status) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else if (TSDB_CODE_SUCCESS == code) {
+      tscDebug("0x%" PRIx64 " plan cached, subplans:%d, consts:%d, reqId:0x%" PRIx64, pRequest->self,
+               pEntry->numOfSubplans, pEntry->numOfConsts, pRequest->requestId);
+      return;
+    }
+  }
+
+  tscDebug("0x%" PRIx64 " plan not cached, code:%s, reqId:0x%" PRIx64, pRequest->self, tstrerror(code),
+           pRequest->requestId);
+}
+
+// Keep the plan of a stmt query for the executions to come, placeholders are rebound in place of translating and
+// planning the statement again. The plan belongs to the stmt, it does not depend on the plan cache being enabled.
+void planCacheCreateStmtPlan(SRequestObj* pRequest, SQuery* pQuery, SQueryPlan* pDag, SArray* pNodeList,
+                             SPlanCacheEntry** ppEntry) {
+  int32_t code =
+      planCacheCreateEntry(pRequest, pQuery, pDag, pNodeList, pQuery->pPlaceholderValues, true, ppEntry);
+  tscDebug("0x%" PRIx64 " stmt plan %s, code:%s, reqId:0x%" PRIx64, pRequest->self,
+           TSDB_CODE_SUCCESS == code ? "kept" : "not kept", tstrerror(code), pRequest->requestId);
+}
+
+static int32_t planCacheApplyEntry(SRequestObj* pRequest, SPlanCacheEntry* pEntry, SQueryPlan* pDag) {
+  SArray* pDbList = taosArrayDup(pEntry->pDbList);
+  SArray* pTableList = taosArrayDup(pEntry->pTableList);
+  if ((NULL != pEntry->pDbList && NULL == pDbList) || (NULL != pEntry->pTableList && NULL == pTableList)) {
+    taosArrayDestroy(pDbList);
+    taosArrayDestroy(pTableList);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosArrayDestroy(pRequest->dbList);
+  taosArrayDestroy(pRequest->tableList);
+  pRequest->dbList = pDbList;
+  pRequest->tableList = pTableList;
+  pRequest->type = pEntry->msgType;
+  pRequest->stableQuery = pEntry->stableQuery;
+  pRequest->stmtType = QUERY_NODE_SELECT_STMT;
+  pRequest->body.execMode = QUERY_EXEC_MODE_SCHEDULE;
+  pRequest->body.subplanNum = pDag->numOfSubplans;
+  setResSchemaInfo(&pRequest->body.resInfo, pEntry->pResSchema, pEntry->numOfResCols);
+  setResPrecision(&pRequest->body.resInfo, pEntry->precision);
+  return TSDB_CODE_SUCCESS;
+}
+
+// Look the request up in the plan cache. On a hit the request is set up as semantic analysis would have done it,
+// and the plan to schedule is returned in *ppDag, otherwise *ppDag is NULL and the request goes the normal way.
+int32_t planCacheLookup(SRequestObj* pRequest, SSqlCallbackWrapper* pWrapper, bool updateMetaForce,
+                        SQueryPlan** ppDag, SArray** ppNodeList) {
+  *ppDag = NULL;
+  *ppNodeList = NULL;
+
+  SLRUCache* pCache = pRequest->pTscObj->pAppInfo->pPlanCache;
+  if (NULL == pCache || pRequest->validateOnly) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = planCacheInitKey(pRequest, pWrapper);
+  if (TSDB_CODE_SUCCESS != code || NULL == pWrapper->pPlanCacheKey) {
+    return code;
+  }
+
+  const char* key = pWrapper->pPlanCacheKey;
+  if (updateMetaForce) {
+    // the server rejected what the cache or the catalog knew, plan again from fresh meta
+    taosLRUCacheErase(pCache, key, strlen(key));
+    return TSDB_CODE_SUCCESS;
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pCache, key, strlen(key));
+  if (NULL == h) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SPlanCacheEntry* pEntry = (SPlanCacheEntry*)taosLRUCacheValue(pCache, h);
+  SPlanCacheConst* pConsts = NULL;
+  SQueryPlan*      pDag = NULL;
+  if (pEntry->uncacheable) {
+    // planned the normal way, and not offered to the cache again
+    taosLRUCacheRelease(pCache, h, false);
+    taosMemoryFreeClear(pWrapper->pPlanCacheKey);
+    return TSDB_CODE_SUCCESS;
+  }
+  if (!planCacheMetaValid(pRequest, pEntry)) {
+    taosLRUCacheRelease(pCache, h, false);
+    taosLRUCacheErase(pCache, key, strlen(key));
+    tscDebug("0x%" PRIx64 " cached plan expired, reqId:0x%" PRIx64, pRequest->self, pRequest->requestId);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the plan binds exactly the constants it was cached with, any other number of them is planned again
+  if (taosArrayGetSize(pWrapper->pPlanCacheConsts) != pEntry->numOfConsts) {
+    code = TSDB_CODE_FAILED;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheInitConsts(pWrapper->pPlanCacheConsts, pEntry->precision, &pConsts);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBuildPlan(pEntry, pConsts, pRequest->requestId, &pDag);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    *ppNodeList = taosArrayDup(pEntry->pNodeList);
+    if (NULL != pEntry->pNodeList && NULL == *ppNodeList) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheApplyEntry(pRequest, pEntry, pDag);
+  }
+  taosMemoryFree(pConsts);
+  taosLRUCacheRelease(pCache, h, false);
+
+  if (TSDB_CODE_SUCCESS != code) {
+    // a constant the cached plan cannot take, e.g. a longer string, leave it to the parser
+    tscDebug("0x%" PRIx64 " cached plan not used, code:%s, reqId:0x%" PRIx64, pRequest->self, tstrerror(code),
+             pRequest->requestId);
+    qDestroyQueryPlan(pDag);
+    taosArrayDestroy(*ppNodeList);
+    *ppNodeList = NULL;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  *ppDag = pDag;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Rebuild the plan kept by a stmt with the values bound to its placeholders. A failure leaves the request untouched,
+// the stmt then goes through translation and planning.
+int32_t planCacheBuildStmtPlan(SRequestObj* pRequest, SPlanCacheEntry* pEntry, SQuery* pQuery, SQueryPlan** ppDag,
+                               SArray** ppNodeList) {
+  if (!planCacheMetaValid(pRequest, pEntry) || taosArrayGetSize(pQuery->pPlaceholderValues) != pEntry->numOfConsts) {
+    return TSDB_CODE_FAILED;
+  }
+
+  SPlanCacheConst* pConsts = NULL;
+  SQueryPlan*      pDag = NULL;
+  SArray*          pNodeList = NULL;
+  int32_t          code = planCacheInitParams(pQuery->pPlaceholderValues, pEntry->precision, &pConsts);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheBuildPlan(pEntry, pConsts, pRequest->requestId, &pDag);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    pNodeList = taosArrayDup(pEntry->pNodeList);
+    if (NULL != pEntry->pNodeList && NULL == pNodeList) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = planCacheApplyEntry(pRequest, pEntry, pDag);
+  }
+  taosMemoryFree(pConsts);
+
+  if (TSDB_CODE_SUCCESS != code) {
+    qDestroyQueryPlan(pDag);
+    taosArrayDestroy(pNodeList);
+    return code;
+  }
+
+  *ppDag = pDag;
+  *ppNodeList = pNodeList;
+  return TSDB_CODE_SUCCESS;
+}
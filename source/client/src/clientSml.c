@@ -2,8 +2,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-#include "cJSON.h"
 #include "catalog.h"
 #include "clientInt.h"
 #include "osSemaphore.h"
@@ -55,13 +57,15 @@
 
 #define MOVE_FORWARD_ONE(sql, len) (memmove((void *)((sql)-1), (sql), len))
 
-#define PROCESS_SLASH(key, keyLen)           \
-  for (int i = 1; i < keyLen; ++i) {         \
-    if (IS_SLASH_LETTER(key + i)) {          \
-      MOVE_FORWARD_ONE(key + i, keyLen - i); \
-      i--;                                   \
-      keyLen--;                              \
-    }                                        \
+#define PROCESS_SLASH(key, keyLen)             \
+  if (memchr(key, SLASH, keyLen) != NULL) {    \
+    for (int i = 1; i < keyLen; ++i) {         \
+      if (IS_SLASH_LETTER(key + i)) {          \
+        MOVE_FORWARD_ONE(key + i, keyLen - i); \
+        i--;                                   \
+        keyLen--;                              \
+      }                                        \
+    }                                          \
   }
 
 #define IS_INVALID_COL_LEN(len)   ((len) <= 0 || (len) >= TSDB_COL_NAME_LEN)
@@ -183,6 +187,46 @@ typedef struct {
 //=================================================================================================
 
 //=================================================================================================
+/*
+ * Find the first byte in [p, end) that is one of the nSet bytes in set, 32 bytes are checked per step with SSE2.
+ * The parsers only act on a few delimiters, so everything in between is skipped by this scan.
+ */
+static FORCE_INLINE const char *smlScanBytes(const char *p, const char *end, const char *set, int32_t nSet) {
+#ifdef __SSE2__
+  __m128i vSet[8];
+  for (int32_t i = 0; i < nSet; ++i) {
+    vSet[i] = _mm_set1_epi8(set[i]);
+  }
+  while (end - p >= 32) {
+    __m128i lo = _mm_loadu_si128((const __m128i *)p);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(p + 16));
+    __m128i mLo = _mm_setzero_si128();
+    __m128i mHi = _mm_setzero_si128();
+    for (int32_t i = 0; i < nSet; ++i) {
+      mLo = _mm_or_si128(mLo, _mm_cmpeq_epi8(lo, vSet[i]));
+      mHi = _mm_or_si128(mHi, _mm_cmpeq_epi8(hi, vSet[i]));
+    }
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(mLo) | ((uint32_t)_mm_movemask_epi8(mHi) << 16);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+#endif
+  for (; p < end; ++p) {
+    for (int32_t i = 0; i < nSet; ++i) {
+      if (*p == set[i]) return p;
+    }
+  }
+  return end;
+}
+
+// delimiters of line and telnet protocol
+static FORCE_INLINE const char *smlScanDelimiter(const char *p, const char *end) {
+  static const char delimiters[] = {SPACE, COMMA, EQUAL, QUOTE, SLASH};
+  return smlScanBytes(p, end, delimiters, sizeof(delimiters));
+}
+
 static volatile int64_t linesSmlHandleId = 0;
 static int64_t          smlGenId() {
            int64_t id;
@@ -924,7 +968,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   elements->measure = sql;
 
   // parse measure
-  while (sql < sqlEnd) {
+  while ((sql = smlScanDelimiter(sql, sqlEnd)) < sqlEnd) {
     if ((sql != elements->measure) && IS_SLASH_LETTER(sql)) {
       MOVE_FORWARD_ONE(sql, sqlEnd - sql);
       sqlEnd--;
@@ -951,7 +995,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   } else {
     if (*sql == COMMA) sql++;
     elements->tags = sql;
-    while (sql < sqlEnd) {
+    while ((sql = smlScanDelimiter(sql, sqlEnd)) < sqlEnd) {
       if (IS_SPACE(sql)) {
         break;
       }
@@ -965,7 +1009,7 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   JUMP_SPACE(sql, sqlEnd)
   elements->cols = sql;
   bool isInQuote = false;
-  while (sql < sqlEnd) {
+  while ((sql = smlScanDelimiter(sql, sqlEnd)) < sqlEnd) {
     if (IS_QUOTE(sql)) {
       isInQuote = !isInQuote;
     }
@@ -1007,6 +1051,7 @@ static void smlParseTelnetElement(const char **sql, const char *sqlEnd, const ch
       break;
     }
     (*sql)++;
+    if (*data) *sql = smlScanDelimiter(*sql, sqlEnd);
   }
 }
 
@@ -1023,7 +1068,7 @@ static int32_t smlParseTelnetTags(const char *data, const char *sqlEnd, SArray *
     int32_t     keyLen = 0;
 
     // parse key
-    while (sql < sqlEnd) {
+    while ((sql = smlScanDelimiter(sql, sqlEnd)) < sqlEnd) {
       if (*sql == SPACE) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -1048,7 +1093,7 @@ static int32_t smlParseTelnetTags(const char *data, const char *sqlEnd, SArray *
     // parse value
     const char *value = sql;
     int32_t     valueLen = 0;
-    while (sql < sqlEnd) {
+    while ((sql = smlScanDelimiter(sql, sqlEnd)) < sqlEnd) {
       // parse value
       if (*sql == SPACE) {
         break;
@@ -1160,7 +1205,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     const char *key = sql;
     int32_t     keyLen = 0;
 
-    while (sql < data + len) {
+    while ((sql = smlScanDelimiter(sql, data + len)) < data + len) {
       // parse key
       if (IS_COMMA(sql)) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
@@ -1187,7 +1232,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     const char *value = sql;
     int32_t     valueLen = 0;
     bool        isInQuote = false;
-    while (sql < data + len) {
+    while ((sql = smlScanDelimiter(sql, data + len)) < data + len) {
       // parse value
       if (!isTag && IS_QUOTE(sql)) {
         isInQuote = !isInQuote;
@@ -1582,48 +1627,331 @@ cleanup:
 }
 
 /************* TSDB_SML_JSON_PROTOCOL function start **************/
-static int32_t smlJsonCreateSring(const char **output, char *input, int32_t inputLen) {
-  *output = (const char *)taosMemoryCalloc(1, inputLen);
-  if (*output == NULL) {
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+/*
+ * The JSON payload is parsed on demand: fields of a data point are read in place and converted into SSmlKv straight
+ * away, no DOM is built for the whole payload. Strings keep pointing into the payload until they are copied out.
+ */
+#define SML_JSON_NULL   0
+#define SML_JSON_BOOL   1
+#define SML_JSON_NUMBER 2
+#define SML_JSON_STRING 3
+
+#define SML_JSON_NUMBER_MAX_LEN 64
+
+typedef struct {
+  const char *p;
+  const char *end;
+} SSmlJson;
+
+typedef struct {
+  int8_t      type;
+  bool        escaped;  // string contains escape sequence
+  int32_t     len;
+  const char *str;      // raw string in payload, without quotes
+  union {
+    bool   b;
+    double d;
+  };
+} SSmlJsonVal;
+
+static FORCE_INLINE char smlJsonPeek(SSmlJson *js) {
+  while (js->p < js->end && (uint8_t)(*js->p) <= ' ') {
+    js->p++;
+  }
+  return js->p < js->end ? *js->p : '\0';
+}
+
+static FORCE_INLINE bool smlJsonConsume(SSmlJson *js, char c) {
+  if (smlJsonPeek(js) != c) {
+    return false;
+  }
+  js->p++;
+  return true;
+}
+
+static int32_t smlJsonParseStr(SSmlJson *js, SSmlJsonVal *val) {
+  static const char quotes[] = {'"', '\\'};
+  if (!smlJsonConsume(js, '"')) {
+    return TSDB_CODE_TSC_INVALID_JSON;
+  }
+
+  const char *start = js->p;
+  val->escaped = false;
+  while (true) {
+    const char *p = smlScanBytes(js->p, js->end, quotes, sizeof(quotes));
+    if (p >= js->end) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+    if (*p == '"') {
+      val->type = SML_JSON_STRING;
+      val->str = start;
+      val->len = p - start;
+      js->p = p + 1;
+      return TSDB_CODE_SUCCESS;
+    }
+    val->escaped = true;
+    js->p = p + 2;
+  }
+}
+
+static int32_t smlJsonParseHex4(const char *p, const char *end, uint32_t *code) {
+  if (end - p < 4) {
+    return -1;
+  }
+  *code = 0;
+  for (int32_t i = 0; i < 4; ++i) {
+    char c = p[i];
+    *code <<= 4;
+    if (c >= '0' && c <= '9') {
+      *code |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      *code |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      *code |= c - 'A' + 10;
+    } else {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+// unescape JSON string into dst which has at least len + 1 bytes, return length of the result or -1 if invalid
+static int32_t smlJsonUnescape(const char *src, int32_t len, char *dst) {
+  const char *end = src + len;
+  char       *out = dst;
+  while (src < end) {
+    if (*src != '\\') {
+      *out++ = *src++;
+      continue;
+    }
+    if (++src >= end) {
+      return -1;
+    }
+    switch (*src++) {
+      case 'b':
+        *out++ = '\b';
+        break;
+      case 'f':
+        *out++ = '\f';
+        break;
+      case 'n':
+        *out++ = '\n';
+        break;
+      case 'r':
+        *out++ = '\r';
+        break;
+      case 't':
+        *out++ = '\t';
+        break;
+      case '"':
+      case '\\':
+      case '/':
+        *out++ = src[-1];
+        break;
+      case 'u': {
+        uint32_t code = 0;
+        if (smlJsonParseHex4(src, end, &code) != 0) {
+          return -1;
+        }
+        src += 4;
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          // utf16 surrogate pair
+          uint32_t low = 0;
+          if (end - src < 6 || src[0] != '\\' || src[1] != 'u' || smlJsonParseHex4(src + 2, end, &low) != 0 ||
+              low < 0xDC00 || low > 0xDFFF) {
+            return -1;
+          }
+          src += 6;
+          code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+          return -1;
+        }
+
+        if (code < 0x80) {
+          *out++ = (char)code;
+        } else if (code < 0x800) {
+          *out++ = (char)(0xC0 | (code >> 6));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+          *out++ = (char)(0xE0 | (code >> 12));
+          *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        } else {
+          *out++ = (char)(0xF0 | (code >> 18));
+          *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+          *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+          *out++ = (char)(0x80 | (code & 0x3F));
+        }
+        break;
+      }
+      default:
+        return -1;
+    }
+  }
+  *out = '\0';
+  return out - dst;
+}
+
+// copy the string value out of payload, the result is null terminated
+static int32_t smlJsonCopyStr(const SSmlJsonVal *val, char **output, int32_t *outputLen) {
+  char *buf = (char *)taosMemoryMalloc(val->len + 1);
+  if (buf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  memcpy((void *)(*output), input, inputLen);
+  if (!val->escaped) {
+    memcpy(buf, val->str, val->len);
+    buf[val->len] = '\0';
+    *outputLen = val->len;
+  } else {
+    *outputLen = smlJsonUnescape(val->str, val->len, buf);
+    if (*outputLen < 0) {
+      taosMemoryFree(buf);
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+  }
+  *output = buf;
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseMetricFromJSON(SSmlHandle *info, cJSON *root, SSmlTableInfo *tinfo) {
-  cJSON *metric = cJSON_GetObjectItem(root, "metric");
-  if (!cJSON_IsString(metric)) {
+// keys are case insensitive, the same as cJSON_GetObjectItem
+static bool smlJsonKeyIs(const SSmlJsonVal *key, const char *name) {
+  int32_t nameLen = strlen(name);
+  if (!key->escaped) {
+    return key->len == nameLen && strncasecmp(key->str, name, nameLen) == 0;
+  }
+
+  char buf[64] = {0};
+  if (key->len >= sizeof(buf)) {
+    return false;
+  }
+  return smlJsonUnescape(key->str, key->len, buf) == nameLen && strncasecmp(buf, name, nameLen) == 0;
+}
+
+static int32_t smlJsonParseKey(SSmlJson *js, SSmlJsonVal *key) {
+  int32_t ret = smlJsonParseStr(js, key);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
+  }
+  return smlJsonConsume(js, ':') ? TSDB_CODE_SUCCESS : TSDB_CODE_TSC_INVALID_JSON;
+}
+
+// consume the separator after a field, *last is set if the object ends
+static int32_t smlJsonNextField(SSmlJson *js, bool *last) {
+  char c = smlJsonPeek(js);
+  js->p++;
+  if (c == ',') {
+    *last = false;
+    return TSDB_CODE_SUCCESS;
+  }
+  if (c == '}') {
+    *last = true;
+    return TSDB_CODE_SUCCESS;
+  }
+  return TSDB_CODE_TSC_INVALID_JSON;
+}
+
+static bool smlJsonMatchLiteral(SSmlJson *js, const char *literal, int32_t len) {
+  if (js->end - js->p < len || memcmp(js->p, literal, len) != 0) {
+    return false;
+  }
+  js->p += len;
+  return true;
+}
+
+// parse string, number, bool or null
+static int32_t smlJsonParseScalar(SSmlJson *js, SSmlJsonVal *val) {
+  char c = smlJsonPeek(js);
+  if (c == '"') {
+    return smlJsonParseStr(js, val);
+  }
+  if (c == 't' || c == 'f') {
+    val->type = SML_JSON_BOOL;
+    val->b = (c == 't');
+    return smlJsonMatchLiteral(js, val->b ? "true" : "false", val->b ? 4 : 5) ? TSDB_CODE_SUCCESS
+                                                                            : TSDB_CODE_TSC_INVALID_JSON;
+  }
+  if (c == 'n') {
+    val->type = SML_JSON_NULL;
+    return smlJsonMatchLiteral(js, "null", 4) ? TSDB_CODE_SUCCESS : TSDB_CODE_TSC_INVALID_JSON;
+  }
+  if (c == '-' || isdigit((uint8_t)c)) {
+    char    buf[SML_JSON_NUMBER_MAX_LEN] = {0};
+    int32_t len = 0;
+    while (js->p < js->end && (isdigit((uint8_t)*js->p) || *js->p == '+' || *js->p == '-' || *js->p == 'e' ||
+                               *js->p == 'E' || *js->p == '.')) {
+      if (len >= SML_JSON_NUMBER_MAX_LEN - 1) {
+        return TSDB_CODE_TSC_INVALID_JSON;
+      }
+      buf[len++] = *js->p++;
+    }
+    char *numEnd = NULL;
+    val->type = SML_JSON_NUMBER;
+    val->d = taosStr2Double(buf, &numEnd);
+    return (numEnd == buf + len) ? TSDB_CODE_SUCCESS : TSDB_CODE_TSC_INVALID_JSON;
+  }
+  return TSDB_CODE_TSC_INVALID_JSON;
+}
+
+static int32_t smlParseMetricFromJSON(SSmlHandle *info, SSmlJson *js, SSmlTableInfo *tinfo) {
+  SSmlJsonVal metric = {0};
+  if (tinfo->sTableName != NULL || smlJsonParseStr(js, &metric) != TSDB_CODE_SUCCESS) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  tinfo->sTableNameLen = strlen(metric->valuestring);
+  char   *sTableName = NULL;
+  int32_t ret = smlJsonCopyStr(&metric, &sTableName, &tinfo->sTableNameLen);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
+  }
+  tinfo->sTableName = sTableName;
   if (IS_INVALID_TABLE_LEN(tinfo->sTableNameLen)) {
     uError("OTD:0x%" PRIx64 " Metric lenght is 0 or large than 192", info->id);
     return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
   }
 
-  return smlJsonCreateSring(&tinfo->sTableName, metric->valuestring, tinfo->sTableNameLen);
+  return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseTSFromJSONObj(SSmlHandle *info, cJSON *root, int64_t *tsVal) {
-  int32_t size = cJSON_GetArraySize(root);
-  if (size != OTD_JSON_SUB_FIELDS_NUM) {
-    return TSDB_CODE_TSC_INVALID_JSON;
-  }
+static int32_t smlParseTSFromJSONObj(SSmlHandle *info, SSmlJson *js, int64_t *tsVal) {
+  SSmlJsonVal value = {0};
+  bool        hasValue = false;
+  char        typeStr[4] = {0};
+  bool        hasType = false;
+  bool        last = false;
 
-  cJSON *value = cJSON_GetObjectItem(root, "value");
-  if (!cJSON_IsNumber(value)) {
+  if (!smlJsonConsume(js, '{')) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
-
-  cJSON *type = cJSON_GetObjectItem(root, "type");
-  if (!cJSON_IsString(type)) {
+  while (!last) {
+    SSmlJsonVal key = {0};
+    if (smlJsonParseKey(js, &key) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+    if (!hasValue && smlJsonKeyIs(&key, "value")) {
+      if (smlJsonParseScalar(js, &value) != TSDB_CODE_SUCCESS || value.type != SML_JSON_NUMBER) {
+        return TSDB_CODE_TSC_INVALID_JSON;
+      }
+      hasValue = true;
+    } else if (!hasType && smlJsonKeyIs(&key, "type")) {
+      SSmlJsonVal type = {0};
+      if (smlJsonParseStr(js, &type) != TSDB_CODE_SUCCESS || type.escaped || type.len >= sizeof(typeStr)) {
+        return TSDB_CODE_TSC_INVALID_JSON;
+      }
+      memcpy(typeStr, type.str, type.len);
+      hasType = true;
+    } else {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+    if (smlJsonNextField(js, &last) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+  }
+  if (!hasValue || !hasType) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  double timeDouble = value->valuedouble;
+  double timeDouble = value.d;
   if (smlDoubleToInt64OverFlow(timeDouble)) {
     smlBuildInvalidDataMsg(&info->msgBuf, "timestamp is too large", NULL);
     return TSDB_CODE_INVALID_TIMESTAMP;
@@ -1639,8 +1967,8 @@ static int32_t smlParseTSFromJSONObj(SSmlHandle *info, cJSON *root, int64_t *tsV
   }
 
   *tsVal = timeDouble;
-  size_t typeLen = strlen(type->valuestring);
-  if (typeLen == 1 && (type->valuestring[0] == 's' || type->valuestring[0] == 'S')) {
+  size_t typeLen = strlen(typeStr);
+  if (typeLen == 1 && (typeStr[0] == 's' || typeStr[0] == 'S')) {
     // seconds
     *tsVal = *tsVal * NANOSECOND_PER_SEC;
     timeDouble = timeDouble * NANOSECOND_PER_SEC;
@@ -1648,8 +1976,8 @@ static int32_t smlParseTSFromJSONObj(SSmlHandle *info, cJSON *root, int64_t *tsV
       smlBuildInvalidDataMsg(&info->msgBuf, "timestamp is too large", NULL);
       return TSDB_CODE_INVALID_TIMESTAMP;
     }
-  } else if (typeLen == 2 && (type->valuestring[1] == 's' || type->valuestring[1] == 'S')) {
-    switch (type->valuestring[0]) {
+  } else if (typeLen == 2 && (typeStr[1] == 's' || typeStr[1] == 'S')) {
+    switch (typeStr[0]) {
       case 'm':
       case 'M':
         // milliseconds
@@ -1692,14 +2020,23 @@ static uint8_t smlGetTimestampLen(int64_t num) {
   return len;
 }
 
-static int32_t smlParseTSFromJSON(SSmlHandle *info, cJSON *root, SArray *cols) {
-  // Timestamp must be the first KV to parse
+static int32_t smlParseTSFromJSON(SSmlHandle *info, SSmlJson *js, SSmlKv **pKv) {
   int64_t tsVal = 0;
 
-  cJSON *timestamp = cJSON_GetObjectItem(root, "timestamp");
-  if (cJSON_IsNumber(timestamp)) {
+  if (smlJsonPeek(js) == '{') {
+    int32_t ret = smlParseTSFromJSONObj(info, js, &tsVal);
+    if (ret != TSDB_CODE_SUCCESS) {
+      uError("SML:0x%" PRIx64 " Failed to parse timestamp from JSON Obj", info->id);
+      return ret;
+    }
+  } else {
+    SSmlJsonVal timestamp = {0};
+    if (smlJsonParseScalar(js, &timestamp) != TSDB_CODE_SUCCESS || timestamp.type != SML_JSON_NUMBER) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+
     // timestamp value 0 indicates current system time
-    double timeDouble = timestamp->valuedouble;
+    double timeDouble = timestamp.d;
     if (smlDoubleToInt64OverFlow(timeDouble)) {
       smlBuildInvalidDataMsg(&info->msgBuf, "timestamp is too large", NULL);
       return TSDB_CODE_INVALID_TIMESTAMP;
@@ -1730,17 +2067,8 @@ static int32_t smlParseTSFromJSON(SSmlHandle *info, cJSON *root, SArray *cols) {
     } else {
       return TSDB_CODE_INVALID_TIMESTAMP;
     }
-  } else if (cJSON_IsObject(timestamp)) {
-    int32_t ret = smlParseTSFromJSONObj(info, timestamp, &tsVal);
-    if (ret != TSDB_CODE_SUCCESS) {
-      uError("SML:0x%" PRIx64 " Failed to parse timestamp from JSON Obj", info->id);
-      return ret;
-    }
-  } else {
-    return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  // add ts to
   SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
   if (!kv) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -1750,85 +2078,85 @@ static int32_t smlParseTSFromJSON(SSmlHandle *info, cJSON *root, SArray *cols) {
   kv->i = tsVal;
   kv->type = TSDB_DATA_TYPE_TIMESTAMP;
   kv->length = (int16_t)tDataTypes[kv->type].bytes;
-  taosArrayPush(cols, &kv);
+  *pKv = kv;
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlConvertJSONBool(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONBool(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   if (strcasecmp(typeStr, "bool") != 0) {
     uError("OTD:invalid type(%s) for JSON Bool", typeStr);
     return TSDB_CODE_TSC_INVALID_JSON_TYPE;
   }
   pVal->type = TSDB_DATA_TYPE_BOOL;
   pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-  pVal->i = value->valueint;
+  pVal->i = value->b;
 
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   // tinyint
   if (strcasecmp(typeStr, "i8") == 0 || strcasecmp(typeStr, "tinyint") == 0) {
-    if (!IS_VALID_TINYINT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(tinyint)", value->valuedouble);
+    if (!IS_VALID_TINYINT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(tinyint)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_TINYINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // smallint
   if (strcasecmp(typeStr, "i16") == 0 || strcasecmp(typeStr, "smallint") == 0) {
-    if (!IS_VALID_SMALLINT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(smallint)", value->valuedouble);
+    if (!IS_VALID_SMALLINT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(smallint)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_SMALLINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // int
   if (strcasecmp(typeStr, "i32") == 0 || strcasecmp(typeStr, "int") == 0) {
-    if (!IS_VALID_INT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(int)", value->valuedouble);
+    if (!IS_VALID_INT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(int)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_INT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->i = value->valuedouble;
+    pVal->i = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // bigint
   if (strcasecmp(typeStr, "i64") == 0 || strcasecmp(typeStr, "bigint") == 0) {
     pVal->type = TSDB_DATA_TYPE_BIGINT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    if (value->valuedouble >= (double)INT64_MAX) {
+    if (value->d >= (double)INT64_MAX) {
       pVal->i = INT64_MAX;
-    } else if (value->valuedouble <= (double)INT64_MIN) {
+    } else if (value->d <= (double)INT64_MIN) {
       pVal->i = INT64_MIN;
     } else {
-      pVal->i = value->valuedouble;
+      pVal->i = value->d;
     }
     return TSDB_CODE_SUCCESS;
   }
   // float
   if (strcasecmp(typeStr, "f32") == 0 || strcasecmp(typeStr, "float") == 0) {
-    if (!IS_VALID_FLOAT(value->valuedouble)) {
-      uError("OTD:JSON value(%f) cannot fit in type(float)", value->valuedouble);
+    if (!IS_VALID_FLOAT(value->d)) {
+      uError("OTD:JSON value(%f) cannot fit in type(float)", value->d);
       return TSDB_CODE_TSC_VALUE_OUT_OF_RANGE;
     }
     pVal->type = TSDB_DATA_TYPE_FLOAT;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->f = value->valuedouble;
+    pVal->f = value->d;
     return TSDB_CODE_SUCCESS;
   }
   // double
   if (strcasecmp(typeStr, "f64") == 0 || strcasecmp(typeStr, "double") == 0) {
     pVal->type = TSDB_DATA_TYPE_DOUBLE;
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->d = value->valuedouble;
+    pVal->d = value->d;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -1837,7 +2165,7 @@ static int32_t smlConvertJSONNumber(SSmlKv *pVal, char *typeStr, cJSON *value) {
   return TSDB_CODE_TSC_INVALID_JSON_TYPE;
 }
 
-static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, cJSON *value) {
+static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
   if (strcasecmp(typeStr, "binary") == 0) {
     pVal->type = TSDB_DATA_TYPE_BINARY;
   } else if (strcasecmp(typeStr, "nchar") == 0) {
@@ -1846,98 +2174,114 @@ static int32_t smlConvertJSONString(SSmlKv *pVal, char *typeStr, cJSON *value) {
     uError("OTD:invalid type(%s) for JSON String", typeStr);
     return TSDB_CODE_TSC_INVALID_JSON_TYPE;
   }
-  pVal->length = (int16_t)strlen(value->valuestring);
 
-  if (pVal->type == TSDB_DATA_TYPE_BINARY && pVal->length > TSDB_MAX_BINARY_LEN - VARSTR_HEADER_SIZE) {
-    return TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
+  char   *str = NULL;
+  int32_t len = 0;
+  int32_t ret = smlJsonCopyStr(value, &str, &len);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
   }
-  if (pVal->type == TSDB_DATA_TYPE_NCHAR &&
-      pVal->length > (TSDB_MAX_NCHAR_LEN - VARSTR_HEADER_SIZE) / TSDB_NCHAR_SIZE) {
+
+  if ((pVal->type == TSDB_DATA_TYPE_BINARY && len > TSDB_MAX_BINARY_LEN - VARSTR_HEADER_SIZE) ||
+      (pVal->type == TSDB_DATA_TYPE_NCHAR && len > (TSDB_MAX_NCHAR_LEN - VARSTR_HEADER_SIZE) / TSDB_NCHAR_SIZE)) {
+    taosMemoryFree(str);
     return TSDB_CODE_PAR_INVALID_VAR_COLUMN_LEN;
   }
-
-  return smlJsonCreateSring(&pVal->value, value->valuestring, pVal->length);
+  pVal->length = (int16_t)len;
+  pVal->value = str;
+  return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseValueFromJSONObj(cJSON *root, SSmlKv *kv) {
-  int32_t ret = TSDB_CODE_SUCCESS;
-  int32_t size = cJSON_GetArraySize(root);
-
-  if (size != OTD_JSON_SUB_FIELDS_NUM) {
-    return TSDB_CODE_TSC_INVALID_JSON;
+static int32_t smlConvertJSONValue(SSmlKv *pVal, char *typeStr, SSmlJsonVal *value) {
+  switch (value->type) {
+    case SML_JSON_BOOL:
+      return smlConvertJSONBool(pVal, typeStr, value);
+    case SML_JSON_NUMBER:
+      return smlConvertJSONNumber(pVal, typeStr, value);
+    case SML_JSON_STRING:
+      return smlConvertJSONString(pVal, typeStr, value);
+    default:
+      return TSDB_CODE_TSC_INVALID_JSON_TYPE;
   }
+}
 
-  cJSON *value = cJSON_GetObjectItem(root, "value");
-  if (value == NULL) {
-    return TSDB_CODE_TSC_INVALID_JSON;
-  }
+static int32_t smlParseValueFromJSONObj(SSmlJson *js, SSmlKv *kv) {
+  SSmlJsonVal value = {0};
+  bool        hasValue = false;
+  char        typeStr[16] = {0};
+  bool        hasType = false;
+  bool        last = false;
 
-  cJSON *type = cJSON_GetObjectItem(root, "type");
-  if (!cJSON_IsString(type)) {
+  if (!smlJsonConsume(js, '{')) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
-
-  switch (value->type) {
-    case cJSON_True:
-    case cJSON_False: {
-      ret = smlConvertJSONBool(kv, type->valuestring, value);
-      if (ret != TSDB_CODE_SUCCESS) {
-        return ret;
-      }
-      break;
+  while (!last) {
+    SSmlJsonVal key = {0};
+    if (smlJsonParseKey(js, &key) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
     }
-    case cJSON_Number: {
-      ret = smlConvertJSONNumber(kv, type->valuestring, value);
-      if (ret != TSDB_CODE_SUCCESS) {
-        return ret;
+    if (!hasValue && smlJsonKeyIs(&key, "value")) {
+      if (smlJsonParseScalar(js, &value) != TSDB_CODE_SUCCESS) {
+        return TSDB_CODE_TSC_INVALID_JSON;
       }
-      break;
-    }
-    case cJSON_String: {
-      ret = smlConvertJSONString(kv, type->valuestring, value);
-      if (ret != TSDB_CODE_SUCCESS) {
-        return ret;
+      hasValue = true;
+    } else if (!hasType && smlJsonKeyIs(&key, "type")) {
+      SSmlJsonVal type = {0};
+      if (smlJsonParseStr(js, &type) != TSDB_CODE_SUCCESS) {
+        return TSDB_CODE_TSC_INVALID_JSON;
       }
-      break;
+      // unknown type names are rejected by the conversion below
+      if (!type.escaped && type.len < sizeof(typeStr)) {
+        memcpy(typeStr, type.str, type.len);
+      }
+      hasType = true;
+    } else {
+      return TSDB_CODE_TSC_INVALID_JSON;
     }
-    default:
-      return TSDB_CODE_TSC_INVALID_JSON_TYPE;
+    if (smlJsonNextField(js, &last) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
+    }
+  }
+  if (!hasValue || !hasType) {
+    return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  return TSDB_CODE_SUCCESS;
+  return smlConvertJSONValue(kv, typeStr, &value);
 }
 
-static int32_t smlParseValueFromJSON(cJSON *root, SSmlKv *kv) {
-  switch (root->type) {
-    case cJSON_True:
-    case cJSON_False: {
+static int32_t smlParseValueFromJSON(SSmlJson *js, SSmlKv *kv) {
+  if (smlJsonPeek(js) == '{') {
+    int32_t ret = smlParseValueFromJSONObj(js, kv);
+    if (ret != TSDB_CODE_SUCCESS) {
+      uError("OTD:Failed to parse value from JSON Obj");
+    }
+    return ret;
+  }
+
+  SSmlJsonVal value = {0};
+  if (smlJsonParseScalar(js, &value) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_TSC_INVALID_JSON;
+  }
+  switch (value.type) {
+    case SML_JSON_BOOL: {
       kv->type = TSDB_DATA_TYPE_BOOL;
       kv->length = (int16_t)tDataTypes[kv->type].bytes;
-      kv->i = root->valueint;
+      kv->i = value.b;
       break;
     }
-    case cJSON_Number: {
+    case SML_JSON_NUMBER: {
       kv->type = TSDB_DATA_TYPE_DOUBLE;
       kv->length = (int16_t)tDataTypes[kv->type].bytes;
-      kv->d = root->valuedouble;
+      kv->d = value.d;
       break;
     }
-    case cJSON_String: {
+    case SML_JSON_STRING: {
       /* set default JSON type to binary/nchar according to
        * user configured parameter tsDefaultJSONStrType
        */
 
-      char *tsDefaultJSONStrType = "nchar";  // todo
-      smlConvertJSONString(kv, tsDefaultJSONStrType, root);
-      break;
-    }
-    case cJSON_Object: {
-      int32_t ret = smlParseValueFromJSONObj(root, kv);
-      if (ret != TSDB_CODE_SUCCESS) {
-        uError("OTD:Failed to parse value from JSON Obj");
-        return ret;
-      }
-      break;
+      char *tsDefaultJSONStrType = (char *)"nchar";  // todo
+      return smlConvertJSONString(kv, tsDefaultJSONStrType, &value);
     }
     default:
       return TSDB_CODE_TSC_INVALID_JSON;
@@ -1946,136 +2290,180 @@ static int32_t smlParseValueFromJSON(cJSON *root, SSmlKv *kv) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t smlParseColsFromJSON(cJSON *root, SArray *cols) {
-  if(!cols) return TSDB_CODE_OUT_OF_MEMORY;
-  cJSON *metricVal = cJSON_GetObjectItem(root, "value");
-  if (metricVal == NULL) {
-    return TSDB_CODE_TSC_INVALID_JSON;
-  }
-
+static int32_t smlParseColsFromJSON(SSmlJson *js, SSmlKv **pKv) {
   SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
   if (!kv) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
-  taosArrayPush(cols, &kv);
+  *pKv = kv;
 
   kv->key = VALUE;
   kv->keyLen = VALUE_LEN;
-  int32_t ret = smlParseValueFromJSON(metricVal, kv);
-  if (ret != TSDB_CODE_SUCCESS) {
-    return ret;
-  }
-  return TSDB_CODE_SUCCESS;
+  return smlParseValueFromJSON(js, kv);
 }
 
-static int32_t smlParseTagsFromJSON(cJSON *root, SArray *pKVs, char *childTableName, SHashObj *dumplicateKey,
+static int32_t smlParseTagsFromJSON(SSmlJson *js, SArray *pKVs, char *childTableName, SHashObj *dumplicateKey,
                                     SSmlMsgBuf *msg) {
   int32_t ret = TSDB_CODE_SUCCESS;
-  if (!pKVs){
+  if (!pKVs) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
-  cJSON *tags = cJSON_GetObjectItem(root, "tags");
-  if (tags == NULL || tags->type != cJSON_Object) {
+  if (taosArrayGetSize(pKVs) > 0 || !smlJsonConsume(js, '{')) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
+  if (smlJsonConsume(js, '}')) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-  size_t  childTableNameLen = strlen(tsSmlChildTableName);
-  int32_t tagNum = cJSON_GetArraySize(tags);
-  for (int32_t i = 0; i < tagNum; ++i) {
-    cJSON *tag = cJSON_GetArrayItem(tags, i);
-    if (tag == NULL) {
+  size_t childTableNameLen = strlen(tsSmlChildTableName);
+  bool   last = false;
+  while (!last) {
+    SSmlJsonVal tag = {0};
+    if (smlJsonParseKey(js, &tag) != TSDB_CODE_SUCCESS) {
       return TSDB_CODE_TSC_INVALID_JSON;
     }
-    size_t keyLen = strlen(tag->string);
+
+    char   *key = NULL;
+    int32_t keyLen = 0;
+    ret = smlJsonCopyStr(&tag, &key, &keyLen);
+    if (ret != TSDB_CODE_SUCCESS) {
+      return ret;
+    }
     if (IS_INVALID_COL_LEN(keyLen)) {
       uError("OTD:Tag key length is 0 or too large than 64");
+      taosMemoryFree(key);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
     // check duplicate keys
-    if (smlCheckDuplicateKey(tag->string, keyLen, dumplicateKey)) {
+    if (smlCheckDuplicateKey(key, keyLen, dumplicateKey)) {
+      taosMemoryFree(key);
       return TSDB_CODE_TSC_DUP_NAMES;
     }
 
     // handle child table name
-    if (childTableNameLen != 0 && strcmp(tag->string, tsSmlChildTableName) == 0) {
-      if (!cJSON_IsString(tag)) {
+    if (childTableNameLen != 0 && strcmp(key, tsSmlChildTableName) == 0) {
+      taosMemoryFree(key);
+      SSmlJsonVal id = {0};
+      char       *idStr = NULL;
+      int32_t     idLen = 0;
+      if (smlJsonPeek(js) != '"' || smlJsonParseStr(js, &id) != TSDB_CODE_SUCCESS) {
         uError("OTD:ID must be JSON string");
         return TSDB_CODE_TSC_INVALID_JSON;
       }
+      ret = smlJsonCopyStr(&id, &idStr, &idLen);
+      if (ret != TSDB_CODE_SUCCESS) {
+        return ret;
+      }
       memset(childTableName, 0, TSDB_TABLE_NAME_LEN);
-      tstrncpy(childTableName, tag->valuestring, TSDB_TABLE_NAME_LEN);
-      continue;
-    }
-
-    // add kv to SSmlKv
-    SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
-    if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
-    taosArrayPush(pKVs, &kv);
+      tstrncpy(childTableName, idStr, TSDB_TABLE_NAME_LEN);
+      taosMemoryFree(idStr);
+    } else {
+      // add kv to SSmlKv
+      SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
+      if (!kv) {
+        taosMemoryFree(key);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      taosArrayPush(pKVs, &kv);
 
-    // key
-    kv->keyLen = keyLen;
-    ret = smlJsonCreateSring(&kv->key, tag->string, kv->keyLen);
-    if (ret != TSDB_CODE_SUCCESS) {
-      return ret;
+      // key
+      kv->key = key;
+      kv->keyLen = keyLen;
+      // value
+      ret = smlParseValueFromJSON(js, kv);
+      if (ret != TSDB_CODE_SUCCESS) {
+        return ret;
+      }
     }
-    // value
-    ret = smlParseValueFromJSON(tag, kv);
-    if (ret != TSDB_CODE_SUCCESS) {
-      return ret;
+
+    if (smlJsonNextField(js, &last) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_INVALID_JSON;
     }
   }
 
   return ret;
 }
 
-static int32_t smlParseJSONString(SSmlHandle *info, cJSON *root, SSmlTableInfo *tinfo, SArray *cols) {
+static void smlDestroyJSONKv(SSmlKv *kv) {
+  if (kv == NULL) return;
+  if (kv->type == TSDB_DATA_TYPE_NCHAR || kv->type == TSDB_DATA_TYPE_BINARY) {
+    taosMemoryFree((void *)kv->value);
+  }
+  taosMemoryFree(kv);
+}
+
+static int32_t smlParseJSONString(SSmlHandle *info, SSmlJson *js, SSmlTableInfo *tinfo, SArray *cols) {
   int32_t ret = TSDB_CODE_SUCCESS;
+  SSmlKv *tsKv = NULL;
+  SSmlKv *valueKv = NULL;
+  int32_t size = 0;
+  bool    last = false;
 
-  if (!cJSON_IsObject(root)) {
+  if (!smlJsonConsume(js, '{')) {
     uError("OTD:0x%" PRIx64 " data point needs to be JSON object", info->id);
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  int32_t size = cJSON_GetArraySize(root);
-  // outmost json fields has to be exactly 4
-  if (size != OTD_JSON_FIELDS_NUM) {
-    uError("OTD:0x%" PRIx64 " Invalid number of JSON fields in data point %d", info->id, size);
-    return TSDB_CODE_TSC_INVALID_JSON;
-  }
-
-  // Parse metric
-  ret = smlParseMetricFromJSON(info, root, tinfo);
-  if (ret != TSDB_CODE_SUCCESS) {
-    uError("OTD:0x%" PRIx64 " Unable to parse metric from JSON payload", info->id);
-    return ret;
-  }
-  uDebug("OTD:0x%" PRIx64 " Parse metric from JSON payload finished", info->id);
+  // outmost json fields has to be exactly 4, they may come in any order
+  while (!last) {
+    SSmlJsonVal key = {0};
+    if (smlJsonParseKey(js, &key) != TSDB_CODE_SUCCESS) {
+      ret = TSDB_CODE_TSC_INVALID_JSON;
+      goto _end;
+    }
 
-  // Parse timestamp
-  ret = smlParseTSFromJSON(info, root, cols);
-  if (ret) {
-    uError("OTD:0x%" PRIx64 " Unable to parse timestamp from JSON payload", info->id);
-    return ret;
-  }
-  uDebug("OTD:0x%" PRIx64 " Parse timestamp from JSON payload finished", info->id);
+    if (smlJsonKeyIs(&key, "metric")) {
+      ret = smlParseMetricFromJSON(info, js, tinfo);
+      if (ret != TSDB_CODE_SUCCESS) {
+        uError("OTD:0x%" PRIx64 " Unable to parse metric from JSON payload", info->id);
+        goto _end;
+      }
+    } else if (smlJsonKeyIs(&key, "timestamp") && tsKv == NULL) {
+      ret = smlParseTSFromJSON(info, js, &tsKv);
+      if (ret != TSDB_CODE_SUCCESS) {
+        uError("OTD:0x%" PRIx64 " Unable to parse timestamp from JSON payload", info->id);
+        goto _end;
+      }
+    } else if (smlJsonKeyIs(&key, "value") && valueKv == NULL) {
+      ret = smlParseColsFromJSON(js, &valueKv);
+      if (ret != TSDB_CODE_SUCCESS) {
+        uError("OTD:0x%" PRIx64 " Unable to parse metric value from JSON payload", info->id);
+        goto _end;
+      }
+    } else if (smlJsonKeyIs(&key, "tags")) {
+      ret = smlParseTagsFromJSON(js, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
+      if (ret != TSDB_CODE_SUCCESS) {
+        uError("OTD:0x%" PRIx64 " Unable to parse tags from JSON payload", info->id);
+        goto _end;
+      }
+    } else {
+      ret = TSDB_CODE_TSC_INVALID_JSON;
+      goto _end;
+    }
+    size++;
 
-  // Parse metric value
-  ret = smlParseColsFromJSON(root, cols);
-  if (ret) {
-    uError("OTD:0x%" PRIx64 " Unable to parse metric value from JSON payload", info->id);
-    return ret;
+    ret = smlJsonNextField(js, &last);
+    if (ret != TSDB_CODE_SUCCESS) {
+      goto _end;
+    }
   }
-  uDebug("OTD:0x%" PRIx64 " Parse metric value from JSON payload finished", info->id);
 
-  // Parse tags
-  ret = smlParseTagsFromJSON(root, tinfo->tags, tinfo->childTableName, info->dumplicateKey, &info->msgBuf);
-  if (ret) {
-    uError("OTD:0x%" PRIx64 " Unable to parse tags from JSON payload", info->id);
-    return ret;
+  if (size != OTD_JSON_FIELDS_NUM || tinfo->sTableName == NULL || tsKv == NULL || valueKv == NULL) {
+    uError("OTD:0x%" PRIx64 " Invalid number of JSON fields in data point %d", info->id, size);
+    ret = TSDB_CODE_TSC_INVALID_JSON;
+    goto _end;
   }
-  uDebug("OTD:0x%" PRIx64 " Parse tags from JSON payload finished", info->id);
 
+  // Timestamp must be the first KV
+  taosArrayPush(cols, &tsKv);
+  taosArrayPush(cols, &valueKv);
+  uDebug("OTD:0x%" PRIx64 " Parse JSON data point finished", info->id);
   return TSDB_CODE_SUCCESS;
+
+_end:
+  smlDestroyJSONKv(tsKv);
+  smlDestroyJSONKv(valueKv);
+  return ret;
 }
 /************* TSDB_SML_JSON_PROTOCOL function end **************/
 
@@ -2190,6 +2578,10 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * For json protocol, data is the text of one data point. If len is negative, data is a SSmlJson positioned at the
+ * data point, it is moved past the data point after parsing.
+ */
 static int32_t smlParseTelnetLine(SSmlHandle *info, void *data, const int len) {
   int            ret = TSDB_CODE_SUCCESS;
   SSmlTableInfo *tinfo = smlBuildTableInfo();
@@ -2206,7 +2598,15 @@ static int32_t smlParseTelnetLine(SSmlHandle *info, void *data, const int len) {
   if (info->protocol == TSDB_SML_TELNET_PROTOCOL) {
     ret = smlParseTelnetString(info, (const char *)data, (char*)data + len, tinfo, cols);
   } else if (info->protocol == TSDB_SML_JSON_PROTOCOL) {
-    ret = smlParseJSONString(info, (cJSON *)data, tinfo, cols);
+    if (len < 0) {
+      ret = smlParseJSONString(info, (SSmlJson *)data, tinfo, cols);
+    } else {
+      SSmlJson js = {(const char *)data, (const char *)data + len};
+      ret = smlParseJSONString(info, &js, tinfo, cols);
+      if (ret == TSDB_CODE_SUCCESS && smlJsonPeek(&js) != '\0') {
+        ret = TSDB_CODE_TSC_INVALID_JSON;
+      }
+    }
   } else {
     ASSERT(0);
   }
@@ -2269,7 +2669,6 @@ static int32_t smlParseTelnetLine(SSmlHandle *info, void *data, const int len) {
 }
 
 static int32_t smlParseJSON(SSmlHandle *info, char *payload) {
-  int32_t payloadNum = 0;
   int32_t ret = TSDB_CODE_SUCCESS;
 
   if (payload == NULL) {
@@ -2277,33 +2676,36 @@ static int32_t smlParseJSON(SSmlHandle *info, char *payload) {
     return TSDB_CODE_TSC_INVALID_JSON;
   }
 
-  cJSON *root = cJSON_Parse(payload);
-  if (root == NULL) {
-    uError("SML:0x%" PRIx64 " parse json failed:%s", info->id, payload);
-    return TSDB_CODE_TSC_INVALID_JSON;
-  }
+  SSmlJson js = {payload, payload + strlen(payload)};
+  char     c = smlJsonPeek(&js);
   // multiple data points must be sent in JSON array
-  if (cJSON_IsObject(root)) {
-    payloadNum = 1;
-  } else if (cJSON_IsArray(root)) {
-    payloadNum = cJSON_GetArraySize(root);
+  if (c == '{') {
+    ret = smlParseTelnetLine(info, &js, -1);
+  } else if (c == '[') {
+    js.p++;
+    if (smlJsonConsume(&js, ']')) {
+      return TSDB_CODE_SUCCESS;
+    }
+    while (true) {
+      ret = smlParseTelnetLine(info, &js, -1);
+      if (ret != TSDB_CODE_SUCCESS) {
+        break;
+      }
+      if (smlJsonConsume(&js, ']')) {
+        break;
+      }
+      if (!smlJsonConsume(&js, ',')) {
+        ret = TSDB_CODE_TSC_INVALID_JSON;
+        break;
+      }
+    }
   } else {
-    uError("SML:0x%" PRIx64 " Invalid JSON Payload", info->id);
     ret = TSDB_CODE_TSC_INVALID_JSON;
-    goto end;
   }
 
-  for (int32_t i = 0; i < payloadNum; ++i) {
-    cJSON *dataPoint = (payloadNum == 1 && cJSON_IsObject(root)) ? root : cJSON_GetArrayItem(root, i);
-    ret = smlParseTelnetLine(info, dataPoint, -1);
-    if (ret != TSDB_CODE_SUCCESS) {
-      uError("SML:0x%" PRIx64 " Invalid JSON Payload", info->id);
-      goto end;
-    }
+  if (ret != TSDB_CODE_SUCCESS) {
+    uError("SML:0x%" PRIx64 " Invalid JSON Payload", info->id);
   }
-
-end:
-  cJSON_Delete(root);
   return ret;
 }
 
@@ -2350,7 +2752,7 @@ static int32_t smlInsertData(SSmlHandle *info) {
     oneTable = (SSmlTableInfo **)taosHashIterate(info->childTables, oneTable);
   }
 
-  code = smlBuildOutput(info->exec, info->pVgHash);
+  code = smlBuildOutput(info->exec, info->pVgHash, info->taos->submitColFmt);
   if (code != TSDB_CODE_SUCCESS) {
     uError("SML:0x%" PRIx64 " smlBuildOutput failed", info->id);
     return code;
@@ -2,6 +2,7 @@
 #include "clientInt.h"
 #include "clientLog.h"
 #include "tdef.h"
+#include "tglobal.h"
 
 #include "clientStmt.h"
 
@@ -316,6 +317,7 @@ int32_t stmtCleanSQLInfo(STscStmt* pStmt) {
   taosMemoryFree(pStmt->sql.sqlStr);
   qDestroyQuery(pStmt->sql.pQuery);
   taosArrayDestroy(pStmt->sql.nodeList);
+  planCacheDestroyEntry(pStmt->sql.pQueryPlan);
   taosHashCleanup(pStmt->sql.pVgHash);
   pStmt->sql.pVgHash = NULL;
 
@@ -493,9 +495,22 @@ int32_t stmtGetFromCache(STscStmt* pStmt) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void stmtAsyncResetRows(SStmtAsyncInfo* pAsync) {
+  SStmtAsyncVg** pIter = taosHashIterate(pAsync->pVgroups, NULL);
+  while (pIter) {
+    (*pIter)->numOfRows = 0;
+    taosHashClear((*pIter)->pTables);
+    pIter = taosHashIterate(pAsync->pVgroups, pIter);
+  }
+}
+
 int32_t stmtResetStmt(STscStmt* pStmt) {
   STMT_ERR_RET(stmtCleanSQLInfo(pStmt));
 
+  if (pStmt->pAsync) {
+    stmtAsyncResetRows(pStmt->pAsync);
+  }
+
   pStmt->sql.pTableCache = taosHashInit(100, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
   if (NULL == pStmt->sql.pTableCache) {
     terrno = TSDB_CODE_TSC_OUT_OF_MEMORY;
@@ -549,6 +564,11 @@ int stmtPrepare(TAOS_STMT* stmt, const char* sql, unsigned long length) {
   pStmt->sql.sqlStr = strndup(sql, length);
   pStmt->sql.sqlLen = length;
 
+  // a query is parsed here, only translation and planning wait for the types of the bound values
+  if (!qIsInsertValuesSql(pStmt->sql.sqlStr, pStmt->sql.sqlLen)) {
+    STMT_ERR_RET(stmtParseSql(pStmt));
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -646,6 +666,464 @@ int stmtFetchColFields(STscStmt* pStmt, int32_t* fieldNum, TAOS_FIELD_E** fields
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t stmtTranslateQuery(STscStmt* pStmt) {
+  SParseContext ctx = {.requestId = pStmt->exec.pRequest->requestId,
+                       .acctId = pStmt->taos->acctId,
+                       .db = pStmt->exec.pRequest->pDb,
+                       .topicQuery = false,
+                       .pSql = pStmt->sql.sqlStr,
+                       .sqlLen = pStmt->sql.sqlLen,
+                       .pMsg = pStmt->exec.pRequest->msgBuf,
+                       .msgLen = ERROR_MSG_BUF_DEFAULT_SIZE,
+                       .pTransporter = pStmt->taos->pAppInfo->pTransporter,
+                       .pStmtCb = NULL,
+                       .pUser = pStmt->taos->user};
+  ctx.mgmtEpSet = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp);
+  STMT_ERR_RET(catalogGetHandle(pStmt->taos->pAppInfo->clusterId, &ctx.pCatalog));
+
+  STMT_ERR_RET(qStmtParseQuerySql(&ctx, pStmt->sql.pQuery));
+
+  if (pStmt->sql.pQuery->haveResultSet) {
+    setResSchemaInfo(&pStmt->exec.pRequest->body.resInfo, pStmt->sql.pQuery->pResSchema,
+                     pStmt->sql.pQuery->numOfResCols);
+    taosMemoryFreeClear(pStmt->sql.pQuery->pResSchema);
+    setResPrecision(&pStmt->exec.pRequest->body.resInfo, pStmt->sql.pQuery->precision);
+  }
+
+  TSWAP(pStmt->exec.pRequest->dbList, pStmt->sql.pQuery->pDbList);
+  TSWAP(pStmt->exec.pRequest->tableList, pStmt->sql.pQuery->pTableList);
+  TSWAP(pStmt->exec.pRequest->targetTableList, pStmt->sql.pQuery->pTargetTableList);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+typedef struct SStmtAsyncReq {
+  STscStmt*      pStmt;
+  SStmtAsyncVg*  pVg;
+  SArray*        pTables;  // SArray<SName>
+  SVgDataBlocks* pBlocks;  // the submit msg, kept until it succeeds to be sent again
+  int32_t        code;
+  int32_t        retry;
+} SStmtAsyncReq;
+
+static void stmtAsyncDestroyReq(SStmtAsyncReq* pReq) {
+  taosArrayDestroy(pReq->pTables);
+  if (pReq->pBlocks) {
+    taosMemoryFree(pReq->pBlocks->pData);
+    taosMemoryFree(pReq->pBlocks);
+  }
+  taosMemoryFree(pReq);
+}
+
+static int32_t stmtAsyncAddRows(STscStmt* pStmt, int32_t numOfRows) {
+  if (pStmt->sql.autoCreateTbl) {
+    tscError("async stmt does not support auto create table");
+    STMT_ERR_RET(TSDB_CODE_TSC_STMT_API_ERROR);
+  }
+
+  STableDataBlocks** pDataBlock =
+      (STableDataBlocks**)taosHashGet(pStmt->exec.pBlockHash, pStmt->bInfo.tbFName, strlen(pStmt->bInfo.tbFName));
+  if (NULL == pDataBlock) {
+    tscError("table %s not found in exec blockHash", pStmt->bInfo.tbFName);
+    STMT_ERR_RET(TSDB_CODE_QRY_APP_ERROR);
+  }
+
+  int32_t        vgId = qGetTableMetaInDataBlock(*pDataBlock)->vgId;
+  SStmtAsyncVg** ppVg = taosHashGet(pStmt->pAsync->pVgroups, &vgId, sizeof(vgId));
+  SStmtAsyncVg*  pVg = ppVg ? *ppVg : NULL;
+  if (NULL == pVg) {
+    pVg = taosMemoryCalloc(1, sizeof(SStmtAsyncVg));
+    if (NULL == pVg) {
+      STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+    }
+    pVg->pTables = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    if (NULL == pVg->pTables || taosHashPut(pStmt->pAsync->pVgroups, &vgId, sizeof(vgId), &pVg, POINTER_BYTES)) {
+      taosHashCleanup(pVg->pTables);
+      taosMemoryFree(pVg);
+      STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+    }
+    pVg->vgId = vgId;
+  }
+
+  int32_t keyLen = strlen(pStmt->bInfo.tbFName);
+  if (NULL == taosHashGet(pVg->pTables, pStmt->bInfo.tbFName, keyLen) &&
+      taosHashPut(pVg->pTables, pStmt->bInfo.tbFName, keyLen, &pStmt->bInfo.sname, sizeof(SName))) {
+    STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+  }
+
+  if (0 == pVg->numOfRows) {
+    pVg->firstTs = taosGetTimestampMs();
+  }
+  pVg->numOfRows += numOfRows;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// account a finished submit and hand its result to the callback, which owns res then
+static void stmtAsyncDone(SStmtAsyncReq* pReq, void* res, int32_t code) {
+  SStmtAsyncInfo*   pAsync = pReq->pStmt->pAsync;
+  int64_t           affectedRows = (TSDB_CODE_SUCCESS == code) ? taos_affected_rows(res) : 0;
+  __taos_async_fn_t fp = NULL;
+  void*             param = NULL;
+
+  tscDebug("stmt async submit to vgId:%d done, code:%s", pReq->pVg->vgId, tstrerror(code));
+
+  // the stmt may be executed or closed as soon as the submit is not in flight, nothing of it is used after that
+  taosThreadMutexLock(&pAsync->lock);
+  if (TSDB_CODE_SUCCESS != code) {
+    if (TSDB_CODE_SUCCESS == pAsync->code) {
+      pAsync->code = code;
+    }
+  } else {
+    pAsync->affectedRows += affectedRows;
+  }
+  fp = pAsync->fp;
+  param = pAsync->param;
+  --pReq->pVg->inflight;
+  --pAsync->inflight;
+  taosThreadCondBroadcast(&pAsync->cond);
+  taosThreadMutexUnlock(&pAsync->lock);
+
+  stmtAsyncDestroyReq(pReq);
+
+  if (fp) {
+    (*fp)(param, res, code);
+  } else {
+    taos_free_result(res);
+  }
+}
+
+static void stmtAsyncSubmitCb(void* param, void* res, int32_t code) {
+  SStmtAsyncReq*  pReq = (SStmtAsyncReq*)param;
+  SStmtAsyncInfo* pAsync = pReq->pStmt->pAsync;
+
+  if (NEED_CLIENT_HANDLE_ERROR(code) && pReq->retry < REQUEST_TOTAL_EXEC_TIMES) {
+    // the meta is refreshed by the thread of the stmt, the submit stays in flight until it is sent again
+    tscDebug("stmt async submit to vgId:%d failed since %s, retry:%d", pReq->pVg->vgId, tstrerror(code), pReq->retry);
+    pReq->code = code;
+    taosThreadMutexLock(&pAsync->lock);
+    void* p = taosArrayPush(pAsync->pRetry, &pReq);
+    taosThreadCondBroadcast(&pAsync->cond);
+    taosThreadMutexUnlock(&pAsync->lock);
+    if (p) {
+      destroyRequest((SRequestObj*)res);
+      return;
+    }
+  }
+
+  stmtAsyncDone(pReq, res, code);
+}
+
+static int32_t stmtAsyncBuildReq(STscStmt* pStmt, SStmtAsyncVg* pVg, SStmtAsyncReq* pReq) {
+  SHashObj* pBlocks = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  SQuery*   pQuery = (SQuery*)nodesMakeNode(QUERY_NODE_QUERY);
+  int32_t   code = TSDB_CODE_SUCCESS;
+
+  pReq->pTables = taosArrayInit(taosHashGetSize(pVg->pTables), sizeof(SName));
+  if (NULL == pBlocks || NULL == pQuery || NULL == pReq->pTables) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+  } else {
+    pQuery->pRoot = nodesMakeNode(QUERY_NODE_VNODE_MODIF_STMT);
+    if (NULL == pQuery->pRoot) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  size_t keyLen = 0;
+  SName* pIter = (TSDB_CODE_SUCCESS == code) ? taosHashIterate(pVg->pTables, NULL) : NULL;
+  while (pIter) {
+    char*              key = taosHashGetKey(pIter, &keyLen);
+    STableDataBlocks** pDataBlock = (STableDataBlocks**)taosHashGet(pStmt->exec.pBlockHash, key, keyLen);
+    if (pDataBlock && (taosHashPut(pBlocks, key, keyLen, pDataBlock, POINTER_BYTES) ||
+                       NULL == taosArrayPush(pReq->pTables, pIter))) {
+      taosHashCancelIterate(pVg->pTables, pIter);
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      break;
+    }
+    pIter = taosHashIterate(pVg->pTables, pIter);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = qBuildStmtOutput(pQuery, pStmt->sql.pVgHash, pBlocks, pStmt->taos->submitColFmt);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    SArray* pDataBlocks = ((SVnodeModifOpStmt*)pQuery->pRoot)->pDataBlocks;
+    if (1 != taosArrayGetSize(pDataBlocks)) {
+      code = TSDB_CODE_QRY_APP_ERROR;
+    } else {
+      pReq->pBlocks = taosArrayGetP(pDataBlocks, 0);
+      taosArrayClear(pDataBlocks);
+    }
+  }
+  qDestroyQuery(pQuery);
+
+  if (TSDB_CODE_SUCCESS != code) {
+    taosHashCleanup(pBlocks);
+    STMT_ERR_RET(code);
+  }
+
+  // the submit msg owns a copy of the rows now, the current table keeps its block for the next bind
+  STableDataBlocks** ppBlock = taosHashIterate(pBlocks, NULL);
+  while (ppBlock) {
+    char* key = taosHashGetKey(ppBlock, &keyLen);
+    if (keyLen == strlen(pStmt->bInfo.tbFName) && 0 == strncmp(key, pStmt->bInfo.tbFName, keyLen)) {
+      if (TSDB_CODE_SUCCESS == code) {
+        code = qResetStmtDataBlock(*ppBlock, true);
+      }
+    } else {
+      qFreeStmtDataBlock(*ppBlock);
+      taosHashRemove(pStmt->exec.pBlockHash, key, keyLen);
+    }
+    ppBlock = taosHashIterate(pBlocks, ppBlock);
+  }
+  taosHashCleanup(pBlocks);
+  taosHashClear(pVg->pTables);
+
+  STMT_RET(code);
+}
+
+// send a copy of the submit msg of pReq, to the vgroup the refreshed meta routes its tables to if refresh
+static int32_t stmtAsyncLaunch(STscStmt* pStmt, SStmtAsyncReq* pReq, bool refresh) {
+  SRequestObj*         pRequest = createRequest(pStmt->taos->id, TSDB_SQL_INSERT);
+  SSqlCallbackWrapper* pWrapper = taosMemoryCalloc(1, sizeof(SSqlCallbackWrapper));
+  SQuery*              pQuery = (SQuery*)nodesMakeNode(QUERY_NODE_QUERY);
+  SVgDataBlocks*       pBlocks = taosMemoryMalloc(sizeof(SVgDataBlocks));
+  void*                pData = taosMemoryMalloc(pReq->pBlocks->size);
+  int32_t              code = TSDB_CODE_SUCCESS;
+
+  if (NULL == pRequest || NULL == pWrapper || NULL == pQuery || NULL == pBlocks || NULL == pData) {
+    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+  } else {
+    memcpy(pBlocks, pReq->pBlocks, sizeof(SVgDataBlocks));
+    memcpy(pData, pReq->pBlocks->pData, pReq->pBlocks->size);
+    pBlocks->pData = pData;
+    pData = NULL;
+
+    pQuery->execMode = QUERY_EXEC_MODE_SCHEDULE;
+    pQuery->haveResultSet = false;
+    pQuery->msgType = TDMT_VND_SUBMIT;
+    pQuery->pRoot = nodesMakeNode(QUERY_NODE_VNODE_MODIF_STMT);
+    SVnodeModifOpStmt* pModif = (SVnodeModifOpStmt*)pQuery->pRoot;
+    if (NULL == pModif || NULL == (pModif->pDataBlocks = taosArrayInit(1, POINTER_BYTES)) ||
+        NULL == taosArrayPush(pModif->pDataBlocks, &pBlocks)) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    } else {
+      pBlocks = NULL;
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    char dbFName[TSDB_DB_FNAME_LEN];
+    tNameGetFullDbName(taosArrayGet(pReq->pTables, 0), dbFName);
+    pRequest->dbList = taosArrayInit(1, TSDB_DB_FNAME_LEN);
+    pRequest->tableList = taosArrayDup(pReq->pTables);
+    if (NULL == pRequest->dbList || NULL == pRequest->tableList || NULL == taosArrayPush(pRequest->dbList, dbFName)) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && refresh) {
+    SVgroupInfo      vgInfo = {0};
+    SRequestConnInfo conn = {.pTrans = pStmt->taos->pAppInfo->pTransporter,
+                             .requestId = pRequest->requestId,
+                             .requestObjRefId = pRequest->self,
+                             .mgmtEps = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp)};
+
+    code = refreshMeta(pStmt->taos, pRequest);
+    if (TSDB_CODE_SUCCESS == code) {
+      code = catalogGetTableHashVgroup(pStmt->pCatalog, &conn, taosArrayGet(pReq->pTables, 0), &vgInfo);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      // the msg is built for the vgroup, tables moved to another one can only be bound again
+      if (vgInfo.vgId != pReq->pBlocks->vg.vgId) {
+        code = pReq->code;
+      } else {
+        pReq->pBlocks->vg = vgInfo;
+        (*(SVgDataBlocks**)taosArrayGet(((SVnodeModifOpStmt*)pQuery->pRoot)->pDataBlocks, 0))->vg = vgInfo;
+      }
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS != code) {
+    if (pBlocks) {
+      taosMemoryFree(pBlocks->pData);
+      taosMemoryFree(pBlocks);
+    }
+    taosMemoryFree(pData);
+    qDestroyQuery(pQuery);
+    destroyRequest(pRequest);
+    taosMemoryFree(pWrapper);
+    STMT_ERR_RET(code);
+  }
+
+  pWrapper->pRequest = pRequest;
+  pRequest->pQuery = pQuery;
+  pRequest->stmtType = pQuery->pRoot->type;
+  pRequest->body.queryFp = stmtAsyncSubmitCb;
+  pRequest->body.param = pReq;
+
+  tscDebug("stmt async submit %d tables to vgId:%d, retry:%d, reqId:0x%" PRIx64, pReq->pBlocks->numOfTables,
+           pReq->pBlocks->vg.vgId, pReq->retry, pRequest->requestId);
+
+  atomic_add_fetch_64((int64_t*)&pStmt->taos->pAppInfo->summary.numOfInsertsReq, 1);
+  launchAsyncQuery(pRequest, pQuery, NULL, pWrapper);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void stmtAsyncResubmit(STscStmt* pStmt, SStmtAsyncReq* pReq) {
+  ++pReq->retry;
+  int32_t code = stmtAsyncLaunch(pStmt, pReq, true);
+  if (code) {
+    stmtAsyncDone(pReq, NULL, code);
+  }
+}
+
+// wait until at most maxInflight submits counted by pInflight are in flight, resubmitting the failed ones meanwhile
+static void stmtAsyncWait(STscStmt* pStmt, int32_t* pInflight, int32_t maxInflight) {
+  SStmtAsyncInfo* pAsync = pStmt->pAsync;
+
+  taosThreadMutexLock(&pAsync->lock);
+  while (*pInflight > maxInflight) {
+    if (taosArrayGetSize(pAsync->pRetry) > 0) {
+      SStmtAsyncReq* pReq = *(SStmtAsyncReq**)taosArrayPop(pAsync->pRetry);
+      taosThreadMutexUnlock(&pAsync->lock);
+      stmtAsyncResubmit(pStmt, pReq);
+      taosThreadMutexLock(&pAsync->lock);
+      continue;
+    }
+    taosThreadCondWait(&pAsync->cond, &pAsync->lock);
+  }
+  taosThreadMutexUnlock(&pAsync->lock);
+}
+
+static int32_t stmtAsyncFlushVg(STscStmt* pStmt, SStmtAsyncVg* pVg) {
+  SStmtAsyncInfo* pAsync = pStmt->pAsync;
+
+  stmtAsyncWait(pStmt, &pVg->inflight, tsStmtMaxInflight - 1);
+
+  SStmtAsyncReq* pReq = taosMemoryCalloc(1, sizeof(SStmtAsyncReq));
+  if (NULL == pReq) {
+    STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+  }
+  pReq->pStmt = pStmt;
+  pReq->pVg = pVg;
+
+  int32_t code = stmtAsyncBuildReq(pStmt, pVg, pReq);
+  if (TSDB_CODE_SUCCESS == code) {
+    pVg->numOfRows = 0;
+
+    // the submit may complete before it is launched
+    taosThreadMutexLock(&pAsync->lock);
+    ++pVg->inflight;
+    ++pAsync->inflight;
+    taosThreadMutexUnlock(&pAsync->lock);
+
+    code = stmtAsyncLaunch(pStmt, pReq, false);
+    if (code) {
+      taosThreadMutexLock(&pAsync->lock);
+      --pVg->inflight;
+      --pAsync->inflight;
+      taosThreadMutexUnlock(&pAsync->lock);
+    }
+  }
+
+  if (code) {
+    stmtAsyncDestroyReq(pReq);
+    STMT_ERR_RET(code);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// send the vgroups whose buffered rows reached the size or age limit, all pending ones if flushAll
+static int32_t stmtAsyncFlush(STscStmt* pStmt, bool flushAll) {
+  int64_t        now = taosGetTimestampMs();
+  SStmtAsyncVg** pIter = taosHashIterate(pStmt->pAsync->pVgroups, NULL);
+  while (pIter) {
+    SStmtAsyncVg* pVg = *pIter;
+    if (pVg->numOfRows > 0 &&
+        (flushAll || pVg->numOfRows >= tsStmtFlushRows || now - pVg->firstTs >= tsStmtFlushInterval)) {
+      int32_t code = stmtAsyncFlushVg(pStmt, pVg);
+      if (code) {
+        taosHashCancelIterate(pStmt->pAsync->pVgroups, pIter);
+        STMT_ERR_RET(code);
+      }
+    }
+    pIter = taosHashIterate(pStmt->pAsync->pVgroups, pIter);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void stmtAsyncDestroy(STscStmt* pStmt) {
+  SStmtAsyncInfo* pAsync = pStmt->pAsync;
+  if (NULL == pAsync) {
+    return;
+  }
+
+  stmtAsyncWait(pStmt, &pAsync->inflight, 0);
+
+  SStmtAsyncVg** pIter = taosHashIterate(pAsync->pVgroups, NULL);
+  while (pIter) {
+    taosHashCleanup((*pIter)->pTables);
+    taosMemoryFree(*pIter);
+    pIter = taosHashIterate(pAsync->pVgroups, pIter);
+  }
+  taosHashCleanup(pAsync->pVgroups);
+  taosArrayDestroy(pAsync->pRetry);
+  taosThreadCondDestroy(&pAsync->cond);
+  taosThreadMutexDestroy(&pAsync->lock);
+  taosMemoryFree(pAsync);
+  pStmt->pAsync = NULL;
+}
+
+static int32_t stmtAsyncExec(STscStmt* pStmt) {
+  SStmtAsyncInfo* pAsync = pStmt->pAsync;
+  int32_t         code = stmtAsyncFlush(pStmt, true);
+
+  stmtAsyncWait(pStmt, &pAsync->inflight, 0);
+
+  taosThreadMutexLock(&pAsync->lock);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = pAsync->code;
+  }
+  pStmt->exec.affectedRows = pAsync->affectedRows;
+  pAsync->code = TSDB_CODE_SUCCESS;
+  pAsync->affectedRows = 0;
+  taosThreadMutexUnlock(&pAsync->lock);
+
+  pStmt->affectedRows += pStmt->exec.affectedRows;
+
+  if (code) {
+    stmtAsyncResetRows(pAsync);
+  }
+  stmtCleanExecInfo(pStmt, (code ? false : true), false);
+
+  ++pStmt->sql.runTimes;
+
+  STMT_RET(code);
+}
+
+static int32_t stmtExecQuery(STscStmt* pStmt) {
+  bool keepPlan = false;
+  if (pStmt->sql.pQueryPlan) {
+    if (TSDB_CODE_SUCCESS == launchStmtCachedQuery(pStmt->exec.pRequest, pStmt->sql.pQueryPlan, pStmt->sql.pQuery)) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    // the bound values do not fit the plan, e.g. another type, translate them as the first execution did
+    planCacheDestroyEntry(pStmt->sql.pQueryPlan);
+    pStmt->sql.pQueryPlan = NULL;
+    STMT_ERR_RET(stmtTranslateQuery(pStmt));
+    keepPlan = true;
+  }
+
+  launchStmtQuery(pStmt->exec.pRequest, pStmt->sql.pQuery, keepPlan ? &pStmt->sql.pQueryPlan : NULL);
+  return TSDB_CODE_SUCCESS;
+}
+
 int stmtBindBatch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind, int32_t colIdx) {
   STscStmt* pStmt = (STscStmt*)stmt;
 
@@ -672,33 +1150,14 @@ int stmtBindBatch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind, int32_t colIdx) {
   if (STMT_TYPE_QUERY == pStmt->sql.type) {
     STMT_ERR_RET(qStmtBindParams(pStmt->sql.pQuery, bind, colIdx));
 
-    SParseContext ctx = {.requestId = pStmt->exec.pRequest->requestId,
-                         .acctId = pStmt->taos->acctId,
-                         .db = pStmt->exec.pRequest->pDb,
-                         .topicQuery = false,
-                         .pSql = pStmt->sql.sqlStr,
-                         .sqlLen = pStmt->sql.sqlLen,
-                         .pMsg = pStmt->exec.pRequest->msgBuf,
-                         .msgLen = ERROR_MSG_BUF_DEFAULT_SIZE,
-                         .pTransporter = pStmt->taos->pAppInfo->pTransporter,
-                         .pStmtCb = NULL,
-                         .pUser = pStmt->taos->user};
-    ctx.mgmtEpSet = getEpSet_s(&pStmt->taos->pAppInfo->mgmtEp);
-    STMT_ERR_RET(catalogGetHandle(pStmt->taos->pAppInfo->clusterId, &ctx.pCatalog));
-
-    STMT_ERR_RET(qStmtParseQuerySql(&ctx, pStmt->sql.pQuery));
-
-    if (pStmt->sql.pQuery->haveResultSet) {
-      setResSchemaInfo(&pStmt->exec.pRequest->body.resInfo, pStmt->sql.pQuery->pResSchema,
-                       pStmt->sql.pQuery->numOfResCols);
-      taosMemoryFreeClear(pStmt->sql.pQuery->pResSchema);
-      setResPrecision(&pStmt->exec.pRequest->body.resInfo, pStmt->sql.pQuery->precision);
+    // the plan is made once the first values are bound, the values of later binds are rebound into it at execution
+    if (NULL == pStmt->sql.pQueryPlan) {
+      STMT_ERR_RET(stmtTranslateQuery(pStmt));
+      if (0 == pStmt->sql.runTimes && (colIdx < 0 || colIdx + 1 == pStmt->sql.pQuery->placeholderNum)) {
+        createStmtPlan(pStmt->exec.pRequest, pStmt->sql.pQuery, &pStmt->sql.pQueryPlan);
+      }
     }
 
-    TSWAP(pStmt->exec.pRequest->dbList, pStmt->sql.pQuery->pDbList);
-    TSWAP(pStmt->exec.pRequest->tableList, pStmt->sql.pQuery->pTableList);
-    TSWAP(pStmt->exec.pRequest->targetTableList, pStmt->sql.pQuery->pTargetTableList);
-
     // if (STMT_TYPE_QUERY == pStmt->sql.queryRes) {
     //   STMT_ERR_RET(stmtRestoreQueryFields(pStmt));
     // }
@@ -733,8 +1192,18 @@ int stmtBindBatch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind, int32_t colIdx) {
       pStmt->bInfo.sBindRowNum = bind->num;
     }
 
-    qBindStmtSingleColValue(*pDataBlock, bind, pStmt->exec.pRequest->msgBuf, pStmt->exec.pRequest->msgBufLen, colIdx,
-                            pStmt->bInfo.sBindRowNum);
+    int32_t code = qBindStmtSingleColValue(*pDataBlock, bind, pStmt->exec.pRequest->msgBuf,
+                                           pStmt->exec.pRequest->msgBufLen, colIdx, pStmt->bInfo.sBindRowNum);
+    if (code) {
+      // the columns bound so far are rolled back, the rows have to be bound again from the first column
+      pStmt->bInfo.sBindLastIdx = -1;
+      tscError("qBindStmtSingleColValue failed, error:%s", tstrerror(code));
+      STMT_ERR_RET(code);
+    }
+  }
+
+  if (pStmt->pAsync && colIdx <= 0) {
+    STMT_ERR_RET(stmtAsyncAddRows(pStmt, bind->num));
   }
 
   return TSDB_CODE_SUCCESS;
@@ -749,6 +1218,10 @@ int stmtAddBatch(TAOS_STMT* stmt) {
 
   STMT_ERR_RET(stmtCacheBlock(pStmt));
 
+  if (pStmt->pAsync) {
+    STMT_ERR_RET(stmtAsyncFlush(pStmt, false));
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -814,10 +1287,15 @@ int stmtExec(TAOS_STMT* stmt) {
 
   STMT_ERR_RET(stmtSwitchStatus(pStmt, STMT_EXECUTE));
 
+  if (pStmt->pAsync && STMT_TYPE_QUERY != pStmt->sql.type) {
+    return stmtAsyncExec(pStmt);
+  }
+
   if (STMT_TYPE_QUERY == pStmt->sql.type) {
-    launchQueryImpl(pStmt->exec.pRequest, pStmt->sql.pQuery, true, NULL);
+    STMT_ERR_RET(stmtExecQuery(pStmt));
   } else {
-    STMT_ERR_RET(qBuildStmtOutput(pStmt->sql.pQuery, pStmt->sql.pVgHash, pStmt->exec.pBlockHash));
+    STMT_ERR_RET(qBuildStmtOutput(pStmt->sql.pQuery, pStmt->sql.pVgHash, pStmt->exec.pBlockHash,
+                                  pStmt->taos->submitColFmt));
     launchQueryImpl(pStmt->exec.pRequest, pStmt->sql.pQuery, true, (autoCreateTbl ? (void**)&pRsp : NULL));
   }
 
@@ -860,12 +1338,68 @@ _return:
 int stmtClose(TAOS_STMT* stmt) {
   STscStmt* pStmt = (STscStmt*)stmt;
 
+  stmtAsyncDestroy(pStmt);
   stmtCleanSQLInfo(pStmt);
   taosMemoryFree(stmt);
 
   return TSDB_CODE_SUCCESS;
 }
 
+int stmtSetAsync(TAOS_STMT* stmt, __taos_async_fn_t fp, void* param) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+
+  tscDebug("stmt start to set async");
+
+  if (pStmt->pAsync) {
+    taosThreadMutexLock(&pStmt->pAsync->lock);
+    pStmt->pAsync->fp = fp;
+    pStmt->pAsync->param = param;
+    taosThreadMutexUnlock(&pStmt->pAsync->lock);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SStmtAsyncInfo* pAsync = taosMemoryCalloc(1, sizeof(SStmtAsyncInfo));
+  if (NULL == pAsync) {
+    STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+  }
+
+  pAsync->pVgroups = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_NO_LOCK);
+  pAsync->pRetry = taosArrayInit(4, POINTER_BYTES);
+  if (NULL == pAsync->pVgroups || NULL == pAsync->pRetry) {
+    taosHashCleanup(pAsync->pVgroups);
+    taosArrayDestroy(pAsync->pRetry);
+    taosMemoryFree(pAsync);
+    STMT_ERR_RET(TSDB_CODE_TSC_OUT_OF_MEMORY);
+  }
+
+  taosThreadMutexInit(&pAsync->lock, NULL);
+  taosThreadCondInit(&pAsync->cond, NULL);
+  pAsync->fp = fp;
+  pAsync->param = param;
+  pStmt->pAsync = pAsync;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int stmtBindTables(TAOS_STMT* stmt, int32_t numOfTables, const char** tbnames, TAOS_MULTI_BIND** binds) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+
+  tscDebug("stmt start to bind %d tables", numOfTables);
+
+  if (NULL == pStmt->pAsync) {
+    tscError("bind tables needs an async stmt");
+    STMT_ERR_RET(TSDB_CODE_TSC_STMT_API_ERROR);
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STMT_ERR_RET(stmtSetTbName(stmt, tbnames[i]));
+    STMT_ERR_RET(stmtBindBatch(stmt, binds[i], -1));
+    STMT_ERR_RET(stmtAddBatch(stmt));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 const char* stmtErrstr(TAOS_STMT* stmt) {
   STscStmt* pStmt = (STscStmt*)stmt;
 
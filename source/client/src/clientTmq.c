@@ -1762,18 +1762,19 @@ TAOS_RES* tmq_consumer_poll(tmq_t* tmq, int64_t timeout) {
       tscDebug("consumer:%" PRId64 ", return null since no committed offset", tmq->consumerId);
       return NULL;
     }
+    // vnodes hold the poll until data arrives, just wait for the rsp here
     if (timeout != -1) {
       int64_t endTime = taosGetTimestampMs();
-      int64_t leftTime = endTime - startTime;
-      if (leftTime > timeout) {
+      int64_t elapsed = endTime - startTime;
+      if (elapsed >= timeout) {
         tscDebug("consumer:%" PRId64 ", (epoch %d) timeout, no rsp, start time %" PRId64 ", end time %" PRId64,
                  tmq->consumerId, tmq->epoch, startTime, endTime);
         return NULL;
       }
-      tsem_timewait(&tmq->rspSem, leftTime * 1000);
+      tsem_timewait(&tmq->rspSem, (timeout - elapsed) * 1000000);
     } else {
       // use tsem_timewait instead of tsem_wait to avoid unexpected stuck
-      tsem_timewait(&tmq->rspSem, 500 * 1000);
+      tsem_timewait(&tmq->rspSem, 500 * 1000000L);
     }
   }
 }
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "../src/clientPlanCache.c"
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  SCatalogCfg cfg = {0};
+  catalogInit(&cfg);
+  return RUN_ALL_TESTS();
+}
+
+namespace {
+
+SValueNode *makeValue(int8_t type, const char *literal, int64_t v) {
+  SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  pVal->node.resType.type = type;
+  pVal->node.resType.bytes = tDataTypes[type].bytes;
+  pVal->node.resType.precision = TSDB_TIME_PRECISION_MILLI;
+  pVal->literal = (char *)taosMemoryStrDup(literal);
+  pVal->translate = true;
+  pVal->datum.i = v;
+  pVal->typeData = v;
+  return pVal;
+}
+
+SNode *makeCond(EOperatorType opType, const char *colName, SValueNode *pVal) {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = pVal->node.resType.type;
+  pCol->node.resType.bytes = pVal->node.resType.bytes;
+  strcpy(pCol->colName, colName);
+
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->opType = opType;
+  pOp->pLeft = (SNode *)pCol;
+  pOp->pRight = (SNode *)pVal;
+  return (SNode *)pOp;
+}
+
+// select ... from t where ts between [skey, ekey] and c1 = <literal>, as the optimizer leaves it
+SQueryPlan *makePlan(int64_t skey, int64_t ekey, const char *literal, int64_t v) {
+  STableScanPhysiNode *pScan = (STableScanPhysiNode *)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN);
+  pScan->scan.node.pOutputDataBlockDesc = (SDataBlockDescNode *)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pScan->scan.node.pOutputDataBlockDesc->precision = TSDB_TIME_PRECISION_MILLI;
+  pScan->scan.node.pConditions = makeCond(OP_TYPE_EQUAL, "c1", makeValue(TSDB_DATA_TYPE_BIGINT, literal, v));
+  pScan->scanRange.skey = skey;
+  pScan->scanRange.ekey = ekey;
+
+  SSubplan *pSubplan = (SSubplan *)nodesMakeNode(QUERY_NODE_PHYSICAL_SUBPLAN);
+  pSubplan->subplanType = SUBPLAN_TYPE_SCAN;
+  pSubplan->pNode = (SPhysiNode *)pScan;
+
+  SNodeListNode *pGroup = (SNodeListNode *)nodesMakeNode(QUERY_NODE_NODE_LIST);
+  nodesListMakeAppend(&pGroup->pNodeList, (SNode *)pSubplan);
+  SQueryPlan *pDag = (SQueryPlan *)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN);
+  pDag->numOfSubplans = 1;
+  nodesListMakeAppend(&pDag->pSubplans, (SNode *)pGroup);
+  return pDag;
+}
+
+STableScanPhysiNode *getScan(SQueryPlan *pDag) {
+  SNodeListNode *pGroup = (SNodeListNode *)nodesListGetNode(pDag->pSubplans, 0);
+  return (STableScanPhysiNode *)((SSubplan *)nodesListGetNode(pGroup->pNodeList, 0))->pNode;
+}
+
+SValueNode *getCondValue(SQueryPlan *pDag) {
+  return (SValueNode *)((SOperatorNode *)getScan(pDag)->scan.node.pConditions)->pRight;
+}
+
+SArray *makeConsts(const std::vector<std::pair<int32_t, const char *>> &consts) {
+  SArray *pArray = taosArrayInit(consts.size(), sizeof(SQueryConstant));
+  for (auto &c : consts) {
+    SQueryConstant qc = {c.first, (char *)taosMemoryStrDup(c.second)};
+    taosArrayPush(pArray, &qc);
+  }
+  return pArray;
+}
+
+// an entry of the plan as planCacheCreateEntry builds it, without the catalog part
+SPlanCacheEntry *makeEntry(SQueryPlan *pDag, SArray *pConsts) {
+  SPlanCacheEntry *pEntry = (SPlanCacheEntry *)taosMemoryCalloc(1, sizeof(SPlanCacheEntry));
+  pEntry->precision = TSDB_TIME_PRECISION_MILLI;
+  pEntry->msgType = TDMT_SCH_QUERY;
+  pEntry->numOfResCols = 1;
+  pEntry->pResSchema = (SSchema *)taosMemoryCalloc(1, sizeof(SSchema));
+  pEntry->pResSchema[0].type = TSDB_DATA_TYPE_BIGINT;
+  pEntry->pResSchema[0].bytes = sizeof(int64_t);
+  strcpy(pEntry->pResSchema[0].name, "c1");
+  pEntry->pDbList = taosArrayInit(1, TSDB_DB_FNAME_LEN);
+  pEntry->pTableList = taosArrayInit(1, sizeof(SName));
+  pEntry->pDbs = taosArrayInit(1, sizeof(SPlanCacheDb));
+  pEntry->pTables = taosArrayInit(1, sizeof(SPlanCacheTable));
+  pEntry->pNodeList = taosArrayInit(1, sizeof(SQueryNodeLoad));
+  pEntry->numOfConsts = taosArrayGetSize(pConsts);
+  EXPECT_EQ(planCacheInitEntryConsts(pEntry, pConsts), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(planCacheSaveSubplans(pEntry, pDag), TSDB_CODE_SUCCESS);
+  return pEntry;
+}
+
+SQueryPlan *rebuild(SPlanCacheEntry *pEntry, SArray *pConsts, SPlanCacheConst **ppConsts = NULL) {
+  SPlanCacheConst *pNew = NULL;
+  SQueryPlan      *pDag = NULL;
+  EXPECT_EQ(planCacheInitConsts(pConsts, pEntry->precision, &pNew), TSDB_CODE_SUCCESS);
+  if (TSDB_CODE_SUCCESS != planCacheBuildPlan(pEntry, pNew, 1, &pDag)) {
+    pDag = NULL;
+  }
+  if (NULL != ppConsts) {
+    *ppConsts = pNew;
+  } else {
+    taosMemoryFree(pNew);
+  }
+  return pDag;
+}
+
+SPlanCacheConst tsConst(const char *literal, int64_t ts) {
+  SPlanCacheConst c = {0};
+  c.literal = (char *)literal;
+  c.isTs = true;
+  c.ts = ts;
+  return c;
+}
+
+}  // namespace
+
+TEST(planCacheTest, setValue) {
+  SValueNode *pVal = makeValue(TSDB_DATA_TYPE_BIGINT, "10", 10);
+  ASSERT_EQ(planCacheSetValue(pVal, "-42"), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(pVal->datum.i, -42);
+  EXPECT_EQ(pVal->typeData, -42);
+  EXPECT_STREQ(pVal->literal, "-42");
+  EXPECT_NE(planCacheSetValue(pVal, "4x"), TSDB_CODE_SUCCESS);
+  nodesDestroyNode((SNode *)pVal);
+
+  pVal = makeValue(TSDB_DATA_TYPE_TIMESTAMP, "0", 0);
+  ASSERT_EQ(planCacheSetValue(pVal, "1660000000000"), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(pVal->datum.i, 1660000000000LL);
+  ASSERT_EQ(planCacheSetValue(pVal, "1970-01-01 00:00:01.000Z"), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(pVal->datum.i, 1000);
+  EXPECT_NE(planCacheSetValue(pVal, "yesterday"), TSDB_CODE_SUCCESS);
+  nodesDestroyNode((SNode *)pVal);
+
+  // the buffer of a string value fits the literal it was translated with, not a longer one
+  pVal = makeValue(TSDB_DATA_TYPE_VARCHAR, "abc", 0);
+  pVal->node.resType.bytes = VARSTR_HEADER_SIZE + 3;
+  pVal->datum.p = (char *)taosMemoryCalloc(1, VARSTR_HEADER_SIZE + 3 + 1);
+  ASSERT_EQ(planCacheSetValue(pVal, "xy"), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(varDataLen(pVal->datum.p), 2);
+  EXPECT_EQ(memcmp(varDataVal(pVal->datum.p), "xy", 2), 0);
+  EXPECT_STREQ(pVal->literal, "xy");
+  EXPECT_NE(planCacheSetValue(pVal, "abcd"), TSDB_CODE_SUCCESS);
+  EXPECT_STREQ(pVal->literal, "xy");
+  nodesDestroyNode((SNode *)pVal);
+}
+
+TEST(planCacheTest, bindTsBound) {
+  SPlanCacheConst   pOld[2] = {tsConst("1000", 1000), tsConst("5", 5)};
+  SPlanCacheConst   pNew[2] = {tsConst("2000", 2000), tsConst("7", 7)};
+  SPlanCacheBindCxt cxt = {0};
+  cxt.precision = TSDB_TIME_PRECISION_MILLI;
+  cxt.numOfConsts = 1;
+  cxt.pOld = pOld;
+  cxt.pNew = pNew;
+
+  // ts > 1000 is scanned from 1001, ts >= 1000 from 1000, ts < 1000 up to 999
+  int64_t bound = 1001;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, 2001);
+  bound = 1000;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, 2000);
+  bound = 999;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, 1999);
+  EXPECT_EQ(pNew[0].numOfBounds, 3);
+
+  // open ranges and bounds no constant is near stay
+  bound = INT64_MIN;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, INT64_MIN);
+  bound = 1002;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, 1002);
+  EXPECT_EQ(pNew[0].numOfBounds, 3);
+
+  // a bound two constants are near is ambiguous
+  pOld[1] = tsConst("1001", 1001);
+  cxt.numOfConsts = 2;
+  bound = 1001;
+  EXPECT_NE(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  cxt.numOfConsts = 1;
+
+  // the new constant must be a timestamp, and stay one after the shift
+  pNew[0].isTs = false;
+  bound = 1000;
+  EXPECT_NE(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  pNew[0] = tsConst("9223372036854775807", INT64_MAX);
+  bound = 1001;
+  EXPECT_NE(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  bound = 1000;
+  ASSERT_EQ(planCacheBindTsBound(&cxt, &bound), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(bound, INT64_MAX);
+}
+
+TEST(planCacheTest, rebind) {
+  // where ts > 1000 and ts <= 3000 and c1 = 5
+  SArray          *pConsts = makeConsts({{TK_NK_INTEGER, "1000"}, {TK_NK_INTEGER, "3000"}, {TK_NK_INTEGER, "5"}});
+  SQueryPlan      *pDag = makePlan(1001, 3000, "5", 5);
+  SPlanCacheEntry *pEntry = makeEntry(pDag, pConsts);
+
+  // the plan rebuilt with its own constants is bound exactly like it
+  SPlanCacheConst *pCheck = NULL;
+  SQueryPlan      *pOwn = rebuild(pEntry, pConsts, &pCheck);
+  ASSERT_NE(pOwn, nullptr);
+  EXPECT_EQ(planCacheCheckBinding(pEntry, pCheck, pDag), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(pCheck[0].numOfBounds, 1);
+  EXPECT_EQ(pCheck[1].numOfBounds, 1);
+  EXPECT_EQ(pCheck[2].numOfValues, 1);
+  taosMemoryFree(pCheck);
+  qDestroyQueryPlan(pOwn);
+
+  // where ts > 2000 and ts <= 2500 and c1 = 7, from the entry decoded once already
+  SArray     *pOther = makeConsts({{TK_NK_INTEGER, "2000"}, {TK_NK_INTEGER, "2500"}, {TK_NK_INTEGER, "7"}});
+  SQueryPlan *pNew = rebuild(pEntry, pOther);
+  ASSERT_NE(pNew, nullptr);
+  EXPECT_EQ(getScan(pNew)->scanRange.skey, 2001);
+  EXPECT_EQ(getScan(pNew)->scanRange.ekey, 2500);
+  EXPECT_EQ(getCondValue(pNew)->datum.i, 7);
+  EXPECT_STREQ(getCondValue(pNew)->literal, "7");
+  EXPECT_EQ(pNew->queryId, 1);
+  qDestroyQueryPlan(pNew);
+  qDestroyQueryConstants(pOther);
+
+  // a string timestamp rebinds the bound as well
+  pOther = makeConsts({{TK_NK_STRING, "1970-01-01 00:00:10.000Z"}, {TK_NK_INTEGER, "20000"}, {TK_NK_INTEGER, "5"}});
+  pNew = rebuild(pEntry, pOther);
+  ASSERT_NE(pNew, nullptr);
+  EXPECT_EQ(getScan(pNew)->scanRange.skey, 10001);
+  EXPECT_EQ(getScan(pNew)->scanRange.ekey, 20000);
+  qDestroyQueryPlan(pNew);
+  qDestroyQueryConstants(pOther);
+
+  // a value the cached value node cannot take is not bound
+  pOther = makeConsts({{TK_NK_INTEGER, "2000"}, {TK_NK_INTEGER, "2500"}, {TK_NK_INTEGER, "7.5"}});
+  EXPECT_EQ(rebuild(pEntry, pOther), nullptr);
+  qDestroyQueryConstants(pOther);
+
+  planCacheDestroyEntry(pEntry);
+  qDestroyQueryPlan(pDag);
+  qDestroyQueryConstants(pConsts);
+}
+
+TEST(planCacheTest, rebindGreaterEqual) {
+  // where ts >= 1000 and ts < 3000: the bounds are the constant itself and one below it
+  SArray          *pConsts = makeConsts({{TK_NK_INTEGER, "1000"}, {TK_NK_INTEGER, "3000"}, {TK_NK_INTEGER, "5"}});
+  SQueryPlan      *pDag = makePlan(1000, 2999, "5", 5);
+  SPlanCacheEntry *pEntry = makeEntry(pDag, pConsts);
+
+  SArray     *pOther = makeConsts({{TK_NK_INTEGER, "2000"}, {TK_NK_INTEGER, "2500"}, {TK_NK_INTEGER, "5"}});
+  SQueryPlan *pNew = rebuild(pEntry, pOther);
+  ASSERT_NE(pNew, nullptr);
+  EXPECT_EQ(getScan(pNew)->scanRange.skey, 2000);
+  EXPECT_EQ(getScan(pNew)->scanRange.ekey, 2499);
+  qDestroyQueryPlan(pNew);
+  qDestroyQueryConstants(pOther);
+
+  planCacheDestroyEntry(pEntry);
+  qDestroyQueryPlan(pDag);
+  qDestroyQueryConstants(pConsts);
+}
+
+TEST(planCacheTest, checkBinding) {
+  // 1000 is folded into the scan range, 5 is not in the plan at all
+  SArray          *pConsts = makeConsts({{TK_NK_INTEGER, "1000"}, {TK_NK_INTEGER, "5"}});
+  SQueryPlan      *pDag = makePlan(1001, INT64_MAX, "6", 6);
+  SPlanCacheEntry *pEntry = makeEntry(pDag, pConsts);
+  SPlanCacheConst *pCheck = NULL;
+  SQueryPlan      *pOwn = rebuild(pEntry, pConsts, &pCheck);
+  ASSERT_NE(pOwn, nullptr);
+  EXPECT_NE(planCacheCheckBinding(pEntry, pCheck, pDag), TSDB_CODE_SUCCESS);
+  taosMemoryFree(pCheck);
+  qDestroyQueryPlan(pOwn);
+  planCacheDestroyEntry(pEntry);
+  qDestroyQueryConstants(pConsts);
+
+  // the same literal twice cannot tell which value node is which constant
+  pConsts = makeConsts({{TK_NK_INTEGER, "6"}, {TK_NK_INTEGER, "6"}});
+  pEntry = makeEntry(pDag, pConsts);
+  pOwn = rebuild(pEntry, pConsts, &pCheck);
+  ASSERT_NE(pOwn, nullptr);
+  EXPECT_NE(planCacheCheckBinding(pEntry, pCheck, pDag), TSDB_CODE_SUCCESS);
+  taosMemoryFree(pCheck);
+  qDestroyQueryPlan(pOwn);
+  planCacheDestroyEntry(pEntry);
+  qDestroyQueryConstants(pConsts);
+
+  qDestroyQueryPlan(pDag);
+}
+
+TEST(planCacheTest, lookup) {
+  SAppInstInfo appInfo = {0};
+  appInfo.clusterId = 0x1234;
+  appInfo.pPlanCache = planCacheOpen(1 << 20);
+  ASSERT_NE(appInfo.pPlanCache, nullptr);
+  STscObj tscObj;
+  memset(&tscObj, 0, sizeof(tscObj));
+  tscObj.pAppInfo = &appInfo;
+  strcpy(tscObj.user, TSDB_DEFAULT_USER);
+
+  auto lookup = [&](const char *sql, SQueryPlan **ppDag) {
+    SRequestObj request;
+    memset(&request, 0, sizeof(request));
+    request.pTscObj = &tscObj;
+    request.sqlstr = (char *)sql;
+    request.sqlLen = strlen(sql);
+    SSqlCallbackWrapper wrapper = {0};
+    SArray             *pNodeList = NULL;
+    EXPECT_EQ(planCacheLookup(&request, &wrapper, false, ppDag, &pNodeList), TSDB_CODE_SUCCESS);
+    taosArrayDestroy(pNodeList);
+    taosArrayDestroy(request.dbList);
+    taosArrayDestroy(request.tableList);
+    taosMemoryFree(request.body.resInfo.fields);
+    taosMemoryFree(request.body.resInfo.userFields);
+    taosMemoryFree(wrapper.pPlanCacheKey);
+    qDestroyQueryConstants(wrapper.pPlanCacheConsts);
+  };
+
+  const char *sql = "select c1 from t where ts > 1000 and c1 = 5";
+  SRequestObj request;
+  memset(&request, 0, sizeof(request));
+  request.sqlstr = (char *)sql;
+  request.sqlLen = strlen(sql);
+  SSqlCallbackWrapper wrapper = {0};
+  ASSERT_EQ(planCacheInitKey(&request, &wrapper), TSDB_CODE_SUCCESS);
+  ASSERT_NE(wrapper.pPlanCacheKey, nullptr);
+  ASSERT_EQ(taosArrayGetSize(wrapper.pPlanCacheConsts), 2);
+
+  SQueryPlan      *pDag = makePlan(1001, INT64_MAX, "5", 5);
+  SPlanCacheEntry *pEntry = makeEntry(pDag, wrapper.pPlanCacheConsts);
+  const char      *key = wrapper.pPlanCacheKey;
+  ASSERT_EQ(taosLRUCacheInsert(appInfo.pPlanCache, key, strlen(key), pEntry, planCacheEntrySize(pEntry),
+                               planCacheDeleteEntry, NULL, TAOS_LRU_PRIORITY_LOW),
+            TAOS_LRU_STATUS_OK);
+
+  SQueryPlan *pNew = NULL;
+  lookup("select c1 from t where ts > 2000 and c1 = 7", &pNew);
+  ASSERT_NE(pNew, nullptr);
+  EXPECT_EQ(getScan(pNew)->scanRange.skey, 2001);
+  EXPECT_EQ(getCondValue(pNew)->datum.i, 7);
+  qDestroyQueryPlan(pNew);
+
+  // an entry bound to another number of constants than the sql has is planned again, not read past its end
+  pEntry = makeEntry(pDag, wrapper.pPlanCacheConsts);
+  ++pEntry->numOfConsts;
+  pEntry->pConsts = (SPlanCacheConst *)taosMemoryRealloc(pEntry->pConsts, 3 * sizeof(SPlanCacheConst));
+  pEntry->pConsts[2] = tsConst(NULL, 0);
+  pEntry->pConsts[2].literal = (char *)taosMemoryStrDup("9");
+  ASSERT_EQ(taosLRUCacheInsert(appInfo.pPlanCache, key, strlen(key), pEntry, planCacheEntrySize(pEntry),
+                               planCacheDeleteEntry, NULL, TAOS_LRU_PRIORITY_LOW),
+            TAOS_LRU_STATUS_OK_OVERWRITTEN);
+  pNew = (SQueryPlan *)0x1;
+  lookup("select c1 from t where ts > 2000 and c1 = 7", &pNew);
+  EXPECT_EQ(pNew, nullptr);
+
+  qDestroyQueryPlan(pDag);
+  taosMemoryFree(wrapper.pPlanCacheKey);
+  qDestroyQueryConstants(wrapper.pPlanCacheConsts);
+  planCacheClose(appInfo.pPlanCache);
+}
+
+#pragma GCC diagnostic pop
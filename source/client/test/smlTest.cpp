@@ -18,6 +18,7 @@
 #include <taoserror.h>
 #include <tglobal.h>
 #include <iostream>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -573,7 +574,6 @@ TEST(testCase, smlParseTelnetLine_json_error_Test) {
   ASSERT_NE(info, nullptr);
 
   const char *sql[] = {
-      "[\n"
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 13468464009999333322222223,\n"
@@ -582,9 +582,7 @@ TEST(testCase, smlParseTelnetLine_json_error_Test) {
       "           \"host\": \"web01\",\n"
       "           \"dc\": \"lga\"\n"
       "        }\n"
-      "    },\n"
-      "]",
-      "[\n"
+      "    }",
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400i,\n"
@@ -593,9 +591,7 @@ TEST(testCase, smlParseTelnetLine_json_error_Test) {
       "           \"host\": \"web01\",\n"
       "           \"dc\": \"lga\"\n"
       "        }\n"
-      "    },\n"
-      "]",
-      "[\n"
+      "    }",
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400,\n"
@@ -611,8 +607,7 @@ TEST(testCase, smlParseTelnetLine_json_error_Test) {
       "             },\n"
       "           \"id\": \"d1001\"\n"
       "         }\n"
-      "    },\n"
-      "]",
+      "    }",
   };
 
   int ret = TSDB_CODE_SUCCESS;
@@ -629,7 +624,6 @@ TEST(testCase, smlParseTelnetLine_diff_json_type1_Test) {
   ASSERT_NE(info, nullptr);
 
   const char *sql[] = {
-      "[\n"
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400,\n"
@@ -637,9 +631,7 @@ TEST(testCase, smlParseTelnetLine_diff_json_type1_Test) {
       "        \"tags\": {\n"
       "           \"host\": \"lga\"\n"
       "        }\n"
-      "    },\n"
-      "]",
-      "[\n"
+      "    }",
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400,\n"
@@ -647,8 +639,7 @@ TEST(testCase, smlParseTelnetLine_diff_json_type1_Test) {
       "        \"tags\": {\n"
       "           \"host\": 8\n"
       "        }\n"
-      "    },\n"
-      "]",
+      "    }",
   };
 
   int ret = TSDB_CODE_SUCCESS;
@@ -665,7 +656,6 @@ TEST(testCase, smlParseTelnetLine_diff_json_type2_Test) {
   ASSERT_NE(info, nullptr);
 
   const char *sql[] = {
-      "[\n"
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400,\n"
@@ -673,9 +663,7 @@ TEST(testCase, smlParseTelnetLine_diff_json_type2_Test) {
       "        \"tags\": {\n"
       "           \"host\": \"lga\"\n"
       "        }\n"
-      "    },\n"
-      "]",
-      "[\n"
+      "    }",
       "    {\n"
       "        \"metric\": \"sys.cpu.nice\",\n"
       "        \"timestamp\": 1346846400,\n"
@@ -683,8 +671,7 @@ TEST(testCase, smlParseTelnetLine_diff_json_type2_Test) {
       "        \"tags\": {\n"
       "           \"host\": \"fff\"\n"
       "        }\n"
-      "    },\n"
-      "]",
+      "    }",
   };
   int ret = TSDB_CODE_SUCCESS;
   for (int i = 0; i < sizeof(sql) / sizeof(sql[0]); i++) {
@@ -1008,3 +995,155 @@ TEST(testCase, sml_col_4096_Test) {
   ASSERT_NE(ret, 0);
   smlDestroyInfo(info);
 }
+
+TEST(testCase, smlParseJSON_Test) {
+  SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_JSON_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+  ASSERT_NE(info, nullptr);
+
+  // fields may come in any order, strings may have escape sequence
+  char payload[] =
+      "[\n"
+      "    {\n"
+      "        \"metric\": \"sys.cpu.nice\",\n"
+      "        \"timestamp\": 1346846400,\n"
+      "        \"value\": 18,\n"
+      "        \"tags\": {\n"
+      "           \"host\": \"web01\",\n"
+      "           \"dc\": \"lga\"\n"
+      "        }\n"
+      "    },\n"
+      "    {\n"
+      "        \"tags\": {\n"
+      "           \"host\": \"web\\\"02\\u00e9\",\n"
+      "           \"dc\": \"lga\"\n"
+      "        },\n"
+      "        \"Value\": {\"type\": \"f64\", \"value\": -9.5},\n"
+      "        \"timestamp\": {\"type\": \"ms\", \"value\": 1346846400000},\n"
+      "        \"metric\": \"sys.cpu.nice\"\n"
+      "    }\n"
+      "]";
+  int ret = smlParseJSON(info, payload);
+  ASSERT_EQ(ret, 0);
+  ASSERT_EQ(taosHashGetSize(info->childTables), 2);
+  ASSERT_EQ(taosHashGetSize(info->superTables), 1);
+
+  bool   found = false;
+  void **p = (void **)taosHashIterate(info->childTables, NULL);
+  while (p) {
+    SSmlTableInfo *tinfo = (SSmlTableInfo *)(*p);
+    ASSERT_EQ(tinfo->sTableNameLen, strlen("sys.cpu.nice"));
+    ASSERT_EQ(strncmp(tinfo->sTableName, "sys.cpu.nice", tinfo->sTableNameLen), 0);
+    ASSERT_EQ(taosArrayGetSize(tinfo->tags), 2);
+    SSmlKv *host = (SSmlKv *)taosArrayGetP(tinfo->tags, 0);
+    if (host->keyLen != 4) host = (SSmlKv *)taosArrayGetP(tinfo->tags, 1);
+    ASSERT_EQ(host->keyLen, 4);
+    ASSERT_EQ(strncmp(host->key, "host", 4), 0);
+    if (host->length == strlen("web\"02\xc3\xa9") && strncmp(host->value, "web\"02\xc3\xa9", host->length) == 0) {
+      SArray *cols = (SArray *)taosArrayGetP(tinfo->cols, 0);
+      ASSERT_EQ(taosArrayGetSize(cols), 2);
+      SSmlKv *ts = (SSmlKv *)taosArrayGetP(cols, 0);
+      ASSERT_EQ(ts->i, 1346846400000000000);
+      SSmlKv *value = (SSmlKv *)taosArrayGetP(cols, 1);
+      ASSERT_EQ(value->type, TSDB_DATA_TYPE_DOUBLE);
+      ASSERT_EQ(value->d, -9.5);
+      found = true;
+    }
+    p = (void **)taosHashIterate(info->childTables, p);
+  }
+  ASSERT_TRUE(found);
+  smlDestroyInfo(info);
+}
+
+TEST(testCase, smlParseJSON_error_Test) {
+  const char *sql[] = {
+      // trailing comma in array
+      "[{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": 18, \"tags\": {\"t\": \"a\"}},]",
+      // missing field
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"tags\": {\"t\": \"a\"}}",
+      // duplicate field
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": 18, \"value\": 18, \"tags\": {\"t\": \"a\"}}",
+      // unknown field
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": 18, \"tags\": {\"t\": \"a\"}, \"x\": 1}",
+      // unterminated string
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": 18, \"tags\": {\"t\": \"a}}",
+      // invalid escape
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": 18, \"tags\": {\"t\": \"\\ud800\"}}",
+      // value object without type
+      "{\"metric\": \"m\", \"timestamp\": 1346846400, \"value\": {\"value\": 1}, \"tags\": {\"t\": \"a\"}}",
+      // not an object
+      "\"metric\"",
+  };
+
+  for (int i = 0; i < sizeof(sql) / sizeof(sql[0]); i++) {
+    SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_JSON_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+    ASSERT_NE(info, nullptr);
+    char *payload = strdup(sql[i]);
+    int   ret = smlParseJSON(info, payload);
+    ASSERT_NE(ret, 0) << sql[i];
+    taosMemoryFree(payload);
+    smlDestroyInfo(info);
+  }
+}
+
+// parse throughput of the three protocols, the data is generated, only the parse phase is timed
+TEST(testCase, smlParse_perf_Test) {
+  const int32_t numOfLines = 20000;
+  const int32_t numOfTables = 1000;
+
+  std::vector<std::string> influx;
+  std::vector<std::string> telnet;
+  std::string              json = "[";
+  char                     buf[512] = {0};
+  for (int32_t i = 0; i < numOfLines; ++i) {
+    int64_t ts = 1626006833639000000 + i;
+    snprintf(buf, sizeof(buf),
+             "st_perf,t1=%d,t2=location_%d,t3=nchar_tag_value c1=%di32,c2=%d.5f64,c3=\"binary_col_value_%d\","
+             "c4=true %" PRId64,
+             i % numOfTables, i % numOfTables, i, i, i, ts);
+    influx.push_back(buf);
+    snprintf(buf, sizeof(buf), "st_perf %" PRId64 " %d.5 t1=%d t2=location_%d t3=L\"nchar_tag_value\"",
+             ts / 1000000, i, i % numOfTables, i % numOfTables);
+    telnet.push_back(buf);
+    snprintf(buf, sizeof(buf),
+             "%s{\"metric\": \"st_perf\", \"timestamp\": %" PRId64
+             ", \"value\": %d.5, \"tags\": {\"t1\": %d, \"t2\": \"location_%d\", \"t3\": {\"value\": \"nchar\", "
+             "\"type\": \"binary\"}}}",
+             i == 0 ? "" : ",", ts / 1000000, i, i % numOfTables, i % numOfTables);
+    json += buf;
+  }
+  json += "]";
+
+  struct {
+    SMLProtocolType protocol;
+    int64_t         bytes;
+    int64_t         us;
+  } result[3] = {{TSDB_SML_LINE_PROTOCOL, 0, 0}, {TSDB_SML_TELNET_PROTOCOL, 0, 0}, {TSDB_SML_JSON_PROTOCOL, 0, 0}};
+
+  for (int32_t i = 0; i < 3; ++i) {
+    SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, result[i].protocol, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+    ASSERT_NE(info, nullptr);
+    int64_t start = taosGetTimestampUs();
+    int32_t ret = TSDB_CODE_SUCCESS;
+    if (result[i].protocol == TSDB_SML_LINE_PROTOCOL) {
+      for (int32_t j = 0; j < numOfLines && ret == TSDB_CODE_SUCCESS; ++j) {
+        ret = smlParseInfluxLine(info, influx[j].c_str(), influx[j].size());
+        result[i].bytes += influx[j].size();
+      }
+    } else if (result[i].protocol == TSDB_SML_TELNET_PROTOCOL) {
+      for (int32_t j = 0; j < numOfLines && ret == TSDB_CODE_SUCCESS; ++j) {
+        ret = smlParseTelnetLine(info, (void *)telnet[j].c_str(), telnet[j].size());
+        result[i].bytes += telnet[j].size();
+      }
+    } else {
+      ret = smlParseJSON(info, (char *)json.c_str());
+      result[i].bytes = json.size();
+    }
+    result[i].us = taosGetTimestampUs() - start + 1;
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(taosHashGetSize(info->childTables), numOfTables);
+    smlDestroyInfo(info);
+
+    printf("protocol:%d, lines:%d, %.0f lines/s, %.2f MB/s\n", result[i].protocol, numOfLines,
+           numOfLines * 1000000.0 / result[i].us, result[i].bytes / (double)result[i].us);
+  }
+}
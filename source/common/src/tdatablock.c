@@ -2185,10 +2185,393 @@ char* buildCtbNameByGroupId(const char* stbFullName, uint64_t groupId) {
   return rname.ctbShortName;
 }
 
+// Each column of a columnar (version 2) block starts with one of these, colSizes holds the length of the whole
+// column. All encodings but RAW, which keeps the version 1 layout, send the nulls as a bitmap.
+enum {
+  BLOCK_COL_RAW = 0,
+  BLOCK_COL_CMPR,  // fixed length values through the type compressor, delta of delta for timestamps
+  BLOCK_COL_DICT,  // distinct var values, followed by the dictionary code of each non-null value
+  BLOCK_COL_LZ4,   // non-null var values back to back, lz4 compressed
+};
+
+// float and double compression may be lossy, they are sent as is
+static bool blockColCanCompress(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int32_t blockColRawSize(const SColumnInfoData* pColInfoData, int32_t numOfRows) {
+  int32_t metaSize = IS_VAR_DATA_TYPE(pColInfoData->info.type) ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+  return metaSize + colDataGetLength(pColInfoData, numOfRows);
+}
+
+static int32_t blockEncodeVarNull(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data,
+                                  int32_t* nonNullLen) {
+  memset(data, 0, BitmapLen(numOfRows));
+  *nonNullLen = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_var(pColInfoData, i)) {
+      colDataSetNull_f(data, i);
+    } else {
+      *nonNullLen += varDataTLen(pColInfoData->pData + pColInfoData->varmeta.offset[i]);
+    }
+  }
+  return BitmapLen(numOfRows);
+}
+
+// | null bitmap | nDict | dictLen | dict values | code width | codes of the non-null rows |
+static int32_t blockEncodeDictCol(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data, int32_t cap) {
+  int32_t nonNullLen = 0;
+  char*   p = data + blockEncodeVarNull(pColInfoData, numOfRows, data, &nonNullLen);
+  int32_t* nDict = (int32_t*)p;
+  int32_t* dictLen = (int32_t*)(p + sizeof(int32_t));
+  char*    pDict = p + sizeof(int32_t) * 2;
+  if (pDict + nonNullLen - data > cap) {
+    return -1;
+  }
+
+  int32_t*  codes = taosMemoryMalloc(sizeof(int32_t) * numOfRows);
+  SHashObj* pHash = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (codes == NULL || pHash == NULL) {
+    taosMemoryFree(codes);
+    taosHashCleanup(pHash);
+    return -1;
+  }
+
+  int32_t nNonNull = 0;
+  *nDict = 0;
+  *dictLen = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_var(pColInfoData, i)) continue;
+
+    char*    pVal = pColInfoData->pData + pColInfoData->varmeta.offset[i];
+    int32_t  len = varDataTLen(pVal);
+    int32_t* pCode = taosHashGet(pHash, pVal, len);
+    if (pCode == NULL) {
+      taosHashPut(pHash, pVal, len, nDict, sizeof(int32_t));
+      memcpy(pDict + *dictLen, pVal, len);
+      *dictLen += len;
+      codes[nNonNull++] = (*nDict)++;
+    } else {
+      codes[nNonNull++] = *pCode;
+    }
+  }
+  taosHashCleanup(pHash);
+
+  // not repetitive enough to pay for the codes
+  int8_t width = (*nDict <= UINT8_MAX) ? sizeof(uint8_t) : ((*nDict <= UINT16_MAX) ? sizeof(uint16_t) : sizeof(int32_t));
+  p = pDict + *dictLen;
+  if (*nDict * 2 > nNonNull || p + sizeof(int8_t) + nNonNull * width - data > cap) {
+    taosMemoryFree(codes);
+    return -1;
+  }
+
+  *(int8_t*)p = width;
+  p += sizeof(int8_t);
+  for (int32_t i = 0; i < nNonNull; ++i) {
+    if (width == sizeof(uint8_t)) {
+      ((uint8_t*)p)[i] = codes[i];
+    } else if (width == sizeof(uint16_t)) {
+      ((uint16_t*)p)[i] = codes[i];
+    } else {
+      ((int32_t*)p)[i] = codes[i];
+    }
+  }
+  p += nNonNull * width;
+
+  taosMemoryFree(codes);
+  return p - data;
+}
+
+// | null bitmap | length of the non-null values | compressed values |
+static int32_t blockEncodeLz4Col(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data, int32_t cap) {
+  int32_t nonNullLen = 0;
+  char*   p = data + blockEncodeVarNull(pColInfoData, numOfRows, data, &nonNullLen);
+  *(int32_t*)p = nonNullLen;
+  p += sizeof(int32_t);
+
+  // the compressor falls back to a plain copy plus one byte
+  if (nonNullLen == 0 || p + nonNullLen + COMP_OVERFLOW_BYTES - data > cap) {
+    return -1;
+  }
+
+  char* pVals = taosMemoryMalloc(nonNullLen);
+  if (pVals == NULL) {
+    return -1;
+  }
+
+  int32_t len = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_var(pColInfoData, i)) continue;
+
+    char* pVal = pColInfoData->pData + pColInfoData->varmeta.offset[i];
+    memcpy(pVals + len, pVal, varDataTLen(pVal));
+    len += varDataTLen(pVal);
+  }
+
+  p += tsCompressString(pVals, nonNullLen, numOfRows, p, cap - (p - data), ONE_STAGE_COMP, NULL, 0);
+  taosMemoryFree(pVals);
+  return p - data;
+}
+
+// | null bitmap | compressed values |
+static int32_t blockEncodeCmprCol(SColumnInfoData* pColInfoData, int32_t numOfRows, char* data, int32_t cap) {
+  int32_t metaSize = BitmapLen(numOfRows);
+  if (metaSize + colDataGetLength(pColInfoData, numOfRows) + COMP_OVERFLOW_BYTES > cap) {
+    return -1;
+  }
+
+  memcpy(data, pColInfoData->nullbitmap, metaSize);
+  int32_t len = blockCompressColData(pColInfoData, numOfRows, data + metaSize, ONE_STAGE_COMP);
+  return (len <= 0) ? -1 : metaSize + len;
+}
+
+// Encode into pBuf with the encoding that suits the type, keep the version 1 layout if it is not smaller.
+static int32_t blockEncodeCol(SColumnInfoData* pColInfoData, int32_t numOfRows, char* data, char* pBuf, int32_t nBuf) {
+  int8_t  type = pColInfoData->info.type;
+  int8_t  encode = BLOCK_COL_RAW;
+  int32_t len = -1;
+
+  if (nBuf <= 0) {
+    // no scratch buffer, send it as is
+  } else if (IS_VAR_DATA_TYPE(type)) {
+    len = blockEncodeDictCol(pColInfoData, numOfRows, pBuf, nBuf);
+    encode = BLOCK_COL_DICT;
+    if (len < 0) {
+      len = blockEncodeLz4Col(pColInfoData, numOfRows, pBuf, nBuf);
+      encode = BLOCK_COL_LZ4;
+    }
+  } else if (blockColCanCompress(type)) {
+    len = blockEncodeCmprCol(pColInfoData, numOfRows, pBuf, nBuf);
+    encode = BLOCK_COL_CMPR;
+  }
+
+  int32_t rawSize = blockColRawSize(pColInfoData, numOfRows);
+  if (len < 0 || len >= rawSize) {
+    *(int8_t*)data = BLOCK_COL_RAW;
+    data += sizeof(int8_t);
+
+    int32_t metaSize = rawSize - colDataGetLength(pColInfoData, numOfRows);
+    memcpy(data, IS_VAR_DATA_TYPE(type) ? (char*)pColInfoData->varmeta.offset : pColInfoData->nullbitmap, metaSize);
+    if (rawSize > metaSize) {
+      memcpy(data + metaSize, pColInfoData->pData, rawSize - metaSize);
+    }
+    return sizeof(int8_t) + rawSize;
+  }
+
+  *(int8_t*)data = encode;
+  memcpy(data + sizeof(int8_t), pBuf, len);
+  return sizeof(int8_t) + len;
+}
+
+static FORCE_INLINE int32_t blockDictCode(const char* pCodes, int8_t width, int32_t i) {
+  if (width == sizeof(uint8_t)) return ((uint8_t*)pCodes)[i];
+  if (width == sizeof(uint16_t)) return ((uint16_t*)pCodes)[i];
+  return ((int32_t*)pCodes)[i];
+}
+
+static int32_t blockColReserve(SColumnInfoData* pColInfoData, int32_t len) {
+  if (len > pColInfoData->varmeta.allocLen) {
+    char* tmp = taosMemoryRealloc(pColInfoData->pData, len);
+    if (tmp == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    pColInfoData->pData = tmp;
+    pColInfoData->varmeta.allocLen = len;
+  }
+
+  pColInfoData->varmeta.length = len;
+  return 0;
+}
+
+// every length read from the block is checked against its end before it is used
+#define BLOCK_COL_CHECK(cond)             \
+  do {                                    \
+    if (!(cond)) {                        \
+      terrno = TSDB_CODE_INVALID_MSG;     \
+      return -1;                          \
+    }                                     \
+  } while (0)
+
+// check that the var values back to back in [pVals, pVals + len) are whole
+static int32_t blockCheckVarVals(const char* pVals, int32_t len, int32_t num, int32_t* offsets) {
+  int32_t offset = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    BLOCK_COL_CHECK(offset <= len - VARSTR_HEADER_SIZE);
+    BLOCK_COL_CHECK(varDataTLen(pVals + offset) <= len - offset);
+    if (offsets != NULL) offsets[i] = offset;
+    offset += varDataTLen(pVals + offset);
+  }
+  return 0;
+}
+
+int32_t blockDecodeCol(SColumnInfoData* pColInfoData, const char* pData, int32_t len, int32_t numOfRows) {
+  BLOCK_COL_CHECK(len >= (int32_t)sizeof(int8_t));
+
+  const char* p = pData + sizeof(int8_t);
+  const char* pEnd = pData + len;
+  int8_t      encode = *(int8_t*)pData;
+  bool        isVar = IS_VAR_DATA_TYPE(pColInfoData->info.type);
+
+  if (encode == BLOCK_COL_RAW) {
+    if (isVar) {
+      BLOCK_COL_CHECK(pEnd - p >= (int64_t)sizeof(int32_t) * numOfRows);
+      memcpy(pColInfoData->varmeta.offset, p, sizeof(int32_t) * numOfRows);
+      p += sizeof(int32_t) * numOfRows;
+      if (blockColReserve(pColInfoData, pEnd - p) < 0) {
+        return -1;
+      }
+    } else {
+      BLOCK_COL_CHECK(pEnd - p >= BitmapLen(numOfRows) && pEnd - p - BitmapLen(numOfRows) <= (int64_t)numOfRows * pColInfoData->info.bytes);
+      memcpy(pColInfoData->nullbitmap, p, BitmapLen(numOfRows));
+      p += BitmapLen(numOfRows);
+    }
+
+    if (pEnd > p) {
+      memcpy(pColInfoData->pData, p, pEnd - p);
+    }
+    return 0;
+  }
+
+  BLOCK_COL_CHECK(pEnd - p >= BitmapLen(numOfRows));
+  const char* nullbitmap = p;
+  p += BitmapLen(numOfRows);
+
+  if (encode == BLOCK_COL_CMPR) {
+    memcpy(pColInfoData->nullbitmap, nullbitmap, BitmapLen(numOfRows));
+    int32_t size = numOfRows * pColInfoData->info.bytes;
+    if ((*(tDataTypes[pColInfoData->info.type].decompFunc))((void*)p, pEnd - p, numOfRows, pColInfoData->pData, size,
+                                                            ONE_STAGE_COMP, NULL, 0) < 0) {
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+    return 0;
+  }
+
+  if (encode == BLOCK_COL_LZ4) {
+    BLOCK_COL_CHECK(pEnd - p >= (int64_t)sizeof(int32_t));
+    int32_t nonNullLen = *(int32_t*)p;
+    p += sizeof(int32_t);
+    // lz4 does not expand more than 255 times
+    BLOCK_COL_CHECK(nonNullLen > 0 && nonNullLen <= (pEnd - p) * 255 + COMP_OVERFLOW_BYTES);
+    if (blockColReserve(pColInfoData, nonNullLen) < 0) {
+      return -1;
+    }
+    if (tsDecompressString((void*)p, pEnd - p, numOfRows, pColInfoData->pData, nonNullLen, ONE_STAGE_COMP, NULL, 0) !=
+        nonNullLen) {
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+
+    int32_t offset = 0;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (colDataIsNull_f(nullbitmap, i)) {
+        colDataSetNull_var(pColInfoData, i);
+      } else {
+        if (blockCheckVarVals(pColInfoData->pData + offset, nonNullLen - offset, 1, NULL) < 0) {
+          return -1;
+        }
+        pColInfoData->varmeta.offset[i] = offset;
+        offset += varDataTLen(pColInfoData->pData + offset);
+      }
+    }
+    return 0;
+  }
+
+  if (encode != BLOCK_COL_DICT) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  BLOCK_COL_CHECK(pEnd - p >= (int64_t)sizeof(int32_t) * 2);
+  int32_t     nDict = *(int32_t*)p;
+  int32_t     dictLen = *(int32_t*)(p + sizeof(int32_t));
+  const char* pDict = p + sizeof(int32_t) * 2;
+  BLOCK_COL_CHECK(dictLen >= 0 && pEnd - pDict > dictLen);
+  BLOCK_COL_CHECK(nDict >= 0 && nDict <= dictLen / VARSTR_HEADER_SIZE);
+  p = pDict + dictLen;
+  int8_t width = *(int8_t*)p;
+  p += sizeof(int8_t);
+  BLOCK_COL_CHECK(width == sizeof(uint8_t) || width == sizeof(uint16_t) || width == sizeof(int32_t));
+
+  int32_t nNonNull = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (!colDataIsNull_f(nullbitmap, i)) nNonNull++;
+  }
+  BLOCK_COL_CHECK(pEnd - p >= (int64_t)nNonNull * width);
+
+  int32_t* dictOffset = taosMemoryMalloc(sizeof(int32_t) * (nDict + 1));
+  if (dictOffset == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  if (blockCheckVarVals(pDict, dictLen, nDict, dictOffset) < 0) {
+    taosMemoryFree(dictOffset);
+    return -1;
+  }
+
+  // values are expanded so that the column keeps one copy per row like any other block
+  int64_t total = 0;
+  nNonNull = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_f(nullbitmap, i)) continue;
+
+    int32_t code = blockDictCode(p, width, nNonNull++);
+    if (code < 0 || code >= nDict) {
+      taosMemoryFree(dictOffset);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+    total += varDataTLen(pDict + dictOffset[code]);
+  }
+
+  if (total > INT32_MAX) {
+    taosMemoryFree(dictOffset);
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+  if (blockColReserve(pColInfoData, total) < 0) {
+    taosMemoryFree(dictOffset);
+    return -1;
+  }
+
+  int32_t offset = 0;
+  nNonNull = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (colDataIsNull_f(nullbitmap, i)) {
+      colDataSetNull_var(pColInfoData, i);
+      continue;
+    }
+
+    const char* pVal = pDict + dictOffset[blockDictCode(p, width, nNonNull++)];
+    memcpy(pColInfoData->pData + offset, pVal, varDataTLen(pVal));
+    pColInfoData->varmeta.offset[i] = offset;
+    offset += varDataTLen(pVal);
+  }
+
+  taosMemoryFree(dictOffset);
+  return 0;
+}
+
 void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_t numOfCols, int8_t needCompress) {
   // todo extract method
   int32_t* version = (int32_t*)data;
-  *version = 1;
+  *version = needCompress ? BLOCK_VERSION_COLUMNAR : BLOCK_VERSION_1;
   data += sizeof(int32_t);
 
   int32_t* actualLen = (int32_t*)data;
@@ -2229,7 +2612,27 @@ void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_
   *dataLen = blockDataGetSerialMetaSize(numOfCols);
 
   int32_t numOfRows = pBlock->info.rows;
-  for (int32_t col = 0; col < numOfCols; ++col) {
+  if (needCompress) {
+    int32_t nBuf = 0;
+    for (int32_t col = 0; col < numOfCols; ++col) {
+      SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
+      nBuf = TMAX(nBuf, blockColRawSize(pColRes, numOfRows) + BitmapLen(numOfRows) + sizeof(int32_t) * 2 +
+                            sizeof(int8_t) + COMP_OVERFLOW_BYTES);
+    }
+
+    // every column costs one byte more at most, see blockGetEncodeSize
+    char* pBuf = taosMemoryMalloc(nBuf);
+    for (int32_t col = 0; col < numOfCols; ++col) {
+      SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
+      colSizes[col] = blockEncodeCol(pColRes, numOfRows, data, pBuf, (pBuf == NULL) ? 0 : nBuf);
+      data += colSizes[col];
+      (*dataLen) += colSizes[col];
+      colSizes[col] = htonl(colSizes[col]);
+    }
+    taosMemoryFree(pBuf);
+  }
+
+  for (int32_t col = 0; col < numOfCols && !needCompress; ++col) {
     SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
 
     // copy the null bitmap
@@ -2245,16 +2648,10 @@ void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_
     data += metaSize;
     (*dataLen) += metaSize;
 
-    if (needCompress) {
-      colSizes[col] = blockCompressColData(pColRes, numOfRows, data, needCompress);
-      data += colSizes[col];
-      (*dataLen) += colSizes[col];
-    } else {
-      colSizes[col] = colDataGetLength(pColRes, numOfRows);
-      (*dataLen) += colSizes[col];
-      memmove(data, pColRes->pData, colSizes[col]);
-      data += colSizes[col];
-    }
+    colSizes[col] = colDataGetLength(pColRes, numOfRows);
+    (*dataLen) += colSizes[col];
+    memmove(data, pColRes->pData, colSizes[col]);
+    data += colSizes[col];
 
     colSizes[col] = htonl(colSizes[col]);
   }
@@ -2270,7 +2667,7 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
 
   int32_t version = *(int32_t*)pStart;
   pStart += sizeof(int32_t);
-  ASSERT(version == 1);
+  ASSERT(version == BLOCK_VERSION_1 || version == BLOCK_VERSION_COLUMNAR);
 
   // total length sizeof(int32_t)
   int32_t dataLen = *(int32_t*)pStart;
@@ -2321,6 +2718,16 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
     ASSERT(colLen[i] >= 0);
 
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    if (version == BLOCK_VERSION_COLUMNAR) {
+      if (blockDecodeCol(pColInfoData, pStart, colLen[i], numOfRows) < 0) {
+        return NULL;
+      }
+
+      pColInfoData->hasNull = true;
+      pStart += colLen[i];
+      continue;
+    }
+
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
       memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
       pStart += sizeof(int32_t) * numOfRows;
@@ -1563,6 +1563,71 @@ int32_t tColDataAppendValue(SColData *pColData, SColVal *pColVal) {
   return tColDataAppendValueImpl[pColData->flag][pColVal->flag](pColData, pColVal);
 }
 
+// Append nVal fixed-size values laid out back to back in pData, isNull[i] (when given) marks the null ones. The
+// values go in with one copy, a column already holding NONE goes value by value.
+int32_t tColDataAppendFixed(SColData *pColData, const void *pData, const char *isNull, int32_t nVal) {
+  int32_t code = 0;
+  int32_t bytes = tDataTypes[pColData->type].bytes;
+
+  ASSERT(!IS_VAR_DATA_TYPE(pColData->type));
+  if (nVal <= 0) return code;
+
+  int32_t nNull = 0;
+  if (isNull) {
+    for (int32_t i = 0; i < nVal; ++i) {
+      nNull += (isNull[i] != 0);
+    }
+  }
+
+  uint8_t flag = pColData->flag | (nNull ? HAS_NULL : 0) | ((nNull < nVal) ? HAS_VALUE : 0);
+  if (flag & HAS_NONE) {
+    for (int32_t i = 0; i < nVal; ++i) {
+      SColVal cv = COL_VAL_NULL(pColData->cid, pColData->type);
+      if (NULL == isNull || 0 == isNull[i]) {
+        SValue value = {0};
+        memcpy(&value.val, (const uint8_t *)pData + bytes * i, bytes);
+        cv = COL_VAL_VALUE(pColData->cid, pColData->type, value);
+      }
+      code = tColDataAppendValue(pColData, &cv);
+      if (code) return code;
+    }
+    return code;
+  }
+
+  int32_t nTotal = pColData->nVal + nVal;
+  if (flag == (HAS_VALUE | HAS_NULL)) {
+    code = tRealloc(&pColData->pBitMap, BIT1_SIZE(nTotal));
+    if (code) return code;
+
+    if (pColData->flag != flag && pColData->nVal) {
+      // the rows so far were all values or all nulls
+      memset(pColData->pBitMap, (pColData->flag == HAS_VALUE) ? 255 : 0, BIT1_SIZE(pColData->nVal));
+    }
+    for (int32_t i = 0; i < nVal; ++i) {
+      SET_BIT1(pColData->pBitMap, pColData->nVal + i, (isNull && isNull[i]) ? 0 : 1);
+    }
+  }
+
+  if (flag & HAS_VALUE) {
+    code = tRealloc(&pColData->pData, bytes * nTotal);
+    if (code) return code;
+
+    if (!(pColData->flag & HAS_VALUE) && pColData->nVal) {
+      memset(pColData->pData, 0, bytes * pColData->nVal);
+    }
+    uint8_t *pStart = pColData->pData + bytes * pColData->nVal;
+    memcpy(pStart, pData, bytes * nVal);
+    for (int32_t i = 0; nNull && i < nVal; ++i) {
+      if (isNull[i]) memset(pStart + bytes * i, 0, bytes);
+    }
+    pColData->nData = bytes * nTotal;
+  }
+
+  pColData->flag = flag;
+  pColData->nVal = nTotal;
+  return code;
+}
+
 static FORCE_INLINE void tColDataGetValue1(SColData *pColData, int32_t iVal, SColVal *pColVal) {  // HAS_NONE
   *pColVal = COL_VAL_NONE(pColData->cid, pColData->type);
 }
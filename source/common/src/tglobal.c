@@ -82,6 +82,7 @@ bool tsSmlDataFormat = false;
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsQueryTimeSlice = 100;  // ms a query task runs before it gives way to the tasks queued behind it, 0 to disable
 bool    tsEnableQueryHb = false;
 int32_t tsQuerySmaOptimize = 0;
 int32_t tsQueryRsmaTolerance = 1000;  // the tolerance time (ms) to judge from which level to query rsma data.
@@ -89,6 +90,7 @@ bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
 bool    tsKeepColumnName = false;
+int32_t tsQueryPlanCacheSize = 0;  // MB of physical plans a client keeps per cluster for repeated selects, 0 to disable
 
 /*
  * denote if the server needs to compress response message at the application layer to client, including query rsp,
@@ -122,6 +124,15 @@ int32_t tsMinIntervalTime = 1;
 // maximum memory allowed to be allocated for a single csv load (in MB)
 int32_t tsMaxMemUsedByInsert = 1024;
 
+// number of threads to parse a csv file in parallel, 1 means the file is parsed by the calling thread only
+int32_t tsNumOfCsvParseThreads = 4;
+
+// async stmt: a vgroup's buffered rows are submitted once there are stmtFlushRows of them or the oldest was bound
+// stmtFlushInterval ms ago, with at most stmtMaxInflight submits outstanding per vgroup
+int32_t tsStmtFlushRows = 4096;
+int32_t tsStmtFlushInterval = 100;
+int32_t tsStmtMaxInflight = 4;
+
 // the maximum allowed query buffer size during query processing for each data node.
 // -1 no limit (default)
 // 0  no query allowed, queries are disabled
@@ -159,6 +170,24 @@ bool tsStartUdfd = true;
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
 
+// vnode
+int64_t tsVnodeWriteBufferSize = 0;  // bytes of memtable shared by all vnodes of the dnode
+int32_t tsVnodeCommitAge = 600;      // seconds a memtable is kept before it is committed
+int32_t tsVnodeWriteBufferNum = 3;   // memtables per vnode, the active one plus the ones being flushed or read
+bool    tsCompactEnable = true;      // compact tsdb file sets in the background after commits
+int32_t tsCompactIOLimit = 32;       // MB/s read and written by background tsdb compaction of the dnode, 0 for no limit
+bool    tsRetentionRewrite = false;  // merge the .stt files and drop deleted rows of file sets moved to a lower tier
+int32_t tsCommitIOLimit = 0;         // MB/s read and written by tsdb commits of the dnode, 0 for no limit
+int32_t tsMigrateIOLimit = 0;        // MB/s moved to other tiers by retention, 0 for no limit
+int32_t tsSnapshotIOLimit = 0;       // MB/s read and written by tsdb snapshot transfer, 0 for no limit
+int32_t tsIoBackgroundShare = 50;    // percent of the limits above granted while queries are running on the dnode
+
+// tmq
+int32_t tsTqLogCacheSize = 16;  // MB per vnode, 0 to disable
+
+// stream
+int32_t tsStreamBufferSize = 32;  // MB per stream task state, 0 to write through
+
 // internal
 int32_t tsTransPullupInterval = 2;
 int32_t tsMqRebalanceInterval = 2;
@@ -295,11 +324,19 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryPlanCacheSize", tsQueryPlanCacheSize, 0, 1024, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxMemUsedByInsert", tsMaxMemUsedByInsert, 1, INT32_MAX, true) != 0) return -1;
 
+  tsNumOfCsvParseThreads = tsNumOfCores / 2;
+  TRANGE(tsNumOfCsvParseThreads, 1, 8);
+  if (cfgAddInt32(pCfg, "numOfCsvParseThreads", tsNumOfCsvParseThreads, 1, 1024, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "stmtFlushRows", tsStmtFlushRows, 1, INT32_MAX, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "stmtFlushInterval", tsStmtFlushInterval, 0, 3600 * 1000, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "stmtMaxInflight", tsStmtMaxInflight, 1, 1024, true) != 0) return -1;
+
   tsNumOfTaskQueueThreads = tsNumOfCores / 2;
   tsNumOfTaskQueueThreads = TMAX(tsNumOfTaskQueueThreads, 4);
   if (cfgAddInt32(pCfg, "numOfTaskQueueThreads", tsNumOfTaskQueueThreads, 4, 1024, 0) != 0) return -1;
@@ -349,6 +386,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryTimeSlice", tsQueryTimeSlice, 0, 3600000, 0) != 0) return -1;
 
   tsNumOfRpcThreads = tsNumOfCores / 2;
   tsNumOfRpcThreads = TRANGE(tsNumOfRpcThreads, 1, 4);
@@ -407,6 +445,20 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt64(pCfg, "rpcQueueMemoryAllowed", tsRpcQueueMemoryAllowed, TSDB_MAX_MSG_SIZE * 10L, INT64_MAX, 0) != 0)
     return -1;
 
+  tsVnodeWriteBufferSize = tsTotalMemoryKB * 1024 * 0.25;
+  tsVnodeWriteBufferSize = TMAX(tsVnodeWriteBufferSize, 64 * 1024 * 1024LL);
+  if (cfgAddInt64(pCfg, "vnodeWriteBufferSize", tsVnodeWriteBufferSize, 64 * 1024 * 1024LL, INT64_MAX, 0) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "vnodeCommitAge", tsVnodeCommitAge, 1, 86400, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "vnodeWriteBufferNum", tsVnodeWriteBufferNum, 2, 16, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "compactEnable", tsCompactEnable, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "compactIOLimit", tsCompactIOLimit, 0, 4096, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "retentionRewrite", tsRetentionRewrite, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "commitIOLimit", tsCommitIOLimit, 0, 4096, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "migrateIOLimit", tsMigrateIOLimit, 0, 4096, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "snapshotIOLimit", tsSnapshotIOLimit, 0, 4096, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "ioBackgroundShare", tsIoBackgroundShare, 1, 100, 0) != 0) return -1;
+
   if (cfgAddBool(pCfg, "monitor", tsEnableMonitor, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "monitorInterval", tsMonitorInterval, 1, 200000, 0) != 0) return -1;
   if (cfgAddString(pCfg, "monitorFqdn", tsMonitorFqdn, 0) != 0) return -1;
@@ -428,6 +480,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX, 0) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "tqLogCacheSize", tsTqLogCacheSize, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "streamBufferSize", tsStreamBufferSize, 0, 65536, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, 0) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, 0) != 0) return -1;
@@ -580,6 +634,14 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(tsCfg, "vnodeWriteBufferSize");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsVnodeWriteBufferSize = totalMemoryKB * 1024 * 0.25;
+    tsVnodeWriteBufferSize = TMAX(tsVnodeWriteBufferSize, 64 * 1024 * 1024LL);
+    pItem->i64 = tsVnodeWriteBufferSize;
+    pItem->stype = stype;
+  }
+
   return 0;
 }
 
@@ -648,6 +710,10 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
 
   tsMaxMemUsedByInsert = cfgGetItem(pCfg, "maxMemUsedByInsert")->i32;
+  tsNumOfCsvParseThreads = cfgGetItem(pCfg, "numOfCsvParseThreads")->i32;
+  tsStmtFlushRows = cfgGetItem(pCfg, "stmtFlushRows")->i32;
+  tsStmtFlushInterval = cfgGetItem(pCfg, "stmtFlushInterval")->i32;
+  tsStmtMaxInflight = cfgGetItem(pCfg, "stmtMaxInflight")->i32;
 
   tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
   tsCompressMsgSize = cfgGetItem(pCfg, "compressMsgSize")->i32;
@@ -660,6 +726,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
+  tsQueryPlanCacheSize = cfgGetItem(pCfg, "queryPlanCacheSize")->i32;
   return 0;
 }
 
@@ -715,6 +782,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMonitorMaxLogs = cfgGetItem(pCfg, "monitorMaxLogs")->i32;
   tsMonitorComp = cfgGetItem(pCfg, "monitorComp")->bval;
   tsQueryRspPolicy = cfgGetItem(pCfg, "queryRspPolicy")->i32;
+  tsQueryTimeSlice = cfgGetItem(pCfg, "queryTimeSlice")->i32;
 
   tsEnableTelem = cfgGetItem(pCfg, "telemetryReporting")->bval;
   tsTelemInterval = cfgGetItem(pCfg, "telemetryInterval")->i32;
@@ -729,6 +797,18 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsVnodeWriteBufferSize = cfgGetItem(pCfg, "vnodeWriteBufferSize")->i64;
+  tsVnodeCommitAge = cfgGetItem(pCfg, "vnodeCommitAge")->i32;
+  tsVnodeWriteBufferNum = cfgGetItem(pCfg, "vnodeWriteBufferNum")->i32;
+  tsCompactEnable = cfgGetItem(pCfg, "compactEnable")->bval;
+  tsCompactIOLimit = cfgGetItem(pCfg, "compactIOLimit")->i32;
+  tsRetentionRewrite = cfgGetItem(pCfg, "retentionRewrite")->bval;
+  tsCommitIOLimit = cfgGetItem(pCfg, "commitIOLimit")->i32;
+  tsMigrateIOLimit = cfgGetItem(pCfg, "migrateIOLimit")->i32;
+  tsSnapshotIOLimit = cfgGetItem(pCfg, "snapshotIOLimit")->i32;
+  tsIoBackgroundShare = cfgGetItem(pCfg, "ioBackgroundShare")->i32;
+  tsTqLogCacheSize = cfgGetItem(pCfg, "tqLogCacheSize")->i32;
+  tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i32;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
   tstrncpy(tsUdfdResFuncs, cfgGetItem(pCfg, "udfdResFuncs")->str, sizeof(tsUdfdResFuncs));
@@ -931,6 +1011,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
     case 'n': {
       if (strcasecmp("numOfTaskQueueThreads", name) == 0) {
         tsNumOfTaskQueueThreads = cfgGetItem(pCfg, "numOfTaskQueueThreads")->i32;
+      } else if (strcasecmp("numOfCsvParseThreads", name) == 0) {
+        tsNumOfCsvParseThreads = cfgGetItem(pCfg, "numOfCsvParseThreads")->i32;
       } else if (strcasecmp("numOfRpcThreads", name) == 0) {
         tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
       } else if (strcasecmp("numOfCommitThreads", name) == 0) {
@@ -15,6 +15,8 @@
 
 #define _DEFAULT_SOURCE
 #include "tmsg.h"
+#include "tRealloc.h"
+#include "tcompression.h"
 
 #undef TD_MSG_NUMBER_
 #undef TD_MSG_DICT_
@@ -77,19 +79,128 @@ int32_t tGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPBlock) {
     pIter->dataLen = htonl((*pPBlock)->dataLen);
     pIter->schemaLen = htonl((*pPBlock)->schemaLen);
     pIter->numOfRows = htonl((*pPBlock)->numOfRows);
+    pIter->colFmt = (pIter->schemaLen & SUBMIT_BLK_COL_FMT) ? 1 : 0;
+    pIter->schemaLen &= ~SUBMIT_BLK_COL_FMT;
   }
   return 0;
 }
 
 int32_t tInitSubmitBlkIter(SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock, SSubmitBlkIter *pIter) {
-  if (pMsgIter->dataLen <= 0) return -1;
+  SSubmitColBlk *pColBlk = pIter->pColBlk;
+
+  if (pColBlk) {
+    // keep the decode buffers of the previous column-major block for reuse
+    taosMemoryFreeClear(pIter->row);
+    pIter->pColBlk = NULL;
+  }
+  tDestroySubmitBlkIter(pIter);
+
+  if (pMsgIter->dataLen <= 0 || !pMsgIter->colFmt) {
+    if (pColBlk) {
+      tDestroySubmitColBlk(pColBlk);
+      taosMemoryFree(pColBlk);
+    }
+    if (pMsgIter->dataLen <= 0) {
+      if (pMsgIter->colFmt) terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+      return -1;
+    }
+
+    pIter->totalLen = pMsgIter->dataLen;
+    pIter->len = 0;
+    pIter->row = (STSRow *)(pBlock->data + pMsgIter->schemaLen);
+    return 0;
+  }
+
+  if (pColBlk == NULL && (pColBlk = taosMemoryCalloc(1, sizeof(SSubmitColBlk))) == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
   pIter->totalLen = pMsgIter->dataLen;
-  pIter->len = 0;
-  pIter->row = (STSRow *)(pBlock->data + pMsgIter->schemaLen);
+  pIter->pColBlk = pColBlk;
+  pIter->sversion = pMsgIter->sversion;
+  if (tDecodeSubmitColBlk((uint8_t *)pBlock->data + pMsgIter->schemaLen, pMsgIter->dataLen, pColBlk) < 0) {
+    pColBlk->nRow = 0;
+    return -1;
+  }
   return 0;
 }
 
+static STSRow *tGetSubmitColBlkNext(SSubmitBlkIter *pIter) {
+  SSubmitColBlk *pColBlk = pIter->pColBlk;
+
+  if (pIter->iRow >= pColBlk->nRow) return NULL;
+
+  // the row buffer is sized for the widest row of the block and the var buffer for the widest value, both are reused
+  // by every row, so a row costs no allocation
+  if (pIter->pTSchema == NULL) {
+    pIter->pTSchema = tdGetSTSChemaFromSSChema(pColBlk->aSchema, pColBlk->nCol, pIter->sversion);
+    if (pIter->pTSchema == NULL) return NULL;
+
+    int32_t size = sizeof(STSRow) + pIter->pTSchema->flen + TD_BITMAP_BYTES(pColBlk->nCol - 1);
+    int32_t maxVarLen = 0;
+    for (int32_t iCol = 0; iCol < pColBlk->nCol; iCol++) {
+      SColData *pColData = &pColBlk->aColData[iCol];
+      if (!IS_VAR_DATA_TYPE(pColData->type)) continue;
+
+      int32_t maxLen = INT_BYTES;
+      if (pColData->flag & HAS_VALUE) {
+        for (int32_t iRow = 0; iRow < pColData->nVal; iRow++) {
+          int32_t end = (iRow + 1 < pColData->nVal) ? pColData->aOffset[iRow + 1] : pColData->nData;
+          maxLen = TMAX(maxLen, end - pColData->aOffset[iRow]);
+        }
+      }
+      size += sizeof(VarDataLenT) + maxLen;
+      maxVarLen = TMAX(maxVarLen, sizeof(VarDataLenT) + maxLen);
+    }
+
+    pIter->row = taosMemoryMalloc(size);
+    pIter->varBuf = maxVarLen > 0 ? taosMemoryMalloc(maxVarLen) : NULL;
+    if (pIter->row == NULL || (maxVarLen > 0 && pIter->varBuf == NULL)) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return NULL;
+    }
+  }
+
+  STSchema   *pTSchema = pIter->pTSchema;
+  SRowBuilder rb = {0};
+  tdSRowInit(&rb, pTSchema->version);
+  tdSRowSetInfo(&rb, pTSchema->numOfCols, pTSchema->numOfCols, pTSchema->flen);
+  tdSRowResetBuf(&rb, pIter->row);
+
+  for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+    STColumn   *pTColumn = &pTSchema->columns[iCol];
+    TDRowValT   valType = TD_VTYPE_NORM;
+    const void *val = NULL;
+    SColVal     colVal;
+
+    if (iCol < pColBlk->nCol) {
+      tColDataGetValue(&pColBlk->aColData[iCol], pIter->iRow, &colVal);
+      if (COL_VAL_IS_NONE(&colVal)) {
+        valType = TD_VTYPE_NONE;
+      } else if (COL_VAL_IS_NULL(&colVal)) {
+        valType = TD_VTYPE_NULL;
+      } else if (IS_VAR_DATA_TYPE(pTColumn->type)) {
+        varDataSetLen(pIter->varBuf, colVal.value.nData);
+        memcpy(varDataVal(pIter->varBuf), colVal.value.pData, colVal.value.nData);
+        val = pIter->varBuf;
+      } else {
+        val = &colVal.value.val;
+      }
+    } else {
+      valType = TD_VTYPE_NONE;
+    }
+
+    tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, valType, val, true, pTColumn->offset, iCol);
+  }
+  tdSRowEnd(&rb);
+
+  pIter->iRow++;
+  return pIter->row;
+}
+
 STSRow *tGetSubmitBlkNext(SSubmitBlkIter *pIter) {
+  if (pIter->pColBlk) return tGetSubmitColBlkNext(pIter);
+
   STSRow *row = pIter->row;
 
   if (pIter->len >= pIter->totalLen) {
@@ -103,6 +214,236 @@ STSRow *tGetSubmitBlkNext(SSubmitBlkIter *pIter) {
   }
 }
 
+void tDestroySubmitBlkIter(SSubmitBlkIter *pIter) {
+  if (pIter->pColBlk) {
+    taosMemoryFree(pIter->row);
+    tDestroySubmitColBlk(pIter->pColBlk);
+    taosMemoryFree(pIter->pColBlk);
+  }
+  taosMemoryFree(pIter->pTSchema);
+  taosMemoryFree(pIter->varBuf);
+  memset(pIter, 0, sizeof(*pIter));
+}
+
+// Column-major submit block, all fields in host byte order:
+//   SSubmitColBlkHead | (SSubmitColHead | bitmap | offsets | values) * nCol
+// Values of fixed length types are compressed with cmprAlg, var length values are kept raw.
+typedef struct {
+  int32_t nRow;
+  int16_t nCol;
+  int8_t  cmprAlg;
+  int8_t  reserved;
+} SSubmitColBlkHead;
+
+typedef struct {
+  int16_t cid;
+  int8_t  type;
+  uint8_t flag;
+  int32_t bytes;
+  int32_t szBitMap;
+  int32_t szOffset;
+  int32_t szValue;
+  int32_t szOrigin;
+} SSubmitColHead;
+
+static FORCE_INLINE int32_t tSubmitColBitMapSize(uint8_t flag, int32_t nVal) {
+  switch (flag) {
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      return BIT2_SIZE(nVal);
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return BIT1_SIZE(nVal);
+    default:
+      return 0;
+  }
+}
+
+static FORCE_INLINE bool tSubmitColIsCmpr(int8_t cmprAlg, int8_t type, int32_t szOrigin) {
+  return cmprAlg != NO_COMPRESSION && !IS_VAR_DATA_TYPE(type) && szOrigin > 0;
+}
+
+int32_t tSubmitColBlkMaxSize(SColData *aColData, int32_t nCol) {
+  int32_t size = sizeof(SSubmitColBlkHead);
+  for (int32_t iCol = 0; iCol < nCol; iCol++) {
+    SColData *pColData = &aColData[iCol];
+    size += sizeof(SSubmitColHead) + tSubmitColBitMapSize(pColData->flag, pColData->nVal) + pColData->nData +
+            COMP_OVERFLOW_BYTES;
+    if (IS_VAR_DATA_TYPE(pColData->type)) {
+      size += sizeof(int32_t) * pColData->nVal;
+    }
+  }
+  return size;
+}
+
+// pBuf should hold at least tSubmitColBlkMaxSize bytes, return the encoded size or -1
+int32_t tEncodeSubmitColBlk(SColData *aColData, const SSchema *aSchema, int32_t nCol, int8_t cmprAlg, uint8_t *pBuf) {
+  ASSERT(nCol > 0 && nCol <= INT16_MAX && (cmprAlg == NO_COMPRESSION || cmprAlg == ONE_STAGE_COMP));
+
+  SSubmitColBlkHead blkHead = {.nRow = aColData[0].nVal, .nCol = nCol, .cmprAlg = cmprAlg};
+  uint8_t          *p = pBuf;
+
+  memcpy(p, &blkHead, sizeof(blkHead));
+  p += sizeof(blkHead);
+
+  for (int32_t iCol = 0; iCol < nCol; iCol++) {
+    SColData      *pColData = &aColData[iCol];
+    SSubmitColHead colHead = {.cid = pColData->cid,
+                              .type = pColData->type,
+                              .flag = pColData->flag,
+                              .bytes = aSchema[iCol].bytes,
+                              .szBitMap = tSubmitColBitMapSize(pColData->flag, pColData->nVal)};
+    uint8_t       *pHead = p;
+
+    ASSERT(pColData->nVal == blkHead.nRow && pColData->cid == aSchema[iCol].colId);
+    p += sizeof(colHead);
+
+    if (colHead.szBitMap) {
+      memcpy(p, pColData->pBitMap, colHead.szBitMap);
+      p += colHead.szBitMap;
+    }
+
+    if (pColData->flag & HAS_VALUE) {
+      if (IS_VAR_DATA_TYPE(pColData->type)) {
+        colHead.szOffset = sizeof(int32_t) * pColData->nVal;
+        memcpy(p, pColData->aOffset, colHead.szOffset);
+        p += colHead.szOffset;
+      }
+
+      colHead.szOrigin = pColData->nData;
+      if (tSubmitColIsCmpr(cmprAlg, pColData->type, colHead.szOrigin)) {
+        colHead.szValue =
+            tDataTypes[pColData->type].compFunc(pColData->pData, pColData->nData, pColData->nVal, p,
+                                                pColData->nData + COMP_OVERFLOW_BYTES, cmprAlg, NULL, 0);
+        if (colHead.szValue <= 0) {
+          terrno = TSDB_CODE_COMPRESS_ERROR;
+          return -1;
+        }
+      } else {
+        colHead.szValue = colHead.szOrigin;
+        if (colHead.szValue) memcpy(p, pColData->pData, colHead.szValue);
+      }
+      p += colHead.szValue;
+    }
+
+    memcpy(pHead, &colHead, sizeof(colHead));
+  }
+
+  return (int32_t)(p - pBuf);
+}
+
+static int32_t tSubmitColBlkAlloc(SSubmitColBlk *pBlk, int32_t nCol) {
+  if (nCol <= pBlk->nColAlloc) return 0;
+
+  SSchema  *aSchema = taosMemoryRealloc(pBlk->aSchema, sizeof(SSchema) * nCol);
+  if (aSchema == NULL) goto _err;
+  pBlk->aSchema = aSchema;
+
+  SColData *aColData = taosMemoryRealloc(pBlk->aColData, sizeof(SColData) * nCol);
+  if (aColData == NULL) goto _err;
+  pBlk->aColData = aColData;
+
+  uint8_t **aBuf = taosMemoryRealloc(pBlk->aBuf, POINTER_BYTES * nCol);
+  if (aBuf == NULL) goto _err;
+  memset(aBuf + pBlk->nColAlloc, 0, POINTER_BYTES * (nCol - pBlk->nColAlloc));
+  pBlk->aBuf = aBuf;
+
+  pBlk->nColAlloc = nCol;
+  return 0;
+
+_err:
+  terrno = TSDB_CODE_OUT_OF_MEMORY;
+  return -1;
+}
+
+int32_t tDecodeSubmitColBlk(const uint8_t *pBuf, int32_t len, SSubmitColBlk *pBlk) {
+  const uint8_t    *p = pBuf;
+  const uint8_t    *pEnd = pBuf + len;
+  SSubmitColBlkHead blkHead;
+
+  if (len < sizeof(blkHead)) goto _err;
+  memcpy(&blkHead, p, sizeof(blkHead));
+  p += sizeof(blkHead);
+  if (blkHead.nRow <= 0 || blkHead.nCol <= 0) goto _err;
+
+  if (tSubmitColBlkAlloc(pBlk, blkHead.nCol) < 0) return -1;
+  pBlk->nRow = blkHead.nRow;
+  pBlk->nCol = blkHead.nCol;
+
+  for (int32_t iCol = 0; iCol < blkHead.nCol; iCol++) {
+    SSubmitColHead colHead;
+    SColData      *pColData = &pBlk->aColData[iCol];
+
+    if (pEnd - p < sizeof(colHead)) goto _err;
+    memcpy(&colHead, p, sizeof(colHead));
+    p += sizeof(colHead);
+
+    if (colHead.type <= TSDB_DATA_TYPE_NULL || colHead.type >= TSDB_DATA_TYPE_MAX || colHead.flag == 0 ||
+        colHead.flag > (HAS_VALUE | HAS_NULL | HAS_NONE) ||
+        colHead.szBitMap != tSubmitColBitMapSize(colHead.flag, blkHead.nRow) || colHead.szOffset < 0 ||
+        colHead.szValue < 0 || colHead.szOrigin < 0 ||
+        pEnd - p < (int64_t)colHead.szBitMap + colHead.szOffset + colHead.szValue) {
+      goto _err;
+    }
+    if (colHead.flag & HAS_VALUE) {
+      if (IS_VAR_DATA_TYPE(colHead.type) ? colHead.szOffset != sizeof(int32_t) * blkHead.nRow
+                                         : colHead.szOrigin != tDataTypes[colHead.type].bytes * blkHead.nRow) {
+        goto _err;
+      }
+    }
+
+    pBlk->aSchema[iCol] = (SSchema){.type = colHead.type, .colId = colHead.cid, .bytes = colHead.bytes};
+
+    pColData->cid = colHead.cid;
+    pColData->type = colHead.type;
+    pColData->smaOn = 0;
+    pColData->nVal = blkHead.nRow;
+    pColData->flag = colHead.flag;
+    pColData->pBitMap = colHead.szBitMap ? (uint8_t *)p : NULL;
+    p += colHead.szBitMap;
+    pColData->aOffset = colHead.szOffset ? (int32_t *)p : NULL;
+    p += colHead.szOffset;
+    for (int32_t iRow = 0; iRow < colHead.szOffset / (int32_t)sizeof(int32_t); iRow++) {
+      int32_t end = (iRow + 1 < blkHead.nRow) ? pColData->aOffset[iRow + 1] : colHead.szOrigin;
+      if (pColData->aOffset[iRow] < 0 || pColData->aOffset[iRow] > end) goto _err;
+    }
+    pColData->nData = colHead.szOrigin;
+    if (tSubmitColIsCmpr(blkHead.cmprAlg, colHead.type, colHead.szOrigin)) {
+      if (tRealloc(&pBlk->aBuf[iCol], colHead.szOrigin)) {
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        return -1;
+      }
+      int32_t size = tDataTypes[colHead.type].decompFunc((char *)p, colHead.szValue, blkHead.nRow, pBlk->aBuf[iCol],
+                                                         colHead.szOrigin, blkHead.cmprAlg, NULL, 0);
+      if (size != colHead.szOrigin) {
+        terrno = TSDB_CODE_COMPRESS_ERROR;
+        return -1;
+      }
+      pColData->pData = pBlk->aBuf[iCol];
+    } else {
+      if (colHead.szValue != colHead.szOrigin) goto _err;
+      pColData->pData = (uint8_t *)p;
+    }
+    p += colHead.szValue;
+  }
+
+  return 0;
+
+_err:
+  terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+  return -1;
+}
+
+void tDestroySubmitColBlk(SSubmitColBlk *pBlk) {
+  for (int32_t iCol = 0; iCol < pBlk->nColAlloc; iCol++) {
+    tFree(pBlk->aBuf[iCol]);
+  }
+  taosMemoryFree(pBlk->aBuf);
+  taosMemoryFree(pBlk->aColData);
+  taosMemoryFree(pBlk->aSchema);
+  memset(pBlk, 0, sizeof(*pBlk));
+}
+
 int32_t tPrintFixedSchemaSubmitReq(SSubmitReq *pReq, STSchema *pTschema) {
   SSubmitMsgIter msgIter = {0};
   if (tInitSubmitMsgIter(pReq, &msgIter) < 0) return -1;
@@ -118,6 +459,7 @@ int32_t tPrintFixedSchemaSubmitReq(SSubmitReq *pReq, STSchema *pTschema) {
     while ((row = tGetSubmitBlkNext(&blkIter)) != NULL) {
       tdSRowPrint(row, pTschema, "stream");
     }
+    tDestroySubmitBlkIter(&blkIter);
   }
   return 0;
 }
@@ -1020,6 +1362,21 @@ int32_t tSerializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tEncodeI64(&encoder, pReq->qload.timeInQueryQueue) < 0) return -1;
   if (tEncodeI64(&encoder, pReq->qload.timeInFetchQueue) < 0) return -1;
 
+  // stream task loads
+  int32_t slen = (int32_t)taosArrayGetSize(pReq->pStreamLoads);
+  if (tEncodeI32(&encoder, slen) < 0) return -1;
+  for (int32_t i = 0; i < slen; ++i) {
+    SStreamTaskLoad *pload = taosArrayGet(pReq->pStreamLoads, i);
+    if (tEncodeI64(&encoder, pload->streamId) < 0) return -1;
+    if (tEncodeI32(&encoder, pload->taskId) < 0) return -1;
+    if (tEncodeI32(&encoder, pload->batchSize) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->execNum) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->inputItems) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->outputRows) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->execTimeUs) < 0) return -1;
+    if (tEncodeI64(&encoder, pload->maxExecUs) < 0) return -1;
+  }
+
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -1095,12 +1452,37 @@ int32_t tDeserializeSStatusReq(void *buf, int32_t bufLen, SStatusReq *pReq) {
   if (tDecodeI64(&decoder, &pReq->qload.timeInQueryQueue) < 0) return -1;
   if (tDecodeI64(&decoder, &pReq->qload.timeInFetchQueue) < 0) return -1;
 
+  if (!tDecodeIsEnd(&decoder)) {
+    int32_t slen = 0;
+    if (tDecodeI32(&decoder, &slen) < 0) return -1;
+    pReq->pStreamLoads = taosArrayInit(slen, sizeof(SStreamTaskLoad));
+    if (pReq->pStreamLoads == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    for (int32_t i = 0; i < slen; ++i) {
+      SStreamTaskLoad sload = {0};
+      if (tDecodeI64(&decoder, &sload.streamId) < 0) return -1;
+      if (tDecodeI32(&decoder, &sload.taskId) < 0) return -1;
+      if (tDecodeI32(&decoder, &sload.batchSize) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.execNum) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.inputItems) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.outputRows) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.execTimeUs) < 0) return -1;
+      if (tDecodeI64(&decoder, &sload.maxExecUs) < 0) return -1;
+      taosArrayPush(pReq->pStreamLoads, &sload);
+    }
+  }
+
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
   return 0;
 }
 
-void tFreeSStatusReq(SStatusReq *pReq) { taosArrayDestroy(pReq->pVloads); }
+void tFreeSStatusReq(SStatusReq *pReq) {
+  taosArrayDestroy(pReq->pVloads);
+  taosArrayDestroy(pReq->pStreamLoads);
+}
 
 int32_t tSerializeSStatusRsp(void *buf, int32_t bufLen, SStatusRsp *pRsp) {
   SEncoder encoder = {0};
@@ -3468,6 +3850,114 @@ int32_t tDeserializeSTableInfoReq(void *buf, int32_t bufLen, STableInfoReq *pReq
   return 0;
 }
 
+int32_t tSerializeSVTablesMetaReq(void *buf, int32_t bufLen, SVTablesMetaReq *pReq) {
+  int32_t headLen = sizeof(SMsgHead);
+  if (buf != NULL) {
+    buf = (char *)buf + headLen;
+    bufLen -= headLen;
+  }
+
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeCStr(&encoder, pReq->dbFName) < 0) return -1;
+  if (tEncodeCStr(&encoder, pReq->stbName) < 0) return -1;
+  if (tEncodeI64(&encoder, pReq->lastUid) < 0) return -1;
+  if (tEncodeI32(&encoder, pReq->limit) < 0) return -1;
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+
+  if (buf != NULL) {
+    SMsgHead *pHead = (SMsgHead *)((char *)buf - headLen);
+    pHead->vgId = htonl(pReq->header.vgId);
+    pHead->contLen = htonl(tlen + headLen);
+  }
+
+  return tlen + headLen;
+}
+
+int32_t tDeserializeSVTablesMetaReq(void *buf, int32_t bufLen, SVTablesMetaReq *pReq) {
+  int32_t headLen = sizeof(SMsgHead);
+
+  SMsgHead *pHead = buf;
+  pHead->vgId = pReq->header.vgId;
+  pHead->contLen = pReq->header.contLen;
+
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, (char *)buf + headLen, bufLen - headLen);
+
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeCStrTo(&decoder, pReq->dbFName) < 0) return -1;
+  if (tDecodeCStrTo(&decoder, pReq->stbName) < 0) return -1;
+  if (tDecodeI64(&decoder, &pReq->lastUid) < 0) return -1;
+  if (tDecodeI32(&decoder, &pReq->limit) < 0) return -1;
+
+  tEndDecode(&decoder);
+  tDecoderClear(&decoder);
+  return 0;
+}
+
+int32_t tSerializeSVTablesMetaRsp(void *buf, int32_t bufLen, SVTablesMetaRsp *pRsp) {
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, buf, bufLen);
+
+  int32_t num = taosArrayGetSize(pRsp->pCtbs);
+  if (tStartEncode(&encoder) < 0) return -1;
+  if (tEncodeI64(&encoder, pRsp->dbId) < 0) return -1;
+  if (tEncodeI64(&encoder, pRsp->suid) < 0) return -1;
+  if (tEncodeI32(&encoder, pRsp->vgId) < 0) return -1;
+  if (tEncodeI32(&encoder, pRsp->sversion) < 0) return -1;
+  if (tEncodeI32(&encoder, pRsp->tversion) < 0) return -1;
+  if (tEncodeI8(&encoder, pRsp->hasMore) < 0) return -1;
+  if (tEncodeI32(&encoder, num) < 0) return -1;
+  for (int32_t i = 0; i < num; ++i) {
+    SVCtbMeta *pCtb = taosArrayGet(pRsp->pCtbs, i);
+    if (tEncodeCStr(&encoder, pCtb->tbName) < 0) return -1;
+    if (tEncodeI64(&encoder, pCtb->uid) < 0) return -1;
+  }
+  tEndEncode(&encoder);
+
+  int32_t tlen = encoder.pos;
+  tEncoderClear(&encoder);
+  return tlen;
+}
+
+int32_t tDeserializeSVTablesMetaRsp(void *buf, int32_t bufLen, SVTablesMetaRsp *pRsp) {
+  SDecoder decoder = {0};
+  tDecoderInit(&decoder, buf, bufLen);
+
+  int32_t num = 0;
+  if (tStartDecode(&decoder) < 0) return -1;
+  if (tDecodeI64(&decoder, &pRsp->dbId) < 0) return -1;
+  if (tDecodeI64(&decoder, &pRsp->suid) < 0) return -1;
+  if (tDecodeI32(&decoder, &pRsp->vgId) < 0) return -1;
+  if (tDecodeI32(&decoder, &pRsp->sversion) < 0) return -1;
+  if (tDecodeI32(&decoder, &pRsp->tversion) < 0) return -1;
+  if (tDecodeI8(&decoder, &pRsp->hasMore) < 0) return -1;
+  if (tDecodeI32(&decoder, &num) < 0) return -1;
+
+  pRsp->pCtbs = taosArrayInit(num > 0 ? num : 1, sizeof(SVCtbMeta));
+  if (pRsp->pCtbs == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    SVCtbMeta ctb = {0};
+    if (tDecodeCStrTo(&decoder, ctb.tbName) < 0) return -1;
+    if (tDecodeI64(&decoder, &ctb.uid) < 0) return -1;
+    taosArrayPush(pRsp->pCtbs, &ctb);
+  }
+
+  tEndDecode(&decoder);
+  tDecoderClear(&decoder);
+  return 0;
+}
+
+void tFreeSVTablesMetaRsp(SVTablesMetaRsp *pRsp) { taosArrayDestroy(pRsp->pCtbs); }
+
 int32_t tSerializeSMDropTopicReq(void *buf, int32_t bufLen, SMDropTopicReq *pReq) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -3673,6 +4163,7 @@ int32_t tSerializeSConnectRsp(void *buf, int32_t bufLen, SConnectRsp *pRsp) {
   if (tEncodeI32(&encoder, pRsp->svrTimestamp) < 0) return -1;
   if (tEncodeCStr(&encoder, pRsp->sVer) < 0) return -1;
   if (tEncodeCStr(&encoder, pRsp->sDetailVer) < 0) return -1;
+  if (tEncodeI8(&encoder, pRsp->submitColFmt) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -3696,6 +4187,10 @@ int32_t tDeserializeSConnectRsp(void *buf, int32_t bufLen, SConnectRsp *pRsp) {
   if (tDecodeI32(&decoder, &pRsp->svrTimestamp) < 0) return -1;
   if (tDecodeCStrTo(&decoder, pRsp->sVer) < 0) return -1;
   if (tDecodeCStrTo(&decoder, pRsp->sDetailVer) < 0) return -1;
+  pRsp->submitColFmt = 0;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pRsp->submitColFmt) < 0) return -1;
+  }
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -260,4 +260,217 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+namespace {
+// ts, int with nulls, double, binary from a few distinct values and binary with distinct values
+SSDataBlock* createColumnarTestBlock(int32_t numOfRows) {
+  SSDataBlock*    b = createDataBlock();
+  SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  SColumnInfoData i32 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  SColumnInfoData dbl = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 3);
+  SColumnInfoData dict = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 4);
+  SColumnInfoData str = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 5);
+  blockDataAppendColInfo(b, &ts);
+  blockDataAppendColInfo(b, &i32);
+  blockDataAppendColInfo(b, &dbl);
+  blockDataAppendColInfo(b, &dict);
+  blockDataAppendColInfo(b, &str);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[64] = {0};
+  char varbuf[64] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t k = 1537146000000 + i * 1000;
+    double  d = i * 0.5;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&k, false);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&i, i % 3 == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+
+    sprintf(buf, "device_%d", i % 4);
+    STR_TO_VARSTR(varbuf, buf);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, varbuf, i % 5 == 0);
+
+    sprintf(buf, "the value of row %d", i);
+    STR_TO_VARSTR(varbuf, buf);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 4), i, varbuf, i % 7 == 0);
+  }
+  b->info.rows = numOfRows;
+  return b;
+}
+
+void checkSameBlock(const SSDataBlock* pExpect, const SSDataBlock* pBlock) {
+  ASSERT_EQ(pBlock->info.rows, pExpect->info.rows);
+  ASSERT_EQ(taosArrayGetSize(pBlock->pDataBlock), taosArrayGetSize(pExpect->pDataBlock));
+  for (int32_t col = 0; col < taosArrayGetSize(pExpect->pDataBlock); ++col) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(pExpect->pDataBlock, col);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
+    ASSERT_EQ(p1->info.type, p0->info.type);
+    for (int32_t i = 0; i < pExpect->info.rows; ++i) {
+      bool isNull = colDataIsNull(p0, pExpect->info.rows, i, NULL);
+      ASSERT_EQ(colDataIsNull(p1, pBlock->info.rows, i, NULL), isNull);
+      if (isNull) continue;
+
+      char* v0 = colDataGetData(p0, i);
+      char* v1 = colDataGetData(p1, i);
+      int32_t len = IS_VAR_DATA_TYPE(p0->info.type) ? varDataTLen(v0) : p0->info.bytes;
+      ASSERT_EQ(memcmp(v0, v1, len), 0);
+    }
+  }
+}
+}  // namespace
+
+TEST(testCase, columnar_block_round_trip) {
+  const int32_t numOfRows = 1000;
+  SSDataBlock*  b = createColumnarTestBlock(numOfRows);
+
+  // a columnar block is smaller than the version 1 block and decodes to the same values
+  char*   pV1 = (char*)taosMemoryMalloc(blockGetEncodeSize(b));
+  char*   pV2 = (char*)taosMemoryMalloc(blockGetEncodeSize(b));
+  int32_t len1 = 0;
+  int32_t len2 = 0;
+  blockEncode(b, pV1, &len1, 5, 0);
+  blockEncode(b, pV2, &len2, 5, 1);
+  ASSERT_EQ(*(int32_t*)pV1, BLOCK_VERSION_1);
+  ASSERT_EQ(*(int32_t*)pV2, BLOCK_VERSION_COLUMNAR);
+  ASSERT_LT(len2, len1);
+
+  SSDataBlock d1 = {0};
+  SSDataBlock d2 = {0};
+  ASSERT_EQ(blockDecode(&d1, pV1), pV1 + len1);
+  ASSERT_EQ(blockDecode(&d2, pV2), pV2 + len2);
+  checkSameBlock(b, &d1);
+  checkSameBlock(b, &d2);
+
+  blockDataFreeRes(&d1);
+  blockDataFreeRes(&d2);
+  taosMemoryFree(pV1);
+  taosMemoryFree(pV2);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, columnar_block_bad_col) {
+  const int32_t numOfRows = 100;
+  SSDataBlock*  b = createColumnarTestBlock(numOfRows);
+
+  char*   pData = (char*)taosMemoryMalloc(blockGetEncodeSize(b));
+  int32_t len = 0;
+  blockEncode(b, pData, &len, 5, 1);
+
+  // find the dictionary coded column
+  int32_t* colLen = (int32_t*)(pData + blockDataGetSerialMetaSize(5) - sizeof(int32_t) * 5);
+  char*    pCol = pData + blockDataGetSerialMetaSize(5);
+  for (int32_t i = 0; i < 3; ++i) pCol += htonl(colLen[i]);
+  int32_t nCol = htonl(colLen[3]);
+  ASSERT_EQ(*(int8_t*)pCol, 2);  // BLOCK_COL_DICT
+
+  SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 20, 4);
+  ASSERT_EQ(colInfoDataEnsureCapacity(&col, numOfRows), 0);
+  ASSERT_EQ(blockDecodeCol(&col, pCol, nCol, numOfRows), 0);
+
+  char*    pBad = (char*)taosMemoryMalloc(nCol);
+  int32_t* pDictHead = (int32_t*)(pBad + sizeof(int8_t) + BitmapLen(numOfRows));
+  int32_t  cases[][2] = {{-1, 0}, {0, -1}, {1 << 20, 0}, {0, 1 << 20}, {1 << 30, 1 << 20}};
+  for (int32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    memcpy(pBad, pCol, nCol);
+    pDictHead[0] += cases[i][0];
+    pDictHead[1] += cases[i][1];
+    terrno = 0;
+    ASSERT_EQ(blockDecodeCol(&col, pBad, nCol, numOfRows), -1);
+    ASSERT_EQ(terrno, TSDB_CODE_INVALID_MSG);
+  }
+
+  // a bad code width and a cut column
+  memcpy(pBad, pCol, nCol);
+  pBad[sizeof(int8_t) + BitmapLen(numOfRows) + sizeof(int32_t) * 2 + pDictHead[1]] = 3;
+  ASSERT_EQ(blockDecodeCol(&col, pBad, nCol, numOfRows), -1);
+  for (int32_t n = 0; n < nCol; n += 7) {
+    ASSERT_EQ(blockDecodeCol(&col, pCol, n, numOfRows), -1);
+  }
+
+  colDataDestroy(&col);
+  taosMemoryFree(pBad);
+  taosMemoryFree(pData);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, tables_meta_msg_round_trip) {
+  SVTablesMetaReq req = {0};
+  req.header.vgId = 3;
+  req.lastUid = 0x7f00000000001234;
+  req.limit = 4096;
+  strcpy(req.dbFName, "1.db");
+  strcpy(req.stbName, "stb");
+
+  int32_t len = tSerializeSVTablesMetaReq(NULL, 0, &req);
+  char*   pBuf = (char*)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSVTablesMetaReq(pBuf, len, &req), len);
+  ASSERT_EQ(ntohl(((SMsgHead*)pBuf)->vgId), 3);
+  ASSERT_EQ(ntohl(((SMsgHead*)pBuf)->contLen), len);
+
+  SVTablesMetaReq req2 = {0};
+  ASSERT_EQ(tDeserializeSVTablesMetaReq(pBuf, len, &req2), 0);
+  ASSERT_STREQ(req2.dbFName, "1.db");
+  ASSERT_STREQ(req2.stbName, "stb");
+  ASSERT_EQ(req2.lastUid, req.lastUid);
+  ASSERT_EQ(req2.limit, 4096);
+  taosMemoryFree(pBuf);
+
+  SVTablesMetaRsp rsp = {0};
+  rsp.dbId = 1;
+  rsp.suid = 2;
+  rsp.vgId = 3;
+  rsp.sversion = 4;
+  rsp.tversion = 5;
+  rsp.hasMore = 1;
+  rsp.pCtbs = taosArrayInit(3, sizeof(SVCtbMeta));
+  for (int32_t i = 0; i < 3; ++i) {
+    SVCtbMeta ctb = {0};
+    ctb.uid = 100 + i;
+    memset(ctb.tbName, 'a' + i, i == 2 ? TSDB_TABLE_NAME_LEN - 1 : i + 1);
+    taosArrayPush(rsp.pCtbs, &ctb);
+  }
+
+  len = tSerializeSVTablesMetaRsp(NULL, 0, &rsp);
+  pBuf = (char*)taosMemoryMalloc(len);
+  ASSERT_EQ(tSerializeSVTablesMetaRsp(pBuf, len, &rsp), len);
+
+  SVTablesMetaRsp rsp2 = {0};
+  ASSERT_EQ(tDeserializeSVTablesMetaRsp(pBuf, len, &rsp2), 0);
+  ASSERT_EQ(rsp2.dbId, 1);
+  ASSERT_EQ(rsp2.suid, 2);
+  ASSERT_EQ(rsp2.vgId, 3);
+  ASSERT_EQ(rsp2.sversion, 4);
+  ASSERT_EQ(rsp2.tversion, 5);
+  ASSERT_EQ(rsp2.hasMore, 1);
+  ASSERT_EQ(taosArrayGetSize(rsp2.pCtbs), 3);
+  for (int32_t i = 0; i < 3; ++i) {
+    SVCtbMeta* p1 = (SVCtbMeta*)taosArrayGet(rsp.pCtbs, i);
+    SVCtbMeta* p2 = (SVCtbMeta*)taosArrayGet(rsp2.pCtbs, i);
+    ASSERT_EQ(p2->uid, p1->uid);
+    ASSERT_STREQ(p2->tbName, p1->tbName);
+  }
+  tFreeSVTablesMetaRsp(&rsp2);
+
+  // a page claiming more tables than it carries is rejected
+  int32_t* pNum = (int32_t*)(pBuf + sizeof(int32_t) + sizeof(int64_t) * 2 + sizeof(int32_t) * 3 + sizeof(int8_t));
+  ASSERT_EQ(*pNum, 3);
+  *pNum = 4;
+  SVTablesMetaRsp rsp3 = {0};
+  ASSERT_EQ(tDeserializeSVTablesMetaRsp(pBuf, len, &rsp3), -1);
+  tFreeSVTablesMetaRsp(&rsp3);
+  taosMemoryFree(pBuf);
+
+  // the last page of a vgroup may be empty
+  tFreeSVTablesMetaRsp(&rsp);
+  SVTablesMetaRsp empty = {0};
+  empty.suid = 2;
+  len = tSerializeSVTablesMetaRsp(NULL, 0, &empty);
+  pBuf = (char*)taosMemoryMalloc(len);
+  tSerializeSVTablesMetaRsp(pBuf, len, &empty);
+  ASSERT_EQ(tDeserializeSVTablesMetaRsp(pBuf, len, &rsp2), 0);
+  ASSERT_EQ(rsp2.hasMore, 0);
+  ASSERT_EQ(taosArrayGetSize(rsp2.pCtbs), 0);
+  tFreeSVTablesMetaRsp(&rsp2);
+  taosMemoryFree(pBuf);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
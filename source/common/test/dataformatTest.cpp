@@ -13,7 +13,6 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#if 0
 #include <gtest/gtest.h>
 
 #include <taoserror.h>
@@ -21,7 +20,9 @@
 #include <tglobal.h>
 #include <tmsg.h>
 #include <iostream>
+#include <vector>
 
+#if 0
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
 #pragma GCC diagnostic ignored "-Wunused-function"
@@ -478,4 +479,108 @@ TEST(testCase, NoneTest) {
   taosMemoryFree(pTSchema);
 }
 #endif
-#endif
\ No newline at end of file
+#endif
+
+// the rows of a column, -1 for NONE, -2 for NULL
+static void checkColData(SColData *pColData, uint8_t flag, const std::vector<int32_t> &rows) {
+  ASSERT_EQ(pColData->flag, flag);
+  ASSERT_EQ(pColData->nVal, (int32_t)rows.size());
+  for (int32_t i = 0; i < pColData->nVal; ++i) {
+    SColVal cv;
+    tColDataGetValue(pColData, i, &cv);
+    if (rows[i] == -1) {
+      EXPECT_TRUE(COL_VAL_IS_NONE(&cv)) << "row " << i;
+    } else if (rows[i] == -2) {
+      EXPECT_TRUE(COL_VAL_IS_NULL(&cv)) << "row " << i;
+    } else {
+      EXPECT_TRUE(COL_VAL_IS_VALUE(&cv)) << "row " << i;
+      EXPECT_EQ(*(int32_t *)&cv.value.val, rows[i]) << "row " << i;
+    }
+  }
+}
+
+static void appendNone(SColData *pColData) {
+  SColVal cv = COL_VAL_NONE(pColData->cid, pColData->type);
+  ASSERT_EQ(tColDataAppendValue(pColData, &cv), 0);
+}
+
+TEST(tColDataAppendFixed, value) {
+  SColData colData = {0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+
+  int32_t v[] = {1, 2, 3};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, NULL, 3), 0);
+  checkColData(&colData, HAS_VALUE, {1, 2, 3});
+
+  char noNull[] = {0, 0, 0};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, noNull, 3), 0);
+  checkColData(&colData, HAS_VALUE, {1, 2, 3, 1, 2, 3});
+  tColDataDestroy(&colData);
+}
+
+TEST(tColDataAppendFixed, nullToValueNull) {
+  SColData colData = {0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+
+  int32_t v[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  char    allNull[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, allNull, 9), 0);
+  checkColData(&colData, HAS_NULL, {-2, -2, -2, -2, -2, -2, -2, -2, -2});
+
+  // the nulls so far get their bits when the first value comes, across a byte of the bitmap
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, NULL, 2), 0);
+  checkColData(&colData, HAS_VALUE | HAS_NULL, {-2, -2, -2, -2, -2, -2, -2, -2, -2, 1, 2});
+  tColDataDestroy(&colData);
+}
+
+TEST(tColDataAppendFixed, valueToValueNull) {
+  SColData colData = {0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+
+  int32_t v[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, NULL, 7), 0);
+  checkColData(&colData, HAS_VALUE, {1, 2, 3, 4, 5, 6, 7});
+
+  char isNull[] = {0, 1, 0, 1};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, isNull, 4), 0);
+  checkColData(&colData, HAS_VALUE | HAS_NULL, {1, 2, 3, 4, 5, 6, 7, 1, -2, 3, -2});
+
+  ASSERT_EQ(tColDataAppendFixed(&colData, v + 5, NULL, 2), 0);
+  checkColData(&colData, HAS_VALUE | HAS_NULL, {1, 2, 3, 4, 5, 6, 7, 1, -2, 3, -2, 6, 7});
+  tColDataDestroy(&colData);
+}
+
+TEST(tColDataAppendFixed, none) {
+  SColData colData = {0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+
+  // a column holding NONE takes the values one by one
+  int32_t v[] = {1, 2, 3};
+  appendNone(&colData);
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, NULL, 3), 0);
+  checkColData(&colData, HAS_NONE | HAS_VALUE, {-1, 1, 2, 3});
+
+  char isNull[] = {1, 0, 0};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, isNull, 3), 0);
+  checkColData(&colData, HAS_NONE | HAS_VALUE | HAS_NULL, {-1, 1, 2, 3, -2, 2, 3});
+  tColDataDestroy(&colData);
+
+  // NONE after fixed values and nulls, then fixed values again
+  colData = (SColData){0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, isNull, 3), 0);
+  checkColData(&colData, HAS_VALUE | HAS_NULL, {-2, 2, 3});
+  appendNone(&colData);
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, NULL, 3), 0);
+  checkColData(&colData, HAS_NONE | HAS_VALUE | HAS_NULL, {-2, 2, 3, -1, 1, 2, 3});
+  tColDataDestroy(&colData);
+
+  // only NONE and nulls
+  colData = (SColData){0};
+  tColDataInit(&colData, 2, TSDB_DATA_TYPE_INT, 0);
+  appendNone(&colData);
+  char allNull[] = {1, 1};
+  ASSERT_EQ(tColDataAppendFixed(&colData, v, allNull, 2), 0);
+  checkColData(&colData, HAS_NONE | HAS_NULL, {-1, -2, -2});
+  tColDataDestroy(&colData);
+}
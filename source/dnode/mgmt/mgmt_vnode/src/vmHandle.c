@@ -32,6 +32,9 @@ void vmGetVnodeLoads(SVnodeMgmt *pMgmt, SMonVloadInfo *pInfo, bool isReset) {
     vnodeGetLoad(pVnode->pImpl, &vload);
     if (isReset) vnodeResetLoad(pVnode->pImpl, &vload);
     taosArrayPush(pInfo->pVloads, &vload);
+    if (pInfo->pStreamLoads != NULL && vload.syncState == TAOS_SYNC_STATE_LEADER) {
+      vnodeGetStreamTaskLoads(pVnode->pImpl, pInfo->pStreamLoads);
+    }
     pIter = taosHashIterate(pMgmt->hash, pIter);
   }
 
@@ -52,6 +55,10 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   int64_t numOfInsertSuccessReqs = 0;
   int64_t numOfBatchInsertReqs = 0;
   int64_t numOfBatchInsertSuccessReqs = 0;
+  int64_t numOfCommitStalls = 0;
+  int64_t commitStallTimeUs = 0;
+  int64_t numOfBufferStalls = 0;
+  int64_t bufferStallTimeUs = 0;
 
   for (int32_t i = 0; i < taosArrayGetSize(pVloads); ++i) {
     SVnodeLoad *pLoad = taosArrayGet(pVloads, i);
@@ -60,6 +67,10 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
     numOfInsertSuccessReqs += pLoad->numOfInsertSuccessReqs;
     numOfBatchInsertReqs += pLoad->numOfBatchInsertReqs;
     numOfBatchInsertSuccessReqs += pLoad->numOfBatchInsertSuccessReqs;
+    numOfCommitStalls += pLoad->numOfCommitStalls;
+    commitStallTimeUs += pLoad->commitStallTimeUs;
+    numOfBufferStalls += pLoad->numOfBufferStalls;
+    bufferStallTimeUs += pLoad->bufferStallTimeUs;
     if (pLoad->syncState == TAOS_SYNC_STATE_LEADER) masterNum++;
     totalVnodes++;
   }
@@ -71,6 +82,11 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pInfo->vstat.numOfInsertSuccessReqs = numOfInsertSuccessReqs;            // delta
   pInfo->vstat.numOfBatchInsertReqs = numOfBatchInsertReqs;                // delta
   pInfo->vstat.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;  // delta
+  pInfo->vstat.numOfCommitStalls = numOfCommitStalls;                      // delta
+  pInfo->vstat.commitStallTimeUs = commitStallTimeUs;                      // delta
+  pInfo->vstat.numOfBufferStalls = numOfBufferStalls;                      // delta
+  pInfo->vstat.bufferStallTimeUs = bufferStallTimeUs;                      // delta
+  vnodeGetIoStat(pInfo->vstat.ioStat);
   pMgmt->state.totalVnodes = totalVnodes;
   pMgmt->state.masterNum = masterNum;
   pMgmt->state.numOfSelectReqs = numOfSelectReqs;
@@ -117,6 +117,13 @@ static void vmProcessFetchQueue(SQueueInfo *pInfo, STaosQall *qall, int32_t numO
   }
 }
 
+// Only the fetch of query tasks may run on another fetch thread, qworker guards each task by itself. The other messages,
+// e.g. TDMT_VND_TMQ_CONSUME and TDMT_STREAM_TASK_RUN, rely on the fetch queue of a vnode being consumed by one thread.
+static bool vmIsStealableMsg(void *pItem) {
+  SRpcMsg *pMsg = pItem;
+  return pMsg->msgType == TDMT_SCH_FETCH || pMsg->msgType == TDMT_SCH_MERGE_FETCH;
+}
+
 static void vmProcessSyncQueue(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs) {
   SVnodeObj *pVnode = pInfo->ahandle;
   SRpcMsg   *pMsg = NULL;
@@ -355,6 +362,7 @@ int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
   SWWorkerPool *pFPool = &pMgmt->fetchPool;
   pFPool->name = "vnode-fetch";
   pFPool->max = tsNumOfVnodeFetchThreads;
+  pFPool->stealFp = vmIsStealableMsg;
   if (tWWorkerInit(pFPool) != 0) return -1;
 
   SWWorkerPool *pWPool = &pMgmt->writePool;
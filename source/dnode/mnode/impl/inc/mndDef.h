@@ -432,6 +432,7 @@ typedef struct {
   int16_t        numOfColumns;
   int32_t        numOfRows;
   void*          pIter;
+  int32_t        curIterPackedRows;  // rows of the object at pIter already returned
   SMnode*        pMnode;
   STableMetaRsp* pMeta;
   bool           sysDbRsp;
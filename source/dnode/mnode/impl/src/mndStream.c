@@ -41,6 +41,8 @@ static int32_t mndProcessStreamMetaReq(SRpcMsg *pReq);
 static int32_t mndGetStreamMeta(SRpcMsg *pReq, SShowObj *pShow, STableMetaRsp *pMeta);
 static int32_t mndRetrieveStream(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
 static void    mndCancelGetNextStream(SMnode *pMnode, void *pIter);
+static int32_t mndRetrieveStreamTask(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows);
+static void    mndCancelGetNextStreamTask(SMnode *pMnode, void *pIter);
 
 int32_t mndInitStream(SMnode *pMnode) {
   SSdbTable table = {
@@ -62,6 +64,8 @@ int32_t mndInitStream(SMnode *pMnode) {
 
   mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_STREAMS, mndRetrieveStream);
   mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_STREAMS, mndCancelGetNextStream);
+  mndAddShowRetrieveHandle(pMnode, TSDB_MGMT_TABLE_STREAM_TASKS, mndRetrieveStreamTask);
+  mndAddShowFreeIterHandle(pMnode, TSDB_MGMT_TABLE_STREAM_TASKS, mndCancelGetNextStreamTask);
 
   return sdbSetTable(pMnode->pSdb, table);
 }
@@ -955,3 +959,191 @@ static void mndCancelGetNextStream(SMnode *pMnode, void *pIter) {
   SSdb *pSdb = pMnode->pSdb;
   sdbCancelFetch(pSdb, pIter);
 }
+
+// the stream at the iterator of a task retrieve is still referenced
+static void mndCancelGetNextStreamTask(SMnode *pMnode, void *pIter) {
+  SSdb *pSdb = pMnode->pSdb;
+  sdbRelease(pSdb, sdbGetRowObj(*(SSdbRow **)pIter));
+  sdbCancelFetch(pSdb, pIter);
+}
+
+// Keep the exec statistics the dnodes report for the tasks of their leader vnodes in the tasks of the streams.
+// The statistics are plain stores read by the show path only, so the read latch is enough to keep the task list in
+// place and the status messages do not serialize with each other or with the stream transactions.
+void mndStreamUpdateTaskLoads(SMnode *pMnode, SArray *pLoads) {
+  int32_t size = taosArrayGetSize(pLoads);
+  if (size == 0) return;
+
+  // the loads of a dnode belong to a few streams, so only the streams they name are visited
+  SHashObj *pHash = taosHashInit(size, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pHash == NULL) return;
+  for (int32_t i = 0; i < size; ++i) {
+    SStreamTaskLoad *pLoad = taosArrayGet(pLoads, i);
+    SArray         **ppStreamLoads = taosHashGet(pHash, &pLoad->streamId, sizeof(int64_t));
+    SArray          *pStreamLoads = ppStreamLoads != NULL ? *ppStreamLoads : NULL;
+    if (pStreamLoads == NULL) {
+      pStreamLoads = taosArrayInit(4, POINTER_BYTES);
+      if (pStreamLoads == NULL) continue;
+      if (taosHashPut(pHash, &pLoad->streamId, sizeof(int64_t), &pStreamLoads, POINTER_BYTES) != 0) {
+        taosArrayDestroy(pStreamLoads);
+        continue;
+      }
+    }
+    taosArrayPush(pStreamLoads, &pLoad);
+  }
+
+  SSdb       *pSdb = pMnode->pSdb;
+  SStreamObj *pStream = NULL;
+  void       *pIter = NULL;
+  while (taosHashGetSize(pHash) > 0) {
+    pIter = sdbFetch(pSdb, SDB_STREAM, pIter, (void **)&pStream);
+    if (pIter == NULL) break;
+
+    SArray **ppStreamLoads = taosHashGet(pHash, &pStream->uid, sizeof(int64_t));
+    if (ppStreamLoads == NULL) {
+      sdbRelease(pSdb, pStream);
+      continue;
+    }
+
+    SArray *pStreamLoads = *ppStreamLoads;
+    taosRLockLatch(&pStream->lock);
+    for (int32_t i = 0; i < taosArrayGetSize(pStream->tasks); ++i) {
+      SArray *pLevel = taosArrayGetP(pStream->tasks, i);
+      for (int32_t j = 0; j < taosArrayGetSize(pLevel); ++j) {
+        SStreamTask *pTask = taosArrayGetP(pLevel, j);
+        for (int32_t k = 0; k < taosArrayGetSize(pStreamLoads); ++k) {
+          SStreamTaskLoad *pLoad = taosArrayGetP(pStreamLoads, k);
+          if (pLoad->taskId != pTask->taskId) continue;
+
+          STaskExecStatis *pStatis = &pTask->execStatis;
+          pStatis->batchSize = pLoad->batchSize;
+          pStatis->execNum = pLoad->execNum;
+          pStatis->inputItems = pLoad->inputItems;
+          pStatis->outputRows = pLoad->outputRows;
+          pStatis->execTimeUs = pLoad->execTimeUs;
+          pStatis->maxExecUs = pLoad->maxExecUs;
+          break;
+        }
+      }
+    }
+    taosRUnLockLatch(&pStream->lock);
+
+    taosArrayDestroy(pStreamLoads);
+    taosHashRemove(pHash, &pStream->uid, sizeof(int64_t));
+    sdbRelease(pSdb, pStream);
+  }
+  if (pIter != NULL) sdbCancelFetch(pSdb, pIter);
+
+  void *pHashIter = taosHashIterate(pHash, NULL);
+  while (pHashIter != NULL) {
+    taosArrayDestroy(*(SArray **)pHashIter);
+    pHashIter = taosHashIterate(pHash, pHashIter);
+  }
+  taosHashCleanup(pHash);
+}
+
+static const char *mndStreamTaskLevelStr(int8_t level) {
+  switch (level) {
+    case TASK_LEVEL__SOURCE:
+      return "source";
+    case TASK_LEVEL__AGG:
+      return "agg";
+    case TASK_LEVEL__SINK:
+      return "sink";
+    default:
+      return "unknown";
+  }
+}
+
+// The tasks of a stream may not fit in the rows left of a retrieve. The stream at pShow->pIter stays referenced
+// between the retrieves and the next one goes on from its task pShow->curIterPackedRows.
+static int32_t mndRetrieveStreamTask(SRpcMsg *pReq, SShowObj *pShow, SSDataBlock *pBlock, int32_t rows) {
+  SMnode     *pMnode = pReq->info.node;
+  SSdb       *pSdb = pMnode->pSdb;
+  int32_t     numOfRows = 0;
+  SStreamObj *pStream = NULL;
+
+  if (pShow->pIter == NULL) {
+    pShow->pIter = sdbFetch(pSdb, SDB_STREAM, NULL, (void **)&pStream);
+    pShow->curIterPackedRows = 0;
+  }
+
+  while (pShow->pIter != NULL && numOfRows < rows) {
+    pStream = sdbGetRowObj(*(SSdbRow **)pShow->pIter);
+
+    char streamName[TSDB_DB_NAME_LEN + VARSTR_HEADER_SIZE] = {0};
+    STR_WITH_MAXSIZE_TO_VARSTR(streamName, mndGetDbStr(pStream->name), sizeof(streamName));
+
+    int32_t index = 0;
+    bool    done = true;
+    taosRLockLatch(&pStream->lock);
+    for (int32_t i = 0; i < taosArrayGetSize(pStream->tasks) && done; ++i) {
+      SArray *pLevel = taosArrayGetP(pStream->tasks, i);
+      for (int32_t j = 0; j < taosArrayGetSize(pLevel); ++j, ++index) {
+        if (index < pShow->curIterPackedRows) continue;
+        if (numOfRows >= rows) {
+          done = false;
+          break;
+        }
+
+        SStreamTask     *pTask = taosArrayGetP(pLevel, j);
+        STaskExecStatis *pStatis = &pTask->execStatis;
+        SColumnInfoData *pColInfo = NULL;
+        int32_t          cols = 0;
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)streamName, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pTask->taskId, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pTask->nodeId, false);
+
+        char level[20 + VARSTR_HEADER_SIZE] = {0};
+        STR_WITH_MAXSIZE_TO_VARSTR(level, mndStreamTaskLevelStr(pTask->taskLevel), sizeof(level));
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)level, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pStatis->batchSize, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pStatis->execNum, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pStatis->inputItems, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pStatis->outputRows, false);
+
+        int64_t avgLatency = pStatis->execNum > 0 ? pStatis->execTimeUs / pStatis->execNum : 0;
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&avgLatency, false);
+
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&pStatis->maxExecUs, false);
+
+        double throughput = pStatis->execTimeUs > 0 ? pStatis->inputItems * 1000000.0 / pStatis->execTimeUs : 0;
+        pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+        colDataAppend(pColInfo, numOfRows, (const char *)&throughput, false);
+
+        numOfRows++;
+      }
+    }
+    taosRUnLockLatch(&pStream->lock);
+
+    if (!done) {
+      pShow->curIterPackedRows = index;
+      break;
+    }
+
+    SStreamObj *pShown = pStream;
+    pShow->pIter = sdbFetch(pSdb, SDB_STREAM, pShow->pIter, (void **)&pStream);
+    pShow->curIterPackedRows = 0;
+    sdbRelease(pSdb, pShown);
+  }
+
+  pShow->numOfRows += numOfRows;
+  return numOfRows;
+}
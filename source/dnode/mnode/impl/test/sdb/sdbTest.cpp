@@ -1009,3 +1009,194 @@ TEST_F(MndTestSdb, 01_Read_Str) {
   ASSERT_EQ(mnode.insertTimes, 9);
   ASSERT_EQ(mnode.deleteTimes, 9);
 }
+
+static SSdb *deltaOpen(SMnode *pMnode, bool clear) {
+  SSdbOpt opt = {0};
+  opt.pMnode = pMnode;
+  opt.path = TD_TMP_DIR_PATH "mnode_test_sdb_delta";
+  if (clear) taosRemoveDir(opt.path);
+
+  SSdbTable table;
+  memset(&table, 0, sizeof(SSdbTable));
+  table.sdbType = SDB_USER;
+  table.keyType = SDB_KEY_BINARY;
+  table.encodeFp = (SdbEncodeFp)strEncode;
+  table.decodeFp = (SdbDecodeFp)strDecode;
+  table.insertFp = (SdbInsertFp)strInsert;
+  table.updateFp = (SdbUpdateFp)strUpdate;
+  table.deleteFp = (SdbDeleteFp)strDelete;
+
+  SSdb *pSdb = sdbInit(&opt);
+  if (pSdb == NULL) return NULL;
+  pMnode->pSdb = pSdb;
+  sdbSetTable(pSdb, table);
+  if (sdbReadFile(pSdb) != 0) {
+    sdbCleanup(pSdb);
+    return NULL;
+  }
+  return pSdb;
+}
+
+static void deltaPut(SSdb *pSdb, int32_t index, int32_t v32, ESdbStatus status) {
+  SStrObj strObj;
+  strSetDefault(&strObj, index);
+  strObj.v32 = v32;
+  SSdbRaw *pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, status);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+}
+
+// v32 of the row, -1 if it is not there
+static int32_t deltaGet(SSdb *pSdb, int32_t index) {
+  char key[24] = {0};
+  snprintf(key, sizeof(key), "k%d", index * 1000);
+  SStrObj *pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, key);
+  if (pObj == NULL) return -1;
+  int32_t v32 = pObj->v32;
+  sdbRelease(pSdb, pObj);
+  return v32;
+}
+
+static int64_t deltaCommitIndex(SSdb *pSdb) {
+  int64_t index = 0, term = 0, config = 0;
+  sdbGetCommitInfo(pSdb, &index, &term, &config);
+  return index;
+}
+
+TEST_F(MndTestSdb, 02_Delta_Replay) {
+  SMnode mnode = {0};
+  SSdb  *pSdb = deltaOpen(&mnode, true);
+  ASSERT_NE(pSdb, nullptr);
+
+  for (int32_t i = 1; i <= 5; ++i) deltaPut(pSdb, i, i, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 1, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_GT(pSdb->baseSize, 0);
+  ASSERT_EQ(pSdb->deltaSize, 0);
+
+  // only the changed rows and the drops are appended
+  deltaPut(pSdb, 1, 100, SDB_STATUS_READY);
+  deltaPut(pSdb, 2, 0, SDB_STATUS_DROPPED);
+  deltaPut(pSdb, 7, 7, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 2, 1, 1);
+  int64_t baseSize = pSdb->baseSize;
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  EXPECT_EQ(pSdb->baseSize, baseSize);
+  EXPECT_GT(pSdb->deltaSize, 0);
+  EXPECT_LT(pSdb->deltaSize, baseSize);
+
+  deltaPut(pSdb, 7, 70, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 3, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  int64_t deltaSize = pSdb->deltaSize;
+  sdbCleanup(pSdb);
+
+  // a restart replays the checkpoints over the data file
+  pSdb = deltaOpen(&mnode, false);
+  ASSERT_NE(pSdb, nullptr);
+  EXPECT_EQ(deltaCommitIndex(pSdb), 3);
+  EXPECT_EQ(pSdb->deltaSize, deltaSize);
+  EXPECT_EQ(sdbGetSize(pSdb, SDB_USER), 5);
+  EXPECT_EQ(deltaGet(pSdb, 1), 100);
+  EXPECT_EQ(deltaGet(pSdb, 2), -1);
+  EXPECT_EQ(deltaGet(pSdb, 3), 3);
+  EXPECT_EQ(deltaGet(pSdb, 7), 70);
+  sdbCleanup(pSdb);
+}
+
+TEST_F(MndTestSdb, 02_Delta_Torn) {
+  SMnode mnode = {0};
+  SSdb  *pSdb = deltaOpen(&mnode, true);
+  ASSERT_NE(pSdb, nullptr);
+
+  for (int32_t i = 1; i <= 5; ++i) deltaPut(pSdb, i, i, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 1, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  deltaPut(pSdb, 1, 100, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 2, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  int64_t goodSize = pSdb->deltaSize;
+
+  // the last checkpoint is cut by a crash, its rows are dropped with it
+  deltaPut(pSdb, 1, 200, SDB_STATUS_READY);
+  deltaPut(pSdb, 3, 300, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 3, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  int64_t tornSize = pSdb->deltaSize - 5;
+  sdbCleanup(pSdb);
+
+  char file[PATH_MAX] = {0};
+  snprintf(file, sizeof(file), "%s%sdata%ssdb.delta", TD_TMP_DIR_PATH "mnode_test_sdb_delta", TD_DIRSEP, TD_DIRSEP);
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosFtruncateFile(pFile, tornSize), 0);
+  taosCloseFile(&pFile);
+
+  pSdb = deltaOpen(&mnode, false);
+  ASSERT_NE(pSdb, nullptr);
+  EXPECT_EQ(deltaCommitIndex(pSdb), 2);
+  EXPECT_EQ(pSdb->deltaSize, goodSize);
+  EXPECT_EQ(deltaGet(pSdb, 1), 100);
+  EXPECT_EQ(deltaGet(pSdb, 3), 3);
+
+  // the next checkpoint overwrites the torn tail
+  deltaPut(pSdb, 4, 400, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, 4, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  sdbCleanup(pSdb);
+
+  pSdb = deltaOpen(&mnode, false);
+  ASSERT_NE(pSdb, nullptr);
+  EXPECT_EQ(deltaCommitIndex(pSdb), 4);
+  EXPECT_EQ(deltaGet(pSdb, 1), 100);
+  EXPECT_EQ(deltaGet(pSdb, 3), 3);
+  EXPECT_EQ(deltaGet(pSdb, 4), 400);
+  sdbCleanup(pSdb);
+}
+
+TEST_F(MndTestSdb, 02_Delta_Compact) {
+  SMnode mnode = {0};
+  SSdb  *pSdb = deltaOpen(&mnode, true);
+  ASSERT_NE(pSdb, nullptr);
+
+  for (int32_t i = 1; i <= 50; ++i) deltaPut(pSdb, i, i, SDB_STATUS_READY);
+  int64_t index = 1;
+  sdbSetApplyInfo(pSdb, index, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+
+  // once the delta is as large as the data file, a checkpoint rewrites the data file
+  bool compacted = false;
+  for (int32_t round = 0; round < 1000 && !compacted; ++round) {
+    for (int32_t i = 1; i <= 50; ++i) deltaPut(pSdb, i, round * 100 + i, SDB_STATUS_READY);
+    sdbSetApplyInfo(pSdb, ++index, 1, 1);
+    int64_t deltaSize = pSdb->deltaSize;
+    ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+    compacted = pSdb->deltaSize < deltaSize;
+  }
+  ASSERT_TRUE(compacted);
+  EXPECT_EQ(pSdb->deltaSize, 0);
+  int32_t last = deltaGet(pSdb, 50);
+
+  // a snapshot folds the delta into the data file it sends
+  deltaPut(pSdb, 51, 51, SDB_STATUS_READY);
+  sdbSetApplyInfo(pSdb, ++index, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_GT(pSdb->deltaSize, 0);
+
+  SSdbIter *pReader = NULL;
+  int64_t   snapIndex = 0;
+  ASSERT_EQ(sdbStartRead(pSdb, &pReader, &snapIndex, NULL, NULL), 0);
+  EXPECT_EQ(snapIndex, index);
+  EXPECT_EQ(pSdb->deltaSize, 0);
+  sdbStopRead(pSdb, pReader);
+  sdbCleanup(pSdb);
+
+  pSdb = deltaOpen(&mnode, false);
+  ASSERT_NE(pSdb, nullptr);
+  EXPECT_EQ(deltaCommitIndex(pSdb), index);
+  EXPECT_EQ(pSdb->deltaSize, 0);
+  EXPECT_EQ(sdbGetSize(pSdb, SDB_USER), 51);
+  EXPECT_EQ(deltaGet(pSdb, 50), last);
+  EXPECT_EQ(deltaGet(pSdb, 51), 51);
+  sdbCleanup(pSdb);
+}
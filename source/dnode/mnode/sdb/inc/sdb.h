@@ -189,6 +189,10 @@ typedef struct SSdb {
   SdbDeployFp    deployFps[SDB_MAX];
   SdbEncodeFp    encodeFps[SDB_MAX];
   SdbDecodeFp    decodeFps[SDB_MAX];
+  SHashObj      *dirtyObjs[SDB_MAX];  // key -> SSdbRaw* of the drop, NULL if the row is still alive
+  int64_t        baseSize;
+  int64_t        deltaSize;
+  int8_t         deltaBroken;
   TdThreadMutex  filelock;
 } SSdb;
 
@@ -257,7 +261,8 @@ int32_t sdbDeploy(SSdb *pSdb);
 int32_t sdbReadFile(SSdb *pSdb);
 
 /**
- * @brief Write sdb file.
+ * @brief Write sdb file. Only the rows changed since the last checkpoint are appended to sdb.delta, the full
+ * sdb.data is rewritten once the delta grows as large as the data file.
  *
  * @param pSdb The sdb object.
  * @return int32_t 0 for success, -1 for failure.
@@ -390,6 +395,7 @@ int32_t  sdbGetRawTotalSize(SSdbRaw *pRaw);
 SSdbRow *sdbAllocRow(int32_t objSize);
 void    *sdbGetRowObj(SSdbRow *pRow);
 void     sdbFreeRow(SSdb *pSdb, SSdbRow *pRow, bool callFunc);
+void     sdbClearDirty(SSdb *pSdb, int32_t type);
 
 int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *term, int64_t *config);
 int32_t sdbStopRead(SSdb *pSdb, SSdbIter *pIter);
@@ -23,6 +23,11 @@
 #define SDB_RESERVE_SIZE 512
 #define SDB_FILE_VER     1
 
+// sdb.delta holds the rows changed by each checkpoint, closed by a commit record carrying the file head fields
+#define SDB_DELTA_COMMIT     127
+#define SDB_DELTA_COMMIT_LEN ((3 + SDB_TABLE_SIZE * 2) * (int32_t)sizeof(int64_t))
+#define SDB_DELTA_MIN_SIZE   (1024 * 1024)
+
 static int32_t sdbDeployData(SSdb *pSdb) {
   mInfo("start to deploy sdb");
 
@@ -63,6 +68,7 @@ static void sdbResetData(SSdb *pSdb) {
     if (hash == NULL) continue;
 
     taosHashClear(pSdb->hashObjs[i]);
+    sdbClearDirty(pSdb, i);
     pSdb->tableVer[i] = 0;
     pSdb->maxId[i] = 0;
     mInfo("sdb:%s is reset", sdbTableName(i));
@@ -74,6 +80,9 @@ static void sdbResetData(SSdb *pSdb) {
   pSdb->commitIndex = -1;
   pSdb->commitTerm = -1;
   pSdb->commitConfig = -1;
+  pSdb->baseSize = 0;
+  pSdb->deltaSize = 0;
+  pSdb->deltaBroken = 0;
   mInfo("sdb reset success");
 }
 
@@ -222,6 +231,170 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   return 0;
 }
 
+static int32_t sdbWriteRaw(TdFilePtr pFile, SSdbRaw *pRaw, int64_t *pSize) {
+  int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
+  if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, writeLen);
+  if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  *pSize += writeLen + sizeof(int32_t);
+  return 0;
+}
+
+// Return the length of the record read, 0 at the end of file and -1 if the record is incomplete or corrupted.
+static int32_t sdbReadRaw(TdFilePtr pFile, SSdbRaw *pRaw) {
+  int64_t ret = taosReadFile(pFile, pRaw, sizeof(SSdbRaw));
+  if (ret == 0) return 0;
+  if (ret < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  if (ret != sizeof(SSdbRaw) || pRaw->dataLen < 0 || pRaw->dataLen > TSDB_MAX_MSG_SIZE) {
+    terrno = TSDB_CODE_FILE_CORRUPTED;
+    return -1;
+  }
+
+  int32_t readLen = pRaw->dataLen + sizeof(int32_t);
+  ret = taosReadFile(pFile, pRaw->pData, readLen);
+  if (ret < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  if (ret != readLen) {
+    terrno = TSDB_CODE_FILE_CORRUPTED;
+    return -1;
+  }
+
+  int32_t totalLen = sizeof(SSdbRaw) + readLen;
+  if (!taosCheckChecksumWhole((const uint8_t *)pRaw, totalLen)) {
+    terrno = TSDB_CODE_CHECKSUM_ERROR;
+    return -1;
+  }
+
+  return totalLen;
+}
+
+static SSdbRaw *sdbBuildCommitRaw(SSdb *pSdb) {
+  SSdbRaw *pRaw = sdbAllocRaw(SDB_DELTA_COMMIT, SDB_FILE_VER, SDB_DELTA_COMMIT_LEN);
+  if (pRaw == NULL) return NULL;
+
+  int64_t *pData = (int64_t *)pRaw->pData;
+  pData[0] = pSdb->applyIndex;
+  pData[1] = pSdb->applyTerm;
+  pData[2] = pSdb->applyConfig;
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    pData[3 + i] = pSdb->maxId[i];
+    pData[3 + SDB_TABLE_SIZE + i] = pSdb->tableVer[i];
+  }
+
+  return pRaw;
+}
+
+static void sdbClearPending(SArray *pPending) {
+  for (int32_t i = 0; i < taosArrayGetSize(pPending); ++i) {
+    sdbFreeRaw(*(SSdbRaw **)taosArrayGet(pPending, i));
+  }
+  taosArrayClear(pPending);
+}
+
+// The rows of a checkpoint are applied only after its commit record is read, so a checkpoint torn by a crash is
+// dropped as a whole and truncated by the next append. Checkpoints not newer than sdb.data are left by a compaction
+// interrupted before the delta was removed.
+static int32_t sdbReadDeltaFile(SSdb *pSdb, SSdbRaw *pRaw) {
+  int32_t code = 0;
+  int32_t numOfCommits = 0;
+  int64_t offset = 0;
+  int64_t baseIndex = pSdb->applyIndex;
+  char    file[PATH_MAX] = {0};
+
+  snprintf(file, sizeof(file), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+  pSdb->deltaSize = 0;
+
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
+  if (pFile == NULL) {
+    mDebug("no sdb delta file:%s", file);
+    return 0;
+  }
+
+  SArray *pPending = taosArrayInit(64, sizeof(SSdbRaw *));
+  if (pPending == NULL) {
+    taosCloseFile(&pFile);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  while (1) {
+    int32_t len = sdbReadRaw(pFile, pRaw);
+    if (len == 0) break;
+    if (len < 0) {
+      mWarn("sdb delta file:%s is torn at offset:%" PRId64 " since %s", file, pSdb->deltaSize, terrstr());
+      break;
+    }
+    offset += len;
+
+    if (pRaw->type != SDB_DELTA_COMMIT) {
+      int32_t  size = sizeof(SSdbRaw) + pRaw->dataLen;
+      SSdbRaw *pCopy = taosMemoryMalloc(size);
+      if (pCopy == NULL || taosArrayPush(pPending, &pCopy) == NULL) {
+        taosMemoryFree(pCopy);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _OVER;
+      }
+      memcpy(pCopy, pRaw, size);
+      continue;
+    }
+
+    if (pRaw->dataLen != SDB_DELTA_COMMIT_LEN) {
+      mWarn("sdb delta file:%s has invalid commit at offset:%" PRId64, file, pSdb->deltaSize);
+      break;
+    }
+
+    int64_t *pData = (int64_t *)pRaw->pData;
+    if (pData[0] > baseIndex) {
+      for (int32_t i = 0; i < taosArrayGetSize(pPending); ++i) {
+        SSdbRaw *pRow = *(SSdbRaw **)taosArrayGet(pPending, i);
+        code = sdbWriteWithoutFree(pSdb, pRow);
+        if (code == TSDB_CODE_SDB_OBJ_NOT_THERE && pRow->status == SDB_STATUS_DROPPED) {
+          code = 0;
+        }
+        if (code != 0) {
+          mError("failed to read sdb delta file:%s since %s", file, tstrerror(code));
+          goto _OVER;
+        }
+      }
+
+      pSdb->applyIndex = pData[0];
+      pSdb->applyTerm = pData[1];
+      pSdb->applyConfig = pData[2];
+      for (int32_t i = 0; i < SDB_MAX; ++i) {
+        pSdb->maxId[i] = pData[3 + i];
+        pSdb->tableVer[i] = pData[3 + SDB_TABLE_SIZE + i];
+      }
+      numOfCommits++;
+    }
+
+    sdbClearPending(pPending);
+    pSdb->deltaSize = offset;
+  }
+
+  code = 0;
+  mInfo("read sdb delta file:%s success, %d checkpoints applied, apply index:%" PRId64 " size:%" PRId64, file,
+        numOfCommits, pSdb->applyIndex, pSdb->deltaSize);
+
+_OVER:
+  sdbClearPending(pPending);
+  taosArrayDestroy(pPending);
+  taosCloseFile(&pFile);
+
+  terrno = code;
+  return code;
+}
+
 static int32_t sdbReadFileImp(SSdb *pSdb) {
   int64_t offset = 0;
   int32_t code = 0;
@@ -254,6 +427,10 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
     return -1;
   }
 
+  if (taosStatFile(file, &pSdb->baseSize, NULL) != 0) {
+    pSdb->baseSize = 0;
+  }
+
   int64_t tableVer[SDB_MAX] = {0};
   memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
 
@@ -303,10 +480,14 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
   }
 
   code = 0;
+  memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
+
+  code = sdbReadDeltaFile(pSdb, pRaw);
+  if (code != 0) goto _OVER;
+
   pSdb->commitIndex = pSdb->applyIndex;
   pSdb->commitTerm = pSdb->applyTerm;
   pSdb->commitConfig = pSdb->applyConfig;
-  memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
   mInfo("read sdb file:%s success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64, file, pSdb->commitIndex,
         pSdb->commitTerm, pSdb->commitConfig);
 
@@ -328,12 +509,18 @@ int32_t sdbReadFile(SSdb *pSdb) {
     sdbResetData(pSdb);
   }
 
+  // rows loaded from the files are already persisted
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    sdbClearDirty(pSdb, i);
+  }
+
   taosThreadMutexUnlock(&pSdb->filelock);
   return code;
 }
 
 static int32_t sdbWriteFileImp(SSdb *pSdb) {
   int32_t code = 0;
+  int64_t size = 0;
 
   char tmpfile[PATH_MAX] = {0};
   snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data", pSdb->tmpDir, TD_DIRSEP);
@@ -357,6 +544,7 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     taosCloseFile(&pFile);
     return -1;
   }
+  size = taosLSeekFile(pFile, 0, SEEK_CUR);
 
   for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
     SdbEncodeFp encodeFp = pSdb->encodeFps[i];
@@ -386,17 +574,8 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
       SSdbRaw *pRaw = (*encodeFp)(pRow->pObj);
       if (pRaw != NULL) {
         pRaw->status = pRow->status;
-        int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
-        if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
-          code = TAOS_SYSTEM_ERROR(errno);
-          taosHashCancelIterate(hash, ppRow);
-          sdbFreeRaw(pRaw);
-          break;
-        }
-
-        int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, sizeof(SSdbRaw) + pRaw->dataLen);
-        if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
-          code = TAOS_SYSTEM_ERROR(errno);
+        code = sdbWriteRaw(pFile, pRaw, &size);
+        if (code != 0) {
           taosHashCancelIterate(hash, ppRow);
           sdbFreeRaw(pRaw);
           break;
@@ -410,6 +589,9 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
       sdbFreeRaw(pRaw);
       ppRow = taosHashIterate(hash, ppRow);
     }
+    if (code == 0) {
+      sdbClearDirty(pSdb, i);
+    }
     sdbUnLock(pSdb, i);
   }
 
@@ -432,30 +614,148 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
   }
 
   if (code != 0) {
+    pSdb->deltaBroken = 1;
     mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
   } else {
+    // the delta is older than the new file now, a leftover one is skipped when reading
+    char deltafile[PATH_MAX] = {0};
+    snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+    (void)taosRemoveFile(deltafile);
+
+    pSdb->baseSize = size;
+    pSdb->deltaSize = 0;
+    pSdb->deltaBroken = 0;
     pSdb->commitIndex = pSdb->applyIndex;
     pSdb->commitTerm = pSdb->applyTerm;
     pSdb->commitConfig = pSdb->applyConfig;
-    mInfo("write sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " file:%s",
-          pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile);
+    mInfo("write sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " file:%s size:%" PRId64,
+          pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile, size);
   }
 
   terrno = code;
   return code;
 }
 
-int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
+static int32_t sdbWriteDeltaImp(SSdb *pSdb) {
   int32_t code = 0;
-  if (pSdb->applyIndex == pSdb->commitIndex) {
-    return 0;
+  int64_t size = 0;
+  char    file[PATH_MAX] = {0};
+  snprintf(file, sizeof(file), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+
+  mInfo("start to write sdb delta, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
+        " term:%" PRId64 " config:%" PRId64 ", file:%s size:%" PRId64,
+        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
+        file, pSdb->deltaSize);
+
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_CREATE | TD_FILE_WRITE);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb delta file:%s for write since %s", file, terrstr());
+    return -1;
   }
 
-  if (pSdb->applyIndex - pSdb->commitIndex < delta) {
-    return 0;
+  // cut the tail left by a failed checkpoint
+  if (taosFtruncateFile(pFile, pSdb->deltaSize) != 0 || taosLSeekFile(pFile, pSdb->deltaSize, SEEK_SET) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
   }
 
-  taosThreadMutexLock(&pSdb->filelock);
+  for (int32_t i = SDB_MAX - 1; i >= 0 && code == 0; --i) {
+    SdbEncodeFp encodeFp = pSdb->encodeFps[i];
+    SHashObj   *dirty = pSdb->dirtyObjs[i];
+    if (encodeFp == NULL || dirty == NULL) continue;
+
+    int32_t numOfRows = 0;
+    sdbWriteLock(pSdb, i);
+
+    SSdbRaw **ppDrop = taosHashIterate(dirty, NULL);
+    while (ppDrop != NULL) {
+      size_t    keyLen = 0;
+      void     *pKey = taosHashGetKey(ppDrop, &keyLen);
+      SSdbRow **ppRow = taosHashGet(pSdb->hashObjs[i], pKey, keyLen);
+
+      if (ppRow != NULL && *ppRow != NULL) {
+        // creating rows are written again once their transaction changes the status
+        SSdbRow *pRow = *ppRow;
+        if (pRow->status == SDB_STATUS_READY || pRow->status == SDB_STATUS_DROPPING) {
+          SSdbRaw *pRaw = (*encodeFp)(pRow->pObj);
+          if (pRaw != NULL) {
+            pRaw->status = pRow->status;
+            code = sdbWriteRaw(pFile, pRaw, &size);
+            sdbFreeRaw(pRaw);
+          } else {
+            code = TSDB_CODE_SDB_APP_ERROR;
+          }
+          numOfRows++;
+        }
+      } else if (*ppDrop != NULL) {
+        code = sdbWriteRaw(pFile, *ppDrop, &size);
+        numOfRows++;
+      }
+
+      if (code != 0) {
+        taosHashCancelIterate(dirty, ppDrop);
+        break;
+      }
+      ppDrop = taosHashIterate(dirty, ppDrop);
+    }
+
+    if (code == 0) {
+      if (numOfRows > 0) mDebug("write %s to sdb delta, %d changed rows", sdbTableName(i), numOfRows);
+      sdbClearDirty(pSdb, i);
+    }
+    sdbUnLock(pSdb, i);
+  }
+
+  if (code == 0) {
+    SSdbRaw *pCommit = sdbBuildCommitRaw(pSdb);
+    if (pCommit == NULL) {
+      code = terrno;
+    } else {
+      code = sdbWriteRaw(pFile, pCommit, &size);
+      sdbFreeRaw(pCommit);
+    }
+  }
+
+  if (code == 0) {
+    code = taosFsyncFile(pFile);
+    if (code != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+    }
+  }
+
+  taosCloseFile(&pFile);
+
+  if (code != 0) {
+    // the cleared dirty rows are only recovered by a full write
+    pSdb->deltaBroken = 1;
+    mError("failed to write sdb delta file:%s since %s", file, tstrerror(code));
+  } else {
+    pSdb->deltaSize += size;
+    pSdb->commitIndex = pSdb->applyIndex;
+    pSdb->commitTerm = pSdb->applyTerm;
+    pSdb->commitConfig = pSdb->applyConfig;
+    mInfo("write sdb delta success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " size:%" PRId64
+          " total:%" PRId64,
+          pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, size, pSdb->deltaSize);
+  }
+
+  terrno = code;
+  return code;
+}
+
+// Append the changed rows unless the delta is as large as the data file, replaying it would cost more than reading
+// a compacted file.
+static int32_t sdbCheckpointImp(SSdb *pSdb) {
+  if (pSdb->deltaBroken || pSdb->baseSize <= 0 || pSdb->deltaSize >= TMAX(pSdb->baseSize, SDB_DELTA_MIN_SIZE)) {
+    return sdbWriteFileImp(pSdb);
+  }
+  return sdbWriteDeltaImp(pSdb);
+}
+
+// Called with the file lock held. The wal is only trimmed up to what the written files hold, a full write folds the
+// delta into the data file.
+static int32_t sdbDoWriteFile(SSdb *pSdb, bool full) {
+  int32_t code = 0;
   if (pSdb->pWal != NULL) {
     // code = walBeginSnapshot(pSdb->pWal, pSdb->applyIndex);
     if (pSdb->sync == 0) {
@@ -465,7 +765,7 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
     }
   }
   if (code == 0) {
-    code = sdbWriteFileImp(pSdb);
+    code = full ? sdbWriteFileImp(pSdb) : sdbCheckpointImp(pSdb);
   }
   if (code == 0) {
     if (pSdb->pWal != NULL) {
@@ -481,6 +781,20 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
   if (code != 0) {
     mError("failed to write sdb file since %s", terrstr());
   }
+  return code;
+}
+
+int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
+  if (pSdb->applyIndex == pSdb->commitIndex) {
+    return 0;
+  }
+
+  if (pSdb->applyIndex - pSdb->commitIndex < delta) {
+    return 0;
+  }
+
+  taosThreadMutexLock(&pSdb->filelock);
+  int32_t code = sdbDoWriteFile(pSdb, false);
   taosThreadMutexUnlock(&pSdb->filelock);
   return code;
 }
@@ -542,6 +856,14 @@ int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *ter
   snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
 
   taosThreadMutexLock(&pSdb->filelock);
+  // the snapshot is a single data file, fold the delta into it first
+  if (pSdb->deltaSize > 0 && sdbDoWriteFile(pSdb, true) != 0) {
+    taosThreadMutexUnlock(&pSdb->filelock);
+    mError("failed to compact sdb file for snapshot since %s", terrstr());
+    sdbCloseIter(pIter);
+    return -1;
+  }
+
   int64_t commitIndex = pSdb->commitIndex;
   int64_t commitTerm = pSdb->commitTerm;
   int64_t commitConfig = pSdb->commitConfig;
@@ -647,6 +969,10 @@ int32_t sdbStopWrite(SSdb *pSdb, SSdbIter *pIter, bool isApply, int64_t index, i
     return -1;
   }
 
+  char deltafile[PATH_MAX] = {0};
+  snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+  (void)taosRemoveFile(deltafile);
+
   if (sdbReadFile(pSdb) != 0) {
     mError("sdbiter:%p, failed to read from %s since %s", pIter, datafile, terrstr());
     sdbCloseIter(pIter);
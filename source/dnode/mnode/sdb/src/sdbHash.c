@@ -130,6 +130,46 @@ static int32_t sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey) {
   return keySize;
 }
 
+// Called with the table locked. A copy of the drop raw is kept since the row is gone when the checkpoint runs.
+static void sdbMarkDirty(SSdb *pSdb, int32_t type, const void *pKey, int32_t keySize, SSdbRaw *pDropRaw) {
+  SHashObj *dirty = pSdb->dirtyObjs[type];
+  if (dirty == NULL) return;
+
+  SSdbRaw *pCopy = NULL;
+  if (pDropRaw != NULL) {
+    int32_t size = sizeof(SSdbRaw) + pDropRaw->dataLen;
+    pCopy = taosMemoryMalloc(size);
+    if (pCopy == NULL) {
+      pSdb->deltaBroken = 1;
+      return;
+    }
+    memcpy(pCopy, pDropRaw, size);
+  }
+
+  SSdbRaw **ppOld = taosHashGet(dirty, pKey, keySize);
+  if (ppOld != NULL) {
+    sdbFreeRaw(*ppOld);
+  }
+
+  if (taosHashPut(dirty, pKey, keySize, &pCopy, sizeof(void *)) != 0) {
+    sdbFreeRaw(pCopy);
+    if (ppOld != NULL) taosHashRemove(dirty, pKey, keySize);
+    pSdb->deltaBroken = 1;
+  }
+}
+
+void sdbClearDirty(SSdb *pSdb, int32_t type) {
+  SHashObj *dirty = pSdb->dirtyObjs[type];
+  if (dirty == NULL) return;
+
+  SSdbRaw **ppRaw = taosHashIterate(dirty, NULL);
+  while (ppRaw != NULL) {
+    sdbFreeRaw(*ppRaw);
+    ppRaw = taosHashIterate(dirty, ppRaw);
+  }
+  taosHashClear(dirty);
+}
+
 static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *pRow, int32_t keySize) {
   int32_t type = pRow->type;
   sdbWriteLock(pSdb, type);
@@ -167,6 +207,7 @@ static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
     }
   }
 
+  sdbMarkDirty(pSdb, type, pRow->pObj, keySize, NULL);
   sdbUnLock(pSdb, type);
 
   if (pSdb->keyTypes[pRow->type] == SDB_KEY_INT32) {
@@ -193,6 +234,7 @@ static int32_t sdbUpdateRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   SSdbRow *pOldRow = *ppOldRow;
   pOldRow->status = pRaw->status;
   sdbPrintOper(pSdb, pOldRow, "update");
+  sdbMarkDirty(pSdb, type, pOldRow->pObj, keySize, NULL);
   sdbUnLock(pSdb, type);
 
   int32_t     code = 0;
@@ -225,6 +267,7 @@ static int32_t sdbDeleteRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   atomic_add_fetch_32(&pOldRow->refCount, 1);
   sdbPrintOper(pSdb, pOldRow, "delete");
 
+  sdbMarkDirty(pSdb, type, pOldRow->pObj, keySize, pRaw);
   taosHashRemove(hash, pOldRow->pObj, keySize);
   pSdb->tableVer[pOldRow->type]++;
   sdbUnLock(pSdb, type);
@@ -49,6 +49,7 @@ extern const SVnodeCfg vnodeCfgDefault;
 
 int32_t vnodeInit(int32_t nthreads);
 void    vnodeCleanup();
+void    vnodeGetIoStat(SVnodeIoStat *aStat);
 int32_t vnodeCreate(const char *path, SVnodeCfg *pCfg, STfs *pTfs);
 int32_t vnodeAlter(const char *path, SAlterVnodeReplicaReq *pReq, STfs *pTfs);
 void    vnodeDestroy(const char *path, STfs *pTfs);
@@ -76,6 +77,7 @@ int32_t vnodeGetAllCtbNum(SVnode *pVnode, int64_t *num);
 
 void    vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad);
 int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad);
+int32_t vnodeGetStreamTaskLoads(SVnode *pVnode, SArray *pLoads);
 int32_t vnodeValidateTableHash(SVnode *pVnode, char *tableFName);
 
 int32_t vnodePreProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg);
@@ -214,6 +216,7 @@ typedef struct STqReader {
 
   SWalReader *pWalReader;
 
+  SVnode   *pVnode;
   SMeta    *pVnodeMeta;
   SHashObj *tbIdHash;
   SArray   *pColIdList;  // SArray<int16_t>
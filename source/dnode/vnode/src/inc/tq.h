@@ -21,6 +21,7 @@
 #include "executor.h"
 #include "os.h"
 #include "thash.h"
+#include "tlrucache.h"
 #include "tmsg.h"
 #include "tqueue.h"
 #include "trpc.h"
@@ -113,23 +114,38 @@ typedef struct {
 
 } STqHandle;
 
+// recently applied log entries, keyed by version and shared by all readers of the vnode
 typedef struct {
-  SMqDataRsp     dataRsp;
-  char           subKey[TSDB_SUBSCRIBE_KEY_LEN];
+  SLRUCache* pCache;
+  int64_t    hitNum;
+  int64_t    missNum;
+} STqLogCache;
+
+// a poll request parked until new data is applied or the wait expires
+typedef struct {
+  SMqPollReq     pollReq;
   SRpcHandleInfo pInfo;
+  int64_t        expireTs;
 } STqPushEntry;
 
+#define TQ_POLL_MAX_WAIT_MS    5000
+#define TQ_POLL_CHECK_INTERVAL 100
+
 struct STQ {
   SVnode* pVnode;
   char*   path;
 
   SRWLatch pushLock;
 
-  SHashObj* pPushMgr;    // consumerId -> STqPushEntry
+  SHashObj* pPushMgr;    // subKey -> STqPushEntry
+  int64_t   refId;
+  tmr_h     pushTimer;
+  tsem_t    closeSem;
   SHashObj* pHandle;     // subKey -> STqHandle
   SHashObj* pCheckInfo;  // topic -> SAlterCheckInfo
 
   STqOffsetStore* pOffsetStore;
+  STqLogCache*    pLogCache;
 
   TDB* pMetaDB;
   TTB* pExecStore;
@@ -139,8 +155,9 @@ struct STQ {
 };
 
 typedef struct {
-  int8_t inited;
-  tmr_h  timer;
+  int8_t  inited;
+  int32_t rsetId;
+  tmr_h   timer;
 } STqMgmt;
 
 static STqMgmt tqMgmt = {0};
@@ -153,11 +170,23 @@ int32_t tqScanTaosx(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMeta
 int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset);
 int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHead** pHeadWithCkSum);
 
+// tqCache
+STqLogCache* tqLogCacheOpen(int64_t capacity);
+void         tqLogCacheClose(STqLogCache* pCache);
+int32_t      tqLogCachePut(STqLogCache* pCache, int64_t ver, tmsg_t msgType, const void* body, int32_t bodyLen);
+bool         tqLogCacheHas(STqLogCache* pCache, int64_t ver);
+int32_t      tqLogCacheGet(STqLogCache* pCache, int64_t ver, SWalCkHead** ppCkHead, int64_t* pCapacity);
+
 // tqExec
 int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SSubmitReq* pReq, STaosxRsp* pRsp);
 int32_t tqAddBlockDataToRsp(const SSDataBlock* pBlock, SMqDataRsp* pRsp, int32_t numOfCols, int8_t precision);
 int32_t tqSendDataRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq, const SMqDataRsp* pRsp);
-int32_t tqPushDataRsp(STQ* pTq, STqPushEntry* pPushEntry);
+
+// tqPush
+int32_t tqPushRegister(STQ* pTq, const SRpcMsg* pMsg, const STqOffsetVal* pOffset, STqPushEntry** ppOld);
+void    tqPushRedispatch(STQ* pTq, STqPushEntry* pEntry);
+void    tqPushRemove(STQ* pTq, const char* subKey);
+void    tqPushExpire(STQ* pTq);
 
 // tqMeta
 int32_t tqMetaOpen(STQ* pTq);
@@ -52,6 +52,7 @@ typedef struct SDataFile        SDataFile;
 typedef struct SSttFile         SSttFile;
 typedef struct SSmaFile         SSmaFile;
 typedef struct SDFileSet        SDFileSet;
+typedef struct SDFileSetVal     SDFileSetVal;
 typedef struct SDataFWriter     SDataFWriter;
 typedef struct SDataFReader     SDataFReader;
 typedef struct SDelFWriter      SDelFWriter;
@@ -253,6 +254,10 @@ int32_t tsdbFSRef(STsdb *pTsdb, STsdbFS *pFS);
 void    tsdbFSUnref(STsdb *pTsdb, STsdbFS *pFS);
 
 int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet);
+void    tsdbDFileSetToVal(SDFileSet *pSet, SDFileSetVal *pVal);
+void    tsdbDFileSetFromVal(SDFileSetVal *pVal, SDFileSet *pSet);
+bool    tsdbDFileSetSameVal(SDFileSet *pSet, SDFileSetVal *pVal);
+void    tsdbDFileSetRemove(STsdb *pTsdb, SDFileSet *pSet);
 int32_t tsdbFSUpsertDelFile(STsdbFS *pFS, SDelFile *pDelFile);
 // tsdbReaderWriter.c ==============================================================================================
 // SDataFWriter
@@ -266,7 +271,7 @@ int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlock
                            int8_t cmprAlg, int8_t toLast);
 int32_t tsdbWriteDiskData(SDataFWriter *pWriter, const SDiskData *pDiskData, SBlockInfo *pBlkInfo, SSmaInfo *pSmaInfo);
 
-int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo);
+int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo, int8_t ioClass);
 // SDataFReader
 int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet);
 int32_t tsdbDataFReaderClose(SDataFReader **ppReader);
@@ -293,6 +298,9 @@ int32_t tsdbTakeReadSnap(STsdb *pTsdb, STsdbReadSnap **ppSnap, const char *id);
 void    tsdbUntakeReadSnap(STsdb *pTsdb, STsdbReadSnap *pSnap, const char *id);
 // tsdbMerge.c ==============================================================================================
 int32_t tsdbMerge(STsdb *pTsdb);
+// tsdbCompact.c ==============================================================================================
+int32_t tsdbRewriteFSet(STsdb *pTsdb, STsdbFS *pFS, SDFileSet *pSet, SDiskID did, int64_t commitID,
+                        SDFileSetVal *pSetN);
 
 #define TSDB_CACHE_NO(c)       ((c).cacheLast == 0)
 #define TSDB_CACHE_LAST_ROW(c) (((c).cacheLast & 1) > 0)
@@ -323,6 +331,8 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  TdThreadMutex  fsMutex;       // taken over a whole file set change, see tsdbLockFS
+  SHashObj      *pCompactMark;  // fid -> SCompactMark, only touched by the compaction task
 };
 
 struct TSDBKEY {
@@ -365,6 +375,7 @@ struct SMemTable {
   STsdb           *pTsdb;
   SVBufPool       *pPool;
   volatile int32_t nRef;
+  int64_t          commitID;
   TSKEY            minKey;
   TSKEY            maxKey;
   int64_t          nRow;
@@ -565,6 +576,18 @@ struct SDFileSet {
   SSttFile  *aSttF[TSDB_MAX_STT_TRIGGER];
 };
 
+// A file set by value. A background task that reads a set without the file set lock keeps one to tell whether a commit
+// changed the set meanwhile, a file keeps its commit ID when appended to so the sizes are compared too.
+struct SDFileSetVal {
+  SDiskID   diskId;
+  int32_t   fid;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  uint8_t   nSttF;
+  SSttFile  aSttF[TSDB_MAX_STT_TRIGGER];
+};
+
 struct SRowIter {
   TSDBROW  *pRow;
   STSchema *pTSchema;
@@ -615,6 +638,7 @@ struct SDataFWriter {
   SSttFile  fStt[TSDB_MAX_STT_TRIGGER];
 
   uint8_t *aBuf[4];
+  int8_t   ioClass;  // EVndIoClass the written blocks are charged to
 };
 
 struct SDataFReader {
@@ -625,6 +649,7 @@ struct SDataFReader {
   STsdbFD   *pSmaFD;
   STsdbFD   *aSttFD[TSDB_MAX_STT_TRIGGER];
   uint8_t   *aBuf[3];
+  int8_t     ioClass;  // EVndIoClass the read blocks are charged to
 };
 
 typedef struct {
@@ -50,6 +50,13 @@ int32_t vnodeDecodeConfig(const SJson* pJson, void* pObj);
 
 // vnodeModule.c
 int32_t vnodeScheduleTask(int32_t (*execute)(void*), void* arg);
+int32_t vnodeScheduleBgTask(int32_t (*execute)(void*), void* arg);
+
+// vnodeIo.c
+int32_t vnodeIoInit();
+void    vnodeIoCleanup();
+void    vnodeIoForegroundEnter();
+void    vnodeIoForegroundLeave();
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
@@ -65,15 +72,24 @@ struct SVBufPool {
   SVnode*          pVnode;
   volatile int32_t nRef;
   TdThreadSpinlock lock;
-  int64_t          size;
+  int64_t          size;      // bytes handed out
+  int64_t          capacity;  // bytes of chunks borrowed from the dnode budget
+  int64_t          firstTs;   // time of the first allocation, ms
+  bool             frozen;    // handed over to commit, its memory is given back once released
   uint8_t*         ptr;
   SVBufPoolNode*   pTail;
   SVBufPoolNode    node;
 };
 
+int32_t vnodeBufPoolInit();
+void    vnodeBufPoolCleanup();
 int32_t vnodeOpenBufPool(SVnode* pVnode);
 int32_t vnodeCloseBufPool(SVnode* pVnode);
 void    vnodeBufPoolReset(SVBufPool* pPool);
+void    vnodeBufPoolFreeze(SVBufPool* pPool);
+void    vnodeBufPoolCheckBudget(SVnode* pVnode);
+int64_t vnodeBufPoolGetUsed();
+int64_t vnodeBufPoolGetMaxSize(SVnode* pVnode);
 
 // vnodeQuery.c
 int32_t vnodeQueryOpen(SVnode* pVnode);
@@ -81,6 +97,7 @@ void    vnodeQueryClose(SVnode* pVnode);
 int32_t vnodeGetTableMeta(SVnode* pVnode, SRpcMsg* pMsg, bool direct);
 int     vnodeGetTableCfg(SVnode* pVnode, SRpcMsg* pMsg, bool direct);
 int32_t vnodeGetBatchMeta(SVnode* pVnode, SRpcMsg* pMsg);
+int32_t vnodeGetTablesMeta(SVnode* pVnode, SRpcMsg* pMsg);
 
 // vnodeCommit.c
 int32_t vnodeBegin(SVnode* pVnode);
@@ -93,6 +110,9 @@ int32_t vnodeLoadInfo(const char* dir, SVnodeInfo* pInfo);
 int32_t vnodeSyncCommit(SVnode* pVnode);
 int32_t vnodeAsyncCommit(SVnode* pVnode);
 bool    vnodeShouldRollback(SVnode* pVnode);
+void    vnodeStartBgTask(SVnode* pVnode, int64_t compactID);
+void    vnodeStopBgTask(SVnode* pVnode);
+void    vnodeResumeBgTask(SVnode* pVnode);
 
 // vnodeSync.c
 int32_t vnodeSyncOpen(SVnode* pVnode, char* path);
@@ -87,10 +87,11 @@ typedef struct SSnapDataHdr       SSnapDataHdr;
 #define VNODE_RSMA2_DIR "rsma2"
 
 // vnd.h
-void* vnodeBufPoolMalloc(SVBufPool* pPool, int size);
-void  vnodeBufPoolFree(SVBufPool* pPool, void* p);
-void  vnodeBufPoolRef(SVBufPool* pPool);
-void  vnodeBufPoolUnRef(SVBufPool* pPool);
+void*   vnodeBufPoolMalloc(SVBufPool* pPool, int size);
+void    vnodeBufPoolFree(SVBufPool* pPool, void* p);
+void    vnodeBufPoolRef(SVBufPool* pPool);
+void    vnodeBufPoolUnRef(SVBufPool* pPool);
+int32_t vnodeIoAcquire(SVnode* pVnode, int8_t ioClass, int64_t nBytes);
 
 // meta
 typedef struct SMCtbCursor SMCtbCursor;
@@ -106,6 +107,7 @@ int             metaCreateSTable(SMeta* pMeta, int64_t version, SVCreateStbReq*
 int             metaAlterSTable(SMeta* pMeta, int64_t version, SVCreateStbReq* pReq);
 int             metaDropSTable(SMeta* pMeta, int64_t verison, SVDropStbReq* pReq, SArray* tbUidList);
 int             metaCreateTable(SMeta* pMeta, int64_t version, SVCreateTbReq* pReq, STableMetaRsp** pMetaRsp);
+int             metaCreateTableBatch(SMeta* pMeta, int64_t version, SArray* aReq, SArray* aRsp);
 int             metaDropTable(SMeta* pMeta, int64_t version, SVDropTbReq* pReq, SArray* tbUids, int64_t* tbUid);
 int             metaTtlDropTable(SMeta* pMeta, int64_t ttl, SArray* tbUids);
 int             metaAlterTable(SMeta* pMeta, int64_t version, SVAlterTbReq* pReq, STableMetaRsp* pMetaRsp);
@@ -121,6 +123,8 @@ int64_t       metaGetTimeSeriesNum(SMeta* pMeta);
 SMCtbCursor*  metaOpenCtbCursor(SMeta* pMeta, tb_uid_t uid, int lock);
 void          metaCloseCtbCursor(SMCtbCursor* pCtbCur, int lock);
 tb_uid_t      metaCtbCursorNext(SMCtbCursor* pCtbCur);
+int32_t       metaCtbCursorSkip(SMCtbCursor* pCtbCur, tb_uid_t uid);
+int32_t       metaGetCtbUids(SMeta* pMeta, tb_uid_t suid, tb_uid_t lastUid, int32_t limit, SArray* pUids, int8_t* hasMore);
 SMStbCursor*  metaOpenStbCursor(SMeta* pMeta, tb_uid_t uid);
 void          metaCloseStbCursor(SMStbCursor* pStbCur);
 tb_uid_t      metaStbCursorNext(SMStbCursor* pStbCur);
@@ -153,10 +157,14 @@ int32_t metaGetStbStats(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
 int         tsdbOpen(SVnode* pVnode, STsdb** ppTsdb, const char* dir, STsdbKeepCfg* pKeepCfg, int8_t rollback);
 int         tsdbClose(STsdb** pTsdb);
 int32_t     tsdbBegin(STsdb* pTsdb);
+int32_t     tsdbPrepareCommit(STsdb* pTsdb);
 int32_t     tsdbCommit(STsdb* pTsdb);
 int32_t     tsdbFinishCommit(STsdb* pTsdb);
 int32_t     tsdbRollbackCommit(STsdb* pTsdb);
 int32_t     tsdbDoRetention(STsdb* pTsdb, int64_t now);
+int32_t     tsdbCompact(STsdb* pTsdb, int64_t commitID);
+void        tsdbLockFS(STsdb* pTsdb);
+void        tsdbUnlockFS(STsdb* pTsdb);
 int         tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq* pMsg);
 int         tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq* pMsg, SSubmitRsp* pRsp);
 int32_t     tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock,
@@ -170,6 +178,7 @@ void    tqCleanUp();
 STQ*    tqOpen(const char* path, SVnode* pVnode);
 void    tqClose(STQ*);
 int     tqPushMsg(STQ*, void* msg, int32_t msgLen, tmsg_t msgType, int64_t ver);
+void    tqPushReplyAll(STQ* pTq, int32_t code);
 int     tqCommit(STQ*);
 int32_t tqUpdateTbUidList(STQ* pTq, const SArray* tbUidList, bool isAdd);
 int32_t tqCheckColModifiable(STQ* pTq, int64_t tbUid, int32_t colId);
@@ -196,6 +205,7 @@ int32_t tqProcessTaskRecover1Req(STQ* pTq, SRpcMsg* pMsg);
 int32_t tqProcessTaskRecover2Req(STQ* pTq, int64_t version, char* msg, int32_t msgLen);
 int32_t tqProcessTaskRecoverFinishReq(STQ* pTq, SRpcMsg* pMsg);
 int32_t tqProcessTaskRecoverFinishRsp(STQ* pTq, SRpcMsg* pMsg);
+int32_t tqGetStreamTaskLoads(STQ* pTq, SArray* pLoads);
 
 SSubmitReq* tqBlockToSubmit(SVnode* pVnode, const SArray* pBlocks, const STSchema* pSchema,
                             SSchemaWrapper* pTagSchemaWrapper, bool createTb, int64_t suid, const char* stbFullName,
@@ -294,6 +304,7 @@ struct SVState {
   int64_t applyTerm;
   int64_t commitID;
   int64_t commitTerm;
+  int32_t trimTime;  // time of a trim request not done yet, 0 for none, rerun at open
 };
 
 struct SVStatis {
@@ -301,6 +312,10 @@ struct SVStatis {
   int64_t nInsertSuccess;       // delta
   int64_t nBatchInsert;         // delta
   int64_t nBatchInsertSuccess;  // delta
+  int64_t nStallCommit;         // delta, writes blocked by a running commit
+  int64_t stallCommitUs;        // delta
+  int64_t nStallBuffer;         // delta, writes blocked by no free write buffer
+  int64_t stallBufferUs;        // delta
 };
 
 struct SVnodeInfo {
@@ -336,6 +351,8 @@ struct SVnode {
   TdThreadCond  poolNotEmpty;
   SVBufPool*    pPool;
   SVBufPool*    inUse;
+  int64_t       bufUsed;      // bytes of all its memtables, counted in the dnode write buffer budget
+  int64_t       commitAskMs;  // when the dnode last asked it to commit, see vnodeBufPoolCheckBudget
   SMeta*        pMeta;
   SSma*         pSma;
   STsdb*        pTsdb;
@@ -343,6 +360,13 @@ struct SVnode {
   STQ*          pTq;
   SSink*        pSink;
   tsem_t        canCommit;
+  int32_t       commitCode;  // error of a failed commit, the vnode neither commits nor applies writes after it
+  int64_t       stallLogMs;  // last write stall logged, see vnodeLogStall
+  int32_t       nStallNoLog;  // write stalls since then that were not logged
+  int8_t        bgTask;      // the background task is running or scheduled, see vnodeStartBgTask
+  int8_t        bgStop;      // set by vnodeStopBgTask, the background task gives up its moves
+  TdThreadMutex bgMutex;
+  TdThreadCond  bgDone;
   int64_t       sync;
   TdThreadMutex lock;
   bool          blocked;
@@ -32,8 +32,8 @@ int metaBegin(SMeta *pMeta, int8_t fromSys) {
   return 0;
 }
 
-// commit the meta txn
-int metaCommit(SMeta *pMeta) { return tdbCommit(pMeta->pEnv, &pMeta->txn); }
+// commit the meta txn, it is undone at reopen with rollback until metaFinishCommit
+int metaCommit(SMeta *pMeta) { return tdbAsyncCommit(pMeta->pEnv, &pMeta->txn); }
 int metaFinishCommit(SMeta *pMeta) { return tdbPostCommit(pMeta->pEnv, &pMeta->txn); }
 
 // abort the meta txn
@@ -499,6 +499,61 @@ void metaCloseCtbCursor(SMCtbCursor *pCtbCur, int lock) {
   }
 }
 
+// position the cursor after the child table uid, the next metaCtbCursorNext returns the one that follows it
+int32_t metaCtbCursorSkip(SMCtbCursor *pCtbCur, tb_uid_t uid) {
+  SCtbIdxKey ctbIdxKey = {.suid = pCtbCur->suid, .uid = uid};
+  int        c = 0;
+
+  // tdb only moves a clear cursor
+  tdbTbcClose(pCtbCur->pCur);
+  pCtbCur->pCur = NULL;
+  if (tdbTbcOpen(pCtbCur->pMeta->pCtbIdx, &pCtbCur->pCur, NULL) < 0) {
+    return -1;
+  }
+
+  tdbTbcMoveTo(pCtbCur->pCur, &ctbIdxKey, sizeof(ctbIdxKey), &c);
+  if (c >= 0) {
+    tdbTbcMoveToNext(pCtbCur->pCur);
+  }
+
+  return 0;
+}
+
+// up to limit child table uids after lastUid, the lock is held only while the ctb index is walked
+int32_t metaGetCtbUids(SMeta *pMeta, tb_uid_t suid, tb_uid_t lastUid, int32_t limit, SArray *pUids, int8_t *hasMore) {
+  SMCtbCursor *pCur = metaOpenCtbCursor(pMeta, suid, 1);
+  if (pCur == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  if (lastUid != 0 && metaCtbCursorSkip(pCur, lastUid) < 0) {
+    metaCloseCtbCursor(pCur, 1);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  *hasMore = 0;
+  while (1) {
+    tb_uid_t uid = metaCtbCursorNext(pCur);
+    if (uid == 0) break;
+
+    if (taosArrayGetSize(pUids) >= limit) {
+      *hasMore = 1;
+      break;
+    }
+
+    if (taosArrayPush(pUids, &uid) == NULL) {
+      metaCloseCtbCursor(pCur, 1);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  metaCloseCtbCursor(pCur, 1);
+  return 0;
+}
+
 tb_uid_t metaCtbCursorNext(SMCtbCursor *pCtbCur) {
   int         ret;
   SCtbIdxKey *pCtbIdxKey;
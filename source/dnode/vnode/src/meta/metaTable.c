@@ -25,6 +25,7 @@ static int  metaSaveToSkmDb(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateSuidIdx(SMeta *pMeta, const SMetaEntry *pME);
 static int  metaUpdateTagIdx(SMeta *pMeta, const SMetaEntry *pCtbEntry);
+static int  metaHandleEntryBatch(SMeta *pMeta, SMetaEntry *aME, int32_t nME, int upsert);
 static int  metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type);
 static void metaDestroyTagIdxKey(STagIdxKey *pTagIdxKey);
 // opt ins_tables query
@@ -382,14 +383,13 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   return 0;
 }
 
-int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMetaRsp **pMetaRsp) {
-  SMetaEntry  me = {0};
+static int metaValidateCreateTbReq(SMeta *pMeta, SVCreateTbReq *pReq) {
   SMetaReader mr = {0};
 
   // validate message
   if (pReq->type != TSDB_CHILD_TABLE && pReq->type != TSDB_NORMAL_TABLE) {
     terrno = TSDB_CODE_INVALID_MSG;
-    goto _err;
+    return -1;
   }
 
   if (pReq->type == TSDB_CHILD_TABLE) {
@@ -415,18 +415,21 @@ int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMe
   }
   metaReaderClear(&mr);
 
-  // build SMetaEntry
-  me.version = version;
-  me.type = pReq->type;
-  me.uid = pReq->uid;
-  me.name = pReq->name;
-  if (me.type == TSDB_CHILD_TABLE) {
-    me.ctbEntry.ctime = pReq->ctime;
-    me.ctbEntry.ttlDays = pReq->ttl;
-    me.ctbEntry.commentLen = pReq->commentLen;
-    me.ctbEntry.comment = pReq->comment;
-    me.ctbEntry.suid = pReq->ctb.suid;
-    me.ctbEntry.pTags = pReq->ctb.pTag;
+  return 0;
+}
+
+static void metaBuildCreateTbEntry(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, SMetaEntry *pME) {
+  pME->version = version;
+  pME->type = pReq->type;
+  pME->uid = pReq->uid;
+  pME->name = pReq->name;
+  if (pME->type == TSDB_CHILD_TABLE) {
+    pME->ctbEntry.ctime = pReq->ctime;
+    pME->ctbEntry.ttlDays = pReq->ttl;
+    pME->ctbEntry.commentLen = pReq->commentLen;
+    pME->ctbEntry.comment = pReq->comment;
+    pME->ctbEntry.suid = pReq->ctb.suid;
+    pME->ctbEntry.pTags = pReq->ctb.pTag;
 
 #ifdef TAG_FILTER_DEBUG
     SArray *pTagVals = NULL;
@@ -448,36 +451,57 @@ int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMe
       }
     }
 #endif
+  } else {
+    pME->ntbEntry.ctime = pReq->ctime;
+    pME->ntbEntry.ttlDays = pReq->ttl;
+    pME->ntbEntry.commentLen = pReq->commentLen;
+    pME->ntbEntry.comment = pReq->comment;
+    pME->ntbEntry.schemaRow = pReq->ntb.schemaRow;
+    pME->ntbEntry.ncid = pME->ntbEntry.schemaRow.pSchema[pME->ntbEntry.schemaRow.nCols - 1].colId + 1;
+  }
+}
 
+// only the tables that made it into the meta are counted
+static void metaCountCreatedTb(SMeta *pMeta, const SMetaEntry *pME) {
+  if (pME->type == TSDB_CHILD_TABLE) {
     ++pMeta->pVnode->config.vndStats.numOfCTables;
   } else {
-    me.ntbEntry.ctime = pReq->ctime;
-    me.ntbEntry.ttlDays = pReq->ttl;
-    me.ntbEntry.commentLen = pReq->commentLen;
-    me.ntbEntry.comment = pReq->comment;
-    me.ntbEntry.schemaRow = pReq->ntb.schemaRow;
-    me.ntbEntry.ncid = me.ntbEntry.schemaRow.pSchema[me.ntbEntry.schemaRow.nCols - 1].colId + 1;
-
     ++pMeta->pVnode->config.vndStats.numOfNTables;
-    pMeta->pVnode->config.vndStats.numOfNTimeSeries += me.ntbEntry.schemaRow.nCols - 1;
+    pMeta->pVnode->config.vndStats.numOfNTimeSeries += pME->ntbEntry.schemaRow.nCols - 1;
   }
+}
 
-  if (metaHandleEntry(pMeta, &me) < 0) goto _err;
-
-  if (pMetaRsp) {
-    *pMetaRsp = taosMemoryCalloc(1, sizeof(STableMetaRsp));
+static void metaBuildCreateTbRsp(SVCreateTbReq *pReq, STableMetaRsp **pMetaRsp) {
+  if (pMetaRsp == NULL) return;
 
-    if (*pMetaRsp) {
-      if (me.type == TSDB_CHILD_TABLE) {
-        (*pMetaRsp)->tableType = TSDB_CHILD_TABLE;
-        (*pMetaRsp)->tuid = pReq->uid;
-        (*pMetaRsp)->suid = pReq->ctb.suid;
-        strcpy((*pMetaRsp)->tbName, pReq->name);
-      } else {
-        metaUpdateMetaRsp(pReq->uid, pReq->name, &pReq->ntb.schemaRow, *pMetaRsp);
-      }
+  *pMetaRsp = taosMemoryCalloc(1, sizeof(STableMetaRsp));
+  if (*pMetaRsp) {
+    if (pReq->type == TSDB_CHILD_TABLE) {
+      (*pMetaRsp)->tableType = TSDB_CHILD_TABLE;
+      (*pMetaRsp)->tuid = pReq->uid;
+      (*pMetaRsp)->suid = pReq->ctb.suid;
+      strcpy((*pMetaRsp)->tbName, pReq->name);
+    } else {
+      metaUpdateMetaRsp(pReq->uid, pReq->name, &pReq->ntb.schemaRow, *pMetaRsp);
     }
   }
+}
+
+int metaCreateTable(SMeta *pMeta, int64_t version, SVCreateTbReq *pReq, STableMetaRsp **pMetaRsp) {
+  SMetaEntry me = {0};
+
+  if (metaValidateCreateTbReq(pMeta, pReq) < 0) {
+    if (terrno == TSDB_CODE_INVALID_MSG) goto _err;
+    return -1;
+  }
+
+  // build SMetaEntry
+  metaBuildCreateTbEntry(pMeta, version, pReq, &me);
+
+  if (metaHandleEntry(pMeta, &me) < 0) goto _err;
+
+  metaCountCreatedTb(pMeta, &me);
+  metaBuildCreateTbRsp(pReq, pMetaRsp);
 
   metaDebug("vgId:%d, table:%s uid %" PRId64 " is created, type:%" PRId8, TD_VID(pMeta->pVnode), pReq->name, pReq->uid,
             pReq->type);
@@ -489,6 +513,123 @@ _err:
   return -1;
 }
 
+typedef struct SMetaCreateTbItem {
+  SVCreateTbReq            *pReq;
+  SVCreateTbRsp            *pRsp;
+  struct SMetaCreateTbItem *pFirst;  // the request creating the table, if the same table is created before in the batch
+} SMetaCreateTbItem;
+
+static int32_t metaCreateTbItemNameCmpr(const void *p1, const void *p2) {
+  const SMetaCreateTbItem *pItem1 = *(const SMetaCreateTbItem **)p1;
+  const SMetaCreateTbItem *pItem2 = *(const SMetaCreateTbItem **)p2;
+
+  int32_t c = strcmp(pItem1->pReq->name, pItem2->pReq->name);
+  if (c) return c;
+
+  // keep the request order for the same name
+  return (pItem1 < pItem2) ? -1 : ((pItem1 > pItem2) ? 1 : 0);
+}
+
+int metaCreateTableBatch(SMeta *pMeta, int64_t version, SArray *aReq, SArray *aRsp) {
+  int32_t             nReq = taosArrayGetSize(aReq);
+  SMetaCreateTbItem  *aItem = NULL;
+  SMetaCreateTbItem **apItem = NULL;
+  SMetaEntry         *aME = NULL;
+  int32_t            *aMEReq = NULL;  // request of each entry
+  int32_t             nME = 0;
+  int32_t             nCreated = 0;
+  int32_t             code = 0;
+
+  ASSERT(taosArrayGetSize(aRsp) == nReq);
+  if (nReq == 0) return 0;
+
+  aItem = taosMemoryCalloc(nReq, sizeof(SMetaCreateTbItem));
+  apItem = taosMemoryCalloc(nReq, sizeof(SMetaCreateTbItem *));
+  aME = taosMemoryCalloc(nReq, sizeof(SMetaEntry));
+  aMEReq = taosMemoryCalloc(nReq, sizeof(int32_t));
+  if (aItem == NULL || apItem == NULL || aME == NULL || aMEReq == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  // validate each request against the meta
+  for (int32_t iReq = 0; iReq < nReq; iReq++) {
+    aItem[iReq].pReq = *(SVCreateTbReq **)taosArrayGet(aReq, iReq);
+    aItem[iReq].pRsp = *(SVCreateTbRsp **)taosArrayGet(aRsp, iReq);
+    apItem[iReq] = &aItem[iReq];
+
+    if (metaValidateCreateTbReq(pMeta, aItem[iReq].pReq) < 0) {
+      aItem[iReq].pRsp->code = terrno;
+    }
+  }
+
+  // the same table may be created more than once in a batch, only the first one wins, the requests are not changed
+  taosSort(apItem, nReq, sizeof(SMetaCreateTbItem *), metaCreateTbItemNameCmpr);
+  for (int32_t iItem = 1; iItem < nReq; iItem++) {
+    SMetaCreateTbItem *pPrev = apItem[iItem - 1];
+    SMetaCreateTbItem *pItem = apItem[iItem];
+    SMetaCreateTbItem *pFirst = pPrev->pFirst ? pPrev->pFirst : pPrev;
+
+    if (pItem->pRsp->code || pFirst->pRsp->code || strcmp(pFirst->pReq->name, pItem->pReq->name) != 0) continue;
+
+    pItem->pFirst = pFirst;
+    pItem->pRsp->code = TSDB_CODE_TDB_TABLE_ALREADY_EXIST;
+  }
+
+  for (int32_t iReq = 0; iReq < nReq; iReq++) {
+    if (aItem[iReq].pRsp->code) continue;
+    aMEReq[nME] = iReq;
+    metaBuildCreateTbEntry(pMeta, version, aItem[iReq].pReq, &aME[nME++]);
+  }
+
+  // The indexes are loaded one after the other, a failure leaves the tables before it in some of them. Each table is
+  // then written again on its own, over the keys the batch left, so that every request gets its own result.
+  if (nME > 0 && metaHandleEntryBatch(pMeta, aME, nME, 0) < 0) {
+    metaWarn("vgId:%d, failed to create %d tables in batch since %s, create them one by one", TD_VID(pMeta->pVnode),
+             nME, terrstr());
+    for (int32_t iME = 0; iME < nME; iME++) {
+      if (metaHandleEntryBatch(pMeta, &aME[iME], 1, 1) < 0) {
+        aItem[aMEReq[iME]].pRsp->code = terrno ? terrno : TSDB_CODE_FAILED;
+        metaError("vgId:%d, failed to create table:%s since %s", TD_VID(pMeta->pVnode), aME[iME].name, terrstr());
+      }
+    }
+  }
+
+  for (int32_t iME = 0; iME < nME; iME++) {
+    SMetaCreateTbItem *pItem = &aItem[aMEReq[iME]];
+    if (pItem->pRsp->code) continue;
+
+    metaCountCreatedTb(pMeta, &aME[iME]);
+    metaBuildCreateTbRsp(pItem->pReq, &pItem->pRsp->pMeta);
+    nCreated++;
+  }
+
+  // a duplicate is answered with the table the first request created
+  for (int32_t iReq = 0; iReq < nReq; iReq++) {
+    SMetaCreateTbItem *pItem = &aItem[iReq];
+    if (pItem->pFirst == NULL || pItem->pFirst->pRsp->code) continue;
+    metaBuildCreateTbRsp(pItem->pFirst->pReq, &pItem->pRsp->pMeta);
+  }
+
+  metaDebug("vgId:%d, %d tables are created in batch of %d, version:%" PRId64, TD_VID(pMeta->pVnode), nCreated, nReq,
+            version);
+
+_exit:
+  if (code) {
+    for (int32_t iReq = 0; iReq < nReq; iReq++) {
+      SVCreateTbRsp *pRsp = *(SVCreateTbRsp **)taosArrayGet(aRsp, iReq);
+      if (pRsp->code == 0) pRsp->code = code;
+    }
+    metaError("vgId:%d, failed to create %d tables in batch since %s", TD_VID(pMeta->pVnode), nReq, tstrerror(code));
+    terrno = code;
+  }
+  taosMemoryFree(aMEReq);
+  taosMemoryFree(aME);
+  taosMemoryFree(apItem);
+  taosMemoryFree(aItem);
+  return code ? -1 : 0;
+}
+
 int metaDropTable(SMeta *pMeta, int64_t version, SVDropTbReq *pReq, SArray *tbUids, tb_uid_t *tbUid) {
   void    *pData = NULL;
   int      nData = 0;
@@ -1463,6 +1604,229 @@ _err:
   metaULock(pMeta);
   return -1;
 }
+typedef struct {
+  STbDbKey     tbDbKey;
+  void        *pVal;
+  int          vLen;
+  SUidIdxVal   uidIdxVal;
+  SCtbIdxKey   ctbIdxKey;
+  STagIdxKey  *pTagIdxKey;
+  int32_t      nTagIdxKey;
+  SCtimeIdxKey ctimeKey;
+  SNcolIdxKey  ncolKey;
+  STtlIdxKey   ttlKey;
+} SMetaBatchKey;
+
+static int metaBuildBatchTagIdxKeys(SMeta *pMeta, SMetaEntry *aME, SMetaBatchKey *aKey, int32_t nME) {
+  void          *pData = NULL;
+  int            nData = 0;
+  tb_uid_t       suid = 0;
+  SMetaEntry     stbEntry = {0};
+  SDecoder       dc = {0};
+  const SSchema *pTagColumn = NULL;
+  int            ret = 0;
+
+  for (int32_t iME = 0; iME < nME; iME++) {
+    SMetaEntry *pME = &aME[iME];
+    if (pME->type != TSDB_CHILD_TABLE) continue;
+
+    // a batch mostly holds child tables of the same super table, so decode the super table only when it changes
+    if (pTagColumn == NULL || pME->ctbEntry.suid != suid) {
+      STbDbKey tbDbKey = {0};
+
+      tDecoderClear(&dc);
+      pTagColumn = NULL;
+      if (tdbTbGet(pMeta->pUidIdx, &pME->ctbEntry.suid, sizeof(tb_uid_t), &pData, &nData) != 0) {
+        ret = -1;
+        goto _exit;
+      }
+      tbDbKey.uid = pME->ctbEntry.suid;
+      tbDbKey.version = ((SUidIdxVal *)pData)[0].version;
+      tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pData, &nData);
+
+      tDecoderInit(&dc, pData, nData);
+      if (metaDecodeEntry(&dc, &stbEntry) < 0) {
+        ret = -1;
+        goto _exit;
+      }
+      suid = pME->ctbEntry.suid;
+      pTagColumn = &stbEntry.stbEntry.schemaTag.pSchema[0];
+    }
+
+    if (pTagColumn->type == TSDB_DATA_TYPE_JSON) {
+      if (metaSaveJsonVarToIdx(pMeta, pME, pTagColumn) < 0) {
+        ret = -1;
+        goto _exit;
+      }
+      continue;
+    }
+
+    const void *pTagData = NULL;
+    int32_t     nTagData = 0;
+    STagVal     tagVal = {.cid = pTagColumn->colId};
+
+    tTagGet((const STag *)pME->ctbEntry.pTags, &tagVal);
+    if (IS_VAR_DATA_TYPE(pTagColumn->type)) {
+      pTagData = tagVal.pData;
+      nTagData = (int32_t)tagVal.nData;
+    } else {
+      pTagData = &(tagVal.i64);
+      nTagData = tDataTypes[pTagColumn->type].bytes;
+    }
+    if (pTagData == NULL) continue;
+
+    if (metaCreateTagIdxKey(suid, pTagColumn->colId, pTagData, nTagData, pTagColumn->type, pME->uid,
+                            &aKey[iME].pTagIdxKey, &aKey[iME].nTagIdxKey) < 0) {
+      ret = -1;
+      goto _exit;
+    }
+  }
+
+_exit:
+  tDecoderClear(&dc);
+  tdbFree(pData);
+  return ret;
+}
+
+// Same as metaHandleEntry for a batch of child and normal tables. Each index is updated with one bulk load of
+// the sorted keys instead of one random insert per table. With upsert, the keys already there are overwritten.
+static int metaHandleEntryBatch(SMeta *pMeta, SMetaEntry *aME, int32_t nME, int upsert) {
+  SMetaBatchKey *aKey = NULL;
+  STdbKV        *aKV = NULL;
+  int32_t        nKV;
+  int            ret = -1;
+
+  aKey = taosMemoryCalloc(nME, sizeof(SMetaBatchKey));
+  aKV = taosMemoryCalloc(nME, sizeof(STdbKV));
+  if (aKey == NULL || aKV == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  // encode entries and build keys
+  for (int32_t iME = 0; iME < nME; iME++) {
+    SMetaEntry    *pME = &aME[iME];
+    SMetaBatchKey *pKey = &aKey[iME];
+    SEncoder       coder = {0};
+    SMetaInfo      info;
+    int32_t        code = 0;
+
+    ASSERT(pME->type == TSDB_CHILD_TABLE || pME->type == TSDB_NORMAL_TABLE);
+
+    pKey->tbDbKey.version = pME->version;
+    pKey->tbDbKey.uid = pME->uid;
+
+    tEncodeSize(metaEncodeEntry, pME, pKey->vLen, code);
+    if (code < 0) goto _exit;
+    pKey->pVal = taosMemoryMalloc(pKey->vLen);
+    if (pKey->pVal == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    tEncoderInit(&coder, pKey->pVal, pKey->vLen);
+    code = metaEncodeEntry(&coder, pME);
+    tEncoderClear(&coder);
+    if (code < 0) goto _exit;
+
+    metaGetEntryInfo(pME, &info);
+    pKey->uidIdxVal = (SUidIdxVal){.suid = info.suid, .version = info.version, .skmVer = info.skmVer};
+
+    if (pME->type == TSDB_CHILD_TABLE) {
+      pKey->ctbIdxKey = (SCtbIdxKey){.suid = pME->ctbEntry.suid, .uid = pME->uid};
+    }
+    metaBuildCtimeIdxKey(&pKey->ctimeKey, pME);
+    metaBuildNColIdxKey(&pKey->ncolKey, pME);
+    metaBuildTtlIdxKey(&pKey->ttlKey, pME);
+  }
+
+  metaWLock(pMeta);
+
+  if (metaBuildBatchTagIdxKeys(pMeta, aME, aKey, nME) < 0) goto _unlock;
+
+  // table.db
+  for (int32_t iME = 0; iME < nME; iME++) {
+    aKV[iME] = (STdbKV){.pKey = &aKey[iME].tbDbKey, .kLen = sizeof(STbDbKey), .pVal = aKey[iME].pVal,
+                        .vLen = aKey[iME].vLen};
+  }
+  if (tdbTbBulkLoad(pMeta->pTbDb, aKV, nME, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  // uid.idx
+  for (int32_t iME = 0; iME < nME; iME++) {
+    SMetaInfo info;
+    metaGetEntryInfo(&aME[iME], &info);
+    metaCacheUpsert(pMeta, &info);
+
+    aKV[iME] = (STdbKV){.pKey = &aME[iME].uid, .kLen = sizeof(tb_uid_t), .pVal = &aKey[iME].uidIdxVal,
+                        .vLen = sizeof(SUidIdxVal)};
+  }
+  if (tdbTbBulkLoad(pMeta->pUidIdx, aKV, nME, 1, &pMeta->txn) < 0) goto _unlock;
+
+  // name.idx
+  for (int32_t iME = 0; iME < nME; iME++) {
+    aKV[iME] = (STdbKV){.pKey = aME[iME].name, .kLen = strlen(aME[iME].name) + 1, .pVal = &aME[iME].uid,
+                        .vLen = sizeof(tb_uid_t)};
+  }
+  if (tdbTbBulkLoad(pMeta->pNameIdx, aKV, nME, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  // ctb.idx and tag.idx
+  nKV = 0;
+  for (int32_t iME = 0; iME < nME; iME++) {
+    if (aME[iME].type != TSDB_CHILD_TABLE) continue;
+    aKV[nKV++] = (STdbKV){.pKey = &aKey[iME].ctbIdxKey, .kLen = sizeof(SCtbIdxKey), .pVal = aME[iME].ctbEntry.pTags,
+                          .vLen = ((STag *)(aME[iME].ctbEntry.pTags))->len};
+  }
+  if (nKV > 0 && tdbTbBulkLoad(pMeta->pCtbIdx, aKV, nKV, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  nKV = 0;
+  for (int32_t iME = 0; iME < nME; iME++) {
+    if (aKey[iME].pTagIdxKey == NULL) continue;
+    aKV[nKV++] = (STdbKV){.pKey = aKey[iME].pTagIdxKey, .kLen = aKey[iME].nTagIdxKey, .pVal = NULL, .vLen = 0};
+  }
+  if (nKV > 0 && tdbTbBulkLoad(pMeta->pTagIdx, aKV, nKV, 1, &pMeta->txn) < 0) goto _unlock;
+
+  // schema.db
+  for (int32_t iME = 0; iME < nME; iME++) {
+    if (aME[iME].type != TSDB_NORMAL_TABLE) continue;
+    if (metaSaveToSkmDb(pMeta, &aME[iME]) < 0) goto _unlock;
+  }
+
+  // ctime.idx
+  for (int32_t iME = 0; iME < nME; iME++) {
+    aKV[iME] = (STdbKV){.pKey = &aKey[iME].ctimeKey, .kLen = sizeof(SCtimeIdxKey), .pVal = NULL, .vLen = 0};
+  }
+  if (tdbTbBulkLoad(pMeta->pCtimeIdx, aKV, nME, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  // ncol.idx
+  nKV = 0;
+  for (int32_t iME = 0; iME < nME; iME++) {
+    if (aME[iME].type != TSDB_NORMAL_TABLE) continue;
+    aKV[nKV++] = (STdbKV){.pKey = &aKey[iME].ncolKey, .kLen = sizeof(SNcolIdxKey), .pVal = NULL, .vLen = 0};
+  }
+  if (nKV > 0 && tdbTbBulkLoad(pMeta->pNcolIdx, aKV, nKV, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  // ttl.idx
+  nKV = 0;
+  for (int32_t iME = 0; iME < nME; iME++) {
+    if (aKey[iME].ttlKey.dtime == 0) continue;
+    aKV[nKV++] = (STdbKV){.pKey = &aKey[iME].ttlKey, .kLen = sizeof(STtlIdxKey), .pVal = NULL, .vLen = 0};
+  }
+  if (nKV > 0 && tdbTbBulkLoad(pMeta->pTtlIdx, aKV, nKV, upsert, &pMeta->txn) < 0) goto _unlock;
+
+  ret = 0;
+
+_unlock:
+  metaULock(pMeta);
+
+_exit:
+  for (int32_t iME = 0; aKey && iME < nME; iME++) {
+    taosMemoryFree(aKey[iME].pVal);
+    metaDestroyTagIdxKey(aKey[iME].pTagIdxKey);
+  }
+  taosMemoryFree(aKV);
+  taosMemoryFree(aKey);
+  return ret;
+}
+
 // refactor later
 void *metaGetIdx(SMeta *pMeta) { return pMeta->pTagIdx; }
 void *metaGetIvtIdx(SMeta *pMeta) { return pMeta->pTagIvtIdx; }
@@ -15,6 +15,22 @@
 
 #include "tq.h"
 
+// STQ is only referenced by the push timer, the last release lets tqClose go on
+static void tqRefFree(void* param) {
+  STQ* pTq = param;
+  tsem_post(&pTq->closeSem);
+}
+
+static void tqPushTimerFn(void* param, void* tmrId) {
+  int64_t refId = (int64_t)param;
+  STQ*    pTq = taosAcquireRef(tqMgmt.rsetId, refId);
+  if (pTq == NULL) return;
+
+  tqPushExpire(pTq);
+  taosTmrReset(tqPushTimerFn, TQ_POLL_CHECK_INTERVAL, param, tqMgmt.timer, &pTq->pushTimer);
+  taosReleaseRef(tqMgmt.rsetId, refId);
+}
+
 int32_t tqInit() {
   int8_t old;
   while (1) {
@@ -31,6 +47,10 @@ int32_t tqInit() {
     if (streamInit() < 0) {
       return -1;
     }
+    tqMgmt.rsetId = taosOpenRef(10000, tqRefFree);
+    if (tqMgmt.rsetId < 0) {
+      return -1;
+    }
     atomic_store_8(&tqMgmt.inited, 1);
   }
 
@@ -45,6 +65,7 @@ void tqCleanUp() {
   }
 
   if (old == 1) {
+    taosCloseRef(tqMgmt.rsetId);
     taosTmrCleanUp(tqMgmt.timer);
     streamCleanUp();
     atomic_store_8(&tqMgmt.inited, 0);
@@ -65,11 +86,6 @@ static void destroySTqHandle(void* data) {
   }
 }
 
-static void tqPushEntryFree(void* data) {
-  STqPushEntry* p = *(void**)data;
-  taosMemoryFree(p);
-}
-
 STQ* tqOpen(const char* path, SVnode* pVnode) {
   STQ* pTq = taosMemoryCalloc(1, sizeof(STQ));
   if (pTq == NULL) {
@@ -84,8 +100,11 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
   taosHashSetFreeFp(pTq->pHandle, destroySTqHandle);
 
   taosInitRWLatch(&pTq->pushLock);
-  pTq->pPushMgr = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
-  taosHashSetFreeFp(pTq->pPushMgr, tqPushEntryFree);
+  pTq->pPushMgr = taosHashInit(64, MurmurHash3_32, true, HASH_NO_LOCK);
+
+  tsem_init(&pTq->closeSem, 0, 0);
+  pTq->refId = taosAddRef(tqMgmt.rsetId, pTq);
+  pTq->pushTimer = taosTmrStart(tqPushTimerFn, TQ_POLL_CHECK_INTERVAL, (void*)pTq->refId, tqMgmt.timer);
 
   pTq->pCheckInfo = taosHashInit(64, MurmurHash3_32, true, HASH_ENTRY_LOCK);
 
@@ -98,6 +117,8 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
     ASSERT(0);
   }
 
+  pTq->pLogCache = tqLogCacheOpen((int64_t)tsTqLogCacheSize * 1024 * 1024);
+
   pTq->pStreamMeta = streamMetaOpen(path, pTq, (FTaskExpand*)tqExpandTask, pTq->pVnode->config.vgId);
   if (pTq->pStreamMeta == NULL) {
     ASSERT(0);
@@ -112,6 +133,12 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
 
 void tqClose(STQ* pTq) {
   if (pTq) {
+    taosTmrStopA(&pTq->pushTimer);
+    if (taosRemoveRef(tqMgmt.rsetId, pTq->refId) == 0) {
+      tsem_wait(&pTq->closeSem);
+    }
+    tsem_destroy(&pTq->closeSem);
+    tqPushReplyAll(pTq, TSDB_CODE_VND_IS_CLOSING);
     tqOffsetClose(pTq->pOffsetStore);
     taosHashCleanup(pTq->pHandle);
     taosHashCleanup(pTq->pPushMgr);
@@ -119,6 +146,7 @@ void tqClose(STQ* pTq) {
     taosMemoryFree(pTq->path);
     tqMetaClose(pTq);
     streamMetaClose(pTq->pStreamMeta);
+    tqLogCacheClose(pTq->pLogCache);
     taosMemoryFree(pTq);
   }
 }
@@ -161,65 +189,6 @@ int32_t tqSendMetaPollRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq,
   return 0;
 }
 
-int32_t tqPushDataRsp(STQ* pTq, STqPushEntry* pPushEntry) {
-  SMqDataRsp* pRsp = &pPushEntry->dataRsp;
-
-  ASSERT(taosArrayGetSize(pRsp->blockData) == pRsp->blockNum);
-  ASSERT(taosArrayGetSize(pRsp->blockDataLen) == pRsp->blockNum);
-
-  ASSERT(!pRsp->withSchema);
-  ASSERT(taosArrayGetSize(pRsp->blockSchema) == 0);
-
-  if (pRsp->reqOffset.type == TMQ_OFFSET__LOG) {
-    /*if (pRsp->blockNum > 0) {*/
-    /*ASSERT(pRsp->rspOffset.version > pRsp->reqOffset.version);*/
-    /*} else {*/
-    ASSERT(pRsp->rspOffset.version > pRsp->reqOffset.version);
-    /*}*/
-  }
-
-  int32_t len = 0;
-  int32_t code = 0;
-  tEncodeSize(tEncodeSMqDataRsp, pRsp, len, code);
-
-  if (code < 0) {
-    return -1;
-  }
-
-  int32_t tlen = sizeof(SMqRspHead) + len;
-  void*   buf = rpcMallocCont(tlen);
-  if (buf == NULL) {
-    return -1;
-  }
-
-  memcpy(buf, &pPushEntry->dataRsp.head, sizeof(SMqRspHead));
-
-  void* abuf = POINTER_SHIFT(buf, sizeof(SMqRspHead));
-
-  SEncoder encoder = {0};
-  tEncoderInit(&encoder, abuf, len);
-  tEncodeSMqDataRsp(&encoder, pRsp);
-  tEncoderClear(&encoder);
-
-  SRpcMsg rsp = {
-      .info = pPushEntry->pInfo,
-      .pCont = buf,
-      .contLen = tlen,
-      .code = 0,
-  };
-
-  tmsgSendRsp(&rsp);
-
-  char buf1[80] = {0};
-  char buf2[80] = {0};
-  tFormatOffset(buf1, 80, &pRsp->reqOffset);
-  tFormatOffset(buf2, 80, &pRsp->rspOffset);
-  tqDebug("vgId:%d, from consumer:%" PRId64 ", (epoch %d) push rsp, block num: %d, reqOffset:%s, rspOffset:%s",
-          TD_VID(pTq->pVnode), pRsp->head.consumerId, pRsp->head.epoch, pRsp->blockNum, buf1, buf2);
-
-  return 0;
-}
-
 int32_t tqSendDataRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq, const SMqDataRsp* pRsp) {
   ASSERT(taosArrayGetSize(pRsp->blockData) == pRsp->blockNum);
   ASSERT(taosArrayGetSize(pRsp->blockDataLen) == pRsp->blockNum);
@@ -552,31 +521,23 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
     SMqDataRsp dataRsp = {0};
     tqInitDataRsp(&dataRsp, pReq, pHandle->execHandle.subType);
     // lock
+    STqPushEntry* pOld = NULL;
     taosWLockLatch(&pTq->pushLock);
     tqScanData(pTq, pHandle, &dataRsp, &fetchOffsetNew);
 
-#if 1
     if (dataRsp.blockNum == 0 && dataRsp.reqOffset.type == TMQ_OFFSET__LOG &&
-        dataRsp.reqOffset.version == dataRsp.rspOffset.version) {
-      STqPushEntry* pPushEntry = taosMemoryCalloc(1, sizeof(STqPushEntry));
-      if (pPushEntry != NULL) {
-        pPushEntry->pInfo = pMsg->info;
-        memcpy(pPushEntry->subKey, pHandle->subKey, TSDB_SUBSCRIBE_KEY_LEN);
-        dataRsp.withTbName = 0;
-        memcpy(&pPushEntry->dataRsp, &dataRsp, sizeof(SMqDataRsp));
-        pPushEntry->dataRsp.head.consumerId = consumerId;
-        pPushEntry->dataRsp.head.epoch = reqEpoch;
-        pPushEntry->dataRsp.head.mqMsgType = TMQ_MSG_TYPE__POLL_RSP;
-        taosHashPut(pTq->pPushMgr, pHandle->subKey, strlen(pHandle->subKey) + 1, &pPushEntry, sizeof(void*));
+        dataRsp.reqOffset.version == dataRsp.rspOffset.version && pReq->timeout != 0) {
+      if (tqPushRegister(pTq, pMsg, &dataRsp.rspOffset, &pOld) == 0) {
         tqDebug("tmq poll: consumer %" PRId64 ", subkey %s, vg %d save handle to push mgr", consumerId, pHandle->subKey,
                 TD_VID(pTq->pVnode));
-        // unlock
         taosWUnLockLatch(&pTq->pushLock);
+        tqPushRedispatch(pTq, pOld);
+        tDeleteSMqDataRsp(&dataRsp);
         return 0;
       }
     }
     taosWUnLockLatch(&pTq->pushLock);
-#endif
+    tqPushRedispatch(pTq, pOld);
 
     if (tqSendDataRsp(pTq, pMsg, pReq, &dataRsp) < 0) {
       code = -1;
@@ -652,6 +613,25 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
 
       if (tqFetchLog(pTq, pHandle, &fetchVer, &pCkHead) < 0) {
         tqOffsetResetToLog(&taosxRsp.rspOffset, fetchVer);
+        // park the poll unless something was applied after the scan, the push path wakes it up under the same lock
+        if (pReq->timeout != 0 && taosxRsp.blockNum == 0) {
+          STqPushEntry* pOld = NULL;
+          taosWLockLatch(&pTq->pushLock);
+          code = -1;
+          if (walGetAppliedVer(pTq->pVnode->pWal) <= fetchVer) {
+            code = tqPushRegister(pTq, pMsg, &taosxRsp.rspOffset, &pOld);
+          }
+          taosWUnLockLatch(&pTq->pushLock);
+          tqPushRedispatch(pTq, pOld);
+          if (code == 0) {
+            tqDebug("tmq poll: consumer %" PRId64 ", subkey %s, vg %d save handle to push mgr", consumerId,
+                    pHandle->subKey, TD_VID(pTq->pVnode));
+            tDeleteSTaosxRsp(&taosxRsp);
+            taosMemoryFreeClear(pCkHead);
+            return 0;
+          }
+          code = 0;
+        }
         if (tqSendTaosxRsp(pTq, pMsg, pReq, &taosxRsp) < 0) {
           code = -1;
         }
@@ -712,14 +692,9 @@ int32_t tqProcessPollReq(STQ* pTq, SRpcMsg* pMsg) {
 int32_t tqProcessDeleteSubReq(STQ* pTq, int64_t version, char* msg, int32_t msgLen) {
   SMqVDeleteReq* pReq = (SMqVDeleteReq*)msg;
 
-  taosWLockLatch(&pTq->pushLock);
-  int32_t code = taosHashRemove(pTq->pPushMgr, pReq->subKey, strlen(pReq->subKey));
-  if (code != 0) {
-    tqDebug("vgId:%d, tq remove push handle %s", pTq->pVnode->config.vgId, pReq->subKey);
-  }
-  taosWUnLockLatch(&pTq->pushLock);
+  tqPushRemove(pTq, pReq->subKey);
 
-  code = taosHashRemove(pTq->pHandle, pReq->subKey, strlen(pReq->subKey));
+  int32_t code = taosHashRemove(pTq->pHandle, pReq->subKey, strlen(pReq->subKey));
   if (code != 0) {
     tqError("cannot process tq delete req %s, since no such handle", pReq->subKey);
   }
@@ -864,6 +839,8 @@ int32_t tqProcessSubscribeReq(STQ* pTq, int64_t version, char* msg, int32_t msgL
     atomic_store_32(&pHandle->epoch, -1);
     atomic_store_64(&pHandle->consumerId, req.newConsumerId);
     atomic_add_fetch_32(&pHandle->epoch, 1);
+    // answer the poll parked by the previous consumer
+    tqPushRemove(pTq, req.subKey);
     if (tqMetaSaveHandle(pTq, req.subKey, pHandle) < 0) {
       // TODO
       ASSERT(0);
@@ -1136,6 +1113,8 @@ int32_t tqProcessTaskRecoverFinishRsp(STQ* pTq, SRpcMsg* pMsg) {
   return 0;
 }
 
+int32_t tqGetStreamTaskLoads(STQ* pTq, SArray* pLoads) { return streamMetaGetTaskLoads(pTq->pStreamMeta, pLoads); }
+
 int32_t tqProcessDelReq(STQ* pTq, void* pReq, int32_t len, int64_t ver) {
   bool        failed = false;
   SDecoder*   pCoder = &(SDecoder){0};
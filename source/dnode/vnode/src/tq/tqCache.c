@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tq.h"
+
+static void tqLogCacheDeleteEntry(const void* key, size_t keyLen, void* value) { taosMemoryFree(value); }
+
+STqLogCache* tqLogCacheOpen(int64_t capacity) {
+  if (capacity <= 0) return NULL;
+
+  STqLogCache* pCache = taosMemoryCalloc(1, sizeof(STqLogCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pCache->pCache = taosLRUCacheInit(capacity, -1, .5);
+  if (pCache->pCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    taosMemoryFree(pCache);
+    return NULL;
+  }
+  taosLRUCacheSetStrictCapacity(pCache->pCache, false);
+
+  return pCache;
+}
+
+void tqLogCacheClose(STqLogCache* pCache) {
+  if (pCache == NULL) return;
+
+  tqDebug("tq log cache closed, hit:%" PRId64 ", miss:%" PRId64 ", usage:%" PRIzu, pCache->hitNum, pCache->missNum,
+          taosLRUCacheGetUsage(pCache->pCache));
+  taosLRUCacheEraseUnrefEntries(pCache->pCache);
+  taosLRUCacheCleanup(pCache->pCache);
+  taosMemoryFree(pCache);
+}
+
+// Only submit and meta bodies are kept, other entries are cached head only so that readers can skip them.
+int32_t tqLogCachePut(STqLogCache* pCache, int64_t ver, tmsg_t msgType, const void* body, int32_t bodyLen) {
+  if (pCache == NULL) return 0;
+
+  int32_t keepLen = (msgType == TDMT_VND_SUBMIT || IS_META_MSG(msgType)) ? bodyLen : 0;
+  int32_t size = sizeof(SWalCkHead) + keepLen;
+
+  SWalCkHead* pCkHead = taosMemoryCalloc(1, size);
+  if (pCkHead == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  pCkHead->head.version = ver;
+  pCkHead->head.ingestTs = taosGetTimestampUs();
+  pCkHead->head.msgType = msgType;
+  pCkHead->head.bodyLen = keepLen;
+  if (keepLen > 0) memcpy(pCkHead->head.body, body, keepLen);
+
+  LRUStatus status = taosLRUCacheInsert(pCache->pCache, &ver, sizeof(int64_t), pCkHead, size, tqLogCacheDeleteEntry,
+                                        NULL, TAOS_LRU_PRIORITY_LOW);
+  if (status == TAOS_LRU_STATUS_FAIL) {
+    taosMemoryFree(pCkHead);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+bool tqLogCacheHas(STqLogCache* pCache, int64_t ver) {
+  if (pCache == NULL) return false;
+
+  LRUHandle* h = taosLRUCacheLookup(pCache->pCache, &ver, sizeof(int64_t));
+  if (h == NULL) return false;
+
+  taosLRUCacheRelease(pCache->pCache, h, false);
+  return true;
+}
+
+// Copy the entry of ver into *ppCkHead, growing the buffer if its body capacity is too small. The entry never left
+// memory, so it is not checked against the wal checksums as a read from the wal is.
+int32_t tqLogCacheGet(STqLogCache* pCache, int64_t ver, SWalCkHead** ppCkHead, int64_t* pCapacity) {
+  if (pCache == NULL) return -1;
+
+  LRUHandle* h = taosLRUCacheLookup(pCache->pCache, &ver, sizeof(int64_t));
+  if (h == NULL) {
+    atomic_add_fetch_64(&pCache->missNum, 1);
+    return -1;
+  }
+
+  SWalCkHead* pEntry = (SWalCkHead*)taosLRUCacheValue(pCache->pCache, h);
+  int32_t     bodyLen = pEntry->head.bodyLen;
+  if (*pCapacity < bodyLen) {
+    SWalCkHead* ptr = taosMemoryRealloc(*ppCkHead, sizeof(SWalCkHead) + bodyLen);
+    if (ptr == NULL) {
+      taosLRUCacheRelease(pCache->pCache, h, false);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    *ppCkHead = ptr;
+    *pCapacity = bodyLen;
+  }
+  memcpy(*ppCkHead, pEntry, sizeof(SWalCkHead) + bodyLen);
+  taosLRUCacheRelease(pCache->pCache, h, false);
+
+  atomic_add_fetch_64(&pCache->hitNum, 1);
+  return 0;
+}
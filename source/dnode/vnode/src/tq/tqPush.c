@@ -212,99 +212,246 @@ int32_t tqPushMsgNew(STQ* pTq, void* msg, int32_t msgLen, tmsg_t msgType, int64_
 }
 #endif
 
-int tqPushMsg(STQ* pTq, void* msg, int32_t msgLen, tmsg_t msgType, int64_t ver) {
-  tqDebug("vgId:%d, tq push msg ver %" PRId64 ", type: %s", pTq->pVnode->config.vgId, ver, TMSG_INFO(msgType));
+// Hand the parked poll back to the fetch queue, where it is executed again as a fresh request.
+static void tqPushEntryDispatch(STQ* pTq, const STqPushEntry* pEntry, int64_t timeout) {
+  SMqPollReq* pReq = rpcMallocCont(sizeof(SMqPollReq));
+  if (pReq != NULL) {
+    memcpy(pReq, &pEntry->pollReq, sizeof(SMqPollReq));
+    pReq->head.vgId = TD_VID(pTq->pVnode);
+    pReq->head.contLen = sizeof(SMqPollReq);
+    pReq->timeout = timeout;
+
+    SRpcMsg msg = {
+        .msgType = TDMT_VND_TMQ_CONSUME,
+        .pCont = pReq,
+        .contLen = sizeof(SMqPollReq),
+        .info = pEntry->pInfo,
+    };
+    if (tmsgPutToQueue(&pTq->pVnode->msgCb, FETCH_QUEUE, &msg) == 0) {
+      return;
+    }
+  } else {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-  if (msgType == TDMT_VND_SUBMIT) {
-    // lock push mgr to avoid potential msg lost
-    taosWLockLatch(&pTq->pushLock);
-    tqDebug("vgId:%d, push handle num %d", pTq->pVnode->config.vgId, taosHashGetSize(pTq->pPushMgr));
-    if (taosHashGetSize(pTq->pPushMgr) != 0) {
-      SArray* cachedKeys = taosArrayInit(0, sizeof(void*));
-      SArray* cachedKeyLens = taosArrayInit(0, sizeof(size_t));
-      void*   data = taosMemoryMalloc(msgLen);
-      if (data == NULL) {
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
-        tqError("failed to copy data for stream since out of memory");
-        taosArrayDestroyP(cachedKeys, (FDelete)taosMemoryFree);
-        taosArrayDestroy(cachedKeyLens);
-        return -1;
-      }
-      memcpy(data, msg, msgLen);
-      SSubmitReq* pReq = (SSubmitReq*)data;
-      pReq->version = ver;
+  tqError("vgId:%d, consumer:%" PRId64 ", subkey %s, failed to dispatch parked poll since %s", TD_VID(pTq->pVnode),
+          pEntry->pollReq.consumerId, pEntry->pollReq.subKey, terrstr());
+  SRpcMsg rsp = {.info = pEntry->pInfo, .code = terrno != 0 ? terrno : TSDB_CODE_OUT_OF_MEMORY};
+  tmsgSendRsp(&rsp);
+}
 
-      void* pIter = NULL;
-      while (1) {
-        pIter = taosHashIterate(pTq->pPushMgr, pIter);
-        if (pIter == NULL) break;
-        STqPushEntry* pPushEntry = *(STqPushEntry**)pIter;
-
-        STqHandle* pHandle = taosHashGet(pTq->pHandle, pPushEntry->subKey, strlen(pPushEntry->subKey));
-        if (pHandle == NULL) {
-          tqDebug("vgId:%d, cannot find handle %s", pTq->pVnode->config.vgId, pPushEntry->subKey);
-          continue;
-        }
-        if (pPushEntry->dataRsp.reqOffset.version >= ver) {
-          tqDebug("vgId:%d, push entry req version %" PRId64 ", while push version %" PRId64 ", skip",
-                  pTq->pVnode->config.vgId, pPushEntry->dataRsp.reqOffset.version, ver);
-          continue;
-        }
-        STqExecHandle* pExec = &pHandle->execHandle;
-        qTaskInfo_t    task = pExec->task;
-
-        SMqDataRsp* pRsp = &pPushEntry->dataRsp;
-
-        // prepare scan mem data
-        qStreamScanMemData(task, pReq);
-
-        // exec
-        while (1) {
-          SSDataBlock* pDataBlock = NULL;
-          uint64_t     ts = 0;
-          if (qExecTask(task, &pDataBlock, &ts) < 0) {
-            ASSERT(0);
-          }
-
-          if (pDataBlock == NULL) {
-            break;
-          }
-
-          tqAddBlockDataToRsp(pDataBlock, pRsp, pExec->numOfCols, pTq->pVnode->config.tsdbCfg.precision);
-          pRsp->blockNum++;
-        }
-
-        tqDebug("vgId:%d, tq handle push, subkey: %s, block num: %d", pTq->pVnode->config.vgId, pPushEntry->subKey,
-                pRsp->blockNum);
-        if (pRsp->blockNum > 0) {
-          // set offset
-          tqOffsetResetToLog(&pRsp->rspOffset, ver);
-          // remove from hash
-          size_t kLen;
-          void*  key = taosHashGetKey(pIter, &kLen);
-          void*  keyCopy = taosMemoryMalloc(kLen);
-          memcpy(keyCopy, key, kLen);
-
-          taosArrayPush(cachedKeys, &keyCopy);
-          taosArrayPush(cachedKeyLens, &kLen);
-
-          tqPushDataRsp(pTq, pPushEntry);
-        }
-      }
-      // delete entry
-      for (int32_t i = 0; i < taosArrayGetSize(cachedKeys); i++) {
-        void*  key = taosArrayGetP(cachedKeys, i);
-        size_t kLen = *(size_t*)taosArrayGet(cachedKeyLens, i);
-        if (taosHashRemove(pTq->pPushMgr, key, kLen) != 0) {
-          ASSERT(0);
-        }
-      }
-      taosArrayDestroyP(cachedKeys, (FDelete)taosMemoryFree);
-      taosArrayDestroy(cachedKeyLens);
-      taosMemoryFree(data);
+// The entries are taken out of pPushMgr under pushLock and sent after it is released, they are owned by the caller
+// from then on.
+static void tqPushEntryDispatchAll(STQ* pTq, SArray* pEntries, bool keepWait) {
+  int64_t now = taosGetTimestampMs();
+  for (int32_t i = 0; i < taosArrayGetSize(pEntries); i++) {
+    STqPushEntry* pEntry = taosArrayGetP(pEntries, i);
+    tqPushEntryDispatch(pTq, pEntry, keepWait ? TMAX(pEntry->expireTs - now, 0) : 0);
+    taosMemoryFree(pEntry);
+  }
+  taosArrayDestroy(pEntries);
+}
+
+static void tqPushEntryRemove(STQ* pTq, const STqPushEntry* pEntry) {
+  char subKey[TSDB_SUBSCRIBE_KEY_LEN];
+  tstrncpy(subKey, pEntry->pollReq.subKey, TSDB_SUBSCRIBE_KEY_LEN);
+  taosHashRemove(pTq->pPushMgr, subKey, strlen(subKey));
+}
+
+void tqPushRedispatch(STQ* pTq, STqPushEntry* pEntry) {
+  if (pEntry == NULL) return;
+  tqPushEntryDispatch(pTq, pEntry, 0);
+  taosMemoryFree(pEntry);
+}
+
+// caller should hold pTq->pushLock, the poll parked before for the same subscription is returned in ppOld and should
+// be passed to tqPushRedispatch once the lock is released
+int32_t tqPushRegister(STQ* pTq, const SRpcMsg* pMsg, const STqOffsetVal* pOffset, STqPushEntry** ppOld) {
+  const SMqPollReq* pReq = pMsg->pCont;
+
+  *ppOld = NULL;
+  STqPushEntry* pEntry = taosMemoryCalloc(1, sizeof(STqPushEntry));
+  if (pEntry == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  memcpy(&pEntry->pollReq, pReq, sizeof(SMqPollReq));
+  pEntry->pollReq.reqOffset = *pOffset;  // resume from where the scan stopped
+  pEntry->pInfo = pMsg->info;
+  int64_t wait = pReq->timeout < 0 ? TQ_POLL_MAX_WAIT_MS : TMIN(pReq->timeout, TQ_POLL_MAX_WAIT_MS);
+  pEntry->expireTs = taosGetTimestampMs() + wait;
+
+  // only one poll per subscription can be parked, the one it replaces is answered
+  int32_t        keyLen = strlen(pReq->subKey);
+  STqPushEntry** ppEntry = taosHashGet(pTq->pPushMgr, pReq->subKey, keyLen);
+  if (ppEntry != NULL) {
+    *ppOld = *ppEntry;
+    taosHashRemove(pTq->pPushMgr, pReq->subKey, keyLen);
+  }
+
+  if (taosHashPut(pTq->pPushMgr, pReq->subKey, keyLen, &pEntry, sizeof(void*)) != 0) {
+    taosMemoryFree(pEntry);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  return 0;
+}
+
+void tqPushRemove(STQ* pTq, const char* subKey) {
+  STqPushEntry* pEntry = NULL;
+
+  taosWLockLatch(&pTq->pushLock);
+  STqPushEntry** ppEntry = taosHashGet(pTq->pPushMgr, subKey, strlen(subKey));
+  if (ppEntry != NULL) {
+    tqDebug("vgId:%d, tq remove push handle %s", TD_VID(pTq->pVnode), subKey);
+    pEntry = *ppEntry;
+    taosHashRemove(pTq->pPushMgr, subKey, strlen(subKey));
+  }
+  taosWUnLockLatch(&pTq->pushLock);
+
+  tqPushRedispatch(pTq, pEntry);
+}
+
+// Answer every parked poll with code, when the vnode is closed or is no longer the leader. The consumers then ask for
+// the new epset instead of waiting for the rpc timeout.
+void tqPushReplyAll(STQ* pTq, int32_t code) {
+  taosWLockLatch(&pTq->pushLock);
+  SArray* pEntries = taosArrayInit(taosHashGetSize(pTq->pPushMgr), sizeof(void*));
+  void*   pIter = NULL;
+  while ((pIter = taosHashIterate(pTq->pPushMgr, pIter)) != NULL) {
+    STqPushEntry* pEntry = *(STqPushEntry**)pIter;
+    if (pEntries == NULL || taosArrayPush(pEntries, &pEntry) == NULL) {
+      // still answered, only later than the others
+      SRpcMsg rsp = {.info = pEntry->pInfo, .code = code};
+      tmsgSendRsp(&rsp);
+      taosMemoryFree(pEntry);
     }
-    // unlock
+  }
+  taosHashClear(pTq->pPushMgr);
+  taosWUnLockLatch(&pTq->pushLock);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pEntries); i++) {
+    STqPushEntry* pEntry = taosArrayGetP(pEntries, i);
+    tqDebug("vgId:%d, consumer:%" PRId64 ", subkey %s, answer parked poll since %s", TD_VID(pTq->pVnode),
+            pEntry->pollReq.consumerId, pEntry->pollReq.subKey, tstrerror(code));
+    SRpcMsg rsp = {.info = pEntry->pInfo, .code = code};
+    tmsgSendRsp(&rsp);
+    taosMemoryFree(pEntry);
+  }
+  taosArrayDestroy(pEntries);
+}
+
+static bool tqPushMsgMatch(STqHandle* pHandle, const void* msg, tmsg_t msgType) {
+  if (msgType != TDMT_VND_SUBMIT) {
+    return pHandle->fetchMeta;
+  }
+
+  STqExecHandle* pExec = &pHandle->execHandle;
+  SHashObj*      pFilterOut = pExec->subType == TOPIC_SUB_TYPE__DB ? pExec->execDb.pFilterOutTbUid : NULL;
+  SHashObj*      pTbIds = (pExec->subType != TOPIC_SUB_TYPE__DB && pExec->pExecReader) ? pExec->pExecReader->tbIdHash
+                                                                                       : NULL;
+  if (pFilterOut == NULL && pTbIds == NULL) {
+    return true;
+  }
+
+  SSubmitMsgIter iter = {0};
+  SSubmitBlk*    pBlock = NULL;
+  if (tInitSubmitMsgIter(msg, &iter) < 0) {
+    return true;
+  }
+  while (tGetSubmitMsgNext(&iter, &pBlock) == 0 && pBlock != NULL) {
+    if (pTbIds != NULL && taosHashGet(pTbIds, &iter.uid, sizeof(int64_t)) != NULL) return true;
+    if (pFilterOut != NULL && taosHashGet(pFilterOut, &iter.uid, sizeof(int64_t)) == NULL) return true;
+  }
+  return false;
+}
+
+// All polls waiting on the vnode are woken in one pass when the applied msg matches their subscription.
+static void tqPushWakeup(STQ* pTq, const void* msg, tmsg_t msgType, int64_t ver) {
+  taosWLockLatch(&pTq->pushLock);
+  int32_t num = taosHashGetSize(pTq->pPushMgr);
+  tqDebug("vgId:%d, push handle num %d", TD_VID(pTq->pVnode), num);
+  if (num == 0) {
     taosWUnLockLatch(&pTq->pushLock);
+    return;
+  }
+
+  SArray* pWoken = taosArrayInit(num, sizeof(void*));
+  if (pWoken == NULL) {
+    taosWUnLockLatch(&pTq->pushLock);
+    return;
+  }
+
+  void* pIter = NULL;
+  while ((pIter = taosHashIterate(pTq->pPushMgr, pIter)) != NULL) {
+    STqPushEntry* pEntry = *(STqPushEntry**)pIter;
+    if (pEntry->pollReq.reqOffset.version >= ver) continue;
+
+    // a dropped handle is woken as well so that the consumer receives the error
+    STqHandle* pHandle = taosHashGet(pTq->pHandle, pEntry->pollReq.subKey, strlen(pEntry->pollReq.subKey));
+    if (pHandle != NULL && !tqPushMsgMatch(pHandle, msg, msgType)) continue;
+
+    if (taosArrayPush(pWoken, &pEntry) == NULL) break;
+  }
+  taosHashCancelIterate(pTq->pPushMgr, pIter);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pWoken); i++) {
+    tqPushEntryRemove(pTq, taosArrayGetP(pWoken, i));
+  }
+  taosWUnLockLatch(&pTq->pushLock);
+
+  tqDebug("vgId:%d, msg ver %" PRId64 " wakes up %d polls", TD_VID(pTq->pVnode), ver,
+          (int32_t)taosArrayGetSize(pWoken));
+  tqPushEntryDispatchAll(pTq, pWoken, true);
+}
+
+void tqPushExpire(STQ* pTq) {
+  taosWLockLatch(&pTq->pushLock);
+  int32_t num = taosHashGetSize(pTq->pPushMgr);
+  if (num == 0) {
+    taosWUnLockLatch(&pTq->pushLock);
+    return;
+  }
+
+  SArray* pExpired = taosArrayInit(num, sizeof(void*));
+  if (pExpired == NULL) {
+    taosWUnLockLatch(&pTq->pushLock);
+    return;
+  }
+
+  int64_t now = taosGetTimestampMs();
+  void*   pIter = NULL;
+  while ((pIter = taosHashIterate(pTq->pPushMgr, pIter)) != NULL) {
+    STqPushEntry* pEntry = *(STqPushEntry**)pIter;
+    if (pEntry->expireTs > now) continue;
+    if (taosArrayPush(pExpired, &pEntry) == NULL) break;
+  }
+  taosHashCancelIterate(pTq->pPushMgr, pIter);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pExpired); i++) {
+    STqPushEntry* pEntry = taosArrayGetP(pExpired, i);
+    tqDebug("vgId:%d, consumer:%" PRId64 ", subkey %s, parked poll expired", TD_VID(pTq->pVnode),
+            pEntry->pollReq.consumerId, pEntry->pollReq.subKey);
+    tqPushEntryRemove(pTq, pEntry);
+  }
+  taosWUnLockLatch(&pTq->pushLock);
+
+  tqPushEntryDispatchAll(pTq, pExpired, false);
+}
+
+int tqPushMsg(STQ* pTq, void* msg, int32_t msgLen, tmsg_t msgType, int64_t ver) {
+  tqDebug("vgId:%d, tq push msg ver %" PRId64 ", type: %s", pTq->pVnode->config.vgId, ver, TMSG_INFO(msgType));
+
+  // consumers polling near the head are served from the cache instead of the wal
+  if (pTq->pLogCache && vnodeIsRoleLeader(pTq->pVnode)) {
+    if (tqLogCachePut(pTq->pLogCache, ver, msgType, msg, msgLen) < 0) {
+      tqWarn("vgId:%d, failed to cache msg ver %" PRId64 " since %s", pTq->pVnode->config.vgId, ver, terrstr());
+    }
+  }
+
+  if (msgType == TDMT_VND_SUBMIT || IS_META_MSG(msgType)) {
+    tqPushWakeup(pTq, msg, msgType, ver);
   }
 
   if (vnodeIsRoleLeader(pTq->pVnode)) {
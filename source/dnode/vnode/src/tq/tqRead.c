@@ -191,6 +191,20 @@ int64_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHea
   int64_t offset = *fetchOffset;
 
   while (1) {
+    if (tqLogCacheGet(pTq->pLogCache, offset, ppCkHead, &pHandle->pWalReader->capacity) == 0) {
+      SWalCont* pHead = &((*ppCkHead)->head);
+      tqDebug("vgId:%d, taosx get msg ver %" PRId64 " from cache, type: %s", pTq->pVnode->config.vgId, offset,
+              TMSG_INFO(pHead->msgType));
+      if (pHead->msgType == TDMT_VND_SUBMIT ||
+          (pHandle->fetchMeta && IS_META_MSG(pHead->msgType) && isValValidForTable(pHandle, pHead))) {
+        *fetchOffset = offset;
+        code = 0;
+        goto END;
+      }
+      offset++;
+      continue;
+    }
+
     if (walFetchHead(pHandle->pWalReader, offset, *ppCkHead) < 0) {
       tqDebug("tmq poll: consumer:%" PRId64 ", (epoch %d) vgId:%d offset %" PRId64 ", no more log to return",
               pHandle->consumerId, pHandle->epoch, TD_VID(pTq->pVnode), offset);
@@ -263,6 +277,7 @@ STqReader* tqOpenReader(SVnode* pVnode) {
     return NULL;
   }
 
+  pReader->pVnode = pVnode;
   pReader->pVnodeMeta = pVnode->pMeta;
   pReader->pMsg = NULL;
   pReader->ver = -1;
@@ -290,12 +305,23 @@ void tqCloseReader(STqReader* pReader) {
   if (pReader->pColIdList) {
     taosArrayDestroy(pReader->pColIdList);
   }
+  tDestroySubmitBlkIter(&pReader->blkIter);
   // free hash
   taosHashCleanup(pReader->tbIdHash);
   taosMemoryFree(pReader);
 }
 
+static STqLogCache* tqReaderGetLogCache(STqReader* pReader) {
+  return pReader->pVnode->pTq ? pReader->pVnode->pTq->pLogCache : NULL;
+}
+
 int32_t tqSeekVer(STqReader* pReader, int64_t ver) {
+  // the next fetch is served from the log cache, defer the wal seek to the first miss
+  if (tqLogCacheHas(tqReaderGetLogCache(pReader), ver)) {
+    pReader->pWalReader->curVersion = ver;
+    pReader->pWalReader->curInvalid = 1;
+    return 0;
+  }
   if (walReadSeekVer(pReader->pWalReader, ver) < 0) {
     ASSERT(pReader->pWalReader->curInvalid);
     ASSERT(pReader->pWalReader->curVersion == ver);
@@ -305,12 +331,36 @@ int32_t tqSeekVer(STqReader* pReader, int64_t ver) {
   return 0;
 }
 
+// Entries still in the log cache are served from memory, the wal reader is repositioned on the first miss.
+static int32_t tqReaderNextValidMsg(STqReader* pReader) {
+  SWalReader*  pWalReader = pReader->pWalReader;
+  STqLogCache* pCache = tqReaderGetLogCache(pReader);
+  int64_t      ver = pWalReader->curVersion;
+
+  while (ver >= 0 && tqLogCacheGet(pCache, ver, &pWalReader->pHead, &pWalReader->capacity) == 0) {
+    tmsg_t msgType = pWalReader->pHead->head.msgType;
+    ver++;
+    if (msgType == TDMT_VND_SUBMIT || (IS_META_MSG(msgType) && pWalReader->cond.scanMeta)) {
+      pWalReader->curVersion = ver;
+      pWalReader->curInvalid = 1;
+      pWalReader->curStopped = 0;
+      return 0;
+    }
+  }
+
+  if (ver != pWalReader->curVersion) {
+    pWalReader->curVersion = ver;
+    pWalReader->curInvalid = 1;
+  }
+  return walNextValidMsg(pWalReader);
+}
+
 int32_t tqNextBlock(STqReader* pReader, SFetchRet* ret) {
   bool fromProcessedMsg = pReader->pMsg != NULL;
 
   while (1) {
     if (!fromProcessedMsg) {
-      if (walNextValidMsg(pReader->pWalReader) < 0) {
+      if (tqReaderNextValidMsg(pReader) < 0) {
         pReader->ver =
             pReader->pWalReader->curVersion - (pReader->pWalReader->curInvalid | pReader->pWalReader->curStopped);
         ret->offset.type = TMQ_OFFSET__LOG;
@@ -370,7 +420,7 @@ int32_t tqReaderSetDataMsg(STqReader* pReader, const SSubmitReq* pMsg, int64_t v
 
   if (tInitSubmitMsgIter(pMsg, &pReader->msgIter) < 0) return -1;
   pReader->ver = ver;
-  memset(&pReader->blkIter, 0, sizeof(SSubmitBlkIter));
+  tDestroySubmitBlkIter(&pReader->blkIter);
   return 0;
 }
 
@@ -414,6 +464,59 @@ bool tqNextDataBlockFilterOut(STqReader* pHandle, SHashObj* filterOutUids) {
   return false;
 }
 
+// Fill the wanted columns straight from the slices of a column-major block, fixed length columns without null are
+// copied in one go.
+static int32_t tqRetrieveColBlk(SSDataBlock* pBlock, SSubmitColBlk* pColBlk) {
+  int32_t  code = 0;
+  uint8_t* pBuf = NULL;
+  int32_t  colActual = blockDataGetNumOfCols(pBlock);
+
+  for (int32_t i = 0; i < colActual; i++) {
+    SColumnInfoData* pColInfo = taosArrayGet(pBlock->pDataBlock, i);
+    SColData*        pColData = NULL;
+    for (int32_t iCol = 0; iCol < pColBlk->nCol; iCol++) {
+      if (pColBlk->aColData[iCol].cid == pColInfo->info.colId) {
+        pColData = &pColBlk->aColData[iCol];
+        break;
+      }
+    }
+
+    if (pColData == NULL || pColData->type != pColInfo->info.type) {
+      colDataAppendNNULL(pColInfo, 0, pColBlk->nRow);
+      continue;
+    }
+
+    if (pColData->flag == HAS_VALUE && !IS_VAR_DATA_TYPE(pColData->type)) {
+      memcpy(pColInfo->pData, pColData->pData, pColData->nData);
+      continue;
+    }
+
+    for (int32_t iRow = 0; iRow < pColBlk->nRow; iRow++) {
+      SColVal colVal;
+      tColDataGetValue(pColData, iRow, &colVal);
+      if (!COL_VAL_IS_VALUE(&colVal)) {
+        colDataAppendNULL(pColInfo, iRow);
+        continue;
+      }
+
+      if (IS_VAR_DATA_TYPE(pColData->type)) {
+        code = tRealloc(&pBuf, VARSTR_HEADER_SIZE + colVal.value.nData);
+        if (code) goto _exit;
+        varDataSetLen(pBuf, colVal.value.nData);
+        if (colVal.value.nData) memcpy(varDataVal(pBuf), colVal.value.pData, colVal.value.nData);
+        code = colDataAppend(pColInfo, iRow, (const char*)pBuf, false);
+      } else {
+        code = colDataAppend(pColInfo, iRow, (const char*)&colVal.value.val, false);
+      }
+      if (code) goto _exit;
+    }
+  }
+
+_exit:
+  tFree(pBuf);
+  return code;
+}
+
 int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
   // TODO: cache multiple schema
   int32_t sversion = htonl(pReader->pBlock->sversion);
@@ -497,12 +600,25 @@ int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
   STSRow* row;
   int32_t curRow = 0;
 
-  tInitSubmitBlkIter(&pReader->msgIter, pReader->pBlock, &pReader->blkIter);
+  if (tInitSubmitBlkIter(&pReader->msgIter, pReader->pBlock, &pReader->blkIter) < 0 && pReader->msgIter.colFmt) {
+    goto FAIL;
+  }
 
   pBlock->info.uid = pReader->msgIter.uid;
   pBlock->info.rows = pReader->msgIter.numOfRows;
   pBlock->info.version = pReader->pMsg->version;
 
+  if (pReader->blkIter.pColBlk) {
+    if (pReader->blkIter.pColBlk->nRow != pBlock->info.rows) {
+      terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+      goto FAIL;
+    }
+    if ((terrno = tqRetrieveColBlk(pBlock, pReader->blkIter.pColBlk)) != 0) {
+      goto FAIL;
+    }
+    return 0;
+  }
+
   while ((row = tGetSubmitBlkNext(&pReader->blkIter)) != NULL) {
     tdSTSRowIterReset(&iter, row);
     // get all wanted col of that block
@@ -150,18 +150,37 @@ _exit:
   return code;
 }
 
+// freeze the active memtable, writes go to the one created by the next tsdbBegin
+int32_t tsdbPrepareCommit(STsdb *pTsdb) {
+  if (!pTsdb) return 0;
+
+  ASSERT(pTsdb->mem && pTsdb->imem == NULL);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  pTsdb->imem = pTsdb->mem;
+  pTsdb->mem = NULL;
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+
+  return 0;
+}
+
+// commit the frozen memtable, the active one is frozen first if tsdbPrepareCommit was not called
 int32_t tsdbCommit(STsdb *pTsdb) {
   if (!pTsdb) return 0;
 
   int32_t    code = 0;
   int32_t    lino = 0;
   SCommitter commith;
-  SMemTable *pMemTable = pTsdb->mem;
+
+  if (pTsdb->imem == NULL) {
+    tsdbPrepareCommit(pTsdb);
+  }
+  SMemTable *pMemTable = pTsdb->imem;
 
   // check
   if (pMemTable->nRow == 0 && pMemTable->nDel == 0) {
     taosThreadRwlockWrlock(&pTsdb->rwLock);
-    pTsdb->mem = NULL;
+    pTsdb->imem = NULL;
     taosThreadRwlockUnlock(&pTsdb->rwLock);
 
     tsdbUnrefMemTable(pMemTable);
@@ -503,6 +522,7 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
   if (pRSet) {
     code = tsdbDataFReaderOpen(&pCommitter->dReader.pReader, pTsdb, pRSet);
     TSDB_CHECK_CODE(code, lino, _exit);
+    pCommitter->dReader.pReader->ioClass = VND_IO_COMMIT;
 
     // data
     code = tsdbReadBlockIdx(pCommitter->dReader.pReader, pCommitter->dReader.aBlockIdx);
@@ -550,6 +570,7 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
   wSet.aSttF[wSet.nSttF - 1] = &fStt;
   code = tsdbDataFWriterOpen(&pCommitter->dWriter.pWriter, pTsdb, &wSet);
   TSDB_CHECK_CODE(code, lino, _exit);
+  pCommitter->dWriter.pWriter->ioClass = VND_IO_COMMIT;
 
   taosArrayClear(pCommitter->dWriter.aBlockIdx);
   taosArrayClear(pCommitter->dWriter.aSttBlk);
@@ -804,15 +825,10 @@ static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter) {
   int32_t lino = 0;
 
   memset(pCommitter, 0, sizeof(*pCommitter));
-  ASSERT(pTsdb->mem && pTsdb->imem == NULL);
-
-  taosThreadRwlockWrlock(&pTsdb->rwLock);
-  pTsdb->imem = pTsdb->mem;
-  pTsdb->mem = NULL;
-  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  ASSERT(pTsdb->imem);
 
   pCommitter->pTsdb = pTsdb;
-  pCommitter->commitID = pTsdb->pVnode->state.commitID;
+  pCommitter->commitID = pTsdb->imem->commitID;
   pCommitter->minutes = pTsdb->keepCfg.days;
   pCommitter->precision = pTsdb->keepCfg.precision;
   pCommitter->minRow = pTsdb->pVnode->config.tsdbCfg.minRows;
@@ -15,13 +15,854 @@
 
 #include "tsdb.h"
 
+#define TSDB_COMPACT_MIN_SCORE 2.0
+#define TSDB_COMPACT_MAX_NDEL  4
+
+typedef enum { TSDB_COMPACT_DATA_ITER = 0, TSDB_COMPACT_STT_ITER } ECompactIterT;
+
+typedef struct {
+  SRBTreeNode   n;
+  SRowInfo      rInfo;
+  ECompactIterT type;
+  union {
+    struct {
+      int32_t    iBlockIdx;
+      SBlockIdx *pBlockIdx;
+      SMapData   mDataBlk;
+      int32_t    iDataBlk;
+    };  // .data file
+    struct {
+      int32_t iStt;
+      SArray *aSttBlk;  // SArray<SSttBlk>
+      int32_t iSttBlk;
+    };  // .stt file
+  };
+  SBlockData bData;
+  int32_t    iRow;
+} SCompactIter;
+
+// The newest version the .data file of a file set reflects, tombstones up to it are applied or older than its rows.
+// Kept in memory by fid, a mark whose head file is gone is recomputed from the block versions.
+typedef struct {
+  int64_t headID;
+  int64_t maxVer;
+} SCompactMark;
+
 typedef struct {
-  STsdb  *pTsdb;
-  STsdbFS fs;
+  STsdb   *pTsdb;
+  STsdbFS *pFS;
+  int32_t  minutes;
+  int8_t   precision;
+  int32_t  maxRow;
+  int8_t   cmprAlg;
+  // tombstones
+  SDelFReader *pDelFReader;
+  SArray      *aDelIdx;   // SArray<SDelIdx>
+  SArray      *aDelData;  // SArray<SDelData>
+  // reader
+  SDataFReader *pReader;
+  SArray       *aBlockIdx;  // SArray<SBlockIdx>
+  SRBTree       rbt;
+  SCompactIter *pIter;
+  int32_t       nIter;
+  SCompactIter  aIter[TSDB_MAX_STT_TRIGGER + 1];
+  // writer
+  SDataFWriter *pWriter;
+  SArray       *aBlockIdxN;  // SArray<SBlockIdx>
+  SArray       *aSttBlk;     // SArray<SSttBlk>, always empty
+  SMapData      mDataBlk;
+  SBlockData    bData;
+  SSkmInfo      skm;
+  int8_t        skip;
+  SDFileSetVal  wSet;  // the set written by tsdbCompactFSet
+  // io
+  int8_t  ioClass;  // EVndIoClass
+  int64_t stMs;
+  int64_t nRead;
 } STsdbCompactor;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+extern int32_t tRowInfoCmprFn(const void *p1, const void *p2);
+extern int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
+extern int32_t tsdbUpdateTableSchema(SMeta *pMeta, int64_t suid, int64_t uid, SSkmInfo *pSkmInfo);
+extern int32_t tsdbWriteDataBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SMapData *mDataBlk, int8_t cmprAlg);
+
+static int32_t tCompactIterCmprFn(const SRBTreeNode *pNode1, const SRBTreeNode *pNode2) {
+  SCompactIter *pIter1 = (SCompactIter *)(((uint8_t *)pNode1) - offsetof(SCompactIter, n));
+  SCompactIter *pIter2 = (SCompactIter *)(((uint8_t *)pNode2) - offsetof(SCompactIter, n));
+
+  return tRowInfoCmprFn(&pIter1->rInfo, &pIter2->rInfo);
+}
+
+// score ==========================================
+// per file set of the run, ordered by fid as pFS->aDFileSet
+typedef struct {
+  TSKEY   minKey;
+  TSKEY   maxKey;
+  int64_t maxVer;
+  int32_t nDel;  // tombstones newer than maxVer over the key range, counted up to TSDB_COMPACT_MAX_NDEL
+} SCompactFSetDel;
+
+// The .del file is read once per run, each tombstone is counted for the file sets its key range covers.
+static int32_t tsdbCompactCountDel(STsdbCompactor *pCompactor, SCompactFSetDel *aSetDel, int32_t nSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  for (int32_t iDelIdx = 0; iDelIdx < taosArrayGetSize(pCompactor->aDelIdx); iDelIdx++) {
+    SDelIdx *pDelIdx = (SDelIdx *)taosArrayGet(pCompactor->aDelIdx, iDelIdx);
+
+    code = tsdbReadDelData(pCompactor->pDelFReader, pDelIdx, pCompactor->aDelData);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    for (int32_t iDelData = 0; iDelData < taosArrayGetSize(pCompactor->aDelData); iDelData++) {
+      SDelData *pDelData = (SDelData *)taosArrayGet(pCompactor->aDelData, iDelData);
+
+      // first file set not before the tombstone
+      int32_t lo = 0, hi = nSet;
+      while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (aSetDel[mid].maxKey < pDelData->sKey) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+
+      for (int32_t iSet = lo; iSet < nSet && aSetDel[iSet].minKey <= pDelData->eKey; iSet++) {
+        if (pDelData->version > aSetDel[iSet].maxVer && aSetDel[iSet].nDel < TSDB_COMPACT_MAX_NDEL) {
+          aSetDel[iSet].nDel++;
+        }
+      }
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactGetMark(STsdbCompactor *pCompactor, SDFileSet *pSet, int64_t *maxVer) {
+  int32_t       code = 0;
+  int32_t       lino = 0;
+  STsdb        *pTsdb = pCompactor->pTsdb;
+  SDataFReader *pReader = NULL;
+  SMapData      mDataBlk = {0};
+  SDataBlk      dataBlk;
+
+  SCompactMark *pMark = (SCompactMark *)taosHashGet(pTsdb->pCompactMark, &pSet->fid, sizeof(pSet->fid));
+  if (pMark && pMark->headID == pSet->pHeadF->commitID) {
+    *maxVer = pMark->maxVer;
+    return code;
+  }
+
+  *maxVer = -1;
+  code = tsdbDataFReaderOpen(&pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  pReader->ioClass = pCompactor->ioClass;
+
+  code = tsdbReadBlockIdx(pReader, pCompactor->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iBlockIdx = 0; iBlockIdx < taosArrayGetSize(pCompactor->aBlockIdx); iBlockIdx++) {
+    code = tsdbReadDataBlk(pReader, (SBlockIdx *)taosArrayGet(pCompactor->aBlockIdx, iBlockIdx), &mDataBlk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    for (int32_t iDataBlk = 0; iDataBlk < mDataBlk.nItem; iDataBlk++) {
+      tMapDataGetItemByIdx(&mDataBlk, iDataBlk, &dataBlk, tGetDataBlk);
+      *maxVer = TMAX(*maxVer, dataBlk.maxVer);
+    }
+  }
+
+  SCompactMark mark = {.headID = pSet->pHeadF->commitID, .maxVer = *maxVer};
+  code = taosHashPut(pTsdb->pCompactMark, &pSet->fid, sizeof(pSet->fid), &mark, sizeof(mark));
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  tMapDataClear(&mDataBlk);
+  if (pReader) tsdbDataFReaderClose(&pReader);
+  return code;
+}
+
+// The read amplification of a file set grows with the number of .stt files a query has to merge, the share of data
+// still sitting in them and the tombstones its .data file does not reflect yet.
+static int32_t tsdbCompactPickFSet(STsdbCompactor *pCompactor, SDFileSet **ppSet, double *pScore) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  int32_t          nSet = taosArrayGetSize(pCompactor->pFS->aDFileSet);
+  SCompactFSetDel *aSetDel = NULL;
+
+  *ppSet = NULL;
+  *pScore = 0;
+  if (pCompactor->pDelFReader && nSet > 0) {
+    aSetDel = (SCompactFSetDel *)taosMemoryCalloc(nSet, sizeof(SCompactFSetDel));
+    if (aSetDel == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    for (int32_t iSet = 0; iSet < nSet; iSet++) {
+      SDFileSet *pSet = (SDFileSet *)taosArrayGet(pCompactor->pFS->aDFileSet, iSet);
+      tsdbFidKeyRange(pSet->fid, pCompactor->minutes, pCompactor->precision, &aSetDel[iSet].minKey,
+                      &aSetDel[iSet].maxKey);
+      code = tsdbCompactGetMark(pCompactor, pSet, &aSetDel[iSet].maxVer);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactCountDel(pCompactor, aSetDel, nSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t iSet = 0; iSet < nSet; iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pCompactor->pFS->aDFileSet, iSet);
+    int64_t    sttSize = 0;
+    int32_t    nDel = aSetDel ? aSetDel[iSet].nDel : 0;
+
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      sttSize += pSet->aSttF[iStt]->size;
+    }
+
+    double score = pSet->nSttF - 1 + 0.5 * nDel;
+    if (sttSize > 0) {
+      score += (double)sttSize / (pSet->pDataF->size + sttSize);
+    }
+
+    if (score >= TSDB_COMPACT_MIN_SCORE && score > *pScore) {
+      *ppSet = pSet;
+      *pScore = score;
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  taosMemoryFree(aSetDel);
+  return code;
+}
+
+// read ==========================================
+static int32_t tsdbCompactIterNext(STsdbCompactor *pCompactor, SCompactIter *pIter, bool *hasRow) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  *hasRow = false;
+  while (true) {
+    if (++pIter->iRow < pIter->bData.nRow) {
+      pIter->rInfo.suid = pIter->bData.suid;
+      pIter->rInfo.uid = pIter->bData.uid ? pIter->bData.uid : pIter->bData.aUid[pIter->iRow];
+      pIter->rInfo.row = tsdbRowFromBlockData(&pIter->bData, pIter->iRow);
+      *hasRow = true;
+      break;
+    }
+
+    if (pIter->type == TSDB_COMPACT_DATA_ITER) {
+      while (++pIter->iDataBlk >= pIter->mDataBlk.nItem) {
+        if (++pIter->iBlockIdx >= taosArrayGetSize(pCompactor->aBlockIdx)) goto _exit;
+
+        pIter->pBlockIdx = (SBlockIdx *)taosArrayGet(pCompactor->aBlockIdx, pIter->iBlockIdx);
+        code = tsdbReadDataBlk(pCompactor->pReader, pIter->pBlockIdx, &pIter->mDataBlk);
+        TSDB_CHECK_CODE(code, lino, _exit);
+        pIter->iDataBlk = -1;
+      }
+
+      SDataBlk dataBlk;
+      tMapDataGetItemByIdx(&pIter->mDataBlk, pIter->iDataBlk, &dataBlk, tGetDataBlk);
+      code = tsdbReadDataBlockEx(pCompactor->pReader, &dataBlk, &pIter->bData);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      pCompactor->nRead += dataBlk.aSubBlock[0].szBlock;
+    } else {
+      if (++pIter->iSttBlk >= taosArrayGetSize(pIter->aSttBlk)) goto _exit;
+
+      SSttBlk *pSttBlk = (SSttBlk *)taosArrayGet(pIter->aSttBlk, pIter->iSttBlk);
+      code = tsdbReadSttBlockEx(pCompactor->pReader, pIter->iStt, pSttBlk, &pIter->bData);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      pCompactor->nRead += pSttBlk->bInfo.szBlock;
+    }
+    pIter->iRow = -1;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static SRowInfo *tsdbCompactGetRow(STsdbCompactor *pCompactor) {
+  return pCompactor->pIter ? &pCompactor->pIter->rInfo : NULL;
+}
+
+static int32_t tsdbCompactNextRow(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  bool    hasRow;
+
+  if (pCompactor->pIter) {
+    code = tsdbCompactIterNext(pCompactor, pCompactor->pIter, &hasRow);
+    if (code) return code;
+
+    if (!hasRow) {
+      pCompactor->pIter = NULL;
+    } else {
+      SCompactIter *pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+      if (pIter && tRowInfoCmprFn(&pCompactor->pIter->rInfo, &pIter->rInfo) > 0) {
+        tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+        pCompactor->pIter = NULL;
+      }
+    }
+  }
+
+  if (pCompactor->pIter == NULL) {
+    pCompactor->pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+    if (pCompactor->pIter) {
+      tRBTreeDrop(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+    }
+  }
+
+  return code;
+}
+
+static int32_t tsdbCompactOpenReader(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  bool    hasRow;
+
+  code = tsdbDataFReaderOpen(&pCompactor->pReader, pCompactor->pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  pCompactor->pReader->ioClass = pCompactor->ioClass;
+
+  code = tsdbReadBlockIdx(pCompactor->pReader, pCompactor->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tRBTreeCreate(&pCompactor->rbt, tCompactIterCmprFn);
+  pCompactor->pIter = NULL;
+  pCompactor->nIter = 0;
+
+  // .data file
+  SCompactIter *pIter = &pCompactor->aIter[pCompactor->nIter++];
+  pIter->type = TSDB_COMPACT_DATA_ITER;
+  pIter->iBlockIdx = -1;
+  pIter->iDataBlk = -1;
+  pIter->iRow = -1;
+  code = tsdbCompactIterNext(pCompactor, pIter, &hasRow);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (hasRow) tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+
+  // .stt file
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pIter = &pCompactor->aIter[pCompactor->nIter++];
+    pIter->type = TSDB_COMPACT_STT_ITER;
+    pIter->iStt = iStt;
+    pIter->iSttBlk = -1;
+    pIter->iRow = -1;
+    if (pIter->aSttBlk == NULL && (pIter->aSttBlk = taosArrayInit(0, sizeof(SSttBlk))) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbReadSttBlk(pCompactor->pReader, iStt, pIter->aSttBlk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbCompactIterNext(pCompactor, pIter, &hasRow);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    if (hasRow) tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+  }
+
+  code = tsdbCompactNextRow(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+// write ==========================================
+static int32_t tsdbCompactTableEnd(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (pCompactor->skip || pCompactor->bData.uid == 0) return code;
+
+  code = tsdbWriteDataBlock(pCompactor->pWriter, &pCompactor->bData, &pCompactor->mDataBlk, pCompactor->cmprAlg);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->mDataBlk.nItem > 0) {
+    SBlockIdx blockIdx = {.suid = pCompactor->bData.suid, .uid = pCompactor->bData.uid};
+    code = tsdbWriteDataBlk(pCompactor->pWriter, &pCompactor->mDataBlk, &blockIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (taosArrayPush(pCompactor->aBlockIdxN, &blockIdx) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactTableStart(STsdbCompactor *pCompactor, TABLEID *pId) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SMeta    *pMeta = pCompactor->pTsdb->pVnode->pMeta;
+  SMetaInfo info;
+
+  tMapDataReset(&pCompactor->mDataBlk);
+  tBlockDataReset(&pCompactor->bData);
+  taosArrayClear(pCompactor->aDelData);
+
+  // rows of a dropped table are garbage
+  pCompactor->skip = (metaGetInfo(pMeta, pId->uid, &info) != 0);
+  if (pCompactor->skip) goto _exit;
+
+  code = tsdbUpdateTableSchema(pMeta, pId->suid, pId->uid, &pCompactor->skm);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tBlockDataInit(&pCompactor->bData, pId, pCompactor->skm.pTSchema, NULL, 0);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->pDelFReader) {
+    SDelIdx  delIdx = {.suid = pId->suid, .uid = pId->uid};
+    SDelIdx *pDelIdx = (SDelIdx *)taosArraySearch(pCompactor->aDelIdx, &delIdx, tCmprDelIdx, TD_EQ);
+    if (pDelIdx) {
+      code = tsdbReadDelData(pCompactor->pDelFReader, pDelIdx, pCompactor->aDelData);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static bool tsdbCompactRowDeleted(STsdbCompactor *pCompactor, TSDBROW *pRow) {
+  TSDBKEY key = TSDBROW_KEY(pRow);
+
+  for (int32_t iDelData = 0; iDelData < taosArrayGetSize(pCompactor->aDelData); iDelData++) {
+    SDelData *pDelData = (SDelData *)taosArrayGet(pCompactor->aDelData, iDelData);
+    if (key.ts >= pDelData->sKey && key.ts <= pDelData->eKey && key.version <= pDelData->version) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool tsdbCompactSameKey(SRowInfo *pInfo1, SRowInfo *pInfo2) {
+  return pInfo1->suid == pInfo2->suid && pInfo1->uid == pInfo2->uid &&
+         TSDBROW_TS(&pInfo1->row) == TSDBROW_TS(&pInfo2->row);
+}
+
+// A row with the same key may follow in another iterator, later in the same block or in the next block of the same
+// iterator. In the last case the current block is gone once the iterator moves on.
+static bool tsdbCompactMayDup(STsdbCompactor *pCompactor) {
+  SCompactIter *pIter = pCompactor->pIter;
+  SCompactIter *pMin = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+
+  if (pMin && tsdbCompactSameKey(&pIter->rInfo, &pMin->rInfo)) return true;
+  if (pIter->iRow + 1 >= pIter->bData.nRow) return true;
+  return pIter->bData.aTSKEY[pIter->iRow + 1] == pIter->bData.aTSKEY[pIter->iRow] &&
+         (pIter->bData.uid || pIter->bData.aUid[pIter->iRow + 1] == pIter->rInfo.uid);
+}
+
+static int32_t tsdbCompactAppendRow(STsdbCompactor *pCompactor, TSDBROW *pRow, STSchema *pTSchema) {
   int32_t code = 0;
-  // TODO
+  int32_t lino = 0;
+
+  code = tBlockDataAppendRow(&pCompactor->bData, pRow, pTSchema, pCompactor->bData.uid);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->bData.nRow >= pCompactor->maxRow) {
+    code = tsdbWriteDataBlock(pCompactor->pWriter, &pCompactor->bData, &pCompactor->mDataBlk, pCompactor->cmprAlg);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+// Write the current row merged with every live version of its key and move past them. The merge result is kept as an
+// STSRow since the block data the versions come from may be replaced while iterating.
+static int32_t tsdbCompactWriteRow(STsdbCompactor *pCompactor) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  SRowInfo   rInfo = *tsdbCompactGetRow(pCompactor);
+  STSchema  *pTSchema = pCompactor->skm.pTSchema;
+  STSRow    *pTSRow = NULL;
+  SRowMerger merger = {0};
+  int64_t    version = TSDBROW_VERSION(&rInfo.row);
+
+  if (!tsdbCompactMayDup(pCompactor)) {
+    code = tsdbCompactAppendRow(pCompactor, &rInfo.row, NULL);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbCompactNextRow(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    goto _exit;
+  }
+
+  code = tRowMergerInit(&merger, &rInfo.row, pTSchema);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  code = tRowMergerGetRow(&merger, &pTSRow);
+  tRowMergerClear(&merger);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  while (true) {
+    code = tsdbCompactNextRow(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    SRowInfo *pRowInfo = tsdbCompactGetRow(pCompactor);
+    if (pRowInfo == NULL || !tsdbCompactSameKey(&rInfo, pRowInfo)) break;
+
+    int64_t rowVer = TSDBROW_VERSION(&pRowInfo->row);
+    if (rowVer == version || tsdbCompactRowDeleted(pCompactor, &pRowInfo->row)) continue;
+
+    STSRow *pNewRow = NULL;
+    TSDBROW row = tsdbRowFromTSRow(version, pTSRow);
+    code = tRowMergerInit(&merger, &row, pTSchema);
+    if (code == 0) code = tRowMerge(&merger, &pRowInfo->row);
+    if (code == 0) code = tRowMergerGetRow(&merger, &pNewRow);
+    tRowMergerClear(&merger);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    taosMemoryFree(pTSRow);
+    pTSRow = pNewRow;
+    version = TMAX(version, rowVer);
+  }
+
+  TSDBROW row = tsdbRowFromTSRow(version, pTSRow);
+  code = tsdbCompactAppendRow(pCompactor, &row, pTSchema);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  taosMemoryFree(pTSRow);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+// write the compacted pSet to pCompactor->wSet
+static int32_t tsdbCompactFSet(STsdbCompactor *pCompactor, SDFileSet *pSet, SDiskID did, int64_t commitID) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  code = tsdbCompactOpenReader(pCompactor, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // the compacted set replaces every file of the old one
+  SHeadFile fHead = {.commitID = commitID};
+  SDataFile fData = {.commitID = commitID};
+  SSmaFile  fSma = {.commitID = commitID};
+  SSttFile  fStt = {.commitID = commitID};
+  SDFileSet wSet = {.diskId = did,
+                    .fid = pSet->fid,
+                    .pHeadF = &fHead,
+                    .pDataF = &fData,
+                    .pSmaF = &fSma,
+                    .nSttF = 1,
+                    .aSttF = {&fStt}};
+  code = tsdbDataFWriterOpen(&pCompactor->pWriter, pCompactor->pTsdb, &wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  pCompactor->pWriter->ioClass = pCompactor->ioClass;
+
+  TABLEID   id = {0};
+  SRowInfo *pRowInfo;
+  while ((pRowInfo = tsdbCompactGetRow(pCompactor)) != NULL) {
+    if (pRowInfo->suid != id.suid || pRowInfo->uid != id.uid) {
+      // give up at a table boundary once the background task of the vnode is stopped
+      if (atomic_load_8(&pCompactor->pTsdb->pVnode->bgStop)) {
+        code = TSDB_CODE_VND_BG_TASK_STOPPED;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
+      code = tsdbCompactTableEnd(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      id = (TABLEID){.suid = pRowInfo->suid, .uid = pRowInfo->uid};
+      code = tsdbCompactTableStart(pCompactor, &id);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    if (pCompactor->skip || tsdbCompactRowDeleted(pCompactor, &pRowInfo->row)) {
+      code = tsdbCompactNextRow(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      continue;
+    }
+
+    code = tsdbCompactWriteRow(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbCompactTableEnd(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteBlockIdx(pCompactor->pWriter, pCompactor->aBlockIdxN);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteSttBlk(pCompactor->pWriter, pCompactor->aSttBlk);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDFileSetHeader(pCompactor->pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbDataFReaderClose(&pCompactor->pReader);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tsdbDFileSetToVal(&pCompactor->pWriter->wSet, &pCompactor->wSet);
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactorOpen(STsdbCompactor *pCompactor, STsdb *pTsdb, STsdbFS *pFS) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  pCompactor->pTsdb = pTsdb;
+  pCompactor->pFS = pFS;
+  pCompactor->minutes = pTsdb->keepCfg.days;
+  pCompactor->precision = pTsdb->keepCfg.precision;
+  pCompactor->maxRow = pTsdb->pVnode->config.tsdbCfg.maxRows;
+  pCompactor->cmprAlg = pTsdb->pVnode->config.tsdbCfg.compression;
+  pCompactor->ioClass = VND_IO_COMPACT;
+  pCompactor->stMs = taosGetTimestampMs();
+
+  if ((pCompactor->aDelIdx = taosArrayInit(0, sizeof(SDelIdx))) == NULL ||
+      (pCompactor->aDelData = taosArrayInit(0, sizeof(SDelData))) == NULL ||
+      (pCompactor->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx))) == NULL ||
+      (pCompactor->aBlockIdxN = taosArrayInit(0, sizeof(SBlockIdx))) == NULL ||
+      (pCompactor->aSttBlk = taosArrayInit(0, sizeof(SSttBlk))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tBlockDataCreate(&pCompactor->bData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    code = tBlockDataCreate(&pCompactor->aIter[iIter].bData);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (pCompactor->pFS->pDelFile) {
+    code = tsdbDelFReaderOpen(&pCompactor->pDelFReader, pCompactor->pFS->pDelFile, pTsdb);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbReadDelIdx(pCompactor->pDelFReader, pCompactor->aDelIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactorClose(STsdbCompactor *pCompactor) {
+  if (pCompactor->pWriter) tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+  if (pCompactor->pReader) tsdbDataFReaderClose(&pCompactor->pReader);
+  if (pCompactor->pDelFReader) tsdbDelFReaderClose(&pCompactor->pDelFReader);
+
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    SCompactIter *pIter = &pCompactor->aIter[iIter];
+    if (iIter == 0) {
+      tMapDataClear(&pIter->mDataBlk);
+    } else {
+      taosArrayDestroy(pIter->aSttBlk);
+    }
+    tBlockDataDestroy(&pIter->bData, 1);
+  }
+
+  tBlockDataDestroy(&pCompactor->bData, 1);
+  tMapDataClear(&pCompactor->mDataBlk);
+  tTSchemaDestroy(pCompactor->skm.pTSchema);
+  taosArrayDestroy(pCompactor->aSttBlk);
+  taosArrayDestroy(pCompactor->aBlockIdxN);
+  taosArrayDestroy(pCompactor->aBlockIdx);
+  taosArrayDestroy(pCompactor->aDelData);
+  taosArrayDestroy(pCompactor->aDelIdx);
+}
+
+// remove the files a compaction wrote, possibly only in part, the names of all of them carry commitID
+static void tsdbCompactRemoveFiles(STsdb *pTsdb, SDiskID did, int32_t fid, int64_t commitID) {
+  SHeadFile fHead = {.commitID = commitID};
+  SDataFile fData = {.commitID = commitID};
+  SSmaFile  fSma = {.commitID = commitID};
+  SSttFile  fStt = {.commitID = commitID};
+  SDFileSet wSet = {
+      .diskId = did, .fid = fid, .pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma, .nSttF = 1, .aSttF = {&fStt}};
+
+  tsdbDFileSetRemove(pTsdb, &wSet);
+}
+
+// Rewrite the file set with the highest read amplification into one .data file of non-overlapping blocks, with its
+// .stt files merged, duplicated keys combined and deleted rows dropped, at most one file set per call; commitID names
+// the new files. The set is read from referenced files without blocking commits, the result is installed under
+// tsdbLockFS only if no commit or retention changed the set meanwhile, and dropped otherwise.
+int32_t tsdbCompact(STsdb *pTsdb, int64_t commitID) {
+  int32_t        code = 0;
+  int32_t        lino = 0;
+  STsdbFS        fsRef = {0};
+  STsdbFS        fs = {0};
+  STsdbCompactor compactor = {0};
+  SDFileSet     *pSet = NULL;
+  SDFileSetVal   base = {0};
+  double         score = 0;
+  int32_t        fid = 0;
+  bool           written = false;
+
+  if (!tsCompactEnable) return code;
+
+  if (pTsdb->pCompactMark == NULL) {
+    pTsdb->pCompactMark = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_NO_LOCK);
+    if (pTsdb->pCompactMark == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  // read before the files are referenced, every tombstone up to it is in the .del file then
+  int64_t committed = atomic_load_64(&pTsdb->pVnode->state.committed);
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &fsRef);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (taosArrayGetSize(fsRef.aDFileSet) == 0) goto _exit;
+
+  code = tsdbCompactorOpen(&compactor, pTsdb, &fsRef);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactPickFSet(&compactor, &pSet, &score);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (pSet == NULL) goto _exit;
+
+  fid = pSet->fid;
+  tsdbDFileSetToVal(pSet, &base);
+
+  written = true;
+  code = tsdbCompactFSet(&compactor, pSet, pSet->diskId, commitID);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // install
+  tsdbLockFS(pTsdb);
+
+  code = tsdbFSCopy(pTsdb, &fs);
+  if (code == 0) {
+    SDFileSet  tSet = {.fid = fid};
+    SDFileSet *pSetN = (SDFileSet *)taosArraySearch(fs.aDFileSet, &tSet, tDFileSetCmprFn, TD_EQ);
+    if (pSetN == NULL || !tsdbDFileSetSameVal(pSetN, &base)) {
+      tsdbUnlockFS(pTsdb);
+      tsdbInfo("vgId:%d, tsdb compact fid:%d dropped, the file set changed meanwhile", TD_VID(pTsdb->pVnode), fid);
+      goto _exit;
+    }
+
+    SDFileSet wSet;
+    tsdbDFileSetFromVal(&compactor.wSet, &wSet);
+    code = tsdbFSUpsertFSet(&fs, &wSet);
+  }
+
+  if (code == 0) {
+    code = tsdbFSPrepareCommit(pTsdb, &fs);
+  }
+
+  if (code == 0) {
+    taosThreadRwlockWrlock(&pTsdb->rwLock);
+    code = tsdbFSCommit(pTsdb);
+    taosThreadRwlockUnlock(&pTsdb->rwLock);
+  }
+
+  if (code) {
+    tsdbFSRollback(pTsdb);
+  } else {
+    written = false;
+  }
+
+  tsdbUnlockFS(pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // the new .data file reflects every tombstone that was in the .del file
+  SCompactMark mark = {.headID = commitID, .maxVer = committed};
+  (void)taosHashPut(pTsdb->pCompactMark, &fid, sizeof(fid), &mark, sizeof(mark));
+
+  tsdbInfo("vgId:%d, tsdb compact fid:%d score:%.2f nStt:%d, read %" PRId64 " bytes in %" PRId64 "ms",
+           TD_VID(pTsdb->pVnode), fid, score, base.nSttF, compactor.nRead, taosGetTimestampMs() - compactor.stMs);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  tsdbCompactorClose(&compactor);
+  if (written) {
+    tsdbCompactRemoveFiles(pTsdb, base.diskId, fid, commitID);
+  }
+  tsdbFSDestroy(&fs);
+  if (fsRef.aDFileSet) {
+    tsdbFSUnref(pTsdb, &fsRef);
+  }
+  return code;
+}
+
+// Rewrite pSet of pFS the same way into the disk did to pSetN. The blocks keep the maxRows of the database, readers size
+// their buffers by it, and are compressed in two stages as the cold data is seldom read. Each block records its own
+// algorithm. All the new files are named by commitID, they are removed if the rewrite fails.
+int32_t tsdbRewriteFSet(STsdb *pTsdb, STsdbFS *pFS, SDFileSet *pSet, SDiskID did, int64_t commitID,
+                        SDFileSetVal *pSetN) {
+  int32_t        code = 0;
+  int32_t        lino = 0;
+  STsdbCompactor compactor = {0};
+
+  code = tsdbCompactorOpen(&compactor, pTsdb, pFS);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  compactor.ioClass = VND_IO_MIGRATE;
+  compactor.cmprAlg = TWO_STAGE_COMP;
+
+  code = tsdbCompactFSet(&compactor, pSet, did, commitID);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  *pSetN = compactor.wSet;
+
+  tsdbInfo("vgId:%d, tsdb rewrite fid:%d to level:%d id:%d, read %" PRId64 " bytes in %" PRId64 "ms",
+           TD_VID(pTsdb->pVnode), pSet->fid, did.level, did.id, compactor.nRead,
+           taosGetTimestampMs() - compactor.stMs);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  tsdbCompactorClose(&compactor);
+  if (code) {
+    tsdbCompactRemoveFiles(pTsdb, did, pSet->fid, commitID);
+  }
   return code;
 }
@@ -934,6 +934,7 @@ int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet) {
     SDFileSet *pDFileSet = (SDFileSet *)taosArrayGet(pFS->aDFileSet, idx);
     int32_t    c = tDFileSetCmprFn(pSet, pDFileSet);
     if (c == 0) {
+      pDFileSet->diskId = pSet->diskId;
       *pDFileSet->pHeadF = *pSet->pHeadF;
       *pDFileSet->pDataF = *pSet->pDataF;
       *pDFileSet->pSmaF = *pSet->pSmaF;
@@ -1010,6 +1011,64 @@ _exit:
   return code;
 }
 
+void tsdbDFileSetToVal(SDFileSet *pSet, SDFileSetVal *pVal) {
+  pVal->diskId = pSet->diskId;
+  pVal->fid = pSet->fid;
+  pVal->fHead = *pSet->pHeadF;
+  pVal->fData = *pSet->pDataF;
+  pVal->fSma = *pSet->pSmaF;
+  pVal->nSttF = pSet->nSttF;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pVal->aSttF[iStt] = *pSet->aSttF[iStt];
+  }
+}
+
+// pSet points to the files of pVal
+void tsdbDFileSetFromVal(SDFileSetVal *pVal, SDFileSet *pSet) {
+  pSet->diskId = pVal->diskId;
+  pSet->fid = pVal->fid;
+  pSet->pHeadF = &pVal->fHead;
+  pSet->pDataF = &pVal->fData;
+  pSet->pSmaF = &pVal->fSma;
+  pSet->nSttF = pVal->nSttF;
+  for (int32_t iStt = 0; iStt < pVal->nSttF; iStt++) {
+    pSet->aSttF[iStt] = &pVal->aSttF[iStt];
+  }
+}
+
+bool tsdbDFileSetSameVal(SDFileSet *pSet, SDFileSetVal *pVal) {
+  if (pSet->fid != pVal->fid || pSet->diskId.level != pVal->diskId.level || pSet->diskId.id != pVal->diskId.id) {
+    return false;
+  }
+  if (pSet->pHeadF->commitID != pVal->fHead.commitID || pSet->pHeadF->size != pVal->fHead.size) return false;
+  if (pSet->pDataF->commitID != pVal->fData.commitID || pSet->pDataF->size != pVal->fData.size) return false;
+  if (pSet->pSmaF->commitID != pVal->fSma.commitID || pSet->pSmaF->size != pVal->fSma.size) return false;
+  if (pSet->nSttF != pVal->nSttF) return false;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->commitID != pVal->aSttF[iStt].commitID ||
+        pSet->aSttF[iStt]->size != pVal->aSttF[iStt].size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// remove the files of a set that was written but not installed
+void tsdbDFileSetRemove(STsdb *pTsdb, SDFileSet *pSet) {
+  char fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  (void)taosRemoveFile(fname);
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
+    (void)taosRemoveFile(fname);
+  }
+}
+
 int32_t tsdbFSPrepareCommit(STsdb *pTsdb, STsdbFS *pFSNew) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -1028,6 +1087,16 @@ _exit:
   return code;
 }
 
+// A commit, a compaction or a retention copies the file set, changes the copy and installs it, each of them holds the
+// lock from the copy to the install so that none installs a copy that misses the change of another.
+void tsdbLockFS(STsdb *pTsdb) {
+  if (pTsdb) taosThreadMutexLock(&pTsdb->fsMutex);
+}
+
+void tsdbUnlockFS(STsdb *pTsdb) {
+  if (pTsdb) taosThreadMutexUnlock(&pTsdb->fsMutex);
+}
+
 int32_t tsdbFSRef(STsdb *pTsdb, STsdbFS *pFS) {
   int32_t code = 0;
   int32_t nRef;
@@ -44,6 +44,7 @@ int32_t tsdbMemTableCreate(STsdb *pTsdb, SMemTable **ppMemTable) {
   pMemTable->pTsdb = pTsdb;
   pMemTable->pPool = pTsdb->pVnode->inUse;
   pMemTable->nRef = 1;
+  pMemTable->commitID = pTsdb->pVnode->state.commitID;
   pMemTable->minKey = TSKEY_MAX;
   pMemTable->maxKey = TSKEY_MIN;
   pMemTable->nRow = 0;
@@ -562,7 +563,10 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
 
   // backward put first data
   row.pTSRow = tGetSubmitBlkNext(&blkIter);
-  if (row.pTSRow == NULL) return code;
+  if (row.pTSRow == NULL) {
+    tDestroySubmitBlkIter(&blkIter);
+    return code;
+  }
 
   key.ts = row.pTSRow->ts;
   nRow++;
@@ -619,9 +623,11 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
   pRsp->numOfRows = nRow;
   pRsp->affectedRows = nRow;
 
+  tDestroySubmitBlkIter(&blkIter);
   return code;
 
 _err:
+  tDestroySubmitBlkIter(&blkIter);
   return code;
 }
 
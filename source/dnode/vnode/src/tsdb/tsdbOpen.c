@@ -52,6 +52,7 @@ int tsdbOpen(SVnode *pVnode, STsdb **ppTsdb, const char *dir, STsdbKeepCfg *pKee
   taosRealPath(pTsdb->path, NULL, slen);
   pTsdb->pVnode = pVnode;
   taosThreadRwlockInit(&pTsdb->rwLock, NULL);
+  taosThreadMutexInit(&pTsdb->fsMutex, NULL);
   if (!pKeepCfg) {
     tsdbSetKeepCfg(pTsdb, &pVnode->config.tsdbCfg);
   } else {
@@ -81,6 +82,8 @@ int tsdbOpen(SVnode *pVnode, STsdb **ppTsdb, const char *dir, STsdbKeepCfg *pKee
   return 0;
 
 _err:
+  taosThreadMutexDestroy(&pTsdb->fsMutex);
+  taosThreadRwlockDestroy(&pTsdb->rwLock);
   taosMemoryFree(pTsdb);
   return -1;
 }
@@ -93,6 +96,8 @@ int tsdbClose(STsdb **pTsdb) {
     taosThreadRwlockUnlock(&(*pTsdb)->rwLock);
 
     taosThreadRwlockDestroy(&(*pTsdb)->rwLock);
+    taosThreadMutexDestroy(&(*pTsdb)->fsMutex);
+    taosHashCleanup((*pTsdb)->pCompactMark);
 
     tsdbFSClose(*pTsdb);
     tsdbCloseCache(*pTsdb);
@@ -15,6 +15,8 @@
 
 #include "tsdb.h"
 
+#define TSDB_COPY_CHUNK_SIZE (4 * 1024 * 1024)
+
 // =============== PAGE-WISE FILE ===============
 static int32_t tsdbOpenFile(const char *path, int32_t szPage, int32_t flag, STsdbFD **ppFD) {
   int32_t  code = 0;
@@ -228,6 +230,7 @@ int32_t tsdbDataFWriterOpen(SDataFWriter **ppWriter, STsdb *pTsdb, SDFileSet *pS
     goto _err;
   }
   pWriter->pTsdb = pTsdb;
+  pWriter->ioClass = VND_IO_NONE;
   pWriter->wSet = (SDFileSet){.diskId = pSet->diskId,
                               .fid = pSet->fid,
                               .pHeadF = &pWriter->fHead,
@@ -593,6 +596,8 @@ int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlock
   } else {
     pWriter->fData.size += pBlkInfo->szBlock;
   }
+  code = vnodeIoAcquire(pWriter->pTsdb->pVnode, pWriter->ioClass, pBlkInfo->szBlock);
+  if (code) goto _err;
 
   // ================= SMA ====================
   if (pSmaInfo) {
@@ -700,6 +705,8 @@ int32_t tsdbWriteDiskData(SDataFWriter *pWriter, const SDiskData *pDiskData, SBl
     }
   }
 
+  code = vnodeIoAcquire(pWriter->pTsdb->pVnode, pWriter->ioClass, pBlkInfo->szBlock);
+  TSDB_CHECK_CODE(code, lino, _exit);
   if (pSmaInfo) {
     pWriter->fData.size += pBlkInfo->szBlock;
   } else {
@@ -737,10 +744,25 @@ _exit:
   return code;
 }
 
-int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
+// copy size bytes from the current offsets, charged to ioClass chunk by chunk
+static int32_t tsdbCopyFile(STsdb *pTsdb, TdFilePtr pOutFD, TdFilePtr pInFD, int64_t size, int8_t ioClass) {
+  int64_t nCopied = 0;
+
+  while (nCopied < size) {
+    int64_t n = taosFSendFile(pOutFD, pInFD, NULL, TMIN(size - nCopied, TSDB_COPY_CHUNK_SIZE));
+    if (n < 0) return TAOS_SYSTEM_ERROR(errno);
+    if (n == 0) break;
+    nCopied += n;
+
+    int32_t code = vnodeIoAcquire(pTsdb->pVnode, ioClass, n);
+    if (code) return code;
+  }
+
+  return 0;
+}
+
+int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo, int8_t ioClass) {
   int32_t   code = 0;
-  int64_t   n;
-  int64_t   size;
   TdFilePtr pOutFD = NULL;
   TdFilePtr PInFD = NULL;
   int32_t   szPage = pTsdb->pVnode->config.szPage;
@@ -760,11 +782,8 @@ int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _err;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
+  code = tsdbCopyFile(pTsdb, pOutFD, PInFD, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage), ioClass);
+  if (code) goto _err;
   taosCloseFile(&pOutFD);
   taosCloseFile(&PInFD);
 
@@ -781,11 +800,8 @@ int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _err;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, LOGIC_TO_FILE_OFFSET(pSetFrom->pDataF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
+  code = tsdbCopyFile(pTsdb, pOutFD, PInFD, LOGIC_TO_FILE_OFFSET(pSetFrom->pDataF->size, szPage), ioClass);
+  if (code) goto _err;
   taosCloseFile(&pOutFD);
   taosCloseFile(&PInFD);
 
@@ -802,11 +818,8 @@ int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _err;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
+  code = tsdbCopyFile(pTsdb, pOutFD, PInFD, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage), ioClass);
+  if (code) goto _err;
   taosCloseFile(&pOutFD);
   taosCloseFile(&PInFD);
 
@@ -824,11 +837,8 @@ int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
       code = TAOS_SYSTEM_ERROR(errno);
       goto _err;
     }
-    n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage));
-    if (n < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
+    code = tsdbCopyFile(pTsdb, pOutFD, PInFD, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage), ioClass);
+    if (code) goto _err;
     taosCloseFile(&pOutFD);
     taosCloseFile(&PInFD);
   }
@@ -836,6 +846,8 @@ int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
   return code;
 
 _err:
+  taosCloseFile(&pOutFD);
+  taosCloseFile(&PInFD);
   tsdbError("vgId:%d, tsdb DFileSet copy failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
   return code;
 }
@@ -856,6 +868,7 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   }
   pReader->pTsdb = pTsdb;
   pReader->pSet = pSet;
+  pReader->ioClass = VND_IO_NONE;
 
   // head
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
@@ -1065,6 +1078,7 @@ _err:
 static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
                                      int32_t iStt) {
   int32_t code = 0;
+  int64_t nRead = 0;
 
   tBlockDataClear(pBlockData);
 
@@ -1076,6 +1090,7 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
   code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
   if (code) goto _err;
+  nRead += pBlkInfo->szKey;
 
   SDiskDataHdr hdr;
   uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
@@ -1122,6 +1137,7 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
     code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
     if (code) goto _err;
+    nRead += hdr.szBlkCol;
   }
 
   SBlockCol  blockCol = {.cid = 0};
@@ -1166,6 +1182,7 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
         code = tsdbReadFile(pFD, offset, pReader->aBuf[1], size);
         if (code) goto _err;
+        nRead += size;
 
         code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr.cmprAlg, hdr.nRow, pColData, &pReader->aBuf[2]);
         if (code) goto _err;
@@ -1174,6 +1191,8 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
   }
 
 _exit:
+  // only the columns asked for are read
+  code = vnodeIoAcquire(pReader->pTsdb->pVnode, pReader->ioClass, nRead);
   return code;
 
 _err:
@@ -1192,6 +1211,8 @@ int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockDat
   // read
   code = tsdbReadFile(pReader->pDataFD, pBlockInfo->offset, pReader->aBuf[0], pBlockInfo->szBlock);
   if (code) goto _err;
+  code = vnodeIoAcquire(pReader->pTsdb->pVnode, pReader->ioClass, pBlockInfo->szBlock);
+  if (code) goto _err;
 
   // decmpr
   code = tDecmprBlockData(pReader->aBuf[0], pBlockInfo->szBlock, pBlockData, &pReader->aBuf[1]);
@@ -1287,6 +1308,8 @@ int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk
   // read
   code = tsdbReadFile(pReader->aSttFD[iStt], pSttBlk->bInfo.offset, pReader->aBuf[0], pSttBlk->bInfo.szBlock);
   TSDB_CHECK_CODE(code, lino, _exit);
+  code = vnodeIoAcquire(pReader->pTsdb->pVnode, pReader->ioClass, pSttBlk->bInfo.szBlock);
+  TSDB_CHECK_CODE(code, lino, _exit);
 
   // decmpr
   code = tDecmprBlockData(pReader->aBuf[0], pSttBlk->bInfo.szBlock, pBlockData, &pReader->aBuf[1]);
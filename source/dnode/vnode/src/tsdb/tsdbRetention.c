@@ -15,98 +15,197 @@
 
 #include "tsdb.h"
 
-static bool tsdbShouldDoRetention(STsdb *pTsdb, int64_t now) {
-  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
-    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
-    int32_t    expLevel = tsdbFidLevel(pSet->fid, &pTsdb->keepCfg, now);
-    SDiskID    did;
+// the newest commit ID of a file set, it names all the files of the set once rewritten to another disk
+static int64_t tsdbFSetCommitID(SDFileSet *pSet) {
+  int64_t commitID = TMAX(pSet->pHeadF->commitID, TMAX(pSet->pDataF->commitID, pSet->pSmaF->commitID));
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    commitID = TMAX(commitID, pSet->aSttF[iStt]->commitID);
+  }
+  return commitID;
+}
 
-    if (expLevel == pSet->diskId.level) continue;
+typedef struct {
+  SDFileSetVal oSet;  // the set as read
+  SDFileSetVal nSet;  // its files on the new disk
+  int8_t       installed;
+} SRetentionMove;
 
-    if (expLevel < 0) {
-      return true;
-    } else {
-      if (tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &did) < 0) {
-        return false;
-      }
+// copy or rewrite pSet to the disk did, a set the rewrite fails on is copied as is
+static int32_t tsdbRetentionMove(STsdb *pTsdb, STsdbFS *pFS, SDFileSet *pSet, SDiskID did, SRetentionMove *pMove) {
+  int32_t code = 0;
 
-      if (did.level == pSet->diskId.level) continue;
+  tsdbDFileSetToVal(pSet, &pMove->oSet);
+  pMove->installed = 0;
 
-      return true;
-    }
+  if (tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, did) < 0) {
+    return terrno;
   }
 
-  return false;
-}
+  if (tsRetentionRewrite) {
+    // cold data is scanned in bulk, merge its .stt files and drop the deleted rows on the way down
+    code = tsdbRewriteFSet(pTsdb, pFS, pSet, did, tsdbFSetCommitID(pSet), &pMove->nSet);
+    if (code == 0 || code == TSDB_CODE_VND_BG_TASK_STOPPED) return code;
 
-int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now) {
-  int32_t code = 0;
+    tsdbWarn("vgId:%d, tsdb rewrite fid:%d failed since %s, copy it instead", TD_VID(pTsdb->pVnode), pSet->fid,
+             tstrerror(code));
+  }
+
+  SDFileSet fSet;
+  pMove->nSet = pMove->oSet;
+  pMove->nSet.diskId = did;
+  tsdbDFileSetFromVal(&pMove->nSet, &fSet);
 
-  if (!tsdbShouldDoRetention(pTsdb, now)) {
-    return code;
+  code = tsdbDFileSetCopy(pTsdb, pSet, &fSet, VND_IO_MIGRATE);
+  if (code) {
+    tsdbDFileSetRemove(pTsdb, &fSet);
   }
+  return code;
+}
 
-  // do retention
+// Drop the expired file sets and move the others to the tier of their age. The files are copied or rewritten from a
+// referenced view without the file set lock, so commits go on meanwhile; a moved set is installed under the lock only
+// if no commit changed it, and left for the next run otherwise. Runs as a background task of the vnode, and gives up
+// without installing anything once vnodeStopBgTask is called.
+int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdbFS fsRef = {0};
   STsdbFS fs = {0};
+  SArray *aDrop = NULL;  // SArray<int32_t>, fids of the expired sets
+  SArray *aMove = NULL;  // SArray<SRetentionMove>
 
-  code = tsdbFSCopy(pTsdb, &fs);
-  if (code) goto _err;
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &fsRef);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if ((aDrop = taosArrayInit(0, sizeof(int32_t))) == NULL ||
+      (aMove = taosArrayInit(0, sizeof(SRetentionMove))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
-  for (int32_t iSet = 0; iSet < taosArrayGetSize(fs.aDFileSet); iSet++) {
-    SDFileSet *pSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, iSet);
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(fsRef.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(fsRef.aDFileSet, iSet);
     int32_t    expLevel = tsdbFidLevel(pSet->fid, &pTsdb->keepCfg, now);
     SDiskID    did;
 
+    if (atomic_load_8(&pTsdb->pVnode->bgStop)) {
+      code = TSDB_CODE_VND_BG_TASK_STOPPED;
+      goto _exit;
+    }
+
     if (expLevel < 0) {
-      taosMemoryFree(pSet->pHeadF);
-      taosMemoryFree(pSet->pDataF);
-      taosMemoryFree(pSet->aSttF[0]);
-      taosMemoryFree(pSet->pSmaF);
-      taosArrayRemove(fs.aDFileSet, iSet);
-      iSet--;
-    } else {
-      if (expLevel == 0) continue;
-      if (tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &did) < 0) {
-        code = terrno;
-        goto _exit;
+      if (taosArrayPush(aDrop, &pSet->fid) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
       }
+      continue;
+    }
 
-      if (did.level == pSet->diskId.level) continue;
+    if (expLevel == 0 || expLevel == pSet->diskId.level) continue;
+    if (tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &did) < 0) {
+      code = terrno;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    if (did.level == pSet->diskId.level) continue;
+
+    SRetentionMove move;
+    code = tsdbRetentionMove(pTsdb, &fsRef, pSet, did, &move);
+    if (code == TSDB_CODE_VND_BG_TASK_STOPPED) goto _exit;
+    if (code) {
+      // the set stays where it is until the next run, the others are still moved
+      tsdbError("vgId:%d, tsdb retention of fid:%d to level:%d skipped since %s", TD_VID(pTsdb->pVnode), pSet->fid,
+                did.level, tstrerror(code));
+      code = 0;
+      continue;
+    }
+
+    if (taosArrayPush(aMove, &move) == NULL) {
+      SDFileSet fSet;
+      tsdbDFileSetFromVal(&move.nSet, &fSet);
+      tsdbDFileSetRemove(pTsdb, &fSet);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
 
-      // copy file to new disk (todo)
-      SDFileSet fSet = *pSet;
-      fSet.diskId = did;
+  if (taosArrayGetSize(aDrop) == 0 && taosArrayGetSize(aMove) == 0) goto _exit;
 
-      code = tsdbDFileSetCopy(pTsdb, pSet, &fSet);
-      if (code) goto _err;
+  // install
+  tsdbLockFS(pTsdb);
 
-      code = tsdbFSUpsertFSet(&fs, &fSet);
-      if (code) goto _err;
+  code = tsdbFSCopy(pTsdb, &fs);
+  for (int32_t iDrop = 0; code == 0 && iDrop < taosArrayGetSize(aDrop); iDrop++) {
+    SDFileSet tSet = {.fid = *(int32_t *)taosArrayGet(aDrop, iDrop)};
+    int32_t   idx = taosArraySearchIdx(fs.aDFileSet, &tSet, tDFileSetCmprFn, TD_EQ);
+    if (idx < 0) continue;
+
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, idx);
+    taosMemoryFree(pSet->pHeadF);
+    taosMemoryFree(pSet->pDataF);
+    taosMemoryFree(pSet->pSmaF);
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      taosMemoryFree(pSet->aSttF[iStt]);
     }
+    taosArrayRemove(fs.aDFileSet, idx);
   }
 
-  // do change fs
-  code = tsdbFSPrepareCommit(pTsdb, &fs);
-  if (code) goto _err;
+  for (int32_t iMove = 0; code == 0 && iMove < taosArrayGetSize(aMove); iMove++) {
+    SRetentionMove *pMove = (SRetentionMove *)taosArrayGet(aMove, iMove);
+    SDFileSet       tSet = {.fid = pMove->oSet.fid};
+    SDFileSet      *pSet = (SDFileSet *)taosArraySearch(fs.aDFileSet, &tSet, tDFileSetCmprFn, TD_EQ);
+    if (pSet == NULL || !tsdbDFileSetSameVal(pSet, &pMove->oSet)) {
+      tsdbInfo("vgId:%d, tsdb retention of fid:%d dropped, the file set changed meanwhile", TD_VID(pTsdb->pVnode),
+               tSet.fid);
+      continue;
+    }
 
-  taosThreadRwlockWrlock(&pTsdb->rwLock);
+    SDFileSet fSet;
+    tsdbDFileSetFromVal(&pMove->nSet, &fSet);
+    code = tsdbFSUpsertFSet(&fs, &fSet);
+    pMove->installed = 1;
+  }
 
-  code = tsdbFSCommit(pTsdb);
-  if (code) {
+  if (code == 0) {
+    code = tsdbFSPrepareCommit(pTsdb, &fs);
+  }
+
+  if (code == 0) {
+    taosThreadRwlockWrlock(&pTsdb->rwLock);
+    code = tsdbFSCommit(pTsdb);
     taosThreadRwlockUnlock(&pTsdb->rwLock);
-    goto _err;
   }
 
-  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  if (code) {
+    tsdbFSRollback(pTsdb);
+    for (int32_t iMove = 0; iMove < taosArrayGetSize(aMove); iMove++) {
+      ((SRetentionMove *)taosArrayGet(aMove, iMove))->installed = 0;
+    }
+  }
 
-  tsdbFSDestroy(&fs);
+  tsdbUnlockFS(pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
 
 _exit:
+  if (code == TSDB_CODE_VND_BG_TASK_STOPPED) {
+    tsdbInfo("vgId:%d, tsdb retention stopped, the moved file sets are dropped", TD_VID(pTsdb->pVnode));
+  } else if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  for (int32_t iMove = 0; iMove < taosArrayGetSize(aMove); iMove++) {
+    SRetentionMove *pMove = (SRetentionMove *)taosArrayGet(aMove, iMove);
+    if (!pMove->installed) {
+      SDFileSet fSet;
+      tsdbDFileSetFromVal(&pMove->nSet, &fSet);
+      tsdbDFileSetRemove(pTsdb, &fSet);
+    }
+  }
+  taosArrayDestroy(aMove);
+  taosArrayDestroy(aDrop);
+  tsdbFSDestroy(&fs);
+  if (fsRef.aDFileSet) {
+    tsdbFSUnref(pTsdb, &fsRef);
+  }
   return code;
-
-_err:
-  tsdbError("vgId:%d, tsdb do retention failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
-  ASSERT(0);
-  // tsdbFSRollback(pTsdb->pFS);
-  return code;
-}
\ No newline at end of file
+}
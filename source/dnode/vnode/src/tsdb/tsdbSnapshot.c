@@ -84,6 +84,7 @@ static int32_t tsdbSnapReadOpenFile(STsdbSnapReader* pReader) {
   pReader->fid = pSet->fid;
   code = tsdbDataFReaderOpen(&pReader->pDataFReader, pReader->pTsdb, pSet);
   if (code) goto _err;
+  pReader->pDataFReader->ioClass = VND_IO_SNAPSHOT;
 
   pReader->pIter = NULL;
   tRBTreeCreate(&pReader->rbt, tFDataIterCmprFn);
@@ -816,6 +817,7 @@ static int32_t tsdbSnapWriteOpenFile(STsdbSnapWriter* pWriter, int32_t fid) {
   if (pSet) {
     code = tsdbDataFReaderOpen(&pWriter->dReader.pReader, pWriter->pTsdb, pSet);
     if (code) goto _err;
+    pWriter->dReader.pReader->ioClass = VND_IO_SNAPSHOT;
 
     code = tsdbReadBlockIdx(pWriter->dReader.pReader, pWriter->dReader.aBlockIdx);
     if (code) goto _err;
@@ -852,6 +854,7 @@ static int32_t tsdbSnapWriteOpenFile(STsdbSnapWriter* pWriter, int32_t fid) {
 
   code = tsdbDataFWriterOpen(&pWriter->dWriter.pWriter, pWriter->pTsdb, &wSet);
   if (code) goto _err;
+  pWriter->dWriter.pWriter->ioClass = VND_IO_SNAPSHOT;
   taosArrayClear(pWriter->dWriter.aBlockIdx);
   tMapDataReset(&pWriter->dWriter.mDataBlk);
   taosArrayClear(pWriter->dWriter.aSttBlk);
@@ -73,9 +73,8 @@ static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, STable *pTable, STSRow *
 }
 #endif
 
-static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, tb_uid_t uid, STSRow *row, TSKEY minKey, TSKEY maxKey,
+static FORCE_INLINE int tsdbCheckKeyRange(STsdb *pTsdb, tb_uid_t uid, TSKEY rowKey, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now) {
-  TSKEY rowKey = TD_ROW_KEY(row);
   if (rowKey < minKey || rowKey > maxKey) {
     tsdbError("vgId:%d, table uid %" PRIu64 " timestamp is out of range! now %" PRId64 " minKey %" PRId64
               " maxKey %" PRId64 " row key %" PRId64,
@@ -87,6 +86,30 @@ static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, tb_uid_t uid, STSRow *ro
   return 0;
 }
 
+static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, tb_uid_t uid, STSRow *row, TSKEY minKey, TSKEY maxKey,
+                                          TSKEY now) {
+  return tsdbCheckKeyRange(pTsdb, uid, TD_ROW_KEY(row), minKey, maxKey, now);
+}
+
+// column-major block: only the primary key slice is needed, no row is rebuilt
+static int tsdbCheckColBlkRange(STsdb *pTsdb, tb_uid_t uid, SSubmitColBlk *pColBlk, TSKEY minKey, TSKEY maxKey,
+                                TSKEY now) {
+  SColData *pColData = &pColBlk->aColData[0];
+  if (pColData->cid != PRIMARYKEY_TIMESTAMP_COL_ID || pColData->flag != HAS_VALUE) {
+    terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+    return -1;
+  }
+
+  TSKEY *aKey = (TSKEY *)pColData->pData;
+  for (int32_t iRow = 0; iRow < pColBlk->nRow; iRow++) {
+    if (tsdbCheckKeyRange(pTsdb, uid, aKey[iRow], minKey, maxKey, now) < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 int tsdbScanAndConvertSubmitMsg(STsdb *pTsdb, SSubmitReq *pMsg) {
   ASSERT(pMsg != NULL);
   // STsdbMeta *    pMeta = pTsdb->tsdbMeta;
@@ -146,7 +169,17 @@ int tsdbScanAndConvertSubmitMsg(STsdb *pTsdb, SSubmitReq *pMsg) {
       }
     }
 #endif
-    tInitSubmitBlkIter(&msgIter, pBlock, &blkIter);
+    if (tInitSubmitBlkIter(&msgIter, pBlock, &blkIter) < 0 && msgIter.colFmt) {
+      tDestroySubmitBlkIter(&blkIter);
+      return -1;
+    }
+    if (blkIter.pColBlk) {
+      if (tsdbCheckColBlkRange(pTsdb, msgIter.uid, blkIter.pColBlk, minKey, maxKey, now) < 0) {
+        tDestroySubmitBlkIter(&blkIter);
+        return -1;
+      }
+      continue;
+    }
     while ((row = tGetSubmitBlkNext(&blkIter)) != NULL) {
       if (tsdbCheckRowRange(pTsdb, msgIter.uid, row, minKey, maxKey, now) < 0) {
         return -1;
@@ -154,6 +187,7 @@ int tsdbScanAndConvertSubmitMsg(STsdb *pTsdb, SSubmitReq *pMsg) {
     }
   }
 
+  tDestroySubmitBlkIter(&blkIter);
   if (terrno != TSDB_CODE_SUCCESS) return -1;
   return 0;
 }
\ No newline at end of file
@@ -16,7 +16,142 @@
 #include "vnd.h"
 
 /* ------------------------ STRUCTURES ------------------------ */
-#define VNODE_BUFPOOL_SEGMENTS 3
+#define VNODE_BUFPOOL_ANCHOR_SIZE (64 * 1024)
+#define VNODE_BUFPOOL_CHUNK_MIN   (1024 * 1024)
+#define VNODE_BUFPOOL_CHUNK_MAX   (64 * 1024 * 1024)
+#define VNODE_BUFPOOL_SCAN_MS     100    // ms between two scans of the vnodes for memtables to commit
+#define VNODE_BUFPOOL_ASK_MS      10000  // ms before a vnode asked to commit is asked again
+#define VNODE_BUFPOOL_COMMIT_MIN  (1024 * 1024)
+
+// Memtable chunks are lent to the vnodes on demand. The dnode tracks how much is out, and how much of it is held by
+// memtables being committed and about to come back, so that commits are triggered by the global pressure: the vnode
+// with the largest active memtable is asked to commit while the dnode is over its write buffer budget, and idle vnodes
+// are asked to commit their old memtables so that their chunks go back to the others.
+static struct {
+  volatile int64_t used;
+  volatile int64_t frozen;  // bytes of the memtables handed over to commit and not yet released
+  volatile int64_t lastScanMs;
+  TdThreadMutex    mutex;
+  SArray          *aVnode;  // SArray<SVnode *>, the vnodes with a buffer pool
+} vnodeBufMgr = {0};
+
+int32_t vnodeBufPoolInit() {
+  if (taosThreadMutexInit(&vnodeBufMgr.mutex, NULL) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+  vnodeBufMgr.aVnode = taosArrayInit(16, sizeof(SVnode *));
+  if (vnodeBufMgr.aVnode == NULL) {
+    taosThreadMutexDestroy(&vnodeBufMgr.mutex);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  vnodeBufMgr.lastScanMs = 0;
+  return 0;
+}
+
+void vnodeBufPoolCleanup() {
+  taosArrayDestroy(vnodeBufMgr.aVnode);
+  vnodeBufMgr.aVnode = NULL;
+  taosThreadMutexDestroy(&vnodeBufMgr.mutex);
+}
+
+int64_t vnodeBufPoolGetUsed() { return atomic_load_64(&vnodeBufMgr.used); }
+
+static void vnodeBufPoolBorrow(SVnode *pVnode, int64_t size) {
+  atomic_add_fetch_64(&vnodeBufMgr.used, size);
+  atomic_add_fetch_64(&pVnode->bufUsed, size);
+}
+
+// The active memtable may take whatever the vnode buffer has left besides its memtables being committed, and at least
+// its part of it, so a vnode written alone uses all of szBuf while the dnode pressure commits it earlier.
+int64_t vnodeBufPoolGetMaxSize(SVnode *pVnode) {
+  int64_t active = pVnode->inUse ? pVnode->inUse->capacity : 0;
+  int64_t others = atomic_load_64(&pVnode->bufUsed) - active;
+  int64_t szBuf = (int64_t)pVnode->config.szBuf;
+  return TMAX(szBuf - others, szBuf / tsVnodeWriteBufferNum);
+}
+
+// called before the memtable is reset, its capacity is what comes back
+static void vnodeBufPoolRelease(SVBufPool *pPool) {
+  if (!pPool->frozen) return;
+
+  pPool->frozen = false;
+  atomic_sub_fetch_64(&vnodeBufMgr.frozen, pPool->capacity);
+}
+
+void vnodeBufPoolFreeze(SVBufPool *pPool) {
+  ASSERT(!pPool->frozen);
+  pPool->frozen = true;
+  atomic_add_fetch_64(&vnodeBufMgr.frozen, pPool->capacity);
+}
+
+// mark pVnode as asked to commit, at most once per VNODE_BUFPOOL_ASK_MS
+static bool vnodeBufPoolMarkAsked(SVnode *pVnode, int64_t nowMs) {
+  int64_t askMs = atomic_load_64(&pVnode->commitAskMs);
+  return nowMs - askMs >= VNODE_BUFPOOL_ASK_MS &&
+         atomic_val_compare_exchange_64(&pVnode->commitAskMs, askMs, nowMs) == askMs;
+}
+
+// ask the vnode vgId to commit through its write queue, the way a flush does
+static void vnodeBufPoolAskCommit(const SMsgCb *pMsgCb, int32_t vgId) {
+  SMsgHead *pHead = rpcMallocCont(sizeof(SMsgHead));
+  if (pHead == NULL) return;
+  pHead->contLen = htonl(sizeof(SMsgHead));
+  pHead->vgId = htonl(vgId);
+
+  SRpcMsg rpcMsg = {.msgType = TDMT_VND_COMMIT, .pCont = pHead, .contLen = sizeof(SMsgHead)};
+  if (tmsgPutToQueue(pMsgCb, WRITE_QUEUE, &rpcMsg) != 0) {
+    vDebug("vgId:%d, failed to ask to commit since %s", vgId, terrstr());
+  }
+}
+
+// Called by the writes of pVnode. Scans the vnodes at most every VNODE_BUFPOOL_SCAN_MS: while the memory not already
+// on its way back is over the budget, the vnode with the largest active memtable is asked to commit, and so is every
+// vnode with a memtable older than vnodeCommitAge, which an idle vnode would otherwise keep. Writes never stall here.
+void vnodeBufPoolCheckBudget(SVnode *pVnode) {
+  int64_t nowMs = taosGetTimestampMs();
+  int64_t lastMs = atomic_load_64(&vnodeBufMgr.lastScanMs);
+  if (nowMs - lastMs < VNODE_BUFPOOL_SCAN_MS ||
+      atomic_val_compare_exchange_64(&vnodeBufMgr.lastScanMs, lastMs, nowMs) != lastMs) {
+    return;
+  }
+
+  int64_t used = vnodeBufPoolGetUsed();
+  bool    over = used - atomic_load_64(&vnodeBufMgr.frozen) > tsVnodeWriteBufferSize;
+  SVnode *pLargest = NULL;
+  int64_t largest = VNODE_BUFPOOL_COMMIT_MIN - 1;
+  SArray *aVgId = taosArrayInit(4, sizeof(int32_t));
+  if (aVgId == NULL) return;
+
+  taosThreadMutexLock(&vnodeBufMgr.mutex);
+  for (int32_t i = 0; i < taosArrayGetSize(vnodeBufMgr.aVnode); i++) {
+    SVnode *pVnodeT = *(SVnode **)taosArrayGet(vnodeBufMgr.aVnode, i);
+    // read aside the write thread of the vnode, its pools live as long as it is in the list
+    SVBufPool *pPool = atomic_load_ptr(&pVnodeT->inUse);
+    if (pPool == NULL || pPool->size == 0) continue;
+
+    bool old = nowMs - pPool->firstTs > tsVnodeCommitAge * 1000LL;
+    if (old && vnodeBufPoolMarkAsked(pVnodeT, nowMs)) {
+      taosArrayPush(aVgId, &TD_VID(pVnodeT));
+    } else if (!old && over && pPool->capacity > largest) {
+      largest = pPool->capacity;
+      pLargest = pVnodeT;
+    }
+  }
+  if (pLargest && vnodeBufPoolMarkAsked(pLargest, nowMs)) {
+    taosArrayPush(aVgId, &TD_VID(pLargest));
+    vDebug("vgId:%d, asked to commit a memtable of %" PRId64 " bytes, dnode used:%" PRId64 " budget:%" PRId64,
+           TD_VID(pLargest), largest, used, tsVnodeWriteBufferSize);
+  }
+  taosThreadMutexUnlock(&vnodeBufMgr.mutex);
+
+  // sent without the lock, the queues are looked up under the locks of the dnode
+  for (int32_t i = 0; i < taosArrayGetSize(aVgId); i++) {
+    vnodeBufPoolAskCommit(&pVnode->msgCb, *(int32_t *)taosArrayGet(aVgId, i));
+  }
+  taosArrayDestroy(aVgId);
+}
 
 static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool) {
   SVBufPool *pPool;
@@ -37,18 +172,25 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool)
   pPool->pVnode = pVnode;
   pPool->nRef = 0;
   pPool->size = 0;
+  pPool->capacity = size;
+  pPool->firstTs = 0;
+  pPool->frozen = false;
   pPool->ptr = pPool->node.data;
   pPool->pTail = &pPool->node;
   pPool->node.prev = NULL;
   pPool->node.pnext = &pPool->pTail;
   pPool->node.size = size;
 
+  vnodeBufPoolBorrow(pVnode, size);
+
   *ppPool = pPool;
   return 0;
 }
 
 static int vnodeBufPoolDestroy(SVBufPool *pPool) {
+  vnodeBufPoolRelease(pPool);
   vnodeBufPoolReset(pPool);
+  vnodeBufPoolBorrow(pPool->pVnode, -pPool->node.size);
   taosThreadSpinDestroy(&pPool->lock);
   taosMemoryFree(pPool);
   return 0;
@@ -56,13 +198,12 @@ static int vnodeBufPoolDestroy(SVBufPool *pPool) {
 
 int vnodeOpenBufPool(SVnode *pVnode) {
   SVBufPool *pPool = NULL;
-  int64_t    size = pVnode->config.szBuf / VNODE_BUFPOOL_SEGMENTS;
 
   ASSERT(pVnode->pPool == NULL);
 
-  for (int i = 0; i < 3; i++) {
+  for (int i = 0; i < tsVnodeWriteBufferNum; i++) {
     // create pool
-    if (vnodeBufPoolCreate(pVnode, size, &pPool)) {
+    if (vnodeBufPoolCreate(pVnode, VNODE_BUFPOOL_ANCHOR_SIZE, &pPool)) {
       vError("vgId:%d, failed to open vnode buffer pool since %s", TD_VID(pVnode), tstrerror(terrno));
       vnodeCloseBufPool(pVnode);
       return -1;
@@ -73,13 +214,33 @@ int vnodeOpenBufPool(SVnode *pVnode) {
     pVnode->pPool = pPool;
   }
 
-  vDebug("vgId:%d, vnode buffer pool is opened, size:%" PRId64, TD_VID(pVnode), size);
+  taosThreadMutexLock(&vnodeBufMgr.mutex);
+  void *p = taosArrayPush(vnodeBufMgr.aVnode, &pVnode);
+  taosThreadMutexUnlock(&vnodeBufMgr.mutex);
+  if (p == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    vnodeCloseBufPool(pVnode);
+    return -1;
+  }
+
+  vDebug("vgId:%d, vnode buffer pool is opened, max size:%" PRId64 ", dnode used:%" PRId64, TD_VID(pVnode),
+         pVnode->config.szBuf, vnodeBufPoolGetUsed());
   return 0;
 }
 
 int vnodeCloseBufPool(SVnode *pVnode) {
   SVBufPool *pPool;
 
+  // out of the list before the pools go away
+  taosThreadMutexLock(&vnodeBufMgr.mutex);
+  for (int32_t i = 0; i < taosArrayGetSize(vnodeBufMgr.aVnode); i++) {
+    if (*(SVnode **)taosArrayGet(vnodeBufMgr.aVnode, i) == pVnode) {
+      taosArrayRemove(vnodeBufMgr.aVnode, i);
+      break;
+    }
+  }
+  taosThreadMutexUnlock(&vnodeBufMgr.mutex);
+
   for (pPool = pVnode->pPool; pPool; pPool = pVnode->pPool) {
     pVnode->pPool = pPool->next;
     vnodeBufPoolDestroy(pPool);
@@ -89,6 +250,7 @@ int vnodeCloseBufPool(SVnode *pVnode) {
     vnodeBufPoolDestroy(pVnode->inUse);
     pVnode->inUse = NULL;
   }
+
   vDebug("vgId:%d, vnode buffer pool is closed", TD_VID(pVnode));
 
   return 0;
@@ -99,13 +261,15 @@ void vnodeBufPoolReset(SVBufPool *pPool) {
     ASSERT(pNode->pnext == &pPool->pTail);
     pNode->prev->pnext = &pPool->pTail;
     pPool->pTail = pNode->prev;
-    pPool->size = pPool->size - sizeof(*pNode) - pNode->size;
+    pPool->capacity -= pNode->size;
+    vnodeBufPoolBorrow(pPool->pVnode, -pNode->size);
     taosMemoryFree(pNode);
   }
 
-  ASSERT(pPool->size == pPool->ptr - pPool->node.data);
+  ASSERT(pPool->capacity == pPool->node.size);
 
   pPool->size = 0;
+  pPool->firstTs = 0;
   pPool->ptr = pPool->node.data;
 }
 
@@ -115,29 +279,38 @@ void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
   ASSERT(pPool != NULL);
 
   taosThreadSpinLock(&pPool->lock);
-  if (pPool->node.size >= pPool->ptr - pPool->node.data + size) {
-    // allocate from the anchor node
-    p = pPool->ptr;
-    pPool->ptr = pPool->ptr + size;
-    pPool->size += size;
-  } else {
-    // allocate a new node
-    pNode = taosMemoryMalloc(sizeof(*pNode) + size);
+  if (pPool->pTail->data + pPool->pTail->size < pPool->ptr + size) {
+    // borrow a new chunk, chunks grow with the pool so that a hot vnode does not go to the allocator too often, up to
+    // an eighth of the memtable size not to overshoot it by much
+    int64_t maxChunk = TMAX(vnodeBufPoolGetMaxSize(pPool->pVnode) / 8, VNODE_BUFPOOL_CHUNK_MIN);
+    maxChunk = TMIN(maxChunk, VNODE_BUFPOOL_CHUNK_MAX);
+    int64_t chunk = TMAX(size, TMIN(TMAX(pPool->capacity, VNODE_BUFPOOL_CHUNK_MIN), maxChunk));
+
+    pNode = taosMemoryMalloc(sizeof(*pNode) + chunk);
     if (pNode == NULL) {
       terrno = TSDB_CODE_OUT_OF_MEMORY;
       taosThreadSpinUnlock(&pPool->lock);
       return NULL;
     }
 
-    p = pNode->data;
-    pNode->size = size;
+    pNode->size = chunk;
     pNode->prev = pPool->pTail;
     pNode->pnext = &pPool->pTail;
     pPool->pTail->pnext = &pNode->prev;
     pPool->pTail = pNode;
+    pPool->ptr = pNode->data;
+
+    pPool->capacity += chunk;
+    vnodeBufPoolBorrow(pPool->pVnode, chunk);
+  }
 
-    pPool->size = pPool->size + sizeof(*pNode) + size;
+  if (pPool->size == 0) {
+    pPool->firstTs = taosGetTimestampMs();
   }
+
+  p = pPool->ptr;
+  pPool->ptr = pPool->ptr + size;
+  pPool->size += size;
   taosThreadSpinUnlock(&pPool->lock);
   return p;
 }
@@ -166,23 +339,11 @@ void vnodeBufPoolUnRef(SVBufPool *pPool) {
   if (nRef == 0) {
     SVnode *pVnode = pPool->pVnode;
 
+    vnodeBufPoolRelease(pPool);
     vnodeBufPoolReset(pPool);
 
     taosThreadMutexLock(&pVnode->mutex);
 
-    int64_t size = pVnode->config.szBuf / VNODE_BUFPOOL_SEGMENTS;
-    if (pPool->node.size != size) {
-      SVBufPool *pPoolT = NULL;
-      if (vnodeBufPoolCreate(pVnode, size, &pPoolT) < 0) {
-        vWarn("vgId:%d, try to change buf pools size from %" PRId64 " to %" PRId64 " since %s", TD_VID(pVnode),
-              pPool->node.size, size, tstrerror(errno));
-      } else {
-        vnodeBufPoolDestroy(pPool);
-        pPool = pPoolT;
-        vDebug("vgId:%d, change buf pools size from %" PRId64 " to %" PRId64, TD_VID(pVnode), pPool->node.size, size);
-      }
-    }
-
     pPool->next = pVnode->pPool;
     pVnode->pPool = pPool;
     taosThreadCondSignal(&pVnode->poolNotEmpty);
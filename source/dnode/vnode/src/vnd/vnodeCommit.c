@@ -17,22 +17,47 @@
 
 #define VND_INFO_FNAME "vnode.json"
 #define VND_INFO_FNAME_TMP "vnode_tmp.json"
+#define VNODE_STALL_MIN_US 1000
+#define VNODE_STALL_LOG_MS 10000
+
+typedef struct {
+  SVnode    *pVnode;
+  SVnodeInfo info;
+  char       dir[TSDB_FILENAME_LEN];
+} SCommitInfo;
+
+typedef struct {
+  SVnode *pVnode;
+  int64_t compactID;  // 0 for no compaction
+} SBgTaskInfo;
 
 static int  vnodeEncodeInfo(const SVnodeInfo *pInfo, char **ppData);
 static int  vnodeDecodeInfo(uint8_t *pData, SVnodeInfo *pInfo);
-static int  vnodeCommitImpl(void *arg);
-static void vnodeWaitCommit(SVnode *pVnode);
+static int  vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo);
+static int  vnodeCommitImpl(SCommitInfo *pInfo);
+static int  vnodeCommitTask(void *arg);
+static int  vnodeWaitCommit(SVnode *pVnode);
+static void vnodeLogStall(SVnode *pVnode, const char *cause, int64_t elapsed);
 
 int vnodeBegin(SVnode *pVnode) {
   // alloc buffer pool
   taosThreadMutexLock(&pVnode->mutex);
 
-  while (pVnode->pPool == NULL) {
-    taosThreadCondWait(&pVnode->poolNotEmpty, &pVnode->mutex);
+  if (pVnode->pPool == NULL) {
+    // all the memtables are still being flushed or read
+    int64_t st = taosGetTimestampUs();
+    while (pVnode->pPool == NULL) {
+      taosThreadCondWait(&pVnode->poolNotEmpty, &pVnode->mutex);
+    }
+    int64_t elapsed = taosGetTimestampUs() - st;
+    atomic_add_fetch_64(&pVnode->statis.nStallBuffer, 1);
+    atomic_add_fetch_64(&pVnode->statis.stallBufferUs, elapsed);
+    vnodeLogStall(pVnode, "a free write buffer", elapsed);
   }
 
   pVnode->inUse = pVnode->pPool;
   pVnode->inUse->nRef = 1;
+  atomic_store_64(&pVnode->commitAskMs, 0);
   pVnode->pPool = pVnode->inUse->next;
   pVnode->inUse->next = NULL;
 
@@ -60,10 +85,23 @@ int vnodeBegin(SVnode *pVnode) {
   return 0;
 }
 
+// A memtable is committed when it reaches what the vnode buffer has left for it, or when it gets old. The dnode write
+// buffer budget asks the vnodes holding the most to commit, see vnodeBufPoolCheckBudget.
 int vnodeShouldCommit(SVnode *pVnode) {
-  if (pVnode->inUse) {
-    return osDataSpaceAvailable() && (pVnode->inUse->size > pVnode->inUse->node.size);
+  SVBufPool *pPool = pVnode->inUse;
+  if (pPool == NULL || pPool->size == 0 || !osDataSpaceAvailable()) {
+    return false;
+  }
+
+  if (pPool->capacity > vnodeBufPoolGetMaxSize(pVnode)) {
+    return true;
+  }
+
+  if (taosGetTimestampMs() - pPool->firstTs > tsVnodeCommitAge * 1000LL) {
+    vDebug("vgId:%d, memtable is too old, size:%" PRId64, TD_VID(pVnode), pPool->size);
+    return true;
   }
+
   return false;
 }
 
@@ -186,28 +224,63 @@ _err:
 }
 
 int vnodeAsyncCommit(SVnode *pVnode) {
-  vnodeWaitCommit(pVnode);
+  SCommitInfo *pInfo = taosMemoryCalloc(1, sizeof(*pInfo));
+  if (pInfo == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
 
-  // vnodeBufPoolSwitch(pVnode);
-  // tsdbPrepareCommit(pVnode->pTsdb);
+  if (vnodeWaitCommit(pVnode) < 0) {
+    taosMemoryFree(pInfo);
+    return -1;
+  }
 
-  vnodeScheduleTask(vnodeCommitImpl, pVnode);
+  if (vnodePrepareCommit(pVnode, pInfo) < 0) {
+    tsem_post(&pVnode->canCommit);
+    taosMemoryFree(pInfo);
+    return -1;
+  }
+
+  // rsma commits its own trees in place, keep it on the write thread
+  if (VND_IS_RSMA(pVnode) || vnodeScheduleTask(vnodeCommitTask, pInfo) < 0) {
+    vnodeCommitTask(pInfo);
+  }
 
   return 0;
 }
 
 int vnodeSyncCommit(SVnode *pVnode) {
-  vnodeAsyncCommit(pVnode);
-  vnodeWaitCommit(pVnode);
+  if (vnodeAsyncCommit(pVnode) < 0) {
+    return -1;
+  }
+  if (vnodeWaitCommit(pVnode) < 0) {
+    return -1;
+  }
   tsem_post(&(pVnode->canCommit));
   return 0;
 }
 
 int vnodeCommit(SVnode *pVnode) {
-  int32_t    code = 0;
-  int32_t    lino = 0;
-  SVnodeInfo info = {0};
-  char       dir[TSDB_FILENAME_LEN];
+  SCommitInfo info = {0};
+
+  if (vnodeWaitCommit(pVnode) < 0) {
+    return -1;
+  }
+
+  int32_t code = vnodePrepareCommit(pVnode, &info);
+  if (code == 0) {
+    code = vnodeCommitImpl(&info);
+  }
+
+  tsem_post(&pVnode->canCommit);
+  return code;
+}
+
+// Runs on the write thread: persist the wal, freeze the memtable and commit the small sub-systems, the data files are
+// written by vnodeCommitImpl while ingestion goes on into the next memtable.
+static int vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo) {
+  int32_t code = 0;
+  int32_t lino = 0;
 
   vInfo("vgId:%d, start to commit, commit ID:%" PRId64 " version:%" PRId64, TD_VID(pVnode), pVnode->state.commitID,
         pVnode->state.applied);
@@ -221,16 +294,18 @@ int vnodeCommit(SVnode *pVnode) {
   pVnode->state.commitTerm = pVnode->state.applyTerm;
 
   // save info
-  info.config = pVnode->config;
-  info.state.committed = pVnode->state.applied;
-  info.state.commitTerm = pVnode->state.applyTerm;
-  info.state.commitID = pVnode->state.commitID;
+  pInfo->pVnode = pVnode;
+  pInfo->info.config = pVnode->config;
+  pInfo->info.state.committed = pVnode->state.applied;
+  pInfo->info.state.commitTerm = pVnode->state.applyTerm;
+  pInfo->info.state.commitID = pVnode->state.commitID;
+  pInfo->info.state.trimTime = atomic_load_32(&pVnode->state.trimTime);
   if (pVnode->pTfs) {
-    snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
+    snprintf(pInfo->dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
   } else {
-    snprintf(dir, TSDB_FILENAME_LEN, "%s", pVnode->path);
+    snprintf(pInfo->dir, TSDB_FILENAME_LEN, "%s", pVnode->path);
   }
-  if (vnodeSaveInfo(dir, &info) < 0) {
+  if (vnodeSaveInfo(pInfo->dir, &pInfo->info) < 0) {
     code = terrno;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
@@ -241,15 +316,59 @@ int vnodeCommit(SVnode *pVnode) {
   code = smaPreCommit(pVnode->pSma);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  vnodeBufPoolUnRef(pVnode->inUse);
-  pVnode->inUse = NULL;
+  code = tsdbPrepareCommit(pVnode->pTsdb);
+  TSDB_CHECK_CODE(code, lino, _exit);
 
-  // commit each sub-system
+  // commit meta and tq, both share the write thread with the next transaction. The meta txn stays undoable until
+  // metaFinishCommit, which follows vnodeCommitInfo.
   if (metaCommit(pVnode->pMeta) < 0) {
     code = TSDB_CODE_FAILED;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  if (tqCommit(pVnode->pTq) < 0) {
+    code = TSDB_CODE_FAILED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  vnodeBufPoolFreeze(pVnode->inUse);
+  vnodeBufPoolUnRef(pVnode->inUse);
+  pVnode->inUse = NULL;
+
+_exit:
+  if (code) {
+    vError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
+// the file sets of the tsdbs a commit writes are not changed by the background task until they are installed
+static void vnodeLockFS(SVnode *pVnode) {
+  tsdbLockFS(pVnode->pTsdb);
+  if (VND_IS_RSMA(pVnode)) {
+    tsdbLockFS(VND_RSMA1(pVnode));
+    tsdbLockFS(VND_RSMA2(pVnode));
+  }
+}
+
+static void vnodeUnlockFS(SVnode *pVnode) {
+  if (VND_IS_RSMA(pVnode)) {
+    tsdbUnlockFS(VND_RSMA2(pVnode));
+    tsdbUnlockFS(VND_RSMA1(pVnode));
+  }
+  tsdbUnlockFS(pVnode->pTsdb);
+}
+
+static int vnodeCommitImpl(SCommitInfo *pInfo) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  SVnode *pVnode = pInfo->pVnode;
+  bool    locked = true;
+
+  // commit each sub-system
+  vnodeLockFS(pVnode);
   code = tsdbCommit(pVnode->pTsdb);
   TSDB_CHECK_CODE(code, lino, _exit);
 
@@ -258,13 +377,8 @@ int vnodeCommit(SVnode *pVnode) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
-  if (tqCommit(pVnode->pTq) < 0) {
-    code = TSDB_CODE_FAILED;
-    TSDB_CHECK_CODE(code, lino, _exit);
-  }
-
   // commit info
-  if (vnodeCommitInfo(dir, &info) < 0) {
+  if (vnodeCommitInfo(pInfo->dir, &pInfo->info) < 0) {
     code = terrno;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
@@ -277,16 +391,19 @@ int vnodeCommit(SVnode *pVnode) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  vnodeUnlockFS(pVnode);
+  locked = false;
+
   if (metaFinishCommit(pVnode->pMeta) < 0) {
     code = terrno;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
-  pVnode->state.committed = info.state.committed;
+  pVnode->state.committed = pInfo->info.state.committed;
 
   if (smaPostCommit(pVnode->pSma) < 0) {
-    vError("vgId:%d, failed to post-commit sma since %s", TD_VID(pVnode), tstrerror(terrno));
-    return -1;
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
   // apply the commit (TODO)
@@ -294,11 +411,15 @@ int vnodeCommit(SVnode *pVnode) {
   syncEndSnapshot(pVnode->sync);
 
 _exit:
+  if (locked) {
+    vnodeUnlockFS(pVnode);
+  }
   if (code) {
     vError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
-  } else {
-    vInfo("vgId:%d, commit end", TD_VID(pVnode));
+    terrno = code;
+    return -1;
   }
+  vInfo("vgId:%d, commit end", TD_VID(pVnode));
   return 0;
 }
 
@@ -318,19 +439,147 @@ void vnodeRollback(SVnode *pVnode) {
   (void)taosRemoveFile(tFName);
 }
 
-static int vnodeCommitImpl(void *arg) {
-  SVnode *pVnode = (SVnode *)arg;
+static int vnodeCommitTask(void *arg) {
+  SCommitInfo *pInfo = (SCommitInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
 
-  // metaCommit(pVnode->pMeta);
-  tqCommit(pVnode->pTq);
-  // tsdbCommit(pVnode->pTsdb, );
+  int32_t code = 0;
+
+  if (vnodeCommitImpl(pInfo) < 0) {
+    // the wal keeps the data of the failed commit, it is recovered at reopen
+    code = terrno;
+    atomic_store_32(&pVnode->commitCode, code);
+    vFatal("vgId:%d, failed to commit since %s, stop committing until reopen", TD_VID(pVnode), tstrerror(code));
+  } else {
+    // started before canCommit is posted, so a vnodeCommit that follows sees it. The compaction files are named by the
+    // negated ID of the commit, a name space no commit uses, so the persisted commit ID is left alone.
+    vnodeStartBgTask(pVnode, tsCompactEnable ? -pInfo->info.state.commitID : 0);
+  }
+  taosMemoryFree(pInfo);
 
-  // vnodeBufPoolRecycle(pVnode);
   tsem_post(&(pVnode->canCommit));
+  return code;
+}
+
+// Retention and compaction change the file set in the background, one task at a time per vnode. A trim request that
+// comes while the task runs is left to it. The trim time stays pending, and is saved by the commits, until its
+// retention is done.
+static int vnodeBgTask(void *arg) {
+  SBgTaskInfo *pInfo = (SBgTaskInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
+  int32_t      code = 0;
+  int32_t      doneTime = 0;
+
+  for (;;) {
+    int32_t trimTime = atomic_load_32(&pVnode->state.trimTime);
+    if (trimTime && trimTime != doneTime) {
+      code = tsdbDoRetention(pVnode->pTsdb, trimTime);
+      if (code == 0) {
+        code = smaDoRetention(pVnode->pSma, trimTime);
+      }
+      if (code == 0) {
+        atomic_val_compare_exchange_32(&pVnode->state.trimTime, trimTime, 0);
+      } else if (code != TSDB_CODE_VND_BG_TASK_STOPPED) {
+        // retried by the next background task
+        vError("vgId:%d, failed to do retention since %s", TD_VID(pVnode), tstrerror(code));
+      }
+      doneTime = trimTime;
+    }
+
+    if (pInfo->compactID && !atomic_load_8(&pVnode->bgStop)) {
+      code = tsdbCompact(pVnode->pTsdb, pInfo->compactID);
+      if (code && code != TSDB_CODE_VND_BG_TASK_STOPPED) {
+        // a failed compaction leaves the data files as they are
+        vWarn("vgId:%d, failed to compact tsdb since %s", TD_VID(pVnode), tstrerror(code));
+      }
+      pInfo->compactID = 0;
+    }
+
+    // a trim request that came meanwhile is run now, unless the task is being stopped
+    bool stop = atomic_load_8(&pVnode->bgStop);
+    vnodeResumeBgTask(pVnode);
+    trimTime = atomic_load_32(&pVnode->state.trimTime);
+    if (stop || trimTime == 0 || trimTime == doneTime) break;
+    if (atomic_val_compare_exchange_8(&pVnode->bgTask, 0, 1) != 0) break;
+  }
+
+  taosMemoryFree(pInfo);
   return 0;
 }
 
-static FORCE_INLINE void vnodeWaitCommit(SVnode *pVnode) { tsem_wait(&pVnode->canCommit); }
+void vnodeStartBgTask(SVnode *pVnode, int64_t compactID) {
+  if (compactID == 0 && atomic_load_32(&pVnode->state.trimTime) == 0) return;
+  if (atomic_val_compare_exchange_8(&pVnode->bgTask, 0, 1) != 0) return;
+
+  SBgTaskInfo *pInfo = taosMemoryCalloc(1, sizeof(*pInfo));
+  if (pInfo == NULL) {
+    vnodeResumeBgTask(pVnode);
+    return;
+  }
+  pInfo->pVnode = pVnode;
+  pInfo->compactID = compactID;
+
+  if (vnodeScheduleBgTask(vnodeBgTask, pInfo) < 0) {
+    taosMemoryFree(pInfo);
+    vnodeResumeBgTask(pVnode);
+  }
+}
+
+// Stop the background task and keep new ones from starting until vnodeResumeBgTask. A running retention or compaction
+// gives up at its next file set, table or I/O charge; its new files are dropped and a pending trim is kept.
+void vnodeStopBgTask(SVnode *pVnode) {
+  atomic_store_8(&pVnode->bgStop, 1);
+  taosThreadMutexLock(&pVnode->bgMutex);
+  while (atomic_val_compare_exchange_8(&pVnode->bgTask, 0, 1) != 0) {
+    taosThreadCondWait(&pVnode->bgDone, &pVnode->bgMutex);
+  }
+  taosThreadMutexUnlock(&pVnode->bgMutex);
+  atomic_store_8(&pVnode->bgStop, 0);
+}
+
+void vnodeResumeBgTask(SVnode *pVnode) {
+  taosThreadMutexLock(&pVnode->bgMutex);
+  atomic_store_8(&pVnode->bgTask, 0);
+  taosThreadCondBroadcast(&pVnode->bgDone);
+  taosThreadMutexUnlock(&pVnode->bgMutex);
+}
+
+// a writer blocks here only when the previous memtable is still being flushed, fails if that commit failed. The tsdb
+// read snapshot holds a single imem, so a second frozen memtable can not be queued behind a running flush.
+static int vnodeWaitCommit(SVnode *pVnode) {
+  int64_t st = taosGetTimestampUs();
+  tsem_wait(&pVnode->canCommit);
+  int64_t elapsed = taosGetTimestampUs() - st;
+  if (elapsed >= VNODE_STALL_MIN_US) {
+    atomic_add_fetch_64(&pVnode->statis.nStallCommit, 1);
+    atomic_add_fetch_64(&pVnode->statis.stallCommitUs, elapsed);
+    vnodeLogStall(pVnode, "the previous commit", elapsed);
+  }
+
+  int32_t code = atomic_load_32(&pVnode->commitCode);
+  if (code) {
+    tsem_post(&pVnode->canCommit);
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
+// under sustained pressure every write stalls, warn at most once per VNODE_STALL_LOG_MS per vnode
+static void vnodeLogStall(SVnode *pVnode, const char *cause, int64_t elapsed) {
+  int64_t nowMs = taosGetTimestampMs();
+  int64_t lastMs = atomic_load_64(&pVnode->stallLogMs);
+  if (nowMs - lastMs < VNODE_STALL_LOG_MS ||
+      atomic_val_compare_exchange_64(&pVnode->stallLogMs, lastMs, nowMs) != lastMs) {
+    atomic_add_fetch_32(&pVnode->nStallNoLog, 1);
+    vDebug("vgId:%d, write stalled %" PRId64 "us waiting for %s", TD_VID(pVnode), elapsed, cause);
+    return;
+  }
+
+  int32_t nNoLog = atomic_exchange_32(&pVnode->nStallNoLog, 0);
+  vWarn("vgId:%d, write stalled %" PRId64 "us waiting for %s, %d more stalls since the last warning", TD_VID(pVnode),
+        elapsed, cause, nNoLog);
+}
 
 static int vnodeEncodeState(const void *pObj, SJson *pJson) {
   const SVState *pState = (SVState *)pObj;
@@ -338,6 +587,7 @@ static int vnodeEncodeState(const void *pObj, SJson *pJson) {
   if (tjsonAddIntegerToObject(pJson, "commit version", pState->committed) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "commit ID", pState->commitID) < 0) return -1;
   if (tjsonAddIntegerToObject(pJson, "commit term", pState->commitTerm) < 0) return -1;
+  if (tjsonAddIntegerToObject(pJson, "trim time", pState->trimTime) < 0) return -1;
 
   return 0;
 }
@@ -352,6 +602,8 @@ static int vnodeDecodeState(const SJson *pJson, void *pObj) {
   if (code < 0) return -1;
   tjsonGetNumberValue(pJson, "commit term", pState->commitTerm, code);
   if (code < 0) return -1;
+  // not in the files of older versions
+  tjsonGetNumberValue(pJson, "trim time", pState->trimTime, code);
 
   return 0;
 }
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vnd.h"
+
+#define VNODE_IO_MAX_SLEEP_MS 100
+
+// A token bucket per class of background I/O, shared by all vnodes of the dnode. Tokens are bytes refilled at the
+// class limit and capped at one second of it. A caller may overdraw the bucket, the next ones wait for the debt.
+typedef struct {
+  double  tokens;
+  int64_t lastUs;
+  int64_t bytes;   // granted since the last report
+  int64_t waitUs;  // waited since the last report
+  int32_t queued;
+} SVnodeIoBucket;
+
+static struct {
+  int8_t           init;
+  TdThreadMutex    mutex;
+  volatile int32_t nForeground;  // query and fetch msgs being processed
+  SVnodeIoBucket   aBucket[VND_IO_MAX];
+} vnodeIo;
+
+static int64_t vnodeIoRate(int8_t ioClass) {
+  int64_t limit = 0;
+  switch (ioClass) {
+    case VND_IO_COMMIT:
+      limit = tsCommitIOLimit;
+      break;
+    case VND_IO_COMPACT:
+      limit = tsCompactIOLimit;
+      break;
+    case VND_IO_MIGRATE:
+      limit = tsMigrateIOLimit;
+      break;
+    case VND_IO_SNAPSHOT:
+      limit = tsSnapshotIOLimit;
+      break;
+    default:
+      break;
+  }
+
+  int64_t rate = limit * 1024 * 1024;
+  if (rate > 0 && atomic_load_32(&vnodeIo.nForeground) > 0) {
+    rate = TMAX(rate * tsIoBackgroundShare / 100, 1);
+  }
+  return rate;
+}
+
+int32_t vnodeIoInit() {
+  taosThreadMutexInit(&vnodeIo.mutex, NULL);
+  memset(vnodeIo.aBucket, 0, sizeof(vnodeIo.aBucket));
+  vnodeIo.nForeground = 0;
+  vnodeIo.init = 1;
+  return 0;
+}
+
+void vnodeIoCleanup() {
+  if (!vnodeIo.init) return;
+  vnodeIo.init = 0;
+  taosThreadMutexDestroy(&vnodeIo.mutex);
+}
+
+// Called after or before nBytes of class ioClass are read or written. Blocks while the class is over its limit.
+// Retention and compaction of pVnode give up with TSDB_CODE_VND_BG_TASK_STOPPED once vnodeStopBgTask is called.
+int32_t vnodeIoAcquire(SVnode *pVnode, int8_t ioClass, int64_t nBytes) {
+  bool bgClass = (ioClass == VND_IO_COMPACT || ioClass == VND_IO_MIGRATE);
+  if (bgClass && pVnode && atomic_load_8(&pVnode->bgStop)) return TSDB_CODE_VND_BG_TASK_STOPPED;
+  if (ioClass <= VND_IO_NONE || ioClass >= VND_IO_MAX || nBytes <= 0 || !vnodeIo.init) return 0;
+
+  SVnodeIoBucket *pBucket = &vnodeIo.aBucket[ioClass];
+  int64_t         stUs = 0;
+  int32_t         code = 0;
+
+  taosThreadMutexLock(&vnodeIo.mutex);
+  pBucket->bytes += nBytes;
+  for (;;) {
+    int64_t rate = vnodeIoRate(ioClass);
+    int64_t nowUs = taosGetTimestampUs();
+    if (rate <= 0) {
+      pBucket->tokens = 0;
+      pBucket->lastUs = nowUs;
+      break;
+    }
+
+    pBucket->tokens = TMIN(pBucket->tokens + (double)(nowUs - pBucket->lastUs) * rate / 1000000, (double)rate);
+    pBucket->lastUs = nowUs;
+    if (pBucket->tokens > 0) {
+      pBucket->tokens -= nBytes;
+      break;
+    }
+
+    if (bgClass && pVnode && atomic_load_8(&pVnode->bgStop)) {
+      code = TSDB_CODE_VND_BG_TASK_STOPPED;
+      break;
+    }
+
+    if (stUs == 0) {
+      stUs = nowUs;
+      pBucket->queued++;
+    }
+
+    int64_t sleepMs = TMIN((int64_t)(-pBucket->tokens * 1000 / rate) + 1, VNODE_IO_MAX_SLEEP_MS);
+    taosThreadMutexUnlock(&vnodeIo.mutex);
+    taosMsleep(sleepMs);
+    taosThreadMutexLock(&vnodeIo.mutex);
+  }
+
+  if (stUs) {
+    pBucket->queued--;
+    pBucket->waitUs += taosGetTimestampUs() - stUs;
+  }
+  taosThreadMutexUnlock(&vnodeIo.mutex);
+  return code;
+}
+
+void vnodeIoForegroundEnter() { atomic_add_fetch_32(&vnodeIo.nForeground, 1); }
+
+void vnodeIoForegroundLeave() { atomic_sub_fetch_32(&vnodeIo.nForeground, 1); }
+
+void vnodeGetIoStat(SVnodeIoStat *aStat) {
+  if (!vnodeIo.init) return;
+
+  taosThreadMutexLock(&vnodeIo.mutex);
+  for (int32_t i = 0; i < VND_IO_MAX; i++) {
+    SVnodeIoBucket *pBucket = &vnodeIo.aBucket[i];
+    aStat[i].bytes = pBucket->bytes;
+    aStat[i].waitUs = pBucket->waitUs;
+    aStat[i].queued = pBucket->queued;
+    pBucket->bytes = 0;
+    pBucket->waitUs = 0;
+  }
+  taosThreadMutexUnlock(&vnodeIo.mutex);
+}
@@ -15,6 +15,8 @@
 
 #include "vnd.h"
 
+#define VNODE_BG_THREADS 2
+
 typedef struct SVnodeTask SVnodeTask;
 struct SVnodeTask {
   SVnodeTask* next;
@@ -23,19 +25,30 @@ struct SVnodeTask {
   void* arg;
 };
 
-struct SVnodeGlobal {
-  int8_t        init;
+typedef struct {
+  const char*   name;
   int8_t        stop;
   int           nthreads;
   TdThread*     threads;
   TdThreadMutex mutex;
   TdThreadCond  hasTask;
   SVnodeTask    queue;
+} SVnodeTaskPool;
+
+// commits run in the commit pool, the background file set work that may block on its I/O limit (compaction and
+// retention) in the bg pool so that it never holds up a flush
+struct SVnodeGlobal {
+  int8_t         init;
+  SVnodeTaskPool commitPool;
+  SVnodeTaskPool bgPool;
 };
 
 struct SVnodeGlobal vnodeGlobal;
 
 static void* loop(void* arg);
+static int   vnodeOpenTaskPool(SVnodeTaskPool* pPool, const char* name, int nthreads);
+static void  vnodeCloseTaskPool(SVnodeTaskPool* pPool);
+static int   vnodePushTask(SVnodeTaskPool* pPool, int (*execute)(void*), void* arg);
 
 int vnodeInit(int nthreads) {
   int8_t init;
@@ -46,29 +59,19 @@ int vnodeInit(int nthreads) {
     return 0;
   }
 
-  taosThreadMutexInit(&vnodeGlobal.mutex, NULL);
-  taosThreadCondInit(&vnodeGlobal.hasTask, NULL);
-
-  taosThreadMutexLock(&vnodeGlobal.mutex);
-
-  vnodeGlobal.stop = 0;
-  vnodeGlobal.queue.next = &vnodeGlobal.queue;
-  vnodeGlobal.queue.prev = &vnodeGlobal.queue;
-
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
-
-  vnodeGlobal.nthreads = nthreads;
-  vnodeGlobal.threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
-  if (vnodeGlobal.threads == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    vError("failed to init vnode module since:%s", tstrerror(terrno));
+  if (vnodeOpenTaskPool(&vnodeGlobal.commitPool, "vnode-commit", nthreads) < 0) {
     return -1;
   }
-
-  for (int i = 0; i < nthreads; i++) {
-    taosThreadCreate(&(vnodeGlobal.threads[i]), NULL, loop, NULL);
+  if (vnodeOpenTaskPool(&vnodeGlobal.bgPool, "vnode-bg", VNODE_BG_THREADS) < 0) {
+    return -1;
   }
 
+  if (vnodeIoInit() < 0) {
+    return -1;
+  }
+  if (vnodeBufPoolInit() < 0) {
+    return -1;
+  }
   if (walInit() < 0) {
     return -1;
   }
@@ -85,31 +88,73 @@ void vnodeCleanup() {
   init = atomic_val_compare_exchange_8(&(vnodeGlobal.init), 1, 0);
   if (init == 0) return;
 
+  vnodeCloseTaskPool(&vnodeGlobal.bgPool);
+  vnodeCloseTaskPool(&vnodeGlobal.commitPool);
+
+  vnodeIoCleanup();
+  vnodeBufPoolCleanup();
+  walCleanUp();
+  tqCleanUp();
+  smaCleanUp();
+}
+
+int vnodeScheduleTask(int (*execute)(void*), void* arg) {
+  return vnodePushTask(&vnodeGlobal.commitPool, execute, arg);
+}
+
+int vnodeScheduleBgTask(int (*execute)(void*), void* arg) { return vnodePushTask(&vnodeGlobal.bgPool, execute, arg); }
+
+/* ------------------------ STATIC METHODS ------------------------ */
+static int vnodeOpenTaskPool(SVnodeTaskPool* pPool, const char* name, int nthreads) {
+  taosThreadMutexInit(&pPool->mutex, NULL);
+  taosThreadCondInit(&pPool->hasTask, NULL);
+
+  taosThreadMutexLock(&pPool->mutex);
+
+  pPool->name = name;
+  pPool->stop = 0;
+  pPool->queue.next = &pPool->queue;
+  pPool->queue.prev = &pPool->queue;
+
+  taosThreadMutexUnlock(&(pPool->mutex));
+
+  pPool->nthreads = nthreads;
+  pPool->threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
+  if (pPool->threads == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    vError("failed to init vnode module since:%s", tstrerror(terrno));
+    return -1;
+  }
+
+  for (int i = 0; i < nthreads; i++) {
+    taosThreadCreate(&(pPool->threads[i]), NULL, loop, pPool);
+  }
+
+  return 0;
+}
+
+static void vnodeCloseTaskPool(SVnodeTaskPool* pPool) {
   // set stop
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  vnodeGlobal.stop = 1;
-  taosThreadCondBroadcast(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  taosThreadMutexLock(&(pPool->mutex));
+  pPool->stop = 1;
+  taosThreadCondBroadcast(&(pPool->hasTask));
+  taosThreadMutexUnlock(&(pPool->mutex));
 
   // wait for threads
-  for (int i = 0; i < vnodeGlobal.nthreads; i++) {
-    taosThreadJoin(vnodeGlobal.threads[i], NULL);
+  for (int i = 0; i < pPool->nthreads; i++) {
+    taosThreadJoin(pPool->threads[i], NULL);
   }
 
   // clear source
-  taosMemoryFreeClear(vnodeGlobal.threads);
-  taosThreadCondDestroy(&(vnodeGlobal.hasTask));
-  taosThreadMutexDestroy(&(vnodeGlobal.mutex));
-
-  walCleanUp();
-  tqCleanUp();
-  smaCleanUp();
+  taosMemoryFreeClear(pPool->threads);
+  taosThreadCondDestroy(&(pPool->hasTask));
+  taosThreadMutexDestroy(&(pPool->mutex));
 }
 
-int vnodeScheduleTask(int (*execute)(void*), void* arg) {
+static int vnodePushTask(SVnodeTaskPool* pPool, int (*execute)(void*), void* arg) {
   SVnodeTask* pTask;
 
-  ASSERT(!vnodeGlobal.stop);
+  ASSERT(!pPool->stop);
 
   pTask = taosMemoryMalloc(sizeof(*pTask));
   if (pTask == NULL) {
@@ -120,35 +165,35 @@ int vnodeScheduleTask(int (*execute)(void*), void* arg) {
   pTask->execute = execute;
   pTask->arg = arg;
 
-  taosThreadMutexLock(&(vnodeGlobal.mutex));
-  pTask->next = &vnodeGlobal.queue;
-  pTask->prev = vnodeGlobal.queue.prev;
-  vnodeGlobal.queue.prev->next = pTask;
-  vnodeGlobal.queue.prev = pTask;
-  taosThreadCondSignal(&(vnodeGlobal.hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+  taosThreadMutexLock(&(pPool->mutex));
+  pTask->next = &pPool->queue;
+  pTask->prev = pPool->queue.prev;
+  pPool->queue.prev->next = pTask;
+  pPool->queue.prev = pTask;
+  taosThreadCondSignal(&(pPool->hasTask));
+  taosThreadMutexUnlock(&(pPool->mutex));
 
   return 0;
 }
 
-/* ------------------------ STATIC METHODS ------------------------ */
 static void* loop(void* arg) {
-  SVnodeTask* pTask;
-  int         ret;
+  SVnodeTaskPool* pPool = (SVnodeTaskPool*)arg;
+  SVnodeTask*     pTask;
+  int             ret;
 
-  setThreadName("vnode-commit");
+  setThreadName(pPool->name);
 
   for (;;) {
-    taosThreadMutexLock(&(vnodeGlobal.mutex));
+    taosThreadMutexLock(&(pPool->mutex));
     for (;;) {
-      pTask = vnodeGlobal.queue.next;
-      if (pTask == &vnodeGlobal.queue) {
+      pTask = pPool->queue.next;
+      if (pTask == &pPool->queue) {
         // no task
-        if (vnodeGlobal.stop) {
-          taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+        if (pPool->stop) {
+          taosThreadMutexUnlock(&(pPool->mutex));
           return NULL;
         } else {
-          taosThreadCondWait(&(vnodeGlobal.hasTask), &(vnodeGlobal.mutex));
+          taosThreadCondWait(&(pPool->hasTask), &(pPool->mutex));
         }
       } else {
         // has task
@@ -158,7 +203,7 @@ static void* loop(void* arg) {
       }
     }
 
-    taosThreadMutexUnlock(&(vnodeGlobal.mutex));
+    taosThreadMutexUnlock(&(pPool->mutex));
 
     pTask->execute(pTask->arg);
     taosMemoryFree(pTask);
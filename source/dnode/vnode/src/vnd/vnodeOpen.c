@@ -147,6 +147,7 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
   pVnode->state.applied = info.state.committed;
   pVnode->state.commitID = info.state.commitID;
   pVnode->state.commitTerm = info.state.commitTerm;
+  pVnode->state.trimTime = info.state.trimTime;
   pVnode->pTfs = pTfs;
   pVnode->msgCb = msgCb;
   taosThreadMutexInit(&pVnode->lock, NULL);
@@ -156,6 +157,8 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
   tsem_init(&(pVnode->canCommit), 0, 1);
   taosThreadMutexInit(&pVnode->mutex, NULL);
   taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+  taosThreadMutexInit(&pVnode->bgMutex, NULL);
+  taosThreadCondInit(&pVnode->bgDone, NULL);
 
   int8_t rollback = vnodeShouldRollback(pVnode);
 
@@ -238,6 +241,8 @@ _err:
   if (pVnode->pPool) vnodeCloseBufPool(pVnode);
 
   tsem_destroy(&(pVnode->canCommit));
+  taosThreadCondDestroy(&pVnode->bgDone);
+  taosThreadMutexDestroy(&pVnode->bgMutex);
   taosMemoryFree(pVnode);
   return NULL;
 }
@@ -251,6 +256,7 @@ void vnodePreClose(SVnode *pVnode) {
 void vnodeClose(SVnode *pVnode) {
   if (pVnode) {
     vnodeCommit(pVnode);
+    vnodeStopBgTask(pVnode);
     vnodeSyncClose(pVnode);
     vnodeQueryClose(pVnode);
     walClose(pVnode->pWal);
@@ -265,13 +271,16 @@ void vnodeClose(SVnode *pVnode) {
     taosThreadCondDestroy(&pVnode->poolNotEmpty);
     taosThreadMutexDestroy(&pVnode->mutex);
     taosThreadMutexDestroy(&pVnode->lock);
+    taosThreadCondDestroy(&pVnode->bgDone);
+    taosThreadMutexDestroy(&pVnode->bgMutex);
     taosMemoryFree(pVnode);
   }
 }
 
-// start the sync timer after the queue is ready
+// start the sync timer after the queue is ready, and rerun the retention of a trim request not done before the close
 int32_t vnodeStart(SVnode *pVnode) {
   vnodeSyncStart(pVnode);
+  vnodeStartBgTask(pVnode, 0);
   return 0;
 }
 
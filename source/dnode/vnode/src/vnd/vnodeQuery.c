@@ -143,6 +143,111 @@ _exit:
   return TSDB_CODE_SUCCESS;
 }
 
+// A page of the child tables of a super table, in uid order after the last uid the client got
+int32_t vnodeGetTablesMeta(SVnode *pVnode, SRpcMsg *pMsg) {
+  SVTablesMetaReq req = {0};
+  SVTablesMetaRsp rsp = {0};
+  SMetaReader     mer1 = {0};
+  SArray         *pUids = NULL;
+  SRpcMsg         rpcMsg = {0};
+  int32_t         code = 0;
+  int32_t         rspLen = 0;
+  void           *pRsp = NULL;
+
+  if (tDeserializeSVTablesMetaReq(pMsg->pCont, pMsg->contLen, &req) != 0) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _exit;
+  }
+
+  if (req.limit <= 0) {
+    req.limit = 4096;
+  }
+
+  rsp.pCtbs = taosArrayInit(TMIN(req.limit, 1024), sizeof(SVCtbMeta));
+  if (rsp.pCtbs == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  metaReaderInit(&mer1, pVnode->pMeta, 0);
+  if (metaGetTableEntryByName(&mer1, req.stbName) < 0) {
+    code = terrno;
+    goto _exit;
+  }
+
+  if (mer1.me.type != TSDB_SUPER_TABLE) {
+    code = TSDB_CODE_TDB_INVALID_TABLE_TYPE;
+    goto _exit;
+  }
+
+  rsp.dbId = pVnode->config.dbId;
+  rsp.suid = mer1.me.uid;
+  rsp.vgId = TD_VID(pVnode);
+  rsp.sversion = mer1.me.stbEntry.schemaRow.version;
+  rsp.tversion = mer1.me.stbEntry.schemaTag.version;
+
+  // the lock is only taken to walk the ctb index and then per entry, not over the whole page
+  metaReaderReleaseLock(&mer1);
+
+  pUids = taosArrayInit(TMIN(req.limit, 1024), sizeof(tb_uid_t));
+  if (pUids == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  if (metaGetCtbUids(pVnode->pMeta, rsp.suid, req.lastUid, req.limit, pUids, &rsp.hasMore) < 0) {
+    code = terrno;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pUids); ++i) {
+    tb_uid_t    uid = *(tb_uid_t *)taosArrayGet(pUids, i);
+    SMetaReader mer2 = {0};
+    metaReaderInit(&mer2, pVnode->pMeta, 0);
+    // dropped since the index was read
+    if (metaGetTableEntryByUid(&mer2, uid) == 0) {
+      SVCtbMeta ctb = {.uid = uid};
+      tstrncpy(ctb.tbName, mer2.me.name, sizeof(ctb.tbName));
+      taosArrayPush(rsp.pCtbs, &ctb);
+    }
+    metaReaderClear(&mer2);
+  }
+
+  rspLen = tSerializeSVTablesMetaRsp(NULL, 0, &rsp);
+  if (rspLen < 0) {
+    code = TSDB_CODE_INVALID_MSG;
+    goto _exit;
+  }
+
+  pRsp = rpcMallocCont(rspLen);
+  if (pRsp == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  tSerializeSVTablesMetaRsp(pRsp, rspLen, &rsp);
+
+_exit:
+  taosArrayDestroy(pUids);
+  metaReaderClear(&mer1);
+
+  if (code) {
+    qError("get child tables of %s meta failed cause of %s", req.stbName, tstrerror(code));
+    rpcFreeCont(pRsp);
+    pRsp = NULL;
+    rspLen = 0;
+  }
+
+  rpcMsg.info = pMsg->info;
+  rpcMsg.pCont = pRsp;
+  rpcMsg.contLen = rspLen;
+  rpcMsg.code = code;
+  rpcMsg.msgType = pMsg->msgType;
+  tmsgSendRsp(&rpcMsg);
+
+  tFreeSVTablesMetaRsp(&rsp);
+  return TSDB_CODE_SUCCESS;
+}
+
 int vnodeGetTableCfg(SVnode *pVnode, SRpcMsg *pMsg, bool direct) {
   STableCfgReq   cfgReq = {0};
   STableCfgRsp   cfgRsp = {0};
@@ -428,9 +533,15 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = atomic_load_64(&pVnode->statis.nInsertSuccess);
   pLoad->numOfBatchInsertReqs = atomic_load_64(&pVnode->statis.nBatchInsert);
   pLoad->numOfBatchInsertSuccessReqs = atomic_load_64(&pVnode->statis.nBatchInsertSuccess);
+  pLoad->numOfCommitStalls = atomic_load_64(&pVnode->statis.nStallCommit);
+  pLoad->commitStallTimeUs = atomic_load_64(&pVnode->statis.stallCommitUs);
+  pLoad->numOfBufferStalls = atomic_load_64(&pVnode->statis.nStallBuffer);
+  pLoad->bufferStallTimeUs = atomic_load_64(&pVnode->statis.stallBufferUs);
   return 0;
 }
 
+int32_t vnodeGetStreamTaskLoads(SVnode *pVnode, SArray *pLoads) { return tqGetStreamTaskLoads(pVnode->pTq, pLoads); }
+
 /**
  * @brief Reset the statistics value by monitor interval
  *
@@ -442,6 +553,10 @@ void vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nInsertSuccess, pLoad->numOfInsertSuccessReqs, 64, "nInsertSuccess");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsert, pLoad->numOfBatchInsertReqs, 64, "nBatchInsert");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsertSuccess, pLoad->numOfBatchInsertSuccessReqs, 64, "nBatchInsertSuccess");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nStallCommit, pLoad->numOfCommitStalls, 64, "nStallCommit");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->statis.stallCommitUs, pLoad->commitStallTimeUs, 64, "stallCommitUs");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nStallBuffer, pLoad->numOfBufferStalls, 64, "nStallBuffer");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->statis.stallBufferUs, pLoad->bufferStallTimeUs, 64, "stallBufferUs");
 }
 
 void vnodeGetInfo(SVnode *pVnode, const char **dbname, int32_t *vgId) {
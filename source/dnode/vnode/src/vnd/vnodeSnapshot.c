@@ -258,9 +258,11 @@ int32_t vnodeSnapWriterOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapWr
   pWriter->sver = sver;
   pWriter->ever = ever;
 
-  // commit it
+  // commit it, the file set is replaced by the snapshot so no retention or compaction runs until the writer is closed
+  vnodeStopBgTask(pVnode);
   code = vnodeCommit(pVnode);
   if (code) {
+    vnodeResumeBgTask(pVnode);
     taosMemoryFree(pWriter);
     goto _err;
   }
@@ -312,6 +314,7 @@ int32_t vnodeSnapWriterClose(SVSnapWriter *pWriter, int8_t rollback, SSnapshot *
     info.state.committed = pVnode->state.applied;
     info.state.commitTerm = pVnode->state.applyTerm;
     info.state.commitID = pVnode->state.commitID;
+    info.state.trimTime = atomic_load_32(&pVnode->state.trimTime);
     snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
     code = vnodeSaveInfo(dir, &info);
     if (code) goto _err;
@@ -326,6 +329,7 @@ int32_t vnodeSnapWriterClose(SVSnapWriter *pWriter, int8_t rollback, SSnapshot *
 
 _exit:
   vInfo("vgId:%d, vnode snapshot writer closed, rollback:%d", TD_VID(pVnode), rollback);
+  vnodeResumeBgTask(pVnode);
   taosMemoryFree(pWriter);
   return code;
 
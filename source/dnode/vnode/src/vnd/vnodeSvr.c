@@ -178,9 +178,19 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
     return -1;
   }
 
+  // nothing more can be committed after a failed commit, do not buffer what can not be flushed
+  int32_t commitCode = atomic_load_32(&pVnode->commitCode);
+  if (commitCode) {
+    terrno = commitCode;
+    vError("vgId:%d, not ready to write since commit failed, %s", TD_VID(pVnode), terrstr());
+    return -1;
+  }
+
   vDebug("vgId:%d, start to process write request %s, index:%" PRId64, TD_VID(pVnode), TMSG_INFO(pMsg->msgType),
          version);
 
+  vnodeBufPoolCheckBudget(pVnode);
+
   pVnode->state.applied = version;
   pVnode->state.applyTerm = pMsg->info.conn.applyTerm;
 
@@ -303,8 +313,8 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
   if (vnodeShouldCommit(pVnode)) {
   _do_commit:
     vInfo("vgId:%d, commit at version %" PRId64, TD_VID(pVnode), version);
-    // commit current change
-    if (vnodeCommit(pVnode) < 0) {
+    // commit current change, the data files are flushed in background
+    if (vnodeAsyncCommit(pVnode) < 0) {
       vError("vgId:%d, failed to commit vnode since %s.", TD_VID(pVnode), tstrerror(terrno));
       goto _err;
     }
@@ -339,13 +349,21 @@ int32_t vnodeProcessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
     return 0;
   }
 
+  // background I/O of the dnode is slowed down while queries run
   SReadHandle handle = {.meta = pVnode->pMeta, .config = &pVnode->config, .vnode = pVnode, .pMsgCb = &pVnode->msgCb};
+  int32_t     code = 0;
   switch (pMsg->msgType) {
     case TDMT_SCH_QUERY:
     case TDMT_SCH_MERGE_QUERY:
-      return qWorkerProcessQueryMsg(&handle, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundEnter();
+      code = qWorkerProcessQueryMsg(&handle, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundLeave();
+      return code;
     case TDMT_SCH_QUERY_CONTINUE:
-      return qWorkerProcessCQueryMsg(&handle, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundEnter();
+      code = qWorkerProcessCQueryMsg(&handle, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundLeave();
+      return code;
     default:
       vError("unknown msg type:%d in query queue", pMsg->msgType);
       return TSDB_CODE_VND_APP_ERROR;
@@ -355,7 +373,7 @@ int32_t vnodeProcessQueryMsg(SVnode *pVnode, SRpcMsg *pMsg) {
 int32_t vnodeProcessFetchMsg(SVnode *pVnode, SRpcMsg *pMsg, SQueueInfo *pInfo) {
   vTrace("vgId:%d, msg:%p in fetch queue is processing", pVnode->config.vgId, pMsg);
   if ((pMsg->msgType == TDMT_SCH_FETCH || pMsg->msgType == TDMT_VND_TABLE_META || pMsg->msgType == TDMT_VND_TABLE_CFG ||
-       pMsg->msgType == TDMT_VND_BATCH_META) &&
+       pMsg->msgType == TDMT_VND_BATCH_META || pMsg->msgType == TDMT_VND_TABLES_META) &&
       !vnodeIsLeader(pVnode)) {
     vnodeRedirectRpcMsg(pVnode, pMsg);
     return 0;
@@ -366,10 +384,14 @@ int32_t vnodeProcessFetchMsg(SVnode *pVnode, SRpcMsg *pMsg, SQueueInfo *pInfo) {
     return 0;
   }
 
+  int32_t code = 0;
   switch (pMsg->msgType) {
     case TDMT_SCH_FETCH:
     case TDMT_SCH_MERGE_FETCH:
-      return qWorkerProcessFetchMsg(pVnode, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundEnter();
+      code = qWorkerProcessFetchMsg(pVnode, pVnode->pQuery, pMsg, 0);
+      vnodeIoForegroundLeave();
+      return code;
     case TDMT_SCH_FETCH_RSP:
       return qWorkerProcessRspMsg(pVnode, pVnode->pQuery, pMsg, 0);
     // case TDMT_SCH_CANCEL_TASK:
@@ -384,6 +406,8 @@ int32_t vnodeProcessFetchMsg(SVnode *pVnode, SRpcMsg *pMsg, SQueueInfo *pInfo) {
       return vnodeGetTableCfg(pVnode, pMsg, true);
     case TDMT_VND_BATCH_META:
       return vnodeGetBatchMeta(pVnode, pMsg);
+    case TDMT_VND_TABLES_META:
+      return vnodeGetTablesMeta(pVnode, pMsg);
     case TDMT_VND_TMQ_CONSUME:
       return tqProcessPollReq(pVnode->pTq, pMsg);
     case TDMT_STREAM_TASK_RUN:
@@ -440,12 +464,10 @@ static int32_t vnodeProcessTrimReq(SVnode *pVnode, int64_t version, void *pReq,
 
   vInfo("vgId:%d, trim vnode request will be processed, time:%d", pVnode->config.vgId, trimReq.timestamp);
 
-  // process
-  code = tsdbDoRetention(pVnode->pTsdb, trimReq.timestamp);
-  if (code) goto _exit;
-
-  code = smaDoRetention(pVnode->pSma, trimReq.timestamp);
-  if (code) goto _exit;
+  // process, retention copies file sets under the migrate I/O limit and is left to the background task. The trim
+  // stays pending in the vnode state until it is done, the commits save it and an open reruns it.
+  atomic_store_32(&pVnode->state.trimTime, trimReq.timestamp);
+  vnodeStartBgTask(pVnode, 0);
 
 _exit:
   return code;
@@ -521,6 +543,8 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
   char               tbName[TSDB_TABLE_FNAME_LEN];
   STbUidStore       *pStore = NULL;
   SArray            *tbUids = NULL;
+  SArray            *aCreateReq = NULL;
+  SArray            *aCreateRsp = NULL;
 
   pRsp->msgType = TDMT_VND_CREATE_TABLE_RSP;
   pRsp->code = TSDB_CODE_SUCCESS;
@@ -537,17 +561,16 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
 
   rsp.pArray = taosArrayInit(req.nReqs, sizeof(cRsp));
   tbUids = taosArrayInit(req.nReqs, sizeof(int64_t));
-  if (rsp.pArray == NULL || tbUids == NULL) {
+  aCreateReq = taosArrayInit(req.nReqs, POINTER_BYTES);
+  aCreateRsp = taosArrayInit(req.nReqs, POINTER_BYTES);
+  if (rsp.pArray == NULL || tbUids == NULL || aCreateReq == NULL || aCreateRsp == NULL) {
     rcode = -1;
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
 
-  // loop to create table
-  for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
-    pCreateReq = req.pReqs + iReq;
-    memset(&cRsp, 0, sizeof(cRsp));
-
+  // the grant is checked once for the whole batch
+  if (req.nReqs > 0) {
     if ((terrno = grantCheck(TSDB_GRANT_TIMESERIES)) < 0) {
       rcode = -1;
       goto _exit;
@@ -557,6 +580,12 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
       rcode = -1;
       goto _exit;
     }
+  }
+
+  // loop to validate the requests, the tables are created in one batch below
+  for (int32_t iReq = 0; iReq < req.nReqs; iReq++) {
+    pCreateReq = req.pReqs + iReq;
+    memset(&cRsp, 0, sizeof(cRsp));
 
     // validate hash
     sprintf(tbName, "%s.%s", pVnode->config.dbname, pCreateReq->name);
@@ -566,21 +595,35 @@ static int32_t vnodeProcessCreateTbReq(SVnode *pVnode, int64_t version, void *pR
       continue;
     }
 
-    // do create table
-    if (metaCreateTable(pVnode->pMeta, version, pCreateReq, &cRsp.pMeta) < 0) {
-      if (pCreateReq->flags & TD_CREATE_IF_NOT_EXISTS && terrno == TSDB_CODE_TDB_TABLE_ALREADY_EXIST) {
-        cRsp.code = TSDB_CODE_SUCCESS;
-      } else {
-        cRsp.code = terrno;
+    cRsp.code = TSDB_CODE_SUCCESS;
+    taosArrayPush(rsp.pArray, &cRsp);
+    taosArrayPush(aCreateReq, &pCreateReq);
+  }
+
+  // rsp.pArray is not resized any more, so it is safe to refer to its elements
+  for (int32_t iRsp = 0; iRsp < taosArrayGetSize(rsp.pArray); iRsp++) {
+    SVCreateTbRsp *pCreateRsp = taosArrayGet(rsp.pArray, iRsp);
+    if (pCreateRsp->code == TSDB_CODE_SUCCESS) {
+      taosArrayPush(aCreateRsp, &pCreateRsp);
+    }
+  }
+
+  // do create table
+  metaCreateTableBatch(pVnode->pMeta, version, aCreateReq, aCreateRsp);
+
+  for (int32_t iReq = 0; iReq < taosArrayGetSize(aCreateReq); iReq++) {
+    SVCreateTbRsp *pCreateRsp = *(SVCreateTbRsp **)taosArrayGet(aCreateRsp, iReq);
+    pCreateReq = *(SVCreateTbReq **)taosArrayGet(aCreateReq, iReq);
+
+    if (pCreateRsp->code != TSDB_CODE_SUCCESS) {
+      if (pCreateReq->flags & TD_CREATE_IF_NOT_EXISTS && pCreateRsp->code == TSDB_CODE_TDB_TABLE_ALREADY_EXIST) {
+        pCreateRsp->code = TSDB_CODE_SUCCESS;
       }
     } else {
-      cRsp.code = TSDB_CODE_SUCCESS;
       tdFetchTbUidList(pVnode->pSma, &pStore, pCreateReq->ctb.suid, pCreateReq->uid);
       taosArrayPush(tbUids, &pCreateReq->uid);
-      vnodeUpdateMetaRsp(pVnode, cRsp.pMeta);
+      vnodeUpdateMetaRsp(pVnode, pCreateRsp->pMeta);
     }
-
-    taosArrayPush(rsp.pArray, &cRsp);
   }
 
   vDebug("vgId:%d, add %d new created tables into query table list", TD_VID(pVnode), (int32_t)taosArrayGetSize(tbUids));
@@ -609,6 +652,8 @@ _exit:
   }
   taosArrayDestroyEx(rsp.pArray, tFreeSVCreateTbRsp);
   taosArrayDestroy(tbUids);
+  taosArrayDestroy(aCreateReq);
+  taosArrayDestroy(aCreateRsp);
   tDecoderClear(&decoder);
   tEncoderClear(&encoder);
   return rcode;
@@ -809,16 +854,19 @@ static int32_t vnodeDebugPrintSingleSubmitMsg(SMeta *pMeta, SSubmitBlk *pBlock,
   STSRow        *row = NULL;
   int32_t        rv = -1;
 
-  tInitSubmitBlkIter(msgIter, pBlock, &blkIter);
-  if (blkIter.row == NULL) return 0;
+  if (tInitSubmitBlkIter(msgIter, pBlock, &blkIter) < 0) {
+    tDestroySubmitBlkIter(&blkIter);
+    return 0;
+  }
 
-  pSchema = metaGetTbTSchema(pMeta, msgIter->suid, TD_ROW_SVER(blkIter.row), 1);  // TODO: use the real schema
+  pSchema = metaGetTbTSchema(pMeta, msgIter->suid, msgIter->sversion, 1);  // TODO: use the real schema
   if (pSchema) {
     suid = msgIter->suid;
-    rv = TD_ROW_SVER(blkIter.row);
+    rv = msgIter->sversion;
   }
   if (!pSchema) {
     printf("%s:%d no valid schema\n", tags, __LINE__);
+    tDestroySubmitBlkIter(&blkIter);
     return -1;
   }
   char __tags[128] = {0};
@@ -827,6 +875,7 @@ static int32_t vnodeDebugPrintSingleSubmitMsg(SMeta *pMeta, SSubmitBlk *pBlock,
     tdSRowPrint(row, pSchema, __tags);
   }
 
+  tDestroySubmitBlkIter(&blkIter);
   taosMemoryFreeClear(pSchema);
 
   return TSDB_CODE_SUCCESS;
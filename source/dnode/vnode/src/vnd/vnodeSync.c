@@ -469,6 +469,11 @@ static void vnodeBecomeFollower(const SSyncFSM *pFsm) {
     tsem_post(&pVnode->syncSem);
   }
   taosThreadMutexUnlock(&pVnode->lock);
+
+  // polls parked on the old leader are sent back, the consumers look up the new one
+  if (pVnode->pTq) {
+    tqPushReplyAll(pVnode->pTq, TSDB_CODE_SYN_NOT_LEADER);
+  }
 }
 
 static void vnodeBecomeLeader(const SSyncFSM *pFsm) {
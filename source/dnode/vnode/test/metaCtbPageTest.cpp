@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "meta.h"
+
+class MetaCtbPageTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    snprintf(path, sizeof(path), "/tmp/metaCtbPageTest%d", taosGetPId());
+    taosRemoveDir(path);
+    taosMkDir(path);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->path = path;
+    pVnode->config.vgId = 2;
+    pVnode->config.szPage = 4096;
+    pVnode->config.szCache = 256;
+    ASSERT_EQ(metaOpen(pVnode, &pMeta, 0), 0);
+    ASSERT_EQ(metaBegin(pMeta, 1), 0);
+
+    // children 1..10 of stb 100, with neighbours in the stbs around it
+    addCtb(99, 5);
+    for (tb_uid_t uid = 1; uid <= 10; ++uid) {
+      addCtb(100, uid);
+    }
+    addCtb(101, 1);
+  }
+
+  void TearDown() override {
+    tdbAbort(pMeta->pEnv, &pMeta->txn);
+    metaClose(pMeta);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(path);
+  }
+
+  void addCtb(tb_uid_t suid, tb_uid_t uid) {
+    SCtbIdxKey key = {.suid = suid, .uid = uid};
+    char       tags[8] = {0};
+    ASSERT_EQ(tdbTbUpsert(pMeta->pCtbIdx, &key, sizeof(key), tags, sizeof(tags), &pMeta->txn), 0);
+  }
+
+  void delCtb(tb_uid_t suid, tb_uid_t uid) {
+    SCtbIdxKey key = {.suid = suid, .uid = uid};
+    ASSERT_EQ(tdbTbDelete(pMeta->pCtbIdx, &key, sizeof(key), &pMeta->txn), 0);
+  }
+
+  // one page of uids as the vnode serves it
+  std::vector<tb_uid_t> page(tb_uid_t lastUid, int32_t limit, int8_t *hasMore) {
+    std::vector<tb_uid_t> uids;
+    SArray               *pUids = taosArrayInit(limit, sizeof(tb_uid_t));
+    EXPECT_EQ(metaGetCtbUids(pMeta, 100, lastUid, limit, pUids, hasMore), 0);
+    for (int32_t i = 0; i < taosArrayGetSize(pUids); ++i) {
+      uids.push_back(*(tb_uid_t *)taosArrayGet(pUids, i));
+    }
+    taosArrayDestroy(pUids);
+    return uids;
+  }
+
+  // all the uids paged through with the given page size
+  std::vector<tb_uid_t> pageAll(int32_t limit, int32_t *pageNum) {
+    std::vector<tb_uid_t> all;
+    tb_uid_t              lastUid = 0;
+    int8_t                hasMore = 1;
+    *pageNum = 0;
+    while (hasMore) {
+      std::vector<tb_uid_t> uids = page(lastUid, limit, &hasMore);
+      ++*pageNum;
+      if (uids.empty()) break;
+      all.insert(all.end(), uids.begin(), uids.end());
+      lastUid = uids.back();
+    }
+    return all;
+  }
+
+  char    path[64];
+  SVnode *pVnode;
+  SMeta  *pMeta;
+};
+
+static std::vector<tb_uid_t> range(tb_uid_t s, tb_uid_t e) {
+  std::vector<tb_uid_t> v;
+  for (tb_uid_t uid = s; uid <= e; ++uid) v.push_back(uid);
+  return v;
+}
+
+TEST_F(MetaCtbPageTest, cursorSkip) {
+  SMCtbCursor *pCur = metaOpenCtbCursor(pMeta, 100, 1);
+  ASSERT_NE(pCur, nullptr);
+  ASSERT_EQ(metaCtbCursorSkip(pCur, 3), 0);
+  EXPECT_EQ(metaCtbCursorNext(pCur), 4);
+  metaCloseCtbCursor(pCur, 1);
+
+  // the last uid of the stb leaves nothing, not the child of the next stb
+  pCur = metaOpenCtbCursor(pMeta, 100, 1);
+  ASSERT_EQ(metaCtbCursorSkip(pCur, 10), 0);
+  EXPECT_EQ(metaCtbCursorNext(pCur), 0);
+  metaCloseCtbCursor(pCur, 1);
+
+  // a uid dropped since the last page continues with the next one
+  delCtb(100, 6);
+  pCur = metaOpenCtbCursor(pMeta, 100, 1);
+  ASSERT_EQ(metaCtbCursorSkip(pCur, 6), 0);
+  EXPECT_EQ(metaCtbCursorNext(pCur), 7);
+  metaCloseCtbCursor(pCur, 1);
+}
+
+TEST_F(MetaCtbPageTest, pageBoundary) {
+  int8_t hasMore = 0;
+  EXPECT_EQ(page(0, 3, &hasMore), range(1, 3));
+  EXPECT_EQ(hasMore, 1);
+  EXPECT_EQ(page(3, 3, &hasMore), range(4, 6));
+  EXPECT_EQ(hasMore, 1);
+  EXPECT_EQ(page(9, 3, &hasMore), range(10, 10));
+  EXPECT_EQ(hasMore, 0);
+
+  // a full last page does not ask for an empty one
+  EXPECT_EQ(page(5, 5, &hasMore), range(6, 10));
+  EXPECT_EQ(hasMore, 0);
+
+  int32_t pageNum = 0;
+  for (int32_t limit : {1, 3, 5, 10, 11}) {
+    EXPECT_EQ(pageAll(limit, &pageNum), range(1, 10));
+    EXPECT_EQ(pageNum, (10 + limit - 1) / limit);
+  }
+}
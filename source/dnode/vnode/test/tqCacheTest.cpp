@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "tq.h"
+
+class TqCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pCache = tqLogCacheOpen(1024 * 1024);
+    ASSERT_NE(pCache, nullptr);
+    pCkHead = (SWalCkHead *)taosMemoryCalloc(1, sizeof(SWalCkHead));
+    capacity = 0;
+  }
+
+  void TearDown() override {
+    taosMemoryFree(pCkHead);
+    tqLogCacheClose(pCache);
+  }
+
+  STqLogCache *pCache;
+  SWalCkHead  *pCkHead;
+  int64_t      capacity;
+};
+
+TEST_F(TqCacheTest, get) {
+  char body[100];
+  for (int32_t i = 0; i < sizeof(body); ++i) body[i] = i;
+  ASSERT_EQ(tqLogCachePut(pCache, 10, TDMT_VND_SUBMIT, body, sizeof(body)), 0);
+  ASSERT_EQ(tqLogCachePut(pCache, 11, TDMT_VND_TMQ_COMMIT_OFFSET, body, sizeof(body)), 0);
+
+  ASSERT_EQ(tqLogCacheGet(pCache, 10, &pCkHead, &capacity), 0);
+  EXPECT_EQ(pCkHead->head.version, 10);
+  EXPECT_EQ(pCkHead->head.msgType, TDMT_VND_SUBMIT);
+  ASSERT_EQ(pCkHead->head.bodyLen, sizeof(body));
+  EXPECT_EQ(memcmp(pCkHead->head.body, body, sizeof(body)), 0);
+  EXPECT_GE(capacity, sizeof(body));
+
+  // the other entries are kept head only, the readers skip them
+  ASSERT_EQ(tqLogCacheGet(pCache, 11, &pCkHead, &capacity), 0);
+  EXPECT_EQ(pCkHead->head.bodyLen, 0);
+
+  EXPECT_EQ(tqLogCacheGet(pCache, 12, &pCkHead, &capacity), -1);
+  EXPECT_EQ(pCache->hitNum, 2);
+  EXPECT_EQ(pCache->missNum, 1);
+}
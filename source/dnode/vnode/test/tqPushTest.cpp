@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "tq.h"
+
+static std::vector<SRpcMsg> rsps;
+static std::vector<SRpcMsg> reqs;
+
+static void    sendRsp(SRpcMsg *pMsg) { rsps.push_back(*pMsg); }
+static int32_t putToQueue(void *pMgmt, EQueueType qtype, SRpcMsg *pMsg) {
+  reqs.push_back(*pMsg);
+  return 0;
+}
+
+class TqPushTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rsps.clear();
+    reqs.clear();
+
+    SMsgCb msgCb = {0};
+    msgCb.sendRspFp = sendRsp;
+    msgCb.putToQueueFp = putToQueue;
+    tmsgSetDefault(&msgCb);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 2;
+    pVnode->msgCb = msgCb;
+    pTq = (STQ *)taosMemoryCalloc(1, sizeof(STQ));
+    pTq->pVnode = pVnode;
+    taosInitRWLatch(&pTq->pushLock);
+    pTq->pPushMgr = taosHashInit(64, MurmurHash3_32, true, HASH_NO_LOCK);
+  }
+
+  void TearDown() override {
+    tqPushReplyAll(pTq, TSDB_CODE_VND_IS_CLOSING);
+    for (auto &msg : reqs) rpcFreeCont(msg.pCont);
+    taosHashCleanup(pTq->pPushMgr);
+    taosMemoryFree(pTq);
+    taosMemoryFree(pVnode);
+  }
+
+  // park a poll of subKey, returns the poll it replaced
+  STqPushEntry *park(const char *subKey, int64_t consumerId, int64_t timeout) {
+    SMqPollReq req = {0};
+    tstrncpy(req.subKey, subKey, TSDB_SUBSCRIBE_KEY_LEN);
+    req.consumerId = consumerId;
+    req.timeout = timeout;
+    SRpcMsg      msg = {0};
+    msg.pCont = &req;
+    msg.info.handle = (void *)consumerId;
+    STqOffsetVal  offset = {0};
+    STqPushEntry *pOld = NULL;
+
+    taosWLockLatch(&pTq->pushLock);
+    EXPECT_EQ(tqPushRegister(pTq, &msg, &offset, &pOld), 0);
+    taosWUnLockLatch(&pTq->pushLock);
+    return pOld;
+  }
+
+  SVnode *pVnode;
+  STQ    *pTq;
+};
+
+TEST_F(TqPushTest, replace) {
+  EXPECT_EQ(park("cg:topic", 1, 1000), nullptr);
+
+  // the replaced poll is handed back to the caller and dispatched outside the lock
+  STqPushEntry *pOld = park("cg:topic", 2, 1000);
+  ASSERT_NE(pOld, nullptr);
+  EXPECT_EQ(pOld->pollReq.consumerId, 1);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 1);
+
+  tqPushRedispatch(pTq, pOld);
+  ASSERT_EQ(reqs.size(), 1);
+  EXPECT_EQ(reqs[0].msgType, TDMT_VND_TMQ_CONSUME);
+  EXPECT_EQ(reqs[0].info.handle, (void *)1);
+  EXPECT_EQ(((SMqPollReq *)reqs[0].pCont)->timeout, 0);
+
+  tqPushRemove(pTq, "cg:topic");
+  ASSERT_EQ(reqs.size(), 2);
+  EXPECT_EQ(reqs[1].info.handle, (void *)2);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 0);
+}
+
+TEST_F(TqPushTest, expire) {
+  park("cg:t1", 1, 1);
+  park("cg:t2", 2, 60000);
+  taosMsleep(10);
+
+  tqPushExpire(pTq);
+  ASSERT_EQ(reqs.size(), 1);
+  EXPECT_EQ(reqs[0].info.handle, (void *)1);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 1);
+}
+
+TEST_F(TqPushTest, replyAll) {
+  park("cg:t1", 1, 60000);
+  park("cg:t2", 2, 60000);
+  park("cg:t3", 3, 60000);
+
+  // every parked poll is answered with the error instead of waiting for the rpc timeout
+  tqPushReplyAll(pTq, TSDB_CODE_VND_IS_CLOSING);
+  EXPECT_EQ(reqs.size(), 0);
+  ASSERT_EQ(rsps.size(), 3);
+  for (auto &rsp : rsps) EXPECT_EQ(rsp.code, TSDB_CODE_VND_IS_CLOSING);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 0);
+
+  tqPushReplyAll(pTq, TSDB_CODE_SYN_NOT_LEADER);
+  EXPECT_EQ(rsps.size(), 3);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "vnd.h"
+
+#define MB (1024 * 1024)
+
+static std::vector<int32_t> askedVgIds;
+
+static int32_t putToQueue(void *pMgmt, EQueueType qtype, SRpcMsg *pMsg) {
+  EXPECT_EQ(qtype, WRITE_QUEUE);
+  EXPECT_EQ(pMsg->msgType, TDMT_VND_COMMIT);
+  askedVgIds.push_back(ntohl(((SMsgHead *)pMsg->pCont)->vgId));
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+class VnodeBufPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tsVnodeWriteBufferNum = 3;
+    tsVnodeWriteBufferSize = INT64_MAX;
+    tsVnodeCommitAge = 600;
+    tsDataSpace.size.avail = 1;
+    vnodeBufPoolInit();
+    askedVgIds.clear();
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 2;
+    pVnode->config.szBuf = 48 * MB;
+    pVnode->msgCb.putToQueueFp = putToQueue;
+    taosThreadMutexInit(&pVnode->mutex, NULL);
+    taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+  }
+
+  void TearDown() override {
+    vnodeCloseBufPool(pVnode);
+    taosThreadCondDestroy(&pVnode->poolNotEmpty);
+    taosThreadMutexDestroy(&pVnode->mutex);
+    taosMemoryFree(pVnode);
+    vnodeBufPoolCleanup();
+  }
+
+  // take a free pool as the active memtable, as vnodeBegin does
+  SVBufPool *begin() {
+    SVBufPool *pPool = pVnode->pPool;
+    pVnode->pPool = pPool->next;
+    pPool->next = NULL;
+    pPool->nRef = 1;
+    pVnode->inUse = pPool;
+    pVnode->commitAskMs = 0;
+    return pPool;
+  }
+
+  void fill(SVBufPool *pPool, int64_t size) {
+    for (int64_t n = 0; n < size; n += 4096) {
+      ASSERT_NE(vnodeBufPoolMalloc(pPool, 4096), nullptr);
+    }
+  }
+
+  // hand the active memtable over to commit, as vnodeCommit does
+  SVBufPool *freeze() {
+    SVBufPool *pPool = pVnode->inUse;
+    vnodeBufPoolFreeze(pPool);
+    pVnode->inUse = NULL;
+    return pPool;
+  }
+
+  // the scans are at least 100ms apart
+  void check() {
+    taosMsleep(110);
+    vnodeBufPoolCheckBudget(pVnode);
+  }
+
+  SVnode *pVnode;
+};
+
+TEST_F(VnodeBufPoolTest, vnodeBound) {
+  // a vnode written alone fills its whole buffer in one memtable, the chunks do not overshoot it by much
+  SVBufPool *pPool = begin();
+  EXPECT_EQ(vnodeBufPoolGetMaxSize(pVnode), 48 * MB - 2 * 64 * 1024);
+  fill(pPool, 40 * MB);
+  EXPECT_FALSE(vnodeShouldCommit(pVnode));
+  while (!vnodeShouldCommit(pVnode)) fill(pPool, 256 * 1024);
+  EXPECT_LE(pPool->size, 48 * MB);
+  EXPECT_LE(pPool->capacity, 48 * MB + 6 * MB + 64 * 1024);
+
+  // the next memtable gets what is left while the first one is committed, at least its part of the buffer
+  freeze();
+  SVBufPool *pPool2 = begin();
+  EXPECT_EQ(vnodeBufPoolGetMaxSize(pVnode), 16 * MB);
+  fill(pPool2, 8 * MB);
+  EXPECT_FALSE(vnodeShouldCommit(pVnode));
+
+  // the chunks are given back to the dnode with the memtable
+  int64_t used = vnodeBufPoolGetUsed();
+  vnodeBufPoolUnRef(pPool);
+  EXPECT_EQ(pPool->capacity, pPool->node.size);
+  EXPECT_LE(vnodeBufPoolGetUsed(), used - 48 * MB);
+  EXPECT_GE(vnodeBufPoolGetMaxSize(pVnode), 47 * MB);
+}
+
+TEST_F(VnodeBufPoolTest, dnodeBudget) {
+  SVBufPool *pPool = begin();
+  fill(pPool, 2 * MB);
+  check();
+  EXPECT_TRUE(askedVgIds.empty());
+
+  // over the budget, the vnode with the largest memtable is asked to commit, once
+  tsVnodeWriteBufferSize = MB;
+  check();
+  ASSERT_EQ(askedVgIds.size(), 1);
+  EXPECT_EQ(askedVgIds[0], 2);
+  check();
+  EXPECT_EQ(askedVgIds.size(), 1);
+
+  // the memory of the memtables being committed is on its way back, nothing more is asked for
+  freeze();
+  pPool = begin();
+  fill(pPool, 2 * MB);
+  tsVnodeWriteBufferSize = 3 * MB;
+  check();
+  EXPECT_EQ(askedVgIds.size(), 1);
+}
+
+TEST_F(VnodeBufPoolTest, idleVnode) {
+  // an old memtable is asked to commit though the vnode is not written, its chunks go back to the others
+  SVBufPool *pPool = begin();
+  fill(pPool, 2 * MB);
+  tsVnodeCommitAge = 1;
+  check();
+  EXPECT_TRUE(askedVgIds.empty());
+  pPool->firstTs -= 2000;
+  check();
+  ASSERT_EQ(askedVgIds.size(), 1);
+  EXPECT_EQ(askedVgIds[0], 2);
+}
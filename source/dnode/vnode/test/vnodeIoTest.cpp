@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "vnd.h"
+
+#define MB (1024 * 1024)
+
+static int64_t acquireMs(int8_t ioClass, int64_t nBytes) {
+  int64_t st = taosGetTimestampMs();
+  vnodeIoAcquire(NULL, ioClass, nBytes);
+  return taosGetTimestampMs() - st;
+}
+
+class VnodeIoTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tsCommitIOLimit = 0;
+    tsCompactIOLimit = 0;
+    tsMigrateIOLimit = 0;
+    tsSnapshotIOLimit = 0;
+    tsIoBackgroundShare = 50;
+    vnodeIoInit();
+  }
+  void TearDown() override { vnodeIoCleanup(); }
+};
+
+TEST_F(VnodeIoTest, unlimited) {
+  // no limit and the foreground class never wait
+  EXPECT_LT(acquireMs(VND_IO_COMMIT, 1024 * MB), 50);
+  EXPECT_LT(acquireMs(VND_IO_NONE, 1024 * MB), 50);
+}
+
+TEST_F(VnodeIoTest, limited) {
+  tsMigrateIOLimit = 4;
+
+  // a full bucket grants one second of the rate, the next caller waits for the debt
+  EXPECT_LT(acquireMs(VND_IO_MIGRATE, 4 * MB), 50);
+  EXPECT_LT(acquireMs(VND_IO_MIGRATE, 2 * MB), 50);
+  int64_t ms = acquireMs(VND_IO_MIGRATE, MB);
+  EXPECT_GE(ms, 400);
+  EXPECT_LT(ms, 1000);
+
+  // the classes are independent
+  EXPECT_LT(acquireMs(VND_IO_COMPACT, 64 * MB), 50);
+}
+
+TEST_F(VnodeIoTest, foreground) {
+  tsCompactIOLimit = 4;
+  tsIoBackgroundShare = 25;
+
+  // while queries run, a class only gets its share of the rate
+  vnodeIoForegroundEnter();
+  EXPECT_LT(acquireMs(VND_IO_COMPACT, MB), 50);
+  EXPECT_LT(acquireMs(VND_IO_COMPACT, MB), 50);
+  int64_t ms = acquireMs(VND_IO_COMPACT, MB);
+  vnodeIoForegroundLeave();
+  EXPECT_GE(ms, 800);
+}
+
+TEST_F(VnodeIoTest, ioStat) {
+  SVnodeIoStat aStat[VND_IO_MAX] = {0};
+
+  tsSnapshotIOLimit = 1;
+  vnodeIoAcquire(NULL, VND_IO_SNAPSHOT, MB);
+  vnodeIoAcquire(NULL, VND_IO_SNAPSHOT, MB / 2);
+  vnodeIoAcquire(NULL, VND_IO_SNAPSHOT, MB / 4);
+  vnodeIoAcquire(NULL, VND_IO_COMMIT, 100);
+
+  vnodeGetIoStat(aStat);
+  EXPECT_EQ(aStat[VND_IO_SNAPSHOT].bytes, MB + MB / 2 + MB / 4);
+  EXPECT_GT(aStat[VND_IO_SNAPSHOT].waitUs, 0);
+  EXPECT_EQ(aStat[VND_IO_SNAPSHOT].queued, 0);
+  EXPECT_EQ(aStat[VND_IO_COMMIT].bytes, 100);
+  EXPECT_EQ(aStat[VND_IO_COMMIT].waitUs, 0);
+
+  // the counters are deltas since the last report
+  vnodeGetIoStat(aStat);
+  EXPECT_EQ(aStat[VND_IO_SNAPSHOT].bytes, 0);
+  EXPECT_EQ(aStat[VND_IO_SNAPSHOT].waitUs, 0);
+}
+
+TEST_F(VnodeIoTest, stop) {
+  SVnode vnode = {0};
+  tsCompactIOLimit = 1;
+
+  // a stopped vnode gives up its background I/O, even the one waiting for the bucket
+  EXPECT_EQ(vnodeIoAcquire(&vnode, VND_IO_COMPACT, 2 * MB), 0);
+  std::thread stopper([&vnode]() {
+    taosMsleep(200);
+    atomic_store_8(&vnode.bgStop, 1);
+  });
+  int64_t st = taosGetTimestampMs();
+  EXPECT_EQ(vnodeIoAcquire(&vnode, VND_IO_COMPACT, MB), TSDB_CODE_VND_BG_TASK_STOPPED);
+  EXPECT_LT(taosGetTimestampMs() - st, 1000);
+  stopper.join();
+  EXPECT_EQ(vnodeIoAcquire(&vnode, VND_IO_MIGRATE, MB), TSDB_CODE_VND_BG_TASK_STOPPED);
+
+  // commits and snapshots are not stopped
+  EXPECT_EQ(vnodeIoAcquire(&vnode, VND_IO_COMMIT, MB), 0);
+  EXPECT_EQ(vnodeIoAcquire(&vnode, VND_IO_SNAPSHOT, MB), 0);
+}
@@ -33,6 +33,10 @@ extern "C" {
 #define CTG_DEFAULT_MAX_RETRY_TIMES      3
 #define CTG_DEFAULT_BATCH_NUM            64
 #define CTG_DEFAULT_FETCH_NUM            8
+#define CTG_DEFAULT_PREFETCH_NUM         4096
+#define CTG_DEFAULT_PREFETCH_VG_NUM      8
+#define CTG_RCU_SLOT_NUM                 64
+#define CTG_RCU_RECLAIM_INTERVAL_NS      (10 * 1000000)
 
 #define CTG_RENT_SLOT_SECOND 1.5
 
@@ -64,6 +68,7 @@ enum {
   CTG_OP_UPDATE_TB_INDEX,
   CTG_OP_DROP_TB_INDEX,
   CTG_OP_CLEAR_CACHE,
+  CTG_OP_UPDATE_CTB_METAS,
   CTG_OP_MAX
 };
 
@@ -178,14 +183,14 @@ typedef struct SCtgUserCtx {
 typedef STableIndexRsp STableIndex;
 
 typedef struct SCtgTbCache {
-  SRWLatch     metaLock;
+  SRWLatch     metaLock;  // serializes writers only, readers go through ctgRcuReadLock
   STableMeta*  pMeta;
   SRWLatch     indexLock;
   STableIndex* pIndex;
 } SCtgTbCache;
 
 typedef struct SCtgVgCache {
-  SRWLatch   vgLock;
+  SRWLatch   vgLock;  // serializes writers only, readers go through ctgRcuReadLock
   SDBVgInfo* vgInfo;
 } SCtgVgCache;
 
@@ -434,6 +439,29 @@ typedef struct SCtgClearCacheMsg {
   bool      freeCtg;
 } SCtgClearCacheMsg;
 
+typedef struct SCtgUpdateCtbMetasMsg {
+  SCatalog* pCtg;
+  char      dbFName[TSDB_DB_FNAME_LEN];
+  uint64_t  dbId;
+  uint64_t  suid;
+  int32_t   vgId;
+  SArray*   pCtbs;  // element is SVCtbMeta
+} SCtgUpdateCtbMetasMsg;
+
+// the vgroups of a super table paged by several threads at the same time
+typedef struct SCtgCtbPrefetch {
+  SCatalog*         pCtg;
+  SRequestConnInfo* pConn;
+  const SName*      pStbName;
+  char              dbFName[TSDB_DB_FNAME_LEN];
+  STableMeta*       pStb;
+  SArray*           vgList;
+  int32_t           vgIdx;  // next vgroup to page
+  int8_t            stbRefreshed;
+  int32_t           code;
+  int64_t           ctbNum;
+} SCtgCtbPrefetch;
+
 typedef struct SCtgUpdateEpsetMsg {
   SCatalog* pCtg;
   char      dbFName[TSDB_DB_FNAME_LEN];
@@ -464,6 +492,29 @@ typedef struct SCtgQueue {
   uint64_t   qRemainNum;
 } SCtgQueue;
 
+typedef void (*FCtgRcuFree)(void*);
+
+typedef struct SCtgRcuRetired {
+  void*       p;
+  FCtgRcuFree freeFp;
+} SCtgRcuRetired;
+
+typedef struct SCtgRcuSlot {
+  int64_t readers[2];  // indexed by epoch parity
+  char    pad[64 - 2 * sizeof(int64_t)];
+} SCtgRcuSlot;
+
+// Epoch based reclamation of the vgInfo and tbMeta objects published in the cache
+typedef struct SCtgRcu {
+  int64_t       epoch;
+  int32_t       slotId;
+  int8_t        phase;
+  TdThreadMutex lock;
+  SArray*       retired;  // element is SCtgRcuRetired, not yet waiting for readers
+  SArray*       waiting;  // element is SCtgRcuRetired, freed once the readers of both parities drained
+  SCtgRcuSlot   slots[CTG_RCU_SLOT_NUM];
+} SCtgRcu;
+
 typedef struct SCatalogMgmt {
   bool         exit;
   int32_t      jobPool;
@@ -473,6 +524,7 @@ typedef struct SCatalogMgmt {
   SHashObj*    pCluster;  // key: clusterId, value: SCatalog*
   SCatalogStat stat;
   SCatalogCfg  cfg;
+  SCtgRcu      rcu;
 } SCatalogMgmt;
 
 typedef uint32_t (*tableNameHashFp)(const char*, uint32_t);
@@ -683,7 +735,7 @@ int32_t ctgOpDropStbMeta(SCtgCacheOperation* action);
 int32_t ctgOpDropTbMeta(SCtgCacheOperation* action);
 int32_t ctgOpUpdateUser(SCtgCacheOperation* action);
 int32_t ctgOpUpdateEpset(SCtgCacheOperation* operation);
-int32_t ctgAcquireVgInfoFromCache(SCatalog* pCtg, const char* dbFName, SCtgDBCache** pCache);
+int32_t ctgAcquireVgInfoFromCache(SCatalog* pCtg, const char* dbFName, SCtgDBCache** pCache, SDBVgInfo** pVgInfo);
 void    ctgReleaseDBCache(SCatalog* pCtg, SCtgDBCache* dbCache);
 void    ctgRUnlockVgInfo(SCtgDBCache* dbCache);
 int32_t ctgTbMetaExistInCache(SCatalog* pCtg, char* dbFName, char* tbName, int32_t* exist);
@@ -702,6 +754,8 @@ int32_t ctgUpdateUserEnqueue(SCatalog* pCtg, SGetUserAuthRsp* pAuth, bool syncRe
 int32_t ctgUpdateVgEpsetEnqueue(SCatalog* pCtg, char* dbFName, int32_t vgId, SEpSet* pEpSet);
 int32_t ctgUpdateTbIndexEnqueue(SCatalog* pCtg, STableIndex** pIndex, bool syncOp);
 int32_t ctgClearCacheEnqueue(SCatalog* pCtg, bool freeCtg, bool stopQueue, bool syncOp);
+int32_t ctgUpdateCtbMetasEnqueue(SCatalog* pCtg, const char* dbFName, uint64_t dbId, uint64_t suid, int32_t vgId,
+                                 SArray* pCtbs, bool syncOp);
 int32_t ctgMetaRentInit(SCtgRentMgmt* mgmt, uint32_t rentSec, int8_t type);
 int32_t ctgMetaRentAdd(SCtgRentMgmt* mgmt, void* meta, int64_t id, int32_t size);
 int32_t ctgMetaRentGet(SCtgRentMgmt* mgmt, void** res, uint32_t* num, int32_t size);
@@ -714,6 +768,15 @@ int32_t ctgDropTbIndexEnqueue(SCatalog* pCtg, SName* pName, bool syncOp);
 int32_t ctgOpDropTbIndex(SCtgCacheOperation* operation);
 int32_t ctgOpUpdateTbIndex(SCtgCacheOperation* operation);
 int32_t ctgOpClearCache(SCtgCacheOperation* operation);
+int32_t ctgOpUpdateCtbMetas(SCtgCacheOperation* operation);
+int32_t ctgRcuInit();
+void    ctgRcuCleanup();
+void    ctgRcuReadLock();
+void    ctgRcuReadUnlock();
+void    ctgRcuRetire(void* p, FCtgRcuFree freeFp);
+bool    ctgRcuReclaim();
+void    ctgRcuSwapTbMeta(SCtgTbCache* pCache, STableMeta* pMeta);
+void    ctgRcuSwapVgInfo(SCtgDBCache* dbCache, SDBVgInfo* vgInfo);
 int32_t ctgReadTbTypeFromCache(SCatalog* pCtg, char* dbFName, char* tableName, int32_t* tbType);
 int32_t ctgGetTbHashVgroupFromCache(SCatalog* pCtg, const SName* pTableName, SVgroupInfo** pVgroup);
 
@@ -741,6 +804,8 @@ int32_t ctgGetTableCfgFromVnode(SCatalog* pCtg, SRequestConnInfo* pConn, const S
                                 SVgroupInfo* vgroupInfo, STableCfg** out, SCtgTask* pTask);
 int32_t ctgGetTableCfgFromMnode(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, STableCfg** out,
                                 SCtgTask* pTask);
+int32_t ctgGetCtbMetasFromVnode(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pStbName, SVgroupInfo* vgroupInfo,
+                                int64_t lastUid, SVTablesMetaRsp* out);
 int32_t ctgGetSvrVerFromMnode(SCatalog* pCtg, SRequestConnInfo* pConn, char** out, SCtgTask* pTask);
 int32_t ctgLaunchBatchs(SCatalog* pCtg, SCtgJob* pJob, SHashObj* pBatchs);
 
@@ -22,11 +22,12 @@
 
 SCatalogMgmt gCtgMgmt = {0};
 
+// With *dbCache set, *pInfo is the cached vgInfo valid until the cache is released, otherwise the caller owns it
 int32_t ctgGetDBVgInfo(SCatalog* pCtg, SRequestConnInfo* pConn, const char* dbFName, SCtgDBCache** dbCache,
                        SDBVgInfo** pInfo, bool* exists) {
   int32_t code = 0;
 
-  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, dbCache));
+  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, dbCache, pInfo));
 
   if (*dbCache) {
     if (exists) {
@@ -66,8 +67,9 @@ _return:
 int32_t ctgRefreshDBVgInfo(SCatalog* pCtg, SRequestConnInfo* pConn, const char* dbFName) {
   int32_t      code = 0;
   SCtgDBCache* dbCache = NULL;
+  SDBVgInfo*   vgInfo = NULL;
 
-  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache));
+  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache, &vgInfo));
 
   SUseDbOutput     DbOut = {0};
   SBuildUseDBInput input = {0};
@@ -459,11 +461,7 @@ int32_t ctgGetTbDistVgInfo(SCatalog* pCtg, SRequestConnInfo* pConn, SName* pTabl
   SHashObj* vgHash = NULL;
   CTG_ERR_JRET(ctgGetDBVgInfo(pCtg, pConn, db, &dbCache, &vgInfo, NULL));
 
-  if (dbCache) {
-    vgHash = dbCache->vgCache.vgInfo->vgHash;
-  } else {
-    vgHash = vgInfo->vgHash;
-  }
+  vgHash = vgInfo->vgHash;
 
   if (tbMeta->tableType == TSDB_SUPER_TABLE) {
     CTG_ERR_JRET(ctgGenerateVgList(pCtg, vgHash, pVgList));
@@ -504,7 +502,7 @@ _return:
 
   taosMemoryFreeClear(tbMeta);
 
-  if (vgInfo) {
+  if (NULL == dbCache && vgInfo) {
     taosHashCleanup(vgInfo->vgHash);
     taosMemoryFreeClear(vgInfo);
   }
@@ -536,7 +534,7 @@ int32_t ctgGetTbHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName*
     return TSDB_CODE_SUCCESS;
   }
   
-  CTG_ERR_JRET(ctgGetVgInfoFromHashValue(pCtg, vgInfo ? vgInfo : dbCache->vgCache.vgInfo, pTableName, pVgroup));
+  CTG_ERR_JRET(ctgGetVgInfoFromHashValue(pCtg, vgInfo, pTableName, pVgroup));
 
 _return:
 
@@ -545,7 +543,7 @@ _return:
     ctgReleaseDBCache(pCtg, dbCache);
   }
 
-  if (vgInfo) {
+  if (NULL == dbCache && vgInfo) {
     taosHashCleanup(vgInfo->vgHash);
     taosMemoryFreeClear(vgInfo);
   }
@@ -629,6 +627,8 @@ int32_t catalogInit(SCatalogCfg* cfg) {
     CTG_ERR_RET(terrno);
   }
 
+  CTG_ERR_RET(ctgRcuInit());
+
   CTG_ERR_RET(ctgStartUpdateThread());
 
   qDebug("catalog initialized, maxDb:%u, maxTbl:%u, dbRentSec:%u, stbRentSec:%u", gCtgMgmt.cfg.maxDBCacheNum,
@@ -723,17 +723,18 @@ int32_t catalogGetDBVgVersion(SCatalog* pCtg, const char* dbFName, int32_t* vers
   }
 
   SCtgDBCache* dbCache = NULL;
+  SDBVgInfo*   vgInfo = NULL;
   int32_t      code = 0;
 
-  CTG_ERR_JRET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache));
+  CTG_ERR_JRET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache, &vgInfo));
   if (NULL == dbCache) {
     *version = CTG_DEFAULT_INVALID_VERSION;
     CTG_API_LEAVE(TSDB_CODE_SUCCESS);
   }
 
-  *version = dbCache->vgCache.vgInfo->vgVersion;
+  *version = vgInfo->vgVersion;
   *dbId = dbCache->dbId;
-  *tableNum = dbCache->vgCache.vgInfo->numOfTable;
+  *tableNum = vgInfo->numOfTable;
 
   ctgReleaseVgInfoToCache(pCtg, dbCache);
 
@@ -759,11 +760,7 @@ int32_t catalogGetDBVgList(SCatalog* pCtg, SRequestConnInfo* pConn, const char*
   SHashObj*    vgHash = NULL;
   SDBVgInfo*   vgInfo = NULL;
   CTG_ERR_JRET(ctgGetDBVgInfo(pCtg, pConn, dbFName, &dbCache, &vgInfo, NULL));
-  if (dbCache) {
-    vgHash = dbCache->vgCache.vgInfo->vgHash;
-  } else {
-    vgHash = vgInfo->vgHash;
-  }
+  vgHash = vgInfo->vgHash;
 
   CTG_ERR_JRET(ctgGenerateVgList(pCtg, vgHash, &vgList));
 
@@ -777,7 +774,7 @@ _return:
     ctgReleaseDBCache(pCtg, dbCache);
   }
 
-  if (vgInfo) {
+  if (NULL == dbCache && vgInfo) {
     taosHashCleanup(vgInfo->vgHash);
     taosMemoryFreeClear(vgInfo);
   }
@@ -796,9 +793,6 @@ int32_t catalogGetDBVgInfo(SCatalog* pCtg, SRequestConnInfo* pConn, const char*
   int32_t      code = 0;
   SDBVgInfo*   dbInfo = NULL;
   CTG_ERR_JRET(ctgGetDBVgInfo(pCtg, pConn, dbFName, &dbCache, &dbInfo, NULL));
-  if (dbCache) {
-    dbInfo = dbCache->vgCache.vgInfo;
-  }
 
   pInfo->routeVersion = dbInfo->vgVersion;
   pInfo->hashPrefix = dbInfo->hashPrefix;
@@ -1067,6 +1061,155 @@ int32_t catalogRefreshDBVgInfo(SCatalog* pCtg, SRequestConnInfo* pConn, const ch
   CTG_API_LEAVE(ctgRefreshDBVgInfo(pCtg, pConn, dbFName));
 }
 
+static int32_t ctgPrefetchVgCtbMeta(SCtgCtbPrefetch* pFetch, SVgroupInfo* pVg) {
+  SCatalog*   pCtg = pFetch->pCtg;
+  STableMeta* pStb = pFetch->pStb;
+  int32_t     code = 0;
+  int64_t     lastUid = 0;
+
+  while (true) {
+    SVTablesMetaRsp rsp = {0};
+    CTG_ERR_RET(ctgGetCtbMetasFromVnode(pCtg, pFetch->pConn, pFetch->pStbName, pVg, lastUid, &rsp));
+
+    if ((rsp.suid != pStb->uid || rsp.sversion > pStb->sversion || rsp.tversion > pStb->tversion) &&
+        0 == atomic_val_compare_exchange_8(&pFetch->stbRefreshed, 0, 1)) {
+      ctgDebug("stb %s.%s changed in vgId:%d, suid:0x%" PRIx64 ", sver:%d, tver:%d, refresh its meta", pFetch->dbFName,
+               pFetch->pStbName->tname, rsp.vgId, rsp.suid, rsp.sversion, rsp.tversion);
+      SCtgTbMetaCtx rctx = {0};
+      rctx.pName = (SName*)pFetch->pStbName;
+      rctx.flag = CTG_FLAG_FORCE_UPDATE | CTG_FLAG_STB;
+      code = ctgRefreshTbMeta(pCtg, pFetch->pConn, &rctx, NULL, false);
+      if (code) {
+        tFreeSVTablesMetaRsp(&rsp);
+        CTG_ERR_RET(code);
+      }
+    }
+
+    int32_t num = taosArrayGetSize(rsp.pCtbs);
+    bool    hasMore = rsp.hasMore && num > 0;
+    if (num > 0) {
+      lastUid = ((SVCtbMeta*)taosArrayGetLast(rsp.pCtbs))->uid;
+      atomic_add_fetch_64(&pFetch->ctbNum, num);
+      code = ctgUpdateCtbMetasEnqueue(pCtg, pFetch->dbFName, rsp.dbId, rsp.suid, rsp.vgId, rsp.pCtbs, false);
+      rsp.pCtbs = NULL;
+      CTG_ERR_RET(code);
+    }
+
+    tFreeSVTablesMetaRsp(&rsp);
+    if (!hasMore) {
+      break;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void* ctgPrefetchCtbMetaThreadFp(void* param) {
+  SCtgCtbPrefetch* pFetch = (SCtgCtbPrefetch*)param;
+  int32_t          vgNum = taosArrayGetSize(pFetch->vgList);
+
+  while (TSDB_CODE_SUCCESS == atomic_load_32(&pFetch->code)) {
+    int32_t i = atomic_fetch_add_32(&pFetch->vgIdx, 1);
+    if (i >= vgNum) {
+      break;
+    }
+
+    int32_t code = ctgPrefetchVgCtbMeta(pFetch, taosArrayGet(pFetch->vgList, i));
+    if (code) {
+      atomic_val_compare_exchange_32(&pFetch->code, TSDB_CODE_SUCCESS, code);
+    }
+  }
+
+  return NULL;
+}
+
+int32_t ctgPrefetchCtbMeta(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pStbName) {
+  int32_t         code = 0;
+  SCtgDBCache*    dbCache = NULL;
+  SDBVgInfo*      vgInfo = NULL;
+  TdThread*       threads = NULL;
+  int32_t         threadNum = 0;
+  SCtgCtbPrefetch fetch = {.pCtg = pCtg, .pConn = pConn, .pStbName = pStbName};
+  tNameGetFullDbName(pStbName, fetch.dbFName);
+
+  SCtgTbMetaCtx ctx = {0};
+  ctx.pName = (SName*)pStbName;
+  ctx.flag = CTG_FLAG_STB;
+  CTG_ERR_JRET(ctgGetTbMeta(pCtg, pConn, &ctx, &fetch.pStb));
+  if (TSDB_SUPER_TABLE != fetch.pStb->tableType) {
+    ctgError("table %s.%s is not a super table, type:%d", fetch.dbFName, pStbName->tname, fetch.pStb->tableType);
+    CTG_ERR_JRET(TSDB_CODE_CTG_INVALID_INPUT);
+  }
+
+  CTG_ERR_JRET(ctgGetDBVgInfo(pCtg, pConn, fetch.dbFName, &dbCache, &vgInfo, NULL));
+  CTG_ERR_JRET(ctgGenerateVgList(pCtg, vgInfo->vgHash, &fetch.vgList));
+
+  // no cache reference is kept across the vnode requests
+  if (dbCache) {
+    ctgRUnlockVgInfo(dbCache);
+    ctgReleaseDBCache(pCtg, dbCache);
+    dbCache = NULL;
+    vgInfo = NULL;
+  }
+
+  // the calling thread pages vgroups too, the requests are synchronous so each thread has one in flight
+  int32_t vgNum = taosArrayGetSize(fetch.vgList);
+  if (vgNum > 1) {
+    threads = taosMemoryCalloc(TMIN(vgNum, CTG_DEFAULT_PREFETCH_VG_NUM) - 1, sizeof(TdThread));
+  }
+
+  if (threads) {
+    TdThreadAttr thAttr;
+    taosThreadAttrInit(&thAttr);
+    taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+    for (; threadNum < TMIN(vgNum, CTG_DEFAULT_PREFETCH_VG_NUM) - 1; ++threadNum) {
+      if (taosThreadCreate(&threads[threadNum], &thAttr, ctgPrefetchCtbMetaThreadFp, &fetch) != 0) {
+        ctgError("create ctb meta prefetch thread failed, error:%s, started:%d", strerror(errno), threadNum);
+        break;
+      }
+    }
+    taosThreadAttrDestroy(&thAttr);
+  }
+
+  ctgPrefetchCtbMetaThreadFp(&fetch);
+  for (int32_t i = 0; i < threadNum; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+
+  CTG_ERR_JRET(fetch.code);
+
+  ctgDebug("%" PRId64 " ctb metas of stb %s.%s prefetched from %d vgroups by %d threads", fetch.ctbNum, fetch.dbFName,
+           pStbName->tname, vgNum, threadNum + 1);
+
+_return:
+
+  if (dbCache) {
+    ctgRUnlockVgInfo(dbCache);
+    ctgReleaseDBCache(pCtg, dbCache);
+  }
+
+  if (NULL == dbCache && vgInfo) {
+    taosHashCleanup(vgInfo->vgHash);
+    taosMemoryFreeClear(vgInfo);
+  }
+
+  taosMemoryFree(threads);
+  taosArrayDestroy(fetch.vgList);
+  taosMemoryFree(fetch.pStb);
+
+  CTG_RET(code);
+}
+
+int32_t catalogPrefetchChildTableMeta(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pStbName) {
+  CTG_API_ENTER();
+
+  if (NULL == pCtg || NULL == pConn || NULL == pStbName) {
+    CTG_API_LEAVE(TSDB_CODE_CTG_INVALID_INPUT);
+  }
+
+  CTG_API_LEAVE(ctgPrefetchCtbMeta(pCtg, pConn, pStbName));
+}
+
 int32_t catalogRefreshTableMeta(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, int32_t isSTable) {
   CTG_API_ENTER();
 
@@ -1457,6 +1600,7 @@ void catalogDestroy(void) {
   if (!taosCheckCurrentInDll()) {
     ctgClearCacheEnqueue(NULL, true, true, true);
     taosThreadJoin(gCtgMgmt.updateThread, NULL);
+    ctgRcuCleanup();
   }
 
   taosHashCleanup(gCtgMgmt.pCluster);
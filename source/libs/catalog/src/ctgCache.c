@@ -29,29 +29,179 @@ SCtgOperation gCtgCacheOperation[CTG_OP_MAX] = {{CTG_OP_UPDATE_VGROUP, "update v
                                                 {CTG_OP_UPDATE_VG_EPSET, "update epset", ctgOpUpdateEpset},
                                                 {CTG_OP_UPDATE_TB_INDEX, "update tbIndex", ctgOpUpdateTbIndex},
                                                 {CTG_OP_DROP_TB_INDEX, "drop tbIndex", ctgOpDropTbIndex},
-                                                {CTG_OP_CLEAR_CACHE, "clear cache", ctgOpClearCache}};
+                                                {CTG_OP_CLEAR_CACHE, "clear cache", ctgOpClearCache},
+                                                {CTG_OP_UPDATE_CTB_METAS, "update ctbMetas", ctgOpUpdateCtbMetas}};
+
+// Readers of vgInfo and tbMeta only count themselves in the slot of their thread for the current epoch parity.
+// Writers publish a new object and retire the old one, which is freed after the epoch moved twice and the readers
+// of both parities drained, so no reader still holds it.
+static threadlocal int32_t ctgRcuSlot = -1;
+static threadlocal int32_t ctgRcuDepth = 0;
+static threadlocal int32_t ctgRcuParity = 0;
+
+int32_t ctgRcuInit() {
+  SCtgRcu *pRcu = &gCtgMgmt.rcu;
+  pRcu->epoch = 0;
+  pRcu->phase = 0;
+  pRcu->retired = taosArrayInit(64, sizeof(SCtgRcuRetired));
+  pRcu->waiting = taosArrayInit(64, sizeof(SCtgRcuRetired));
+  if (NULL == pRcu->retired || NULL == pRcu->waiting) {
+    qError("taosArrayInit failed");
+    taosArrayDestroy(pRcu->retired);
+    taosArrayDestroy(pRcu->waiting);
+    pRcu->retired = pRcu->waiting = NULL;
+    CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  taosThreadMutexInit(&pRcu->lock, NULL);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void ctgRcuFreeList(SArray *pList) {
+  int32_t num = taosArrayGetSize(pList);
+  for (int32_t i = 0; i < num; ++i) {
+    SCtgRcuRetired *pItem = taosArrayGet(pList, i);
+    (*pItem->freeFp)(pItem->p);
+  }
+  taosArrayClear(pList);
+}
+
+// no reader may be left, called after the update thread exited
+void ctgRcuCleanup() {
+  SCtgRcu *pRcu = &gCtgMgmt.rcu;
+  if (NULL == pRcu->retired) {
+    return;
+  }
+
+  ctgRcuFreeList(pRcu->waiting);
+  ctgRcuFreeList(pRcu->retired);
+  taosArrayDestroy(pRcu->retired);
+  taosArrayDestroy(pRcu->waiting);
+  pRcu->retired = pRcu->waiting = NULL;
+  taosThreadMutexDestroy(&pRcu->lock);
+}
+
+void ctgRcuReadLock() {
+  if (ctgRcuDepth++ > 0) {
+    return;
+  }
+
+  if (ctgRcuSlot < 0) {
+    ctgRcuSlot = (int32_t)((uint32_t)atomic_fetch_add_32(&gCtgMgmt.rcu.slotId, 1) % CTG_RCU_SLOT_NUM);
+  }
+
+  ctgRcuParity = (int32_t)(atomic_load_64(&gCtgMgmt.rcu.epoch) & 1);
+  atomic_add_fetch_64(&gCtgMgmt.rcu.slots[ctgRcuSlot].readers[ctgRcuParity], 1);
+}
+
+void ctgRcuReadUnlock() {
+  if (--ctgRcuDepth > 0) {
+    return;
+  }
+
+  atomic_sub_fetch_64(&gCtgMgmt.rcu.slots[ctgRcuSlot].readers[ctgRcuParity], 1);
+}
+
+// p must already be unreachable from the cache
+void ctgRcuRetire(void *p, FCtgRcuFree freeFp) {
+  if (NULL == p) {
+    return;
+  }
+
+  SCtgRcu       *pRcu = &gCtgMgmt.rcu;
+  SCtgRcuRetired item = {.p = p, .freeFp = freeFp};
+
+  // no reader left once the catalog is destroyed
+  if (NULL == pRcu->retired) {
+    (*freeFp)(p);
+    return;
+  }
+
+  taosThreadMutexLock(&pRcu->lock);
+  if (NULL == taosArrayPush(pRcu->retired, &item)) {
+    qError("retire %p failed, leaked", p);
+  }
+  taosThreadMutexUnlock(&pRcu->lock);
+}
+
+static bool ctgRcuDrained(int32_t parity) {
+  for (int32_t i = 0; i < CTG_RCU_SLOT_NUM; ++i) {
+    if (atomic_load_64(&gCtgMgmt.rcu.slots[i].readers[parity]) > 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Called by the update thread after each operation, never waits for the readers. Returns whether objects are
+// still waiting to be freed.
+bool ctgRcuReclaim() {
+  bool pending = false;
+  SCtgRcu *pRcu = &gCtgMgmt.rcu;
+
+  taosThreadMutexLock(&pRcu->lock);
+
+  if (0 == pRcu->phase && taosArrayGetSize(pRcu->retired) > 0) {
+    TSWAP(pRcu->retired, pRcu->waiting);
+    atomic_add_fetch_64(&pRcu->epoch, 1);
+    pRcu->phase = 1;
+  }
+
+  if (1 == pRcu->phase && ctgRcuDrained((int32_t)((atomic_load_64(&pRcu->epoch) - 1) & 1))) {
+    atomic_add_fetch_64(&pRcu->epoch, 1);
+    pRcu->phase = 2;
+  }
+
+  if (2 == pRcu->phase && ctgRcuDrained((int32_t)((atomic_load_64(&pRcu->epoch) - 1) & 1))) {
+    ctgRcuFreeList(pRcu->waiting);
+    pRcu->phase = 0;
+  }
+
+  pending = (0 != pRcu->phase || taosArrayGetSize(pRcu->retired) > 0);
+
+  taosThreadMutexUnlock(&pRcu->lock);
+
+  return pending;
+}
+
+static void ctgRcuFreeTbMeta(void *p) { taosMemoryFree(p); }
 
-int32_t ctgRLockVgInfo(SCatalog *pCtg, SCtgDBCache *dbCache, bool *inCache) {
-  CTG_LOCK(CTG_READ, &dbCache->vgCache.vgLock);
+static void ctgRcuFreeVgInfo(void *p) { ctgFreeVgInfo((SDBVgInfo *)p); }
+
+// publish a new meta of the table, the one replaced is retired
+void ctgRcuSwapTbMeta(SCtgTbCache *pCache, STableMeta *pMeta) {
+  STableMeta *orig = atomic_exchange_ptr(&pCache->pMeta, pMeta);
+  ctgRcuRetire(orig, ctgRcuFreeTbMeta);
+}
+
+void ctgRcuSwapVgInfo(SCtgDBCache *dbCache, SDBVgInfo *vgInfo) {
+  SDBVgInfo *orig = atomic_exchange_ptr(&dbCache->vgCache.vgInfo, vgInfo);
+  ctgRcuRetire(orig, ctgRcuFreeVgInfo);
+}
+
+// *pVgInfo is the snapshot of vgInfo the caller must use until ctgRUnlockVgInfo, writers may swap the cached one
+int32_t ctgRLockVgInfo(SCatalog *pCtg, SCtgDBCache *dbCache, SDBVgInfo **pVgInfo) {
+  *pVgInfo = NULL;
+
+  ctgRcuReadLock();
 
   if (dbCache->deleted) {
-    CTG_UNLOCK(CTG_READ, &dbCache->vgCache.vgLock);
+    ctgRcuReadUnlock();
 
     ctgDebug("db is dropping, dbId:0x%" PRIx64, dbCache->dbId);
-
-    *inCache = false;
     return TSDB_CODE_SUCCESS;
   }
 
-  if (NULL == dbCache->vgCache.vgInfo) {
-    CTG_UNLOCK(CTG_READ, &dbCache->vgCache.vgLock);
+  SDBVgInfo *vgInfo = atomic_load_ptr(&dbCache->vgCache.vgInfo);
+  if (NULL == vgInfo) {
+    ctgRcuReadUnlock();
 
-    *inCache = false;
     ctgDebug("db vgInfo is empty, dbId:0x%" PRIx64, dbCache->dbId);
     return TSDB_CODE_SUCCESS;
   }
 
-  *inCache = true;
+  *pVgInfo = vgInfo;
 
   return TSDB_CODE_SUCCESS;
 }
@@ -68,7 +218,7 @@ int32_t ctgWLockVgInfo(SCatalog *pCtg, SCtgDBCache *dbCache) {
   return TSDB_CODE_SUCCESS;
 }
 
-void ctgRUnlockVgInfo(SCtgDBCache *dbCache) { CTG_UNLOCK(CTG_READ, &dbCache->vgCache.vgLock); }
+void ctgRUnlockVgInfo(SCtgDBCache *dbCache) { ctgRcuReadUnlock(); }
 
 void ctgWUnlockVgInfo(SCtgDBCache *dbCache) { CTG_UNLOCK(CTG_WRITE, &dbCache->vgCache.vgLock); }
 
@@ -131,7 +281,7 @@ void ctgReleaseVgInfoToCache(SCatalog *pCtg, SCtgDBCache *dbCache) {
 
 void ctgReleaseTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, SCtgTbCache *pCache) {
   if (pCache) {
-    CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+    ctgRcuReadUnlock();
     taosHashRelease(dbCache->tbCache, pCache);
   }
 
@@ -151,17 +301,17 @@ void ctgReleaseTbIndexToCache(SCatalog *pCtg, SCtgDBCache *dbCache, SCtgTbCache
   }
 }
 
-int32_t ctgAcquireVgInfoFromCache(SCatalog *pCtg, const char *dbFName, SCtgDBCache **pCache) {
+int32_t ctgAcquireVgInfoFromCache(SCatalog *pCtg, const char *dbFName, SCtgDBCache **pCache, SDBVgInfo **pVgInfo) {
   SCtgDBCache *dbCache = NULL;
+  *pVgInfo = NULL;
   ctgAcquireDBCache(pCtg, dbFName, &dbCache);
   if (NULL == dbCache) {
     ctgDebug("db %s not in cache", dbFName);
     goto _return;
   }
 
-  bool inCache = false;
-  ctgRLockVgInfo(pCtg, dbCache, &inCache);
-  if (!inCache) {
+  ctgRLockVgInfo(pCtg, dbCache, pVgInfo);
+  if (NULL == *pVgInfo) {
     ctgDebug("vgInfo of db %s not in cache", dbFName);
     goto _return;
   }
@@ -187,9 +337,12 @@ _return:
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t ctgAcquireTbMetaFromCache(SCatalog *pCtg, char *dbFName, char *tbName, SCtgDBCache **pDb, SCtgTbCache **pTb) {
+// *pMeta is the snapshot of the table meta the caller must use until ctgReleaseTbMetaToCache
+int32_t ctgAcquireTbMetaFromCache(SCatalog *pCtg, char *dbFName, char *tbName, SCtgDBCache **pDb, SCtgTbCache **pTb,
+                                  STableMeta **pMeta) {
   SCtgDBCache *dbCache = NULL;
   SCtgTbCache *pCache = NULL;
+  *pMeta = NULL;
   ctgAcquireDBCache(pCtg, dbFName, &dbCache);
   if (NULL == dbCache) {
     ctgDebug("db %s not in cache", dbFName);
@@ -202,8 +355,9 @@ int32_t ctgAcquireTbMetaFromCache(SCatalog *pCtg, char *dbFName, char *tbName, S
     goto _return;
   }
 
-  CTG_LOCK(CTG_READ, &pCache->metaLock);
-  if (NULL == pCache->pMeta) {
+  ctgRcuReadLock();
+  *pMeta = atomic_load_ptr(&pCache->pMeta);
+  if (NULL == *pMeta) {
     ctgDebug("tb %s meta not in cache, dbFName:%s", tbName, dbFName);
     goto _return;
   }
@@ -226,9 +380,11 @@ _return:
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t ctgAcquireStbMetaFromCache(SCatalog *pCtg, char *dbFName, uint64_t suid, SCtgDBCache **pDb, SCtgTbCache **pTb) {
+int32_t ctgAcquireStbMetaFromCache(SCatalog *pCtg, char *dbFName, uint64_t suid, SCtgDBCache **pDb, SCtgTbCache **pTb,
+                                   STableMeta **pMeta) {
   SCtgDBCache *dbCache = NULL;
   SCtgTbCache *pCache = NULL;
+  *pMeta = NULL;
   ctgAcquireDBCache(pCtg, dbFName, &dbCache);
   if (NULL == dbCache) {
     ctgDebug("db %s not in cache", dbFName);
@@ -248,8 +404,9 @@ int32_t ctgAcquireStbMetaFromCache(SCatalog *pCtg, char *dbFName, uint64_t suid,
     goto _return;
   }
 
-  CTG_LOCK(CTG_READ, &pCache->metaLock);
-  if (NULL == pCache->pMeta) {
+  ctgRcuReadLock();
+  *pMeta = atomic_load_ptr(&pCache->pMeta);
+  if (NULL == *pMeta) {
     ctgDebug("stb 0x%" PRIx64 " meta not in cache, dbFName:%s", suid, dbFName);
     goto _return;
   }
@@ -318,7 +475,8 @@ _return:
 int32_t ctgTbMetaExistInCache(SCatalog *pCtg, char *dbFName, char *tbName, int32_t *exist) {
   SCtgDBCache *dbCache = NULL;
   SCtgTbCache *tbCache = NULL;
-  ctgAcquireTbMetaFromCache(pCtg, dbFName, tbName, &dbCache, &tbCache);
+  STableMeta  *tbMeta = NULL;
+  ctgAcquireTbMetaFromCache(pCtg, dbFName, tbName, &dbCache, &tbCache, &tbMeta);
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
 
@@ -345,13 +503,13 @@ int32_t ctgReadTbMetaFromCache(SCatalog *pCtg, SCtgTbMetaCtx *ctx, STableMeta **
     tNameGetFullDbName(ctx->pName, dbFName);
   }
 
-  ctgAcquireTbMetaFromCache(pCtg, dbFName, ctx->pName->tname, &dbCache, &tbCache);
+  STableMeta *tbMeta = NULL;
+  ctgAcquireTbMetaFromCache(pCtg, dbFName, ctx->pName->tname, &dbCache, &tbCache, &tbMeta);
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     return TSDB_CODE_SUCCESS;
   }
 
-  STableMeta *tbMeta = tbCache->pMeta;
   ctx->tbInfo.inCache = true;
   ctx->tbInfo.dbId = dbCache->dbId;
   ctx->tbInfo.suid = tbMeta->suid;
@@ -368,7 +526,7 @@ int32_t ctgReadTbMetaFromCache(SCatalog *pCtg, SCtgTbMetaCtx *ctx, STableMeta **
     memcpy(*pTableMeta, tbMeta, metaSize);
 
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
-    ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", ctx->pName->tname, tbMeta->tableType, dbFName);
+    ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", ctx->pName->tname, ctx->tbInfo.tbType, dbFName);
     return TSDB_CODE_SUCCESS;
   }
 
@@ -386,7 +544,8 @@ int32_t ctgReadTbMetaFromCache(SCatalog *pCtg, SCtgTbMetaCtx *ctx, STableMeta **
   ctgDebug("Got ctb %s meta from cache, will continue to get its stb meta, type:%d, dbFName:%s", ctx->pName->tname,
            ctx->tbInfo.tbType, dbFName);
 
-  ctgAcquireStbMetaFromCache(pCtg, dbFName, ctx->tbInfo.suid, &dbCache, &tbCache);
+  STableMeta *stbMeta = NULL;
+  ctgAcquireStbMetaFromCache(pCtg, dbFName, ctx->tbInfo.suid, &dbCache, &tbCache, &stbMeta);
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     taosMemoryFreeClear(*pTableMeta);
@@ -394,7 +553,6 @@ int32_t ctgReadTbMetaFromCache(SCatalog *pCtg, SCtgTbMetaCtx *ctx, STableMeta **
     return TSDB_CODE_SUCCESS;
   }
 
-  STableMeta *stbMeta = tbCache->pMeta;
   if (stbMeta->suid != ctx->tbInfo.suid) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     ctgError("stb suid 0x%" PRIx64 " in stbCache mis-match, expected suid 0x%" PRIx64, stbMeta->suid, ctx->tbInfo.suid);
@@ -434,13 +592,13 @@ int32_t ctgReadTbVerFromCache(SCatalog *pCtg, SName *pTableName, int32_t *sver,
   char         dbFName[TSDB_DB_FNAME_LEN] = {0};
   tNameGetFullDbName(pTableName, dbFName);
 
-  ctgAcquireTbMetaFromCache(pCtg, dbFName, pTableName->tname, &dbCache, &tbCache);
+  STableMeta *tbMeta = NULL;
+  ctgAcquireTbMetaFromCache(pCtg, dbFName, pTableName->tname, &dbCache, &tbCache, &tbMeta);
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     return TSDB_CODE_SUCCESS;
   }
 
-  STableMeta *tbMeta = tbCache->pMeta;
   *tbType = tbMeta->tableType;
   *suid = tbMeta->suid;
 
@@ -460,14 +618,14 @@ int32_t ctgReadTbVerFromCache(SCatalog *pCtg, SName *pTableName, int32_t *sver,
   ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
   ctgDebug("Got ctb %s ver from cache, will continue to get its stb ver, dbFName:%s", pTableName->tname, dbFName);
 
-  ctgAcquireStbMetaFromCache(pCtg, dbFName, *suid, &dbCache, &tbCache);
+  STableMeta *stbMeta = NULL;
+  ctgAcquireStbMetaFromCache(pCtg, dbFName, *suid, &dbCache, &tbCache, &stbMeta);
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     ctgDebug("stb 0x%" PRIx64 " meta not in cache", *suid);
     return TSDB_CODE_SUCCESS;
   }
 
-  STableMeta *stbMeta = tbCache->pMeta;
   if (stbMeta->suid != *suid) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     ctgError("stb suid 0x%" PRIx64 " in stbCache mis-match, expected suid:0x%" PRIx64, stbMeta->suid, *suid);
@@ -494,13 +652,14 @@ int32_t ctgReadTbVerFromCache(SCatalog *pCtg, SName *pTableName, int32_t *sver,
 int32_t ctgReadTbTypeFromCache(SCatalog *pCtg, char *dbFName, char *tbName, int32_t *tbType) {
   SCtgDBCache *dbCache = NULL;
   SCtgTbCache *tbCache = NULL;
-  CTG_ERR_RET(ctgAcquireTbMetaFromCache(pCtg, dbFName, tbName, &dbCache, &tbCache));
+  STableMeta  *tbMeta = NULL;
+  CTG_ERR_RET(ctgAcquireTbMetaFromCache(pCtg, dbFName, tbName, &dbCache, &tbCache, &tbMeta));
   if (NULL == tbCache) {
     ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
     return TSDB_CODE_SUCCESS;
   }
 
-  *tbType = tbCache->pMeta->tableType;
+  *tbType = tbMeta->tableType;
   ctgReleaseTbMetaToCache(pCtg, dbCache, tbCache);
 
   ctgDebug("Got tb %s tbType %d from cache, dbFName:%s", tbName, *tbType, dbFName);
@@ -998,6 +1157,39 @@ _return:
   CTG_RET(code);
 }
 
+int32_t ctgUpdateCtbMetasEnqueue(SCatalog *pCtg, const char *dbFName, uint64_t dbId, uint64_t suid, int32_t vgId,
+                                 SArray *pCtbs, bool syncOp) {
+  int32_t             code = 0;
+  SCtgCacheOperation *op = taosMemoryCalloc(1, sizeof(SCtgCacheOperation));
+  op->opId = CTG_OP_UPDATE_CTB_METAS;
+  op->syncOp = syncOp;
+
+  SCtgUpdateCtbMetasMsg *msg = taosMemoryMalloc(sizeof(SCtgUpdateCtbMetasMsg));
+  if (NULL == msg) {
+    ctgError("malloc %d failed", (int32_t)sizeof(SCtgUpdateCtbMetasMsg));
+    taosMemoryFree(op);
+    taosArrayDestroy(pCtbs);
+    CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  msg->pCtg = pCtg;
+  tstrncpy(msg->dbFName, dbFName, sizeof(msg->dbFName));
+  msg->dbId = dbId;
+  msg->suid = suid;
+  msg->vgId = vgId;
+  msg->pCtbs = pCtbs;
+
+  op->data = msg;
+
+  CTG_ERR_JRET(ctgEnqueue(pCtg, op));
+
+  return TSDB_CODE_SUCCESS;
+
+_return:
+
+  CTG_RET(code);
+}
+
 int32_t ctgMetaRentInit(SCtgRentMgmt *mgmt, uint32_t rentSec, int8_t type) {
   mgmt->slotRIdx = 0;
   mgmt->slotNum = rentSec / CTG_RENT_SLOT_SECOND;
@@ -1403,8 +1595,7 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
     pCache = taosHashGet(dbCache->tbCache, tbName, strlen(tbName));
   } else {
     CTG_LOCK(CTG_WRITE, &pCache->metaLock);
-    taosMemoryFree(pCache->pMeta);
-    pCache->pMeta = meta;
+    ctgRcuSwapTbMeta(pCache, meta);
     CTG_UNLOCK(CTG_WRITE, &pCache->metaLock);
   }
 
@@ -1590,11 +1781,9 @@ int32_t ctgOpUpdateVgroup(SCtgCacheOperation *operation) {
 
       goto _return;
     }
-
-    ctgFreeVgInfo(vgInfo);
   }
 
-  vgCache->vgInfo = dbInfo;
+  ctgRcuSwapVgInfo(dbCache, dbInfo);
   msg->dbInfo = NULL;
 
   ctgDebug("db vgInfo updated, dbFName:%s, vgVer:%d, dbId:0x%" PRIx64, dbFName, vgVersion.vgVersion, vgVersion.dbId);
@@ -1654,8 +1843,7 @@ int32_t ctgOpDropDbVgroup(SCtgCacheOperation *operation) {
 
   CTG_ERR_JRET(ctgWLockVgInfo(pCtg, dbCache));
 
-  ctgFreeVgInfo(dbCache->vgCache.vgInfo);
-  dbCache->vgCache.vgInfo = NULL;
+  ctgRcuSwapVgInfo(dbCache, NULL);
 
   ctgDebug("db vgInfo removed, dbFName:%s", msg->dbFName);
 
@@ -1718,6 +1906,44 @@ _return:
   CTG_RET(code);
 }
 
+int32_t ctgOpUpdateCtbMetas(SCtgCacheOperation *operation) {
+  int32_t                code = 0;
+  SCtgUpdateCtbMetasMsg *msg = operation->data;
+  SCatalog              *pCtg = msg->pCtg;
+  SCtgDBCache           *dbCache = NULL;
+
+  CTG_ERR_JRET(ctgGetAddDBCache(pCtg, msg->dbFName, msg->dbId, &dbCache));
+  if (NULL == dbCache) {
+    ctgInfo("conflict db update, ignore this update, dbFName:%s, dbId:0x%" PRIx64, msg->dbFName, msg->dbId);
+    CTG_ERR_JRET(TSDB_CODE_CTG_INTERNAL_ERROR);
+  }
+
+  int32_t num = taosArrayGetSize(msg->pCtbs);
+  for (int32_t i = 0; i < num; ++i) {
+    SVCtbMeta   *pCtb = taosArrayGet(msg->pCtbs, i);
+    SCTableMeta *ctbMeta = taosMemoryMalloc(sizeof(SCTableMeta));
+    if (NULL == ctbMeta) {
+      CTG_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+    }
+
+    ctbMeta->vgId = msg->vgId;
+    ctbMeta->tableType = TSDB_CHILD_TABLE;
+    ctbMeta->uid = pCtb->uid;
+    ctbMeta->suid = msg->suid;
+    CTG_ERR_JRET(ctgWriteTbMetaToCache(pCtg, dbCache, msg->dbFName, msg->dbId, pCtb->tbName, (STableMeta *)ctbMeta,
+                                       sizeof(SCTableMeta)));
+  }
+
+  ctgDebug("%d ctb metas of stb 0x%" PRIx64 " updated, dbFName:%s, vgId:%d", num, msg->suid, msg->dbFName, msg->vgId);
+
+_return:
+
+  taosArrayDestroy(msg->pCtbs);
+  taosMemoryFreeClear(msg);
+
+  CTG_RET(code);
+}
+
 int32_t ctgOpDropStbMeta(SCtgCacheOperation *operation) {
   int32_t             code = 0;
   SCtgDropStbMetaMsg *msg = operation->data;
@@ -1900,8 +2126,15 @@ int32_t ctgOpUpdateEpset(SCtgCacheOperation *operation) {
            pInfo->epSet.inUse, pInfo->epSet.numOfEps, pOrigEp->fqdn, pOrigEp->port, msg->epSet.inUse,
            msg->epSet.numOfEps, pNewEp->fqdn, pNewEp->port, msg->dbFName);
 
+  // readers may hold vgInfo, update a copy of it
+  SDBVgInfo *newInfo = NULL;
+  CTG_ERR_JRET(ctgCloneVgInfo(vgInfo, &newInfo));
+
+  pInfo = taosHashGet(newInfo->vgHash, &msg->vgId, sizeof(msg->vgId));
   pInfo->epSet = msg->epSet;
 
+  ctgRcuSwapVgInfo(dbCache, newInfo);
+
 _return:
 
   if (dbCache) {
@@ -2038,6 +2271,12 @@ void ctgFreeCacheOperationData(SCtgCacheOperation *op) {
       taosMemoryFreeClear(op->data);
       break;
     }
+    case CTG_OP_UPDATE_CTB_METAS: {
+      SCtgUpdateCtbMetasMsg *msg = op->data;
+      taosArrayDestroy(msg->pCtbs);
+      taosMemoryFreeClear(op->data);
+      break;
+    }
     case CTG_OP_UPDATE_TB_INDEX: {
       SCtgUpdateTbIndexMsg *msg = op->data;
       if (msg->pIndex) {
@@ -2105,8 +2344,15 @@ void *ctgUpdateThreadFunc(void *param) {
 
   qInfo("catalog update thread started");
 
+  bool reclaimPending = false;
   while (true) {
-    if (tsem_wait(&gCtgMgmt.queue.reqSem)) {
+    if (reclaimPending) {
+      // keep reclaiming the retired cache objects while the queue is idle
+      if (tsem_timewait(&gCtgMgmt.queue.reqSem, CTG_RCU_RECLAIM_INTERVAL_NS)) {
+        reclaimPending = ctgRcuReclaim();
+        continue;
+      }
+    } else if (tsem_wait(&gCtgMgmt.queue.reqSem)) {
       qError("ctg tsem_wait failed, error:%s", tstrerror(TAOS_SYSTEM_ERROR(errno)));
     }
 
@@ -2123,6 +2369,8 @@ void *ctgUpdateThreadFunc(void *param) {
 
     (*gCtgCacheOperation[operation->opId].func)(operation);
 
+    reclaimPending = ctgRcuReclaim();
+
     if (operation->syncOp) {
       tsem_post(&operation->rspSem);
     } else {
@@ -2276,17 +2524,19 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
       continue;
     }
 
-    CTG_LOCK(CTG_READ, &pCache->metaLock);
-    if (NULL == pCache->pMeta) {
+    ctgRcuReadLock();
+    STableMeta *tbMeta = atomic_load_ptr(&pCache->pMeta);
+    if (NULL == tbMeta) {
       ctgDebug("tb %s meta not in cache, dbFName:%s", pName->tname, dbFName);
+      ctgRcuReadUnlock();
+      taosHashRelease(dbCache->tbCache, pCache);
+
       ctgAddFetch(&ctx->pFetchs, dbIdx, i, fetchIdx, baseResIdx + i, flag);
       taosArraySetSize(ctx->pResList, taosArrayGetSize(ctx->pResList) + 1);
 
       continue;
     }
 
-    STableMeta *tbMeta = pCache->pMeta;
-
     SCtgTbMetaCtx nctx = {0};
     nctx.flag = flag;
     nctx.tbInfo.inCache = true;
@@ -2306,10 +2556,10 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
 
       memcpy(pTableMeta, tbMeta, metaSize);
 
-      CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+      ctgRcuReadUnlock();
       taosHashRelease(dbCache->tbCache, pCache);
 
-      ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", pName->tname, tbMeta->tableType, dbFName);
+      ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", pName->tname, nctx.tbInfo.tbType, dbFName);
 
       res.pRes = pTableMeta;
       taosArrayPush(ctx->pResList, &res);
@@ -2323,10 +2573,10 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
       cloneTableMeta(lastTableMeta, &pTableMeta);
       memcpy(pTableMeta, tbMeta, sizeof(SCTableMeta));
 
-      CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+      ctgRcuReadUnlock();
       taosHashRelease(dbCache->tbCache, pCache);
 
-      ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", pName->tname, tbMeta->tableType, dbFName);
+      ctgDebug("Got tb %s meta from cache, type:%d, dbFName:%s", pName->tname, nctx.tbInfo.tbType, dbFName);
 
       res.pRes = pTableMeta;
       taosArrayPush(ctx->pResList, &res);
@@ -2343,7 +2593,7 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
 
     memcpy(pTableMeta, tbMeta, metaSize);
 
-    CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+    ctgRcuReadUnlock();
     taosHashRelease(dbCache->tbCache, pCache);
 
     ctgDebug("Got ctb %s meta from cache, will continue to get its stb meta, type:%d, dbFName:%s", pName->tname,
@@ -2373,10 +2623,11 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
 
     taosHashRelease(dbCache->stbCache, stName);
 
-    CTG_LOCK(CTG_READ, &pCache->metaLock);
-    if (NULL == pCache->pMeta) {
+    ctgRcuReadLock();
+    STableMeta *stbMeta = atomic_load_ptr(&pCache->pMeta);
+    if (NULL == stbMeta) {
       ctgDebug("stb 0x%" PRIx64 " meta not in cache, dbFName:%s", pTableMeta->suid, dbFName);
-      CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+      ctgRcuReadUnlock();
       taosHashRelease(dbCache->tbCache, pCache);
 
       ctgAddFetch(&ctx->pFetchs, dbIdx, i, fetchIdx, baseResIdx + i, flag);
@@ -2387,9 +2638,8 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
       continue;
     }
 
-    STableMeta *stbMeta = pCache->pMeta;
     if (stbMeta->suid != nctx.tbInfo.suid) {
-      CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+      ctgRcuReadUnlock();
       taosHashRelease(dbCache->tbCache, pCache);
 
       ctgError("stb suid 0x%" PRIx64 " in stbCache mis-match, expected suid 0x%" PRIx64, stbMeta->suid,
@@ -2412,7 +2662,7 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
 
     memcpy(&pTableMeta->sversion, &stbMeta->sversion, metaSize - sizeof(SCTableMeta));
 
-    CTG_UNLOCK(CTG_READ, &pCache->metaLock);
+    ctgRcuReadUnlock();
     taosHashRelease(dbCache->tbCache, pCache);
 
     res.pRes = pTableMeta;
@@ -2468,7 +2718,8 @@ int32_t ctgGetTbHashVgroupFromCache(SCatalog *pCtg, const SName *pTableName, SVg
   char         dbFName[TSDB_DB_FNAME_LEN] = {0};
   tNameGetFullDbName(pTableName, dbFName);
 
-  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache));
+  SDBVgInfo *vgInfo = NULL;
+  CTG_ERR_RET(ctgAcquireVgInfoFromCache(pCtg, dbFName, &dbCache, &vgInfo));
 
   if (NULL == dbCache) {
     *pVgroup = NULL;
@@ -2476,7 +2727,7 @@ int32_t ctgGetTbHashVgroupFromCache(SCatalog *pCtg, const SName *pTableName, SVg
   }
 
   *pVgroup = taosMemoryCalloc(1, sizeof(SVgroupInfo));
-  CTG_ERR_JRET(ctgGetVgInfoFromHashValue(pCtg, dbCache->vgCache.vgInfo, pTableName, *pVgroup));
+  CTG_ERR_JRET(ctgGetVgInfoFromHashValue(pCtg, vgInfo, pTableName, *pVgroup));
 
 _return:
 
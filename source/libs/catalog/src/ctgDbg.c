@@ -376,15 +376,18 @@ void ctgdShowDBCache(SCatalog *pCtg, SHashObj *dbHash) {
     int16_t hashSuffix = 0;
     int32_t vgNum = 0;
 
-    if (dbCache->vgCache.vgInfo) {
-      vgVersion = dbCache->vgCache.vgInfo->vgVersion;
-      hashMethod = dbCache->vgCache.vgInfo->hashMethod;
-      hashPrefix = dbCache->vgCache.vgInfo->hashPrefix;
-      hashSuffix = dbCache->vgCache.vgInfo->hashSuffix;
-      if (dbCache->vgCache.vgInfo->vgHash) {
-        vgNum = taosHashGetSize(dbCache->vgCache.vgInfo->vgHash);
+    ctgRcuReadLock();
+    SDBVgInfo *vgInfo = atomic_load_ptr(&dbCache->vgCache.vgInfo);
+    if (vgInfo) {
+      vgVersion = vgInfo->vgVersion;
+      hashMethod = vgInfo->hashMethod;
+      hashPrefix = vgInfo->hashPrefix;
+      hashSuffix = vgInfo->hashSuffix;
+      if (vgInfo->vgHash) {
+        vgNum = taosHashGetSize(vgInfo->vgHash);
       }
     }
+    ctgRcuReadUnlock();
 
     ctgDebug("[%d] db [%.*s][0x%" PRIx64
              "] %s: metaNum:%d, stbNum:%d, vgVersion:%d, hashMethod:%d, prefix:%d, suffix:%d, vgNum:%d",
@@ -1273,6 +1273,54 @@ int32_t ctgGetTableCfgFromVnode(SCatalog* pCtg, SRequestConnInfo* pConn, const S
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t ctgGetCtbMetasFromVnode(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pStbName, SVgroupInfo* vgroupInfo,
+                                int64_t lastUid, SVTablesMetaRsp* out) {
+  int32_t         code = 0;
+  int32_t         reqType = TDMT_VND_TABLES_META;
+  SVTablesMetaReq req = {.header.vgId = vgroupInfo->vgId, .lastUid = lastUid, .limit = CTG_DEFAULT_PREFETCH_NUM};
+  tNameGetFullDbName(pStbName, req.dbFName);
+  tstrncpy(req.stbName, pStbName->tname, sizeof(req.stbName));
+
+  SEp* pEp = &vgroupInfo->epSet.eps[vgroupInfo->epSet.inUse];
+  ctgDebug("try to get ctb metas from vnode, vgId:%d, ep num:%d, ep %s:%d, stb:%s.%s, lastUid:0x%" PRIx64,
+           vgroupInfo->vgId, vgroupInfo->epSet.numOfEps, pEp->fqdn, pEp->port, req.dbFName, req.stbName, lastUid);
+
+  int32_t msgLen = tSerializeSVTablesMetaReq(NULL, 0, &req);
+  void*   msg = rpcMallocCont(msgLen);
+  if (NULL == msg) {
+    CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+  tSerializeSVTablesMetaReq(msg, msgLen, &req);
+
+  SRpcMsg rpcMsg = {
+      .msgType = reqType,
+      .pCont = msg,
+      .contLen = msgLen,
+  };
+
+  SRpcMsg rpcRsp = {0};
+  rpcSendRecv(pConn->pTrans, &vgroupInfo->epSet, &rpcMsg, &rpcRsp);
+
+  if (TSDB_CODE_SUCCESS != rpcRsp.code) {
+    ctgError("get ctb metas from vnode failed, vgId:%d, stb:%s, error:%s", vgroupInfo->vgId, req.stbName,
+             tstrerror(rpcRsp.code));
+    CTG_ERR_JRET(rpcRsp.code);
+  }
+
+  if (tDeserializeSVTablesMetaRsp(rpcRsp.pCont, rpcRsp.contLen, out)) {
+    ctgError("invalid ctb metas rsp, vgId:%d, stb:%s", vgroupInfo->vgId, req.stbName);
+    tFreeSVTablesMetaRsp(out);
+    out->pCtbs = NULL;
+    CTG_ERR_JRET(TSDB_CODE_INVALID_MSG);
+  }
+
+_return:
+
+  rpcFreeCont(rpcRsp.pCont);
+
+  CTG_RET(code);
+}
+
 int32_t ctgGetTableCfgFromMnode(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, STableCfg** out,
                                 SCtgTask* pTask) {
   char*   msg = NULL;
@@ -208,7 +208,7 @@ void ctgFreeStbMetaCache(SCtgDBCache* dbCache) {
 
 void ctgFreeTbCacheImpl(SCtgTbCache* pCache) {
   qDebug("tbMeta freed, p:%p", pCache->pMeta);
-  taosMemoryFreeClear(pCache->pMeta);
+  ctgRcuSwapTbMeta(pCache, NULL);
   if (pCache->pIndex) {
     taosArrayDestroyEx(pCache->pIndex->pIndex, tFreeSTableIndexInfo);
     taosMemoryFreeClear(pCache->pIndex);
@@ -244,7 +244,7 @@ void ctgFreeVgInfo(SDBVgInfo* vgInfo) {
   taosMemoryFreeClear(vgInfo);
 }
 
-void ctgFreeVgInfoCache(SCtgDBCache* dbCache) { ctgFreeVgInfo(dbCache->vgCache.vgInfo); }
+void ctgFreeVgInfoCache(SCtgDBCache* dbCache) { ctgRcuSwapVgInfo(dbCache, NULL); }
 
 void ctgFreeDbCache(SCtgDBCache* dbCache) {
   if (NULL == dbCache) {
@@ -1052,6 +1052,105 @@ void ctgTestSetRspDbVgroupsAndMultiSuperMeta() {
   }
 }
 
+int32_t ctgTestCtbPerVg = 7;
+int32_t ctgTestCtbPageSize = 3;
+int32_t ctgTestTablesMetaReqNum = 0;
+int32_t ctgTestTablesMetaInFlight = 0;
+int32_t ctgTestTablesMetaMaxInFlight = 0;
+
+// the children of a vgroup are vgId * 1000 + k, served a few per page
+void ctgTestRspTablesMeta(void *shandle, SEpSet *pEpSet, SRpcMsg *pMsg, SRpcMsg *pRsp) {
+  int32_t         vgId = ntohl(((SMsgHead *)pMsg->pCont)->vgId);
+  SVTablesMetaReq req = {0};
+  tDeserializeSVTablesMetaReq(pMsg->pCont, pMsg->contLen, &req);
+  rpcFreeCont(pMsg->pCont);
+
+  atomic_add_fetch_32(&ctgTestTablesMetaReqNum, 1);
+  int32_t inFlight = atomic_add_fetch_32(&ctgTestTablesMetaInFlight, 1);
+  int32_t maxInFlight = atomic_load_32(&ctgTestTablesMetaMaxInFlight);
+  while (inFlight > maxInFlight) {
+    maxInFlight = atomic_val_compare_exchange_32(&ctgTestTablesMetaMaxInFlight, maxInFlight, inFlight);
+  }
+  taosMsleep(20);
+
+  SVTablesMetaRsp rsp = {0};
+  rsp.dbId = ctgTestDbId;
+  rsp.suid = ctgTestSuid;
+  rsp.vgId = vgId;
+  rsp.sversion = ctgTestSVersion;
+  rsp.tversion = ctgTestTVersion;
+  rsp.pCtbs = taosArrayInit(ctgTestCtbPageSize, sizeof(SVCtbMeta));
+  for (int32_t k = 0; k < ctgTestCtbPerVg; ++k) {
+    SVCtbMeta ctb = {0};
+    ctb.uid = vgId * 1000 + k;
+    if (ctb.uid <= req.lastUid) {
+      continue;
+    }
+    if (taosArrayGetSize(rsp.pCtbs) >= ctgTestCtbPageSize) {
+      rsp.hasMore = 1;
+      break;
+    }
+    sprintf(ctb.tbName, "ctb_%d_%d", vgId, k);
+    taosArrayPush(rsp.pCtbs, &ctb);
+  }
+
+  int32_t contLen = tSerializeSVTablesMetaRsp(NULL, 0, &rsp);
+  void   *pCont = rpcMallocCont(contLen);
+  tSerializeSVTablesMetaRsp(pCont, contLen, &rsp);
+  tFreeSVTablesMetaRsp(&rsp);
+
+  atomic_sub_fetch_32(&ctgTestTablesMetaInFlight, 1);
+
+  pRsp->code = 0;
+  pRsp->contLen = contLen;
+  pRsp->pCont = pCont;
+}
+
+void ctgTestRspCtbPrefetch(void *shandle, SEpSet *pEpSet, SRpcMsg *pMsg, SRpcMsg *pRsp) {
+  if (TDMT_MND_USE_DB == pMsg->msgType) {
+    ctgTestRspDbVgroups(shandle, pEpSet, pMsg, pRsp);
+  } else if (TDMT_VND_TABLES_META == pMsg->msgType) {
+    ctgTestRspTablesMeta(shandle, pEpSet, pMsg, pRsp);
+  } else {
+    ctgTestRspSTableMeta(shandle, pEpSet, pMsg, pRsp);
+  }
+}
+
+void ctgTestSetRspCtbPrefetch() {
+  static Stub stub;
+  stub.set(rpcSendRecv, ctgTestRspCtbPrefetch);
+  {
+#ifdef WINDOWS
+    AddrAny                       any;
+    std::map<std::string, void *> result;
+    any.get_func_addr("rpcSendRecv", result);
+#endif
+#ifdef LINUX
+    AddrAny                       any("libtransport.so");
+    std::map<std::string, void *> result;
+    any.get_global_func_addr_dynsym("^rpcSendRecv$", result);
+#endif
+    for (const auto &f : result) {
+      stub.set(f.second, ctgTestRspCtbPrefetch);
+    }
+  }
+}
+
+// the cached child table, NULL if it is not there (yet)
+STableMeta *ctgTestReadCtbMeta(struct SCatalog *pCtg, const char *tbName) {
+  SName cn = {TSDB_TABLE_NAME_T, 1, {0}, {0}};
+  strcpy(cn.dbname, "db1");
+  strcpy(cn.tname, tbName);
+
+  SCtgTbMetaCtx ctx = {0};
+  ctx.pName = &cn;
+  ctx.flag = CTG_FLAG_UNKNOWN_STB;
+
+  STableMeta *tbMeta = NULL;
+  EXPECT_EQ(ctgReadTbMetaFromCache(pCtg, &ctx, &tbMeta), 0);
+  return tbMeta;
+}
+
 }  // namespace
 
 void *ctgTestGetDbVgroupThread(void *param) {
@@ -1204,6 +1303,109 @@ void *ctgTestSetCtableMetaThread(void *param) {
 }
 
 
+void *ctgTestReadCacheThread(void *param) {
+  struct SCatalog  *pCtg = (struct SCatalog *)param;
+  int32_t           code = 0;
+  int32_t           n = 0;
+  STableMeta       *tbMeta = NULL;
+  SRequestConnInfo connInfo = {0};
+  SRequestConnInfo *mockPointer = (SRequestConnInfo *)&connInfo;
+
+  SName cn = {TSDB_TABLE_NAME_T, 1, {0}, {0}};
+  strcpy(cn.dbname, "db1");
+  strcpy(cn.tname, ctgTestCTablename);
+
+  SCtgTbMetaCtx ctx = {0};
+  ctx.pName = &cn;
+  ctx.flag = CTG_FLAG_UNKNOWN_STB;
+
+  while (!ctgTestStop) {
+    code = ctgReadTbMetaFromCache(pCtg, &ctx, &tbMeta);
+    if (code) {
+      assert(0);
+    }
+    if (tbMeta) {
+      assert(tbMeta->tableType == TSDB_CHILD_TABLE && tbMeta->uid == 3);
+      assert(tbMeta->tableInfo.numOfColumns == ctgTestColNum);
+      taosMemoryFreeClear(tbMeta);
+    }
+
+    int32_t vgVersion = 0, tbNum = 0;
+    int64_t dbId = 0;
+    code = catalogGetDBVgVersion(pCtg, ctgTestDbname, &vgVersion, &dbId, &tbNum);
+    if (code) {
+      assert(0);
+    }
+
+    SVgroupInfo vgInfo = {0};
+    bool        exists = false;
+    code = catalogGetCachedTableHashVgroup(pCtg, mockPointer, &cn, &vgInfo, &exists);
+    if (TSDB_CODE_SUCCESS == code && exists) {
+      assert(vgInfo.vgId > 0 && vgInfo.vgId <= ctgTestVgNum);
+    }
+
+    if (ctgTestEnableSleep) {
+      taosUsleep(taosRand() % 5);
+    }
+
+    if (++n % ctgTestPrintNum == 0) {
+      printf("Read:%d\n", n);
+    }
+  }
+
+  return NULL;
+}
+
+// keeps swapping and dropping the cached objects the readers are using
+void *ctgTestDropUpdateCacheThread(void *param) {
+  struct SCatalog  *pCtg = (struct SCatalog *)param;
+  int32_t           code = 0;
+  int32_t           n = 0;
+  SDBVgInfo        *dbVgroup = NULL;
+  STableMetaOutput *output = NULL;
+
+  while (!ctgTestStop) {
+    switch (n % 4) {
+      case 0:
+        output = (STableMetaOutput *)taosMemoryMalloc(sizeof(STableMetaOutput));
+        ctgTestBuildCTableMetaOutput(output);
+        code = ctgUpdateTbMetaEnqueue(pCtg, output, true);
+        break;
+      case 1:
+        code = ctgDropTbMetaEnqueue(pCtg, ctgTestDbname, ctgTestDbId, ctgTestCTablename, true);
+        break;
+      case 2:
+        ctgTestBuildDBVgroup(&dbVgroup);
+        code = ctgUpdateVgroupEnqueue(pCtg, ctgTestDbname, ctgTestDbId, dbVgroup, true);
+        if (TSDB_CODE_SUCCESS == code) {
+          SEpSet epSet = {0};
+          epSet.numOfEps = 1;
+          strcpy(epSet.eps[0].fqdn, "a1");
+          epSet.eps[0].port = 22;
+          code = ctgUpdateVgEpsetEnqueue(pCtg, ctgTestDbname, taosRand() % (ctgTestVgNum - 2) + 1, &epSet);
+        }
+        break;
+      default:
+        code = ctgDropDbVgroupEnqueue(pCtg, ctgTestDbname, true);
+        break;
+    }
+
+    if (code) {
+      assert(0);
+    }
+
+    if (ctgTestEnableSleep) {
+      taosUsleep(taosRand() % 5);
+    }
+    if (++n % ctgTestPrintNum == 0) {
+      printf("Write:%d\n", n);
+    }
+  }
+
+  return NULL;
+}
+
+
 TEST(tableMeta, normalTable) {
   struct SCatalog  *pCtg = NULL;
   SVgroupInfo       vgInfo = {0};
@@ -2643,6 +2845,188 @@ TEST(multiThread, ctableMeta) {
   catalogDestroy();
 }
 
+TEST(multiThread, readDropUpdateCache) {
+  struct SCatalog *pCtg = NULL;
+  SDBVgInfo       *dbVgroup = NULL;
+  ctgTestStop = false;
+
+  ctgTestInitLogFile();
+
+  ctgTestSetRspDbVgroupsAndChildMeta();
+
+  initQueryModuleMsgHandle();
+
+  int32_t code = catalogInit(NULL);
+  ASSERT_EQ(code, 0);
+
+  code = catalogGetHandle(ctgTestClusterId, &pCtg);
+  ASSERT_EQ(code, 0);
+
+  ctgTestBuildDBVgroup(&dbVgroup);
+  code = catalogUpdateDBVgInfo(pCtg, ctgTestDbname, ctgTestDbId, dbVgroup);
+  ASSERT_EQ(code, 0);
+
+  TdThreadAttr thattr;
+  taosThreadAttrInit(&thattr);
+
+  TdThread readers[4], writer;
+  for (int32_t i = 0; i < sizeof(readers) / sizeof(readers[0]); ++i) {
+    taosThreadCreate(&readers[i], &thattr, ctgTestReadCacheThread, pCtg);
+  }
+  taosThreadCreate(&writer, &thattr, ctgTestDropUpdateCacheThread, pCtg);
+
+  while (true) {
+    if (ctgTestDeadLoop) {
+      taosSsleep(1);
+    } else {
+      taosSsleep(ctgTestMTRunSec);
+      break;
+    }
+  }
+
+  ctgTestStop = true;
+  taosThreadJoin(writer, NULL);
+  for (int32_t i = 0; i < sizeof(readers) / sizeof(readers[0]); ++i) {
+    taosThreadJoin(readers[i], NULL);
+  }
+
+  catalogDestroy();
+}
+
+TEST(ctbMetaCache, updateCtbMetas) {
+  struct SCatalog *pCtg = NULL;
+
+  ctgTestInitLogFile();
+
+  ctgTestSetRspDbVgroupsAndSuperMeta();
+
+  initQueryModuleMsgHandle();
+
+  int32_t code = catalogInit(NULL);
+  ASSERT_EQ(code, 0);
+
+  code = catalogGetHandle(ctgTestClusterId, &pCtg);
+  ASSERT_EQ(code, 0);
+
+  STableMetaRsp stbRsp = {0};
+  ctgTestBuildSTableMetaRsp(&stbRsp);
+  code = catalogUpdateTableMeta(pCtg, &stbRsp);
+  ASSERT_EQ(code, 0);
+  tFreeSTableMetaRsp(&stbRsp);
+
+  SArray   *pCtbs = taosArrayInit(2, sizeof(SVCtbMeta));
+  SVCtbMeta ctb = {0};
+  strcpy(ctb.tbName, "ctb_a");
+  ctb.uid = 10;
+  taosArrayPush(pCtbs, &ctb);
+  strcpy(ctb.tbName, "ctb_b");
+  ctb.uid = 11;
+  taosArrayPush(pCtbs, &ctb);
+
+  // a sync op is run after the stb update queued before it
+  CTG_LOCK(CTG_READ, &gCtgMgmt.lock);
+  code = ctgUpdateCtbMetasEnqueue(pCtg, ctgTestDbname, ctgTestDbId, ctgTestSuid, 2, pCtbs, true);
+  CTG_UNLOCK(CTG_READ, &gCtgMgmt.lock);
+  ASSERT_EQ(code, 0);
+
+  STableMeta *tbMeta = ctgTestReadCtbMeta(pCtg, "ctb_a");
+  ASSERT_NE(tbMeta, nullptr);
+  ASSERT_EQ(tbMeta->tableType, TSDB_CHILD_TABLE);
+  ASSERT_EQ(tbMeta->uid, 10);
+  ASSERT_EQ(tbMeta->suid, ctgTestSuid);
+  ASSERT_EQ(tbMeta->vgId, 2);
+  ASSERT_EQ(tbMeta->tableInfo.numOfColumns, ctgTestColNum);
+  taosMemoryFreeClear(tbMeta);
+
+  tbMeta = ctgTestReadCtbMeta(pCtg, "ctb_b");
+  ASSERT_NE(tbMeta, nullptr);
+  ASSERT_EQ(tbMeta->uid, 11);
+  taosMemoryFreeClear(tbMeta);
+
+  // a table with the cached uid is kept, a table created again under the name replaces it
+  pCtbs = taosArrayInit(2, sizeof(SVCtbMeta));
+  strcpy(ctb.tbName, "ctb_a");
+  ctb.uid = 10;
+  taosArrayPush(pCtbs, &ctb);
+  strcpy(ctb.tbName, "ctb_b");
+  ctb.uid = 12;
+  taosArrayPush(pCtbs, &ctb);
+  CTG_LOCK(CTG_READ, &gCtgMgmt.lock);
+  code = ctgUpdateCtbMetasEnqueue(pCtg, ctgTestDbname, ctgTestDbId, ctgTestSuid, 5, pCtbs, true);
+  CTG_UNLOCK(CTG_READ, &gCtgMgmt.lock);
+  ASSERT_EQ(code, 0);
+
+  tbMeta = ctgTestReadCtbMeta(pCtg, "ctb_a");
+  ASSERT_NE(tbMeta, nullptr);
+  ASSERT_EQ(tbMeta->vgId, 2);
+  taosMemoryFreeClear(tbMeta);
+
+  tbMeta = ctgTestReadCtbMeta(pCtg, "ctb_b");
+  ASSERT_NE(tbMeta, nullptr);
+  ASSERT_EQ(tbMeta->uid, 12);
+  ASSERT_EQ(tbMeta->vgId, 5);
+  taosMemoryFreeClear(tbMeta);
+
+  ASSERT_EQ(ctgTestReadCtbMeta(pCtg, "ctb_c"), nullptr);
+
+  catalogDestroy();
+}
+
+TEST(ctbMetaCache, prefetch) {
+  struct SCatalog  *pCtg = NULL;
+  SRequestConnInfo  connInfo = {0};
+  SRequestConnInfo *mockPointer = (SRequestConnInfo *)&connInfo;
+
+  ctgTestInitLogFile();
+
+  ctgTestSetRspCtbPrefetch();
+
+  initQueryModuleMsgHandle();
+
+  int32_t code = catalogInit(NULL);
+  ASSERT_EQ(code, 0);
+
+  code = catalogGetHandle(ctgTestClusterId, &pCtg);
+  ASSERT_EQ(code, 0);
+
+  SName n = {TSDB_TABLE_NAME_T, 1, {0}, {0}};
+  strcpy(n.dbname, "db1");
+  strcpy(n.tname, ctgTestSTablename);
+
+  ctgTestTablesMetaReqNum = 0;
+  ctgTestTablesMetaMaxInFlight = 0;
+  code = catalogPrefetchChildTableMeta(pCtg, mockPointer, &n);
+  ASSERT_EQ(code, 0);
+
+  // every vgroup is paged to its end, several of them at the same time
+  int32_t pageNum = (ctgTestCtbPerVg + ctgTestCtbPageSize - 1) / ctgTestCtbPageSize;
+  ASSERT_EQ(ctgTestTablesMetaReqNum, ctgTestVgNum * pageNum);
+  ASSERT_GT(ctgTestTablesMetaMaxInFlight, 1);
+  ASSERT_LE(ctgTestTablesMetaMaxInFlight, CTG_DEFAULT_PREFETCH_VG_NUM);
+
+  // the pages are written by the cache update thread
+  char tbName[TSDB_TABLE_NAME_LEN];
+  for (int32_t vgId = 1; vgId <= ctgTestVgNum; ++vgId) {
+    for (int32_t k = 0; k < ctgTestCtbPerVg; ++k) {
+      sprintf(tbName, "ctb_%d_%d", vgId, k);
+      STableMeta *tbMeta = NULL;
+      for (int32_t i = 0; i < 500 && NULL == tbMeta; ++i) {
+        tbMeta = ctgTestReadCtbMeta(pCtg, tbName);
+        if (NULL == tbMeta) {
+          taosMsleep(10);
+        }
+      }
+      ASSERT_NE(tbMeta, nullptr);
+      ASSERT_EQ(tbMeta->tableType, TSDB_CHILD_TABLE);
+      ASSERT_EQ(tbMeta->uid, vgId * 1000 + k);
+      ASSERT_EQ(tbMeta->vgId, vgId);
+      taosMemoryFreeClear(tbMeta);
+    }
+  }
+
+  catalogDestroy();
+}
+
 TEST(rentTest, allRent) {
   struct SCatalog  *pCtg = NULL;
   SRequestConnInfo connInfo = {0};  
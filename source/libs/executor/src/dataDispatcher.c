@@ -60,6 +60,22 @@ typedef struct SDataDispatchHandle {
 // The length of bitmap is decided by number of rows of this data block, and the length of each column data is
 // recorded in the first segment, next to the struct header
 // clang-format on
+// compressColData: -1 never, 0 always, otherwise once a column of the block is larger than it
+static bool needCompress(const SSDataBlock* pData, int32_t numOfCols) {
+  if (tsCompressColData < 0 || 0 == pData->info.rows) {
+    return false;
+  }
+
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColRes = taosArrayGet(pData->pDataBlock, col);
+    if (colDataGetLength(pColRes, pData->info.rows) > tsCompressColData) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
   int32_t numOfCols = 0;
   SNode*  pNode;
@@ -70,7 +86,7 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
     }
   }
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
-  pEntry->compressed = 0;
+  pEntry->compressed = atomic_load_8(&pHandle->sink.colFmt) && needCompress(pInput->pData, numOfCols);
   pEntry->numOfRows = pInput->pData->info.rows;
   pEntry->numOfCols = numOfCols;
   pEntry->dataLen = 0;
@@ -150,6 +166,35 @@ static void endPut(struct SDataSinkHandle* pHandle, uint64_t useconds) {
   taosThreadMutexUnlock(&pDispatcher->mutex);
 }
 
+// The block was encoded for a fetcher that decodes columnar blocks, the one fetching now does not.
+static void toVersion1Entry(SDataDispatchHandle* pDispatcher) {
+  SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  SSDataBlock      block = {0};
+  if (blockDecode(&block, pEntry->data) == NULL) {
+    blockDataFreeRes(&block);
+    qError("SinkNode failed to decode columnar block, code:%s", terrstr());
+    return;
+  }
+
+  int32_t          allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(&block);
+  SDataCacheEntry* pNew = taosMemoryMalloc(allocSize);
+  if (pNew != NULL) {
+    memcpy(pNew, pEntry, sizeof(SDataCacheEntry));
+    pNew->compressed = 0;
+    blockEncode(&block, pNew->data, &pNew->dataLen, pNew->numOfCols, 0);
+
+    atomic_add_fetch_64(&pDispatcher->cachedSize, pNew->dataLen - pEntry->dataLen);
+    atomic_add_fetch_64(&gDataSinkStat.cachedSize, pNew->dataLen - pEntry->dataLen);
+    taosMemoryFree(pDispatcher->nextOutput.pData);
+    pDispatcher->nextOutput.pData = (char*)pNew;
+    pDispatcher->nextOutput.allocSize = allocSize;
+    pDispatcher->nextOutput.useSize = sizeof(SDataCacheEntry) + pNew->dataLen;
+  } else {
+    qError("SinkNode failed to malloc memory, size:%d", allocSize);
+  }
+  blockDataFreeRes(&block);
+}
+
 static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryEnd) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   if (taosQueueEmpty(pDispatcher->pDataBlocks)) {
@@ -165,6 +210,10 @@ static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryE
   taosFreeQitem(pBuf);
 
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  if (pEntry->compressed && !atomic_load_8(&pHandle->colFmt)) {
+    toVersion1Entry(pDispatcher);
+    pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  }
   *pLen = pEntry->dataLen;
 
   ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
@@ -62,6 +62,11 @@ void dsGetDataLength(DataSinkHandle handle, int64_t* pLen, bool* pQueryEnd) {
   pHandleImpl->fGetLen(pHandleImpl, pLen, pQueryEnd);
 }
 
+void dsSetColumnarOutput(DataSinkHandle handle, bool colFmt) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  atomic_store_8(&pHandleImpl->colFmt, colFmt);
+}
+
 int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput) {
   SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
   return pHandleImpl->fGetData(pHandleImpl, pOutput);
@@ -1772,6 +1772,8 @@ static int32_t doSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInf
     pMsg->taskId = htobe64(pSource->taskId);
     pMsg->queryId = htobe64(pTaskInfo->id.queryId);
     pMsg->execId = htonl(pSource->execId);
+    pMsg->ver = htonl(RES_FETCH_REQ_VER);
+    pMsg->colFmt = 1;
 
     // send the fetch remote task result reques
     SMsgSendInfo* pMsgSendInfo = taosMemoryCalloc(1, sizeof(SMsgSendInfo));
@@ -1809,7 +1811,11 @@ void updateLoadRemoteInfo(SLoadRemoteDataInfo* pInfo, int32_t numOfRows, int32_t
 int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pColList, char** pNextStart) {
   if (pColList == NULL) {  // data from other sources
     blockDataCleanup(pRes);
-    *pNextStart = (char*)blockDecode(pRes, pData);
+    const char* pNext = blockDecode(pRes, pData);
+    if (pNext == NULL) {
+      return terrno;
+    }
+    *pNextStart = (char*)pNext;
   } else {  // extract data according to pColList
     char* pStart = pData;
 
@@ -1832,7 +1838,11 @@ int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pCo
       blockDataAppendColInfo(pBlock, &idata);
     }
 
-    blockDecode(pBlock, pStart);
+    if (blockDecode(pBlock, pStart) == NULL) {
+      int32_t code = terrno;
+      blockDataDestroy(pBlock);
+      return code;
+    }
     blockDataEnsureCapacity(pRes, pBlock->info.rows);
 
     // data from mnode
@@ -1910,6 +1920,7 @@ static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeIn
         SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
         code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
         if (code != 0) {
+          blockDataDestroy(pb);
           taosMemoryFreeClear(pDataInfo->pRsp);
           goto _error;
         }
@@ -2033,7 +2044,19 @@ static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
     SRetrieveTableRsp* pRetrieveRsp = pDataInfo->pRsp;
 
     char*   pStart = pRetrieveRsp->data;
-    int32_t code = extractDataBlockFromFetchRsp(NULL, pStart, NULL, &pStart);
+    for (int32_t index = 0; index < pRetrieveRsp->numOfBlocks; ++index) {
+      SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
+      int32_t      code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
+      if (code != TSDB_CODE_SUCCESS) {
+        qError("%s vgId:%d, taskID:0x%" PRIx64 " execId:%d failed to decode the fetch rsp, code:%s",
+               GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, tstrerror(code));
+        blockDataDestroy(pb);
+        taosMemoryFreeClear(pDataInfo->pRsp);
+        pTaskInfo->code = code;
+        return code;
+      }
+      taosArrayPush(pExchangeInfo->pResultBlockList, &pb);
+    }
 
     if (pRsp->completed == 1) {
       qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64 " execId:%d numOfRows:%d, rowsOfSource:%" PRIu64
@@ -3997,7 +3997,13 @@ static SSDataBlock* doSysTableScan(SOperatorInfo* pOperator) {
       }
 
       char* pStart = pRsp->data;
-      extractDataBlockFromFetchRsp(pInfo->pRes, pRsp->data, pInfo->matchInfo.pList, &pStart);
+      code = extractDataBlockFromFetchRsp(pInfo->pRes, pRsp->data, pInfo->matchInfo.pList, &pStart);
+      if (code != TSDB_CODE_SUCCESS) {
+        qError("%s failed to decode meta data from mnode, code:%s", GET_TASKID(pTaskInfo), tstrerror(code));
+        pTaskInfo->code = code;
+        taosMemoryFree(pRsp);
+        return NULL;
+      }
       updateLoadRemoteInfo(&pInfo->loadInfo, pRsp->numOfRows, pRsp->compLen, startTs, pOperator);
 
       // todo log the filter info
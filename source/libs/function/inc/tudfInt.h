@@ -34,6 +34,20 @@ enum {
   TSDB_UDF_CALL_SCALA_PROC,
 };
 
+#define UDF_SHM_NAME_LEN  32
+#define UDF_SHM_PREFIX    "/taosudf"  // segments are named <prefix>-<pid of udfc>-<seq>
+#define UDF_SHM_MIN_SIZE  (64 * 1024)  // smaller msgs go through the pipe
+#define UDF_SHM_POOL_SIZE 16
+
+// The body of a large call request or response is placed in a shared memory segment owned by udfc, only its name and
+// the body length go through the pipe. udfd maps the columns of the request in place, keeps the segment mapped for the
+// connection and writes the response body over the request body.
+typedef struct SUdfShmInfo {
+  char    name[UDF_SHM_NAME_LEN];
+  int64_t size;
+  int32_t bodyLen;  // 0 if the body is inline
+} SUdfShmInfo;
+
 typedef struct SUdfSetupRequest {
   char udfName[TSDB_FUNC_NAME_LEN + 1];
 } SUdfSetupRequest;
@@ -53,6 +67,8 @@ typedef struct SUdfCallRequest {
   SUdfInterBuf interBuf;
   SUdfInterBuf interBuf2;
   int8_t       initFirst;
+
+  SUdfDataBlock input;  // block mapped in place from shared memory by udfd, see mapUdfShmRequestBody
 } SUdfCallRequest;
 
 typedef struct SUdfCallResponse {
@@ -75,7 +91,8 @@ typedef struct SUdfRequest {
   int32_t msgLen;
   int64_t seqNum;
 
-  int8_t type;
+  int8_t      type;
+  SUdfShmInfo shm;
   union {
     SUdfSetupRequest    setup;
     SUdfCallRequest     call;
@@ -87,8 +104,9 @@ typedef struct SUdfResponse {
   int32_t msgLen;
   int64_t seqNum;
 
-  int8_t  type;
-  int32_t code;
+  int8_t      type;
+  int32_t     code;
+  SUdfShmInfo shm;
   union {
     SUdfSetupResponse    setupRsp;
     SUdfCallResponse     callRsp;
@@ -98,13 +116,24 @@ typedef struct SUdfResponse {
 
 int32_t encodeUdfRequest(void **buf, const SUdfRequest *request);
 void   *decodeUdfRequest(const void *buf, SUdfRequest *request);
+int32_t encodeUdfRequestBody(void **buf, const SUdfRequest *request);
+void   *decodeUdfRequestBody(const void *buf, SUdfRequest *request);
 
 int32_t encodeUdfResponse(void **buf, const SUdfResponse *response);
 void   *decodeUdfResponse(const void *buf, SUdfResponse *response);
+int32_t encodeUdfResponseBody(void **buf, const SUdfResponse *response);
+void   *decodeUdfResponseBody(const void *buf, SUdfResponse *response);
+
+// bodies in shared memory, the blocks are not encoded, see encodeUdfShmBlock
+int32_t encodeUdfShmRequestBody(void **buf, const SUdfRequest *request);
+void   *mapUdfShmRequestBody(const void *buf, SUdfRequest *request);
+int32_t encodeUdfShmResponseBody(void **buf, const SUdfResponse *response, const SUdfColumn *pResult);
+void   *decodeUdfShmResponseBody(const void *buf, SUdfResponse *response);
 
 void freeUdfColumnData(SUdfColumnData *data, SUdfColumnMeta *meta);
 void freeUdfColumn(SUdfColumn *col);
 void freeUdfDataDataBlock(SUdfDataBlock *block);
+void freeUdfShmDataBlock(SUdfDataBlock *block);
 
 int32_t convertDataBlockToUdfDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlock);
 int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block);
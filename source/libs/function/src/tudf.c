@@ -363,6 +363,10 @@ typedef struct SUdfcProxy {
 
   uv_mutex_t udfcUvMutex;
   int8_t initialized;
+
+  uv_mutex_t shmMutex;
+  SArray    *shmPool;  // SUdfcShm, idle segments
+  int64_t    shmSeq;
 } SUdfcProxy;
 
 SUdfcProxy gUdfcProxy = {0};
@@ -379,6 +383,11 @@ typedef struct SUdfcUvSession {
   char udfName[TSDB_FUNC_NAME_LEN + 1];
 } SUdfcUvSession;
 
+typedef struct SUdfcShm {
+  char name[UDF_SHM_NAME_LEN];
+  SShm shm;
+} SUdfcShm;
+
 typedef struct SClientUvTaskNode {
   SUdfcProxy *udfc;
   int8_t      type;
@@ -388,6 +397,7 @@ typedef struct SClientUvTaskNode {
 
   int64_t  seqNum;
   uv_buf_t reqBuf;
+  SUdfcShm shm;  // holds the call body when it is too large for the pipe
 
   uv_sem_t taskSem;
   uv_buf_t rspBuf;
@@ -451,6 +461,8 @@ int32_t encodeUdfCallRequest(void **buf, const SUdfCallRequest *call);
 void   *decodeUdfCallRequest(const void *buf, SUdfCallRequest *call);
 int32_t encodeUdfTeardownRequest(void **buf, const SUdfTeardownRequest *teardown);
 void   *decodeUdfTeardownRequest(const void *buf, SUdfTeardownRequest *teardown);
+int32_t encodeUdfShmInfo(void **buf, const SUdfShmInfo *shm);
+void   *decodeUdfShmInfo(const void *buf, SUdfShmInfo *shm);
 int32_t encodeUdfRequest(void **buf, const SUdfRequest *request);
 void   *decodeUdfRequest(const void *buf, SUdfRequest *request);
 int32_t encodeUdfSetupResponse(void **buf, const SUdfSetupResponse *setupRsp);
@@ -570,6 +582,49 @@ void *decodeUdfTeardownRequest(const void *buf, SUdfTeardownRequest *teardown) {
   return (void *)buf;
 }
 
+int32_t encodeUdfShmInfo(void **buf, const SUdfShmInfo *shm) {
+  int32_t len = 0;
+  len += taosEncodeFixedI32(buf, shm->bodyLen);
+  if (shm->bodyLen > 0) {
+    len += taosEncodeString(buf, shm->name);
+    len += taosEncodeFixedI64(buf, shm->size);
+  }
+  return len;
+}
+
+void *decodeUdfShmInfo(const void *buf, SUdfShmInfo *shm) {
+  buf = taosDecodeFixedI32(buf, &shm->bodyLen);
+  if (shm->bodyLen > 0) {
+    buf = taosDecodeStringTo(buf, shm->name);
+    buf = taosDecodeFixedI64(buf, &shm->size);
+  }
+  return (void *)buf;
+}
+
+int32_t encodeUdfRequestBody(void **buf, const SUdfRequest *request) {
+  int32_t len = 0;
+  if (request->type == UDF_TASK_SETUP) {
+    len += encodeUdfSetupRequest(buf, &request->setup);
+  } else if (request->type == UDF_TASK_CALL) {
+    len += encodeUdfCallRequest(buf, &request->call);
+  } else if (request->type == UDF_TASK_TEARDOWN) {
+    len += encodeUdfTeardownRequest(buf, &request->teardown);
+  }
+  return len;
+}
+
+void *decodeUdfRequestBody(const void *buf, SUdfRequest *request) {
+  if (request->type == UDF_TASK_SETUP) {
+    buf = decodeUdfSetupRequest(buf, &request->setup);
+  } else if (request->type == UDF_TASK_CALL) {
+    buf = decodeUdfCallRequest(buf, &request->call);
+  } else if (request->type == UDF_TASK_TEARDOWN) {
+    buf = decodeUdfTeardownRequest(buf, &request->teardown);
+  }
+  return (void *)buf;
+}
+
+// the body is left out when it is placed in shared memory
 int32_t encodeUdfRequest(void **buf, const SUdfRequest *request) {
   int32_t len = 0;
   if (buf == NULL) {
@@ -580,12 +635,9 @@ int32_t encodeUdfRequest(void **buf, const SUdfRequest *request) {
   }
   len += taosEncodeFixedI64(buf, request->seqNum);
   len += taosEncodeFixedI8(buf, request->type);
-  if (request->type == UDF_TASK_SETUP) {
-    len += encodeUdfSetupRequest(buf, &request->setup);
-  } else if (request->type == UDF_TASK_CALL) {
-    len += encodeUdfCallRequest(buf, &request->call);
-  } else if (request->type == UDF_TASK_TEARDOWN) {
-    len += encodeUdfTeardownRequest(buf, &request->teardown);
+  len += encodeUdfShmInfo(buf, &request->shm);
+  if (request->shm.bodyLen == 0) {
+    len += encodeUdfRequestBody(buf, request);
   }
   return len;
 }
@@ -596,13 +648,9 @@ void *decodeUdfRequest(const void *buf, SUdfRequest *request) {
 
   buf = taosDecodeFixedI64(buf, &request->seqNum);
   buf = taosDecodeFixedI8(buf, &request->type);
-
-  if (request->type == UDF_TASK_SETUP) {
-    buf = decodeUdfSetupRequest(buf, &request->setup);
-  } else if (request->type == UDF_TASK_CALL) {
-    buf = decodeUdfCallRequest(buf, &request->call);
-  } else if (request->type == UDF_TASK_TEARDOWN) {
-    buf = decodeUdfTeardownRequest(buf, &request->teardown);
+  buf = decodeUdfShmInfo(buf, &request->shm);
+  if (request->shm.bodyLen == 0) {
+    buf = decodeUdfRequestBody(buf, request);
   }
   return (void *)buf;
 }
@@ -673,6 +721,44 @@ int32_t encodeUdfTeardownResponse(void **buf, const SUdfTeardownResponse *teardo
 
 void *decodeUdfTeardownResponse(const void *buf, SUdfTeardownResponse *teardownResponse) { return (void *)buf; }
 
+int32_t encodeUdfResponseBody(void **buf, const SUdfResponse *rsp) {
+  int32_t len = 0;
+  switch (rsp->type) {
+    case UDF_TASK_SETUP:
+      len += encodeUdfSetupResponse(buf, &rsp->setupRsp);
+      break;
+    case UDF_TASK_CALL:
+      len += encodeUdfCallResponse(buf, &rsp->callRsp);
+      break;
+    case UDF_TASK_TEARDOWN:
+      len += encodeUdfTeardownResponse(buf, &rsp->teardownRsp);
+      break;
+    default:
+      fnError("encode udf response, invalid udf response type %d", rsp->type);
+      break;
+  }
+  return len;
+}
+
+void *decodeUdfResponseBody(const void *buf, SUdfResponse *rsp) {
+  switch (rsp->type) {
+    case UDF_TASK_SETUP:
+      buf = decodeUdfSetupResponse(buf, &rsp->setupRsp);
+      break;
+    case UDF_TASK_CALL:
+      buf = decodeUdfCallResponse(buf, &rsp->callRsp);
+      break;
+    case UDF_TASK_TEARDOWN:
+      buf = decodeUdfTeardownResponse(buf, &rsp->teardownRsp);
+      break;
+    default:
+      fnError("decode udf response, invalid udf response type %d", rsp->type);
+      break;
+  }
+  return (void *)buf;
+}
+
+// the body is left out when it is placed in shared memory
 int32_t encodeUdfResponse(void **buf, const SUdfResponse *rsp) {
   int32_t len = 0;
   if (buf == NULL) {
@@ -692,20 +778,9 @@ int32_t encodeUdfResponse(void **buf, const SUdfResponse *rsp) {
   len += taosEncodeFixedI64(buf, rsp->seqNum);
   len += taosEncodeFixedI8(buf, rsp->type);
   len += taosEncodeFixedI32(buf, rsp->code);
-
-  switch (rsp->type) {
-    case UDF_TASK_SETUP:
-      len += encodeUdfSetupResponse(buf, &rsp->setupRsp);
-      break;
-    case UDF_TASK_CALL:
-      len += encodeUdfCallResponse(buf, &rsp->callRsp);
-      break;
-    case UDF_TASK_TEARDOWN:
-      len += encodeUdfTeardownResponse(buf, &rsp->teardownRsp);
-      break;
-    default:
-      fnError("encode udf response, invalid udf response type %d", rsp->type);
-      break;
+  len += encodeUdfShmInfo(buf, &rsp->shm);
+  if (rsp->shm.bodyLen == 0) {
+    len += encodeUdfResponseBody(buf, rsp);
   }
   return len;
 }
@@ -718,24 +793,252 @@ void *decodeUdfResponse(const void *buf, SUdfResponse *rsp) {
   buf = taosDecodeFixedI64(buf, &rsp->seqNum);
   buf = taosDecodeFixedI8(buf, &rsp->type);
   buf = taosDecodeFixedI32(buf, &rsp->code);
+  buf = decodeUdfShmInfo(buf, &rsp->shm);
+  if (rsp->shm.bodyLen == 0) {
+    buf = decodeUdfResponseBody(buf, rsp);
+  }
+  return (void *)buf;
+}
 
-  switch (rsp->type) {
-    case UDF_TASK_SETUP:
-      buf = decodeUdfSetupResponse(buf, &rsp->setupRsp);
-      break;
-    case UDF_TASK_CALL:
-      buf = decodeUdfCallResponse(buf, &rsp->callRsp);
-      break;
-    case UDF_TASK_TEARDOWN:
-      buf = decodeUdfTeardownResponse(buf, &rsp->teardownRsp);
-      break;
-    default:
-      fnError("decode udf response, invalid udf response type %d", rsp->type);
-      break;
+// In shared memory a block keeps the column buffers as SUdfColumnData holds them, each 8 bytes aligned from the start of
+// the segment, so that udfd maps them in place instead of decoding them. The result column is written back the same way.
+#define UDF_SHM_ALIGN(len) (((len) + 7) & ~7)
+
+typedef struct SUdfShmBlockHdr {
+  int32_t numOfRows;
+  int32_t numOfCols;
+} SUdfShmBlockHdr;
+
+typedef struct SUdfShmColHdr {
+  int8_t  type;
+  int8_t  precision;
+  int8_t  scale;
+  int8_t  hasNull;
+  int32_t bytes;
+  int32_t len1;  // null bitmap of a fixed length column, offsets of a var length one
+  int32_t len2;  // data or payload
+} SUdfShmColHdr;
+
+static int32_t udfShmPut(void **buf, const void *p, int32_t len) {
+  if (buf != NULL) {
+    if (p != NULL) {
+      memcpy(*buf, p, len);
+    } else {
+      memset(*buf, 0, len);
+    }
+    *buf = POINTER_SHIFT(*buf, UDF_SHM_ALIGN(len));
+  }
+  return UDF_SHM_ALIGN(len);
+}
+
+static int32_t udfShmPad(void **buf, int32_t offset) {
+  int32_t pad = UDF_SHM_ALIGN(offset) - offset;
+  if (buf != NULL) *buf = POINTER_SHIFT(*buf, pad);
+  return pad;
+}
+
+static void udfShmGetDataCol(const SColumnInfoData *col, int32_t numOfRows, SUdfShmColHdr *hdr, const void **p1,
+                             const void **p2) {
+  *hdr = (SUdfShmColHdr){.type = col->info.type,
+                         .precision = col->info.precision,
+                         .scale = col->info.scale,
+                         .hasNull = col->hasNull,
+                         .bytes = col->info.bytes,
+                         .len2 = colDataGetLength(col, numOfRows)};
+  if (IS_VAR_DATA_TYPE(col->info.type)) {
+    hdr->len1 = sizeof(int32_t) * numOfRows;
+    *p1 = col->varmeta.offset;
+  } else {
+    hdr->len1 = BitmapLen(numOfRows);
+    *p1 = col->nullbitmap;
+  }
+  *p2 = col->pData;
+}
+
+static void udfShmGetUdfCol(const SUdfColumn *col, SUdfShmColHdr *hdr, const void **p1, const void **p2) {
+  *hdr = (SUdfShmColHdr){.type = col->colMeta.type,
+                         .precision = col->colMeta.precision,
+                         .scale = col->colMeta.scale,
+                         .hasNull = col->hasNull,
+                         .bytes = col->colMeta.bytes};
+  const SUdfColumnData *data = &col->colData;
+  if (IS_VAR_DATA_TYPE(col->colMeta.type)) {
+    hdr->len1 = data->varLenCol.varOffsetsLen;
+    hdr->len2 = data->varLenCol.payloadLen;
+    *p1 = data->varLenCol.varOffsets;
+    *p2 = data->varLenCol.payload;
+  } else {
+    hdr->len1 = data->fixLenCol.nullBitmapLen;
+    hdr->len2 = data->fixLenCol.dataLen;
+    *p1 = data->fixLenCol.nullBitmap;
+    *p2 = data->fixLenCol.data;
+  }
+}
+
+static void udfShmMapCol(const SUdfShmColHdr *hdr, int32_t numOfRows, void *p1, void *p2, SUdfColumn *col) {
+  col->colMeta.type = hdr->type;
+  col->colMeta.precision = hdr->precision;
+  col->colMeta.scale = hdr->scale;
+  col->colMeta.bytes = hdr->bytes;
+  col->hasNull = hdr->hasNull;
+  col->colData.numOfRows = numOfRows;
+  if (IS_VAR_DATA_TYPE(hdr->type)) {
+    col->colData.varLenCol.varOffsetsLen = hdr->len1;
+    col->colData.varLenCol.varOffsets = p1;
+    col->colData.varLenCol.payloadLen = hdr->len2;
+    col->colData.varLenCol.payload = p2;
+  } else {
+    col->colData.fixLenCol.nullBitmapLen = hdr->len1;
+    col->colData.fixLenCol.nullBitmap = p1;
+    col->colData.fixLenCol.dataLen = hdr->len2;
+    col->colData.fixLenCol.data = p2;
+  }
+}
+
+// offset is where buf is from the start of the segment
+static int32_t encodeUdfShmBlock(void **buf, int32_t offset, const SSDataBlock *block) {
+  int32_t         len = udfShmPad(buf, offset);
+  SUdfShmColHdr   hdr = {0};
+  const void     *p1 = NULL, *p2 = NULL;
+  SUdfShmBlockHdr blockHdr = {.numOfRows = block->info.rows, .numOfCols = taosArrayGetSize(block->pDataBlock)};
+
+  len += udfShmPut(buf, &blockHdr, sizeof(blockHdr));
+  for (int32_t i = 0; i < blockHdr.numOfCols; ++i) {
+    udfShmGetDataCol(taosArrayGet(block->pDataBlock, i), blockHdr.numOfRows, &hdr, &p1, &p2);
+    len += udfShmPut(buf, &hdr, sizeof(hdr));
+  }
+  for (int32_t i = 0; i < blockHdr.numOfCols; ++i) {
+    udfShmGetDataCol(taosArrayGet(block->pDataBlock, i), blockHdr.numOfRows, &hdr, &p1, &p2);
+    len += udfShmPut(buf, p1, hdr.len1);
+    len += udfShmPut(buf, p2, hdr.len2);
+  }
+  return len;
+}
+
+static int32_t encodeUdfShmColumn(void **buf, int32_t offset, const SUdfColumn *col) {
+  int32_t         len = udfShmPad(buf, offset);
+  SUdfShmColHdr   hdr = {0};
+  const void     *p1 = NULL, *p2 = NULL;
+  SUdfShmBlockHdr blockHdr = {.numOfRows = col->colData.numOfRows, .numOfCols = 1};
+
+  udfShmGetUdfCol(col, &hdr, &p1, &p2);
+  len += udfShmPut(buf, &blockHdr, sizeof(blockHdr));
+  len += udfShmPut(buf, &hdr, sizeof(hdr));
+  len += udfShmPut(buf, p1, hdr.len1);
+  len += udfShmPut(buf, p2, hdr.len2);
+  return len;
+}
+
+// the columns of udfBlock point into buf, free it by freeUdfShmDataBlock
+static void *mapUdfShmBlock(const void *buf, int32_t offset, SUdfDataBlock *udfBlock) {
+  buf = POINTER_SHIFT(buf, UDF_SHM_ALIGN(offset) - offset);
+  const SUdfShmBlockHdr *blockHdr = buf;
+  const SUdfShmColHdr   *aHdr = POINTER_SHIFT(buf, UDF_SHM_ALIGN(sizeof(SUdfShmBlockHdr)));
+  buf = POINTER_SHIFT(aHdr, UDF_SHM_ALIGN(sizeof(SUdfShmColHdr)) * blockHdr->numOfCols);
+
+  udfBlock->numOfRows = blockHdr->numOfRows;
+  udfBlock->numOfCols = blockHdr->numOfCols;
+  udfBlock->udfCols = taosMemoryCalloc(TMAX(blockHdr->numOfCols, 1), sizeof(SUdfColumn *));
+  SUdfColumn *aCol = taosMemoryCalloc(TMAX(blockHdr->numOfCols, 1), sizeof(SUdfColumn));
+  if (udfBlock->udfCols == NULL || aCol == NULL) {
+    taosMemoryFree(udfBlock->udfCols);
+    taosMemoryFree(aCol);
+    udfBlock->udfCols = NULL;
+    return NULL;
+  }
+  udfBlock->udfCols[0] = aCol;
+
+  for (int32_t i = 0; i < blockHdr->numOfCols; ++i) {
+    const SUdfShmColHdr *hdr = POINTER_SHIFT(aHdr, UDF_SHM_ALIGN(sizeof(SUdfShmColHdr)) * i);
+    void                *p1 = (void *)buf;
+    void                *p2 = POINTER_SHIFT(p1, UDF_SHM_ALIGN(hdr->len1));
+    buf = POINTER_SHIFT(p2, UDF_SHM_ALIGN(hdr->len2));
+    udfBlock->udfCols[i] = aCol + i;
+    udfShmMapCol(hdr, blockHdr->numOfRows, p1, p2, aCol + i);
+  }
+  return (void *)buf;
+}
+
+void freeUdfShmDataBlock(SUdfDataBlock *block) {
+  if (block->udfCols != NULL) {
+    taosMemoryFree(block->udfCols[0]);
+    taosMemoryFree(block->udfCols);
+    block->udfCols = NULL;
+  }
+}
+
+int32_t encodeUdfShmRequestBody(void **buf, const SUdfRequest *request) {
+  const SUdfCallRequest *call = &request->call;
+  if (request->type != UDF_TASK_CALL ||
+      (call->callType != TSDB_UDF_CALL_SCALA_PROC && call->callType != TSDB_UDF_CALL_AGG_PROC)) {
+    return encodeUdfRequestBody(buf, request);
+  }
+
+  int32_t len = 0;
+  len += taosEncodeFixedI64(buf, call->udfHandle);
+  len += taosEncodeFixedI8(buf, call->callType);
+  len += encodeUdfShmBlock(buf, len, &call->block);
+  if (call->callType == TSDB_UDF_CALL_AGG_PROC) {
+    len += encodeUdfInterBuf(buf, &call->interBuf);
+  }
+  return len;
+}
+
+// buf is the start of the segment, the block of a call is mapped to call.input and call.block is left empty
+void *mapUdfShmRequestBody(const void *buf, SUdfRequest *request) {
+  SUdfCallRequest *call = &request->call;
+  const void      *start = buf;
+  if (request->type != UDF_TASK_CALL) {
+    return decodeUdfRequestBody(buf, request);
+  }
+
+  buf = taosDecodeFixedI64(buf, &call->udfHandle);
+  buf = taosDecodeFixedI8(buf, &call->callType);
+  if (call->callType != TSDB_UDF_CALL_SCALA_PROC && call->callType != TSDB_UDF_CALL_AGG_PROC) {
+    return decodeUdfRequestBody(start, request);
+  }
+
+  buf = mapUdfShmBlock(buf, POINTER_DISTANCE(buf, start), &call->input);
+  if (buf == NULL) return NULL;
+  if (call->callType == TSDB_UDF_CALL_AGG_PROC) {
+    buf = decodeUdfInterBuf(buf, &call->interBuf);
   }
   return (void *)buf;
 }
 
+// pResult is the result of a scalar call, written as it is instead of rsp->callRsp.resultData
+int32_t encodeUdfShmResponseBody(void **buf, const SUdfResponse *rsp, const SUdfColumn *pResult) {
+  if (rsp->type != UDF_TASK_CALL || rsp->callRsp.callType != TSDB_UDF_CALL_SCALA_PROC) {
+    return encodeUdfResponseBody(buf, rsp);
+  }
+
+  int32_t len = 0;
+  len += taosEncodeFixedI8(buf, rsp->callRsp.callType);
+  len += encodeUdfShmColumn(buf, len, pResult);
+  return len;
+}
+
+void *decodeUdfShmResponseBody(const void *buf, SUdfResponse *rsp) {
+  const void *start = buf;
+  if (rsp->type != UDF_TASK_CALL) {
+    return decodeUdfResponseBody(buf, rsp);
+  }
+
+  buf = taosDecodeFixedI8(buf, &rsp->callRsp.callType);
+  if (rsp->callRsp.callType != TSDB_UDF_CALL_SCALA_PROC) {
+    return decodeUdfResponseBody(start, rsp);
+  }
+
+  SUdfDataBlock result = {0};
+  buf = mapUdfShmBlock(buf, POINTER_DISTANCE(buf, start), &result);
+  if (buf == NULL) return NULL;
+  if (result.numOfCols == 1) {
+    convertUdfColumnToDataBlock(result.udfCols[0], &rsp->callRsp.resultData);
+  }
+  freeUdfShmDataBlock(&result);
+  return (void *)buf;
+}
+
 void freeUdfColumnData(SUdfColumnData *data, SUdfColumnMeta *meta) {
   if (IS_VAR_DATA_TYPE(meta->type)) {
     taosMemoryFree(data->varLenCol.varOffsets);
@@ -1198,6 +1501,18 @@ int32_t udfcGetUdfTaskResultFromUvTask(SClientUdfTask *task, SClientUvTaskNode *
       void        *buf = decodeUdfResponse(uvTask->rspBuf.base, &rsp);
       assert(uvTask->rspBuf.len == POINTER_DISTANCE(buf, uvTask->rspBuf.base));
       task->errCode = rsp.code;
+      if (rsp.shm.bodyLen > 0) {
+        if (uvTask->shm.shm.ptr == NULL || strcmp(rsp.shm.name, uvTask->shm.name) != 0 ||
+            rsp.shm.bodyLen > uvTask->shm.shm.size) {
+          fnError("udfc invalid shared memory %s in response, seq num: %" PRId64, rsp.shm.name, rsp.seqNum);
+          task->errCode = TSDB_CODE_UDF_INVALID_STATE;
+          taosMemoryFree(uvTask->rspBuf.base);
+          return 0;
+        }
+        if (decodeUdfShmResponseBody(uvTask->shm.shm.ptr, &rsp) == NULL) {
+          task->errCode = TSDB_CODE_OUT_OF_MEMORY;
+        }
+      }
 
       switch (task->type) {
         case UDF_TASK_SETUP: {
@@ -1381,6 +1696,52 @@ void onUdfcPipeConnect(uv_connect_t *connect, int status) {
   uv_sem_post(&uvTask->taskSem);
 }
 
+static int32_t udfcAcquireShm(int32_t size, SUdfcShm *pShm) {
+  SUdfcProxy *udfc = &gUdfcProxy;
+
+  uv_mutex_lock(&udfc->shmMutex);
+  for (int32_t i = 0; i < taosArrayGetSize(udfc->shmPool); ++i) {
+    SUdfcShm *pIdle = taosArrayGet(udfc->shmPool, i);
+    if (pIdle->shm.size >= size) {
+      *pShm = *pIdle;
+      taosArrayRemove(udfc->shmPool, i);
+      uv_mutex_unlock(&udfc->shmMutex);
+      return 0;
+    }
+  }
+  int64_t seq = ++udfc->shmSeq;
+  uv_mutex_unlock(&udfc->shmMutex);
+
+  int64_t shmSize = UDF_SHM_MIN_SIZE;
+  while (shmSize < size) shmSize <<= 1;
+  snprintf(pShm->name, UDF_SHM_NAME_LEN, "%s-%d-%" PRId64, UDF_SHM_PREFIX, taosGetPId(), seq);
+  if (taosCreateShm(&pShm->shm, pShm->name, shmSize) != 0) {
+    fnError("udfc create shared memory %s failed since %s, fall back to pipe", pShm->name, terrstr());
+    memset(pShm, 0, sizeof(SUdfcShm));
+    return -1;
+  }
+  fnDebug("udfc shared memory %s created, size: %" PRId64, pShm->name, shmSize);
+  return 0;
+}
+
+static void udfcReleaseShm(SUdfcShm *pShm, bool reuse) {
+  if (pShm->shm.ptr == NULL) return;
+
+  SUdfcProxy *udfc = &gUdfcProxy;
+  if (reuse) {
+    uv_mutex_lock(&udfc->shmMutex);
+    if (taosArrayGetSize(udfc->shmPool) < UDF_SHM_POOL_SIZE) {
+      taosArrayPush(udfc->shmPool, pShm);
+      uv_mutex_unlock(&udfc->shmMutex);
+      return;
+    }
+    uv_mutex_unlock(&udfc->shmMutex);
+  }
+
+  taosDetachShm(&pShm->shm);
+  taosDropShm(pShm->name);
+}
+
 int32_t udfcInitializeUvTask(SClientUdfTask *task, int8_t uvTaskType, SClientUvTaskNode *uvTask) {
   uvTask->type = uvTaskType;
   uvTask->udfc = task->session->udfc;
@@ -1388,7 +1749,7 @@ int32_t udfcInitializeUvTask(SClientUdfTask *task, int8_t uvTaskType, SClientUvT
   if (uvTaskType == UV_TASK_CONNECT) {
   } else if (uvTaskType == UV_TASK_REQ_RSP) {
     uvTask->pipe = task->session->udfUvPipe;
-    SUdfRequest request;
+    SUdfRequest request = {0};
     request.type = task->type;
     request.seqNum = atomic_fetch_add_64(&gUdfTaskSeqNum, 1);
 
@@ -1404,6 +1765,20 @@ int32_t udfcInitializeUvTask(SClientUdfTask *task, int8_t uvTaskType, SClientUvT
     } else {
       fnError("udfc create uv task, invalid task type : %d", task->type);
     }
+
+#ifndef WINDOWS
+    if (task->type == UDF_TASK_CALL) {
+      int32_t bodyLen = encodeUdfShmRequestBody(NULL, &request);
+      if (bodyLen >= UDF_SHM_MIN_SIZE && udfcAcquireShm(bodyLen, &uvTask->shm) == 0) {
+        void *body = uvTask->shm.shm.ptr;
+        encodeUdfShmRequestBody(&body, &request);
+        tstrncpy(request.shm.name, uvTask->shm.name, UDF_SHM_NAME_LEN);
+        request.shm.size = uvTask->shm.shm.size;
+        request.shm.bodyLen = bodyLen;
+      }
+    }
+#endif
+
     int32_t bufLen = encodeUdfRequest(NULL, &request);
     request.msgLen = bufLen;
     void *bufBegin = taosMemoryMalloc(bufLen);
@@ -1583,6 +1958,9 @@ int32_t udfcOpen() {
     return 0;
   }
   SUdfcProxy *proxy = &gUdfcProxy;
+  // segments of a crashed taosd are never dropped by it
+  int32_t nDrop = taosDropStaleShm(UDF_SHM_PREFIX);
+  if (nDrop > 0) fnInfo("udfc dropped %d stale shared memory segments", nDrop);
   getUdfdPipeName(proxy->udfdPipeName, sizeof(proxy->udfdPipeName));
   proxy->udfcState = UDFC_STATE_STARTNG;
   uv_barrier_init(&proxy->initBarrier, 2);
@@ -1593,6 +1971,8 @@ int32_t udfcOpen() {
   uv_mutex_init(&proxy->udfStubsMutex);
   proxy->udfStubs = taosArrayInit(8, sizeof(SUdfcFuncStub));
   uv_mutex_init(&proxy->udfcUvMutex);
+  uv_mutex_init(&proxy->shmMutex);
+  proxy->shmPool = taosArrayInit(UDF_SHM_POOL_SIZE, sizeof(SUdfcShm));
   fnInfo("udfc initialized") return 0;
 }
 
@@ -1611,6 +1991,14 @@ int32_t udfcClose() {
   taosArrayDestroy(udfc->udfStubs);
   uv_mutex_destroy(&udfc->udfStubsMutex);
   uv_mutex_destroy(&udfc->udfcUvMutex);
+  for (int32_t i = 0; i < taosArrayGetSize(udfc->shmPool); ++i) {
+    SUdfcShm *pShm = taosArrayGet(udfc->shmPool, i);
+    taosDetachShm(&pShm->shm);
+    taosDropShm(pShm->name);
+  }
+  taosArrayDestroy(udfc->shmPool);
+  udfc->shmPool = NULL;
+  uv_mutex_destroy(&udfc->shmMutex);
   udfc->udfcState = UDFC_STATE_INITAL;
   fnInfo("udfc is cleaned up");
   return 0;
@@ -1623,6 +2011,8 @@ int32_t udfcRunUdfUvTask(SClientUdfTask *task, int8_t uvTaskType) {
   udfcInitializeUvTask(task, uvTaskType, uvTask);
   udfcQueueUvTask(uvTask);
   udfcGetUdfTaskResultFromUvTask(task, uvTask);
+  // without a response udfd may still touch the segment
+  udfcReleaseShm(&uvTask->shm, uvTask->rspBuf.base != NULL);
   if (uvTaskType == UV_TASK_CONNECT) {
     task->session->udfUvPipe = uvTask->pipe;
     SClientUvConn *conn = uvTask->pipe->data;
@@ -48,18 +48,31 @@ typedef struct SUdfdContext {
 
 SUdfdContext global;
 
+typedef struct SUdfdShm {
+  char    name[UDF_SHM_NAME_LEN];
+  SShm    shm;
+  int32_t nRef;
+} SUdfdShm;
+
 typedef struct SUdfdUvConn {
   uv_stream_t *client;
   char *       inputBuf;
   int32_t      inputLen;
   int32_t      inputCap;
   int32_t      inputTotal;
+
+  uv_mutex_t shmMutex;
+  SArray *   shms;    // SUdfdShm *, udfc segments kept mapped for the connection, the last used at the end
+  int32_t    nWork;   // requests in process, the connection is freed after the last one
+  bool       closed;
 } SUdfdUvConn;
 
 typedef struct SUvUdfWork {
+  SUdfdUvConn *conn;
   uv_stream_t *client;
   uv_buf_t     input;
   uv_buf_t     output;
+  SUdfdShm *   pShm;  // udfc segment holding the call body, the response body is written back in place
 } SUvUdfWork;
 
 typedef enum { UDF_STATE_INIT = 0, UDF_STATE_LOADING, UDF_STATE_READY, UDF_STATE_UNLOADING } EUdfState;
@@ -147,11 +160,101 @@ static void    udfdCloseWalkCb(uv_handle_t *handle, void *arg);
 static int32_t udfdRun();
 static void    udfdConnectMnodeThreadFunc(void *args);
 
+// udfc reuses its segments, they stay mapped until the connection closes or UDF_SHM_POOL_SIZE others are used
+static SUdfdShm *udfdAcquireShm(SUdfdUvConn *conn, const char *name) {
+  SUdfdShm *pShm = NULL;
+  uv_mutex_lock(&conn->shmMutex);
+  for (int32_t i = 0; i < taosArrayGetSize(conn->shms); ++i) {
+    SUdfdShm *p = *(SUdfdShm **)taosArrayGet(conn->shms, i);
+    if (strcmp(p->name, name) == 0) {
+      taosArrayRemove(conn->shms, i);
+      pShm = p;
+      break;
+    }
+  }
+
+  for (int32_t i = 0; pShm == NULL && i < taosArrayGetSize(conn->shms);) {
+    SUdfdShm *p = *(SUdfdShm **)taosArrayGet(conn->shms, i);
+    if (taosArrayGetSize(conn->shms) < UDF_SHM_POOL_SIZE) break;
+    if (p->nRef > 0) {
+      ++i;
+      continue;
+    }
+    fnDebug("udfd shared memory %s unmapped", p->name);
+    taosArrayRemove(conn->shms, i);
+    taosDetachShm(&p->shm);
+    taosMemoryFree(p);
+  }
+
+  if (pShm == NULL) {
+    pShm = taosMemoryCalloc(1, sizeof(SUdfdShm));
+    if (pShm == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      uv_mutex_unlock(&conn->shmMutex);
+      return NULL;
+    }
+    tstrncpy(pShm->name, name, UDF_SHM_NAME_LEN);
+    if (taosAttachShm(&pShm->shm, name) != 0) {
+      taosMemoryFree(pShm);
+      uv_mutex_unlock(&conn->shmMutex);
+      return NULL;
+    }
+    fnDebug("udfd shared memory %s mapped, size: %" PRId64, name, pShm->shm.size);
+  }
+
+  if (taosArrayPush(conn->shms, &pShm) == NULL) {
+    taosDetachShm(&pShm->shm);
+    taosMemoryFree(pShm);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    uv_mutex_unlock(&conn->shmMutex);
+    return NULL;
+  }
+  pShm->nRef++;
+  uv_mutex_unlock(&conn->shmMutex);
+  return pShm;
+}
+
+static void udfdReleaseShm(SUdfdUvConn *conn, SUdfdShm *pShm) {
+  if (pShm == NULL) return;
+  uv_mutex_lock(&conn->shmMutex);
+  pShm->nRef--;
+  uv_mutex_unlock(&conn->shmMutex);
+}
+
+static void udfdProcessShmFailure(SUvUdfWork *uvUdf, SUdfRequest *request) {
+  fnError("udfd attach shared memory %s failed since %s, seq num %" PRId64, request->shm.name, terrstr(),
+          request->seqNum);
+  SUdfResponse rsp = {0};
+  rsp.seqNum = request->seqNum;
+  rsp.type = request->type;
+  rsp.code = TSDB_CODE_UDF_INVALID_INPUT;
+
+  int32_t len = encodeUdfResponse(NULL, &rsp);
+  rsp.msgLen = len;
+  void *bufBegin = taosMemoryMalloc(len);
+  void *buf = bufBegin;
+  encodeUdfResponse(&buf, &rsp);
+  uvUdf->output = uv_buf_init(bufBegin, len);
+
+  taosMemoryFree(uvUdf->input.base);
+}
+
 void udfdProcessRequest(uv_work_t *req) {
   SUvUdfWork *uvUdf = (SUvUdfWork *)(req->data);
   SUdfRequest request = {0};
   decodeUdfRequest(uvUdf->input.base, &request);
 
+  if (request.shm.bodyLen > 0) {
+    uvUdf->pShm = udfdAcquireShm(uvUdf->conn, request.shm.name);
+    if (uvUdf->pShm == NULL || uvUdf->pShm->shm.size < request.shm.bodyLen ||
+        mapUdfShmRequestBody(uvUdf->pShm->shm.ptr, &request) == NULL) {
+      udfdProcessShmFailure(uvUdf, &request);
+      udfdReleaseShm(uvUdf->conn, uvUdf->pShm);
+      uvUdf->pShm = NULL;
+      return;
+    }
+  }
+
   switch (request.type) {
     case UDF_TASK_SETUP: {
       udfdProcessSetupRequest(uvUdf, &request);
@@ -170,6 +273,9 @@ void udfdProcessRequest(uv_work_t *req) {
       break;
     }
   }
+
+  udfdReleaseShm(uvUdf->conn, uvUdf->pShm);
+  uvUdf->pShm = NULL;
 }
 
 void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
@@ -254,17 +360,20 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   SUdfResponse *    rsp = &response;
   SUdfCallResponse *subRsp = &rsp->callRsp;
 
-  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t    code = TSDB_CODE_SUCCESS;
+  bool       mapped = uvUdf->pShm != NULL;  // the input block is in shared memory and the output is written there as is
+  SUdfColumn output = {0};
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC: {
-      SUdfColumn output = {0};
-
-      SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
-      code = udf->scalarProcFunc(&input, &output);
-      freeUdfDataDataBlock(&input);
-      convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
-      freeUdfColumn(&output);
+      if (mapped) {
+        code = udf->scalarProcFunc(&call->input, &output);
+        freeUdfShmDataBlock(&call->input);
+      } else {
+        SUdfDataBlock input = {0};
+        convertDataBlockToUdfDataBlock(&call->block, &input);
+        code = udf->scalarProcFunc(&input, &output);
+        freeUdfDataDataBlock(&input);
+      }
       break;
     }
     case TSDB_UDF_CALL_AGG_INIT: {
@@ -274,12 +383,17 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
       break;
     }
     case TSDB_UDF_CALL_AGG_PROC: {
-      SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
       SUdfInterBuf outBuf = {.buf = taosMemoryMalloc(udf->bufSize), .bufLen = udf->bufSize, .numOfResult = 0};
-      code = udf->aggProcFunc(&input, &call->interBuf, &outBuf);
+      if (mapped) {
+        code = udf->aggProcFunc(&call->input, &call->interBuf, &outBuf);
+        freeUdfShmDataBlock(&call->input);
+      } else {
+        SUdfDataBlock input = {0};
+        convertDataBlockToUdfDataBlock(&call->block, &input);
+        code = udf->aggProcFunc(&input, &call->interBuf, &outBuf);
+        freeUdfDataDataBlock(&input);
+      }
       freeUdfInterBuf(&call->interBuf);
-      freeUdfDataDataBlock(&input);
       subRsp->resultBuf = outBuf;
 
       break;
@@ -309,6 +423,20 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   rsp->code = code;
   subRsp->callType = call->callType;
 
+  int32_t bodyLen = mapped ? encodeUdfShmResponseBody(NULL, rsp, &output) : 0;
+  if (mapped && bodyLen >= UDF_SHM_MIN_SIZE && bodyLen <= uvUdf->pShm->shm.size) {
+    // the input block is not used any more, overwrite it with the result
+    void *body = uvUdf->pShm->shm.ptr;
+    encodeUdfShmResponseBody(&body, rsp, &output);
+    rsp->shm = request->shm;
+    rsp->shm.bodyLen = bodyLen;
+  } else if (call->callType == TSDB_UDF_CALL_SCALA_PROC) {
+    convertUdfColumnToDataBlock(&output, &subRsp->resultData);
+  }
+  if (call->callType == TSDB_UDF_CALL_SCALA_PROC) {
+    freeUdfColumn(&output);
+  }
+
   int32_t len = encodeUdfResponse(NULL, rsp);
   rsp->msgLen = len;
   void *bufBegin = taosMemoryMalloc(len);
@@ -677,6 +805,19 @@ int32_t udfdCloseClientRpc() {
   return 0;
 }
 
+static void udfdFreeConn(SUdfdUvConn *conn) {
+  for (int32_t i = 0; i < taosArrayGetSize(conn->shms); ++i) {
+    SUdfdShm *pShm = *(SUdfdShm **)taosArrayGet(conn->shms, i);
+    taosDetachShm(&pShm->shm);
+    taosMemoryFree(pShm);
+  }
+  taosArrayDestroy(conn->shms);
+  uv_mutex_destroy(&conn->shmMutex);
+  taosMemoryFree(conn->client);
+  taosMemoryFree(conn->inputBuf);
+  taosMemoryFree(conn);
+}
+
 void udfdOnWrite(uv_write_t *req, int status) {
   SUvUdfWork *work = (SUvUdfWork *)req->data;
   if (status < 0) {
@@ -688,13 +829,21 @@ void udfdOnWrite(uv_write_t *req, int status) {
 }
 
 void udfdSendResponse(uv_work_t *work, int status) {
-  SUvUdfWork *udfWork = (SUvUdfWork *)(work->data);
+  SUvUdfWork  *udfWork = (SUvUdfWork *)(work->data);
+  SUdfdUvConn *conn = udfWork->conn;
+
+  taosMemoryFree(work);
+  conn->nWork--;
+  if (conn->closed) {
+    taosMemoryFree(udfWork->output.base);
+    taosMemoryFree(udfWork);
+    if (conn->nWork == 0) udfdFreeConn(conn);
+    return;
+  }
 
   uv_write_t *write_req = taosMemoryMalloc(sizeof(uv_write_t));
   write_req->data = udfWork;
   uv_write(write_req, udfWork->client, &udfWork->output, 1, udfdOnWrite);
-
-  taosMemoryFree(work);
 }
 
 void udfdAllocBuffer(uv_handle_t *handle, size_t suggestedSize, uv_buf_t *buf) {
@@ -743,8 +892,10 @@ bool isUdfdUvMsgComplete(SUdfdUvConn *pipe) {
 
 void udfdHandleRequest(SUdfdUvConn *conn) {
   uv_work_t * work = taosMemoryMalloc(sizeof(uv_work_t));
-  SUvUdfWork *udfWork = taosMemoryMalloc(sizeof(SUvUdfWork));
+  SUvUdfWork *udfWork = taosMemoryCalloc(1, sizeof(SUvUdfWork));
+  udfWork->conn = conn;
   udfWork->client = conn->client;
+  conn->nWork++;
   udfWork->input = uv_buf_init(conn->inputBuf, conn->inputLen);
   conn->inputBuf = NULL;
   conn->inputLen = 0;
@@ -756,9 +907,10 @@ void udfdHandleRequest(SUdfdUvConn *conn) {
 
 void udfdPipeCloseCb(uv_handle_t *pipe) {
   SUdfdUvConn *conn = pipe->data;
-  taosMemoryFree(conn->client);
-  taosMemoryFree(conn->inputBuf);
-  taosMemoryFree(conn);
+  conn->closed = true;
+  if (conn->nWork == 0) {
+    udfdFreeConn(conn);
+  }
 }
 
 void udfdPipeRead(uv_stream_t *client, ssize_t nread, const uv_buf_t *buf) {
@@ -796,11 +948,13 @@ void udfdOnNewConnection(uv_stream_t *server, int status) {
   uv_pipe_t *client = (uv_pipe_t *)taosMemoryMalloc(sizeof(uv_pipe_t));
   uv_pipe_init(global.loop, client, 0);
   if (uv_accept(server, (uv_stream_t *)client) == 0) {
-    SUdfdUvConn *ctx = taosMemoryMalloc(sizeof(SUdfdUvConn));
+    SUdfdUvConn *ctx = taosMemoryCalloc(1, sizeof(SUdfdUvConn));
     ctx->client = (uv_stream_t *)client;
     ctx->inputBuf = 0;
     ctx->inputLen = 0;
     ctx->inputCap = 0;
+    ctx->shms = taosArrayInit(UDF_SHM_POOL_SIZE, POINTER_BYTES);
+    uv_mutex_init(&ctx->shmMutex);
     client->data = ctx;
     ctx->client = (uv_stream_t *)client;
     uv_read_start((uv_stream_t *)client, udfdAllocBuffer, udfdPipeRead);
@@ -1025,6 +1179,10 @@ int main(int argc, char *argv[]) {
     return -2;
   }
 
+  // a taosd that crashed together with udfd left its segments behind
+  int32_t nDrop = taosDropStaleShm(UDF_SHM_PREFIX);
+  if (nDrop > 0) fnInfo("udfd dropped %d stale shared memory segments", nDrop);
+
   initEpSetFromCfg(tsFirst, tsSecond, &global.mgmtEp);
   if (udfdOpenClientRpc() != 0) {
     fnError("open rpc connection to mnode failure");
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include "tdatablock.h"
+#include "tudf.h"
+#include "tudfInt.h"
+
+#define ROWS 20000
+
+class UdfShmTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    snprintf(name, sizeof(name), "/taosudftest-%d-%d", taosGetPId(), seq++);
+    memset(&owner, 0, sizeof(owner));
+    memset(&peer, 0, sizeof(peer));
+
+    pBlock = createDataBlock();
+    SColumnInfoData intCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+    SColumnInfoData strCol = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 20 + VARSTR_HEADER_SIZE, 2);
+    blockDataAppendColInfo(pBlock, &intCol);
+    blockDataAppendColInfo(pBlock, &strCol);
+    ASSERT_EQ(blockDataEnsureCapacity(pBlock, ROWS), 0);
+
+    SColumnInfoData *pInt = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pStr = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    char             str[32] = {0};
+    for (int32_t i = 0; i < ROWS; ++i) {
+      if (i % 7 == 0) {
+        colDataAppendNULL(pInt, i);
+      } else {
+        colDataAppend(pInt, i, (const char *)&i, false);
+      }
+      varDataSetLen(str, sprintf(varDataVal(str), "s%d", i));
+      colDataAppend(pStr, i, str, false);
+    }
+    pBlock->info.rows = ROWS;
+  }
+
+  void TearDown() override {
+    blockDataDestroy(pBlock);
+    taosDetachShm(&peer);
+    taosDetachShm(&owner);
+    taosDropShm(name);
+  }
+
+  // the segment as udfc creates it and as udfd maps it
+  void share(int32_t size) {
+    ASSERT_EQ(taosCreateShm(&owner, name, size), 0);
+    ASSERT_EQ(taosAttachShm(&peer, name), 0);
+    ASSERT_GE(peer.size, size);
+  }
+
+  bool inPeer(const void *p) {
+    return (const char *)p >= (const char *)peer.ptr && (const char *)p < (const char *)peer.ptr + peer.size;
+  }
+
+  static int32_t seq;
+  char           name[UDF_SHM_NAME_LEN];
+  SShm           owner;
+  SShm           peer;
+  SSDataBlock   *pBlock;
+};
+
+int32_t UdfShmTest::seq = 1;
+
+TEST_F(UdfShmTest, scalarCall) {
+  SUdfRequest req = {0};
+  req.type = UDF_TASK_CALL;
+  req.call.udfHandle = 0x1234;
+  req.call.callType = TSDB_UDF_CALL_SCALA_PROC;
+  req.call.block = *pBlock;
+
+  int32_t bodyLen = encodeUdfShmRequestBody(NULL, &req);
+  ASSERT_GE(bodyLen, UDF_SHM_MIN_SIZE);
+  share(bodyLen);
+  void *body = owner.ptr;
+  ASSERT_EQ(encodeUdfShmRequestBody(&body, &req), bodyLen);
+  EXPECT_EQ(POINTER_DISTANCE(body, owner.ptr), bodyLen);
+
+  // the columns are used where they are in the segment
+  SUdfRequest mapped = {0};
+  mapped.type = UDF_TASK_CALL;
+  ASSERT_EQ(POINTER_DISTANCE(mapUdfShmRequestBody(peer.ptr, &mapped), peer.ptr), bodyLen);
+  EXPECT_EQ(mapped.call.udfHandle, 0x1234);
+  EXPECT_EQ(mapped.call.callType, TSDB_UDF_CALL_SCALA_PROC);
+  EXPECT_EQ(mapped.call.block.pDataBlock, nullptr);
+
+  SUdfDataBlock *input = &mapped.call.input;
+  ASSERT_EQ(input->numOfRows, ROWS);
+  ASSERT_EQ(input->numOfCols, 2);
+  SUdfColumn *pInt = input->udfCols[0];
+  SUdfColumn *pStr = input->udfCols[1];
+  EXPECT_EQ(pInt->colMeta.type, TSDB_DATA_TYPE_INT);
+  EXPECT_TRUE(pInt->hasNull);
+  EXPECT_TRUE(inPeer(pInt->colData.fixLenCol.data));
+  EXPECT_TRUE(inPeer(pStr->colData.varLenCol.payload));
+  EXPECT_EQ((uintptr_t)pInt->colData.fixLenCol.data % 8, 0);
+  EXPECT_EQ((uintptr_t)pStr->colData.varLenCol.varOffsets % 8, 0);
+  for (int32_t i = 0; i < ROWS; ++i) {
+    EXPECT_EQ(udfColDataIsNull(pInt, i), i % 7 == 0);
+    if (i % 7 != 0) EXPECT_EQ(*(int32_t *)udfColDataGetData(pInt, i), i);
+
+    char *str = udfColDataGetData(pStr, i);
+    char  expect[32] = {0};
+    int32_t len = sprintf(expect, "s%d", i);
+    ASSERT_EQ(varDataLen(str), len);
+    EXPECT_EQ(memcmp(varDataVal(str), expect, len), 0);
+  }
+
+  // the result column is written over the input and read back by udfc
+  SUdfColumn result = {0};
+  result.colMeta.type = TSDB_DATA_TYPE_BIGINT;
+  result.colMeta.bytes = sizeof(int64_t);
+  udfColEnsureCapacity(&result, ROWS);
+  result.colData.numOfRows = ROWS;
+  for (int32_t i = 0; i < ROWS; ++i) {
+    int64_t v = *(int32_t *)udfColDataGetData(pInt, i) * 2LL;
+    udfColDataSet(&result, i, (const char *)&v, udfColDataIsNull(pInt, i));
+  }
+  freeUdfShmDataBlock(input);
+
+  SUdfResponse rsp = {0};
+  rsp.type = UDF_TASK_CALL;
+  rsp.callRsp.callType = TSDB_UDF_CALL_SCALA_PROC;
+  int32_t rspLen = encodeUdfShmResponseBody(NULL, &rsp, &result);
+  ASSERT_LE(rspLen, peer.size);
+  body = peer.ptr;
+  ASSERT_EQ(encodeUdfShmResponseBody(&body, &rsp, &result), rspLen);
+  freeUdfColumn(&result);
+
+  SUdfResponse decoded = {0};
+  decoded.type = UDF_TASK_CALL;
+  ASSERT_EQ(POINTER_DISTANCE(decodeUdfShmResponseBody(owner.ptr, &decoded), owner.ptr), rspLen);
+  ASSERT_EQ(decoded.callRsp.resultData.info.rows, ROWS);
+  ASSERT_EQ(taosArrayGetSize(decoded.callRsp.resultData.pDataBlock), 1);
+  SColumnInfoData *pRes = (SColumnInfoData *)taosArrayGet(decoded.callRsp.resultData.pDataBlock, 0);
+  EXPECT_FALSE(inPeer(pRes->pData));
+  for (int32_t i = 0; i < ROWS; ++i) {
+    EXPECT_EQ(colDataIsNull_f(pRes->nullbitmap, i), i % 7 == 0);
+    if (i % 7 != 0) EXPECT_EQ(*(int64_t *)colDataGetData(pRes, i), i * 2LL);
+  }
+  blockDataFreeRes(&decoded.callRsp.resultData);
+}
+
+TEST_F(UdfShmTest, aggCall) {
+  char        state[16] = "agg state";
+  SUdfRequest req = {0};
+  req.type = UDF_TASK_CALL;
+  req.call.callType = TSDB_UDF_CALL_AGG_PROC;
+  req.call.block = *pBlock;
+  req.call.interBuf = (SUdfInterBuf){.bufLen = sizeof(state), .buf = state, .numOfResult = 1};
+
+  int32_t bodyLen = encodeUdfShmRequestBody(NULL, &req);
+  share(bodyLen);
+  void *body = owner.ptr;
+  encodeUdfShmRequestBody(&body, &req);
+
+  SUdfRequest mapped = {0};
+  mapped.type = UDF_TASK_CALL;
+  ASSERT_EQ(POINTER_DISTANCE(mapUdfShmRequestBody(peer.ptr, &mapped), peer.ptr), bodyLen);
+  EXPECT_EQ(mapped.call.input.numOfRows, ROWS);
+  EXPECT_EQ(mapped.call.interBuf.numOfResult, 1);
+  ASSERT_EQ(mapped.call.interBuf.bufLen, sizeof(state));
+  EXPECT_STREQ(mapped.call.interBuf.buf, state);
+  freeUdfInterBuf(&mapped.call.interBuf);
+  freeUdfShmDataBlock(&mapped.call.input);
+
+  // the agg results are encoded as in the pipe
+  SUdfResponse rsp = {0};
+  rsp.type = UDF_TASK_CALL;
+  rsp.callRsp.callType = TSDB_UDF_CALL_AGG_PROC;
+  rsp.callRsp.resultBuf = req.call.interBuf;
+  body = peer.ptr;
+  int32_t rspLen = encodeUdfShmResponseBody(&body, &rsp, NULL);
+  EXPECT_EQ(rspLen, encodeUdfResponseBody(NULL, &rsp));
+
+  SUdfResponse decoded = {0};
+  decoded.type = UDF_TASK_CALL;
+  ASSERT_EQ(POINTER_DISTANCE(decodeUdfShmResponseBody(owner.ptr, &decoded), owner.ptr), rspLen);
+  EXPECT_EQ(decoded.callRsp.callType, TSDB_UDF_CALL_AGG_PROC);
+  EXPECT_STREQ(decoded.callRsp.resultBuf.buf, state);
+  freeUdfInterBuf(&decoded.callRsp.resultBuf);
+}
@@ -395,6 +395,21 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch", pStat->numOfBatchInsertReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
+  tjsonAddDoubleToObject(pJson, "write_stall_commit", pStat->numOfCommitStalls);
+  tjsonAddDoubleToObject(pJson, "write_stall_commit_us", pStat->commitStallTimeUs);
+  tjsonAddDoubleToObject(pJson, "write_stall_buffer", pStat->numOfBufferStalls);
+  tjsonAddDoubleToObject(pJson, "write_stall_buffer_us", pStat->bufferStallTimeUs);
+
+  static const char *ioClassNames[VND_IO_MAX] = {"commit", "compact", "migrate", "snapshot"};
+  for (int32_t i = 0; i < VND_IO_MAX; ++i) {
+    char name[64];
+    snprintf(name, sizeof(name), "io_%s_rate", ioClassNames[i]);
+    tjsonAddDoubleToObject(pJson, name, pStat->ioStat[i].bytes / interval);
+    snprintf(name, sizeof(name), "io_%s_wait_us", ioClassNames[i]);
+    tjsonAddDoubleToObject(pJson, name, pStat->ioStat[i].waitUs);
+    snprintf(name, sizeof(name), "io_%s_queued", ioClassNames[i]);
+    tjsonAddDoubleToObject(pJson, name, pStat->ioStat[i].queued);
+  }
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
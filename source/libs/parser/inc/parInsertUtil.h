@@ -138,6 +138,9 @@ typedef struct STableDataBlocks {
   int32_t            createTbReqLen;
   SParsedDataColInfo boundColumnInfo;
   SRowBuilder        rowBuilder;
+  SColData          *aColData;  // column-major rows of stmt and schemaless, one per schema column, pData then only
+                                // holds the SSubmitBlk head
+  uint8_t           *pColBuf;   // nchar conversion buffer of aColData
 } STableDataBlocks;
 
 int32_t insGetExtendedRowSize(STableDataBlocks *pBlock);
@@ -152,7 +155,7 @@ int32_t insInitRowBuilder(SRowBuilder *pBuilder, int16_t schemaVer, SParsedDataC
 int32_t insGetDataBlockFromList(SHashObj *pHashList, void *id, int32_t idLen, int32_t size, int32_t startOffset,
                                 int32_t rowSize, STableMeta *pTableMeta, STableDataBlocks **dataBlocks,
                                 SArray *pBlockList, SVCreateTbReq *pCreateTbReq);
-int32_t insMergeTableDataBlocks(SHashObj *pHashObj, SArray **pVgDataBlocks);
+int32_t insMergeTableDataBlocks(SHashObj *pHashObj, bool colFmt, SArray **pVgDataBlocks);
 int32_t insBuildCreateTbMsg(STableDataBlocks *pBlocks, SVCreateTbReq *pCreateTbReq);
 int32_t insAllocateMemForSize(STableDataBlocks *pDataBlock, int32_t allSize);
 int32_t insCreateSName(SName *pName, struct SToken *pTableName, int32_t acctId, const char *dbName, SMsgBuf *pMsgBuf);
@@ -161,7 +164,15 @@ void    insBuildCreateTbReq(SVCreateTbReq *pTbReq, const char *tname, STag *pTag
                             SArray *tagName, uint8_t tagNum);
 int32_t insMemRowAppend(SMsgBuf *pMsgBuf, const void *value, int32_t len, void *param);
 int32_t insCheckTimestamp(STableDataBlocks *pDataBlocks, const char *start);
+void    insCheckTimestampBatch(STableDataBlocks *pDataBlocks, const TSKEY *pKeys, int32_t nRows);
 int32_t insBuildOutput(SInsertParseContext *pCxt);
 void    insDestroyDataBlock(STableDataBlocks *pDataBlock);
+int32_t insInitColData(STableDataBlocks *pDataBlock);
+void    insClearColData(STableDataBlocks *pDataBlock);
+void    insDestroyColData(STableDataBlocks *pDataBlock);
+int32_t insColDataAppend(SMsgBuf *pMsgBuf, STableDataBlocks *pDataBlock, col_id_t schemaIdx, const void *value,
+                         int32_t len);
+int32_t insColDataAppendNone(STableDataBlocks *pDataBlock, col_id_t schemaIdx, int32_t nRows);
+void    insColDataRollback(STableDataBlocks *pDataBlock, int32_t nRows);
 
 #endif  // TDENGINE_PAR_INSERT_UTIL_H
@@ -252,25 +252,18 @@ int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols
     buildInvalidOperationMsg(&pBuf, "bound cols error");
     return ret;
   }
-  int32_t             extendedRowSize = insGetExtendedRowSize(pDataBlock);
   SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
-  SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
-  SMemParam           param = {.rb = pBuilder};
-
-  insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo);
 
   int32_t rowNum = taosArrayGetSize(cols);
   if (rowNum <= 0) {
     return buildInvalidOperationMsg(&pBuf, "cols size <= 0");
   }
-  ret = insAllocateMemForSize(pDataBlock, extendedRowSize * rowNum);
+  ret = insInitColData(pDataBlock);
   if (ret != TSDB_CODE_SUCCESS) {
     buildInvalidOperationMsg(&pBuf, "allocate memory error");
     return ret;
   }
   for (int32_t r = 0; r < rowNum; ++r) {
-    STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size);  // skip the SSubmitBlk header
-    tdSRowResetBuf(pBuilder, row);
     void*  rowData = taosArrayGetP(cols, r);
     size_t rowDataSize = 0;
     if (format) {
@@ -279,10 +272,8 @@ int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols
 
     // 1. set the parsed value from sql string
     for (int c = 0, j = 0; c < spd->numOfBound; ++c) {
-      SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
-
-      param.schema = pColSchema;
-      insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
+      col_id_t schemaIdx = spd->boundColumns[c];
+      SSchema* pColSchema = &pSchema[schemaIdx];
 
       SSmlKv* kv = NULL;
       if (format) {
@@ -307,29 +298,32 @@ int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols
           kv->i = convertTimePrecision(kv->i, TSDB_TIME_PRECISION_NANO, pTableMeta->tableInfo.precision);
           //          uError("SML:data after:%" PRId64 ", precision:%d", kv->i, pTableMeta->tableInfo.precision);
         }
+        if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
+          insCheckTimestamp(pDataBlock, (const char*)&kv->i);
+        }
 
         if (IS_VAR_DATA_TYPE(kv->type)) {
-          insMemRowAppend(&pBuf, kv->value, colLen, &param);
+          ret = insColDataAppend(&pBuf, pDataBlock, schemaIdx, kv->value, colLen);
         } else {
-          insMemRowAppend(&pBuf, &(kv->value), colLen, &param);
+          ret = insColDataAppend(&pBuf, pDataBlock, schemaIdx, &(kv->value), colLen);
         }
       } else {
-        pBuilder->hasNone = true;
+        ret = insColDataAppendNone(pDataBlock, schemaIdx, 1);
       }
-
-      if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
-        TSKEY tsKey = TD_ROW_KEY(row);
-        insCheckTimestamp(pDataBlock, (const char*)&tsKey);
+      if (ret != TSDB_CODE_SUCCESS) {
+        return ret;
       }
     }
 
-    // set the null value for the columns that do not assign values
-    if ((spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW(row)) {
-      pBuilder->hasNone = true;
+    // set the none value for the columns that do not assign values
+    for (int c = 0; c < spd->numOfCols && spd->numOfBound < spd->numOfCols; ++c) {
+      if (spd->cols[c].valStat == VAL_STAT_NONE) {
+        ret = insColDataAppendNone(pDataBlock, c, 1);
+        if (ret != TSDB_CODE_SUCCESS) {
+          return ret;
+        }
+      }
     }
-
-    tdSRowEnd(pBuilder);
-    pDataBlock->size += extendedRowSize;
   }
 
   SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
@@ -357,7 +351,7 @@ void smlDestroyHandle(void* pHandle) {
   taosMemoryFree(handle);
 }
 
-int32_t smlBuildOutput(void* handle, SHashObj* pVgHash) {
+int32_t smlBuildOutput(void* handle, SHashObj* pVgHash, bool colFmt) {
   SSmlExecHandle* smlHandle = (SSmlExecHandle*)handle;
-  return qBuildStmtOutput(smlHandle->pQuery, pVgHash, smlHandle->pBlockHash);
+  return qBuildStmtOutput(smlHandle->pQuery, pVgHash, smlHandle->pBlockHash, colFmt);
 }
@@ -16,6 +16,7 @@
 #include "parInsertUtil.h"
 #include "parToken.h"
 #include "tglobal.h"
+#include "tworker.h"
 #include "ttime.h"
 
 #define NEXT_TOKEN_WITH_PREV(pSql, sToken)     \
@@ -1080,18 +1081,76 @@ static int32_t parseValuesClause(SInsertParseContext* pCxt, STableDataBlocks* da
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataBlocks* pDataBlock, int maxRows,
-                            int32_t* numOfRows) {
-  STableComInfo tinfo = getTableInfo(pDataBlock->pTableMeta);
-  int32_t       extendedRowSize = insGetExtendedRowSize(pDataBlock);
-  CHECK_CODE(
-      insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
+#define CSV_PARSE_MIN_ROWS_PER_THREAD 1024
+#define CSV_PARSE_ROWS_PER_THREAD     8192
+
+typedef struct SCsvLines {
+  char*    pBuf;
+  int64_t  len;
+  int64_t  cap;
+  int64_t* pOffset;  // offset of each line in pBuf
+  int32_t  num;
+  int32_t  capNum;
+} SCsvLines;
+
+typedef struct SCsvParseTask {
+  SInsertParseContext cxt;
+  STableDataBlocks    dataBlock;  // shares pData with the target data block, rows are written from dataBlock.size
+  SCsvLines*          pLines;
+  int32_t             startLine;
+  int32_t             numOfLines;
+  int32_t             numOfRows;
+  int16_t             timePrec;
+  int8_t              started;  // claimed by the calling thread or by a csv parse worker
+  tsem_t*             pDone;    // posted by a worker for every task queued to it, run or not
+  int32_t             code;
+} SCsvParseTask;
+
+// long-lived threads shared by all the csv files parsed in the process, created on first use
+static SSingleWorker csvParseWorker = {0};
+static TdThreadOnce  csvParseWorkerOnce = PTHREAD_ONCE_INIT;
+
+static void destroyCsvLines(SCsvLines* pLines) {
+  taosMemoryFreeClear(pLines->pBuf);
+  taosMemoryFreeClear(pLines->pOffset);
+}
 
-  (*numOfRows) = 0;
-  char    tmpTokenBuf[TSDB_MAX_BYTES_PER_ROW] = {0};  // used for deleting Escape character: \\, \', \"
+static int32_t appendCsvLine(SCsvLines* pLines, const char* pLine, int64_t len) {
+  if (pLines->num >= pLines->capNum) {
+    int32_t  capNum = TMAX(pLines->capNum * 2, CSV_PARSE_ROWS_PER_THREAD);
+    int64_t* pOffset = taosMemoryRealloc(pLines->pOffset, capNum * sizeof(int64_t));
+    if (NULL == pOffset) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pLines->pOffset = pOffset;
+    pLines->capNum = capNum;
+  }
+  if (pLines->len + len + 1 > pLines->cap) {
+    int64_t cap = TMAX(pLines->cap * 2, pLines->len + len + 1);
+    char*   pBuf = taosMemoryRealloc(pLines->pBuf, cap);
+    if (NULL == pBuf) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pLines->pBuf = pBuf;
+    pLines->cap = cap;
+  }
+
+  pLines->pOffset[pLines->num++] = pLines->len;
+  memcpy(pLines->pBuf + pLines->len, pLine, len);
+  pLines->len += len;
+  pLines->pBuf[pLines->len++] = '\0';
+  return TSDB_CODE_SUCCESS;
+}
+
+// read at most maxLines non-empty lines
+static int32_t readCsvLines(TdFilePtr fp, SCsvLines* pLines, int32_t maxLines) {
+  pLines->len = 0;
+  pLines->num = 0;
+
+  int32_t code = TSDB_CODE_SUCCESS;
   char*   pLine = NULL;
   int64_t readLen = 0;
-  while ((readLen = taosGetLineFile(fp, &pLine)) != -1) {
+  while (pLines->num < maxLines && (readLen = taosGetLineFile(fp, &pLine)) != -1) {
     if (('\r' == pLine[readLen - 1]) || ('\n' == pLine[readLen - 1])) {
       pLine[--readLen] = '\0';
     }
@@ -1100,32 +1159,210 @@ static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataB
       continue;
     }
 
-    if ((*numOfRows) >= maxRows || pDataBlock->size + extendedRowSize >= pDataBlock->nAllocSize) {
-      int32_t tSize;
-      CHECK_CODE(allocateMemIfNeed(pDataBlock, extendedRowSize, &tSize));
-      ASSERT(tSize >= maxRows);
-      maxRows = tSize;
+    code = appendCsvLine(pLines, pLine, readLen);
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
     }
+  }
+  taosMemoryFree(pLine);
+  return code;
+}
 
+static int32_t parseCsvLines(SCsvParseTask* pTask) {
+  STableDataBlocks* pDataBlock = &pTask->dataBlock;
+  int32_t           extendedRowSize = insGetExtendedRowSize(pDataBlock);
+  for (int32_t i = 0; i < pTask->numOfLines; ++i) {
+    char* pLine = pTask->pLines->pBuf + pTask->pLines->pOffset[pTask->startLine + i];
     strtolower(pLine, pLine);
-    char* pRawSql = pCxt->pSql;
-    pCxt->pSql = pLine;
-    bool    gotRow = false;
-    int32_t code = parseOneRow(pCxt, pDataBlock, tinfo.precision, &gotRow, tmpTokenBuf);
-    if (TSDB_CODE_SUCCESS != code) {
-      pCxt->pSql = pRawSql;
-      return code;
-    }
+    pTask->cxt.pSql = pLine;
+    bool gotRow = false;
+    CHECK_CODE(parseOneRow(&pTask->cxt, pDataBlock, pTask->timePrec, &gotRow, pTask->cxt.tmpTokenBuf));
     if (gotRow) {
       pDataBlock->size += extendedRowSize;  // len;
-      (*numOfRows)++;
+      pTask->numOfRows++;
     }
-    pCxt->pSql = pRawSql;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void runCsvParseTask(SCsvParseTask* pTask) {
+  if (0 == atomic_val_compare_exchange_8(&pTask->started, 0, 1)) {
+    pTask->code = parseCsvLines(pTask);
+  }
+}
+
+static void parseCsvLinesInQueue(SQueueInfo* pInfo, void* pItem) {
+  SCsvParseTask* pTask = *(SCsvParseTask**)pItem;
+  tsem_t*        pDone = pTask->pDone;
+  runCsvParseTask(pTask);
+  taosFreeQitem(pItem);
+  tsem_post(pDone);
+}
+
+static void initCsvParseWorker() {
+  // the calling thread parses a range too
+  int32_t num = tsNumOfCsvParseThreads - 1;
+  if (num <= 0) {
+    return;
+  }
+  SSingleWorkerCfg cfg = {.name = "csv-parse", .min = num, .max = num, .fp = parseCsvLinesInQueue};
+  if (tSingleWorkerInit(&csvParseWorker, &cfg) != 0) {
+    parserError("failed to init csv parse worker since %s", terrstr());
+    csvParseWorker.queue = NULL;
+  }
+}
 
-    if (pDataBlock->nAllocSize > tsMaxMemUsedByInsert * 1024 * 1024) {
+void insCleanupCsvParseWorker() { tSingleWorkerCleanup(&csvParseWorker); }
+
+/*
+ * The lines are split into consecutive ranges which are parsed by the csv parse workers. Each row takes
+ * extendedRowSize bytes, so every range knows where its rows start in the data block and the rows are written in
+ * place. The calling thread parses the first range and then takes over the ranges no worker has started yet.
+ */
+static int32_t parseCsvLinesParallel(SInsertParseContext* pCxt, STableDataBlocks* pDataBlock, SCsvLines* pLines,
+                                     SCsvParseTask* pTasks, int32_t numOfTasks, int16_t timePrec,
+                                     int32_t* numOfRows) {
+  int32_t extendedRowSize = insGetExtendedRowSize(pDataBlock);
+  int64_t allocSize = (int64_t)(pLines->num + 1) * extendedRowSize;
+  if (pDataBlock->size + allocSize > INT32_MAX) {
+    return buildInvalidOperationMsg(&pCxt->msg, "too many rows in sql, total size of rows should be less than 2GB");
+  }
+  CHECK_CODE(insAllocateMemForSize(pDataBlock, (int32_t)allocSize));
+
+  // rows of a stmt may be skipped, then the ranges can not be laid out in advance
+  if (NULL != pCxt->pStmtCb) {
+    numOfTasks = 1;
+  }
+  numOfTasks = TMIN(numOfTasks, (pLines->num + CSV_PARSE_MIN_ROWS_PER_THREAD - 1) / CSV_PARSE_MIN_ROWS_PER_THREAD);
+  numOfTasks = TMAX(numOfTasks, 1);
+
+  int32_t startLine = 0;
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    SCsvParseTask* pTask = pTasks + i;
+    pTask->dataBlock = *pDataBlock;
+    pTask->dataBlock.size = pDataBlock->size + startLine * extendedRowSize;
+    pTask->dataBlock.ordered = true;
+    pTask->dataBlock.prevTS = INT64_MIN;
+    pTask->pLines = pLines;
+    pTask->startLine = startLine;
+    pTask->numOfLines = pLines->num / numOfTasks + (i < pLines->num % numOfTasks ? 1 : 0);
+    pTask->numOfRows = 0;
+    pTask->timePrec = timePrec;
+    pTask->started = 0;
+    pTask->code = TSDB_CODE_SUCCESS;
+    startLine += pTask->numOfLines;
+  }
+
+  int32_t numOfQueued = 0;
+  if (numOfTasks > 1) {
+    taosThreadOnce(&csvParseWorkerOnce, initCsvParseWorker);
+  }
+  for (int32_t i = 1; i < numOfTasks && NULL != csvParseWorker.queue; ++i) {
+    SCsvParseTask** pItem = taosAllocateQitem(sizeof(SCsvParseTask*), DEF_QITEM);
+    if (NULL == pItem) {
+      break;
+    }
+    *pItem = pTasks + i;
+    taosWriteQitem(csvParseWorker.queue, pItem);
+    ++numOfQueued;
+  }
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    runCsvParseTask(pTasks + i);
+  }
+  // the tasks are reused by the next round, wait until the workers are done with all of them
+  for (int32_t i = 0; i < numOfQueued; ++i) {
+    tsem_wait(pTasks->pDone);
+  }
+
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    SCsvParseTask* pTask = pTasks + i;
+    if (TSDB_CODE_SUCCESS != pTask->code) {
+      memcpy(pCxt->msg.buf, pTask->cxt.msg.buf, pCxt->msg.len);
+      return pTask->code;
+    }
+    if (pTask->numOfRows <= 0) {
+      continue;
+    }
+
+    // the data block stays ordered only if every range is ordered and the ranges do not overlap
+    TSKEY firstTs = TD_ROW_KEY((STSRow*)(pDataBlock->pData + pDataBlock->size));
+    if (pDataBlock->ordered && (!pTask->dataBlock.ordered || firstTs <= pDataBlock->prevTS)) {
+      pDataBlock->ordered = false;
+    }
+    if (pDataBlock->ordered) {
+      pDataBlock->prevTS = pTask->dataBlock.prevTS;
+    }
+    pDataBlock->size += pTask->numOfRows * extendedRowSize;
+    (*numOfRows) += pTask->numOfRows;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t initCsvParseTasks(SInsertParseContext* pCxt, SCsvParseTask** pTasks, int32_t numOfTasks,
+                                 tsem_t* pDone) {
+  *pTasks = taosMemoryCalloc(numOfTasks, sizeof(SCsvParseTask));
+  if (NULL == *pTasks) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    (*pTasks)[i].pDone = pDone;
+    SInsertParseContext* pTaskCxt = &(*pTasks)[i].cxt;
+    pTaskCxt->pComCxt = pCxt->pComCxt;
+    pTaskCxt->pStmtCb = pCxt->pStmtCb;
+    pTaskCxt->pOutput = pCxt->pOutput;
+    pTaskCxt->msg.len = pCxt->msg.len;
+    pTaskCxt->msg.buf = taosMemoryCalloc(1, pCxt->msg.len);
+    if (NULL == pTaskCxt->msg.buf) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void destroyCsvParseTasks(SCsvParseTask* pTasks, int32_t numOfTasks) {
+  if (NULL == pTasks) {
+    return;
+  }
+  for (int32_t i = 0; i < numOfTasks; ++i) {
+    taosMemoryFree(pTasks[i].cxt.msg.buf);
+  }
+  taosMemoryFree(pTasks);
+}
+
+static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataBlocks* pDataBlock,
+                            int32_t* numOfRows) {
+  STableComInfo tinfo = getTableInfo(pDataBlock->pTableMeta);
+  int32_t       extendedRowSize = insGetExtendedRowSize(pDataBlock);
+  CHECK_CODE(
+      insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
+
+  (*numOfRows) = 0;
+  int32_t        numOfTasks = TMAX(tsNumOfCsvParseThreads, 1);
+  int64_t        maxSize = (int64_t)tsMaxMemUsedByInsert * 1024 * 1024;
+  SCsvLines      lines = {0};
+  SCsvParseTask* pTasks = NULL;
+  tsem_t         done;
+  tsem_init(&done, 0, 0);
+  int32_t        code = initCsvParseTasks(pCxt, &pTasks, numOfTasks, &done);
+  while (TSDB_CODE_SUCCESS == code) {
+    // stop reading once the data block is larger than the memory limit of a single submit
+    int64_t maxLines = (maxSize - pDataBlock->size) / extendedRowSize + 1;
+    code = readCsvLines(fp, &lines, (int32_t)TMIN(maxLines, (int64_t)numOfTasks * CSV_PARSE_ROWS_PER_THREAD));
+    if (TSDB_CODE_SUCCESS != code || 0 == lines.num) {
+      break;
+    }
+
+    code = parseCsvLinesParallel(pCxt, pDataBlock, &lines, pTasks, numOfTasks, tinfo.precision, numOfRows);
+    if (pDataBlock->size > maxSize) {
       break;
     }
   }
+  destroyCsvParseTasks(pTasks, numOfTasks);
+  tsem_destroy(&done);
+  destroyCsvLines(&lines);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
 
   if (0 == (*numOfRows) && (!TSDB_QUERY_HAS_TYPE(pCxt->pOutput->insertType, TSDB_QUERY_TYPE_STMT_INSERT))) {
     return buildSyntaxErrMsg(&pCxt->msg, "no any data points", NULL);
@@ -1135,11 +1372,8 @@ static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataB
 
 static int32_t parseDataFromFileAgain(SInsertParseContext* pCxt, int16_t tableNo, const SName* pTableName,
                                       STableDataBlocks* dataBuf) {
-  int32_t maxNumOfRows;
-  CHECK_CODE(allocateMemIfNeed(dataBuf, insGetExtendedRowSize(dataBuf), &maxNumOfRows));
-
   int32_t numOfRows = 0;
-  CHECK_CODE(parseCsvFile(pCxt, pCxt->pComCxt->csvCxt.fp, dataBuf, maxNumOfRows, &numOfRows));
+  CHECK_CODE(parseCsvFile(pCxt, pCxt->pComCxt->csvCxt.fp, dataBuf, &numOfRows));
 
   SSubmitBlk* pBlocks = (SSubmitBlk*)(dataBuf->pData);
   if (TSDB_CODE_SUCCESS != insSetBlockInfo(pBlocks, dataBuf, numOfRows)) {
@@ -1369,7 +1603,7 @@ static int32_t parseInsertBody(SInsertParseContext* pCxt) {
 
   // merge according to vgId
   if (taosHashGetSize(pCxt->pTableBlockHashObj) > 0) {
-    CHECK_CODE(insMergeTableDataBlocks(pCxt->pTableBlockHashObj, &pCxt->pVgDataBlocks));
+    CHECK_CODE(insMergeTableDataBlocks(pCxt->pTableBlockHashObj, false, &pCxt->pVgDataBlocks));
   }
   return insBuildOutput(pCxt);
 }
@@ -1390,7 +1624,7 @@ static int32_t parseInsertBodyAgain(SInsertParseContext* pCxt) {
   parserDebug("0x%" PRIx64 " insert again input rows: %d", pCxt->pComCxt->requestId, pCxt->totalNum);
   // merge according to vgId
   if (taosHashGetSize(pCxt->pTableBlockHashObj) > 0) {
-    CHECK_CODE(insMergeTableDataBlocks(pCxt->pTableBlockHashObj, &pCxt->pVgDataBlocks));
+    CHECK_CODE(insMergeTableDataBlocks(pCxt->pTableBlockHashObj, false, &pCxt->pVgDataBlocks));
   }
   return insBuildOutput(pCxt);
 }
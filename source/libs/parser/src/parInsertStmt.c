@@ -29,7 +29,7 @@ typedef struct SKvParam {
   char     buf[TSDB_MAX_TAGS_LEN];
 } SKvParam;
 
-int32_t qBuildStmtOutput(SQuery* pQuery, SHashObj* pVgHash, SHashObj* pBlockHash) {
+int32_t qBuildStmtOutput(SQuery* pQuery, SHashObj* pVgHash, SHashObj* pBlockHash, bool colFmt) {
   SVnodeModifOpStmt*  modifyNode = (SVnodeModifOpStmt*)pQuery->pRoot;
   int32_t             code = 0;
   SInsertParseContext insertCtx = {
@@ -40,7 +40,7 @@ int32_t qBuildStmtOutput(SQuery* pQuery, SHashObj* pVgHash, SHashObj* pBlockHash
 
   // merge according to vgId
   if (taosHashGetSize(insertCtx.pTableBlockHashObj) > 0) {
-    CHECK_CODE(insMergeTableDataBlocks(insertCtx.pTableBlockHashObj, &insertCtx.pVgDataBlocks));
+    CHECK_CODE(insMergeTableDataBlocks(insertCtx.pTableBlockHashObj, colFmt, &insertCtx.pVgDataBlocks));
   }
 
   CHECK_CODE(insBuildOutput(&insertCtx));
@@ -155,161 +155,131 @@ end:
   return code;
 }
 
-int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
-  STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
-  SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
-  int32_t             extendedRowSize = insGetExtendedRowSize(pDataBlock);
-  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
-  SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
-  SMemParam           param = {.rb = pBuilder};
-  SMsgBuf             pBuf = {.buf = msgBuf, .len = msgBufLen};
-  int32_t             rowNum = bind->num;
+static int32_t bindStmtColValue(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf, col_id_t schemaIdx,
+                                int32_t r) {
+  SSchema* pColSchema = getTableColumnSchema(pDataBlock->pTableMeta) + schemaIdx;
 
-  CHECK_CODE(
-      insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
-
-  CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * bind->num));
-
-  for (int32_t r = 0; r < bind->num; ++r) {
-    STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size);  // skip the SSubmitBlk header
-    tdSRowResetBuf(pBuilder, row);
+  if (bind->is_null && bind->is_null[r]) {
+    if (pColSchema->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      return buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
+    }
 
-    for (int c = 0; c < spd->numOfBound; ++c) {
-      SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+    return insColDataAppend(pBuf, pDataBlock, schemaIdx, NULL, 0);
+  }
 
-      if (bind[c].num != rowNum) {
-        return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
-      }
+  if (bind->buffer_type != pColSchema->type) {
+    return buildInvalidOperationMsg(pBuf, "column type mis-match with buffer type");
+  }
 
-      param.schema = pColSchema;
-      insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
+  int32_t colLen = pColSchema->bytes;
+  if (IS_VAR_DATA_TYPE(pColSchema->type)) {
+    colLen = bind->length[r];
+  }
 
-      if (bind[c].is_null && bind[c].is_null[r]) {
-        if (pColSchema->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
-          return buildInvalidOperationMsg(&pBuf, "primary timestamp should not be NULL");
-        }
+  char* value = (char*)bind->buffer + bind->buffer_length * r;
+  if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
+    insCheckTimestamp(pDataBlock, value);
+  }
 
-        CHECK_CODE(insMemRowAppend(&pBuf, NULL, 0, &param));
-      } else {
-        if (bind[c].buffer_type != pColSchema->type) {
-          return buildInvalidOperationMsg(&pBuf, "column type mis-match with buffer type");
-        }
+  return insColDataAppend(pBuf, pDataBlock, schemaIdx, value, colLen);
+}
 
-        int32_t colLen = pColSchema->bytes;
-        if (IS_VAR_DATA_TYPE(pColSchema->type)) {
-          colLen = bind[c].length[r];
-        }
+// A fixed-size column whose buffer holds the values back to back is copied into aColData as a whole, anything else
+// is bound row by row.
+static int32_t bindStmtColumn(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf, col_id_t schemaIdx,
+                              int32_t rowNum) {
+  SSchema* pColSchema = getTableColumnSchema(pDataBlock->pTableMeta) + schemaIdx;
 
-        CHECK_CODE(insMemRowAppend(&pBuf, (char*)bind[c].buffer + bind[c].buffer_length * r, colLen, &param));
-      }
+  if (IS_VAR_DATA_TYPE(pColSchema->type) || bind->buffer_type != pColSchema->type ||
+      bind->buffer_length != pColSchema->bytes) {
+    for (int32_t r = 0; r < rowNum; ++r) {
+      CHECK_CODE(bindStmtColValue(pDataBlock, bind, pBuf, schemaIdx, r));
+    }
+    return TSDB_CODE_SUCCESS;
+  }
 
-      if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
-        TSKEY tsKey = TD_ROW_KEY(row);
-        insCheckTimestamp(pDataBlock, (const char*)&tsKey);
+  if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
+    for (int32_t r = 0; bind->is_null && r < rowNum; ++r) {
+      if (bind->is_null[r]) {
+        return buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
       }
     }
-    // set the null value for the columns that do not assign values
-    if ((spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW(row)) {
-      pBuilder->hasNone = true;
-    }
-    tdSRowEnd(pBuilder);
-#ifdef TD_DEBUG_PRINT_ROW
-    STSchema* pSTSchema = tdGetSTSChemaFromSSChema(pSchema, spd->numOfCols, 1);
-    tdSRowPrint(row, pSTSchema, __func__);
-    taosMemoryFree(pSTSchema);
-#endif
-    pDataBlock->size += extendedRowSize;
+    insCheckTimestampBatch(pDataBlock, (const TSKEY*)bind->buffer, rowNum);
   }
 
-  SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
-  if (TSDB_CODE_SUCCESS != insSetBlockInfo(pBlocks, pDataBlock, bind->num)) {
-    return buildInvalidOperationMsg(&pBuf, "too many rows in sql, total number of rows should be less than INT32_MAX");
+  if (tColDataAppendFixed(&pDataBlock->aColData[schemaIdx], bind->buffer, bind->is_null, rowNum) != 0) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
-
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen, int32_t colIdx,
-                                int32_t rowNum) {
-  STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
-  SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
-  int32_t             extendedRowSize = insGetExtendedRowSize(pDataBlock);
+static int32_t bindStmtColsValue(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf) {
   SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
-  SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
-  SMemParam           param = {.rb = pBuilder};
-  SMsgBuf             pBuf = {.buf = msgBuf, .len = msgBufLen};
-  bool                rowStart = (0 == colIdx);
-  bool                rowEnd = ((colIdx + 1) == spd->numOfBound);
+  int32_t             rowNum = bind->num;
 
-  if (rowStart) {
-    CHECK_CODE(
-        insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
-    CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * bind->num));
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    if (bind[c].num != rowNum) {
+      return buildInvalidOperationMsg(pBuf, "row number in each bind param should be the same");
+    }
   }
 
-  for (int32_t r = 0; r < bind->num; ++r) {
-    STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size + extendedRowSize * r);  // skip the SSubmitBlk header
-    if (rowStart) {
-      tdSRowResetBuf(pBuilder, row);
-    } else {
-      tdSRowGetBuf(pBuilder, row);
-    }
+  CHECK_CODE(insInitColData(pDataBlock));
 
-    SSchema* pColSchema = &pSchema[spd->boundColumns[colIdx]];
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    CHECK_CODE(bindStmtColumn(pDataBlock, &bind[c], pBuf, spd->boundColumns[c], rowNum));
+  }
 
-    if (bind->num != rowNum) {
-      return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
+  for (int c = 0; c < spd->numOfCols; ++c) {
+    if (spd->cols[c].valStat == VAL_STAT_NONE) {
+      CHECK_CODE(insColDataAppendNone(pDataBlock, c, rowNum));
     }
+  }
 
-    param.schema = pColSchema;
-    insGetSTSRowAppendInfo(pBuilder->rowType, spd, colIdx, &param.toffset, &param.colIdx);
-
-    if (bind->is_null && bind->is_null[r]) {
-      if (pColSchema->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
-        return buildInvalidOperationMsg(&pBuf, "primary timestamp should not be NULL");
-      }
+  SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
+  if (TSDB_CODE_SUCCESS != insSetBlockInfo(pBlocks, pDataBlock, bind->num)) {
+    return buildInvalidOperationMsg(pBuf, "too many rows in sql, total number of rows should be less than INT32_MAX");
+  }
 
-      CHECK_CODE(insMemRowAppend(&pBuf, NULL, 0, &param));
-    } else {
-      if (bind->buffer_type != pColSchema->type) {
-        return buildInvalidOperationMsg(&pBuf, "column type mis-match with buffer type");
-      }
+  return TSDB_CODE_SUCCESS;
+}
 
-      int32_t colLen = pColSchema->bytes;
-      if (IS_VAR_DATA_TYPE(pColSchema->type)) {
-        colLen = bind->length[r];
-      }
+// Bound values are appended column by column to pDataBlock->aColData, the columns that are not bound get NONE. On
+// failure the values appended by this call are dropped, so the columns keep the same number of rows.
+int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
+  STableDataBlocks* pDataBlock = (STableDataBlocks*)pBlock;
+  SMsgBuf           pBuf = {.buf = msgBuf, .len = msgBufLen};
+  int32_t           nRows = ((SSubmitBlk*)pDataBlock->pData)->numOfRows;
 
-      CHECK_CODE(insMemRowAppend(&pBuf, (char*)bind->buffer + bind->buffer_length * r, colLen, &param));
-    }
+  int32_t code = bindStmtColsValue(pDataBlock, bind, &pBuf);
+  if (TSDB_CODE_SUCCESS != code) {
+    insColDataRollback(pDataBlock, nRows);
+  }
+  return code;
+}
 
-    if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
-      TSKEY tsKey = TD_ROW_KEY(row);
-      insCheckTimestamp(pDataBlock, (const char*)&tsKey);
-    }
+static int32_t bindStmtSingleColValue(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf,
+                                      int32_t colIdx, int32_t rowNum) {
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  bool                rowEnd = ((colIdx + 1) == spd->numOfBound);
 
-    // set the null value for the columns that do not assign values
-    if (rowEnd && (spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW(row)) {
-      pBuilder->hasNone = true;
-    }
-    if (rowEnd) {
-      tdSRowEnd(pBuilder);
-    }
-#ifdef TD_DEBUG_PRINT_ROW
-    if (rowEnd) {
-      STSchema* pSTSchema = tdGetSTSChemaFromSSChema(pSchema, spd->numOfCols, 1);
-      tdSRowPrint(row, pSTSchema, __func__);
-      taosMemoryFree(pSTSchema);
-    }
-#endif
+  if (bind->num != rowNum) {
+    return buildInvalidOperationMsg(pBuf, "row number in each bind param should be the same");
   }
 
+  CHECK_CODE(insInitColData(pDataBlock));
+
+  CHECK_CODE(bindStmtColumn(pDataBlock, bind, pBuf, spd->boundColumns[colIdx], bind->num));
+
   if (rowEnd) {
-    pDataBlock->size += extendedRowSize * bind->num;
+    for (int c = 0; c < spd->numOfCols; ++c) {
+      if (spd->cols[c].valStat == VAL_STAT_NONE) {
+        CHECK_CODE(insColDataAppendNone(pDataBlock, c, bind->num));
+      }
+    }
 
     SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
     if (TSDB_CODE_SUCCESS != insSetBlockInfo(pBlocks, pDataBlock, bind->num)) {
-      return buildInvalidOperationMsg(&pBuf,
+      return buildInvalidOperationMsg(pBuf,
                                       "too many rows in sql, total number of rows should be less than INT32_MAX");
     }
   }
@@ -317,6 +287,21 @@ int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBu
   return TSDB_CODE_SUCCESS;
 }
 
+// The rows of a batch are complete once the last bound column is bound. A failure drops the columns already bound
+// for the batch, the caller then has to start over from the first column.
+int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen, int32_t colIdx,
+                                int32_t rowNum) {
+  STableDataBlocks* pDataBlock = (STableDataBlocks*)pBlock;
+  SMsgBuf           pBuf = {.buf = msgBuf, .len = msgBufLen};
+  int32_t           nRows = ((SSubmitBlk*)pDataBlock->pData)->numOfRows;
+
+  int32_t code = bindStmtSingleColValue(pDataBlock, bind, &pBuf, colIdx, rowNum);
+  if (TSDB_CODE_SUCCESS != code) {
+    insColDataRollback(pDataBlock, nRows);
+  }
+  return code;
+}
+
 int32_t buildBoundFields(SParsedDataColInfo* boundInfo, SSchema* pSchema, int32_t* fieldNum, TAOS_FIELD_E** fields,
                          uint8_t timePrec) {
   if (fields) {
@@ -395,8 +380,11 @@ int32_t qResetStmtDataBlock(void* block, bool keepBuf) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
     memset(pBlock->pData, 0, sizeof(SSubmitBlk));
+    insClearColData(pBlock);
   } else {
     pBlock->pData = NULL;
+    pBlock->aColData = NULL;
+    pBlock->pColBuf = NULL;
   }
 
   pBlock->ordered = true;
@@ -468,6 +456,7 @@ void qFreeStmtDataBlock(void* pDataBlock) {
     return;
   }
 
+  insDestroyColData((STableDataBlocks*)pDataBlock);
   taosMemoryFreeClear(((STableDataBlocks*)pDataBlock)->pTableMeta);
   taosMemoryFreeClear(((STableDataBlocks*)pDataBlock)->pData);
   taosMemoryFreeClear(pDataBlock);
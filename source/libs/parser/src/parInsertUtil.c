@@ -20,6 +20,7 @@
 #include "parUtil.h"
 #include "querynodes.h"
 #include "tRealloc.h"
+#include "tcompression.h"
 
 typedef struct SBlockKeyTuple {
   TSKEY   skey;
@@ -32,6 +33,11 @@ typedef struct SBlockKeyInfo {
   SBlockKeyTuple* pKeyTuple;
 } SBlockKeyInfo;
 
+typedef struct SColKeyTuple {
+  TSKEY   skey;
+  int32_t index;
+} SColKeyTuple;
+
 typedef struct {
   int32_t   index;
   SArray*   rowArray;  // array of merged rows(mem allocated by tRealloc/free by tFree)
@@ -78,6 +84,16 @@ static int32_t rowDataComparStable(const void* lhs, const void* rhs) {
   }
 }
 
+static int32_t colKeyComparStable(const void* lhs, const void* rhs) {
+  TSKEY left = ((SColKeyTuple*)lhs)->skey;
+  TSKEY right = ((SColKeyTuple*)rhs)->skey;
+  if (left == right) {
+    return ((SColKeyTuple*)lhs)->index - ((SColKeyTuple*)rhs)->index;
+  } else {
+    return left > right ? 1 : -1;
+  }
+}
+
 int32_t insGetExtendedRowSize(STableDataBlocks* pBlock) {
   STableComInfo* pTableInfo = &pBlock->pTableMeta->tableInfo;
   ASSERT(pBlock->rowSize == pTableInfo->rowSize);
@@ -271,6 +287,7 @@ void insDestroyDataBlock(STableDataBlocks* pDataBlock) {
   }
 
   taosMemoryFreeClear(pDataBlock->pData);
+  insDestroyColData(pDataBlock);
   //  if (!pDataBlock->cloned) {
   // free the refcount for metermeta
   taosMemoryFreeClear(pDataBlock->pTableMeta);
@@ -666,6 +683,152 @@ static int sortMergeDataBlockDupRows(STableDataBlocks* dataBuf, SBlockKeyInfo* p
   return TSDB_CODE_SUCCESS;
 }
 
+// Sort the column-major rows of a table by primary key. Rows with the same key are merged into one, the last bound
+// value of each column wins, which is what tdBlockRowMerge does for STSRow.
+static int32_t sortMergeColData(STableDataBlocks* dataBuf) {
+  SSubmitBlk* pBlocks = (SSubmitBlk*)dataBuf->pData;
+  int32_t     nRows = pBlocks->numOfRows;
+  int32_t     numOfCols = getNumOfColumns(dataBuf->pTableMeta);
+  SColData*   aColData = dataBuf->aColData;
+
+  if (dataBuf->ordered) {
+    dataBuf->prevTS = INT64_MIN;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColKeyTuple* pKeyTuple = taosMemoryMalloc(sizeof(SColKeyTuple) * nRows);
+  SColData*     aMerged = taosMemoryCalloc(numOfCols, sizeof(SColData));
+  if (NULL == pKeyTuple || NULL == aMerged) {
+    taosMemoryFree(pKeyTuple);
+    taosMemoryFree(aMerged);
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  ASSERT(aColData[0].flag == HAS_VALUE && aColData[0].nVal == nRows);
+  for (int32_t i = 0; i < nRows; ++i) {
+    pKeyTuple[i].skey = ((TSKEY*)aColData[0].pData)[i];
+    pKeyTuple[i].index = i;
+  }
+  taosSort(pKeyTuple, nRows, sizeof(SColKeyTuple), colKeyComparStable);
+
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    tColDataInit(&aMerged[c], aColData[c].cid, aColData[c].type, 0);
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t nMerged = 0;
+  for (int32_t i = 0, j = 0; i < nRows; i = j) {
+    while (j < nRows && pKeyTuple[j].skey == pKeyTuple[i].skey) {
+      ++j;
+    }
+
+    for (int32_t c = 0; c < numOfCols && TSDB_CODE_SUCCESS == code; ++c) {
+      SColVal colVal;
+      for (int32_t k = j - 1; k >= i; --k) {
+        tColDataGetValue(&aColData[c], pKeyTuple[k].index, &colVal);
+        if (!COL_VAL_IS_NONE(&colVal)) break;
+      }
+      code = tColDataAppendValue(&aMerged[c], &colVal);
+    }
+    if (TSDB_CODE_SUCCESS != code) break;
+    ++nMerged;
+  }
+  taosMemoryFree(pKeyTuple);
+
+  // the merged columns replace the bound ones
+  dataBuf->aColData = aMerged;
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    tColDataDestroy(&aColData[c]);
+  }
+  taosMemoryFree(aColData);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
+  dataBuf->ordered = true;
+  dataBuf->prevTS = INT64_MIN;
+  pBlocks->numOfRows = nMerged;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Encode the column-major rows of a table behind its SSubmitBlk head and create table request
+static int trimColDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock) {
+  int32_t     nonDataLen = sizeof(SSubmitBlk) + pTableDataBlock->createTbReqLen;
+  SSubmitBlk* pBlock = pDataBlock;
+  memcpy(pDataBlock, pTableDataBlock->pData, nonDataLen);
+
+  int32_t dataLen = tEncodeSubmitColBlk(pTableDataBlock->aColData, getTableColumnSchema(pTableDataBlock->pTableMeta),
+                                        getNumOfColumns(pTableDataBlock->pTableMeta), ONE_STAGE_COMP,
+                                        (uint8_t*)pDataBlock + nonDataLen);
+  if (dataLen < 0) {
+    return -1;
+  }
+
+  pBlock->schemaLen = pTableDataBlock->createTbReqLen | SUBMIT_BLK_COL_FMT;
+  pBlock->dataLen = dataLen;
+  return dataLen + pTableDataBlock->createTbReqLen;
+}
+
+// The largest STSRow tdSTSRowNew builds from one row of aColData
+static int32_t colDataMaxRowSize(STableDataBlocks* pTableDataBlock) {
+  int32_t  numOfCols = getNumOfColumns(pTableDataBlock->pTableMeta);
+  SSchema* pSchema = getTableColumnSchema(pTableDataBlock->pTableMeta);
+  int32_t  size = sizeof(STSRow) + TD_BITMAP_BYTES(numOfCols - 1);
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    size += TYPE_BYTES[pSchema[c].type];
+    if (IS_VAR_DATA_TYPE(pSchema[c].type)) {
+      size += pSchema[c].bytes + INT_BYTES;
+    }
+  }
+  return size;
+}
+
+// Rebuild STSRow from the column-major rows of a table, for servers that do not take SUBMIT_BLK_COL_FMT blocks
+static int trimColDataToRows(void* pDataBlock, STableDataBlocks* pTableDataBlock) {
+  int32_t     nonDataLen = sizeof(SSubmitBlk) + pTableDataBlock->createTbReqLen;
+  int32_t     numOfCols = getNumOfColumns(pTableDataBlock->pTableMeta);
+  SSubmitBlk* pBlock = pDataBlock;
+  memcpy(pDataBlock, pTableDataBlock->pData, nonDataLen);
+  pDataBlock = (char*)pDataBlock + nonDataLen;
+
+  pBlock->schemaLen = pTableDataBlock->createTbReqLen;
+  pBlock->dataLen = 0;
+
+  STSchema* pTSchema = tdGetSTSChemaFromSSChema(getTableColumnSchema(pTableDataBlock->pTableMeta), numOfCols,
+                                                pTableDataBlock->pTableMeta->sversion);
+  SArray*   pColVals = taosArrayInit(numOfCols, sizeof(SColVal));
+  if (NULL == pTSchema || NULL == pColVals) {
+    taosMemoryFree(pTSchema);
+    taosArrayDestroy(pColVals);
+    terrno = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int32_t code = 0;
+  for (int32_t r = 0; r < pBlock->numOfRows; ++r) {
+    taosArrayClear(pColVals);
+    for (int32_t c = 0; c < numOfCols; ++c) {
+      SColVal colVal;
+      tColDataGetValue(&pTableDataBlock->aColData[c], r, &colVal);
+      taosArrayPush(pColVals, &colVal);
+    }
+
+    STSRow* row = (STSRow*)pDataBlock;
+    if ((code = tdSTSRowNew(pColVals, pTSchema, &row)) < 0) {
+      break;
+    }
+    pDataBlock = POINTER_SHIFT(pDataBlock, TD_ROW_LEN(row));
+    pBlock->dataLen += TD_ROW_LEN(row);
+  }
+
+  taosMemoryFree(pTSchema);
+  taosArrayDestroy(pColVals);
+  if (code < 0) {
+    return -1;
+  }
+  return pBlock->dataLen + pBlock->schemaLen;
+}
+
 // Erase the empty space reserved for binary data
 static int trimDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SBlockKeyTuple* blkKeyTuple) {
   // TODO: optimize this function, handle the case while binary is not presented
@@ -689,7 +852,7 @@ static int trimDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SB
   return pBlock->dataLen + pBlock->schemaLen;
 }
 
-int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
+int32_t insMergeTableDataBlocks(SHashObj* pHashObj, bool colFmt, SArray** pVgDataBlocks) {
   const int INSERT_HEAD_SIZE = sizeof(SSubmitReq);
   int       code = 0;
   SHashObj* pVnodeDataBlockHashList = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, false);
@@ -716,10 +879,25 @@ int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
         return ret;
       }
       ASSERT(pOneTableBlock->pTableMeta->tableInfo.rowSize > 0);
+      if (pOneTableBlock->aColData) {
+        if ((code = sortMergeColData(pOneTableBlock)) != 0) {
+          tdFreeSBlockRowMerger(pBlkRowMerger);
+          taosHashCleanup(pVnodeDataBlockHashList);
+          insDestroyBlockArrayList(pVnodeDataBlockList);
+          taosMemoryFreeClear(blkKeyInfo.pKeyTuple);
+          return code;
+        }
+      }
+
       // the maximum expanded size in byte when a row-wise data is converted to SDataRow format
       int64_t destSize = dataBuf->size + pOneTableBlock->size +
                          sizeof(STColumn) * getNumOfColumns(pOneTableBlock->pTableMeta) +
                          pOneTableBlock->createTbReqLen;
+      if (pOneTableBlock->aColData && colFmt) {
+        destSize += tSubmitColBlkMaxSize(pOneTableBlock->aColData, getNumOfColumns(pOneTableBlock->pTableMeta));
+      } else if (pOneTableBlock->aColData) {
+        destSize += (int64_t)colDataMaxRowSize(pOneTableBlock) * pBlocks->numOfRows;
+      }
 
       if (dataBuf->nAllocSize < destSize) {
         dataBuf->nAllocSize = (uint32_t)(destSize * 1.5);
@@ -736,18 +914,31 @@ int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
         }
       }
 
-      if ((code = sortMergeDataBlockDupRows(pOneTableBlock, &blkKeyInfo, &pBlkRowMerger)) != 0) {
-        tdFreeSBlockRowMerger(pBlkRowMerger);
-        taosHashCleanup(pVnodeDataBlockHashList);
-        insDestroyBlockArrayList(pVnodeDataBlockList);
-        taosMemoryFreeClear(dataBuf->pData);
-        taosMemoryFreeClear(blkKeyInfo.pKeyTuple);
-        return code;
-      }
-      ASSERT(blkKeyInfo.pKeyTuple != NULL && pBlocks->numOfRows > 0);
+      int32_t finalLen = 0;
+      if (pOneTableBlock->aColData) {
+        finalLen = colFmt ? trimColDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock)
+                          : trimColDataToRows(dataBuf->pData + dataBuf->size, pOneTableBlock);
+        if (finalLen < 0) {
+          tdFreeSBlockRowMerger(pBlkRowMerger);
+          taosHashCleanup(pVnodeDataBlockHashList);
+          insDestroyBlockArrayList(pVnodeDataBlockList);
+          taosMemoryFreeClear(blkKeyInfo.pKeyTuple);
+          return terrno;
+        }
+      } else {
+        if ((code = sortMergeDataBlockDupRows(pOneTableBlock, &blkKeyInfo, &pBlkRowMerger)) != 0) {
+          tdFreeSBlockRowMerger(pBlkRowMerger);
+          taosHashCleanup(pVnodeDataBlockHashList);
+          insDestroyBlockArrayList(pVnodeDataBlockList);
+          taosMemoryFreeClear(dataBuf->pData);
+          taosMemoryFreeClear(blkKeyInfo.pKeyTuple);
+          return code;
+        }
+        ASSERT(blkKeyInfo.pKeyTuple != NULL && pBlocks->numOfRows > 0);
 
-      // erase the empty space reserved for binary data
-      int32_t finalLen = trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, blkKeyInfo.pKeyTuple);
+        // erase the empty space reserved for binary data
+        finalLen = trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, blkKeyInfo.pKeyTuple);
+      }
 
       dataBuf->size += (finalLen + sizeof(SSubmitBlk));
       assert(dataBuf->size <= dataBuf->nAllocSize);
@@ -973,6 +1164,144 @@ int32_t insCheckTimestamp(STableDataBlocks* pDataBlocks, const char* start) {
   return TSDB_CODE_SUCCESS;
 }
 
+// insCheckTimestamp over a whole bound column, compared pairwise without branching so the loop vectorizes.
+void insCheckTimestampBatch(STableDataBlocks* pDataBlocks, const TSKEY* pKeys, int32_t nRows) {
+  if (!pDataBlocks->ordered || nRows <= 0) {
+    return;
+  }
+
+  int32_t disorder = (pKeys[0] <= pDataBlocks->prevTS);
+  for (int32_t i = 1; i < nRows; ++i) {
+    disorder |= (pKeys[i] <= pKeys[i - 1]);
+  }
+
+  if (disorder) {
+    pDataBlocks->ordered = false;
+  }
+  pDataBlocks->prevTS = pKeys[nRows - 1];
+}
+
+int32_t insInitColData(STableDataBlocks* pDataBlock) {
+  if (pDataBlock->aColData) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t  numOfCols = getNumOfColumns(pDataBlock->pTableMeta);
+  SSchema* pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
+  pDataBlock->aColData = taosMemoryCalloc(numOfCols, sizeof(SColData));
+  if (NULL == pDataBlock->aColData) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    tColDataInit(&pDataBlock->aColData[c], pSchema[c].colId, pSchema[c].type, 0);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void insClearColData(STableDataBlocks* pDataBlock) {
+  if (NULL == pDataBlock->aColData) {
+    return;
+  }
+
+  int32_t numOfCols = getNumOfColumns(pDataBlock->pTableMeta);
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    tColDataClear(&pDataBlock->aColData[c]);
+  }
+}
+
+void insDestroyColData(STableDataBlocks* pDataBlock) {
+  if (pDataBlock->aColData) {
+    int32_t numOfCols = getNumOfColumns(pDataBlock->pTableMeta);
+    for (int32_t c = 0; c < numOfCols; ++c) {
+      tColDataDestroy(&pDataBlock->aColData[c]);
+    }
+    taosMemoryFreeClear(pDataBlock->aColData);
+  }
+  tFree(pDataBlock->pColBuf);
+  pDataBlock->pColBuf = NULL;
+}
+
+int32_t insColDataAppend(SMsgBuf* pMsgBuf, STableDataBlocks* pDataBlock, col_id_t schemaIdx, const void* value,
+                         int32_t len) {
+  SSchema* pSchema = getTableColumnSchema(pDataBlock->pTableMeta) + schemaIdx;
+  SColVal  colVal;
+
+  if (value == NULL) {  // it is a null data
+    colVal = COL_VAL_NULL(pSchema->colId, pSchema->type);
+  } else if (TSDB_DATA_TYPE_BINARY == pSchema->type) {
+    if (len > pSchema->bytes - VARSTR_HEADER_SIZE) {
+      return generateSyntaxErrMsg(pMsgBuf, TSDB_CODE_PAR_VALUE_TOO_LONG, pSchema->name);
+    }
+    SValue sv = {.nData = len, .pData = (uint8_t*)value};
+    colVal = COL_VAL_VALUE(pSchema->colId, pSchema->type, sv);
+  } else if (TSDB_DATA_TYPE_NCHAR == pSchema->type) {
+    // if the converted output len is over than pColumnModel->bytes, return error: 'Argument list too long'
+    int32_t output = 0;
+    if (tRealloc(&pDataBlock->pColBuf, pSchema->bytes) != 0) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+    if (!taosMbsToUcs4(value, len, (TdUcs4*)pDataBlock->pColBuf, pSchema->bytes - VARSTR_HEADER_SIZE, &output)) {
+      if (errno == E2BIG) {
+        return generateSyntaxErrMsg(pMsgBuf, TSDB_CODE_PAR_VALUE_TOO_LONG, pSchema->name);
+      }
+      char buf[512] = {0};
+      snprintf(buf, tListLen(buf), "%s", strerror(errno));
+      return buildSyntaxErrMsg(pMsgBuf, buf, value);
+    }
+    SValue sv = {.nData = output, .pData = pDataBlock->pColBuf};
+    colVal = COL_VAL_VALUE(pSchema->colId, pSchema->type, sv);
+  } else {
+    SValue sv = {0};
+    memcpy(&sv.val, value, TYPE_BYTES[pSchema->type]);
+    colVal = COL_VAL_VALUE(pSchema->colId, pSchema->type, sv);
+  }
+
+  if (tColDataAppendValue(&pDataBlock->aColData[schemaIdx], &colVal) != 0) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// Drop the values appended after the first nRows rows, e.g. by a bind that failed halfway. The flag and the bitmap are
+// kept, the bits of the rows left are still right for them.
+void insColDataRollback(STableDataBlocks* pDataBlock, int32_t nRows) {
+  if (NULL == pDataBlock->aColData) {
+    return;
+  }
+
+  int32_t numOfCols = getNumOfColumns(pDataBlock->pTableMeta);
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    SColData* pColData = &pDataBlock->aColData[c];
+    if (0 == nRows) {
+      tColDataClear(pColData);
+      continue;
+    }
+    if (pColData->nVal < nRows) {
+      continue;
+    }
+
+    if (pColData->flag & HAS_VALUE) {
+      if (!IS_VAR_DATA_TYPE(pColData->type)) {
+        pColData->nData = tDataTypes[pColData->type].bytes * nRows;
+      } else if (pColData->nVal > nRows) {
+        pColData->nData = pColData->aOffset[nRows];
+      }
+    }
+    pColData->nVal = nRows;
+  }
+}
+
+int32_t insColDataAppendNone(STableDataBlocks* pDataBlock, col_id_t schemaIdx, int32_t nRows) {
+  SSchema* pSchema = getTableColumnSchema(pDataBlock->pTableMeta) + schemaIdx;
+  SColVal  colVal = COL_VAL_NONE(pSchema->colId, pSchema->type);
+  for (int32_t i = 0; i < nRows; ++i) {
+    if (tColDataAppendValue(&pDataBlock->aColData[schemaIdx], &colVal) != 0) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 static void buildMsgHeader(STableDataBlocks* src, SVgDataBlocks* blocks) {
   SSubmitReq* submit = (SSubmitReq*)blocks->pData;
   submit->header.vgId = htonl(blocks->vg.vgId);
@@ -983,7 +1312,7 @@ static void buildMsgHeader(STableDataBlocks* src, SVgDataBlocks* blocks) {
   int32_t     numOfBlocks = blocks->numOfTables;
   while (numOfBlocks--) {
     int32_t dataLen = blk->dataLen;
-    int32_t schemaLen = blk->schemaLen;
+    int32_t schemaLen = blk->schemaLen & ~SUBMIT_BLK_COL_FMT;
     blk->uid = htobe64(blk->uid);
     blk->suid = htobe64(blk->suid);
     blk->sversion = htonl(blk->sversion);
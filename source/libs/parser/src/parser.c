@@ -48,6 +48,131 @@ bool qIsInsertValuesSql(const char* pStr, size_t length) {
   return false;
 }
 
+static bool isUncacheableQueryToken(uint32_t type) {
+  switch (type) {
+    case TK_NOW:
+    case TK_TODAY:
+    case TK_TIMEZONE:
+    case TK_DATABASE:
+    case TK_CLIENT_VERSION:
+    case TK_SERVER_VERSION:
+    case TK_SERVER_STATUS:
+    case TK_CURRENT_USER:
+    case TK_USER:
+    case TK_QSTART:
+    case TK_QEND:
+    case TK_QDURATION:
+    case TK_NK_QUESTION:
+    case TK_NK_ILLEGAL:
+    case TK_NK_HEX:
+    case TK_NK_OCT:
+    case TK_NK_BIN:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+static int32_t liftQueryConstant(SToken* pToken, SArray* pConsts) {
+  SQueryConstant c = {.type = pToken->type, .literal = taosMemoryCalloc(1, pToken->n + 1)};
+  if (NULL == c.literal) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (TK_NK_STRING == pToken->type) {
+    trimString(pToken->z, pToken->n, c.literal, pToken->n);
+  } else {
+    memcpy(c.literal, pToken->z, pToken->n);
+  }
+  if (NULL == taosArrayPush(pConsts, &c)) {
+    taosMemoryFree(c.literal);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void qDestroyQueryConstants(SArray* pConsts) {
+  for (int32_t i = 0; i < taosArrayGetSize(pConsts); ++i) {
+    taosMemoryFree(((SQueryConstant*)taosArrayGet(pConsts, i))->literal);
+  }
+  taosArrayDestroy(pConsts);
+}
+
+// Replace the integer, float and string literals of a select by typed markers, so that queries differing only in
+// their constants share one key. Literals of LIMIT/OFFSET clauses and durations stay in the key. *pKey is set to NULL
+// if the statement is not a select, or depends on the session or the clock.
+int32_t qNormalizeQuerySql(const char* pSql, size_t sqlLen, char** pKey, SArray** pConsts) {
+  *pKey = NULL;
+  *pConsts = NULL;
+
+  char*   pBuf = taosMemoryMalloc(sqlLen * 3 + 1);
+  SArray* pArray = taosArrayInit(8, sizeof(SQueryConstant));
+  if (NULL == pBuf || NULL == pArray) {
+    taosMemoryFree(pBuf);
+    taosArrayDestroy(pArray);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t len = 0;
+  int32_t num = 0;
+  bool    inLimit = false;
+  bool    cacheable = true;
+  size_t  i = 0;
+  while (cacheable && i < sqlLen && '\0' != pSql[i]) {
+    SToken t = {.z = (char*)pSql + i};
+    t.n = tGetToken(t.z, &t.type);
+    i += t.n;
+    if (TK_NK_SPACE == t.type || TK_NK_COMMENT == t.type) {
+      continue;
+    }
+    if (TK_NK_SEMI == t.type || (0 == num++ && TK_SELECT != t.type) || isUncacheableQueryToken(t.type)) {
+      cacheable = (TK_NK_SEMI == t.type);
+      break;
+    }
+
+    if (len > 0) {
+      pBuf[len++] = ' ';
+    }
+    if (!inLimit && (TK_NK_INTEGER == t.type || TK_NK_FLOAT == t.type || TK_NK_STRING == t.type)) {
+      code = liftQueryConstant(&t, pArray);
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+      pBuf[len++] = '?';
+      pBuf[len++] = (TK_NK_INTEGER == t.type ? 'i' : (TK_NK_FLOAT == t.type ? 'f' : 's'));
+    } else if ('`' == t.z[0]) {
+      memcpy(pBuf + len, t.z, t.n);
+      len += t.n;
+    } else {
+      for (int32_t j = 0; j < t.n; ++j) {
+        pBuf[len++] = tolower(t.z[j]);
+      }
+    }
+
+    if (TK_LIMIT == t.type || TK_OFFSET == t.type || TK_SLIMIT == t.type || TK_SOFFSET == t.type) {
+      inLimit = true;
+    } else if (TK_NK_COMMA != t.type && TK_NK_INTEGER != t.type) {
+      inLimit = false;
+    }
+  }
+
+  // nothing but blanks may follow the terminating semicolon
+  for (; cacheable && i < sqlLen && '\0' != pSql[i]; ++i) {
+    cacheable = isspace(pSql[i]);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && cacheable && num > 0) {
+    pBuf[len] = '\0';
+    *pKey = pBuf;
+    *pConsts = pArray;
+  } else {
+    taosMemoryFree(pBuf);
+    qDestroyQueryConstants(pArray);
+  }
+  return code;
+}
+
 static int32_t analyseSemantic(SParseContext* pCxt, SQuery* pQuery, SParseMetaCache* pMetaCache) {
   int32_t code = authenticate(pCxt, pQuery, pMetaCache);
 
@@ -244,6 +369,8 @@ int32_t qSetSTableIdForRsma(SNode* pStmt, int64_t uid) {
 
 void qCleanupKeywordsTable() { taosCleanupKeywordsTable(); }
 
+void qCleanupCsvParseWorker() { insCleanupCsvParseWorker(); }
+
 int32_t qStmtBindParams(SQuery* pQuery, TAOS_MULTI_BIND* pParams, int32_t colIdx) {
   int32_t code = TSDB_CODE_SUCCESS;
 
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C" {
+#include "parInsertUtil.h"
+}
+#include "parser.h"
+#include "tcompression.h"
+
+namespace ParserTest {
+
+namespace {
+
+const int32_t colFmtNumOfCols = 4;
+const int32_t colFmtBinLen = 16;
+
+STableMeta* createColFmtTableMeta() {
+  STableMeta* pMeta = (STableMeta*)taosMemoryCalloc(1, sizeof(STableMeta) + colFmtNumOfCols * sizeof(SSchema));
+  pMeta->vgId = 2;
+  pMeta->tableType = TSDB_NORMAL_TABLE;
+  pMeta->uid = 100;
+  pMeta->sversion = 1;
+  pMeta->tableInfo.numOfColumns = colFmtNumOfCols;
+  pMeta->tableInfo.precision = TSDB_TIME_PRECISION_MILLI;
+
+  SSchema aSchema[colFmtNumOfCols] = {
+      {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8},
+      {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4},
+      {.type = TSDB_DATA_TYPE_BINARY, .colId = 3, .bytes = colFmtBinLen + VARSTR_HEADER_SIZE},
+      {.type = TSDB_DATA_TYPE_DOUBLE, .colId = 4, .bytes = 8},
+  };
+  for (int32_t i = 0; i < colFmtNumOfCols; ++i) {
+    snprintf(aSchema[i].name, sizeof(aSchema[i].name), "c%d", i);
+    pMeta->schema[i] = aSchema[i];
+    pMeta->tableInfo.rowSize += aSchema[i].bytes;
+  }
+  return pMeta;
+}
+
+void expectColValEq(const SColVal* pExpect, const SColVal* pActual) {
+  ASSERT_EQ(COL_VAL_IS_NONE(pExpect), COL_VAL_IS_NONE(pActual));
+  ASSERT_EQ(COL_VAL_IS_NULL(pExpect), COL_VAL_IS_NULL(pActual));
+  if (!COL_VAL_IS_VALUE(pExpect)) return;
+
+  if (IS_VAR_DATA_TYPE(pExpect->type)) {
+    ASSERT_EQ(pExpect->value.nData, pActual->value.nData);
+    ASSERT_EQ(memcmp(pExpect->value.pData, pActual->value.pData, pExpect->value.nData), 0);
+  } else {
+    ASSERT_EQ(memcmp(&pExpect->value.val, &pActual->value.val, tDataTypes[pExpect->type].bytes), 0);
+  }
+}
+
+// ts | int with nulls | binary with values, nulls and nones | double without values
+void buildColData(SColData* aColData, const SSchema* aSchema, int32_t nRows) {
+  const char* aStr[] = {"", "a", "shanghai", "0123456789abcdef"};
+
+  memset(aColData, 0, sizeof(SColData) * colFmtNumOfCols);
+  for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+    tColDataInit(&aColData[c], aSchema[c].colId, aSchema[c].type, 0);
+  }
+  for (int32_t r = 0; r < nRows; ++r) {
+    SValue  sv = {0};
+    SColVal cv;
+
+    sv.val = 1537146000000 + r;
+    cv = COL_VAL_VALUE(aSchema[0].colId, aSchema[0].type, sv);
+    ASSERT_EQ(tColDataAppendValue(&aColData[0], &cv), 0);
+
+    sv.val = r * 7;
+    cv = (r % 3 == 0) ? COL_VAL_NULL(aSchema[1].colId, aSchema[1].type)
+                      : COL_VAL_VALUE(aSchema[1].colId, aSchema[1].type, sv);
+    ASSERT_EQ(tColDataAppendValue(&aColData[1], &cv), 0);
+
+    if (r % 5 == 1) {
+      cv = COL_VAL_NONE(aSchema[2].colId, aSchema[2].type);
+    } else if (r % 5 == 2) {
+      cv = COL_VAL_NULL(aSchema[2].colId, aSchema[2].type);
+    } else {
+      const char* str = aStr[r % 4];
+      sv.nData = strlen(str);
+      sv.pData = (uint8_t*)str;
+      cv = COL_VAL_VALUE(aSchema[2].colId, aSchema[2].type, sv);
+    }
+    ASSERT_EQ(tColDataAppendValue(&aColData[2], &cv), 0);
+
+    cv = COL_VAL_NONE(aSchema[3].colId, aSchema[3].type);
+    ASSERT_EQ(tColDataAppendValue(&aColData[3], &cv), 0);
+  }
+}
+
+void expectColBlkEq(SColData* aColData, const SSubmitColBlk* pBlk, int32_t nRows) {
+  ASSERT_EQ(pBlk->nRow, nRows);
+  ASSERT_EQ(pBlk->nCol, colFmtNumOfCols);
+  for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+    ASSERT_EQ(pBlk->aColData[c].cid, aColData[c].cid);
+    ASSERT_EQ(pBlk->aColData[c].type, aColData[c].type);
+    for (int32_t r = 0; r < nRows; ++r) {
+      SColVal expect, actual;
+      tColDataGetValue(&aColData[c], r, &expect);
+      tColDataGetValue(&pBlk->aColData[c], r, &actual);
+      expectColValEq(&expect, &actual);
+    }
+  }
+}
+
+void bindRows(STableDataBlocks* pBlock, int64_t startTs, int32_t nRows, int bufferType, int32_t expectCode) {
+  std::vector<int64_t> aTs(nRows);
+  std::vector<int32_t> aInt(nRows);
+  std::vector<char>    aBin(nRows * colFmtBinLen);
+  std::vector<int32_t> aBinLen(nRows);
+  std::vector<double>  aDouble(nRows);
+  std::vector<char>    aNull(nRows, 0);
+
+  for (int32_t r = 0; r < nRows; ++r) {
+    aTs[r] = startTs + r;
+    aInt[r] = r;
+    aBinLen[r] = snprintf(&aBin[r * colFmtBinLen], colFmtBinLen, "bin%d", r);
+    aDouble[r] = r * 1.5;
+    aNull[r] = (r % 2);
+  }
+
+  TAOS_MULTI_BIND aBind[colFmtNumOfCols] = {
+      {TSDB_DATA_TYPE_TIMESTAMP, aTs.data(), sizeof(int64_t), NULL, NULL, nRows},
+      {TSDB_DATA_TYPE_INT, aInt.data(), sizeof(int32_t), NULL, aNull.data(), nRows},
+      {TSDB_DATA_TYPE_BINARY, aBin.data(), (uintptr_t)colFmtBinLen, aBinLen.data(), NULL, nRows},
+      {bufferType, aDouble.data(), sizeof(double), NULL, NULL, nRows},
+  };
+  char msgBuf[256] = {0};
+  ASSERT_EQ(qBindStmtColsValue(pBlock, aBind, msgBuf, sizeof(msgBuf)), expectCode);
+}
+
+}  // namespace
+
+TEST(ParserInsertColFmtTest, colBlkRoundTrip) {
+  STableMeta* pMeta = createColFmtTableMeta();
+  SColData    aColData[colFmtNumOfCols];
+  int32_t     nRows = 100;
+
+  buildColData(aColData, pMeta->schema, nRows);
+
+  int8_t aCmprAlg[] = {NO_COMPRESSION, ONE_STAGE_COMP};
+  for (int8_t cmprAlg : aCmprAlg) {
+    std::vector<uint8_t> buf(tSubmitColBlkMaxSize(aColData, colFmtNumOfCols));
+    int32_t              len = tEncodeSubmitColBlk(aColData, pMeta->schema, colFmtNumOfCols, cmprAlg, buf.data());
+    ASSERT_GT(len, 0);
+    ASSERT_LE(len, (int32_t)buf.size());
+
+    SSubmitColBlk blk = {0};
+    ASSERT_EQ(tDecodeSubmitColBlk(buf.data(), len, &blk), 0);
+    expectColBlkEq(aColData, &blk, nRows);
+
+    // the decode buffers are reused by the next block
+    ASSERT_EQ(tDecodeSubmitColBlk(buf.data(), len, &blk), 0);
+    expectColBlkEq(aColData, &blk, nRows);
+
+    // a cut message is rejected instead of read past its end
+    for (int32_t cut = 1; cut < len; cut += 7) {
+      ASSERT_EQ(tDecodeSubmitColBlk(buf.data(), len - cut, &blk), -1);
+    }
+    tDestroySubmitColBlk(&blk);
+  }
+
+  for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+    tColDataDestroy(&aColData[c]);
+  }
+  taosMemoryFree(pMeta);
+}
+
+TEST(ParserInsertColFmtTest, bindRollback) {
+  STableMeta*       pMeta = createColFmtTableMeta();
+  SHashObj*         pBlockHash = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+  STableDataBlocks* pBlock = NULL;
+
+  ASSERT_EQ(insGetDataBlockFromList(pBlockHash, &pMeta->uid, sizeof(pMeta->uid), TSDB_DEFAULT_PAYLOAD_SIZE,
+                                    sizeof(SSubmitBlk), pMeta->tableInfo.rowSize, pMeta, &pBlock, NULL, NULL),
+                TSDB_CODE_SUCCESS);
+
+  bindRows(pBlock, 1537146000000, 4, TSDB_DATA_TYPE_DOUBLE, TSDB_CODE_SUCCESS);
+
+  // the last column fails after the others got their values, they are dropped again
+  bindRows(pBlock, 1537146001000, 3, TSDB_DATA_TYPE_FLOAT, TSDB_CODE_TSC_INVALID_OPERATION);
+  for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+    ASSERT_EQ(pBlock->aColData[c].nVal, 4);
+  }
+
+  bindRows(pBlock, 1537146002000, 3, TSDB_DATA_TYPE_DOUBLE, TSDB_CODE_SUCCESS);
+  for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+    ASSERT_EQ(pBlock->aColData[c].nVal, 7);
+  }
+  ASSERT_EQ(((SSubmitBlk*)pBlock->pData)->numOfRows, 7);
+
+  // both encodings of the block hold the same rows
+  SColVal aExpect[7][colFmtNumOfCols];
+  for (int32_t r = 0; r < 7; ++r) {
+    for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+      tColDataGetValue(&pBlock->aColData[c], r, &aExpect[r][c]);
+    }
+  }
+
+  STSchema* pTSchema = tdGetSTSChemaFromSSChema(pMeta->schema, colFmtNumOfCols, pMeta->sversion);
+  bool      aColFmt[] = {true, false};
+  for (bool colFmt : aColFmt) {
+    SArray* pVgBlocks = NULL;
+    ASSERT_EQ(insMergeTableDataBlocks(pBlockHash, colFmt, &pVgBlocks), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(taosArrayGetSize(pVgBlocks), 1);
+
+    STableDataBlocks* pVgBlock = (STableDataBlocks*)taosArrayGetP(pVgBlocks, 0);
+    SSubmitBlk*       pBlk = (SSubmitBlk*)(pVgBlock->pData + sizeof(SSubmitReq));
+    ASSERT_EQ(pBlk->numOfRows, 7);
+    ASSERT_EQ((pBlk->schemaLen & SUBMIT_BLK_COL_FMT) != 0, colFmt);
+
+    if (colFmt) {
+      SSubmitColBlk blk = {0};
+      ASSERT_EQ(tDecodeSubmitColBlk((uint8_t*)pBlk->data, pBlk->dataLen, &blk), 0);
+      for (int32_t r = 0; r < 7; ++r) {
+        for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+          SColVal actual;
+          tColDataGetValue(&blk.aColData[c], r, &actual);
+          expectColValEq(&aExpect[r][c], &actual);
+        }
+      }
+      tDestroySubmitColBlk(&blk);
+
+      // the vnode rebuilds the rows from the column slices, all of them into the same buffer
+      SSubmitMsgIter msgIter = {0};
+      SSubmitBlkIter blkIter = {0};
+      msgIter.sversion = pMeta->sversion;
+      msgIter.dataLen = pBlk->dataLen;
+      msgIter.colFmt = 1;
+      ASSERT_EQ(tInitSubmitBlkIter(&msgIter, pBlk, &blkIter), 0);
+      STSRow* pFirst = NULL;
+      for (int32_t r = 0; r < 7; ++r) {
+        STSRow* pRow = tGetSubmitBlkNext(&blkIter);
+        ASSERT_NE(pRow, nullptr);
+        if (pFirst == NULL) pFirst = pRow;
+        ASSERT_EQ(pRow, pFirst);
+        for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+          SColVal actual;
+          tTSRowGetVal(pRow, pTSchema, c, &actual);
+          expectColValEq(&aExpect[r][c], &actual);
+        }
+      }
+      ASSERT_EQ(tGetSubmitBlkNext(&blkIter), nullptr);
+      tDestroySubmitBlkIter(&blkIter);
+    } else {
+      STSRow* pRow = (STSRow*)pBlk->data;
+      for (int32_t r = 0; r < 7; ++r) {
+        for (int32_t c = 0; c < colFmtNumOfCols; ++c) {
+          SColVal actual;
+          tTSRowGetVal(pRow, pTSchema, c, &actual);
+          expectColValEq(&aExpect[r][c], &actual);
+        }
+        pRow = (STSRow*)POINTER_SHIFT(pRow, TD_ROW_LEN(pRow));
+      }
+      ASSERT_EQ((char*)pRow - pBlk->data, pBlk->dataLen);
+    }
+    insDestroyBlockArrayList(pVgBlocks);
+  }
+
+  taosMemoryFree(pTSchema);
+  insDestroyBlockHashmap(pBlockHash);
+  taosMemoryFree(pMeta);
+}
+
+}  // namespace ParserTest
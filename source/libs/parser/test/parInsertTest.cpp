@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 #include "parTestUtil.h"
 
 using namespace std;
@@ -28,7 +30,19 @@ namespace ParserTest {
 //       [(field1_name, ...)]
 //       VALUES (field1_value, ...) [(field1_value2, ...) ...] | FILE csv_file_path
 //   [...];
-class ParserInsertTest : public ParserTestBase {};
+class ParserInsertTest : public ParserTestBase {
+ public:
+  void setCheckInsertFunc(const std::function<void(const SQuery*)>& func) { checkInsert_ = func; }
+
+  virtual void checkDdl(const SQuery* pQuery, ParserStage stage) {
+    if (nullptr != checkInsert_) {
+      checkInsert_(pQuery);
+    }
+  }
+
+ private:
+  std::function<void(const SQuery*)> checkInsert_;
+};
 
 // INSERT INTO tb_name [(field1_name, ...)] VALUES (field1_value, ...)
 TEST_F(ParserInsertTest, singleTableSingleRowTest) {
@@ -84,4 +98,59 @@ TEST_F(ParserInsertTest, autoCreateTableTest) {
       "st1s2 (ts, c1, c2) USING st1 TAGS(2, 'abc', now) VALUES (now+1s, 2, 'shanghai')");
 }
 
+// INSERT INTO tb_name FILE csv_file_path
+TEST_F(ParserInsertTest, importFileTest) {
+  useDb("root", "test");
+
+  // enough rows to be split among the csv parse threads
+  const int32_t rows = 50000;
+  const char*   pFile = "/tmp/parInsertTest.csv";
+  {
+    ofstream csv(pFile);
+    for (int32_t i = 0; i < rows; ++i) {
+      csv << 1659000000000 + i << "," << i << ",'beijing'," << i * 3 << ",4,5\n";
+    }
+  }
+
+  // every row is in the submit, in file order
+  SSchema schema[] = {{TSDB_DATA_TYPE_TIMESTAMP, 0, 1, 8}, {TSDB_DATA_TYPE_INT, 0, 2, 4},
+                      {TSDB_DATA_TYPE_BINARY, 0, 3, 20},   {TSDB_DATA_TYPE_BIGINT, 0, 4, 8},
+                      {TSDB_DATA_TYPE_DOUBLE, 0, 5, 8},    {TSDB_DATA_TYPE_DOUBLE, 0, 6, 8}};
+  STSchema* pTSchema = tdGetSTSChemaFromSSChema(schema, 6, 1);
+  int32_t   numOfRows = 0;
+  setCheckInsertFunc([&](const SQuery* pQuery) {
+    SVnodeModifOpStmt* pStmt = (SVnodeModifOpStmt*)pQuery->pRoot;
+    ASSERT_EQ(taosArrayGetSize(pStmt->pDataBlocks), 1);
+    SVgDataBlocks* pVgData = (SVgDataBlocks*)taosArrayGetP(pStmt->pDataBlocks, 0);
+
+    SSubmitMsgIter msgIter = {0};
+    SSubmitBlk*    pBlk = NULL;
+    ASSERT_EQ(tInitSubmitMsgIter((SSubmitReq*)pVgData->pData, &msgIter), 0);
+    ASSERT_EQ(tGetSubmitMsgNext(&msgIter, &pBlk), 0);
+    ASSERT_NE(pBlk, nullptr);
+    ASSERT_EQ(msgIter.numOfRows, rows);
+
+    SSubmitBlkIter blkIter = {0};
+    ASSERT_EQ(tInitSubmitBlkIter(&msgIter, pBlk, &blkIter), 0);
+    numOfRows = 0;
+    STSRow* pRow = NULL;
+    while (NULL != (pRow = tGetSubmitBlkNext(&blkIter))) {
+      SColVal colVal = {0};
+      tTSRowGetVal(pRow, pTSchema, 0, &colVal);
+      ASSERT_EQ(colVal.value.val, 1659000000000 + numOfRows);
+      tTSRowGetVal(pRow, pTSchema, 1, &colVal);
+      ASSERT_EQ(*(int32_t*)&colVal.value.val, numOfRows);
+      tTSRowGetVal(pRow, pTSchema, 3, &colVal);
+      ASSERT_EQ(colVal.value.val, numOfRows * 3LL);
+      ++numOfRows;
+    }
+    tDestroySubmitBlkIter(&blkIter);
+  });
+
+  run(string("INSERT INTO t1 FILE '") + pFile + "'");
+  EXPECT_EQ(numOfRows, rows);
+  taosMemoryFree(pTSchema);
+  remove(pFile);
+}
+
 }  // namespace ParserTest
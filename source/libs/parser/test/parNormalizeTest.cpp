@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "parser.h"
+#include "ttokendef.h"
+
+namespace ParserTest {
+
+namespace {
+
+struct NormalizeResult {
+  bool                     cacheable;
+  std::string              key;
+  std::vector<int32_t>     types;
+  std::vector<std::string> literals;
+};
+
+NormalizeResult normalize(const std::string& sql) {
+  NormalizeResult res = {false};
+  char*           pKey = nullptr;
+  SArray*         pConsts = nullptr;
+  EXPECT_EQ(qNormalizeQuerySql(sql.c_str(), sql.length(), &pKey, &pConsts), TSDB_CODE_SUCCESS);
+  if (nullptr != pKey) {
+    res.cacheable = true;
+    res.key = pKey;
+    for (int32_t i = 0; i < taosArrayGetSize(pConsts); ++i) {
+      SQueryConstant* pConst = (SQueryConstant*)taosArrayGet(pConsts, i);
+      res.types.push_back(pConst->type);
+      res.literals.push_back(pConst->literal);
+    }
+  } else {
+    EXPECT_EQ(pConsts, nullptr);
+  }
+  taosMemoryFree(pKey);
+  qDestroyQueryConstants(pConsts);
+  return res;
+}
+
+}  // namespace
+
+TEST(parNormalizeTest, constants) {
+  NormalizeResult res = normalize("SELECT c1, c2 FROM t1 WHERE ts > 1626861392589 AND c1 = 1.5 AND c2 = 'abc'");
+  ASSERT_TRUE(res.cacheable);
+  EXPECT_EQ(res.key, "select c1 , c2 from t1 where ts > ?i and c1 = ?f and c2 = ?s");
+  EXPECT_EQ(res.types, (std::vector<int32_t>{TK_NK_INTEGER, TK_NK_FLOAT, TK_NK_STRING}));
+  EXPECT_EQ(res.literals, (std::vector<std::string>{"1626861392589", "1.5", "abc"}));
+}
+
+TEST(parNormalizeTest, sameKey) {
+  // case, blanks, comments and the constants do not make another key
+  NormalizeResult a = normalize("select * from t1 where c1 > 10 and c2 = \"x\"");
+  NormalizeResult b = normalize("SELECT  *\nFROM t1 /* comment */ WHERE c1 > 2000 AND c2 = 'longer string';");
+  ASSERT_TRUE(a.cacheable);
+  ASSERT_TRUE(b.cacheable);
+  EXPECT_EQ(a.key, b.key);
+  EXPECT_EQ(b.literals, (std::vector<std::string>{"2000", "longer string"}));
+
+  // the type of a constant is part of the key, and so are quoted names
+  EXPECT_NE(normalize("select * from t1 where c1 > 10").key, normalize("select * from t1 where c1 > 1.0").key);
+  EXPECT_NE(normalize("select * from `T1`").key, normalize("select * from `t1`").key);
+}
+
+TEST(parNormalizeTest, limit) {
+  // limits and offsets are kept in the key
+  NormalizeResult res = normalize("select * from st partition by tbname where c1 > 5 slimit 2 soffset 1 limit 10, 20");
+  ASSERT_TRUE(res.cacheable);
+  EXPECT_EQ(res.key, "select * from st partition by tbname where c1 > ?i slimit 2 soffset 1 limit 10 , 20");
+  EXPECT_EQ(res.literals, (std::vector<std::string>{"5"}));
+  EXPECT_NE(normalize("select * from t1 limit 10").key, normalize("select * from t1 limit 20").key);
+}
+
+TEST(parNormalizeTest, uncacheable) {
+  EXPECT_FALSE(normalize("insert into t1 values(now, 1)").cacheable);
+  EXPECT_FALSE(normalize("show databases").cacheable);
+  EXPECT_FALSE(normalize("select * from t1 where ts > now - 1h").cacheable);
+  EXPECT_FALSE(normalize("select * from t1 where ts > today()").cacheable);
+  EXPECT_FALSE(normalize("select database()").cacheable);
+  EXPECT_FALSE(normalize("select * from t1 where c1 = ?").cacheable);
+  EXPECT_FALSE(normalize("select * from t1 where c1 = 0x10").cacheable);
+  EXPECT_FALSE(normalize("select * from t1; select * from t2").cacheable);
+  EXPECT_FALSE(normalize("").cacheable);
+  EXPECT_TRUE(normalize("select * from t1 ;  ").cacheable);
+}
+
+}  // namespace ParserTest
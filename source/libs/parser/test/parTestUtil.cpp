@@ -283,6 +283,7 @@ class ParserTestBaseImpl {
   void doParseInsertSql(SParseContext* pCxt, SQuery** pQuery, SParseMetaCache* pMetaCache) {
     DO_WITH_THROW(parseInsertSql, pCxt, pQuery, pMetaCache);
     ASSERT_NE(*pQuery, nullptr);
+    checkQuery(*pQuery, PARSER_STAGE_TRANSLATE);
     res_.parsedAst_ = toString((*pQuery)->pRoot);
   }
 
@@ -118,6 +118,7 @@ typedef struct SQWTaskCtx {
   int8_t   explain;
   int8_t   needFetch;
   int8_t   localExec;
+  int8_t   fetchColFmt;  // the last fetcher of the task accepts columnar blocks
   int32_t  msgType;
   int32_t  fetchType;
   int32_t  execId;
@@ -128,6 +129,7 @@ typedef struct SQWTaskCtx {
   bool    queryEnd;
   bool    queryContinue;
   bool    queryInQueue;
+  bool    queryYield;  // last exec used up its time slice while other tasks were queued
   int32_t rspCode;
   int64_t affectedRows;  // for insert ...select stmt
 
@@ -106,6 +106,37 @@ int32_t qwSendQueryRsp(QW_FPARAMS_DEF, int32_t msgType, SQWTaskCtx *ctx, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
+// A task that has run longer than tsQueryTimeSlice gives way to the tasks queued behind it. Only tasks whose results
+// are fetched are sliced, the next fetch or the continue msg resumes them.
+static bool qwNeedYield(SQWorker *mgmt, SQWTaskCtx *ctx, int64_t startTs) {
+  if (tsQueryTimeSlice <= 0 || ctx->localExec || !ctx->needFetch || NULL == mgmt->msgCb.qsizeFp) {
+    return false;
+  }
+
+  if (taosGetTimestampMs() - startTs < tsQueryTimeSlice) {
+    return false;
+  }
+
+  return tmsgGetQueueSize(&mgmt->msgCb, mgmt->nodeId, QUERY_QUEUE) > 0;
+}
+
+// put the task to the tail of the query queue, ctx->lock shall be held
+static int32_t qwYieldTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, SRpcHandleInfo *pConn) {
+  if (atomic_load_8((int8_t *)&ctx->queryInQueue)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  atomic_store_8((int8_t *)&ctx->queryInQueue, 1);
+  int32_t code = qwBuildAndSendCQueryMsg(QW_FPARAMS(), pConn);
+  if (code) {
+    atomic_store_8((int8_t *)&ctx->queryInQueue, 0);
+    return code;
+  }
+
+  QW_TASK_DLOG_E("task yields to the queued tasks");
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
   int32_t        code = 0;
   bool           qcontinue = true;
@@ -115,6 +146,9 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
   qTaskInfo_t    taskHandle = ctx->taskHandle;
   DataSinkHandle sinkHandle = ctx->sinkHandle;
   SLocalFetch    localFetch = {(void *)mgmt, ctx->localExec, qWorkerProcessLocalFetch, ctx->explainRes};
+  int64_t        startTs = taosGetTimestampMs();
+
+  ctx->queryYield = false;
 
   SArray *pResList = taosArrayInit(4, POINTER_BYTES);
   while (true) {
@@ -190,6 +224,11 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
     if (atomic_load_32(&ctx->rspCode)) {
       break;
     }
+
+    if (qwNeedYield(mgmt, ctx, startTs)) {
+      ctx->queryYield = true;
+      break;
+    }
   }
 
 _return:
@@ -252,6 +291,7 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
     return TSDB_CODE_SUCCESS;
   }
 
+  dsSetColumnarOutput(ctx->sinkHandle, ctx->fetchColFmt);
   *dataLen = 0;
 
   while (true) {
@@ -669,6 +709,14 @@ _return:
     }
   }
 
+  if (ctx != NULL && TSDB_CODE_SUCCESS == code && ctx->queryYield) {
+    QW_LOCK(QW_WRITE, &ctx->lock);
+    if (!QW_QUERY_RUNNING(ctx) && !atomic_load_8((int8_t *)&ctx->queryEnd)) {
+      qwYieldTask(QW_FPARAMS(), ctx, &qwMsg->connInfo);
+    }
+    QW_UNLOCK(QW_WRITE, &ctx->lock);
+  }
+
   QW_RET(TSDB_CODE_SUCCESS);
 }
 
@@ -739,12 +787,17 @@ int32_t qwProcessCQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
     }
 
     QW_LOCK(QW_WRITE, &ctx->lock);
-    if (queryStop || code || 0 == atomic_load_8((int8_t *)&ctx->queryContinue)) {
+    if (queryStop || code || (0 == atomic_load_8((int8_t *)&ctx->queryContinue) && !ctx->queryYield)) {
       // Note: query is not running anymore
       QW_SET_PHASE(ctx, 0);
       QW_UNLOCK(QW_WRITE, &ctx->lock);
       break;
     }
+    if (ctx->queryYield && TSDB_CODE_SUCCESS == qwYieldTask(QW_FPARAMS(), ctx, &qwMsg->connInfo)) {
+      QW_SET_PHASE(ctx, 0);
+      QW_UNLOCK(QW_WRITE, &ctx->lock);
+      break;
+    }
     QW_UNLOCK(QW_WRITE, &ctx->lock);
   } while (true);
 
@@ -768,6 +821,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
 
   ctx->msgType = qwMsg->msgType;
   ctx->dataConnInfo = qwMsg->connInfo;
+  ctx->fetchColFmt = qwMsg->msgInfo.colFmt;
 
   SOutputData sOutput = {0};
   QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rsp, &sOutput));
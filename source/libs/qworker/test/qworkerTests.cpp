@@ -819,6 +819,118 @@ void *fetchQueueThread(void *param) {
   return NULL;
 }
 
+// The executor rewrites the subplan of its task, e.g. getColumn replaces the tbname functions of the tag condition.
+// Every task of a subplan sent again must still get the condition as it was sent.
+SNode    *qwtTagCond = NULL;
+SSubplan *qwtTagCondPlans[2] = {0};  // the tasks own their subplans, freed by the test as qDestroyTask is stubbed
+int32_t   qwtTagCondTaskNum = 0;
+int32_t   qwtTagCondMatchNum = 0;
+
+SNode *qwtMakeTagCond() {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->colId = 2;
+  pCol->colType = COLUMN_TYPE_TAG;
+  pCol->node.resType.type = TSDB_DATA_TYPE_INT;
+  pCol->node.resType.bytes = sizeof(int32_t);
+  strcpy(pCol->colName, "t1");
+
+  SValueNode *pVal = (SValueNode *)nodesMakeNode(QUERY_NODE_VALUE);
+  pVal->node.resType.type = TSDB_DATA_TYPE_INT;
+  pVal->node.resType.bytes = sizeof(int32_t);
+  pVal->literal = strdup("1");
+  pVal->translate = true;
+  pVal->datum.i = 1;
+
+  SOperatorNode *pOp = (SOperatorNode *)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOp->opType = OP_TYPE_EQUAL;
+  pOp->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOp->node.resType.bytes = sizeof(bool);
+  pOp->pLeft = (SNode *)pCol;
+  pOp->pRight = (SNode *)pVal;
+  return (SNode *)pOp;
+}
+
+void qwtBuildTagCondQueryRpc(const char *pPlanMsg, int32_t planLen, SRpcMsg *queryRpc) {
+  int32_t       msgLen = sizeof(SSubQueryMsg) + planLen;
+  SSubQueryMsg *pMsg = (SSubQueryMsg *)taosMemoryCalloc(1, msgLen);
+  pMsg->queryId = htobe64(atomic_add_fetch_64(&qwtTestQueryId, 1));
+  pMsg->sId = htobe64(1);
+  pMsg->taskId = htobe64(1);
+  pMsg->phyLen = htonl(planLen);
+  pMsg->sqlLen = 0;
+  memcpy(pMsg->msg, pPlanMsg, planLen);
+
+  queryRpc->msgType = TDMT_SCH_QUERY;
+  queryRpc->pCont = pMsg;
+  queryRpc->contLen = msgLen;
+}
+
+int32_t qwtCreateTagCondTask(void *readHandle, int32_t vgId, uint64_t taskId, struct SSubplan *pPlan,
+                             qTaskInfo_t *pTaskInfo, DataSinkHandle *handle, char *sql, EOPTR_EXEC_MODEL model) {
+  if (nodesEqualNode(qwtTagCond, pPlan->pTagCond)) {
+    ++qwtTagCondMatchNum;
+  }
+  qwtTagCondPlans[qwtTagCondTaskNum++ % 2] = pPlan;
+
+  nodesDestroyNode(pPlan->pTagCond);
+  pPlan->pTagCond = nodesMakeNode(QUERY_NODE_VALUE);
+  taosMemoryFree(sql);
+
+  qwtTestSinkBlockNum = 0;
+  qwtTestSinkMaxBlockNum = 1;
+  qwtTestSinkQueryEnd = true;
+  *pTaskInfo = (qTaskInfo_t)0x1;
+  *handle = (DataSinkHandle)0x2;
+  return 0;
+}
+
+int32_t qwtExecTagCondTask(qTaskInfo_t tinfo, SArray *pResList, uint64_t *useconds, bool *hasMore,
+                           SLocalFetch *pLocal) {
+  *useconds = 0;
+  *hasMore = false;
+  return 0;
+}
+
+void stubSetExecTagCondTask() {
+  static Stub stub;
+  stub.set(qExecTaskOpt, qwtExecTagCondTask);
+  {
+#ifdef WINDOWS
+    AddrAny                       any;
+    std::map<std::string, void *> result;
+    any.get_func_addr("qExecTaskOpt", result);
+#endif
+#ifdef LINUX
+    AddrAny                       any("libexecutor.so");
+    std::map<std::string, void *> result;
+    any.get_global_func_addr_dynsym("^qExecTaskOpt$", result);
+#endif
+    for (const auto &f : result) {
+      stub.set(f.second, qwtExecTagCondTask);
+    }
+  }
+}
+
+void stubSetCreateTagCondTask() {
+  static Stub stub;
+  stub.set(qCreateExecTask, qwtCreateTagCondTask);
+  {
+#ifdef WINDOWS
+    AddrAny                       any;
+    std::map<std::string, void *> result;
+    any.get_func_addr("qCreateExecTask", result);
+#endif
+#ifdef LINUX
+    AddrAny                       any("libexecutor.so");
+    std::map<std::string, void *> result;
+    any.get_global_func_addr_dynsym("^qCreateExecTask$", result);
+#endif
+    for (const auto &f : result) {
+      stub.set(f.second, qwtCreateTagCondTask);
+    }
+  }
+}
+
 }  // namespace
 
 TEST(seqTest, normalCase) {
@@ -868,6 +980,79 @@ TEST(seqTest, normalCase) {
   qWorkerDestroy(&mgmt);
 }
 
+TEST(seqTest, sameSubplanTwice) {
+  void   *mgmt = NULL;
+  int32_t code = 0;
+  void   *mockPointer = (void *)0x1;
+
+  qwtInitLogFile();
+
+  SSubplan *pPlan = (SSubplan *)nodesMakeNode(QUERY_NODE_PHYSICAL_SUBPLAN);
+  pPlan->id.queryId = 1;
+  pPlan->id.groupId = 1;
+  pPlan->id.subplanId = 1;
+  pPlan->subplanType = SUBPLAN_TYPE_SCAN;
+  pPlan->msgType = TDMT_SCH_QUERY;
+  pPlan->execNode.nodeId = 1;
+  pPlan->pTagCond = qwtMakeTagCond();
+
+  char   *pPlanMsg = NULL;
+  int32_t planLen = 0;
+  ASSERT_EQ(qSubPlanToMsg(pPlan, &pPlanMsg, &planLen), 0);
+
+  // the decoding converts the message in place
+  char *pSentMsg = (char *)taosMemoryMalloc(planLen);
+  memcpy(pSentMsg, pPlanMsg, planLen);
+  SSubplan *pSent = NULL;
+  ASSERT_EQ(qMsgToSubplan(pSentMsg, planLen, &pSent), 0);
+  taosMemoryFree(pSentMsg);
+  qwtTagCond = pSent->pTagCond;
+
+  stubSetRpcSendResponse();
+  stubSetExecTagCondTask();
+  stubSetCreateTagCondTask();
+  stubSetAsyncKillTask();
+  stubSetDestroyTask();
+  stubSetDestroyDataSinker();
+  stubSetGetDataLength();
+  stubSetEndPut();
+  stubSetPutDataBlock();
+  stubSetGetDataBlock();
+
+  SMsgCb msgCb = {0};
+  msgCb.mgmt = (void *)mockPointer;
+  msgCb.putToQueueFp = (PutToQueueFp)qwtPutReqToQueue;
+  code = qWorkerInit(NODE_TYPE_VNODE, 1, &mgmt, &msgCb);
+  ASSERT_EQ(code, 0);
+
+  for (int32_t i = 0; i < 2; ++i) {
+    SRpcMsg queryRpc = {0};
+    SRpcMsg dropRpc = {0};
+    qwtBuildTagCondQueryRpc(pPlanMsg, planLen, &queryRpc);
+    qwtBuildDropReqMsg(&qwtdropMsg, &dropRpc);
+
+    code = qWorkerPreprocessQueryMsg(mgmt, &queryRpc);
+    ASSERT_EQ(code, 0);
+    code = qWorkerProcessQueryMsg(mockPointer, mgmt, &queryRpc, 0);
+    ASSERT_EQ(code, 0);
+    code = qWorkerProcessDropMsg(mockPointer, mgmt, &dropRpc, 0);
+    ASSERT_EQ(code, 0);
+    taosMemoryFree(queryRpc.pCont);
+  }
+
+  // the second task got the tag condition the first one rewrote as it was sent
+  ASSERT_EQ(qwtTagCondTaskNum, 2);
+  ASSERT_EQ(qwtTagCondMatchNum, 2);
+
+  qWorkerDestroy(&mgmt);
+  for (int32_t i = 0; i < 2; ++i) {
+    nodesDestroyNode((SNode *)qwtTagCondPlans[i]);
+  }
+  taosMemoryFree(pPlanMsg);
+  nodesDestroyNode((SNode *)pSent);
+  nodesDestroyNode((SNode *)pPlan);
+}
+
 TEST(seqTest, cancelFirst) {
   void   *mgmt = NULL;
   int32_t code = 0;
@@ -1082,6 +1082,8 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       pMsg->queryId = htobe64(pJob->queryId);
       pMsg->taskId = htobe64(pTask->taskId);
       pMsg->execId = htonl(pTask->execId);
+      pMsg->ver = htonl(RES_FETCH_REQ_VER);
+      pMsg->colFmt = 1;
 
       break;
     }
@@ -32,6 +32,11 @@ typedef struct {
 
 static SStreamGlobalEnv streamEnv;
 
+#define STREAM_EXEC_BATCH_INIT     16
+#define STREAM_EXEC_BATCH_MAX      4096
+#define STREAM_EXEC_LATENCY_US     (100 * 1000)
+#define STREAM_DISPATCH_BATCH_SIZE (4 * 1024 * 1024)
+
 // int32_t streamPipelineExec(SStreamTask* pTask, int32_t batchNum, bool dispatch);
 
 int32_t streamDispatch(SStreamTask* pTask);
@@ -49,6 +54,15 @@ int32_t streamDispatchOneRecoverFinishReq(SStreamTask* pTask, const SStreamRecov
 SStreamQueueItem* streamMergeQueueItem(SStreamQueueItem* dst, SStreamQueueItem* elem);
 void              streamFreeQitem(SStreamQueueItem* data);
 
+SStreamStateBuf* streamStateBufOpen(TTB* pDb, TXN* pTxn, tdb_cmpr_fn_t cmpr, int32_t keyLen, int64_t capacity);
+void             streamStateBufClose(SStreamStateBuf* pBuf);
+void             streamStateBufClear(SStreamStateBuf* pBuf);
+int32_t          streamStateBufPut(SStreamStateBuf* pBuf, const void* key, const void* value, int32_t vLen);
+int32_t          streamStateBufGet(SStreamStateBuf* pBuf, const void* key, void** pVal, int32_t* pVLen);
+int32_t          streamStateBufDel(SStreamStateBuf* pBuf, const void* key);
+int32_t          streamStateBufFlush(SStreamStateBuf* pBuf);
+int32_t          streamStateBufFlushRange(SStreamStateBuf* pBuf, const void* sKey, const void* eKey);
+
 #ifdef __cplusplus
 }
 #endif
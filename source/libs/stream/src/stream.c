@@ -119,8 +119,11 @@ int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SR
     // decode
     /*pData->blocks = pReq->data;*/
     /*pBlock->sourceVer = pReq->sourceVer;*/
-    streamDispatchReqToData(pReq, pData);
-    if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
+    if (streamDispatchReqToData(pReq, pData) != 0) {
+      qError("task %d failed to decode the dispatched blocks from task %d", pTask->taskId, pReq->upstreamTaskId);
+      taosFreeQitem(pData);
+      status = TASK_INPUT_STATUS__FAILED;
+    } else if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
       status = TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
@@ -157,8 +160,11 @@ int32_t streamTaskEnqueueRetrieve(SStreamTask* pTask, SStreamRetrieveReq* pReq,
     // decode
     /*pData->blocks = pReq->data;*/
     /*pBlock->sourceVer = pReq->sourceVer;*/
-    streamRetrieveReqToData(pReq, pData);
-    if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
+    if (streamRetrieveReqToData(pReq, pData) != 0) {
+      qError("task %d failed to decode the retrieve req from task %d", pTask->taskId, pReq->srcTaskId);
+      taosFreeQitem(pData);
+      status = TASK_INPUT_STATUS__FAILED;
+    } else if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
       status = TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
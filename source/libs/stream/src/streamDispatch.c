@@ -454,6 +454,14 @@ int32_t streamDispatchAllBlocks(SStreamTask* pTask, const SStreamDataBlock* pDat
   return 0;
 }
 
+static int64_t streamDataBlockGetSize(const SStreamDataBlock* pBlock) {
+  int64_t size = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pBlock->blocks); i++) {
+    size += blockDataGetSize(taosArrayGet(pBlock->blocks, i));
+  }
+  return size;
+}
+
 int32_t streamDispatch(SStreamTask* pTask) {
   ASSERT(pTask->outputType == TASK_OUTPUT__FIXED_DISPATCH || pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH);
 
@@ -471,7 +479,25 @@ int32_t streamDispatch(SStreamTask* pTask) {
   }
   ASSERT(pBlock->type == STREAM_INPUT__DATA_BLOCK);
 
-  qDebug("stream dispatching: task %d", pTask->taskId);
+  // coalesce the pending outputs into one dispatch msg
+  int32_t batchCnt = 1;
+  int64_t size = streamDataBlockGetSize(pBlock);
+  while (size < STREAM_DISPATCH_BATCH_SIZE) {
+    SStreamDataBlock* pNext = streamQueueNextItem(pTask->outputQueue);
+    if (pNext == NULL) {
+      break;
+    }
+    int64_t nextSize = streamDataBlockGetSize(pNext);
+    if (size + nextSize > STREAM_DISPATCH_BATCH_SIZE ||
+        streamMergeQueueItem((SStreamQueueItem*)pBlock, (SStreamQueueItem*)pNext) == NULL) {
+      streamQueueProcessFail(pTask->outputQueue);
+      break;
+    }
+    size += nextSize;
+    batchCnt++;
+  }
+
+  qDebug("stream dispatching: task %d, merged outputs: %d, size: %" PRId64, pTask->taskId, batchCnt, size);
 
   int32_t code = 0;
   if (streamDispatchAllBlocks(pTask, pBlock) < 0) {
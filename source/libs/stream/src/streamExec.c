@@ -199,11 +199,45 @@ int32_t streamPipelineExec(SStreamTask* pTask, int32_t batchNum, bool dispatch)
 }
 #endif
 
+// Grow the merge limit while the queue keeps filling whole batches within the latency target, shrink it once an
+// execution overruns the target.
+static void streamTaskUpdateExecStatis(SStreamTask* pTask, int32_t batchCnt, SArray* pRes, int64_t elapsed) {
+  STaskExecStatis* pStatis = &pTask->execStatis;
+
+  pStatis->execNum++;
+  pStatis->inputItems += batchCnt;
+  pStatis->execTimeUs += elapsed;
+  if (elapsed > pStatis->maxExecUs) pStatis->maxExecUs = elapsed;
+  for (int32_t i = 0; i < taosArrayGetSize(pRes); i++) {
+    pStatis->outputRows += ((SSDataBlock*)taosArrayGet(pRes, i))->info.rows;
+  }
+
+  if (elapsed > STREAM_EXEC_LATENCY_US) {
+    pStatis->batchSize = TMAX(pStatis->batchSize / 2, 1);
+  } else if (batchCnt >= pStatis->batchSize && elapsed < STREAM_EXEC_LATENCY_US / 2) {
+    pStatis->batchSize = TMIN(pStatis->batchSize * 2, STREAM_EXEC_BATCH_MAX);
+  }
+
+  qDebug("stream task %d exec %d msgs in %" PRId64 "us, next batch: %d, total exec: %" PRId64 ", avg latency: %" PRId64
+         "us, max latency: %" PRId64 "us, throughput: %.2f msgs/s",
+         pTask->taskId, batchCnt, elapsed, pStatis->batchSize, pStatis->execNum,
+         pStatis->execTimeUs / pStatis->execNum, pStatis->maxExecUs,
+         pStatis->execTimeUs > 0 ? pStatis->inputItems * 1000000.0 / pStatis->execTimeUs : 0.0);
+}
+
 int32_t streamExecForAll(SStreamTask* pTask) {
+  if (pTask->execStatis.batchSize <= 0) {
+    pTask->execStatis.batchSize = STREAM_EXEC_BATCH_INIT;
+  }
+
   while (1) {
     int32_t batchCnt = 1;
     void*   data = NULL;
     while (1) {
+      if (data != NULL && batchCnt >= pTask->execStatis.batchSize) {
+        break;
+      }
+
       SStreamQueueItem* qItem = streamQueueNextItem(pTask->inputQueue);
       if (qItem == NULL) {
         qDebug("stream task exec over, queue empty, task: %d", pTask->taskId);
@@ -246,8 +280,9 @@ int32_t streamExecForAll(SStreamTask* pTask) {
     SArray* pRes = taosArrayInit(0, sizeof(SSDataBlock));
 
     qDebug("stream task %d exec begin, msg batch: %d", pTask->taskId, batchCnt);
+    int64_t st = taosGetTimestampUs();
     streamTaskExecImpl(pTask, data, pRes);
-    qDebug("stream task %d exec end", pTask->taskId);
+    streamTaskUpdateExecStatis(pTask, batchCnt, pRes, taosGetTimestampUs() - st);
 
     if (taosArrayGetSize(pRes) != 0) {
       SStreamDataBlock* qRes = taosAllocateQitem(sizeof(SStreamDataBlock), DEF_QITEM);
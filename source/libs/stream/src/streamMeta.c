@@ -48,6 +48,7 @@ SStreamMeta* streamMetaOpen(const char* path, void* ahandle, FTaskExpand expandF
   if (pMeta->pTasks == NULL) {
     goto _err;
   }
+  taosInitRWLatch(&pMeta->lock);
 
   if (streamMetaBegin(pMeta) < 0) {
     goto _err;
@@ -105,12 +106,17 @@ int32_t streamMetaAddSerializedTask(SStreamMeta* pMeta, int64_t ver, char* msg,
     goto FAIL;
   }
 
-  if (taosHashPut(pMeta->pTasks, &pTask->taskId, sizeof(int32_t), &pTask, sizeof(void*)) < 0) {
+  taosWLockLatch(&pMeta->lock);
+  int32_t ret = taosHashPut(pMeta->pTasks, &pTask->taskId, sizeof(int32_t), &pTask, sizeof(void*));
+  taosWUnLockLatch(&pMeta->lock);
+  if (ret < 0) {
     goto FAIL;
   }
 
   if (tdbTbUpsert(pMeta->pTaskDb, &pTask->taskId, sizeof(int32_t), msg, msgLen, &pMeta->txn) < 0) {
+    taosWLockLatch(&pMeta->lock);
     taosHashRemove(pMeta->pTasks, &pTask->taskId, sizeof(int32_t));
+    taosWUnLockLatch(&pMeta->lock);
     ASSERT(0);
     goto FAIL;
   }
@@ -152,7 +158,9 @@ int32_t streamMetaAddTask(SStreamMeta* pMeta, int64_t ver, SStreamTask* pTask) {
   }
 
   taosMemoryFree(buf);
+  taosWLockLatch(&pMeta->lock);
   taosHashPut(pMeta->pTasks, &pTask->taskId, sizeof(int32_t), &pTask, sizeof(void*));
+  taosWUnLockLatch(&pMeta->lock);
 
   return 0;
 }
@@ -168,11 +176,40 @@ SStreamTask* streamMetaGetTask(SStreamMeta* pMeta, int32_t taskId) {
   }
 }
 
+int32_t streamMetaGetTaskLoads(SStreamMeta* pMeta, SArray* pLoads) {
+  taosRLockLatch(&pMeta->lock);
+  void* pIter = NULL;
+  while ((pIter = taosHashIterate(pMeta->pTasks, pIter)) != NULL) {
+    SStreamTask*     pTask = *(SStreamTask**)pIter;
+    STaskExecStatis* pStatis = &pTask->execStatis;
+    SStreamTaskLoad  load = {
+         .streamId = pTask->streamId,
+         .taskId = pTask->taskId,
+         .batchSize = pStatis->batchSize,
+         .execNum = pStatis->execNum,
+         .inputItems = pStatis->inputItems,
+         .outputRows = pStatis->outputRows,
+         .execTimeUs = pStatis->execTimeUs,
+         .maxExecUs = pStatis->maxExecUs,
+    };
+    if (taosArrayPush(pLoads, &load) == NULL) {
+      taosHashCancelIterate(pMeta->pTasks, pIter);
+      taosRUnLockLatch(&pMeta->lock);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+  taosRUnLockLatch(&pMeta->lock);
+  return 0;
+}
+
 int32_t streamMetaRemoveTask(SStreamMeta* pMeta, int32_t taskId) {
   SStreamTask** ppTask = (SStreamTask**)taosHashGet(pMeta->pTasks, &taskId, sizeof(int32_t));
   if (ppTask) {
     SStreamTask* pTask = *ppTask;
+    taosWLockLatch(&pMeta->lock);
     taosHashRemove(pMeta->pTasks, &taskId, sizeof(int32_t));
+    taosWUnLockLatch(&pMeta->lock);
     atomic_store_8(&pTask->taskStatus, TASK_STATUS__DROPPING);
 
     if (tdbTbDelete(pMeta->pTaskDb, &taskId, sizeof(int32_t), &pMeta->txn) < 0) {
@@ -275,7 +312,10 @@ int32_t streamLoadTasks(SStreamMeta* pMeta) {
       return -1;
     }
 
-    if (taosHashPut(pMeta->pTasks, &pTask->taskId, sizeof(int32_t), &pTask, sizeof(void*)) < 0) {
+    taosWLockLatch(&pMeta->lock);
+    int32_t ret = taosHashPut(pMeta->pTasks, &pTask->taskId, sizeof(int32_t), &pTask, sizeof(void*));
+    taosWUnLockLatch(&pMeta->lock);
+    if (ret < 0) {
       tdbFree(pKey);
       tdbFree(pVal);
       tdbTbcClose(pCur);
@@ -16,6 +16,7 @@
 #include "executor.h"
 #include "streamInc.h"
 #include "tcommon.h"
+#include "tglobal.h"
 #include "ttimer.h"
 
 // todo refactor
@@ -122,6 +123,14 @@ SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int
     goto _err;
   }
 
+  if (tsStreamBufferSize > 0) {
+    pState->pBuf =
+        streamStateBufOpen(pState->pStateDb, &pState->txn, stateKeyCmpr, sizeof(SStateKey), (int64_t)tsStreamBufferSize << 20);
+    if (pState->pBuf == NULL) {
+      goto _err;
+    }
+  }
+
   if (streamStateBegin(pState) < 0) {
     goto _err;
   }
@@ -131,6 +140,7 @@ SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int
   return pState;
 
 _err:
+  streamStateBufClose(pState->pBuf);
   tdbTbClose(pState->pStateDb);
   tdbTbClose(pState->pFuncStateDb);
   tdbTbClose(pState->pFillStateDb);
@@ -141,7 +151,9 @@ _err:
 }
 
 void streamStateClose(SStreamState* pState) {
+  if (pState->pBuf) streamStateBufFlush(pState->pBuf);
   tdbCommit(pState->db, &pState->txn);
+  streamStateBufClose(pState->pBuf);
   tdbTbClose(pState->pStateDb);
   tdbTbClose(pState->pFuncStateDb);
   tdbTbClose(pState->pFillStateDb);
@@ -164,7 +176,11 @@ int32_t streamStateBegin(SStreamState* pState) {
   return 0;
 }
 
+// only the states changed since the last commit are written out
 int32_t streamStateCommit(SStreamState* pState) {
+  if (pState->pBuf && streamStateBufFlush(pState->pBuf) < 0) {
+    return -1;
+  }
   if (tdbCommit(pState->db, &pState->txn) < 0) {
     return -1;
   }
@@ -180,6 +196,7 @@ int32_t streamStateCommit(SStreamState* pState) {
 }
 
 int32_t streamStateAbort(SStreamState* pState) {
+  if (pState->pBuf) streamStateBufClear(pState->pBuf);
   if (tdbAbort(pState->db, &pState->txn) < 0) {
     return -1;
   }
@@ -208,6 +225,7 @@ int32_t streamStateFuncDel(SStreamState* pState, const STupleKey* key) {
 // todo refactor
 int32_t streamStatePut(SStreamState* pState, const SWinKey* key, const void* value, int32_t vLen) {
   SStateKey sKey = {.key = *key, .opNum = pState->number};
+  if (pState->pBuf) return streamStateBufPut(pState->pBuf, &sKey, value, vLen);
   return tdbTbUpsert(pState->pStateDb, &sKey, sizeof(SStateKey), value, vLen, &pState->txn);
 }
 
@@ -219,6 +237,7 @@ int32_t streamStateFillPut(SStreamState* pState, const SWinKey* key, const void*
 // todo refactor
 int32_t streamStateGet(SStreamState* pState, const SWinKey* key, void** pVal, int32_t* pVLen) {
   SStateKey sKey = {.key = *key, .opNum = pState->number};
+  if (pState->pBuf) return streamStateBufGet(pState->pBuf, &sKey, pVal, pVLen);
   return tdbTbGet(pState->pStateDb, &sKey, sizeof(SStateKey), pVal, pVLen);
 }
 
@@ -230,6 +249,7 @@ int32_t streamStateFillGet(SStreamState* pState, const SWinKey* key, void** pVal
 // todo refactor
 int32_t streamStateDel(SStreamState* pState, const SWinKey* key) {
   SStateKey sKey = {.key = *key, .opNum = pState->number};
+  if (pState->pBuf) return streamStateBufDel(pState->pBuf, &sKey);
   return tdbTbDelete(pState->pStateDb, &sKey, sizeof(SStateKey), &pState->txn);
 }
 
@@ -277,7 +297,17 @@ int32_t streamStateReleaseBuf(SStreamState* pState, const SWinKey* key, void* pV
   return 0;
 }
 
+// Cursors only see tdb and only the keys of their own operator, both ways from the start key.
+static int32_t streamStateFlushOpBuf(SStreamState* pState) {
+  if (pState->pBuf == NULL) return 0;
+  SStateKey sKey = {.key = {.ts = INT64_MIN, .groupId = 0}, .opNum = pState->number};
+  SStateKey eKey = {.key = {.ts = INT64_MAX, .groupId = UINT64_MAX}, .opNum = pState->number};
+  return streamStateBufFlushRange(pState->pBuf, &sKey, &eKey);
+}
+
 SStreamStateCur* streamStateGetCur(SStreamState* pState, const SWinKey* key) {
+  if (streamStateFlushOpBuf(pState) < 0) return NULL;
+
   SStreamStateCur* pCur = taosMemoryCalloc(1, sizeof(SStreamStateCur));
   if (pCur == NULL) return NULL;
   tdbTbcOpen(pState->pStateDb, &pCur->pCur, NULL);
@@ -383,6 +413,8 @@ int32_t streamStateSeekLast(SStreamState* pState, SStreamStateCur* pCur) {
 }
 
 SStreamStateCur* streamStateSeekKeyNext(SStreamState* pState, const SWinKey* key) {
+  if (streamStateFlushOpBuf(pState) < 0) return NULL;
+
   SStreamStateCur* pCur = taosMemoryCalloc(1, sizeof(SStreamStateCur));
   if (pCur == NULL) {
     return NULL;
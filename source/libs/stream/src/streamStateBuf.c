@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamInc.h"
+
+typedef struct SStateBufEntry {
+  struct SStateBufEntry* prev;
+  struct SStateBufEntry* next;
+  struct SStateBufEntry* dPrev;  // dirty list
+  struct SStateBufEntry* dNext;
+  void*                  pVal;
+  int32_t                vLen;
+  int8_t                 dirty;
+  int8_t                 deleted;
+  char                   key[];
+} SStateBufEntry;
+
+// Write-back buffer in front of a state table: the hot window states live in memory, tdb only sees the last
+// version of a dirty key when the buffer is flushed or the entry is evicted.
+struct SStreamStateBuf {
+  TTB*            pDb;
+  TXN*            pTxn;
+  tdb_cmpr_fn_t   cmpr;
+  int32_t         keyLen;
+  int64_t         capacity;
+  int64_t         memSize;
+  SHashObj*       pMap;   // key -> SStateBufEntry*
+  SStateBufEntry* pHead;  // most recently used
+  SStateBufEntry* pTail;
+  SStateBufEntry* pDirty;  // entries not yet written to tdb, flushes only walk these
+};
+
+static int64_t stateBufEntrySize(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  return sizeof(SStateBufEntry) + pBuf->keyLen + pEntry->vLen;
+}
+
+static void stateBufUnlink(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  if (pEntry->prev) {
+    pEntry->prev->next = pEntry->next;
+  } else {
+    pBuf->pHead = pEntry->next;
+  }
+  if (pEntry->next) {
+    pEntry->next->prev = pEntry->prev;
+  } else {
+    pBuf->pTail = pEntry->prev;
+  }
+  pEntry->prev = pEntry->next = NULL;
+}
+
+static void stateBufPushHead(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  pEntry->prev = NULL;
+  pEntry->next = pBuf->pHead;
+  if (pBuf->pHead) {
+    pBuf->pHead->prev = pEntry;
+  } else {
+    pBuf->pTail = pEntry;
+  }
+  pBuf->pHead = pEntry;
+}
+
+static void stateBufTouch(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  if (pBuf->pHead == pEntry) return;
+  stateBufUnlink(pBuf, pEntry);
+  stateBufPushHead(pBuf, pEntry);
+}
+
+static void stateBufSetDirty(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  if (pEntry->dirty) return;
+  pEntry->dirty = 1;
+  pEntry->dPrev = NULL;
+  pEntry->dNext = pBuf->pDirty;
+  if (pBuf->pDirty) pBuf->pDirty->dPrev = pEntry;
+  pBuf->pDirty = pEntry;
+}
+
+static void stateBufSetClean(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  if (!pEntry->dirty) return;
+  if (pEntry->dPrev) {
+    pEntry->dPrev->dNext = pEntry->dNext;
+  } else {
+    pBuf->pDirty = pEntry->dNext;
+  }
+  if (pEntry->dNext) pEntry->dNext->dPrev = pEntry->dPrev;
+  pEntry->dPrev = pEntry->dNext = NULL;
+  pEntry->dirty = 0;
+}
+
+static void stateBufRemove(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  stateBufSetClean(pBuf, pEntry);
+  stateBufUnlink(pBuf, pEntry);
+  taosHashRemove(pBuf->pMap, pEntry->key, pBuf->keyLen);
+  pBuf->memSize -= stateBufEntrySize(pBuf, pEntry);
+  taosMemoryFree(pEntry->pVal);
+  taosMemoryFree(pEntry);
+}
+
+static int32_t stateBufSetVal(SStreamStateBuf* pBuf, SStateBufEntry* pEntry, const void* value, int32_t vLen) {
+  void* pVal = NULL;
+  if (vLen > 0) {
+    pVal = taosMemoryMalloc(vLen);
+    if (pVal == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    memcpy(pVal, value, vLen);
+  }
+
+  pBuf->memSize += vLen - pEntry->vLen;
+  taosMemoryFree(pEntry->pVal);
+  pEntry->pVal = pVal;
+  pEntry->vLen = vLen;
+  return 0;
+}
+
+static int32_t stateBufWriteBack(SStreamStateBuf* pBuf, SStateBufEntry* pEntry) {
+  if (!pEntry->dirty) return 0;
+
+  if (pEntry->deleted) {
+    // the key may never have reached tdb
+    tdbTbDelete(pBuf->pDb, pEntry->key, pBuf->keyLen, pBuf->pTxn);
+  } else if (tdbTbUpsert(pBuf->pDb, pEntry->key, pBuf->keyLen, pEntry->pVal, pEntry->vLen, pBuf->pTxn) < 0) {
+    return -1;
+  }
+
+  stateBufSetClean(pBuf, pEntry);
+  return 0;
+}
+
+static SStateBufEntry* stateBufAdd(SStreamStateBuf* pBuf, const void* key, const void* value, int32_t vLen) {
+  SStateBufEntry* pEntry = taosMemoryCalloc(1, sizeof(SStateBufEntry) + pBuf->keyLen);
+  if (pEntry == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  memcpy(pEntry->key, key, pBuf->keyLen);
+  pBuf->memSize += stateBufEntrySize(pBuf, pEntry);
+
+  if (stateBufSetVal(pBuf, pEntry, value, vLen) < 0 ||
+      taosHashPut(pBuf->pMap, key, pBuf->keyLen, &pEntry, POINTER_BYTES) < 0) {
+    pBuf->memSize -= stateBufEntrySize(pBuf, pEntry);
+    taosMemoryFree(pEntry->pVal);
+    taosMemoryFree(pEntry);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  stateBufPushHead(pBuf, pEntry);
+  return pEntry;
+}
+
+static int32_t stateBufEvict(SStreamStateBuf* pBuf) {
+  while (pBuf->memSize > pBuf->capacity && pBuf->pTail && pBuf->pTail != pBuf->pHead) {
+    SStateBufEntry* pEntry = pBuf->pTail;
+    if (stateBufWriteBack(pBuf, pEntry) < 0) {
+      return -1;
+    }
+    stateBufRemove(pBuf, pEntry);
+  }
+  return 0;
+}
+
+static SStateBufEntry* stateBufGetEntry(SStreamStateBuf* pBuf, const void* key) {
+  SStateBufEntry** ppEntry = taosHashGet(pBuf->pMap, key, pBuf->keyLen);
+  return ppEntry ? *ppEntry : NULL;
+}
+
+SStreamStateBuf* streamStateBufOpen(TTB* pDb, TXN* pTxn, tdb_cmpr_fn_t cmpr, int32_t keyLen, int64_t capacity) {
+  SStreamStateBuf* pBuf = taosMemoryCalloc(1, sizeof(SStreamStateBuf));
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pBuf->pMap = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (pBuf->pMap == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    taosMemoryFree(pBuf);
+    return NULL;
+  }
+
+  pBuf->pDb = pDb;
+  pBuf->pTxn = pTxn;
+  pBuf->cmpr = cmpr;
+  pBuf->keyLen = keyLen;
+  pBuf->capacity = capacity;
+  return pBuf;
+}
+
+void streamStateBufClose(SStreamStateBuf* pBuf) {
+  if (pBuf == NULL) return;
+
+  streamStateBufClear(pBuf);
+  taosHashCleanup(pBuf->pMap);
+  taosMemoryFree(pBuf);
+}
+
+void streamStateBufClear(SStreamStateBuf* pBuf) {
+  while (pBuf->pHead) {
+    stateBufRemove(pBuf, pBuf->pHead);
+  }
+}
+
+int32_t streamStateBufPut(SStreamStateBuf* pBuf, const void* key, const void* value, int32_t vLen) {
+  SStateBufEntry* pEntry = stateBufGetEntry(pBuf, key);
+  if (pEntry) {
+    if (stateBufSetVal(pBuf, pEntry, value, vLen) < 0) {
+      return -1;
+    }
+    stateBufTouch(pBuf, pEntry);
+  } else {
+    pEntry = stateBufAdd(pBuf, key, value, vLen);
+    if (pEntry == NULL) {
+      return -1;
+    }
+  }
+
+  stateBufSetDirty(pBuf, pEntry);
+  pEntry->deleted = 0;
+  return stateBufEvict(pBuf);
+}
+
+// same contract as tdbTbGet: *pVal is allocated by tdbRealloc and released with streamFreeVal
+int32_t streamStateBufGet(SStreamStateBuf* pBuf, const void* key, void** pVal, int32_t* pVLen) {
+  SStateBufEntry* pEntry = stateBufGetEntry(pBuf, key);
+  if (pEntry == NULL) {
+    void*   pTmp = NULL;
+    int32_t vLen = 0;
+    if (tdbTbGet(pBuf->pDb, key, pBuf->keyLen, &pTmp, &vLen) < 0) {
+      return -1;
+    }
+
+    pEntry = stateBufAdd(pBuf, key, pTmp, vLen);
+    if (pEntry == NULL || stateBufEvict(pBuf) < 0) {
+      tdbFree(pTmp);
+      return -1;
+    }
+
+    if (pVal) {
+      *pVal = pTmp;
+    } else {
+      tdbFree(pTmp);
+    }
+    if (pVLen) *pVLen = vLen;
+    return 0;
+  }
+
+  if (pEntry->deleted) {
+    return -1;
+  }
+
+  stateBufTouch(pBuf, pEntry);
+  if (pVal) {
+    *pVal = tdbRealloc(NULL, pEntry->vLen);
+    if (*pVal == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    if (pEntry->vLen > 0) memcpy(*pVal, pEntry->pVal, pEntry->vLen);
+  }
+  if (pVLen) *pVLen = pEntry->vLen;
+  return 0;
+}
+
+int32_t streamStateBufDel(SStreamStateBuf* pBuf, const void* key) {
+  SStateBufEntry* pEntry = stateBufGetEntry(pBuf, key);
+  if (pEntry == NULL) {
+    return tdbTbDelete(pBuf->pDb, key, pBuf->keyLen, pBuf->pTxn);
+  }
+
+  if (pEntry->deleted) {
+    return -1;
+  }
+
+  stateBufSetVal(pBuf, pEntry, NULL, 0);
+  stateBufSetDirty(pBuf, pEntry);
+  pEntry->deleted = 1;
+  stateBufTouch(pBuf, pEntry);
+  return 0;
+}
+
+static int32_t stateBufFlush(SStreamStateBuf* pBuf, const void* sKey, const void* eKey) {
+  SStateBufEntry* pEntry = pBuf->pDirty;
+  while (pEntry) {
+    SStateBufEntry* pNext = pEntry->dNext;
+    if (sKey && (pBuf->cmpr(pEntry->key, pBuf->keyLen, sKey, pBuf->keyLen) < 0 ||
+                 pBuf->cmpr(pEntry->key, pBuf->keyLen, eKey, pBuf->keyLen) > 0)) {
+      pEntry = pNext;
+      continue;
+    }
+    if (stateBufWriteBack(pBuf, pEntry) < 0) {
+      return -1;
+    }
+    if (pEntry->deleted) {
+      stateBufRemove(pBuf, pEntry);
+    }
+    pEntry = pNext;
+  }
+  return 0;
+}
+
+// Write every dirty entry to tdb. Clean entries stay cached, tombstones are dropped.
+int32_t streamStateBufFlush(SStreamStateBuf* pBuf) { return stateBufFlush(pBuf, NULL, NULL); }
+
+// Same as streamStateBufFlush but only for the dirty keys in [sKey, eKey], what a cursor over that range reads.
+int32_t streamStateBufFlushRange(SStreamStateBuf* pBuf, const void* sKey, const void* eKey) {
+  return stateBufFlush(pBuf, sKey, eKey);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "streamInc.h"
+#include "tdb.h"
+
+typedef struct {
+  int64_t opNum;
+  int64_t ts;
+} STestKey;
+
+static int testKeyCmpr(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  const STestKey *k1 = (const STestKey *)pKey1;
+  const STestKey *k2 = (const STestKey *)pKey2;
+  if (k1->opNum != k2->opNum) return k1->opNum < k2->opNum ? -1 : 1;
+  if (k1->ts != k2->ts) return k1->ts < k2->ts ? -1 : 1;
+  return 0;
+}
+
+class StreamStateBufTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    snprintf(path, sizeof(path), "/tmp/streamStateBufTest%d", taosGetPId());
+    taosRemoveDir(path);
+    ASSERT_EQ(tdbOpen(path, 4096, 256, &pDb, 0), 0);
+    ASSERT_EQ(tdbTbOpen("state.db", sizeof(STestKey), -1, testKeyCmpr, pDb, &pTb, 0), 0);
+    memset(&txn, 0, sizeof(txn));
+    ASSERT_EQ(tdbTxnOpen(&txn, 0, tdbDefaultMalloc, tdbDefaultFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED),
+              0);
+    ASSERT_EQ(tdbBegin(pDb, &txn), 0);
+    pBuf = NULL;
+  }
+
+  void TearDown() override {
+    streamStateBufClose(pBuf);
+    tdbCommit(pDb, &txn);
+    tdbTbClose(pTb);
+    tdbClose(pDb);
+    taosRemoveDir(path);
+  }
+
+  void open(int64_t capacity) {
+    pBuf = streamStateBufOpen(pTb, &txn, testKeyCmpr, sizeof(STestKey), capacity);
+    ASSERT_NE(pBuf, nullptr);
+  }
+
+  int32_t put(int64_t opNum, int64_t ts, int64_t v) {
+    STestKey key = {opNum, ts};
+    return streamStateBufPut(pBuf, &key, &v, sizeof(v));
+  }
+
+  int32_t del(int64_t opNum, int64_t ts) {
+    STestKey key = {opNum, ts};
+    return streamStateBufDel(pBuf, &key);
+  }
+
+  // value through the buffer, -1 if not found
+  int64_t get(int64_t opNum, int64_t ts) {
+    STestKey key = {opNum, ts};
+    void    *pVal = NULL;
+    int32_t  vLen = 0;
+    if (streamStateBufGet(pBuf, &key, &pVal, &vLen) < 0) return -1;
+    int64_t v = *(int64_t *)pVal;
+    streamFreeVal(pVal);
+    return v;
+  }
+
+  // value as tdb has it, -1 if not there
+  int64_t stored(int64_t opNum, int64_t ts) {
+    STestKey key = {opNum, ts};
+    void    *pVal = NULL;
+    int32_t  vLen = 0;
+    if (tdbTbGet(pTb, &key, sizeof(key), &pVal, &vLen) < 0) return -1;
+    int64_t v = *(int64_t *)pVal;
+    tdbFree(pVal);
+    return v;
+  }
+
+  char             path[64];
+  TDB             *pDb;
+  TTB             *pTb;
+  TXN              txn;
+  SStreamStateBuf *pBuf;
+};
+
+TEST_F(StreamStateBufTest, putGet) {
+  open(1 << 20);
+  ASSERT_EQ(put(1, 10, 100), 0);
+  ASSERT_EQ(put(1, 10, 101), 0);
+  EXPECT_EQ(get(1, 10), 101);
+  EXPECT_EQ(get(1, 11), -1);
+
+  // tdb only sees the last version and only once flushed
+  EXPECT_EQ(stored(1, 10), -1);
+  ASSERT_EQ(streamStateBufFlush(pBuf), 0);
+  EXPECT_EQ(stored(1, 10), 101);
+
+  // a key only in tdb is read through and then served from memory
+  STestKey key = {1, 20};
+  int64_t  v = 200;
+  ASSERT_EQ(tdbTbUpsert(pTb, &key, sizeof(key), &v, sizeof(v), &txn), 0);
+  EXPECT_EQ(get(1, 20), 200);
+  ASSERT_EQ(tdbTbDelete(pTb, &key, sizeof(key), &txn), 0);
+  EXPECT_EQ(get(1, 20), 200);
+}
+
+TEST_F(StreamStateBufTest, evict) {
+  // room for a few entries only
+  open(8 * (sizeof(STestKey) + sizeof(int64_t) + 64));
+  for (int64_t ts = 0; ts < 100; ++ts) {
+    ASSERT_EQ(put(1, ts, ts * 10), 0);
+  }
+
+  // the coldest entries were written back, the hottest is still only in memory
+  EXPECT_EQ(stored(1, 0), 0);
+  EXPECT_EQ(stored(1, 50), 500);
+  EXPECT_EQ(stored(1, 99), -1);
+
+  // keeping a key hot keeps it out of tdb
+  for (int64_t ts = 100; ts < 200; ++ts) {
+    ASSERT_EQ(put(1, 99, ts), 0);
+    ASSERT_EQ(put(1, ts, ts * 10), 0);
+  }
+  EXPECT_EQ(stored(1, 99), -1);
+  EXPECT_EQ(get(1, 99), 199);
+
+  // evicted entries are read back from tdb
+  for (int64_t ts = 0; ts < 200; ++ts) {
+    if (ts != 99) EXPECT_EQ(get(1, ts), ts * 10);
+  }
+}
+
+TEST_F(StreamStateBufTest, delete) {
+  open(1 << 20);
+  ASSERT_EQ(put(1, 1, 10), 0);
+  ASSERT_EQ(streamStateBufFlush(pBuf), 0);
+
+  ASSERT_EQ(del(1, 1), 0);
+  EXPECT_EQ(get(1, 1), -1);
+  EXPECT_EQ(del(1, 1), -1);
+  EXPECT_EQ(stored(1, 1), 10);
+  ASSERT_EQ(streamStateBufFlush(pBuf), 0);
+  EXPECT_EQ(stored(1, 1), -1);
+
+  // put, delete, put again before a flush: tdb gets the last put
+  ASSERT_EQ(put(1, 2, 20), 0);
+  ASSERT_EQ(del(1, 2), 0);
+  ASSERT_EQ(put(1, 2, 21), 0);
+  // a key deleted before it ever reached tdb
+  ASSERT_EQ(put(1, 3, 30), 0);
+  ASSERT_EQ(del(1, 3), 0);
+  ASSERT_EQ(streamStateBufFlush(pBuf), 0);
+  EXPECT_EQ(stored(1, 2), 21);
+  EXPECT_EQ(stored(1, 3), -1);
+  EXPECT_EQ(get(1, 3), -1);
+}
+
+TEST_F(StreamStateBufTest, flushRange) {
+  open(1 << 20);
+  for (int64_t ts = 0; ts < 10; ++ts) {
+    ASSERT_EQ(put(1, ts, ts), 0);
+    ASSERT_EQ(put(2, ts, ts + 100), 0);
+  }
+  ASSERT_EQ(del(2, 5), 0);
+
+  // only the dirty keys in the range are written
+  STestKey sKey = {2, INT64_MIN};
+  STestKey eKey = {2, INT64_MAX};
+  ASSERT_EQ(streamStateBufFlushRange(pBuf, &sKey, &eKey), 0);
+  for (int64_t ts = 0; ts < 10; ++ts) {
+    EXPECT_EQ(stored(1, ts), -1);
+    EXPECT_EQ(stored(2, ts), ts == 5 ? -1 : ts + 100);
+  }
+
+  // flushed keys are clean, later changes make them dirty again
+  ASSERT_EQ(put(2, 3, 1000), 0);
+  ASSERT_EQ(streamStateBufFlushRange(pBuf, &sKey, &eKey), 0);
+  EXPECT_EQ(stored(2, 3), 1000);
+
+  ASSERT_EQ(streamStateBufFlush(pBuf), 0);
+  for (int64_t ts = 0; ts < 10; ++ts) {
+    EXPECT_EQ(stored(1, ts), ts);
+  }
+}
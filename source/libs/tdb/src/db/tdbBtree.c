@@ -65,6 +65,7 @@ static int tdbBtreeEncodeCell(SPage *pPage, const void *pKey, int kLen, const vo
                               int *szCell, TXN *pTxn, SBTree *pBt);
 static int tdbBtreeDecodeCell(SPage *pPage, const SCell *pCell, SCellDecoder *pDecoder, TXN *pTxn, SBTree *pBt);
 static int tdbBtreeBalance(SBTC *pBtc);
+static int tdbBtcIsRightEdge(SBTC *pBtc);
 static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *pTxn, SBTree *pBt);
 static int tdbBtcMoveDownward(SBTC *pBtc);
 static int tdbBtcMoveUpward(SBTC *pBtc);
@@ -279,6 +280,94 @@ int tdbBtreeUpsert(SBTree *pBt, const void *pKey, int nKey, const void *pData, i
   return 0;
 }
 
+static void tdbBtreeSortKV(SBTree *pBt, STdbKV *aKV, STdbKV *aTmp, int nKV) {
+  int i, j, k;
+  int mid, end;
+
+  // bottom-up merge sort, it is stable so the last one of the duplicate keys wins on upsert
+  for (int width = 1; width < nKV; width *= 2) {
+    for (int start = 0; start < nKV; start += 2 * width) {
+      mid = TMIN(start + width, nKV);
+      end = TMIN(start + 2 * width, nKV);
+      i = start;
+      j = mid;
+      k = start;
+      while (i < mid && j < end) {
+        if (pBt->kcmpr(aKV[j].pKey, aKV[j].kLen, aKV[i].pKey, aKV[i].kLen) < 0) {
+          aTmp[k++] = aKV[j++];
+        } else {
+          aTmp[k++] = aKV[i++];
+        }
+      }
+      while (i < mid) aTmp[k++] = aKV[i++];
+      while (j < end) aTmp[k++] = aKV[j++];
+    }
+    memcpy(aKV, aTmp, sizeof(STdbKV) * nKV);
+  }
+}
+
+int tdbBtreeBulkLoad(SBTree *pBt, STdbKV *aKV, int nKV, int upsert, TXN *pTxn) {
+  SBTC    btc;
+  STdbKV *aTmp;
+  int     sorted = 1;
+  int     ret;
+  int     c;
+
+  for (int iKV = 1; iKV < nKV; iKV++) {
+    if (pBt->kcmpr(aKV[iKV - 1].pKey, aKV[iKV - 1].kLen, aKV[iKV].pKey, aKV[iKV].kLen) > 0) {
+      sorted = 0;
+      break;
+    }
+  }
+
+  if (!sorted) {
+    aTmp = (STdbKV *)tdbOsMalloc(sizeof(STdbKV) * nKV);
+    if (aTmp == NULL) {
+      return -1;
+    }
+    tdbBtreeSortKV(pBt, aKV, aTmp, nKV);
+    tdbOsFree(aTmp);
+  }
+
+  tdbTrace("tdb bulk load, nKV: %d, sorted: %d, pTxn: %p", nKV, sorted, pTxn);
+
+  // keys are loaded in order, so the cells land on neighbouring cells of the same leaf page and
+  // the ones beyond the current right edge are appended to packed pages by the balancer
+  for (int iKV = 0; iKV < nKV; iKV++) {
+    tdbBtcOpen(&btc, pBt, pTxn);
+    btc.bulk = 1;
+
+    ret = tdbBtcMoveTo(&btc, aKV[iKV].pKey, aKV[iKV].kLen, &c);
+    if (ret < 0) {
+      tdbBtcClose(&btc);
+      ASSERT(0);
+      return -1;
+    }
+
+    if (btc.idx == -1) {
+      btc.idx = 0;
+      c = 1;
+    } else if (c > 0) {
+      btc.idx++;
+    } else if (c == 0 && !upsert) {
+      // dup key not allowed
+      tdbBtcClose(&btc);
+      return -1;
+    }
+
+    ret = tdbBtcUpsert(&btc, aKV[iKV].pKey, aKV[iKV].kLen, aKV[iKV].pVal, aKV[iKV].vLen, c);
+    if (ret < 0) {
+      ASSERT(0);
+      tdbBtcClose(&btc);
+      return -1;
+    }
+
+    tdbBtcClose(&btc);
+  }
+
+  return 0;
+}
+
 int tdbBtreeGet(SBTree *pBt, const void *pKey, int kLen, void **ppVal, int *vLen) {
   return tdbBtreePGet(pBt, pKey, kLen, NULL, NULL, ppVal, vLen);
 }
@@ -506,7 +595,7 @@ static int tdbBtreeBalanceDeeper(SBTree *pBt, SPage *pRoot, SPage **ppChild, TXN
   return 0;
 }
 
-static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTxn) {
+static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, u8 append, TXN *pTxn) {
   int ret;
 
   int    nOlds, pageIdx;
@@ -639,8 +728,9 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
 
     nNews++;
 
-    // back loop to make the distribution even
-    for (int iNew = nNews - 1; iNew > 0; iNew--) {
+    // back loop to make the distribution even, an append at the right edge keeps the left
+    // pages packed so that sequential loads leave full pages behind
+    for (int iNew = append ? 0 : nNews - 1; iNew > 0; iNew--) {
       SCell *pCell;
       int    szLCell, szRCell;
 
@@ -873,6 +963,10 @@ static int tdbBtreeBalance(SBTC *pBtc) {
   u8     flags;
   u8     leaf;
   u8     root;
+  u8     append;
+
+  // random inserts keep the even distribution, a page split by one would only be split again
+  append = pBtc->bulk && tdbBtcIsRightEdge(pBtc);
 
   // Main loop to balance the BTree
   for (;;) {
@@ -907,7 +1001,7 @@ static int tdbBtreeBalance(SBTC *pBtc) {
       // Generalized balance step
       pParent = pBtc->pgStack[iPage - 1];
 
-      ret = tdbBtreeBalanceNonRoot(pBtc->pBt, pParent, pBtc->idxStack[pBtc->iPage - 1], pBtc->pTxn);
+      ret = tdbBtreeBalanceNonRoot(pBtc->pBt, pParent, pBtc->idxStack[pBtc->iPage - 1], append && leaf, pBtc->pTxn);
       if (ret < 0) {
         return -1;
       }
@@ -921,6 +1015,24 @@ static int tdbBtreeBalance(SBTC *pBtc) {
 
   return 0;
 }
+
+// Check if the overflow cell of the leaf page is the right-most cell of the whole tree
+static int tdbBtcIsRightEdge(SBTC *pBtc) {
+  SPage *pPage = pBtc->pPage;
+
+  if (!TDB_BTREE_PAGE_IS_LEAF(pPage) || pPage->nOverflow != 1 ||
+      pPage->aiOvfl[0] != TDB_PAGE_TOTAL_CELLS(pPage) - 1) {
+    return 0;
+  }
+
+  for (int iPage = 0; iPage < pBtc->iPage; iPage++) {
+    if (pBtc->idxStack[iPage] != TDB_PAGE_TOTAL_CELLS(pBtc->pgStack[iPage])) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
 // TDB_BTREE_BALANCE
 
 static int tdbFetchOvflPage(SPgno *pPgno, SPage **ppOfp, TXN *pTxn, SBTree *pBt) {
@@ -1531,6 +1643,7 @@ int tdbBtcOpen(SBTC *pBtc, SBTree *pBt, TXN *pTxn) {
   pBtc->iPage = -1;
   pBtc->pPage = NULL;
   pBtc->idx = -1;
+  pBtc->bulk = 0;
   memset(&pBtc->coder, 0, sizeof(SCellDecoder));
 
   if (pTxn == NULL) {
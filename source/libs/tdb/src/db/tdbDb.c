@@ -115,12 +115,12 @@ int32_t tdbBegin(TDB *pDb, TXN *pTxn) {
   return 0;
 }
 
-int32_t tdbCommit(TDB *pDb, TXN *pTxn) {
+static int32_t tdbCommitImpl(TDB *pDb, TXN *pTxn, bool keepJournal) {
   SPager *pPager;
   int     ret;
 
   for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
-    ret = tdbPagerCommit(pPager, pTxn);
+    ret = tdbPagerCommit(pPager, pTxn, keepJournal);
     if (ret < 0) {
       tdbError("failed to commit pager since %s. dbName:%s, txnId:%" PRId64, tstrerror(terrno), pDb->dbName,
                pTxn->txnId);
@@ -131,6 +131,12 @@ int32_t tdbCommit(TDB *pDb, TXN *pTxn) {
   return 0;
 }
 
+int32_t tdbCommit(TDB *pDb, TXN *pTxn) { return tdbCommitImpl(pDb, pTxn, false); }
+
+// Same as tdbCommit, but the journal of the txn is kept until tdbPostCommit, so the txn is undone if the db is opened
+// with rollback before that. A new txn may begin right after this returns.
+int32_t tdbAsyncCommit(TDB *pDb, TXN *pTxn) { return tdbCommitImpl(pDb, pTxn, true); }
+
 int32_t tdbPostCommit(TDB *pDb, TXN *pTxn) {
   SPager *pPager;
   int     ret;
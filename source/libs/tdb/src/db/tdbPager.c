@@ -240,7 +240,12 @@ int tdbPagerBegin(SPager *pPager, TXN *pTxn) {
   return 0;
 }
 
-int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
+// the journal of a txn committed with keepJournal, it is removed by tdbPagerPostCommit
+static void tdbPagerCommittedJournalName(SPager *pPager, char *fname) {
+  snprintf(fname, TDB_FILENAME_LEN + 16, "%s.commit", pPager->jFileName);
+}
+
+int tdbPagerCommit(SPager *pPager, TXN *pTxn, bool keepJournal) {
   SPage *pPage;
   int    ret;
 
@@ -294,7 +299,16 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
     return -1;
   }
 
-  if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
+  if (keepJournal) {
+    // the next txn opens a new journal under jFileName
+    char cFileName[TDB_FILENAME_LEN + 16];
+    tdbPagerCommittedJournalName(pPager, cFileName);
+    if (tdbOsRename(pPager->jFileName, cFileName) < 0) {
+      tdbError("failed to rename file due to %s. file:%s", strerror(errno), pPager->jFileName);
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return -1;
+    }
+  } else if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
     tdbError("failed to remove file due to %s. file:%s", strerror(errno), pPager->jFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
@@ -305,15 +319,16 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
   return 0;
 }
 
+// never touches the running txn, a new one may have begun since the commit
 int tdbPagerPostCommit(SPager *pPager, TXN *pTxn) {
-  if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
-    tdbError("failed to remove file due to %s. file:%s", strerror(errno), pPager->jFileName);
+  char cFileName[TDB_FILENAME_LEN + 16];
+  tdbPagerCommittedJournalName(pPager, cFileName);
+  if (tdbOsRemove(cFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. file:%s", strerror(errno), cFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  pPager->inTran = 0;
-
   return 0;
 }
 
@@ -592,12 +607,13 @@ static int tdbPagerWritePageToDB(SPager *pPager, SPage *pPage) {
   return 0;
 }
 
-int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
+// write the pages saved in a journal back to the db file and remove the journal
+static int tdbPagerRestoreJournal(SPager *pPager, const char *jFileName) {
   int   ret = 0;
   SPgno journalSize = 0;
   u8   *pageBuf = NULL;
 
-  tdb_fd_t jfd = tdbOsOpen(pPager->jFileName, TDB_O_RDWR, 0755);
+  tdb_fd_t jfd = tdbOsOpen(jFileName, TDB_O_RDWR, 0755);
   if (jfd == NULL) {
     return 0;
   }
@@ -656,13 +672,13 @@ int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
   tdbOsFree(pageBuf);
 
   if (tdbOsClose(jfd) < 0) {
-    tdbError("failed to close jfd due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+    tdbError("failed to close jfd due to %s. jFileName:%s", strerror(errno), jFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
-    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+  if (tdbOsRemove(jFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), jFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
@@ -670,12 +686,30 @@ int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
   return 0;
 }
 
-int tdbPagerRollback(SPager *pPager) {
-  if (tdbOsRemove(pPager->jFileName) < 0 && errno != ENOENT) {
-    tdbError("failed to remove file due to %s. jFileName:%s", strerror(errno), pPager->jFileName);
+int tdbPagerRestore(SPager *pPager, SBTree *pBt) {
+  if (tdbPagerRestoreJournal(pPager, pPager->jFileName) < 0) {
+    return -1;
+  }
+
+  // the txn committed with keepJournal is kept
+  char cFileName[TDB_FILENAME_LEN + 16];
+  tdbPagerCommittedJournalName(pPager, cFileName);
+  if (tdbOsRemove(cFileName) < 0 && errno != ENOENT) {
+    tdbError("failed to remove file due to %s. file:%s", strerror(errno), cFileName);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
   return 0;
 }
+
+// undo the running txn, then the txn committed with keepJournal but not post-committed
+int tdbPagerRollback(SPager *pPager) {
+  if (tdbPagerRestoreJournal(pPager, pPager->jFileName) < 0) {
+    return -1;
+  }
+
+  char cFileName[TDB_FILENAME_LEN + 16];
+  tdbPagerCommittedJournalName(pPager, cFileName);
+  return tdbPagerRestoreJournal(pPager, cFileName);
+}
@@ -151,6 +151,10 @@ int tdbTbUpsert(TTB *pTb, const void *pKey, int kLen, const void *pVal, int vLen
   return tdbBtreeUpsert(pTb->pBt, pKey, kLen, pVal, vLen, pTxn);
 }
 
+int tdbTbBulkLoad(TTB *pTb, STdbKV *aKV, int nKV, int upsert, TXN *pTxn) {
+  return tdbBtreeBulkLoad(pTb->pBt, aKV, nKV, upsert, pTxn);
+}
+
 int tdbTbGet(TTB *pTb, const void *pKey, int kLen, void **ppVal, int *vLen) {
   return tdbBtreeGet(pTb->pBt, pKey, kLen, ppVal, vLen);
 }
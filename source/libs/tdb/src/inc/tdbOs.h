@@ -55,6 +55,7 @@ typedef TdFilePtr tdb_fd_t;
 #define tdbOsFSync               taosFsyncFile
 #define tdbOsLSeek               taosLSeekFile
 #define tdbOsRemove              remove
+#define tdbOsRename              taosRenameFile
 #define tdbOsFileSize(FD, PSIZE) taosFStatFile(FD, PSIZE, NULL)
 
 /* directory */
@@ -113,6 +114,7 @@ i64 tdbOsWrite(tdb_fd_t fd, const void *pData, i64 nBytes);
 #define tdbOsFSync  fsync
 #define tdbOsLSeek  lseek
 #define tdbOsRemove remove
+#define tdbOsRename rename
 #define tdbOsFileSize(FD, PSIZE)
 
 /* directory */
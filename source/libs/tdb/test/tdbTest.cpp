@@ -486,6 +486,251 @@ TEST(tdb_test, DISABLED_simple_upsert1) {
   tdbClose(pEnv);
 }
 
+TEST(tdb_test, simple_bulk_load1) {
+  int       ret;
+  TDB      *pEnv;
+  TTB      *pDb;
+  int       nData = 20000;
+  int       nBatch = 1000;
+  void     *pData = NULL;
+  int       vLen;
+  SPoolMem *pPool;
+  TXN       txn;
+
+  taosRemoveDir("tdb");
+
+  // open env
+  ret = tdbOpen("tdb", 1024, 64, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  // open database
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  std::vector<std::string> keys(nData);
+  std::vector<std::string> vals(nData);
+  std::vector<STdbKV>      aKV(nBatch);
+
+  pPool = openPool();
+  tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+
+  // load batches in reverse order, each batch is unsorted
+  for (int iBatch = nData / nBatch - 1; iBatch >= 0; iBatch--) {
+    for (int i = 0; i < nBatch; i++) {
+      int iData = iBatch * nBatch + (i * 7919) % nBatch;
+
+      keys[iData] = "key" + std::to_string(iData);
+      vals[iData] = "data" + std::to_string(iData);
+      aKV[i] = {keys[iData].c_str(), (int)keys[iData].size(), vals[iData].c_str(), (int)vals[iData].size()};
+    }
+    ret = tdbTbBulkLoad(pDb, aKV.data(), nBatch, 0, &txn);
+    GTEST_ASSERT_EQ(ret, 0);
+  }
+
+  // duplicate keys are rejected without upsert
+  ret = tdbTbBulkLoad(pDb, aKV.data(), 1, 0, &txn);
+  GTEST_ASSERT_EQ(ret, -1);
+
+  // upsert a batch of existing keys
+  for (int i = 0; i < nBatch; i++) {
+    int iData = nData / 2 + i;
+
+    vals[iData] = "data" + std::to_string(iData) + "-u";
+    aKV[i] = {keys[iData].c_str(), (int)keys[iData].size(), vals[iData].c_str(), (int)vals[iData].size()};
+  }
+  ret = tdbTbBulkLoad(pDb, aKV.data(), nBatch, 1, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  tdbCommit(pEnv, &txn);
+  tdbTxnClose(&txn);
+  closePool(pPool);
+
+  // query the data
+  for (int iData = 0; iData < nData; iData++) {
+    ret = tdbTbGet(pDb, keys[iData].c_str(), keys[iData].size(), &pData, &vLen);
+    GTEST_ASSERT_EQ(ret, 0);
+    GTEST_ASSERT_EQ(vLen, vals[iData].size());
+    GTEST_ASSERT_EQ(memcmp(pData, vals[iData].c_str(), vLen), 0);
+  }
+
+  {  // iterate to check the order
+    TBC  *pDbc;
+    void *pKey = NULL;
+    int   kLen;
+    int   count = 0;
+
+    tdbTbcOpen(pDb, &pDbc, NULL);
+    tdbTbcMoveToFirst(pDbc);
+    for (;;) {
+      ret = tdbTbcNext(pDbc, &pKey, &kLen, &pData, &vLen);
+      if (ret < 0) break;
+
+      GTEST_ASSERT_EQ(kLen, keys[count].size());
+      GTEST_ASSERT_EQ(memcmp(pKey, keys[count].c_str(), kLen), 0);
+      count++;
+    }
+    GTEST_ASSERT_EQ(count, nData);
+
+    tdbTbcClose(pDbc);
+    tdbFree(pKey);
+  }
+
+  tdbFree(pData);
+  tdbTbClose(pDb);
+  tdbClose(pEnv);
+}
+
+// size of an env with one table loaded with nData sequential keys, in bulk or one by one
+static int64_t tdbLoadedSize(const char *tbname, int nData, bool bulk) {
+  TDB      *pEnv;
+  TTB      *pDb;
+  SPoolMem *pPool;
+  TXN       txn;
+  int64_t   size = 0;
+
+  taosRemoveDir("tdb");
+  tdbOpen("tdb", 1024, 64, &pEnv, 0);
+  tdbTbOpen(tbname, -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+
+  pPool = openPool();
+  tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+  tdbBegin(pEnv, &txn);
+
+  char                key[64];
+  char                val[64];
+  std::vector<STdbKV> aKV(1);
+  for (int iData = 0; iData < nData; iData++) {
+    int kLen = sprintf(key, "key%08d", iData);
+    int vLen = sprintf(val, "data%08d", iData);
+    if (bulk) {
+      aKV[0] = {key, kLen, val, vLen};
+      EXPECT_EQ(tdbTbBulkLoad(pDb, aKV.data(), 1, 0, &txn), 0);
+    } else {
+      EXPECT_EQ(tdbTbInsert(pDb, key, kLen, val, vLen, &txn), 0);
+    }
+  }
+
+  tdbCommit(pEnv, &txn);
+  tdbTxnClose(&txn);
+  closePool(pPool);
+  tdbTbClose(pDb);
+  tdbClose(pEnv);
+
+  // the tables of an env share the main file
+  taosStatFile("tdb/main.tdb", &size, NULL);
+  return size;
+}
+
+TEST(tdb_test, bulk_load_packs_pages) {
+  // only the bulk path packs the pages split at the right edge, inserts keep the even distribution
+  int64_t bulkSize = tdbLoadedSize("bulk.db", 20000, true);
+  int64_t insertSize = tdbLoadedSize("insert.db", 20000, false);
+  GTEST_ASSERT_GT(bulkSize, 0);
+  GTEST_ASSERT_LT(bulkSize, insertSize);
+}
+
+TEST(tdb_test, async_commit_rollback) {
+  int       ret;
+  TDB      *pEnv;
+  TTB      *pDb;
+  void     *pData = NULL;
+  int       vLen;
+  SPoolMem *pPool;
+  TXN       txn;
+  int       nData = 2000;
+  char      key[64];
+  char      val[64];
+
+  auto writeTxn = [&](int from, int to, const char *prefix) {
+    pPool = openPool();
+    tdbTxnOpen(&txn, 0, poolMalloc, poolFree, pPool, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED);
+    tdbBegin(pEnv, &txn);
+    for (int i = from; i < to; i++) {
+      sprintf(key, "key%d", i);
+      sprintf(val, "%s%d", prefix, i);
+      ret = tdbTbUpsert(pDb, key, strlen(key), val, strlen(val), &txn);
+      GTEST_ASSERT_EQ(ret, 0);
+    }
+  };
+  auto endTxn = [&]() {
+    tdbTxnClose(&txn);
+    closePool(pPool);
+  };
+  auto checkData = [&](int from, int to, const char *prefix) {
+    for (int i = from; i < to; i++) {
+      sprintf(key, "key%d", i);
+      sprintf(val, "%s%d", prefix, i);
+      ret = tdbTbGet(pDb, key, strlen(key), &pData, &vLen);
+      if (prefix == NULL) {
+        GTEST_ASSERT_EQ(ret, -1);
+        continue;
+      }
+      GTEST_ASSERT_EQ(ret, 0);
+      GTEST_ASSERT_EQ(vLen, strlen(val));
+      GTEST_ASSERT_EQ(memcmp(pData, val, vLen), 0);
+    }
+  };
+  auto reopen = [&](int8_t rollback) {
+    tdbTbClose(pDb);
+    tdbClose(pEnv);
+    ret = tdbOpen("tdb", 1024, 64, &pEnv, rollback);
+    GTEST_ASSERT_EQ(ret, 0);
+    ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+    GTEST_ASSERT_EQ(ret, 0);
+  };
+
+  taosRemoveDir("tdb");
+
+  ret = tdbOpen("tdb", 1024, 64, &pEnv, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+  ret = tdbTbOpen("db.db", -1, -1, tKeyCmpr, pEnv, &pDb, 0);
+  GTEST_ASSERT_EQ(ret, 0);
+
+  writeTxn(0, nData, "v1-");
+  ret = tdbCommit(pEnv, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+  endTxn();
+
+  // a txn committed but not post-committed is undone by rollback, the one begun after it is dropped too
+  writeTxn(nData / 2, nData * 2, "v2-");
+  ret = tdbAsyncCommit(pEnv, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+  endTxn();
+  writeTxn(0, nData / 4, "v3-");
+  endTxn();
+
+  reopen(1);
+  checkData(0, nData, "v1-");
+  checkData(nData, nData * 2, NULL);
+
+  // without rollback the txn is kept
+  writeTxn(nData / 2, nData * 2, "v2-");
+  ret = tdbAsyncCommit(pEnv, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+  endTxn();
+
+  reopen(0);
+  checkData(0, nData / 2, "v1-");
+  checkData(nData / 2, nData * 2, "v2-");
+
+  // nothing is undone after the post commit
+  writeTxn(0, nData / 2, "v4-");
+  ret = tdbAsyncCommit(pEnv, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+  ret = tdbPostCommit(pEnv, &txn);
+  GTEST_ASSERT_EQ(ret, 0);
+  endTxn();
+
+  reopen(1);
+  checkData(0, nData / 2, "v4-");
+  checkData(nData / 2, nData * 2, "v2-");
+
+  tdbFree(pData);
+  tdbTbClose(pDb);
+  tdbClose(pEnv);
+}
+
 TEST(tdb_test, multi_thread_query) {
   int           ret;
   TDB          *pEnv;
@@ -99,6 +99,8 @@ typedef void* queue[2];
 #define TRANS_CONN_TIMEOUT      3     // connect timeout (s)
 #define TRANS_READ_TIMEOUT      3000  // read timeout  (ms)
 #define TRANS_PACKET_LIMIT      1024 * 1024 * 512
+#define TRANS_MAX_WRITE_BATCH   64    // max msgs coalesced into one write
+#define TRANS_COMP_BUF_KEEP     (1024 * 1024)  // max compression buffer kept by a thread
 
 #define TRANS_MAGIC_NUM 0x5f375a86
 
@@ -216,6 +218,15 @@ typedef struct SConnBuffer {
   int   invalid;
 } SConnBuffer;
 
+/*
+ * scratch buffer for compression, reused by all msgs compressed on the same thread, freed after a msg
+ * that needs more than TRANS_COMP_BUF_KEEP
+ */
+typedef struct STransCompBuf {
+  char*   buf;
+  int32_t cap;
+} STransCompBuf;
+
 typedef void (*AsyncCB)(uv_async_t* handle);
 
 typedef struct {
@@ -279,6 +290,11 @@ bool        transAsyncPoolIsEmpty(SAsyncPool* pool);
     }                                                                                                        \
   } while (0)
 
+char*   transAllocBuf(int64_t size, bool pooled);
+char*   transReallocBuf(char* p, int64_t size);
+void    transReleaseBuf(char* p);
+int64_t transBufCap(char* p);
+
 int  transInitBuffer(SConnBuffer* buf);
 int  transClearBuffer(SConnBuffer* buf);
 int  transDestroyBuffer(SConnBuffer* buf);
@@ -414,7 +430,9 @@ void transInit();
 void transCleanup();
 
 void    transFreeMsg(void* msg);
-int32_t transCompressMsg(char* msg, int32_t len);
+int32_t transCompressMsg(char* msg, int32_t len, STransCompBuf* pCompBuf);
+void    transDestroyCompBuf(STransCompBuf* pCompBuf);
+void    transUpdateSendStats(STrans* pTransInst, int32_t nMsg);
 int32_t transDecompressMsg(char** msg, int32_t len);
 
 int32_t transOpenRefMgt(int size, void (*func)(void*));
@@ -59,6 +59,10 @@ typedef struct {
   void*         tcphandle;  // returned handle from TCP initialization
   int64_t       refId;
   TdThreadMutex mutex;
+
+  // send stats
+  int64_t numOfWrites;
+  int64_t numOfSentMsgs;
 } SRpcInfo;
 
 #ifdef __cplusplus
@@ -99,10 +99,9 @@ void rpcCloseImpl(void* arg) {
 
 void* rpcMallocCont(int64_t contLen) {
   int64_t size = contLen + TRANS_MSG_OVERHEAD;
-  char*   start = taosMemoryCalloc(1, size);
+  char*   start = transAllocBuf(size, false);
   if (start == NULL) {
     tError("failed to malloc msg, size:%" PRId64, size);
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   } else {
     tTrace("malloc mem:%p size:%" PRId64, start, size);
@@ -113,7 +112,7 @@ void* rpcMallocCont(int64_t contLen) {
 
 void rpcFreeCont(void* cont) {
   if (cont == NULL) return;
-  taosMemoryFree((char*)cont - TRANS_MSG_OVERHEAD);
+  transReleaseBuf((char*)cont - TRANS_MSG_OVERHEAD);
   tTrace("rpc free cont:%p", (char*)cont - TRANS_MSG_OVERHEAD);
 }
 
@@ -122,9 +121,8 @@ void* rpcReallocCont(void* ptr, int64_t contLen) {
 
   char*   st = (char*)ptr - TRANS_MSG_OVERHEAD;
   int64_t sz = contLen + TRANS_MSG_OVERHEAD;
-  st = taosMemoryRealloc(st, sz);
+  st = transReallocBuf(st, sz);
   if (st == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
 
@@ -166,6 +164,17 @@ int rpcSetDefaultAddr(void* thandle, const char* ip, const char* fqdn) {
 
 void* rpcAllocHandle() { return (void*)transAllocHandle(); }
 
+int rpcGetSendStats(void* thandle, SRpcSendStats* pStats) {
+  SRpcInfo* pRpc = transAcquireExHandle(transGetInstMgt(), (int64_t)thandle);
+  if (pRpc == NULL) {
+    return -1;
+  }
+  pStats->numOfWrites = atomic_load_64(&pRpc->numOfWrites);
+  pStats->numOfSentMsgs = atomic_load_64(&pRpc->numOfSentMsgs);
+  transReleaseExHandle(transGetInstMgt(), (int64_t)thandle);
+  return 0;
+}
+
 int32_t rpcInit() {
   transInit();
   return 0;
@@ -36,8 +36,9 @@ typedef struct SCliConn {
   SConnList* list;
 
   STransCtx  ctx;
-  bool       broken;  // link broken or not
-  ConnStatus status;  //
+  bool       broken;      // link broken or not
+  bool       inSendList;  // reqs queued on it wait for the batch in progress to be written
+  ConnStatus status;      //
 
   int64_t  refId;
   char*    ip;
@@ -84,6 +85,9 @@ typedef struct SCliThrd {
 
   SCliMsg* stopMsg;
 
+  STransCompBuf compBuf;
+  SArray*       sendList;  // conns with reqs queued by the batch in progress
+
   bool quit;
 } SCliThrd;
 
@@ -146,6 +150,7 @@ static void cliHandleExcept(SCliConn* conn);
 
 // handle req from app
 static void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd);
+static void cliFlushSendList(SCliThrd* pThrd);
 static void cliHandleQuit(SCliMsg* pMsg, SCliThrd* pThrd);
 static void cliHandleRelease(SCliMsg* pMsg, SCliThrd* pThrd);
 static void cliHandleUpdate(SCliMsg* pMsg, SCliThrd* pThrd);
@@ -693,8 +698,12 @@ static void cliDestroy(uv_handle_t* handle) {
 static bool cliHandleNoResp(SCliConn* conn) {
   bool res = false;
   if (!transQueueEmpty(&conn->cliMsgs)) {
-    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, 0);
-    if (REQUEST_NO_RESP(&pMsg->msg)) {
+    // msgs written in one batch may all require no resp
+    while (!transQueueEmpty(&conn->cliMsgs)) {
+      SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, 0);
+      if (pMsg->sent == 0 || !REQUEST_NO_RESP(&pMsg->msg)) {
+        break;
+      }
       transQueuePop(&conn->cliMsgs);
       destroyCmsg(pMsg);
       res = true;
@@ -729,13 +738,7 @@ static void cliSendCb(uv_write_t* req, int status) {
   uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
 }
 
-void cliSend(SCliConn* pConn) {
-  assert(!transQueueEmpty(&pConn->cliMsgs));
-
-  SCliMsg* pCliMsg = NULL;
-  CONN_GET_NEXT_SENDMSG(pConn);
-  pCliMsg->sent = 1;
-
+static void cliPrepareSendData(SCliConn* pConn, SCliMsg* pCliMsg, uv_buf_t* wb) {
   STransConnCtx* pCtx = pCliMsg->ctx;
 
   SCliThrd* pThrd = pConn->hostThrd;
@@ -762,9 +765,46 @@ void cliSend(SCliConn* pConn) {
     CONN_SET_PERSIST_BY_APP(pConn);
   }
 
+  if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
+    msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, &pThrd->compBuf) + sizeof(STransMsgHead);
+    pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
+  }
+
   STraceId* trace = &pMsg->info.traceId;
+  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
+          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
+
+  *wb = uv_buf_init((char*)pHead, msgLen);
+}
+
+void cliSend(SCliConn* pConn) {
+  assert(!transQueueEmpty(&pConn->cliMsgs));
+
+  SCliThrd* pThrd = pConn->hostThrd;
+  STrans*   pTransInst = pThrd->pTransInst;
 
-  if (pTransInst->startTimer != NULL && pTransInst->startTimer(0, pMsg->msgType)) {
+  // coalesce all unsent msgs cached on conn into one write
+  uv_buf_t wb[TRANS_MAX_WRITE_BATCH];
+  int32_t  nBuf = 0;
+  SCliMsg* pTimerMsg = NULL;
+  SCliMsg* pLastMsg = NULL;
+  for (int32_t i = 0; i < transQueueSize(&pConn->cliMsgs) && nBuf < TRANS_MAX_WRITE_BATCH; i++) {
+    SCliMsg* pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent == 1) {
+      continue;
+    }
+    pCliMsg->sent = 1;
+    pLastMsg = pCliMsg;
+    if (pTimerMsg == NULL && pTransInst->startTimer != NULL && pTransInst->startTimer(0, pCliMsg->msg.msgType)) {
+      pTimerMsg = pCliMsg;
+    }
+    cliPrepareSendData(pConn, pCliMsg, &wb[nBuf++]);
+  }
+  if (nBuf == 0) {
+    return;
+  }
+
+  if (pTimerMsg != NULL) {
     uv_timer_t* timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
     if (timer == NULL) {
       timer = taosMemoryCalloc(1, sizeof(uv_timer_t));
@@ -774,29 +814,24 @@ void cliSend(SCliConn* pConn) {
     timer->data = pConn;
     pConn->timer = timer;
 
-    tGTrace("%s conn %p start timer for msg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType));
+    STraceId* trace = &pTimerMsg->msg.info.traceId;
+    tGTrace("%s conn %p start timer for msg:%s", CONN_GET_INST_LABEL(pConn), pConn,
+            TMSG_INFO(pTimerMsg->msg.msgType));
     uv_timer_start((uv_timer_t*)pConn->timer, cliReadTimeoutCb, TRANS_READ_TIMEOUT, 0);
   }
 
-  if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-    msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
-    pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
-  }
-  tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
-          TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
+  transUpdateSendStats(pTransInst, nBuf);
+  tTrace("%s conn %p start to write %d msgs", CONN_GET_INST_LABEL(pConn), pConn, nBuf);
 
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
 
-  int status = uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
+  int status = uv_write(req, (uv_stream_t*)pConn->stream, wb, nBuf, cliSendCb);
   if (status != 0) {
-    tGError("%s conn %p failed to sent msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType),
-            uv_err_name(status));
+    STraceId* trace = &pLastMsg->msg.info.traceId;
+    tGError("%s conn %p failed to sent msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn,
+            TMSG_INFO(pLastMsg->msg.msgType), uv_err_name(status));
     cliHandleExcept(pConn);
   }
-  return;
-_RETURN:
-  return;
 }
 
 void cliConnCb(uv_connect_t* req, int status) {
@@ -828,6 +863,7 @@ static void cliHandleQuit(SCliMsg* pMsg, SCliThrd* pThrd) {
     pThrd->stopMsg = pMsg;
     return;
   }
+  cliFlushSendList(pThrd);
   pThrd->stopMsg = NULL;
   pThrd->quit = true;
   tDebug("cli work thread %p start to quit", pThrd);
@@ -967,7 +1003,11 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   if (conn != NULL) {
     transCtxMerge(&conn->ctx, &pCtx->appCtx);
     transQueuePush(&conn->cliMsgs, pMsg);
-    cliSend(conn);
+    // written with the other reqs of the batch for the same conn, see cliFlushSendList
+    if (!conn->inSendList) {
+      conn->inSendList = true;
+      taosArrayPush(pThrd->sendList, &conn);
+    }
   } else {
     conn = cliCreateConn(pThrd);
 
@@ -1009,6 +1049,17 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   STraceId* trace = &pMsg->msg.info.traceId;
   tGTrace("%s conn %p ready", pTransInst->label, conn);
 }
+static void cliFlushSendList(SCliThrd* pThrd) {
+  // conns are only freed by the close cb, they are all still there at the end of the batch
+  for (int32_t i = 0; i < taosArrayGetSize(pThrd->sendList); i++) {
+    SCliConn* conn = taosArrayGetP(pThrd->sendList, i);
+    conn->inSendList = false;
+    if (!transQueueEmpty(&conn->cliMsgs)) {
+      cliSend(conn);
+    }
+  }
+  taosArrayClear(pThrd->sendList);
+}
 static void cliAsyncCb(uv_async_t* handle) {
   SAsyncItem* item = handle->data;
   SCliThrd*   pThrd = item->pThrd;
@@ -1029,6 +1080,7 @@ static void cliAsyncCb(uv_async_t* handle) {
     (*cliAsyncHandle[pMsg->type])(pMsg, pThrd);
     count++;
   }
+  cliFlushSendList(pThrd);
   if (count >= 2) {
     tTrace("cli process batch size:%d", count);
   }
@@ -1060,6 +1112,7 @@ static void cliPrepareCb(uv_prepare_t* handle) {
       count++;
     }
   }
+  cliFlushSendList(thrd);
   tTrace("prepare work end");
   if (thrd->stopMsg != NULL) cliHandleQuit(thrd->stopMsg, thrd);
 }
@@ -1203,6 +1256,7 @@ static SCliThrd* createThrdObj(void* trans) {
   pThrd->pTransInst = trans;
 
   pThrd->fqdn2ipCache = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  pThrd->sendList = taosArrayInit(8, sizeof(void*));
   pThrd->quit = false;
   return pThrd;
 }
@@ -1228,6 +1282,8 @@ static void destroyThrdObj(SCliThrd* pThrd) {
   taosMemoryFree(pThrd->prepare);
   taosMemoryFree(pThrd->loop);
   taosHashCleanup(pThrd->fqdn2ipCache);
+  transDestroyCompBuf(&pThrd->compBuf);
+  taosArrayDestroy(pThrd->sendList);
   taosMemoryFree(pThrd);
 }
 
@@ -1263,6 +1319,7 @@ FORCE_INLINE int cliRBChoseIdx(STrans* pTransInst) {
 static FORCE_INLINE void doDelayTask(void* param) {
   STaskArg* arg = param;
   cliHandleReq((SCliMsg*)arg->param1, (SCliThrd*)arg->param2);
+  cliFlushSendList((SCliThrd*)arg->param2);
   taosMemoryFree(arg);
 }
 
@@ -23,17 +23,164 @@ static TdThreadOnce transModuleInit = PTHREAD_ONCE_INIT;
 static int32_t refMgt;
 static int32_t instMgt;
 
-int32_t transCompressMsg(char* msg, int32_t len) {
+/*
+ * rpc msg buffers carry a small header in front of STransMsgHead. Buffers filled by the receive
+ * path come from a size-classed pool and go back to it when the msg is freed.
+ */
+#define TRANS_BUF_MIN_SHIFT   7   // 128B
+#define TRANS_BUF_MAX_SHIFT   22  // 4M
+#define TRANS_BUF_CLASSES     (TRANS_BUF_MAX_SHIFT - TRANS_BUF_MIN_SHIFT + 1)
+#define TRANS_BUF_CLASS_BYTES (8 * 1024 * 1024)  // max bytes cached by one size class
+
+typedef struct STransBuf {
+  int64_t cap;  // size of the data following the header
+  int32_t cls;  // size class, -1 if not allocated from pool
+  int32_t reserved;
+} STransBuf;
+
+typedef struct {
+  TdThreadSpinlock lock;
+  STransBuf*       free;
+  int32_t          num;
+  int32_t          maxNum;
+} STransBufClass;
+
+static STransBufClass transBufPool[TRANS_BUF_CLASSES];
+static int8_t         transBufPoolInited = 0;
+
+#define TRANS_BUF_HEAD(p)     ((STransBuf*)((char*)(p) - sizeof(STransBuf)))
+#define TRANS_BUF_NEXT(pBuf)  (*(STransBuf**)((pBuf) + 1))
+#define TRANS_BUF_CONN_SIZE   (BUFFER_CAP - sizeof(STransBuf))
+
+static void transInitBufPool() {
+  for (int32_t i = 0; i < TRANS_BUF_CLASSES; i++) {
+    STransBufClass* pCls = &transBufPool[i];
+    taosThreadSpinInit(&pCls->lock, 0);
+    pCls->free = NULL;
+    pCls->num = 0;
+    pCls->maxNum = TMAX(TRANS_BUF_CLASS_BYTES >> (TRANS_BUF_MIN_SHIFT + i), 2);
+  }
+  atomic_store_8(&transBufPoolInited, 1);
+}
+static void transDestroyBufPool() {
+  atomic_store_8(&transBufPoolInited, 0);
+  for (int32_t i = 0; i < TRANS_BUF_CLASSES; i++) {
+    STransBufClass* pCls = &transBufPool[i];
+    taosThreadSpinLock(&pCls->lock);
+    STransBuf* pBuf = pCls->free;
+    pCls->free = NULL;
+    pCls->num = 0;
+    taosThreadSpinUnlock(&pCls->lock);
+    while (pBuf != NULL) {
+      STransBuf* pNext = TRANS_BUF_NEXT(pBuf);
+      taosMemoryFree(pBuf);
+      pBuf = pNext;
+    }
+  }
+}
+static int32_t transBufClassOf(int64_t size) {
+  int64_t need = size + sizeof(STransBuf);
+  for (int32_t i = 0; i < TRANS_BUF_CLASSES; i++) {
+    if (need <= (1LL << (TRANS_BUF_MIN_SHIFT + i))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+char* transAllocBuf(int64_t size, bool pooled) {
+  int32_t    cls = (pooled && atomic_load_8(&transBufPoolInited)) ? transBufClassOf(size) : -1;
+  int64_t    cap = size;
+  STransBuf* pBuf = NULL;
+  if (cls >= 0) {
+    STransBufClass* pCls = &transBufPool[cls];
+    taosThreadSpinLock(&pCls->lock);
+    pBuf = pCls->free;
+    if (pBuf != NULL) {
+      pCls->free = TRANS_BUF_NEXT(pBuf);
+      pCls->num--;
+    }
+    taosThreadSpinUnlock(&pCls->lock);
+
+    cap = (1LL << (TRANS_BUF_MIN_SHIFT + cls)) - sizeof(STransBuf);
+    if (pBuf == NULL) {
+      pBuf = taosMemoryMalloc(cap + sizeof(STransBuf));
+    }
+  } else if (pooled) {
+    pBuf = taosMemoryMalloc(cap + sizeof(STransBuf));
+  } else {
+    pBuf = taosMemoryCalloc(1, cap + sizeof(STransBuf));
+  }
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  pBuf->cap = cap;
+  pBuf->cls = cls;
+  return (char*)(pBuf + 1);
+}
+void transReleaseBuf(char* p) {
+  if (p == NULL) {
+    return;
+  }
+  STransBuf* pBuf = TRANS_BUF_HEAD(p);
+  if (pBuf->cls >= 0 && atomic_load_8(&transBufPoolInited)) {
+    STransBufClass* pCls = &transBufPool[pBuf->cls];
+    taosThreadSpinLock(&pCls->lock);
+    if (pCls->num < pCls->maxNum) {
+      TRANS_BUF_NEXT(pBuf) = pCls->free;
+      pCls->free = pBuf;
+      pCls->num++;
+      pBuf = NULL;
+    }
+    taosThreadSpinUnlock(&pCls->lock);
+  }
+  taosMemoryFree(pBuf);
+}
+char* transReallocBuf(char* p, int64_t size) {
+  if (p == NULL) {
+    return transAllocBuf(size, false);
+  }
+  STransBuf* pBuf = TRANS_BUF_HEAD(p);
+  if (pBuf->cls < 0) {
+    pBuf = taosMemoryRealloc(pBuf, size + sizeof(STransBuf));
+    if (pBuf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return NULL;
+    }
+    pBuf->cap = size;
+    return (char*)(pBuf + 1);
+  }
+  if (size <= pBuf->cap) {
+    return p;
+  }
+  char* buf = transAllocBuf(size, true);
+  if (buf == NULL) {
+    return NULL;
+  }
+  memcpy(buf, p, pBuf->cap);
+  transReleaseBuf(p);
+  return buf;
+}
+int64_t transBufCap(char* p) { return TRANS_BUF_HEAD(p)->cap; }
+
+int32_t transCompressMsg(char* msg, int32_t len, STransCompBuf* pCompBuf) {
   int32_t        ret = 0;
   int            compHdr = sizeof(STransCompMsg);
   STransMsgHead* pHead = transHeadFromCont(msg);
 
-  char* buf = taosMemoryMalloc(len + compHdr + 8);  // 8 extra bytes
-  if (buf == NULL) {
-    tError("failed to allocate memory for rpc msg compression, contLen:%d", len);
-    ret = len;
-    return ret;
+  int32_t cap = len + compHdr + 8;  // 8 extra bytes
+  if (pCompBuf->cap < cap) {
+    char* buf = taosMemoryRealloc(pCompBuf->buf, cap);
+    if (buf == NULL) {
+      tError("failed to allocate memory for rpc msg compression, contLen:%d", len);
+      ret = len;
+      return ret;
+    }
+    pCompBuf->buf = buf;
+    pCompBuf->cap = cap;
   }
+  char* buf = pCompBuf->buf;
 
   int32_t clen = LZ4_compress_default(msg, buf, len, len + compHdr);
   /*
@@ -53,9 +200,20 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     ret = len;
     pHead->comp = 0;
   }
-  taosMemoryFree(buf);
+
+  if (pCompBuf->cap > TRANS_COMP_BUF_KEEP) {
+    transDestroyCompBuf(pCompBuf);
+  }
   return ret;
 }
+void transDestroyCompBuf(STransCompBuf* pCompBuf) {
+  taosMemoryFreeClear(pCompBuf->buf);
+  pCompBuf->cap = 0;
+}
+void transUpdateSendStats(STrans* pTransInst, int32_t nMsg) {
+  atomic_add_fetch_64(&pTransInst->numOfWrites, 1);
+  atomic_add_fetch_64(&pTransInst->numOfSentMsgs, nMsg);
+}
 int32_t transDecompressMsg(char** msg, int32_t len) {
   STransMsgHead* pHead = (STransMsgHead*)(*msg);
   if (pHead->comp == 0) return 0;
@@ -64,7 +222,10 @@ int32_t transDecompressMsg(char** msg, int32_t len) {
   STransCompMsg* pComp = (STransCompMsg*)pCont;
   int32_t        oriLen = htonl(pComp->contLen);
 
-  char*          buf = taosMemoryCalloc(1, oriLen + sizeof(STransMsgHead));
+  char*          buf = transAllocBuf(oriLen + sizeof(STransMsgHead), true);
+  if (buf == NULL) {
+    return -1;
+  }
   STransMsgHead* pNewHead = (STransMsgHead*)buf;
 
   int32_t decompLen = LZ4_decompress_safe(pCont + sizeof(STransCompMsg), pNewHead->content,
@@ -73,7 +234,7 @@ int32_t transDecompressMsg(char** msg, int32_t len) {
 
   pNewHead->msgLen = htonl(oriLen + sizeof(STransMsgHead));
 
-  taosMemoryFree(pHead);
+  transReleaseBuf((char*)pHead);
 
   *msg = buf;
   if (decompLen != oriLen) {
@@ -86,7 +247,7 @@ void transFreeMsg(void* msg) {
   if (msg == NULL) {
     return;
   }
-  taosMemoryFree((char*)msg - sizeof(STransMsgHead));
+  transReleaseBuf((char*)msg - sizeof(STransMsgHead));
 }
 int transSockInfo2Str(struct sockaddr* sockname, char* dst) {
   struct sockaddr_in addr = *(struct sockaddr_in*)sockname;
@@ -97,8 +258,8 @@ int transSockInfo2Str(struct sockaddr* sockname, char* dst) {
   return r;
 }
 int transInitBuffer(SConnBuffer* buf) {
-  buf->cap = BUFFER_CAP;
-  buf->buf = taosMemoryCalloc(1, BUFFER_CAP);
+  buf->buf = transAllocBuf(TRANS_BUF_CONN_SIZE, true);
+  buf->cap = buf->buf != NULL ? transBufCap(buf->buf) : 0;
   buf->left = -1;
   buf->len = 0;
   buf->total = 0;
@@ -106,7 +267,7 @@ int transInitBuffer(SConnBuffer* buf) {
   return 0;
 }
 int transDestroyBuffer(SConnBuffer* p) {
-  taosMemoryFree(p->buf);
+  transReleaseBuf(p->buf);
   p->buf = NULL;
   return 0;
 }
@@ -114,8 +275,9 @@ int transDestroyBuffer(SConnBuffer* p) {
 int transClearBuffer(SConnBuffer* buf) {
   SConnBuffer* p = buf;
   if (p->cap > BUFFER_CAP) {
-    p->cap = BUFFER_CAP;
-    p->buf = taosMemoryRealloc(p->buf, BUFFER_CAP);
+    transReleaseBuf(p->buf);
+    p->buf = transAllocBuf(TRANS_BUF_CONN_SIZE, true);
+    p->cap = p->buf != NULL ? transBufCap(p->buf) : 0;
   }
   p->left = -1;
   p->len = 0;
@@ -133,9 +295,29 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
   }
   int total = p->total;
   if (total >= HEADSIZE && !p->invalid) {
-    *buf = taosMemoryCalloc(1, total);
-    memcpy(*buf, p->buf, total);
-    transResetBuffer(connBuf);
+    if (total * 2 >= p->cap) {
+      // large msg, hand the read buffer over to it, and move what follows into a new one
+      int   left = p->len - total;
+      char* newBuf = transAllocBuf(TMAX(left, TRANS_BUF_CONN_SIZE), true);
+      if (newBuf == NULL) {
+        return -1;
+      }
+      memcpy(newBuf, p->buf + total, left);
+      *buf = p->buf;
+
+      p->buf = newBuf;
+      p->cap = transBufCap(newBuf);
+      p->left = -1;
+      p->total = 0;
+      p->len = left;
+    } else {
+      *buf = transAllocBuf(total, true);
+      if (*buf == NULL) {
+        return -1;
+      }
+      memcpy(*buf, p->buf, total);
+      transResetBuffer(connBuf);
+    }
   } else {
     total = -1;
   }
@@ -174,8 +356,18 @@ int transAllocBuffer(SConnBuffer* connBuf, uv_buf_t* uvBuf) {
     if (p->left < p->cap - p->len) {
       uvBuf->len = p->left;
     } else {
-      p->cap = p->left + p->len;
-      p->buf = taosMemoryRealloc(p->buf, p->cap);
+      // read the rest of msg directly into a buffer large enough to be handed over
+      char* buf = transAllocBuf(p->left + p->len, true);
+      if (buf == NULL) {
+        // an empty buffer makes uv fail the read with UV_ENOBUFS, the conn is closed by the read cb
+        uvBuf->base = NULL;
+        uvBuf->len = 0;
+        return -1;
+      }
+      memcpy(buf, p->buf, p->len);
+      transReleaseBuf(p->buf);
+      p->buf = buf;
+      p->cap = transBufCap(buf);
       uvBuf->base = p->buf + p->len;
       uvBuf->len = p->left;
     }
@@ -584,10 +776,12 @@ static void transInitEnv() {
   refMgt = transOpenRefMgt(50000, transDestoryExHandle);
   instMgt = taosOpenRef(50, rpcCloseImpl);
   uv_os_setenv("UV_TCP_SINGLE_ACCEPT", "1");
+  transInitBufPool();
 }
 static void transDestroyEnv() {
   transCloseRefMgt(refMgt);
   transCloseRefMgt(instMgt);
+  transDestroyBufPool();
 }
 
 void transInit() {
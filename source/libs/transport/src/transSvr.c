@@ -39,6 +39,7 @@ typedef struct SSvrConn {
   void*       ahandle;     //
   void*       hostThrd;
   STransQueue srvMsgs;
+  int32_t     nSending;  // num of msgs in the write on flight
 
   SSvrRegArg regArg;
   bool       broken;  // conn broken;
@@ -79,6 +80,8 @@ typedef struct SWorkThrd {
   queue conn;
   void* pTransInst;
   bool  quit;
+
+  STransCompBuf compBuf;
 } SWorkThrd;
 
 typedef struct SServerObj {
@@ -330,40 +333,38 @@ void uvOnSendCb(uv_write_t* req, int status) {
   if (conn == NULL) return;
 
   if (status == 0) {
-    tTrace("conn %p data already was written on stream", conn);
-    if (!transQueueEmpty(&conn->srvMsgs)) {
+    tTrace("conn %p data already was written on stream, msgs:%d", conn, conn->nSending);
+    for (int32_t i = 0; i < conn->nSending && !transQueueEmpty(&conn->srvMsgs); i++) {
       SSvrMsg*  msg = transQueuePop(&conn->srvMsgs);
       STraceId* trace = &msg->msg.info.traceId;
       tGDebug("conn %p write data out", conn);
 
       destroySmsg(msg);
-      // send cached data
-      if (!transQueueEmpty(&conn->srvMsgs)) {
-        msg = (SSvrMsg*)transQueueGet(&conn->srvMsgs, 0);
-        if (msg->type == Register && conn->status == ConnAcquire) {
-          conn->regArg.notifyCount = 0;
-          conn->regArg.init = 1;
-          conn->regArg.msg = msg->msg;
-          if (conn->broken) {
-            STrans* pTransInst = conn->pTransInst;
-            (pTransInst->cfp)(pTransInst->parent, &(conn->regArg.msg), NULL);
-            memset(&conn->regArg, 0, sizeof(conn->regArg));
-          }
-          transQueuePop(&conn->srvMsgs);
-          taosMemoryFree(msg);
-
-          msg = (SSvrMsg*)transQueueGet(&conn->srvMsgs, 0);
-          if (msg != NULL) {
-            uvStartSendRespImpl(msg);
-          }
-        } else {
-          uvStartSendRespImpl(msg);
+    }
+    conn->nSending = 0;
+    // send cached data
+    while (!transQueueEmpty(&conn->srvMsgs)) {
+      SSvrMsg* msg = (SSvrMsg*)transQueueGet(&conn->srvMsgs, 0);
+      if (msg->type == Register && conn->status == ConnAcquire) {
+        conn->regArg.notifyCount = 0;
+        conn->regArg.init = 1;
+        conn->regArg.msg = msg->msg;
+        if (conn->broken) {
+          STrans* pTransInst = conn->pTransInst;
+          (pTransInst->cfp)(pTransInst->parent, &(conn->regArg.msg), NULL);
+          memset(&conn->regArg, 0, sizeof(conn->regArg));
         }
+        transQueuePop(&conn->srvMsgs);
+        taosMemoryFree(msg);
+      } else {
+        uvStartSendRespImpl(msg);
+        break;
       }
     }
     transUnrefSrvHandle(conn);
   } else {
     tError("conn %p failed to write data, %s", conn, uv_err_name(status));
+    conn->nSending = 0;
     conn->broken = true;
     transUnrefSrvHandle(conn);
   }
@@ -419,7 +420,8 @@ static void uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
 
   STrans* pTransInst = pConn->pTransInst;
   if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-    len = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+    SWorkThrd* pThrd = pConn->hostThrd;
+    len = transCompressMsg(pMsg->pCont, pMsg->contLen, &pThrd->compBuf) + sizeof(STransMsgHead);
     pHead->msgLen = (int32_t)htonl((uint32_t)len);
   }
 
@@ -437,12 +439,24 @@ static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
     return;
   }
 
-  uv_buf_t wb;
-  uvPrepareSendData(smsg, &wb);
+  // coalesce the resps cached on conn into one write, stop at the first register msg
+  uv_buf_t wb[TRANS_MAX_WRITE_BATCH];
+  int32_t  nBuf = 0;
+  int32_t  size = transQueueSize(&pConn->srvMsgs);
+  for (int32_t i = 0; i < size && nBuf < TRANS_MAX_WRITE_BATCH; i++) {
+    SSvrMsg* msg = (SSvrMsg*)transQueueGet(&pConn->srvMsgs, i);
+    if (msg->type == Register && nBuf > 0) {
+      break;
+    }
+    uvPrepareSendData(msg, &wb[nBuf++]);
+  }
+  pConn->nSending = nBuf;
+  transUpdateSendStats(pConn->pTransInst, nBuf);
+  tTrace("conn %p start to write %d msgs", pConn, nBuf);
 
   transRefSrvHandle(pConn);
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
-  uv_write(req, (uv_stream_t*)pConn->pTcp, &wb, 1, uvOnSendCb);
+  uv_write(req, (uv_stream_t*)pConn->pTcp, wb, nBuf, uvOnSendCb);
 }
 static void uvStartSendResp(SSvrMsg* smsg) {
   // impl
@@ -1147,6 +1161,7 @@ void destroyWorkThrd(SWorkThrd* pThrd) {
   transAsyncPoolDestroy(pThrd->asyncPool);
   taosMemoryFree(pThrd->prepare);
   taosMemoryFree(pThrd->loop);
+  transDestroyCompBuf(&pThrd->compBuf);
   taosMemoryFree(pThrd);
 }
 void sendQuitToWorkThrd(SWorkThrd* pThrd) {
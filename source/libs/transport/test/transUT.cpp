@@ -38,6 +38,7 @@ static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReleaseHandleCb(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processCheckReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 class Client {
@@ -80,6 +81,19 @@ class Client {
     SemWait();
     *resp = this->resp;
   }
+  // send the reqs without waiting in between, then wait for all of their resps
+  void SendBurstAndRecv(SRpcMsg *reqs, int num) {
+    SEpSet epSet = {0};
+    epSet.inUse = 0;
+    addEpIntoEpSet(&epSet, "127.0.0.1", 7000);
+
+    for (int i = 0; i < num; i++) {
+      rpcSendRequest(this->transCli, &epSet, &reqs[i], NULL);
+    }
+    for (int i = 0; i < num; i++) {
+      SemWait();
+    }
+  }
   void SendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) {
     if (req->info.handle != NULL) {
       rpcReleaseHandle(req->info.handle, TAOS_CONN_CLIENT);
@@ -88,6 +102,7 @@ class Client {
     SendAndRecv(req, resp);
   }
 
+  int  GetSendStats(SRpcSendStats *pStats) { return rpcGetSendStats(this->transCli, pStats); }
   void SemWait() { tsem_wait(&this->sem); }
   void SemPost() { tsem_post(&this->sem); }
   void Reset() {}
@@ -139,6 +154,7 @@ class Server {
     this->Stop();
     this->Start();
   }
+  int GetSendStats(SRpcSendStats *pStats) { return rpcGetSendStats(this->transSrv, pStats); }
   ~Server() {
     if (this->transSrv) rpcClose(this->transSrv);
     this->transSrv = NULL;
@@ -157,6 +173,24 @@ static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   rpcSendResponse(&rpcMsg);
 }
 
+static void processCheckReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  int32_t code = 0;
+  for (int32_t i = 0; i < pMsg->contLen; i++) {
+    if (((uint8_t *)pMsg->pCont)[i] != (uint8_t)(i % 251)) {
+      code = -1;
+      break;
+    }
+  }
+  rpcFreeCont(pMsg->pCont);
+
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(100);
+  rpcMsg.contLen = 100;
+  rpcMsg.info = pMsg->info;
+  rpcMsg.code = code;
+  rpcSendResponse(&rpcMsg);
+}
+
 static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   for (int i = 0; i < 10; i++) {
     SRpcMsg rpcMsg = {0};
@@ -259,6 +293,9 @@ class TransObj {
   }
   void cliSendAndRecv(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecv(req, resp); }
   void cliSendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecvNoHandle(req, resp); }
+  void cliSendBurstAndRecv(SRpcMsg *reqs, int num) { cli->SendBurstAndRecv(reqs, num); }
+  int  cliGetSendStats(SRpcSendStats *pStats) { return cli->GetSendStats(pStats); }
+  int  srvGetSendStats(SRpcSendStats *pStats) { return srv->GetSendStats(pStats); }
 
   ~TransObj() {
     delete cli;
@@ -294,6 +331,76 @@ TEST_F(TransEnv, 01sendAndRec) {
   }
 }
 
+TEST_F(TransEnv, sendStats) {
+  for (int i = 0; i < 10; i++) {
+    SRpcMsg req = {0}, resp = {0};
+    req.msgType = 0;
+    req.pCont = rpcMallocCont(10);
+    req.contLen = 10;
+    tr->cliSendAndRecv(&req, &resp);
+    assert(resp.code == 0);
+  }
+  SRpcSendStats cliStats = {0}, srvStats = {0};
+  EXPECT_EQ(tr->cliGetSendStats(&cliStats), 0);
+  EXPECT_EQ(tr->srvGetSendStats(&srvStats), 0);
+
+  EXPECT_EQ(cliStats.numOfSentMsgs, 10);
+  EXPECT_GT(cliStats.numOfWrites, 0);
+  EXPECT_LE(cliStats.numOfWrites, cliStats.numOfSentMsgs);
+
+  EXPECT_EQ(srvStats.numOfSentMsgs, 10);
+  EXPECT_GT(srvStats.numOfWrites, 0);
+  EXPECT_LE(srvStats.numOfWrites, srvStats.numOfSentMsgs);
+
+  // a burst on a persisted conn: reqs taken by the cli thread at once share writes
+  SRpcMsg req = {0}, resp = {0};
+  req.info.persistHandle = 1;
+  req.msgType = 1;
+  req.pCont = rpcMallocCont(10);
+  req.contLen = 10;
+  tr->cliSendAndRecv(&req, &resp);
+  ASSERT_EQ(resp.code, 0);
+
+  const int burst = 200;
+  SRpcMsg   reqs[burst];
+  memset(reqs, 0, sizeof(reqs));
+  for (int i = 0; i < burst; i++) {
+    reqs[i].info.handle = resp.info.handle;
+    reqs[i].info.persistHandle = 1;
+    reqs[i].info.ahandle = (void *)(int64_t)(i + 1);
+    reqs[i].msgType = 1;
+    reqs[i].pCont = rpcMallocCont(10);
+    reqs[i].contLen = 10;
+  }
+  tr->cliSendBurstAndRecv(reqs, burst);
+  rpcReleaseHandle(resp.info.handle, TAOS_CONN_CLIENT);
+
+  SRpcSendStats burstStats = {0};
+  EXPECT_EQ(tr->cliGetSendStats(&burstStats), 0);
+  int64_t msgs = burstStats.numOfSentMsgs - cliStats.numOfSentMsgs;
+  int64_t writes = burstStats.numOfWrites - cliStats.numOfWrites;
+  EXPECT_GE(msgs, 1 + burst);
+  EXPECT_LT(writes, msgs);
+}
+
+TEST_F(TransEnv, bigMsg) {
+  tr->SetSrvContinueSend(processCheckReq);
+  int32_t sizes[] = {10, 3000, 64 * 1024, 1024 * 1024, 6 * 1024 * 1024};
+  for (int r = 0; r < 2; r++) {
+    for (int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+      SRpcMsg req = {0}, resp = {0};
+      req.msgType = 1;
+      req.pCont = rpcMallocCont(sizes[i]);
+      req.contLen = sizes[i];
+      for (int32_t j = 0; j < sizes[i]; j++) {
+        ((uint8_t *)req.pCont)[j] = (uint8_t)(j % 251);
+      }
+      tr->cliSendAndRecv(&req, &resp);
+      EXPECT_EQ(resp.code, 0);
+    }
+  }
+}
+
 TEST_F(TransEnv, 02StopServer) {
   for (int i = 0; i < 1; i++) {
     SRpcMsg req = {0}, resp = {0};
@@ -80,8 +80,8 @@ int32_t tsem_timewait(tsem_t* sem, int64_t nanosecs) {
   FILETIME        ft_before, ft_after;
   int             rc;
 
-  rel.tv_sec = 0;
-  rel.tv_nsec = nanosecs;
+  rel.tv_sec = nanosecs / 1000000000;
+  rel.tv_nsec = nanosecs % 1000000000;
 
   GetSystemTimeAsFileTime(&ft_before);
   // errno = 0;
@@ -135,7 +135,7 @@ int tsem_wait(tsem_t *psem) {
 
 int tsem_timewait(tsem_t *psem, int64_t nanosecs) {
   if (psem == NULL || *psem == NULL) return -1;
-  dispatch_semaphore_wait(*psem, nanosecs);
+  dispatch_semaphore_wait(*psem, dispatch_time(DISPATCH_TIME_NOW, nanosecs));
   return 0;
 }
 
@@ -230,10 +230,15 @@ int32_t tsem_wait(tsem_t* sem) {
 int32_t tsem_timewait(tsem_t* sem, int64_t nanosecs) {
   int ret = 0;
 
-  struct timespec tv = {
-      .tv_sec = 0,
-      .tv_nsec = nanosecs,
-  };
+  // sem_timedwait takes an absolute time
+  struct timespec tv = {0};
+  taosClockGetTime(CLOCK_REALTIME, &tv);
+  tv.tv_sec += nanosecs / 1000000000;
+  tv.tv_nsec += nanosecs % 1000000000;
+  if (tv.tv_nsec >= 1000000000) {
+    tv.tv_sec++;
+    tv.tv_nsec -= 1000000000;
+  }
 
   while ((ret = sem_timedwait(sem, &tv)) == -1 && errno == EINTR) continue;
 
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define ALLOW_FORBID_FUNC
+#define _DEFAULT_SOURCE
+#include "os.h"
+
+#ifndef WINDOWS
+#include <sys/mman.h>
+#endif
+
+int32_t taosCreateShm(SShm *pShm, const char *name, int64_t size) {
+#ifdef WINDOWS
+  terrno = TSDB_CODE_OPS_NOT_SUPPORT;
+  return -1;
+#else
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  if (ftruncate(fd, size) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    close(fd);
+    shm_unlink(name);
+    return -1;
+  }
+
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    shm_unlink(name);
+    return -1;
+  }
+
+  pShm->ptr = ptr;
+  pShm->size = size;
+  return 0;
+#endif
+}
+
+int32_t taosAttachShm(SShm *pShm, const char *name) {
+#ifdef WINDOWS
+  terrno = TSDB_CODE_OPS_NOT_SUPPORT;
+  return -1;
+#else
+  int fd = shm_open(name, O_RDWR, 0600);
+  if (fd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    close(fd);
+    return -1;
+  }
+
+  void *ptr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  pShm->ptr = ptr;
+  pShm->size = st.st_size;
+  return 0;
+#endif
+}
+
+void taosDetachShm(SShm *pShm) {
+#ifndef WINDOWS
+  if (pShm->ptr != NULL) {
+    munmap(pShm->ptr, pShm->size);
+  }
+#endif
+  pShm->ptr = NULL;
+  pShm->size = 0;
+}
+
+void taosDropShm(const char *name) {
+#ifndef WINDOWS
+  shm_unlink(name);
+#endif
+}
+
+int32_t taosDropStaleShm(const char *prefix) {
+#ifdef LINUX
+  // the segments of shm_open live in /dev/shm, named without the leading '/'
+  if (prefix[0] == '/') prefix++;
+  int32_t  prefixLen = strlen(prefix);
+  int32_t  nDrop = 0;
+  TdDirPtr pDir = taosOpenDir("/dev/shm");
+  if (pDir == NULL) return 0;
+
+  TdDirEntryPtr pEntry = NULL;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    char *entryName = taosGetDirEntryName(pEntry);
+    if (strncmp(entryName, prefix, prefixLen) != 0 || entryName[prefixLen] != '-') continue;
+
+    char *pidStr = entryName + prefixLen + 1;
+    char *end = NULL;
+    long  pid = strtol(pidStr, &end, 10);
+    if (end == pidStr || *end != '-' || pid <= 0) continue;
+    if (kill((pid_t)pid, 0) == 0 || errno != ESRCH) continue;
+
+    char name[PATH_MAX] = {0};
+    snprintf(name, sizeof(name), "/%s", entryName);
+    if (shm_unlink(name) == 0) nDrop++;
+  }
+
+  taosCloseDir(&pDir);
+  return nDrop;
+#else
+  return 0;
+#endif
+}
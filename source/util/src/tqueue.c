@@ -44,6 +44,7 @@ typedef struct STaosQueue {
   TdThreadMutex mutex;
   int64_t       memOfItems;
   int32_t       numOfItems;
+  int32_t       numOfStolen;  // items taken by other threads and not processed yet
 } STaosQueue;
 
 typedef struct STaosQset {
@@ -115,7 +116,8 @@ bool taosQueueEmpty(STaosQueue *queue) {
 
   bool empty = false;
   taosThreadMutexLock(&queue->mutex);
-  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 && queue->memOfItems == 0) {
+  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 && queue->memOfItems == 0 &&
+      queue->numOfStolen == 0) {
     empty = true;
   }
   taosThreadMutexUnlock(&queue->mutex);
@@ -131,6 +133,14 @@ void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   taosThreadMutexUnlock(&queue->mutex);
 }
 
+void taosUpdateStolenItemSize(STaosQueue *queue, int32_t items) {
+  if (queue == NULL) return;
+
+  taosThreadMutexLock(&queue->mutex);
+  queue->numOfStolen -= items;
+  taosThreadMutexUnlock(&queue->mutex);
+}
+
 int32_t taosQueueItemSize(STaosQueue *queue) {
   if (queue == NULL) return 0;
 
@@ -446,11 +456,11 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
   return code;
 }
 
-int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+// read all items of the next non-empty queue, one count of qset->sem shall be taken by the caller
+static int32_t taosReadAllQitemsFromQsetImpl(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
   STaosQueue *queue;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
   taosThreadMutexLock(&qset->mutex);
 
   for (int32_t i = 0; i < qset->numOfQueues; ++i) {
@@ -492,6 +502,89 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
   return code;
 }
 
+int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+  tsem_wait(&qset->sem);
+  return taosReadAllQitemsFromQsetImpl(qset, qall, qinfo);
+}
+
+// same as taosReadAllQitemsFromQset, but return -1 if nothing is posted to the qset within ms
+int32_t taosTimedReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo, int64_t ms) {
+  if (tsem_timewait(&qset->sem, ms * 1000000) != 0) return -1;
+  return taosReadAllQitemsFromQsetImpl(qset, qall, qinfo);
+}
+
+// Take the items accepted by filterFp from one queue of a qset owned by another thread, never blocks. The counts of
+// qset->sem are taken only if they are still there, so the owner may wake up later and find nothing to read. The stolen
+// items move from queue->numOfItems to queue->numOfStolen here, taosUpdateStolenItemSize shall be called for them
+// instead of taosUpdateItemSize once they are processed.
+int32_t taosStealQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo, FItemFilter filterFp) {
+  STaosQueue *queue;
+  int32_t     code = 0;
+
+  if (atomic_load_32(&qset->numOfItems) <= 0) return 0;
+  if (taosThreadMutexTryLock(&qset->mutex) != 0) return 0;
+
+  for (queue = qset->head; queue != NULL; queue = queue->next) {
+    if (queue->head == NULL) continue;
+
+    taosThreadMutexLock(&queue->mutex);
+
+    STaosQnode *pNode = queue->head;
+    STaosQnode *pPrev = NULL;
+    STaosQnode *pTail = NULL;
+    qall->numOfItems = 0;
+    qall->start = NULL;
+    while (pNode != NULL) {
+      STaosQnode *pNext = pNode->next;
+      if (filterFp == NULL || (*filterFp)(pNode->item)) {
+        if (pPrev) {
+          pPrev->next = pNext;
+        } else {
+          queue->head = pNext;
+        }
+        if (queue->tail == pNode) queue->tail = pPrev;
+
+        pNode->next = NULL;
+        if (pTail) {
+          pTail->next = pNode;
+        } else {
+          qall->start = pNode;
+        }
+        pTail = pNode;
+        qall->numOfItems++;
+        queue->memOfItems -= pNode->size;
+      } else {
+        pPrev = pNode;
+      }
+      pNode = pNext;
+    }
+
+    if (qall->numOfItems > 0) {
+      qall->current = qall->start;
+      code = qall->numOfItems;
+      qinfo->ahandle = queue->ahandle;
+      qinfo->fp = queue->itemsFp;
+      qinfo->queue = queue;
+
+      queue->numOfItems -= qall->numOfItems;
+      queue->numOfStolen += qall->numOfItems;
+      uTrace("steal %d items from queue:%p, items:%d", code, queue, queue->numOfItems);
+
+      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
+      for (int32_t j = 0; j < qall->numOfItems; ++j) {
+        if (tsem_timewait(&qset->sem, 0) != 0) break;
+      }
+    }
+
+    taosThreadMutexUnlock(&queue->mutex);
+
+    if (code != 0) break;
+  }
+
+  taosThreadMutexUnlock(&qset->mutex);
+  return code;
+}
+
 int32_t taosQallItemSize(STaosQall *qall) { return qall->numOfItems; }
 void    taosResetQitems(STaosQall *qall) { qall->current = qall->start; }
 int32_t taosGetQueueNumber(STaosQset *qset) { return qset->numOfQueues; }
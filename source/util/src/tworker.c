@@ -20,6 +20,9 @@
 
 typedef void *(*ThreadFp)(void *param);
 
+#define WORKER_STEAL_MIN_WAIT_MS 5
+#define WORKER_STEAL_MAX_WAIT_MS 500
+
 int32_t tQWorkerInit(SQWorkerPool *pool) {
   pool->qset = taosOpenQset();
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SQWorker));
@@ -136,6 +139,7 @@ void tQWorkerFreeQueue(SQWorkerPool *pool, STaosQueue *queue) {
 
 int32_t tWWorkerInit(SWWorkerPool *pool) {
   pool->nextId = 0;
+  pool->stop = 0;
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SWWorker));
   if (pool->workers == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -157,6 +161,7 @@ int32_t tWWorkerInit(SWWorkerPool *pool) {
 }
 
 void tWWorkerCleanup(SWWorkerPool *pool) {
+  atomic_store_8(&pool->stop, 1);
   for (int32_t i = 0; i < pool->max; ++i) {
     SWWorker *worker = pool->workers + i;
     if (taosCheckPthreadValid(worker->thread)) {
@@ -170,6 +175,13 @@ void tWWorkerCleanup(SWWorkerPool *pool) {
     SWWorker *worker = pool->workers + i;
     if (taosCheckPthreadValid(worker->thread)) {
       taosThreadJoin(worker->thread, NULL);
+    }
+  }
+
+  // a stealing worker may read the qset of any other worker until it exits
+  for (int32_t i = 0; i < pool->max; ++i) {
+    SWWorker *worker = pool->workers + i;
+    if (taosCheckPthreadValid(worker->thread)) {
       taosThreadClear(&worker->thread);
       taosFreeQall(worker->qall);
       taosCloseQset(worker->qset);
@@ -182,19 +194,56 @@ void tWWorkerCleanup(SWWorkerPool *pool) {
   uDebug("worker:%s is closed", pool->name);
 }
 
+// Wait on the own qset for a while, then try to take the pending items of the other workers. The wait doubles after
+// each round that finds nothing, so idle workers seldom wake up. Returns 0 only when the pool is stopping.
+static int32_t tWWorkerReadOrSteal(SWWorker *worker, SQueueInfo *qinfo, bool *stolen) {
+  SWWorkerPool *pool = worker->pool;
+  int64_t       waitMs = WORKER_STEAL_MIN_WAIT_MS;
+
+  *stolen = false;
+  while (!atomic_load_8(&pool->stop)) {
+    int32_t numOfMsgs = taosTimedReadAllQitemsFromQset(worker->qset, worker->qall, qinfo, waitMs);
+    if (numOfMsgs > 0) return numOfMsgs;
+    if (numOfMsgs == 0) continue;  // the items were taken by another worker
+
+    int32_t num = atomic_load_32(&pool->num);
+    for (int32_t i = 1; i < num; ++i) {
+      SWWorker  *victim = pool->workers + (worker->id + i) % num;
+      STaosQset *qset = atomic_load_ptr(&victim->qset);
+      if (qset == NULL) continue;
+
+      numOfMsgs = taosStealQitemsFromQset(qset, worker->qall, qinfo, pool->stealFp);
+      if (numOfMsgs > 0) {
+        uTrace("worker:%s:%d steal %d items from worker:%d", pool->name, worker->id, numOfMsgs, victim->id);
+        *stolen = true;
+        return numOfMsgs;
+      }
+    }
+
+    waitMs = TMIN(waitMs * 2, WORKER_STEAL_MAX_WAIT_MS);
+  }
+
+  return 0;
+}
+
 static void *tWWorkerThreadFp(SWWorker *worker) {
   SWWorkerPool *pool = worker->pool;
   SQueueInfo    qinfo = {0};
   void         *msg = NULL;
   int32_t       code = 0;
   int32_t       numOfMsgs = 0;
+  bool          stolen = false;
 
   taosBlockSIGPIPE();
   setThreadName(pool->name);
   uDebug("worker:%s:%d is running", pool->name, worker->id);
 
   while (1) {
-    numOfMsgs = taosReadAllQitemsFromQset(worker->qset, worker->qall, &qinfo);
+    if (pool->stealFp) {
+      numOfMsgs = tWWorkerReadOrSteal(worker, &qinfo, &stolen);
+    } else {
+      numOfMsgs = taosReadAllQitemsFromQset(worker->qset, worker->qall, &qinfo);
+    }
     if (numOfMsgs == 0) {
       uDebug("worker:%s:%d qset:%p, got no message and exiting", pool->name, worker->id, worker->qset);
       break;
@@ -205,7 +254,11 @@ static void *tWWorkerThreadFp(SWWorker *worker) {
       qinfo.threadNum = pool->num;
       (*((FItems)qinfo.fp))(&qinfo, worker->qall, numOfMsgs);
     }
-    taosUpdateItemSize(qinfo.queue, numOfMsgs);
+    if (stolen) {
+      taosUpdateStolenItemSize(qinfo.queue, numOfMsgs);
+    } else {
+      taosUpdateItemSize(qinfo.queue, numOfMsgs);
+    }
   }
 
   return NULL;
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "tqueue.h"
+
+namespace {
+
+bool isEven(void *pItem) { return *(int32_t *)pItem % 2 == 0; }
+
+}  // namespace
+
+TEST(queueTest, stealFilteredItems) {
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queue = taosOpenQueue();
+  STaosQall  *qall = taosAllocateQall();
+  ASSERT_NE(qset, nullptr);
+  ASSERT_NE(queue, nullptr);
+  ASSERT_NE(qall, nullptr);
+
+  taosAddIntoQset(qset, queue, NULL);
+
+  for (int32_t i = 0; i < 10; ++i) {
+    int32_t *pItem = (int32_t *)taosAllocateQitem(sizeof(int32_t), DEF_QITEM);
+    *pItem = i;
+    taosWriteQitem(queue, pItem);
+  }
+
+  SQueueInfo qinfo = {0};
+  int32_t    num = taosStealQitemsFromQset(qset, qall, &qinfo, isEven);
+  EXPECT_EQ(num, 5);
+  EXPECT_EQ(qinfo.queue, queue);
+  EXPECT_EQ(taosQueueItemSize(queue), 5);
+
+  void *pItem = NULL;
+  for (int32_t i = 0; i < num; ++i) {
+    ASSERT_EQ(taosGetQitem(qall, &pItem), 1);
+    EXPECT_EQ(*(int32_t *)pItem, i * 2);
+    taosFreeQitem(pItem);
+  }
+
+  // the queue is not empty until the stolen items are processed
+  EXPECT_FALSE(taosQueueEmpty(queue));
+  EXPECT_EQ(taosStealQitemsFromQset(qset, qall, &qinfo, isEven), 0);
+
+  num = taosReadAllQitemsFromQset(qset, qall, &qinfo);
+  EXPECT_EQ(num, 5);
+  for (int32_t i = 0; i < num; ++i) {
+    ASSERT_EQ(taosGetQitem(qall, &pItem), 1);
+    EXPECT_EQ(*(int32_t *)pItem, i * 2 + 1);
+    taosFreeQitem(pItem);
+  }
+  taosUpdateItemSize(queue, num);
+  EXPECT_FALSE(taosQueueEmpty(queue));
+
+  taosUpdateStolenItemSize(queue, 5);
+  EXPECT_TRUE(taosQueueEmpty(queue));
+
+  taosFreeQall(qall);
+  taosRemoveFromQset(qset, queue);
+  taosCloseQueue(queue);
+  taosCloseQset(qset);
+}
@@ -0,0 +1,152 @@
+// sample code to verify the async multi-table stmt, taos_stmt_set_async and taos_stmt_bind_tables
+// build: gcc -o stmtAsyncTest stmtAsyncTest.c -ltaos -lpthread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "taos.h"
+
+#define TB_NUM  100
+#define ROW_NUM 100
+
+typedef struct {
+  int32_t nCallback;
+  int32_t nError;
+  int32_t lastCode;
+  int64_t affectedRows;
+} SAsyncStat;
+
+static void asyncCb(void *param, TAOS_RES *res, int code) {
+  SAsyncStat *pStat = param;
+  __atomic_add_fetch(&pStat->nCallback, 1, __ATOMIC_SEQ_CST);
+  if (code) {
+    __atomic_add_fetch(&pStat->nError, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&pStat->lastCode, code, __ATOMIC_SEQ_CST);
+  } else {
+    __atomic_add_fetch(&pStat->affectedRows, taos_affected_rows(res), __ATOMIC_SEQ_CST);
+  }
+  // the callback owns the result
+  taos_free_result(res);
+}
+
+static void execSql(TAOS *taos, const char *sql) {
+  TAOS_RES *res = taos_query(taos, sql);
+  if (taos_errno(res) != 0) {
+    printf("failed to run %s, reason: %s\n", sql, taos_errstr(res));
+    exit(1);
+  }
+  taos_free_result(res);
+}
+
+static int64_t countRows(TAOS *taos, const char *sql) {
+  TAOS_RES *res = taos_query(taos, sql);
+  TAOS_ROW  row = taos_fetch_row(res);
+  int64_t   count = row ? *(int64_t *)row[0] : -1;
+  taos_free_result(res);
+  return count;
+}
+
+static void check(int cond, const char *msg) {
+  if (!cond) {
+    printf("check failed: %s\n", msg);
+    exit(1);
+  }
+  printf("%s ok\n", msg);
+}
+
+typedef struct {
+  int64_t          ts[ROW_NUM];
+  int32_t          v[ROW_NUM];
+  TAOS_MULTI_BIND  cols[2];
+  TAOS_MULTI_BIND *binds[TB_NUM];
+  char             names[TB_NUM][16];
+  const char      *tbnames[TB_NUM];
+} SBatch;
+
+static void prepareBatch(SBatch *pBatch, int64_t ts0) {
+  for (int i = 0; i < ROW_NUM; ++i) {
+    pBatch->ts[i] = ts0 + i;
+    pBatch->v[i] = i;
+  }
+  memset(pBatch->cols, 0, sizeof(pBatch->cols));
+  pBatch->cols[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  pBatch->cols[0].buffer = pBatch->ts;
+  pBatch->cols[0].buffer_length = sizeof(int64_t);
+  pBatch->cols[0].num = ROW_NUM;
+  pBatch->cols[1].buffer_type = TSDB_DATA_TYPE_INT;
+  pBatch->cols[1].buffer = pBatch->v;
+  pBatch->cols[1].buffer_length = sizeof(int32_t);
+  pBatch->cols[1].num = ROW_NUM;
+  for (int i = 0; i < TB_NUM; ++i) {
+    sprintf(pBatch->names[i], "t%d", i);
+    pBatch->tbnames[i] = pBatch->names[i];
+    pBatch->binds[i] = pBatch->cols;
+  }
+}
+
+// every table is bound and submitted in per-vgroup batches, each submit is reported once
+static void asyncInsert(TAOS *taos) {
+  SAsyncStat stat = {0};
+  SBatch     batch;
+  prepareBatch(&batch, 1626861392589);
+
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  check(taos_stmt_prepare(stmt, "insert into ? values(?,?)", 0) == 0, "prepare");
+  check(taos_stmt_set_async(stmt, asyncCb, &stat) == 0, "set async");
+  check(taos_stmt_bind_tables(stmt, TB_NUM, batch.tbnames, batch.binds) == 0, "bind tables");
+  check(taos_stmt_execute(stmt) == 0, "execute");
+  check(taos_stmt_affected_rows(stmt) == TB_NUM * ROW_NUM, "affected rows");
+  taos_stmt_close(stmt);
+
+  check(stat.nError == 0 && stat.nCallback > 0, "callbacks");
+  check(stat.affectedRows == TB_NUM * ROW_NUM, "callback affected rows");
+  check(countRows(taos, "select count(*) from stb") == TB_NUM * ROW_NUM, "rows written");
+}
+
+// a table dropped by another connection fails its submit even after the meta is refreshed, the error is reported to
+// the callback and by execute
+static void asyncInsertDropped(TAOS *taos, TAOS *other) {
+  SAsyncStat stat = {0};
+  SBatch     batch;
+  prepareBatch(&batch, 1626861492589);
+
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  check(taos_stmt_prepare(stmt, "insert into ? values(?,?)", 0) == 0, "prepare");
+  check(taos_stmt_set_async(stmt, asyncCb, &stat) == 0, "set async");
+  check(taos_stmt_bind_tables(stmt, 1, batch.tbnames, batch.binds) == 0, "bind dropped table");
+  execSql(other, "drop table t0");
+  check(taos_stmt_execute(stmt) != 0, "execute on dropped table");
+  taos_stmt_close(stmt);
+
+  check(stat.nCallback == 1 && stat.nError == 1, "callback of the failed submit");
+}
+
+int main(int argc, char *argv[]) {
+  TAOS *taos = taos_connect("127.0.0.1", "root", "taosdata", NULL, 0);
+  TAOS *other = taos_connect("127.0.0.1", "root", "taosdata", NULL, 0);
+  if (taos == NULL || other == NULL) {
+    printf("failed to connect to server\n");
+    exit(1);
+  }
+
+  execSql(taos, "drop database if exists stmt_async");
+  execSql(taos, "create database stmt_async vgroups 4");
+  execSql(taos, "use stmt_async");
+  execSql(other, "use stmt_async");
+  execSql(taos, "create stable stb (ts timestamp, v int) tags (t int)");
+
+  char sql[128];
+  for (int i = 0; i < TB_NUM; ++i) {
+    sprintf(sql, "create table t%d using stb tags(%d)", i, i);
+    execSql(taos, sql);
+  }
+
+  asyncInsert(taos);
+  asyncInsertDropped(taos, other);
+
+  execSql(taos, "drop database stmt_async");
+  taos_close(other);
+  taos_close(taos);
+  taos_cleanup();
+  return 0;
+}
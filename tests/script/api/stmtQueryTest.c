@@ -0,0 +1,148 @@
+// sample code to verify prepared queries executed again and again with other values bound, each result must match
+// the same query with the values written in the sql
+// build: gcc -o stmtQueryTest stmtQueryTest.c -ltaos
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "taos.h"
+
+#define TB_NUM  10
+#define ROW_NUM 1000
+#define TS0     1626861392589
+
+static void execSql(TAOS *taos, const char *sql) {
+  TAOS_RES *res = taos_query(taos, sql);
+  if (taos_errno(res) != 0) {
+    printf("failed to run %s, reason: %s\n", sql, taos_errstr(res));
+    exit(1);
+  }
+  taos_free_result(res);
+}
+
+static int64_t fetchCount(TAOS_RES *res) {
+  TAOS_ROW row = taos_fetch_row(res);
+  return row ? *(int64_t *)row[0] : -1;
+}
+
+static int64_t queryCount(TAOS *taos, const char *sql) {
+  TAOS_RES *res = taos_query(taos, sql);
+  int64_t   count = fetchCount(res);
+  taos_free_result(res);
+  return count;
+}
+
+static void check(int cond, const char *msg) {
+  if (!cond) {
+    printf("check failed: %s\n", msg);
+    exit(1);
+  }
+}
+
+static int64_t stmtCount(TAOS_STMT *stmt, int64_t skey, int64_t ekey, int32_t v) {
+  TAOS_MULTI_BIND params[3] = {0};
+  params[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  params[0].buffer = &skey;
+  params[0].buffer_length = sizeof(skey);
+  params[0].num = 1;
+  params[1].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  params[1].buffer = &ekey;
+  params[1].buffer_length = sizeof(ekey);
+  params[1].num = 1;
+  params[2].buffer_type = TSDB_DATA_TYPE_INT;
+  params[2].buffer = &v;
+  params[2].buffer_length = sizeof(v);
+  params[2].num = 1;
+
+  check(taos_stmt_bind_param_batch(stmt, params) == 0, "bind");
+  check(taos_stmt_execute(stmt) == 0, "execute");
+  return fetchCount(taos_stmt_use_result(stmt));
+}
+
+// the plan made with the first values serves the executions to come
+static void rebind(TAOS *taos) {
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  check(taos_stmt_prepare(stmt, "select count(*) from stb where ts >= ? and ts < ? and v > ?", 0) == 0, "prepare");
+
+  char sql[256];
+  for (int i = 0; i < 20; ++i) {
+    int64_t skey = TS0 + i * 37;
+    int64_t ekey = skey + 100 + i * 11;
+    int32_t v = i % 7;
+    sprintf(sql, "select count(*) from stb where ts >= %" PRId64 " and ts < %" PRId64 " and v > %d", skey, ekey, v);
+    int64_t expect = queryCount(taos, sql);
+    check(expect > 0, sql);
+    check(stmtCount(stmt, skey, ekey, v) == expect, sql);
+  }
+  printf("rebind ok\n");
+  taos_stmt_close(stmt);
+}
+
+// a value of another type does not fit the kept plan, the query is translated again
+static void rebindOtherType(TAOS *taos) {
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  check(taos_stmt_prepare(stmt, "select count(*) from stb where v > ?", 0) == 0, "prepare");
+
+  int32_t         v = 500;
+  double          d = 900.5;
+  TAOS_MULTI_BIND param = {0};
+  param.buffer_type = TSDB_DATA_TYPE_INT;
+  param.buffer = &v;
+  param.buffer_length = sizeof(v);
+  param.num = 1;
+  check(taos_stmt_bind_param_batch(stmt, &param) == 0, "bind int");
+  check(taos_stmt_execute(stmt) == 0, "execute int");
+  check(fetchCount(taos_stmt_use_result(stmt)) == queryCount(taos, "select count(*) from stb where v > 500"),
+        "count with int");
+
+  param.buffer_type = TSDB_DATA_TYPE_DOUBLE;
+  param.buffer = &d;
+  param.buffer_length = sizeof(d);
+  check(taos_stmt_bind_param_batch(stmt, &param) == 0, "bind double");
+  check(taos_stmt_execute(stmt) == 0, "execute double");
+  check(fetchCount(taos_stmt_use_result(stmt)) == queryCount(taos, "select count(*) from stb where v > 900.5"),
+        "count with double");
+  printf("rebind other type ok\n");
+  taos_stmt_close(stmt);
+}
+
+// a query is parsed by prepare
+static void prepareError(TAOS *taos) {
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  check(taos_stmt_prepare(stmt, "select count(*) fro stb where v > ?", 0) != 0, "prepare a bad query");
+  taos_stmt_close(stmt);
+  printf("prepare error ok\n");
+}
+
+int main(int argc, char *argv[]) {
+  TAOS *taos = taos_connect("127.0.0.1", "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to server\n");
+    exit(1);
+  }
+
+  execSql(taos, "drop database if exists stmt_query");
+  execSql(taos, "create database stmt_query vgroups 2");
+  execSql(taos, "use stmt_query");
+  execSql(taos, "create stable stb (ts timestamp, v int) tags (t int)");
+
+  char *sql = malloc(ROW_NUM * 32 + 128);
+  for (int i = 0; i < TB_NUM; ++i) {
+    int len = sprintf(sql, "insert into t%d using stb tags(%d) values", i, i);
+    for (int j = 0; j < ROW_NUM; ++j) {
+      len += sprintf(sql + len, "(%" PRId64 ",%d)", (int64_t)TS0 + j, (j * 7 + i) % ROW_NUM);
+    }
+    execSql(taos, sql);
+  }
+  free(sql);
+
+  rebind(taos);
+  rebindOtherType(taos);
+  prepareError(taos);
+
+  execSql(taos, "drop database stmt_query");
+  taos_close(taos);
+  taos_cleanup();
+  return 0;
+}
@@ -0,0 +1,86 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+        self.dbname = 'db_stream_statis'
+        self.tbnum = 4
+        self.rowNum = 100
+        self.ts = 1537146000000
+
+    def prepare(self):
+        tdSql.execute(f'drop database if exists {self.dbname}')
+        tdSql.execute(f'create database {self.dbname} vgroups 2')
+        tdSql.execute(f'create table {self.dbname}.stb (ts timestamp, c1 int) tags(t1 int)')
+        for i in range(self.tbnum):
+            tdSql.execute(f'create table {self.dbname}.ct{i} using {self.dbname}.stb tags({i})')
+        tdSql.execute(f'create stream s_statis into {self.dbname}.output as '
+                      f'select _wstart, count(*), sum(c1) from {self.dbname}.stb interval(10s)')
+
+    def insert_rows(self):
+        for i in range(self.tbnum):
+            sql = f'insert into {self.dbname}.ct{i} values'
+            for j in range(self.rowNum):
+                sql += f'({self.ts + j * 1000},{j})'
+            tdSql.execute(sql)
+
+    def check_statis(self):
+        tdSql.query(f"select * from information_schema.ins_stream_tasks where stream_name = 's_statis'")
+        if tdSql.queryRows == 0:
+            tdLog.exit("no task of the stream in ins_stream_tasks")
+
+        # the source tasks of the leader vnodes report what they ran with the status of their dnode
+        for i in range(30):
+            tdSql.query(f"select sum(exec_num), sum(input_msgs), max(max_latency_us) from information_schema.ins_stream_tasks "
+                        f"where stream_name = 's_statis' and level = 'source'")
+            if tdSql.queryResult[0][0] is not None and tdSql.queryResult[0][0] > 0:
+                break
+            time.sleep(1)
+        else:
+            tdLog.exit("the exec statistics of the source tasks are not reported")
+        if tdSql.queryResult[0][1] <= 0 or tdSql.queryResult[0][2] <= 0:
+            tdLog.exit(f"unexpected source task statistics {tdSql.queryResult[0]}")
+
+        tdSql.query(f"select avg_latency_us, max_latency_us, throughput from information_schema.ins_stream_tasks "
+                    f"where stream_name = 's_statis' and exec_num > 0")
+        for row in tdSql.queryResult:
+            if row[0] > row[1] or row[2] < 0:
+                tdLog.exit(f"unexpected task statistics {row}")
+
+    def run(self):
+        self.prepare()
+        self.insert_rows()
+        self.check_statis()
+
+        # the tasks go away with the stream
+        tdSql.execute('drop stream s_statis')
+        tdSql.query(f"select * from information_schema.ins_stream_tasks where stream_name = 's_statis'")
+        tdSql.checkRows(0)
+        tdSql.execute(f'drop database {self.dbname}')
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
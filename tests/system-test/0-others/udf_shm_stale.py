@@ -0,0 +1,61 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import os
+import subprocess
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+    def shm_path(self, pid, seq):
+        return f'/dev/shm/taosudf-{pid}-{seq}'
+
+    def make_shm(self, path):
+        with open(path, 'wb') as f:
+            f.write(b'\0' * 65536)
+
+    def run(self):
+        # a process that is gone stands for the crashed taosd, the test itself for a live one
+        proc = subprocess.Popen(['true'])
+        proc.wait()
+        stale = [self.shm_path(proc.pid, seq) for seq in range(1, 4)]
+        live = self.shm_path(os.getpid(), 1)
+        for path in stale + [live]:
+            self.make_shm(path)
+
+        # the segments of dead pids are dropped when taosd starts, the others are kept
+        tdDnodes.stoptaosd(1)
+        tdDnodes.starttaosd(1)
+        for path in stale:
+            if os.path.exists(path):
+                tdLog.exit(f"stale shared memory {path} is not dropped")
+        if not os.path.exists(live):
+            tdLog.exit(f"shared memory {live} of a live process is dropped")
+        os.remove(live)
+
+        tdSql.query('select server_version()')
+        tdSql.checkRows(1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addLinux(__file__, TDTestCase())
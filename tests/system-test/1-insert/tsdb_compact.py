@@ -0,0 +1,93 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+        self.dbname = 'db_compact'
+        self.stbname = 'stb'
+        self.tbnum = 4
+        self.rowNum = 1000
+        self.ts = 1537146000000
+
+    def insert_rows(self, offset, value):
+        for i in range(self.tbnum):
+            sql = f'insert into {self.dbname}.{self.stbname}_{i} values'
+            for j in range(self.rowNum):
+                sql += f'({self.ts + (offset + j) * 1000},{value})'
+            tdSql.execute(sql)
+
+    def check_rows(self, nRow, value):
+        tdSql.query(f'select count(*) from {self.dbname}.{self.stbname}')
+        tdSql.checkData(0, 0, nRow * self.tbnum)
+        tdSql.query(f'select count(*) from {self.dbname}.{self.stbname} where c1 != {value}')
+        tdSql.checkData(0, 0, 0)
+
+    def prepare(self):
+        tdSql.execute(f'drop database if exists {self.dbname}')
+        tdSql.execute(f'create database {self.dbname} vgroups 1')
+        tdSql.execute(f'create table {self.dbname}.{self.stbname} (ts timestamp, c1 int) tags(t1 int)')
+        for i in range(self.tbnum):
+            tdSql.execute(f'create table {self.dbname}.{self.stbname}_{i} using {self.dbname}.{self.stbname} tags({i})')
+
+    def compact_overlap(self):
+        # every flush rewrites the same keys, the newest version has to survive the merge of the file set
+        for value in range(5):
+            self.insert_rows(0, value)
+            tdSql.execute(f'flush database {self.dbname}')
+        time.sleep(3)
+        self.check_rows(self.rowNum, 4)
+
+    def compact_delete(self):
+        # enough tombstones to get the file set compacted, rows written after a tombstone are kept
+        nDel = 0
+        for i in range(5):
+            sKey = self.ts + i * 100 * 1000
+            tdSql.execute(f'delete from {self.dbname}.{self.stbname} where ts >= {sKey} and ts < {sKey + 10 * 1000}')
+            nDel += 10
+        tdSql.execute(f'flush database {self.dbname}')
+        time.sleep(3)
+        self.check_rows(self.rowNum - nDel, 4)
+
+        # a compacted set is not picked again by the same tombstones, the data stays the same over more commits
+        for i in range(3):
+            self.insert_rows(self.rowNum, 4)
+            tdSql.execute(f'flush database {self.dbname}')
+        time.sleep(3)
+        self.check_rows(2 * self.rowNum - nDel, 4)
+        return nDel
+
+    def run(self):
+        self.prepare()
+        self.compact_overlap()
+        nDel = self.compact_delete()
+        tdDnodes.stoptaosd(1)
+        tdDnodes.starttaosd(1)
+        self.check_rows(2 * self.rowNum - nDel, 4)
+        tdSql.execute(f'drop database {self.dbname}')
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,146 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import glob
+import os
+import platform
+import re
+import time
+from datetime import datetime
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+HOUR = 3600 * 1000
+NOW = int(datetime.timestamp(datetime.now()) * 1000)
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+        self.cfgPath = tdDnodes.dnodes[0].cfgPath
+        self.dataDir = tdDnodes.dnodes[0].dataDir
+        self.dbname = 'db_rewrite'
+        self.refname = 'db_rewrite_ref'
+        self.stbname = 'stb'
+        self.tbnum = 4
+        self.rowNum = 1000
+        self.maxRows = 200
+
+    def deploy(self, rewrite):
+        # two tiers, the primary disk on level 0
+        cmd = f"sed -i '/^dataDir/d' {self.cfgPath}"
+        if platform.system().lower() == 'darwin':
+            cmd = f"sed -i '' '/^dataDir/d' {self.cfgPath}"
+        tdDnodes.stop(1)
+        tdDnodes.deploy(1)
+        if os.system(cmd) != 0:
+            tdLog.exit(cmd)
+        cfg = [f"dataDir {self.dataDir}/data00 0 1", f"dataDir {self.dataDir}/data10 1 0", f"retentionRewrite {rewrite}"]
+        for line in cfg:
+            if os.system(f'echo "{line}" >> {self.cfgPath}') != 0:
+                tdLog.exit(line)
+        tdDnodes.start(1)
+
+    def insert_rows(self, dbname, ts, value):
+        for i in range(self.tbnum):
+            sql = f'insert into {dbname}.{self.stbname}_{i} values'
+            for j in range(self.rowNum):
+                sql += f'({ts + j * 1000},{value},{(j * 7919) % 1000})'
+            tdSql.execute(sql)
+
+    def check_rows(self, dbname, nRow, value):
+        tdSql.query(f'select count(*) from {dbname}.{self.stbname}')
+        tdSql.checkData(0, 0, nRow * self.tbnum)
+        tdSql.query(f'select count(*) from {dbname}.{self.stbname} where c1 != {value}')
+        tdSql.checkData(0, 0, 0)
+
+    def check_max_rows(self, dbname):
+        tdSql.query(f'show table distributed {dbname}.{self.stbname}')
+        for row in tdSql.queryResult:
+            m = re.search(r'MaxRows=\[(\d+)\]', str(row[0]))
+            if m and int(m.group(1)) > self.maxRows:
+                tdLog.exit(f"{dbname} has blocks of {m.group(1)} rows, more than maxrows {self.maxRows}")
+
+    def cold_files(self, dbname, ext):
+        tdSql.query(f'show {dbname}.vgroups')
+        vgId = tdSql.queryResult[0][0]
+        return glob.glob(f'{self.dataDir}/data10/vnode/vnode{vgId}/tsdb/*.{ext}')
+
+    def create_db(self, dbname, comp):
+        tdSql.execute(f'create database {dbname} vgroups 1 stt_trigger 4 duration 1h keep 1d,2d,3d '
+                      f'maxrows {self.maxRows} comp {comp}')
+        tdSql.execute(f'create table {dbname}.{self.stbname} (ts timestamp, c1 int, c2 int) tags(t1 int)')
+        for i in range(self.tbnum):
+            tdSql.execute(f'create table {dbname}.{self.stbname}_{i} using {dbname}.{self.stbname} tags({i})')
+
+        # a file set older than keep0, written by several commits so that it has .stt files, with a tombstone in it
+        ts = NOW - 36 * HOUR
+        for value in range(3):
+            self.insert_rows(dbname, ts, value)
+            tdSql.execute(f'flush database {dbname}')
+        tdSql.execute(f'delete from {dbname}.{self.stbname} where ts < {ts + 10 * 1000}')
+        tdSql.execute(f'flush database {dbname}')
+        self.check_rows(dbname, self.rowNum - 10, 2)
+
+    def move(self, dbname, rewrite):
+        tdSql.execute(f'trim database {dbname}')
+        for i in range(30):
+            if len(self.cold_files(dbname, 'head')) > 0:
+                break
+            time.sleep(1)
+        if len(self.cold_files(dbname, 'head')) == 0:
+            tdLog.exit(f"file set of {dbname} not moved to level 1")
+
+        # a rewritten set has its .stt files merged into one, a copied set keeps them all
+        nStt = len(self.cold_files(dbname, 'stt'))
+        if (rewrite and nStt > 1) or (not rewrite and nStt < 3):
+            tdLog.exit(f"file set of {dbname} moved with {nStt} stt files")
+        self.check_rows(dbname, self.rowNum - 10, 2)
+        self.check_max_rows(dbname)
+
+    def cold_size(self, dbname):
+        return sum(os.path.getsize(f) for ext in ('data', 'stt') for f in self.cold_files(dbname, ext))
+
+    def retention(self, rewrite):
+        self.deploy(rewrite)
+        dbnames = [self.dbname]
+        self.create_db(self.dbname, 1)
+        if rewrite:
+            # cold sets are compressed in two stages whatever the compression of the database
+            dbnames.append(self.refname)
+            self.create_db(self.refname, 2)
+        for dbname in dbnames:
+            self.move(dbname, rewrite)
+        if rewrite and self.cold_size(self.dbname) != self.cold_size(self.refname):
+            tdLog.exit(f"rewritten sets of comp 1 and comp 2 differ: {self.cold_size(self.dbname)} "
+                       f"{self.cold_size(self.refname)}")
+
+        tdDnodes.stoptaosd(1)
+        tdDnodes.starttaosd(1)
+        for dbname in dbnames:
+            self.check_rows(dbname, self.rowNum - 10, 2)
+            tdSql.execute(f'drop database {dbname}')
+
+    def run(self):
+        self.retention(0)
+        self.retention(1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addLinux(__file__, TDTestCase())